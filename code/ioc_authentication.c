@@ -46,6 +46,7 @@ void ioc_make_authentication_message(
         *p,
         *auth_flags_ptr,
         auth_flags,
+        features,
         *start;
 
     os_char
@@ -65,11 +66,16 @@ void ioc_make_authentication_message(
         device_nr,
         send_device_nr;
 
+#if IOC_MBINFO_RESUME
+    os_uint
+        digest;
+#endif
+
     root = con->link.root;
 
     /* Set frame header.
      */
-    ioc_generate_header(con, con->frame_out.buf, &ptrs, con->frame_sz, 0);
+    ioc_generate_header(con, con->frame_out.buf, &ptrs, con->frame_sz, 0, 0);
 
     /* Generate frame content. Here we do not check for buffer overflow,
        we know (and trust) that it fits within one frame.
@@ -140,6 +146,36 @@ void ioc_make_authentication_message(
 #endif
     ioc_msg_setstr(password, &p);
 
+    /* Optional features this end supports. Adaptive flow control window bounds are sent
+       only for socket connections.
+     */
+    features = 0;
+#if IOC_LZ_COMPRESSION_SUPPORT
+    features |= IOC_AUTH_FEATURE_LZ_COMPRESSION;
+#endif
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    if (con->flags & IOC_SOCKET) {
+        features |= IOC_AUTH_FEATURE_FLOW_WINDOW;
+    }
+#endif
+#if IOC_MBINFO_RESUME
+    features |= IOC_AUTH_FEATURE_MBINFO_RESUME;
+#endif
+    *(p++) = features;
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    if (features & IOC_AUTH_FEATURE_FLOW_WINDOW) {
+        *(p++) = (os_uchar)(IOC_FC_MAX_IN_AIR_LIMIT >> 10);
+        *(p++) = (os_uchar)(IOC_FC_MAX_IN_AIR_LIMIT >> 18);
+    }
+#endif
+#if IOC_MBINFO_RESUME
+    digest = (con->resume.state == IOC_RESUME_WAIT_REPLY) ? con->resume.digest : 0;
+    *(p++) = (os_uchar)digest;
+    *(p++) = (os_uchar)(digest >> 8);
+    *(p++) = (os_uchar)(digest >> 16);
+    *(p++) = (os_uchar)(digest >> 24);
+#endif
+
     /* Set connect up and bidirectional flags.
      */
     if (con->flags & IOC_CONNECT_UP) {
@@ -189,6 +225,7 @@ void ioc_make_authentication_message(
   @param   con Pointer to the connection object.
   @param   mblk_id Memory block identifier in this end.
   @param   data Received data, can be compressed and delta encoded, check flags.
+  @param   data_sz Size of received data in bytes.
 
   @return  OSAL_SUCCESS if successfull. Other values indicate unauthenticated device or user,
            or a corrupted frame.
@@ -198,7 +235,8 @@ void ioc_make_authentication_message(
 osalStatus ioc_process_received_authentication_message(
     struct iocConnection *con,
     os_uint mblk_id,
-    os_char *data)
+    os_char *data,
+    os_int data_sz)
 {
     iocUser user;
     iocRoot *root;
@@ -207,6 +245,7 @@ osalStatus ioc_process_received_authentication_message(
 #if OSAL_SECRET_SUPPORT
     os_char tmp_password[IOC_PASSWORD_SZ];
 #endif
+    iocAuthFeatures features;
 #if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
     os_char nbuf[OSAL_NBUF_SZ];
     os_uint device_nr;
@@ -301,6 +340,11 @@ osalStatus ioc_process_received_authentication_message(
     if (s) return s;
 #endif
 
+    /* Optional features supported by the other end, if sent.
+     */
+    p = ioc_get_auth_features(&features, p, (os_uchar*)data + data_sz);
+    con->peer_features = features.flags;
+
     /* If other end limited frame size it can process.
      */
     if (mblk_id >= IOC_MIN_FRAME_SZ && mblk_id <= IOC_MAX_FRAME_SZ)
@@ -312,6 +356,12 @@ osalStatus ioc_process_received_authentication_message(
         }
     }
 
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    /* Set bounds within which flow control window is adapted.
+     */
+    ioc_flow_control_set_window_bounds(con, features.max_in_air);
+#endif
+
 #if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
     /* Check user authorization.
      */
@@ -338,10 +388,74 @@ osalStatus ioc_process_received_authentication_message(
        to next step.
      */
     con->authentication_received = OS_TRUE;
+#if IOC_CONNECT_STATS
+    ioc_connect_timing_mark(con, IOC_CONNECT_PHASE_AUTHENTICATED);
+#endif
+
+#if IOC_MBINFO_RESUME
+    /* Connecting end: Calculate digest of memory block information to send in this end's
+       authentication message. Other end: Use cached memory block information if digest
+       was received.
+     */
+    if (con->flags & IOC_CONNECT_UP) {
+        ioc_mbinfo_resume_start(con);
+    }
+    else {
+        ioc_mbinfo_resume_requested(con, features.digest, user.network_name);
+    }
+#endif
     return OSAL_SUCCESS;
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Parse optional features from authentication message.
+  @anchor ioc_get_auth_features
+
+  The ioc_get_auth_features() function reads the feature byte which follows the password, and
+  the feature fields after it. Each field whose feature bit is set is consumed, also when this
+  build does not support the feature, so that the following fields are read from the right
+  position whatever feature set the other end was built with. Unused fields are discarded.
+  Missing feature byte (older versions) means no optional features.
+
+  @param   features Structure where to store feature flags and field values. Values which
+           were not sent are set to zero.
+  @param   p Pointer to feature byte within received message.
+  @param   end Pointer to end of received message.
+  @return  Pointer to position after the feature fields.
+
+****************************************************************************************************
+*/
+os_uchar *ioc_get_auth_features(
+    iocAuthFeatures *features,
+    os_uchar *p,
+    const os_uchar *end)
+{
+    os_memclear(features, sizeof(iocAuthFeatures));
+    if (p >= end) return p;
+    features->flags = *(p++);
+
+    if (features->flags & IOC_AUTH_FEATURE_FLOW_WINDOW)
+    {
+        if (p + IOC_AUTH_FLOW_WINDOW_SZ > end) return (os_uchar*)end;
+        features->max_in_air = ((os_int)p[0] | ((os_int)p[1] << 8)) << 10;
+        p += IOC_AUTH_FLOW_WINDOW_SZ;
+    }
+
+    if (features->flags & IOC_AUTH_FEATURE_MBINFO_RESUME)
+    {
+        if (p + IOC_AUTH_MBINFO_DIGEST_SZ > end) return (os_uchar*)end;
+        features->digest = (os_uint)p[0] | ((os_uint)p[1] << 8) |
+            ((os_uint)p[2] << 16) | ((os_uint)p[3] << 24);
+        p += IOC_AUTH_MBINFO_DIGEST_SZ;
+    }
+
+    return p;
+}
+
+
 #if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
 /**
 ****************************************************************************************************
@@ -40,6 +40,46 @@ struct iocConnection;
 #define IOC_AUTH_DEVICE_NR_4_BYTES 64       /* Four bytes needed for device number in this message. */
 #define IOC_AUTH_BIDIRECTIONAL_COM 128      /* Bidirectional memory blocks supported. This may be OBSOLETED. */
 
+/**
+****************************************************************************************************
+  Optional feature flags, sent as one byte after the password in authentication message.
+  Older versions neither send nor read this byte, missing byte means no optional features.
+****************************************************************************************************
+*/
+#define IOC_AUTH_FEATURE_LZ_COMPRESSION 1   /* Can uncompress LZ compressed data frames. */
+#define IOC_AUTH_FEATURE_FLOW_WINDOW 2      /* Adaptive flow control window, followed by 2 byte
+                                               largest accepted window in kilobytes. */
+#define IOC_AUTH_FEATURE_MBINFO_RESUME 4    /* Memory block information resume, followed by 4 byte
+                                               digest of memory block information, 0 if none. */
+
+/* Sizes of optional feature fields following the feature byte, in feature bit order.
+   A field is present when its feature bit is set, whether or not the receiving end
+   supports the feature.
+ */
+#define IOC_AUTH_FLOW_WINDOW_SZ 2
+#define IOC_AUTH_MBINFO_DIGEST_SZ 4
+
+/**
+****************************************************************************************************
+  Optional features and their fields parsed from received authentication message.
+****************************************************************************************************
+*/
+typedef struct iocAuthFeatures
+{
+    /** Feature flags, IOC_AUTH_FEATURE_LZ_COMPRESSION, etc. Zero if not sent.
+     */
+    os_uchar flags;
+
+    /** Largest flow control window accepted by the other end, bytes. Zero if not sent.
+     */
+    os_int max_in_air;
+
+    /** Digest of memory block information, zero if not sent.
+     */
+    os_uint digest;
+}
+iocAuthFeatures;
+
 /**
 ****************************************************************************************************
   User account.
@@ -118,7 +158,15 @@ void ioc_make_authentication_message(
 osalStatus ioc_process_received_authentication_message(
     struct iocConnection *con,
     os_uint mblk_id,
-    os_char *data);
+    os_char *data,
+    os_int data_sz);
+
+/* Parse optional feature byte and feature fields from authentication message.
+ */
+os_uchar *ioc_get_auth_features(
+    iocAuthFeatures *features,
+    os_uchar *p,
+    const os_uchar *end);
 
 #if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
 
@@ -66,6 +66,9 @@ void ioc_initialize_brick_buffer(
     b->timeout_ms = timeout_ms;
     b->prm.is_device = (os_boolean)((flags & IOC_BRICK_CONTROLLER) == 0);
     b->compression_quality = 30.0;
+    b->rate.target_latency_ms = IOC_BRICK_DEFAULT_TARGET_LATENCY_MS;
+    b->rate.link_share_pct = IOC_BRICK_DEFAULT_LINK_SHARE_PCT;
+    b->rate.quality_limit = 80.0;
 
     if (signals == OS_NULL) {
         osal_debug_error("ioc_initialize_brick_buffer: NULL signals");
@@ -100,6 +103,9 @@ void ioc_release_brick_buffer(
     {
         ioc_lock(b->root);
         ioc_free_brick_buffer(b);
+#if IOC_BRICK_TILES_SUPPORT
+        ioc_free_brick_tiles_frame(b);
+#endif
 
         if (b->stream) {
             ioc_streamer_close(b->stream, OSAL_STREAM_DEFAULT);
@@ -117,6 +123,10 @@ void ioc_release_brick_buffer(
   @brief Check if we are can send new brick (previous has been processed)
   @anchor ioc_ready_for_new_brick
 
+  The previous brick must have been transferred and minimum frame interval set by rate
+  control must have elapsed since it was stored. If the application drops a frame because
+  of this, it should call ioc_brick_frame_skipped().
+
   @param   b Pointer to brick buffer
   @return  OS_TRUE if if we can send new brick, OS_FALSE if not.
 
@@ -125,10 +135,44 @@ void ioc_release_brick_buffer(
 os_boolean ioc_ready_for_new_brick(
     iocBrickBuffer *b)
 {
+    os_boolean ready;
+
 #if IOC_BRICK_RING_BUFFER_SUPPORT
-    if (!b->signals->flat_buffer) return b->buf_n == 0;
+    if (!b->signals->flat_buffer) {
+        ready = (os_boolean)(b->buf_n == 0);
+    }
+    else
 #endif
-    return b->flat_ready_for_brick;
+    {
+        ready = b->flat_ready_for_brick;
+    }
+
+    if (ready && b->rate.frame_ms) {
+        ready = os_has_elapsed(&b->rate.store_timer, b->rate.frame_ms);
+    }
+    return ready;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Count frame which was not sent because brick buffer was not ready.
+  @anchor ioc_brick_frame_skipped
+
+  The ioc_brick_frame_skipped() function is called by camera callback or other data source
+  once for each frame it drops because ioc_ready_for_new_brick() returned OS_FALSE. The
+  count is published as skipped frames telemetry.
+
+  @param   b Pointer to brick buffer
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_brick_frame_skipped(
+    iocBrickBuffer *b)
+{
+    b->rate.skipped++;
 }
 
 
@@ -257,6 +301,242 @@ void ioc_free_brick_buffer(
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Set rate control targets.
+  @anchor ioc_set_brick_rate_target
+
+  The ioc_set_brick_rate_target() function sets how brick sending adapts to link. Defaults
+  are IOC_BRICK_DEFAULT_TARGET_LATENCY_MS and IOC_BRICK_DEFAULT_LINK_SHARE_PCT.
+
+  @param   b Pointer to brick buffer.
+  @param   target_latency_ms Brick delivery latency above which JPEG quality is reduced.
+  @param   link_share_pct Maximum share of link time used by bricks, 1 - 100 percent.
+           Frame interval is adjusted so that remaining time is left for control traffic.
+           100 disables frame interval limit.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_set_brick_rate_target(
+    iocBrickBuffer *b,
+    os_int target_latency_ms,
+    os_int link_share_pct)
+{
+    if (target_latency_ms < 1) target_latency_ms = 1;
+    if (link_share_pct < 1) link_share_pct = 1;
+    if (link_share_pct > 100) link_share_pct = 100;
+    b->rate.target_latency_ms = target_latency_ms;
+    b->rate.link_share_pct = link_share_pct;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set signals to publish rate control telemetry.
+  @anchor ioc_set_brick_rate_signals
+
+  The ioc_set_brick_rate_signals() function stores signal pointers. Once set, JPEG quality,
+  frame interval, throughput, latency, in flight bytes and skipped/lost counts are written
+  to these signals about once per second by ioc_run_brick_send().
+
+  @param   b Pointer to brick buffer.
+  @param   sigs Structure containing signal pointers, unused ones OS_NULL. Macro
+           IOC_SET_BRICK_RATE_SIGNALS can be used to set up it.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_set_brick_rate_signals(
+    iocBrickBuffer *b,
+    const iocBrickRateSignals *sigs)
+{
+    os_memcpy(&b->rate.sigs, sigs, sizeof(iocBrickRateSignals));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick has been stored for sending (internal).
+  @anchor ioc_brick_rate_stored
+
+  Start measuring delivery latency of the brick.
+
+  @param   b Pointer to brick buffer.
+  @param   sz Brick size in bytes, including header.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_brick_rate_stored(
+    iocBrickBuffer *b,
+    os_memsz sz)
+{
+    os_get_timer(&b->rate.store_timer);
+    b->rate.store_sz = sz;
+    b->rate.in_flight = OS_TRUE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick has been delivered, adjust quality limit and frame interval (internal).
+  @anchor ioc_brick_rate_delivered
+
+  Measured latency and throughput are low pass filtered. Transfer time is the time the link
+  needs to move the bytes which were in flight, at filtered throughput. Delay is the larger
+  of this brick's latency and the transfer time. If delay is over target, JPEG quality limit
+  is reduced in proportion, by 20 - 50%. If it is under half of target, the limit grows back
+  slowly. Minimum frame interval is set from transfer time so that bricks occupy
+  link_share_pct of the link. Since transfer time follows brick size, the interval shrinks
+  as soon as lower quality makes bricks smaller.
+
+  @param   b Pointer to brick buffer.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_brick_rate_delivered(
+    iocBrickBuffer *b)
+{
+    const os_double filter_rate = 0.25;
+    iocBrickRateControl *r;
+    os_timer tnow;
+    os_long ms;
+    os_double throughput, transfer_ms, delay_ms, scale, frame_ms;
+
+    r = &b->rate;
+    if (!r->in_flight) return;
+    r->in_flight = OS_FALSE;
+
+    os_get_timer(&tnow);
+    ms = os_get_ms_elapsed(&r->store_timer, &tnow);
+    if (ms < 1) ms = 1;
+    throughput = 1000.0 * r->store_sz / ms;
+
+    if (r->latency_ms <= 0.0) {
+        r->latency_ms = (os_double)ms;
+        r->throughput = throughput;
+    }
+    else {
+        r->latency_ms = (1.0 - filter_rate) * r->latency_ms + filter_rate * ms;
+        r->throughput = (1.0 - filter_rate) * r->throughput + filter_rate * throughput;
+    }
+
+    transfer_ms = 0.0;
+    if (r->throughput > 0.0) {
+        transfer_ms = 1000.0 * r->store_sz / r->throughput;
+    }
+    delay_ms = (os_double)ms;
+    if (transfer_ms > delay_ms) delay_ms = transfer_ms;
+
+    if (delay_ms > r->target_latency_ms) {
+        scale = r->target_latency_ms / delay_ms;
+        if (scale > 0.8) scale = 0.8;
+        if (scale < 0.5) scale = 0.5;
+        r->quality_limit *= scale;
+        if (r->quality_limit < 2.0) r->quality_limit = 2.0;
+    }
+    else if (2.0 * delay_ms < r->target_latency_ms) {
+        r->quality_limit += 1.0;
+        if (r->quality_limit > 80.0) r->quality_limit = 80.0;
+    }
+    if (b->compression_quality > r->quality_limit) {
+        b->compression_quality = r->quality_limit;
+    }
+
+    frame_ms = 0.0;
+    if (r->link_share_pct < 100) {
+        frame_ms = transfer_ms * 100.0 / r->link_share_pct;
+        if (frame_ms > IOC_BRICK_MAX_FRAME_MS) frame_ms = IOC_BRICK_MAX_FRAME_MS;
+    }
+    r->frame_ms = (os_int)frame_ms;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick was lost because connection dropped during transfer (internal).
+  @anchor ioc_brick_rate_lost
+
+  Halve JPEG quality limit and double frame interval.
+
+  @param   b Pointer to brick buffer.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_brick_rate_lost(
+    iocBrickBuffer *b)
+{
+    iocBrickRateControl *r;
+
+    r = &b->rate;
+    if (!r->in_flight) return;
+    r->in_flight = OS_FALSE;
+    r->lost++;
+
+    r->quality_limit *= 0.5;
+    if (r->quality_limit < 2.0) r->quality_limit = 2.0;
+    if (b->compression_quality > r->quality_limit) {
+        b->compression_quality = r->quality_limit;
+    }
+
+    r->frame_ms = r->frame_ms ? 2 * r->frame_ms : r->target_latency_ms;
+    if (r->frame_ms > IOC_BRICK_MAX_FRAME_MS) r->frame_ms = IOC_BRICK_MAX_FRAME_MS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write rate control telemetry to signals (internal).
+  @anchor ioc_brick_rate_publish
+
+  Called from ioc_run_brick_send(), writes signals once per second.
+
+  @param   b Pointer to brick buffer.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_brick_rate_publish(
+    iocBrickBuffer *b)
+{
+    iocBrickRateControl *r;
+    const iocSignal *const *sig;
+    os_memsz in_flight;
+
+    r = &b->rate;
+    sig = r->sigs.sig;
+    if (!os_has_elapsed(&r->publish_timer, 1000)) return;
+    os_get_timer(&r->publish_timer);
+
+    in_flight = 0;
+    if (r->in_flight) {
+        in_flight = r->store_sz;
+#if IOC_BRICK_RING_BUFFER_SUPPORT
+        if (!b->signals->flat_buffer) {
+            in_flight = b->buf_n - b->pos;
+        }
+#endif
+    }
+
+    if (sig[IOC_BRICK_RATE_QUALITY]) ioc_set(sig[IOC_BRICK_RATE_QUALITY], ioc_get_jpeg_compression_quality(b));
+    if (sig[IOC_BRICK_RATE_FRAME_MS]) ioc_set(sig[IOC_BRICK_RATE_FRAME_MS], r->frame_ms);
+    if (sig[IOC_BRICK_RATE_KBPS]) ioc_set(sig[IOC_BRICK_RATE_KBPS], (os_long)(r->throughput * 8.0 / 1000.0));
+    if (sig[IOC_BRICK_RATE_LATENCY_MS]) ioc_set(sig[IOC_BRICK_RATE_LATENCY_MS], (os_long)r->latency_ms);
+    if (sig[IOC_BRICK_RATE_IN_FLIGHT]) ioc_set(sig[IOC_BRICK_RATE_IN_FLIGHT], in_flight);
+    if (sig[IOC_BRICK_RATE_SKIPPED]) ioc_set(sig[IOC_BRICK_RATE_SKIPPED], r->skipped);
+    if (sig[IOC_BRICK_RATE_LOST]) ioc_set(sig[IOC_BRICK_RATE_LOST], r->lost);
+}
+
+
 /**
 ****************************************************************************************************
 
@@ -271,7 +551,7 @@ void ioc_free_brick_buffer(
   @param  w Source image width in pixels, etc.
   @param  h Source image height in pixels, etc.
   @param  compression How to compress data, bit field. Set IOC_UNCOMPRESSED_BRICK (0) or
-          IOC_NORMAL_JPEG.
+          IOC_NORMAL_JPEG. IOC_SAMPLES stores data uncompressed and marks it as sample batch.
   @return OSAL_SUCCESS (0) if brick is stored. OSAL_STATUS_OUT_OF_BUFFER if data data doesn't
           first into given buffer. Other values indicate an error.
 
@@ -318,7 +598,27 @@ osalStatus ioc_compress_brick(
 
     /* Copy or compress.
      */
-    if (compression & IOC_JPEG)
+    if (compression == IOC_TILED)
+    {
+        /* Tiled brick data is encoded by ioc_compress_brick_tiles(), copy as is.
+         */
+        if (data_sz + (os_memsz)sizeof(iocBrickHdr) > b->signals->buf->n) {
+            osal_debug_error("ioc_brick: buffer too small for tiles");
+            s = OSAL_STATUS_OUT_OF_BUFFER;
+            goto getout;
+        }
+
+        ioc_lock(b->root);
+        lock_on = OS_TRUE;
+
+        ioc_move_array(b->signals->buf, sizeof(iocBrickHdr), data, (os_int)data_sz,
+            OSAL_STATE_CONNECTED, IOC_SIGNAL_WRITE);
+
+        sz = data_sz;
+        dhdr->compression = IOC_TILED;
+    }
+
+    else if (compression & IOC_JPEG)
     {
         /* If already compressed by camera (ESP32 cam already makes JPEG)
          */
@@ -388,7 +688,8 @@ osalStatus ioc_compress_brick(
     {
         sz = w * (os_memsz)h * OSAL_BITMAP_BYTES_PER_PIX(format);
         osal_debug_assert(sz == data_sz);
-        if (sz +  (os_memsz)sizeof(iocBrickHdr) > buf_sz) {
+        if (sz +  (os_memsz)sizeof(iocBrickHdr) > b->signals->buf->n) {
+            osal_debug_error("ioc_brick: buffer too small");
             s = OSAL_STATUS_OUT_OF_BUFFER;
             goto getout;
         }
@@ -400,7 +701,7 @@ osalStatus ioc_compress_brick(
             OSAL_STATE_CONNECTED, IOC_SIGNAL_WRITE);
         sz = data_sz;
 
-        dhdr->compression = IOC_UNCOMPRESSED;
+        dhdr->compression = (compression == IOC_SAMPLES) ? IOC_SAMPLES : IOC_UNCOMPRESSED;
     }
 
     dhdr->format = format;
@@ -436,6 +737,11 @@ osalStatus ioc_compress_brick(
     if (++(b->flat_frame_count) == 0) b->flat_frame_count++;
     ioc_set(b->signals->state, b->flat_frame_count);
 
+    /* Wait for receiver to acknowledge this brick before storing next one.
+     */
+    b->flat_ready_for_brick = OS_FALSE;
+    ioc_brick_rate_stored(b, sz);
+
 getout:
     if (buf) {
         os_free(buf, buf_sz);
@@ -463,7 +769,7 @@ getout:
   @param  w Source image width in pixels, etc.
   @param  h Source image height in pixels, etc.
   @param  compression How to compress data, bit field. Set IOC_UNCOMPRESSED_BRICK (0) or
-          IOC_NORMAL_JPEG.
+          IOC_NORMAL_JPEG. IOC_SAMPLES stores data uncompressed and marks it as sample batch.
   @return OSAL_SUCCESS (0) if all is fine. Other values indicate an error.
 
 ****************************************************************************************************
@@ -502,7 +808,22 @@ osalStatus ioc_compress_brick_ring(
 
     /* Copy or compress.
      */
-    if (compression & IOC_JPEG)
+    if (compression == IOC_TILED)
+    {
+        /* Tiled brick data is encoded by ioc_compress_brick_tiles(), copy as is.
+         */
+        if (data_sz + (os_memsz)sizeof(iocBrickHdr) > buf_sz) {
+            osal_debug_error("ioc_brick: buffer too small for tiles");
+            s = OSAL_STATUS_OUT_OF_BUFFER;
+            goto getout;
+        }
+
+        os_memcpy(buf + sizeof(iocBrickHdr), data, data_sz);
+        sz = data_sz;
+        dhdr->compression = IOC_TILED;
+    }
+
+    else if (compression & IOC_JPEG)
     {
         /* If already compressed by camera (ESP32 cam can make JPEG)
             */
@@ -555,7 +876,7 @@ osalStatus ioc_compress_brick_ring(
             osal_debug_error("ioc_brick: buffer too small");
         }
         os_memcpy(buf + sizeof(iocBrickHdr), data, sz);
-        dhdr->compression = IOC_UNCOMPRESSED;
+        dhdr->compression = (compression == IOC_SAMPLES) ? IOC_SAMPLES : IOC_UNCOMPRESSED;
     }
 
     dhdr->format = format;
@@ -577,6 +898,7 @@ osalStatus ioc_compress_brick_ring(
     dhdr->checksum[0] = (os_uchar)checksum;
     dhdr->checksum[1] = (os_uchar)(checksum >> 8);
     b->buf_n = sz;
+    ioc_brick_rate_stored(b, sz);
 
 getout:
     return s;
@@ -598,7 +920,7 @@ getout:
   @param  w Source image width in pixels, etc.
   @param  h Source image height in pixels, etc.
   @param  compression How to compress data, bit field. Set IOC_UNCOMPRESSED_BRICK (0) or
-          IOC_NORMAL_JPEG.
+          IOC_NORMAL_JPEG. IOC_SAMPLES stores data uncompressed and marks it as sample batch.
   @return OSAL_SUCCESS (0) if all is fine. Other values indicate an error.
 
 ****************************************************************************************************
@@ -687,6 +1009,7 @@ static osalStatus ioc_send_brick_data(
             n, &n_written, OSAL_STREAM_DEFAULT);
         if (s)
         {
+            ioc_unlock(b->root);
             return s;
         }
 
@@ -697,6 +1020,7 @@ static osalStatus ioc_send_brick_data(
      */
     if (b->pos >= b->buf_n) {
         b->buf_n = 0;
+        ioc_brick_rate_delivered(b);
     }
 
     ioc_unlock(b->root);
@@ -729,6 +1053,7 @@ osalStatus ioc_run_brick_send(
     cmd = (os_int)ioc_get_ext(b->signals->cmd, &state_bits, IOC_SIGNAL_DEFAULT);
     prev_cmd = b->prev_cmd;
     b->prev_cmd = cmd;
+    ioc_brick_rate_publish(b);
 
 #if IOC_BRICK_RING_BUFFER_SUPPORT
     if (!b->signals->flat_buffer)
@@ -748,6 +1073,9 @@ osalStatus ioc_run_brick_send(
             if (stream == OS_NULL) return OSAL_NOTHING_TO_DO;
             b->buf_n = 0;
             b->stream = stream;
+#if IOC_BRICK_TILES_SUPPORT
+            b->tile_keyframe_request = OS_TRUE;
+#endif
 
             if (b->timeout_ms) {
                 ((iocStreamer*)stream)->write_timeout_ms = b->timeout_ms;
@@ -767,6 +1095,7 @@ osalStatus ioc_run_brick_send(
         if (OSAL_IS_ERROR(s)) {
             ioc_streamer_close(b->stream, OSAL_STREAM_DEFAULT);
             b->stream = OS_NULL;
+            ioc_brick_rate_lost(b);
         }
         return s;
     }
@@ -775,6 +1104,7 @@ osalStatus ioc_run_brick_send(
     {
         b->flat_ready_for_brick = OS_FALSE;
         b->flat_connected = OS_FALSE;
+        ioc_brick_rate_lost(b);
     }
     else
     {
@@ -783,6 +1113,12 @@ osalStatus ioc_run_brick_send(
             os_get_timer(&b->flat_frame_timer);
             b->flat_ready_for_brick = OS_TRUE;
             b->flat_connected = OS_TRUE;
+            ioc_brick_rate_delivered(b);
+#if IOC_BRICK_TILES_SUPPORT
+            /* Negative acknowledge: receiver needs a tiled key frame.
+             */
+            if (cmd < 0) b->tile_keyframe_request = OS_TRUE;
+#endif
         }
         else
         {
@@ -790,6 +1126,7 @@ osalStatus ioc_run_brick_send(
                 if (os_has_elapsed(&b->flat_frame_timer, 10000))
                 {
                     b->flat_connected = OS_FALSE;
+                    ioc_brick_rate_lost(b);
                 }
             }
         }
@@ -991,6 +1328,24 @@ static osalStatus ioc_receive_ring_brick_data(
         return OSAL_STATUS_CHECKSUM_ERROR;
     }
 
+#if IOC_BRICK_TILES_SUPPORT
+    /* If this is tiled brick, replace it with assembled frame.
+     */
+    s = ioc_assemble_brick_tiles(b);
+    if (s == OSAL_PENDING)
+    {
+        /* Tiles without key frame: Close the stream, sender starts the new one with
+           key frame.
+         */
+        b->tile_keyframe_request = OS_FALSE;
+        return OSAL_STATUS_FAILED;
+    }
+    if (s) {
+        osal_debug_error("tiled brick error");
+        return s;
+    }
+#endif
+
     /* Callback function.
      */
     if (b->receive_callback)
@@ -1027,6 +1382,9 @@ static void ioc_process_flat_brick_data(
     os_int n;
     os_ushort checksum, checksum2;
     os_char state_bits;
+#if IOC_BRICK_TILES_SUPPORT
+    osalStatus s;
+#endif
 
     n = (os_int)ioc_get_ext(b->signals->head, &state_bits, IOC_SIGNAL_NO_THREAD_SYNC);
     if (n <= (os_memsz)sizeof(iocBrickHdr) || (state_bits & OSAL_STATE_CONNECTED) == 0)
@@ -1079,6 +1437,20 @@ static void ioc_process_flat_brick_data(
         goto failed;
     }
 
+#if IOC_BRICK_TILES_SUPPORT
+    /* If this is tiled brick, replace it with assembled frame.
+     */
+    s = ioc_assemble_brick_tiles(b);
+    if (s)
+    {
+        /* OSAL_PENDING: Tiles without key frame dropped, request is sent with the
+           acknowledge.
+         */
+        if (s != OSAL_PENDING) osal_debug_error("tiled brick error");
+        goto failed;
+    }
+#endif
+
     /* Callback function. Leave image into buffer. Can be processed from there as well.
      */
     if (b->receive_callback)
@@ -1111,7 +1483,7 @@ failed:
 osalStatus ioc_run_brick_receive(
     iocBrickBuffer *b)
 {
-    os_int state;
+    os_int state, ack;
     os_char state_bits;
 #if IOC_BRICK_RING_BUFFER_SUPPORT
     os_int cmd;
@@ -1170,8 +1542,17 @@ osalStatus ioc_run_brick_receive(
                 b->flat_connected = OS_TRUE;
             }
 
-            if (++(b->prev_cmd) == 0) b->prev_cmd++;
-            ioc_set(b->signals->cmd, b->prev_cmd);
+            /* Acknowledge with positive counter, negated to request tiled key frame.
+             */
+            if (++(b->prev_cmd) <= 0) b->prev_cmd = 1;
+            ack = b->prev_cmd;
+#if IOC_BRICK_TILES_SUPPORT
+            if (b->tile_keyframe_request) {
+                ack = -ack;
+                b->tile_keyframe_request = OS_FALSE;
+            }
+#endif
+            ioc_set(b->signals->cmd, ack);
 
         }
         ioc_unlock(b->root);
@@ -1323,7 +1704,7 @@ void ioc_adjust_jpeg_compression_quality(
     lim = b->compression_quality + max_change;
     if (calc_quality > lim) calc_quality = lim; */
     if (calc_quality < 2) calc_quality = 2;
-    if (calc_quality > 80) calc_quality = 80;
+    if (calc_quality > b->rate.quality_limit) calc_quality = b->rate.quality_limit;
     b->compression_quality = (1.0 - adjust_rate) * b->compression_quality + adjust_rate * calc_quality;
 }
 
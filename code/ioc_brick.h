@@ -23,10 +23,13 @@ struct iocBrickBuffer;
 
 /* Do not change enumeration values, breaks compatibility. Future compressions should be marked
    with nonzero value 1 - 126 (highest bit zero, nonzero value). JPEG quality 0 means that
-   quality is not set.
+   quality is not set. IOC_SAMPLES marks batch of time stamped samples (ioc_sampler.h), data
+   is stored uncompressed.
  */
 #define IOC_UNCOMPRESSED 0
 #define IOC_JPEG 0x80
+#define IOC_TILED 0x01
+#define IOC_SAMPLES 0x02
 #define IOC_JPEG_QUALITY_MASK 0x7F
 #define IOC_DEFAULT_COMPRESSION 0x7F
 
@@ -91,6 +94,97 @@ typedef struct iocBrickHdr
 }
 iocBrickHdr;
 
+/* Rate control defaults: Target brick delivery latency, and maximum share of link
+   throughput used by bricks (percent), rest is left for control traffic.
+ */
+#define IOC_BRICK_DEFAULT_TARGET_LATENCY_MS 250
+#define IOC_BRICK_DEFAULT_LINK_SHARE_PCT 70
+
+/* Maximum frame interval set by rate control, ms.
+ */
+#define IOC_BRICK_MAX_FRAME_MS 5000
+
+/* Enumeration of rate control telemetry signals.
+ */
+typedef enum iocBrickRateSigEnum
+{
+    IOC_BRICK_RATE_QUALITY,
+    IOC_BRICK_RATE_FRAME_MS,
+    IOC_BRICK_RATE_KBPS,
+    IOC_BRICK_RATE_LATENCY_MS,
+    IOC_BRICK_RATE_IN_FLIGHT,
+    IOC_BRICK_RATE_SKIPPED,
+    IOC_BRICK_RATE_LOST,
+
+    IOC_BRICK_RATE_NRO_SIGNALS
+}
+iocBrickRateSigEnum;
+
+/* Rate control telemetry signal pointers, OS_NULL if signal is not published.
+ */
+typedef struct iocBrickRateSignals
+{
+    const iocSignal
+        *sig[IOC_BRICK_RATE_NRO_SIGNALS];
+}
+iocBrickRateSignals;
+
+/* Macro to set up rate control telemetry signals from "video_stats" group in exp block,
+   see config/signals/video_stats.json.
+ */
+#define IOC_SET_BRICK_RATE_SIGNALS(sigs, staticsigs)  \
+    os_memclear(&sigs, sizeof(iocBrickRateSignals)); \
+    (sigs).sig[IOC_BRICK_RATE_QUALITY] = &(staticsigs).exp.vs_quality; \
+    (sigs).sig[IOC_BRICK_RATE_FRAME_MS] = &(staticsigs).exp.vs_frame_ms; \
+    (sigs).sig[IOC_BRICK_RATE_KBPS] = &(staticsigs).exp.vs_kbps; \
+    (sigs).sig[IOC_BRICK_RATE_LATENCY_MS] = &(staticsigs).exp.vs_latency_ms; \
+    (sigs).sig[IOC_BRICK_RATE_IN_FLIGHT] = &(staticsigs).exp.vs_in_flight; \
+    (sigs).sig[IOC_BRICK_RATE_SKIPPED] = &(staticsigs).exp.vs_skipped; \
+    (sigs).sig[IOC_BRICK_RATE_LOST] = &(staticsigs).exp.vs_lost;
+
+/* Rate control state of sending brick buffer. Delivery latency of each brick (from storing
+   it for sending to acknowledged by flat buffer receiver, or written to ring buffer) and
+   throughput are measured. Latency, or time to transfer brick's bytes at measured throughput,
+   over target reduces JPEG quality limit, low values let it grow back. Frame interval is set
+   from transfer time so that bricks use only link_share_pct of the link.
+ */
+typedef struct iocBrickRateControl
+{
+    /* Telemetry signals and timer for publishing them.
+     */
+    iocBrickRateSignals sigs;
+    os_timer publish_timer;
+
+    /* Targets set by ioc_set_brick_rate_target().
+     */
+    os_int target_latency_ms;
+    os_int link_share_pct;
+
+    /* Brick being transferred: time stored and size in bytes.
+     */
+    os_timer store_timer;
+    os_memsz store_sz;
+    os_boolean in_flight;
+
+    /* Filtered measurements: delivery latency, ms, and throughput, bytes/s.
+     */
+    os_double latency_ms;
+    os_double throughput;
+
+    /* Control outputs: Upper limit for JPEG quality and minimum interval between
+       bricks, ms.
+     */
+    os_double quality_limit;
+    os_int frame_ms;
+
+    /* Number of frames skipped (reported by ioc_brick_frame_skipped()) and bricks lost
+       (connection dropped during transfer).
+     */
+    os_uint skipped;
+    os_uint lost;
+}
+iocBrickRateControl;
+
 /* Brick received callback function type.
  */
 typedef osalStatus ioc_brick_received(
@@ -143,6 +237,22 @@ typedef struct iocBrickBuffer
      */
     os_double compression_quality;
 
+    /* Rate control, sending end.
+     */
+    iocBrickRateControl rate;
+
+#if IOC_BRICK_TILES_SUPPORT
+    /* Frame assembled from tiled bricks, receiving end.
+     */
+    os_uchar *tile_frame;
+    os_memsz tile_frame_alloc_sz;
+
+    /* Key frame request. Receiving end: tiles arrived without assembled frame, to be passed
+       to sender. Sending end: request received, consumed by ioc_compress_brick_tiles().
+     */
+    os_boolean tile_keyframe_request;
+#endif
+
     /* Callback.
      */
     volatile os_boolean enable_receive;
@@ -168,6 +278,11 @@ void ioc_release_brick_buffer(
 os_boolean ioc_ready_for_new_brick(
     iocBrickBuffer *b);
 
+/* Count frame which was not sent because brick buffer was not ready.
+ */
+void ioc_brick_frame_skipped(
+    iocBrickBuffer *b);
+
 os_boolean ioc_is_brick_connected(
     iocBrickBuffer *b);
 
@@ -239,6 +354,19 @@ void ioc_adjust_jpeg_compression_quality(
     osalStatus compression_status,
     os_memsz compressed_sz);
 
+/* Set rate control targets.
+ */
+void ioc_set_brick_rate_target(
+    iocBrickBuffer *b,
+    os_int target_latency_ms,
+    os_int link_share_pct);
+
+/* Set signals to publish rate control telemetry.
+ */
+void ioc_set_brick_rate_signals(
+    iocBrickBuffer *b,
+    const iocBrickRateSignals *sigs);
+
 /* Get compression quality to use for this brick.
  */
 #define ioc_get_jpeg_compression_quality(b) ((os_int)((b)->compression_quality))
@@ -0,0 +1,413 @@
+/**
+
+  @file    ioc_brick_hub.c
+  @brief   Distribute bricks received from one device to many consumers.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_BRICK_HUB_SUPPORT
+
+/* Forward referred static functions.
+ */
+static osalStatus ioc_brick_hub_received(
+    iocBrickBuffer *b,
+    void *context);
+
+static osalStatus ioc_brick_hub_deliver(
+    iocBrickHubConsumer *c);
+
+static void ioc_brick_hub_set_pending(
+    iocBrickHubConsumer *c,
+    iocBrickHubFrame *frame);
+
+
+/**
+****************************************************************************************************
+
+  @brief Initialize brick hub.
+  @anchor ioc_initialize_brick_hub
+
+  The ioc_initialize_brick_hub() function sets up the hub and takes over brick received
+  callback of the receiving brick buffer.
+
+  @param   hub Pointer to brick hub structure to initialize.
+  @param   in Brick buffer receiving from the device, initialized by
+           ioc_initialize_brick_buffer() as controller end.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_initialize_brick_hub(
+    iocBrickHub *hub,
+    iocBrickBuffer *in)
+{
+    os_memclear(hub, sizeof(iocBrickHub));
+    hub->in = in;
+#if OSAL_MULTITHREAD_SUPPORT
+    hub->mutex = osal_mutex_create();
+#endif
+    ioc_set_brick_received_callback(in, ioc_brick_hub_received, hub);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release brick hub.
+  @anchor ioc_release_brick_hub
+
+  Removes all consumers and releases pending frames. Brick buffers are not released.
+
+  @param   hub Pointer to brick hub.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_brick_hub(
+    iocBrickHub *hub)
+{
+    while (hub->first)
+    {
+        ioc_remove_brick_hub_consumer(hub->first);
+    }
+    ioc_brick_set_receive(hub->in, OS_FALSE);
+    ioc_set_brick_received_callback(hub->in, OS_NULL, OS_NULL);
+
+#if OSAL_MULTITHREAD_SUPPORT
+    if (hub->mutex)
+    {
+        osal_mutex_delete(hub->mutex);
+        hub->mutex = OS_NULL;
+    }
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add consumer to brick hub.
+  @anchor ioc_add_brick_hub_consumer
+
+  @param   hub Pointer to brick hub.
+  @param   consumer Consumer structure, allocated by application.
+  @param   prm Consumer parameters, either local callback function or remote brick buffer.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_add_brick_hub_consumer(
+    iocBrickHub *hub,
+    iocBrickHubConsumer *consumer,
+    const iocBrickHubConsumerParams *prm)
+{
+    os_memclear(consumer, sizeof(iocBrickHubConsumer));
+    os_memcpy(&consumer->prm, prm, sizeof(iocBrickHubConsumerParams));
+    consumer->hub = hub;
+
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_lock(hub->mutex);
+#endif
+    consumer->prev = hub->last;
+    if (hub->last) {
+        hub->last->next = consumer;
+    }
+    else {
+        hub->first = consumer;
+    }
+    hub->last = consumer;
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_unlock(hub->mutex);
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remove consumer from brick hub.
+  @anchor ioc_remove_brick_hub_consumer
+
+  @param   consumer Consumer to remove.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_remove_brick_hub_consumer(
+    iocBrickHubConsumer *consumer)
+{
+    iocBrickHub *hub;
+
+    hub = consumer->hub;
+    if (hub == OS_NULL) return;
+
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_lock(hub->mutex);
+#endif
+    if (consumer->prev) {
+        consumer->prev->next = consumer->next;
+    }
+    else {
+        hub->first = consumer->next;
+    }
+    if (consumer->next) {
+        consumer->next->prev = consumer->prev;
+    }
+    else {
+        hub->last = consumer->prev;
+    }
+    ioc_brick_hub_set_pending(consumer, OS_NULL);
+    consumer->hub = OS_NULL;
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_unlock(hub->mutex);
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Receive from device and deliver to consumers.
+  @anchor ioc_run_brick_hub
+
+  The ioc_run_brick_hub() function is called repeatedly from controller's loop or thread.
+  Receiving from device is enabled only if there is a local consumer or a connected remote
+  consumer. Pending bricks are delivered to consumers which are ready, and remote consumers'
+  brick transfer is run.
+
+  @param   hub Pointer to brick hub.
+  @return  OSAL_SUCCESS if work was done, OSAL_NOTHING_TO_DO if idle. Other values indicate
+           error receiving from device.
+
+****************************************************************************************************
+*/
+osalStatus ioc_run_brick_hub(
+    iocBrickHub *hub)
+{
+    iocBrickHubConsumer *c;
+    os_boolean wanted;
+    osalStatus s, rval = OSAL_NOTHING_TO_DO;
+
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_lock(hub->mutex);
+#endif
+
+    wanted = OS_FALSE;
+    for (c = hub->first; c; c = c->next)
+    {
+        if (c->prm.out == OS_NULL || ioc_is_brick_connected(c->prm.out)) {
+            wanted = OS_TRUE;
+            break;
+        }
+    }
+    ioc_brick_set_receive(hub->in, wanted);
+
+    s = ioc_run_brick_receive(hub->in);
+    if (s == OSAL_COMPLETED) {
+        rval = OSAL_SUCCESS;
+    }
+    else if (OSAL_IS_ERROR(s)) {
+        rval = s;
+    }
+
+    for (c = hub->first; c; c = c->next)
+    {
+        if (c->pending)
+        {
+            if (ioc_brick_hub_deliver(c) == OSAL_SUCCESS && rval == OSAL_NOTHING_TO_DO) {
+                rval = OSAL_SUCCESS;
+            }
+        }
+        if (c->prm.out)
+        {
+            s = ioc_run_brick_send(c->prm.out);
+            if (s == OSAL_SUCCESS && rval == OSAL_NOTHING_TO_DO) {
+                rval = OSAL_SUCCESS;
+            }
+        }
+    }
+
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_unlock(hub->mutex);
+#endif
+    return rval;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick received from device (internal).
+  @anchor ioc_brick_hub_received
+
+  Brick received callback of the receiving brick buffer. Copies the brick into a shared frame
+  and makes it pending for every consumer according to consumer's drop policy. Called from
+  ioc_run_brick_hub() with hub's mutex locked.
+
+  @param   b Pointer to receiving brick buffer.
+  @param   context Pointer to brick hub.
+  @return  OSAL_SUCCESS, or OSAL_STATUS_MEMORY_ALLOCATION_FAILED.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_brick_hub_received(
+    iocBrickBuffer *b,
+    void *context)
+{
+    iocBrickHub *hub;
+    iocBrickHubConsumer *c;
+    iocBrickHubFrame *frame;
+    os_memsz alloc_sz;
+
+    hub = (iocBrickHub*)context;
+    hub->received++;
+    if (hub->first == OS_NULL || b->buf == OS_NULL ||
+        b->buf_sz <= (os_memsz)sizeof(iocBrickHdr))
+    {
+        return OSAL_SUCCESS;
+    }
+
+    frame = (iocBrickHubFrame*)os_malloc(sizeof(iocBrickHubFrame) + b->buf_sz, &alloc_sz);
+    if (frame == OS_NULL) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+    frame->ref_count = 0;
+    frame->buf_sz = b->buf_sz;
+    frame->alloc_sz = alloc_sz;
+    os_memcpy(ioc_brick_hub_frame_buf(frame), b->buf, b->buf_sz);
+
+    for (c = hub->first; c; c = c->next)
+    {
+        if (c->pending)
+        {
+            c->dropped++;
+            if (c->prm.out) ioc_brick_frame_skipped(c->prm.out);
+            if (c->prm.policy == IOC_BRICK_HUB_KEEP_PENDING) continue;
+        }
+        ioc_brick_hub_set_pending(c, frame);
+    }
+
+    if (frame->ref_count == 0) {
+        os_free(frame, frame->alloc_sz);
+    }
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Deliver pending frame to consumer (internal).
+  @anchor ioc_brick_hub_deliver
+
+  Local consumer: Call consumer's callback function. Remote consumer: Store brick into
+  consumer's sending brick buffer if ready, compressing it if needed.
+
+  @param   c Pointer to consumer with pending frame.
+  @return  OSAL_SUCCESS if frame was delivered, OSAL_PENDING if consumer is not ready.
+           Other values indicate that the frame was dropped because of an error.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_brick_hub_deliver(
+    iocBrickHubConsumer *c)
+{
+    iocBrickHdr *hdr;
+    os_uchar *buf, compression;
+    os_int w, h;
+    osalStatus s;
+
+    if (c->prm.min_interval_ms &&
+        !os_has_elapsed(&c->delivered_timer, c->prm.min_interval_ms))
+    {
+        return OSAL_PENDING;
+    }
+
+    buf = ioc_brick_hub_frame_buf(c->pending);
+    if (c->prm.func)
+    {
+        s = c->prm.func(c, buf, c->pending->buf_sz, c->prm.context);
+    }
+    else
+    {
+        if (!ioc_is_brick_connected(c->prm.out)) {
+            s = OSAL_STATUS_NOT_CONNECTED;
+        }
+        else if (!ioc_ready_for_new_brick(c->prm.out)) {
+            return OSAL_PENDING;
+        }
+        else
+        {
+            hdr = (iocBrickHdr*)buf;
+            w = (os_int)ioc_get_brick_hdr_int(hdr->width, IOC_BRICK_DIM_SZ);
+            h = (os_int)ioc_get_brick_hdr_int(hdr->height, IOC_BRICK_DIM_SZ);
+            /* Tiled bricks arrive assembled. JPEG from device and sample batches are
+               forwarded as is.
+             */
+            if (hdr->compression & IOC_JPEG) {
+                compression = IOC_JPEG;
+            }
+            else if (hdr->compression == IOC_SAMPLES) {
+                compression = IOC_SAMPLES;
+            }
+            else {
+                compression = c->prm.compression;
+            }
+            s = ioc_compress_brick(c->prm.out, hdr, buf + sizeof(iocBrickHdr),
+                c->pending->buf_sz - sizeof(iocBrickHdr), (osalBitmapFormat)hdr->format,
+                w, h, compression);
+        }
+    }
+
+    if (s == OSAL_PENDING) return s;
+
+    if (s == OSAL_SUCCESS) {
+        c->delivered++;
+        os_get_timer(&c->delivered_timer);
+    }
+    else {
+        c->dropped++;
+    }
+    ioc_brick_hub_set_pending(c, OS_NULL);
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set consumer's pending frame (internal).
+  @anchor ioc_brick_hub_set_pending
+
+  Releases reference to previous pending frame, frees it if this was the last reference.
+
+  @param   c Pointer to consumer.
+  @param   frame New pending frame, OS_NULL to clear.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_brick_hub_set_pending(
+    iocBrickHubConsumer *c,
+    iocBrickHubFrame *frame)
+{
+    if (c->pending)
+    {
+        if (--(c->pending->ref_count) <= 0) {
+            os_free(c->pending, c->pending->alloc_sz);
+        }
+    }
+    c->pending = frame;
+    if (frame) {
+        frame->ref_count++;
+    }
+}
+
+#endif
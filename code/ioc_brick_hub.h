@@ -0,0 +1,203 @@
+/**
+
+  @file    ioc_brick_hub.h
+  @brief   Distribute bricks received from one device to many consumers.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  When several clients want the same camera stream, each having its own brick buffer would
+  make the device send every image once per client. The brick hub receives bricks once from
+  the device and republishes them to local consumers (callback functions, like recorders)
+  and remote consumers (sending brick buffers on controller's own memory blocks, like
+  Python viewers connecting to the controller).
+
+  Received brick is kept in a reference counted frame shared by all consumers. Each consumer
+  has one pending frame and a drop policy, which decides what happens when a new brick
+  arrives before the previous one has been delivered: IOC_BRICK_HUB_KEEP_LATEST replaces
+  pending frame with the new one (live view), IOC_BRICK_HUB_KEEP_PENDING drops the new one.
+  Slow consumers never hold back the device or other consumers. Receiving from device is
+  turned on only while some consumer is connected.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_BRICK_HUB_H_
+#define IOC_BRICK_HUB_H_
+#include "iocom.h"
+
+#if IOC_BRICK_HUB_SUPPORT
+
+struct iocBrickHub;
+struct iocBrickHubConsumer;
+
+/* Consumer drop policy.
+ */
+typedef enum iocBrickHubPolicy
+{
+    IOC_BRICK_HUB_KEEP_LATEST = 0,
+    IOC_BRICK_HUB_KEEP_PENDING = 1
+}
+iocBrickHubPolicy;
+
+
+/**
+****************************************************************************************************
+    Reference counted copy of received brick, shared by consumers. Brick (header and data)
+    follows this structure in the same memory allocation.
+****************************************************************************************************
+*/
+typedef struct iocBrickHubFrame
+{
+    os_int ref_count;
+    os_memsz buf_sz;
+    os_memsz alloc_sz;
+}
+iocBrickHubFrame;
+
+/* Get pointer to brick within frame.
+ */
+#define ioc_brick_hub_frame_buf(f) ((os_uchar*)((f) + 1))
+
+/* Local consumer callback. Called from ioc_run_brick_hub() with brick (header and data).
+   Return OSAL_PENDING if the consumer is busy and brick should be offered again later.
+ */
+typedef osalStatus ioc_brick_hub_callback(
+    struct iocBrickHubConsumer *consumer,
+    const os_uchar *buf,
+    os_memsz buf_sz,
+    void *context);
+
+
+/**
+****************************************************************************************************
+    Parameters for ioc_add_brick_hub_consumer(). Set either func (local consumer) or out
+    (remote consumer).
+****************************************************************************************************
+*/
+typedef struct iocBrickHubConsumerParams
+{
+    /** Drop policy, and minimum interval between bricks delivered, ms (0 = no limit).
+     */
+    iocBrickHubPolicy policy;
+    os_int min_interval_ms;
+
+    /** Local consumer: callback function and application context.
+     */
+    ioc_brick_hub_callback *func;
+    void *context;
+
+    /** Remote consumer: brick buffer initialized as sending end, and compression to use
+        for uncompressed bricks: IOC_UNCOMPRESSED or IOC_DEFAULT_COMPRESSION to JPEG
+        compress. Tiled bricks arrive at the hub already assembled into uncompressed
+        frames and are compressed like any other. Only JPEG bricks and sample batches
+        (IOC_SAMPLES) are forwarded as is.
+     */
+    iocBrickBuffer *out;
+    os_uchar compression;
+}
+iocBrickHubConsumerParams;
+
+
+/**
+****************************************************************************************************
+    Brick hub consumer. Allocated by application, must exist until removed.
+****************************************************************************************************
+*/
+typedef struct iocBrickHubConsumer
+{
+    struct iocBrickHub *hub;
+    iocBrickHubConsumerParams prm;
+
+    /** Frame waiting for delivery, OS_NULL if none.
+     */
+    iocBrickHubFrame *pending;
+
+    /** Time when previous brick was delivered.
+     */
+    os_timer delivered_timer;
+
+    /** Number of bricks delivered and dropped.
+     */
+    os_uint delivered;
+    os_uint dropped;
+
+    /** Consumer list.
+     */
+    struct iocBrickHubConsumer *next, *prev;
+}
+iocBrickHubConsumer;
+
+
+/**
+****************************************************************************************************
+    Brick hub.
+****************************************************************************************************
+*/
+typedef struct iocBrickHub
+{
+    /** Brick buffer receiving from the device.
+     */
+    iocBrickBuffer *in;
+
+    /** Consumer list.
+     */
+    iocBrickHubConsumer *first, *last;
+
+    /** Number of bricks received from device.
+     */
+    os_uint received;
+
+#if OSAL_MULTITHREAD_SUPPORT
+    /** Consumers can be added and removed from other threads.
+     */
+    osalMutex mutex;
+#endif
+}
+iocBrickHub;
+
+
+/**
+****************************************************************************************************
+  Brick hub functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Initialize brick hub.
+ */
+void ioc_initialize_brick_hub(
+    iocBrickHub *hub,
+    iocBrickBuffer *in);
+
+/* Release brick hub, removes all consumers.
+ */
+void ioc_release_brick_hub(
+    iocBrickHub *hub);
+
+/* Add consumer to brick hub.
+ */
+void ioc_add_brick_hub_consumer(
+    iocBrickHub *hub,
+    iocBrickHubConsumer *consumer,
+    const iocBrickHubConsumerParams *prm);
+
+/* Remove consumer from brick hub.
+ */
+void ioc_remove_brick_hub_consumer(
+    iocBrickHubConsumer *consumer);
+
+/* Receive from device and deliver to consumers, call repeatedly.
+ */
+osalStatus ioc_run_brick_hub(
+    iocBrickHub *hub);
+
+/*@}*/
+
+#endif
+#endif
@@ -0,0 +1,723 @@
+/**
+
+  @file    ioc_brick_tiles.c
+  @brief   Tiled brick transfer, send only changed parts of camera image.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_BRICK_TILES_SUPPORT
+
+/* Forward referred static functions.
+ */
+static os_int ioc_brick_tile_diff(
+    iocBrickTiles *t,
+    const os_uchar *data,
+    os_int col,
+    os_int row,
+    os_boolean update);
+
+static void ioc_brick_tile_rect(
+    os_int tile_w,
+    os_int tile_h,
+    os_int frame_w,
+    os_int frame_h,
+    os_int col,
+    os_int row,
+    os_int *x,
+    os_int *y,
+    os_int *w,
+    os_int *h);
+
+static void ioc_set_brick_tiles_int(
+    os_uchar *dst,
+    os_ulong x,
+    os_int nro_bytes);
+
+
+/**
+****************************************************************************************************
+
+  @brief Initialize tiled brick sender.
+  @anchor ioc_initialize_brick_tiles
+
+  The ioc_initialize_brick_tiles() function sets up tiled brick sender state. Memory is
+  allocated when the first frame is stored. JPEG compressed tiles work best when tile size
+  is multiple of 16 pixels.
+
+  @param   t Pointer to tiled brick sender state to initialize.
+  @param   brick Brick buffer used to send, initialized as sending end.
+  @param   tile_w Tile width in pixels.
+  @param   tile_h Tile height in pixels.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_initialize_brick_tiles(
+    iocBrickTiles *t,
+    iocBrickBuffer *brick,
+    os_int tile_w,
+    os_int tile_h)
+{
+    os_memclear(t, sizeof(iocBrickTiles));
+    t->brick = brick;
+    t->tile_w = tile_w < IOC_BRICK_TILE_SAMPLES ? IOC_BRICK_TILE_SAMPLES : tile_w;
+    t->tile_h = tile_h < IOC_BRICK_TILE_SAMPLES ? IOC_BRICK_TILE_SAMPLES : tile_h;
+    t->threshold = IOC_BRICK_TILE_THRESHOLD;
+    t->keyframe_ms = IOC_BRICK_TILE_KEYFRAME_MS;
+    t->keyframe_needed = OS_TRUE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release tiled brick sender.
+  @anchor ioc_release_brick_tiles
+
+  @param   t Pointer to tiled brick sender state.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_brick_tiles(
+    iocBrickTiles *t)
+{
+    if (t->samples)
+    {
+        os_free(t->samples, t->samples_alloc_sz);
+        t->samples = OS_NULL;
+    }
+    if (t->enc)
+    {
+        os_free(t->enc, t->enc_alloc_sz);
+        t->enc = OS_NULL;
+    }
+    t->frame_w = t->frame_h = 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set region of interest.
+  @anchor ioc_set_brick_tiles_roi
+
+  Tiles overlapping the region of interest are sent with every frame, whether changed or not.
+  Tiles outside it are sent only when changed.
+
+  @param   t Pointer to tiled brick sender state.
+  @param   x Left edge of the region, pixels.
+  @param   y Top edge of the region, pixels.
+  @param   w Width of the region, 0 to clear region of interest.
+  @param   h Height of the region.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_set_brick_tiles_roi(
+    iocBrickTiles *t,
+    os_int x,
+    os_int y,
+    os_int w,
+    os_int h)
+{
+    t->roi_x = x;
+    t->roi_y = y;
+    t->roi_w = w > 0 && h > 0 ? w : 0;
+    t->roi_h = w > 0 && h > 0 ? h : 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Send all tiles with next frame.
+  @anchor ioc_brick_tiles_keyframe
+
+  @param   t Pointer to tiled brick sender state.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_brick_tiles_keyframe(
+    iocBrickTiles *t)
+{
+    t->keyframe_needed = OS_TRUE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Store changed tiles of image into brick buffer.
+  @anchor ioc_compress_brick_tiles
+
+  The ioc_compress_brick_tiles() function is used instead of ioc_compress_brick() to send
+  camera image as tiled brick. Tiles which have changed or overlap region of interest are
+  copied or JPEG compressed into the brick. If no tile has changed, nothing is stored.
+
+  Image which is already JPEG compressed by camera cannot be tiled and is passed to
+  ioc_compress_brick() as is. If tiled data would not fit into the brick, full frame is
+  sent instead.
+
+  @param  t Pointer to tiled brick sender state.
+  @param  hdr Brick header to save.
+  @param  data Uncompressed source image.
+  @param  data_sz Data size in bytes.
+  @param  format Source data format, like OSAL_GRAYSCALE8 or OSAL_RGB24.
+  @param  w Source image width in pixels.
+  @param  h Source image height in pixels.
+  @param  compression How to compress tiles: IOC_UNCOMPRESSED, IOC_JPEG or
+          IOC_DEFAULT_COMPRESSION.
+  @return OSAL_SUCCESS if brick was stored. OSAL_NOTHING_TO_DO if no tile has changed.
+          Other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus ioc_compress_brick_tiles(
+    iocBrickTiles *t,
+    iocBrickHdr *hdr,
+    os_uchar *data,
+    os_memsz data_sz,
+    osalBitmapFormat format,
+    os_int w,
+    os_int h,
+    os_uchar compression)
+{
+    iocBrickBuffer *b;
+    iocBrickHdr thdr;
+    iocBrickTilesHdr *tshdr;
+    iocBrickTileHdr *tile;
+    os_uchar *src, *dst;
+    os_memsz frame_sz, enc_max, pos, sz;
+    os_int bytes_per_pix, col, row, x, y, tw, th, i, n, nro_tiles;
+    os_boolean keyframe, send;
+    osalStatus s;
+#if OSAL_USE_JPEG_LIBRARY
+    os_int quality = 0;
+#endif
+
+    b = t->brick;
+    if (b->tile_keyframe_request)
+    {
+        t->keyframe_needed = OS_TRUE;
+        b->tile_keyframe_request = OS_FALSE;
+    }
+    if (hdr->compression & IOC_JPEG)
+    {
+        t->keyframe_needed = OS_TRUE;
+        return ioc_compress_brick(b, hdr, data, data_sz, format, w, h, compression);
+    }
+
+    if (compression == IOC_DEFAULT_COMPRESSION)
+    {
+#if OSAL_USE_JPEG_LIBRARY
+        compression = IOC_JPEG;
+#else
+        compression = IOC_UNCOMPRESSED;
+#endif
+    }
+
+    bytes_per_pix = OSAL_BITMAP_BYTES_PER_PIX(format);
+    frame_sz = w * (os_memsz)h * bytes_per_pix;
+    if (w < 1 || h < 1 || data_sz < frame_sz) return OSAL_STATUS_FAILED;
+
+    /* Maximum size of tiled data: Brick validation requires that brick is no bigger
+       than uncompressed frame, and it must fit into brick buffer.
+     */
+    enc_max = frame_sz;
+#if IOC_BRICK_RING_BUFFER_SUPPORT
+    if (!b->signals->flat_buffer) {
+        sz = b->buf_sz - (os_memsz)sizeof(iocBrickHdr);
+    }
+    else
+#endif
+    {
+        sz = b->signals->buf->n - (os_memsz)sizeof(iocBrickHdr);
+    }
+    if (sz < enc_max) enc_max = sz;
+
+    /* If image geometry changed, allocate new buffers.
+     */
+    if (w != t->frame_w || h != t->frame_h || format != t->format || t->samples == OS_NULL)
+    {
+        ioc_release_brick_tiles(t);
+        t->cols = (w + t->tile_w - 1) / t->tile_w;
+        t->rows = (h + t->tile_h - 1) / t->tile_h;
+        sz = t->cols * (os_memsz)t->rows * IOC_BRICK_TILE_SAMPLES * IOC_BRICK_TILE_SAMPLES;
+        t->samples = (os_uchar*)os_malloc(sz, &t->samples_alloc_sz);
+        t->enc = (os_uchar*)os_malloc(frame_sz, &t->enc_alloc_sz);
+        if (t->samples == OS_NULL || t->enc == OS_NULL)
+        {
+            ioc_release_brick_tiles(t);
+            return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+        }
+        t->frame_w = w;
+        t->frame_h = h;
+        t->format = format;
+        t->keyframe_needed = OS_TRUE;
+    }
+
+    /* Receiver which connects needs full image, and periodic key frames recover from lost
+       bricks.
+     */
+    if (!ioc_is_brick_connected(b)) {
+        t->keyframe_needed = OS_TRUE;
+    }
+    if (t->keyframe_ms && os_has_elapsed(&t->keyframe_timer, t->keyframe_ms)) {
+        t->keyframe_needed = OS_TRUE;
+    }
+    keyframe = t->keyframe_needed;
+
+#if OSAL_USE_JPEG_LIBRARY
+    if (compression & IOC_JPEG) {
+        quality = ioc_get_jpeg_compression_quality(b);
+    }
+#endif
+
+    nro_tiles = t->cols * t->rows;
+    pos = sizeof(iocBrickTilesHdr);
+    if (pos > enc_max) goto send_full_frame;
+    n = 0;
+
+    for (row = 0; row < t->rows; row++)
+    {
+        for (col = 0; col < t->cols; col++)
+        {
+            ioc_brick_tile_rect(t->tile_w, t->tile_h, w, h, col, row, &x, &y, &tw, &th);
+
+            send = keyframe;
+            if (!send && t->roi_w) {
+                send = (os_boolean)(x < t->roi_x + t->roi_w && x + tw > t->roi_x &&
+                    y < t->roi_y + t->roi_h && y + th > t->roi_y);
+            }
+            if (!send) {
+                send = (os_boolean)(ioc_brick_tile_diff(t, data, col, row, OS_FALSE) > t->threshold);
+            }
+            if (!send) continue;
+
+            if (pos + (os_memsz)sizeof(iocBrickTileHdr) > enc_max) goto send_full_frame;
+            tile = (iocBrickTileHdr*)(t->enc + pos);
+            pos += sizeof(iocBrickTileHdr);
+            src = data + (y * (os_memsz)w + x) * bytes_per_pix;
+
+#if OSAL_USE_JPEG_LIBRARY
+            if (compression & IOC_JPEG)
+            {
+                s = os_compress_JPEG((const os_char*)src, tw, th, w * bytes_per_pix, format,
+                    quality, OS_NULL, (os_char*)t->enc + pos, enc_max - pos, &sz,
+                    OSAL_JPEG_DEFAULT);
+                if (s) goto send_full_frame;
+                tile->compression = IOC_JPEG;
+            }
+            else
+#endif
+            {
+                sz = tw * (os_memsz)th * bytes_per_pix;
+                if (pos + sz > enc_max) goto send_full_frame;
+                dst = t->enc + pos;
+                for (i = 0; i < th; i++)
+                {
+                    os_memcpy(dst, src, tw * bytes_per_pix);
+                    dst += tw * bytes_per_pix;
+                    src += w * (os_memsz)bytes_per_pix;
+                }
+                tile->compression = IOC_UNCOMPRESSED;
+            }
+
+            ioc_set_brick_tiles_int(tile->col, col, IOC_BRICK_DIM_SZ);
+            ioc_set_brick_tiles_int(tile->row, row, IOC_BRICK_DIM_SZ);
+            ioc_set_brick_tiles_int(tile->sz, sz, IOC_BRICK_BYTES_SZ);
+            pos += sz;
+            n++;
+
+            ioc_brick_tile_diff(t, data, col, row, OS_TRUE);
+        }
+    }
+
+    if (n == 0)
+    {
+        t->tiles_skipped += nro_tiles;
+        return OSAL_NOTHING_TO_DO;
+    }
+
+    tshdr = (iocBrickTilesHdr*)t->enc;
+    ioc_set_brick_tiles_int(tshdr->tile_w, t->tile_w, IOC_BRICK_DIM_SZ);
+    ioc_set_brick_tiles_int(tshdr->tile_h, t->tile_h, IOC_BRICK_DIM_SZ);
+    ioc_set_brick_tiles_int(tshdr->nro_tiles, n, IOC_BRICK_DIM_SZ);
+    tshdr->flags = keyframe ? IOC_BRICK_TILES_KEYFRAME : 0;
+    tshdr->reserved = 0;
+
+#if OSAL_USE_JPEG_LIBRARY
+    if (compression & IOC_JPEG)
+    {
+        i = (os_int)(h * (os_long)n / nro_tiles);
+        ioc_adjust_jpeg_compression_quality(b, format, w, i > 0 ? i : 1,
+            quality, OSAL_SUCCESS, pos);
+    }
+#endif
+
+    os_memcpy(&thdr, hdr, sizeof(iocBrickHdr));
+    ioc_set_brick_tiles_int(thdr.alloc_sz, frame_sz + sizeof(iocBrickHdr), IOC_BRICK_BYTES_SZ);
+    s = ioc_compress_brick(b, &thdr, t->enc, pos, format, w, h, IOC_TILED);
+    if (s) {
+        t->keyframe_needed = OS_TRUE;
+        return s;
+    }
+
+    t->tiles_sent += n;
+    t->tiles_skipped += nro_tiles - n;
+    if (keyframe) {
+        os_get_timer(&t->keyframe_timer);
+        t->keyframe_needed = OS_FALSE;
+    }
+    return OSAL_SUCCESS;
+
+send_full_frame:
+    /* Tiled data does not fit, send whole frame as normal brick. Receiver updates its
+       assembled frame from uncompressed full frame, but JPEG full frame needs a tiled
+       key frame later.
+     */
+    s = ioc_compress_brick(b, hdr, data, frame_sz, format, w, h, compression);
+    if (s == OSAL_SUCCESS && (compression & IOC_JPEG) == 0)
+    {
+        for (row = 0; row < t->rows; row++) {
+            for (col = 0; col < t->cols; col++) {
+                ioc_brick_tile_diff(t, data, col, row, OS_TRUE);
+            }
+        }
+        t->tiles_sent += nro_tiles;
+        os_get_timer(&t->keyframe_timer);
+        t->keyframe_needed = OS_FALSE;
+    }
+    else
+    {
+        t->keyframe_needed = OS_TRUE;
+    }
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Update receiver's assembled frame with received brick.
+  @anchor ioc_assemble_brick_tiles
+
+  The ioc_assemble_brick_tiles() function is called by ioc_brick.c when a complete brick has
+  been received and checksum verified, before brick received callback. Tiles of tiled brick
+  are decoded into assembled frame, and the received brick in b->buf is replaced by full
+  uncompressed frame. Uncompressed full frame replaces the assembled frame. Other bricks
+  are passed as is.
+
+  Tiles are never drawn without a key frame below them. If there is no assembled frame and
+  tiled brick is not a key frame, the brick is dropped and b->tile_keyframe_request is set.
+  ioc_brick.c passes the request to the sender: flat buffer acknowledges the brick with
+  negative cmd value, ring buffer closes the stream.
+
+  @param   b Pointer to receiving brick buffer, b->buf holds the received brick.
+  @return  OSAL_SUCCESS if all is fine. OSAL_PENDING if tiled brick was dropped while waiting
+           for key frame. Other values indicate corrupted tiled brick or memory allocation
+           failure.
+
+****************************************************************************************************
+*/
+osalStatus ioc_assemble_brick_tiles(
+    iocBrickBuffer *b)
+{
+    iocBrickHdr rhdr, *fhdr;
+    iocBrickTilesHdr *tshdr;
+    iocBrickTileHdr *tile;
+    os_uchar *p, *e, *src, *dst;
+    os_memsz frame_sz, sz;
+    os_int w, h, bytes_per_pix, tile_w, tile_h, n, col, row, x, y, tw, th, i;
+    osalStatus s = OSAL_SUCCESS;
+#if OSAL_USE_JPEG_LIBRARY
+    osalJpegMallocContext alloc_context;
+#endif
+
+    if (b->buf == OS_NULL || b->buf_sz < (os_memsz)sizeof(iocBrickHdr)) {
+        return OSAL_SUCCESS;
+    }
+    os_memcpy(&rhdr, b->buf, sizeof(iocBrickHdr));
+    w = (os_int)ioc_get_brick_hdr_int(rhdr.width, IOC_BRICK_DIM_SZ);
+    h = (os_int)ioc_get_brick_hdr_int(rhdr.height, IOC_BRICK_DIM_SZ);
+    bytes_per_pix = OSAL_BITMAP_BYTES_PER_PIX(rhdr.format);
+    frame_sz = w * (os_memsz)h * bytes_per_pix + sizeof(iocBrickHdr);
+
+    /* Check if assembled frame matches image geometry.
+     */
+    fhdr = (iocBrickHdr*)b->tile_frame;
+    if (fhdr && (fhdr->format != rhdr.format ||
+        os_memcmp(fhdr->width, rhdr.width, IOC_BRICK_DIM_SZ) ||
+        os_memcmp(fhdr->height, rhdr.height, IOC_BRICK_DIM_SZ)))
+    {
+        fhdr = OS_NULL;
+    }
+
+    if (rhdr.compression != IOC_TILED)
+    {
+        /* Uncompressed full frame becomes assembled frame, also when there was none. Anything
+           else invalidates it, so that tiles are not drawn over stale image.
+         */
+        if (rhdr.compression == IOC_UNCOMPRESSED && b->buf_sz == frame_sz)
+        {
+            if (fhdr == OS_NULL)
+            {
+                ioc_free_brick_tiles_frame(b);
+                b->tile_frame = (os_uchar*)os_malloc(frame_sz, &b->tile_frame_alloc_sz);
+                if (b->tile_frame == OS_NULL) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+            }
+            os_memcpy(b->tile_frame, b->buf, frame_sz);
+        }
+        else {
+            ioc_free_brick_tiles_frame(b);
+        }
+        return OSAL_SUCCESS;
+    }
+
+    p = b->buf + sizeof(iocBrickHdr);
+    e = b->buf + b->buf_sz;
+    if (p + sizeof(iocBrickTilesHdr) > e) return OSAL_STATUS_FAILED;
+    tshdr = (iocBrickTilesHdr*)p;
+    tile_w = (os_int)ioc_get_brick_hdr_int(tshdr->tile_w, IOC_BRICK_DIM_SZ);
+    tile_h = (os_int)ioc_get_brick_hdr_int(tshdr->tile_h, IOC_BRICK_DIM_SZ);
+    n = (os_int)ioc_get_brick_hdr_int(tshdr->nro_tiles, IOC_BRICK_DIM_SZ);
+    if (tile_w < 1 || tile_h < 1) return OSAL_STATUS_FAILED;
+    p += sizeof(iocBrickTilesHdr);
+
+    /* Without assembled frame only key frame can be used, otherwise ask sender for one.
+     */
+    if (fhdr == OS_NULL)
+    {
+        ioc_free_brick_tiles_frame(b);
+        if ((tshdr->flags & IOC_BRICK_TILES_KEYFRAME) == 0)
+        {
+            b->tile_keyframe_request = OS_TRUE;
+            return OSAL_PENDING;
+        }
+        b->tile_frame = (os_uchar*)os_malloc(frame_sz, &b->tile_frame_alloc_sz);
+        if (b->tile_frame == OS_NULL) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+        os_memclear(b->tile_frame, frame_sz);
+        os_memcpy(b->tile_frame, &rhdr, sizeof(iocBrickHdr));
+    }
+
+    /* Decode tiles.
+     */
+
+    while (n--)
+    {
+        if (p + sizeof(iocBrickTileHdr) > e) return OSAL_STATUS_FAILED;
+        tile = (iocBrickTileHdr*)p;
+        p += sizeof(iocBrickTileHdr);
+        col = (os_int)ioc_get_brick_hdr_int(tile->col, IOC_BRICK_DIM_SZ);
+        row = (os_int)ioc_get_brick_hdr_int(tile->row, IOC_BRICK_DIM_SZ);
+        sz = (os_memsz)ioc_get_brick_hdr_int(tile->sz, IOC_BRICK_BYTES_SZ);
+        if (col * (os_long)tile_w >= w || row * (os_long)tile_h >= h || sz > e - p) {
+            return OSAL_STATUS_FAILED;
+        }
+        ioc_brick_tile_rect(tile_w, tile_h, w, h, col, row, &x, &y, &tw, &th);
+
+        src = p;
+#if OSAL_USE_JPEG_LIBRARY
+        os_memclear(&alloc_context, sizeof(alloc_context));
+        if (tile->compression & IOC_JPEG)
+        {
+            s = os_uncompress_JPEG(p, sz, &alloc_context, OSAL_JPEG_DEFAULT);
+            if (s == OSAL_SUCCESS && alloc_context.nbytes != tw * (os_memsz)th * bytes_per_pix) {
+                s = OSAL_STATUS_FAILED;
+            }
+            if (s) {
+                os_free(alloc_context.buf, alloc_context.buf_sz);
+                return s;
+            }
+            src = (os_uchar*)alloc_context.buf;
+        }
+        else
+#endif
+        if (tile->compression != IOC_UNCOMPRESSED ||
+            sz != tw * (os_memsz)th * bytes_per_pix)
+        {
+            return OSAL_STATUS_NOT_SUPPORTED;
+        }
+
+        dst = b->tile_frame + sizeof(iocBrickHdr) + (y * (os_memsz)w + x) * bytes_per_pix;
+        for (i = 0; i < th; i++)
+        {
+            os_memcpy(dst, src, tw * bytes_per_pix);
+            src += tw * bytes_per_pix;
+            dst += w * (os_memsz)bytes_per_pix;
+        }
+
+#if OSAL_USE_JPEG_LIBRARY
+        if (alloc_context.buf) {
+            os_free(alloc_context.buf, alloc_context.buf_sz);
+        }
+#endif
+        p += sz;
+    }
+
+    /* Replace received brick with assembled frame.
+     */
+    if (b->buf_alloc_sz < frame_sz)
+    {
+        os_free(b->buf, b->buf_alloc_sz);
+        b->buf = (os_uchar*)os_malloc(frame_sz, &b->buf_alloc_sz);
+        if (b->buf == OS_NULL) {
+            b->buf_alloc_sz = b->buf_sz = 0;
+            return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+        }
+    }
+    os_memcpy(b->buf, b->tile_frame, frame_sz);
+    fhdr = (iocBrickHdr*)b->buf;
+    fhdr->compression = IOC_UNCOMPRESSED;
+    fhdr->checksum[0] = fhdr->checksum[1] = 0;
+    ioc_set_brick_tiles_int(fhdr->buf_sz, frame_sz, IOC_BRICK_BYTES_SZ);
+    ioc_set_brick_tiles_int(fhdr->alloc_sz, frame_sz, IOC_BRICK_BYTES_SZ);
+    os_memcpy(fhdr->tstamp, rhdr.tstamp, IOC_BRICK_TSTAMP_SZ);
+    b->buf_sz = frame_sz;
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Free receiver's assembled frame.
+  @anchor ioc_free_brick_tiles_frame
+
+  @param   b Pointer to receiving brick buffer.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_free_brick_tiles_frame(
+    iocBrickBuffer *b)
+{
+    if (b->tile_frame)
+    {
+        os_free(b->tile_frame, b->tile_frame_alloc_sz);
+        b->tile_frame = OS_NULL;
+        b->tile_frame_alloc_sz = 0;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Compare tile against samples from when it was last sent (internal).
+  @anchor ioc_brick_tile_diff
+
+  Pixels in IOC_BRICK_TILE_SAMPLES x IOC_BRICK_TILE_SAMPLES grid are sampled, pixel value
+  is average of its bytes (color channels).
+
+  @param   t Pointer to tiled brick sender state.
+  @param   data Image data.
+  @param   col Tile column.
+  @param   row Tile row.
+  @param   update OS_TRUE to store current pixel values as new samples.
+  @return  Mean absolute difference of sampled pixels, 0 - 255.
+
+****************************************************************************************************
+*/
+static os_int ioc_brick_tile_diff(
+    iocBrickTiles *t,
+    const os_uchar *data,
+    os_int col,
+    os_int row,
+    os_boolean update)
+{
+    const os_uchar *px;
+    os_uchar *sample;
+    os_int x, y, tw, th, i, j, k, bytes_per_pix, v, d, sum;
+
+    bytes_per_pix = OSAL_BITMAP_BYTES_PER_PIX(t->format);
+    ioc_brick_tile_rect(t->tile_w, t->tile_h, t->frame_w, t->frame_h, col, row,
+        &x, &y, &tw, &th);
+    sample = t->samples + (row * (os_memsz)t->cols + col)
+        * IOC_BRICK_TILE_SAMPLES * IOC_BRICK_TILE_SAMPLES;
+
+    sum = 0;
+    for (j = 0; j < IOC_BRICK_TILE_SAMPLES; j++)
+    {
+        for (i = 0; i < IOC_BRICK_TILE_SAMPLES; i++)
+        {
+            px = data + ((y + (j * th) / IOC_BRICK_TILE_SAMPLES) * (os_memsz)t->frame_w
+                + x + (i * tw) / IOC_BRICK_TILE_SAMPLES) * bytes_per_pix;
+            v = 0;
+            for (k = 0; k < bytes_per_pix; k++) v += px[k];
+            v /= bytes_per_pix;
+
+            d = v - *sample;
+            sum += d >= 0 ? d : -d;
+            if (update) *sample = (os_uchar)v;
+            sample++;
+        }
+    }
+
+    return sum / (IOC_BRICK_TILE_SAMPLES * IOC_BRICK_TILE_SAMPLES);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get position and size of a tile, clipped to image (internal).
+  @anchor ioc_brick_tile_rect
+
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_brick_tile_rect(
+    os_int tile_w,
+    os_int tile_h,
+    os_int frame_w,
+    os_int frame_h,
+    os_int col,
+    os_int row,
+    os_int *x,
+    os_int *y,
+    os_int *w,
+    os_int *h)
+{
+    *x = col * tile_w;
+    *y = row * tile_h;
+    *w = frame_w - *x < tile_w ? frame_w - *x : tile_w;
+    *h = frame_h - *y < tile_h ? frame_h - *y : tile_h;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Store integer in brick header byte order, least significant first (internal).
+  @anchor ioc_set_brick_tiles_int
+
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_set_brick_tiles_int(
+    os_uchar *dst,
+    os_ulong x,
+    os_int nro_bytes)
+{
+    while (nro_bytes--)
+    {
+        *(dst++) = (os_uchar)x;
+        x >>= 8;
+    }
+}
+
+#endif
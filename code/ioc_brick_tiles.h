@@ -0,0 +1,202 @@
+/**
+
+  @file    ioc_brick_tiles.h
+  @brief   Tiled brick transfer, send only changed parts of camera image.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  The image is split into tiles. Only tiles which have changed since they were last sent,
+  or which are within region of interest, are encoded and sent as one tiled brick. The
+  receiving brick buffer keeps the assembled frame, updates it with received tiles and
+  passes a full uncompressed frame to brick received callback (or to Python BrickBuffer.get),
+  so receiving applications do not need to know about tiles.
+
+  Change detection compares a grid of IOC_BRICK_TILE_SAMPLES x IOC_BRICK_TILE_SAMPLES pixels
+  of each tile against values when the tile was last sent. Full frame (key frame) is sent
+  when a receiver connects and periodically. A receiver which gets tiles without a key frame
+  drops them and requests one: flat buffer by negative acknowledge, ring buffer by closing
+  the stream.
+
+  Tiled brick data: compression byte in brick header is IOC_TILED, width and height are
+  full frame size. Data starts with iocBrickTilesHdr, followed by tiles. Each tile is
+  iocBrickTileHdr followed by tile data: pixels row by row (uncompressed) or JPEG.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_BRICK_TILES_H_
+#define IOC_BRICK_TILES_H_
+#include "iocom.h"
+
+#if IOC_BRICK_TILES_SUPPORT
+
+/* Change detection sample grid size per tile (n x n pixels).
+ */
+#define IOC_BRICK_TILE_SAMPLES 8
+
+/* Default change detection threshold, mean absolute difference of sampled pixels 0 - 255.
+ */
+#define IOC_BRICK_TILE_THRESHOLD 6
+
+/* Default key frame interval, ms.
+ */
+#define IOC_BRICK_TILE_KEYFRAME_MS 5000
+
+/* Tiled brick flags: All tiles are included.
+ */
+#define IOC_BRICK_TILES_KEYFRAME 1
+
+
+/**
+****************************************************************************************************
+    Tiled brick data header, follows brick header. Byte order is least significant first.
+****************************************************************************************************
+*/
+typedef struct iocBrickTilesHdr
+{
+    os_uchar tile_w[IOC_BRICK_DIM_SZ];
+    os_uchar tile_h[IOC_BRICK_DIM_SZ];
+    os_uchar nro_tiles[IOC_BRICK_DIM_SZ];
+    os_uchar flags;
+    os_uchar reserved;
+}
+iocBrickTilesHdr;
+
+
+/**
+****************************************************************************************************
+    Header of one tile within tiled brick. Tile position is given as column and row index.
+    Tiles at right and bottom edge are clipped to image size.
+****************************************************************************************************
+*/
+typedef struct iocBrickTileHdr
+{
+    os_uchar col[IOC_BRICK_DIM_SZ];
+    os_uchar row[IOC_BRICK_DIM_SZ];
+    os_uchar compression;
+    os_uchar sz[IOC_BRICK_BYTES_SZ];
+}
+iocBrickTileHdr;
+
+
+/**
+****************************************************************************************************
+    Tiled brick sender state.
+****************************************************************************************************
+*/
+typedef struct iocBrickTiles
+{
+    /** Brick buffer to send tiled bricks.
+     */
+    iocBrickBuffer *brick;
+
+    /** Tile size in pixels.
+     */
+    os_int tile_w, tile_h;
+
+    /** Change detection threshold and key frame interval, ms (0 = no periodic key frames).
+        Set to defaults by ioc_initialize_brick_tiles(), application may modify these.
+     */
+    os_int threshold;
+    os_int keyframe_ms;
+
+    /** Current frame geometry, number of tile columns and rows.
+     */
+    os_int frame_w, frame_h;
+    osalBitmapFormat format;
+    os_int cols, rows;
+
+    /** Sampled pixel values of each tile when it was last sent.
+     */
+    os_uchar *samples;
+    os_memsz samples_alloc_sz;
+
+    /** Buffer to encode tiled brick data.
+     */
+    os_uchar *enc;
+    os_memsz enc_alloc_sz;
+
+    /** Region of interest, tiles overlapping it are sent with every frame.
+     */
+    os_int roi_x, roi_y, roi_w, roi_h;
+
+    /** Key frame needed, and time when last key frame was sent.
+     */
+    os_boolean keyframe_needed;
+    os_timer keyframe_timer;
+
+    /** Statistics: number of tiles sent and skipped as unchanged.
+     */
+    os_uint tiles_sent;
+    os_uint tiles_skipped;
+}
+iocBrickTiles;
+
+
+/**
+****************************************************************************************************
+  Tiled brick functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Initialize tiled brick sender.
+ */
+void ioc_initialize_brick_tiles(
+    iocBrickTiles *t,
+    iocBrickBuffer *brick,
+    os_int tile_w,
+    os_int tile_h);
+
+/* Release memory allocated for tiled brick sender.
+ */
+void ioc_release_brick_tiles(
+    iocBrickTiles *t);
+
+/* Set region of interest, w = 0 to clear.
+ */
+void ioc_set_brick_tiles_roi(
+    iocBrickTiles *t,
+    os_int x,
+    os_int y,
+    os_int w,
+    os_int h);
+
+/* Send all tiles with next frame.
+ */
+void ioc_brick_tiles_keyframe(
+    iocBrickTiles *t);
+
+/* Store changed tiles of image into brick buffer, same arguments as ioc_compress_brick().
+ */
+osalStatus ioc_compress_brick_tiles(
+    iocBrickTiles *t,
+    iocBrickHdr *hdr,
+    os_uchar *data,
+    os_memsz data_sz,
+    osalBitmapFormat format,
+    os_int w,
+    os_int h,
+    os_uchar compression);
+
+/* Update receiver's assembled frame with received brick (called by ioc_brick.c). Returns
+   OSAL_PENDING and sets key frame request if tiles arrive without assembled frame.
+ */
+osalStatus ioc_assemble_brick_tiles(
+    iocBrickBuffer *b);
+
+/* Free receiver's assembled frame (called by ioc_brick.c).
+ */
+void ioc_free_brick_tiles_frame(
+    iocBrickBuffer *b);
+
+/*@}*/
+
+#endif
+#endif
@@ -230,3 +230,320 @@ os_int ioc_uncompress(
     return (os_int)(dst - dst_start);
 }
 
+
+
+#if IOC_LZ_COMPRESSION_SUPPORT
+
+/* Hash table index for four bytes at position p.
+ */
+#define IOC_LZ_HASH(p) ((os_int)((((os_uint)(os_uchar)(p)[0]) \
+    | ((os_uint)(os_uchar)(p)[1] << 8) \
+    | ((os_uint)(os_uchar)(p)[2] << 16) \
+    | ((os_uint)(os_uchar)(p)[3] << 24)) * 2654435761u >> (32 - IOC_LZ_HASH_BITS)))
+
+/* Number of extension bytes needed to store literal or match length n.
+ */
+#define IOC_LZ_EXT_BYTES(n) ((n) >= 15 ? ((n) - 15) / 255 + 1 : 0)
+
+
+/**
+****************************************************************************************************
+
+  @brief Store extension bytes for long literal or match length.
+  @anchor ioc_lz_set_ext
+
+  The ioc_lz_set_ext() function stores length bytes which didn't fit in 4 bit token field.
+
+  @param   dst Position in destination buffer where to store the length.
+  @param   n Literal length or match length - 4.
+  @return  Updated destination buffer position.
+
+****************************************************************************************************
+*/
+static os_char *ioc_lz_set_ext(
+    os_char *dst,
+    os_int n)
+{
+    if (n < 15) return dst;
+    n -= 15;
+    while (n >= 255)
+    {
+        *(dst++) = (os_char)255;
+        n -= 255;
+    }
+    *(dst++) = (os_char)n;
+    return dst;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get extension bytes for long literal or match length.
+  @anchor ioc_lz_get_ext
+
+  The ioc_lz_get_ext() function reads length bytes which didn't fit in 4 bit token field.
+
+  @param   src Pointer to source position, advanced over the extension bytes.
+  @param   src_end End of source data.
+  @param   n Literal length or match length - 4 from the token.
+  @return  Length, or -1 if source data is corrupted.
+
+****************************************************************************************************
+*/
+static os_int ioc_lz_get_ext(
+    os_char **src,
+    os_char *src_end,
+    os_int n)
+{
+    os_uchar
+        b;
+
+    if (n < 15) return n;
+    do
+    {
+        if (*src >= src_end) return -1;
+        b = (os_uchar)*((*src)++);
+        n += b;
+    }
+    while (b == 255);
+    return n;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Compress data using LZ compression.
+  @anchor ioc_compress_lz
+
+  The ioc_compress_lz() function compresses data from source buffer into destination buffer
+  using simple byte oriented LZ77 style compression. This is intended for key frames and
+  large data ranges, like JSON text in info and configuration blocks, which do not compress
+  with zero run compression. Arguments and return value are the same as for ioc_compress().
+
+  Compressed data is a sequence of tokens. Token byte's high 4 bits are count of literal
+  bytes and low 4 bits are match length - 4. Value 15 in either field is followed by extension
+  bytes, which are added to length until a byte other than 255 is found. Then come the
+  literal bytes and, unless end of data has been reached, two byte match offset (least
+  significant byte first). Offset is counted back from current uncompressed position.
+
+  At most IOC_LZ_MAX_SRC_BYTES source bytes are compressed in one call, so that the receiver
+  can uncompress delta encoded data into fixed size temporary buffer.
+
+  @param   srcbuf Source buffer pointer.
+  @param   start_addr At entry, index of the first byte in source buffer to compress. At exit
+           index of first byte which was left uncompressed.
+  @param   end_addr Index of last byte in source buffer to compress.
+  @param   dst Pointer to destination buffer.
+  @param   dst_sz Maximum number of bytes to store in destination buffer.
+  @return  Number of bytes in destination buffer or -1 if is not compressed (longer than original)
+
+****************************************************************************************************
+*/
+os_int ioc_compress_lz(
+    os_char *srcbuf,
+    os_int *start_addr,
+    os_int end_addr,
+    os_char *dst,
+    os_memsz dst_sz)
+{
+    os_ushort
+        table[1 << IOC_LZ_HASH_BITS];
+
+    os_char
+        *src,
+        *src_end,
+        *p,
+        *anchor,
+        *ref,
+        *dst_start,
+        *dst_end;
+
+    os_int
+        bytes,
+        pos,
+        h,
+        lit,
+        ml,
+        off,
+        avail,
+        consumed,
+        dst_count;
+
+    bytes = end_addr - *start_addr + 1;
+    if (bytes < 4) return -1;
+    if (bytes > IOC_LZ_MAX_SRC_BYTES) bytes = IOC_LZ_MAX_SRC_BYTES;
+
+    src = srcbuf + *start_addr;
+    src_end = src + bytes;
+    dst_start = dst;
+    dst_end = dst + dst_sz;
+    os_memclear(table, sizeof(table));
+
+    p = anchor = src;
+    while (p + 4 <= src_end)
+    {
+        /* Hash table holds source position + 1 of last four bytes with the same hash,
+           zero if none.
+         */
+        h = IOC_LZ_HASH(p);
+        pos = table[h];
+        table[h] = (os_ushort)(p - src + 1);
+        if (pos == 0) {
+            p++;
+            continue;
+        }
+        ref = src + pos - 1;
+        if (os_memcmp(ref, p, 4)) {
+            p++;
+            continue;
+        }
+
+        ml = 4;
+        while (p + ml < src_end && ref[ml] == p[ml]) ml++;
+
+        /* Stop if the sequence doesn't fit into destination buffer.
+         */
+        lit = (os_int)(p - anchor);
+        if (dst + 1 + IOC_LZ_EXT_BYTES(lit) + lit + 2 + IOC_LZ_EXT_BYTES(ml - 4) > dst_end) {
+            break;
+        }
+
+        *(dst++) = (os_char)(((lit < 15 ? lit : 15) << 4) | (ml - 4 < 15 ? ml - 4 : 15));
+        dst = ioc_lz_set_ext(dst, lit);
+        os_memcpy(dst, anchor, lit);
+        dst += lit;
+        off = (os_int)(p - ref);
+        *(dst++) = (os_char)off;
+        *(dst++) = (os_char)(off >> 8);
+        dst = ioc_lz_set_ext(dst, ml - 4);
+
+        p += ml;
+        anchor = p;
+    }
+
+    /* Trailing literals, as many as fit into the destination buffer.
+     */
+    lit = (os_int)(src_end - anchor);
+    avail = (os_int)(dst_end - dst) - 1;
+    if (avail < lit + IOC_LZ_EXT_BYTES(lit))
+    {
+        lit = avail - IOC_LZ_EXT_BYTES(avail);
+        while (lit > 0 && lit + IOC_LZ_EXT_BYTES(lit) > avail) lit--;
+    }
+    if (lit > 0)
+    {
+        *(dst++) = (os_char)((lit < 15 ? lit : 15) << 4);
+        dst = ioc_lz_set_ext(dst, lit);
+        os_memcpy(dst, anchor, lit);
+        dst += lit;
+        anchor += lit;
+    }
+
+    consumed = (os_int)(anchor - src);
+    dst_count = (os_int)(dst - dst_start);
+    if (consumed == 0 || dst_count >= consumed) return -1;
+
+    *start_addr += consumed;
+    return dst_count;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Uncompress LZ compressed data.
+  @anchor ioc_uncompress_lz
+
+  The ioc_uncompress_lz() function uncompresses data compressed by ioc_compress_lz() into
+  destination buffer. Delta encoding is taken care of if set in flags: Data is first
+  uncompressed into temporary buffer and then added to destination.
+
+  @param   src Source buffer pointer.
+  @param   src_bytes Number of source bytes.
+  @param   dst Pointer to destination buffer.
+  @param   dst_sz Maximum number of bytes to store in destination buffer.
+  @param   flags IOC_DELTA_ENCODED bit is checked.
+  @return  Number of destination bytes if uncompression was successful. -1 indicates failed
+           decompression (source data is corrupted)
+
+****************************************************************************************************
+*/
+os_int ioc_uncompress_lz(
+    os_char *src,
+    os_int src_bytes,
+    os_char *dst,
+    os_memsz dst_sz,
+    os_uchar flags)
+{
+    os_char
+        tmp[IOC_LZ_MAX_SRC_BYTES],
+        *src_end,
+        *out,
+        *out_start,
+        *out_end,
+        *ref;
+
+    os_int
+        lit,
+        ml,
+        off,
+        n,
+        i;
+
+    os_uchar
+        token;
+
+    src_end = src + src_bytes;
+    if (flags & IOC_DELTA_ENCODED)
+    {
+        out = tmp;
+        out_end = tmp + (dst_sz < IOC_LZ_MAX_SRC_BYTES ? dst_sz : IOC_LZ_MAX_SRC_BYTES);
+    }
+    else
+    {
+        out = dst;
+        out_end = dst + dst_sz;
+    }
+    out_start = out;
+
+    while (src < src_end)
+    {
+        token = (os_uchar)*(src++);
+
+        /* Copy literals.
+         */
+        lit = ioc_lz_get_ext(&src, src_end, token >> 4);
+        if (lit < 0 || src + lit > src_end) return -1;
+        n = lit;
+        if (out + n > out_end) n = (os_int)(out_end - out);
+        os_memcpy(out, src, n);
+        out += n;
+        src += lit;
+        if (n < lit || src >= src_end) break;
+
+        /* Copy match. Byte by byte, match may overlap with data being written.
+         */
+        if (src + 2 > src_end) return -1;
+        off = (os_uchar)src[0] | ((os_int)(os_uchar)src[1] << 8);
+        src += 2;
+        ml = ioc_lz_get_ext(&src, src_end, token & 15);
+        if (ml < 0 || off == 0 || off > (os_int)(out - out_start)) return -1;
+        ml += 4;
+        n = ml;
+        if (out + n > out_end) n = (os_int)(out_end - out);
+        ref = out - off;
+        for (i = 0; i < n; i++) *(out++) = *(ref++);
+        if (n < ml) break;
+    }
+
+    n = (os_int)(out - out_start);
+    if (flags & IOC_DELTA_ENCODED)
+    {
+        for (i = 0; i < n; i++) dst[i] += tmp[i];
+    }
+    return n;
+}
+
+#endif
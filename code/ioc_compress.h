@@ -18,12 +18,30 @@
 #define IOC_COMPRESS_H_
 #include "iocom.h"
 
+#if IOC_LZ_COMPRESSION_SUPPORT
+/* Maximum number of source bytes LZ compressed into one frame. This limits the receiver's
+   temporary buffer size needed to apply LZ compressed delta.
+ */
+#define IOC_LZ_MAX_SRC_BYTES 4096
+
+/* Do not use LZ compression for delta encoded data ranges smaller than this. Key frames
+   are always LZ compressed, if LZ is enabled for the connection.
+ */
+#define IOC_LZ_MIN_RANGE 64
+
+/* Number of bits in LZ compressor's hash table index.
+ */
+#define IOC_LZ_HASH_BITS 11
+#endif
+
 /** 
 ****************************************************************************************************
 
   @name Compression and uncompression functions
 
   The ioc_compress() function compressess data from source buffer into destination buffer.
+  The ioc_compress_lz() is alternative for key frames and large data ranges, used only
+  if the other end of the connection has indicated that it can uncompress it.
 
 ****************************************************************************************************
  */
@@ -47,6 +65,26 @@ os_int ioc_uncompress(
     os_memsz dst_sz,
     os_uchar flags);
 
+#if IOC_LZ_COMPRESSION_SUPPORT
+/* Compress data using LZ compression.
+ */
+os_int ioc_compress_lz(
+    os_char *srcbuf,
+    os_int *start_addr,
+    os_int end_addr,
+    os_char *dst,
+    os_memsz dst_sz);
+
+/* Uncompress LZ compressed data.
+ */
+os_int ioc_uncompress_lz(
+    os_char *src,
+    os_int src_bytes,
+    os_char *dst,
+    os_memsz dst_sz,
+    os_uchar flags);
+#endif
+
 /*@}*/
 
 #endif
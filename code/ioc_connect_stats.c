@@ -0,0 +1,167 @@
+/**
+
+  @file    ioc_connect_stats.c
+  @brief   Connection setup timing statistics.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_CONNECT_STATS
+
+
+/**
+****************************************************************************************************
+
+  @brief Start measuring connection setup.
+  @anchor ioc_connect_timing_start
+
+  The ioc_connect_timing_start() function is called by ioc_reset_connection_state() when
+  stream has been opened or accepted. It records start time and marks that no phase has
+  been reached yet.
+
+  @param   con Pointer to the connection object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_connect_timing_start(
+    iocConnection *con)
+{
+    os_int i;
+
+    os_get_timer(&con->connect_timing.start);
+    for (i = 0; i < IOC_CONNECT_NRO_PHASES; i++)
+    {
+        con->connect_timing.phase_ms[i] = -1;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Record that connection reached a setup phase.
+  @anchor ioc_connect_timing_mark
+
+  The ioc_connect_timing_mark() function stores time from stream open to the phase in the
+  connection and adds it to root's histogram. Only the first call for each phase after
+  open is recorded, so this is cheap to call on every received frame.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   con Pointer to the connection object.
+  @param   phase Setup phase reached, IOC_CONNECT_PHASE_AUTHENTICATED or
+           IOC_CONNECT_PHASE_FIRST_DATA.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_connect_timing_mark(
+    iocConnection *con,
+    iocConnectPhase phase)
+{
+    iocConnectHistogram *h;
+    os_timer tnow;
+    os_long elapsed;
+    os_int ms, b;
+
+    if (con->connect_timing.phase_ms[phase] >= 0) return;
+
+    os_get_timer(&tnow);
+    elapsed = os_get_ms_elapsed(&con->connect_timing.start, &tnow);
+    ms = elapsed > 0x7FFFFFFF ? 0x7FFFFFFF : (os_int)elapsed;
+    con->connect_timing.phase_ms[phase] = ms;
+
+    for (b = 0; b < IOC_CONNECT_STATS_BUCKETS - 1; b++)
+    {
+        if (ms < (1 << b)) break;
+    }
+
+    h = &con->link.root->connect_stats.phase[phase];
+    h->count[b]++;
+    h->n++;
+    h->sum_ms += ms;
+    if (ms > h->max_ms) h->max_ms = ms;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get copy of connection setup statistics.
+  @anchor ioc_get_connect_stats
+
+  The ioc_get_connect_stats() function copies root's connection setup histograms, for
+  example to be reported by a load test or diagnostics. Statistics can be cleared at the
+  same time to measure next reconnect storm separately.
+
+  @param   root Pointer to the root structure.
+  @param   stats Pointer to structure where to store the statistics.
+  @param   clear OS_TRUE to clear the statistics after copying.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_get_connect_stats(
+    iocRoot *root,
+    iocConnectStats *stats,
+    os_boolean clear)
+{
+    ioc_lock(root);
+    os_memcpy(stats, &root->connect_stats, sizeof(iocConnectStats));
+    if (clear)
+    {
+        os_memclear(&root->connect_stats, sizeof(iocConnectStats));
+    }
+    ioc_unlock(root);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get percentile from connection setup histogram.
+  @anchor ioc_connect_stats_percentile
+
+  The ioc_connect_stats_percentile() function finds the bucket which contains given
+  percentile. Resolution is the bucket width, the function returns bucket's upper limit.
+
+  @param   h Pointer to histogram.
+  @param   percent Percentile 0 - 100, like 50 for median or 99.
+  @return  Upper limit of the bucket, ms. Maximum time if percentile falls in the last
+           bucket, 0 if histogram is empty.
+
+****************************************************************************************************
+*/
+os_int ioc_connect_stats_percentile(
+    const iocConnectHistogram *h,
+    os_int percent)
+{
+    os_int64 limit, total;
+    os_int b;
+
+    if (h->n == 0) return 0;
+    limit = ((os_int64)h->n * percent + 99) / 100;
+    if (limit < 1) limit = 1;
+
+    total = 0;
+    for (b = 0; b < IOC_CONNECT_STATS_BUCKETS - 1; b++)
+    {
+        total += h->count[b];
+        if (total >= limit)
+        {
+            return (1 << b) < h->max_ms ? (1 << b) : h->max_ms;
+        }
+    }
+    return h->max_ms;
+}
+
+#endif
@@ -0,0 +1,133 @@
+/**
+
+  @file    ioc_connect_stats.h
+  @brief   Connection setup timing statistics.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Mass reconnects (power cycle, switch reboot) load handshake, authentication, memory block
+  information exchange and dynamic information parsing all at once. To tell how long devices
+  are without data, each connection measures time from stream open to authentication and
+  to first received memory block data. Times are collected into per root histograms with
+  power of two millisecond buckets, from which percentiles can be read.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_CONNECT_STATS_H_
+#define IOC_CONNECT_STATS_H_
+#include "iocom.h"
+
+#if IOC_CONNECT_STATS
+
+struct iocRoot;
+struct iocConnection;
+
+/* Number of histogram buckets. Bucket 0 counts times under 1 ms, bucket i times under
+   2^i ms, and the last bucket all longer times (16 s and over).
+ */
+#define IOC_CONNECT_STATS_BUCKETS 16
+
+/* Connection setup phases to measure, from stream open.
+ */
+typedef enum iocConnectPhase
+{
+    IOC_CONNECT_PHASE_AUTHENTICATED = 0,
+    IOC_CONNECT_PHASE_FIRST_DATA = 1
+}
+iocConnectPhase;
+
+#define IOC_CONNECT_NRO_PHASES 2
+
+
+/**
+****************************************************************************************************
+    Histogram of setup times for one phase.
+****************************************************************************************************
+*/
+typedef struct iocConnectHistogram
+{
+    /** Number of connections in each bucket.
+     */
+    os_uint count[IOC_CONNECT_STATS_BUCKETS];
+
+    /** Total number of connections, sum and maximum of times, ms.
+     */
+    os_uint n;
+    os_int64 sum_ms;
+    os_int max_ms;
+}
+iocConnectHistogram;
+
+
+/**
+****************************************************************************************************
+    Connection setup statistics, member of root structure.
+****************************************************************************************************
+*/
+typedef struct iocConnectStats
+{
+    iocConnectHistogram phase[IOC_CONNECT_NRO_PHASES];
+}
+iocConnectStats;
+
+
+/**
+****************************************************************************************************
+    Connection setup timing, member of connection structure.
+****************************************************************************************************
+*/
+typedef struct iocConnectTiming
+{
+    /** Timer when stream was opened or accepted.
+     */
+    os_timer start;
+
+    /** Time from start to each phase, ms. -1 if the phase has not been reached.
+     */
+    os_int phase_ms[IOC_CONNECT_NRO_PHASES];
+}
+iocConnectTiming;
+
+
+/**
+****************************************************************************************************
+  Connection setup statistics functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Start measuring connection setup, called when stream is opened or accepted.
+ */
+void ioc_connect_timing_start(
+    struct iocConnection *con);
+
+/* Record that connection reached a setup phase (ioc_lock must be on).
+ */
+void ioc_connect_timing_mark(
+    struct iocConnection *con,
+    iocConnectPhase phase);
+
+/* Get copy of root's connection setup statistics, optionally clear them.
+ */
+void ioc_get_connect_stats(
+    struct iocRoot *root,
+    iocConnectStats *stats,
+    os_boolean clear);
+
+/* Get percentile, like 50 or 99, from histogram as bucket's upper limit in ms.
+ */
+os_int ioc_connect_stats_percentile(
+    const iocConnectHistogram *h,
+    os_int percent);
+
+/*@}*/
+
+#endif
+#endif
@@ -38,6 +38,20 @@ static void ioc_connection_thread(
     osalEvent done);
 #endif
 
+#if IOC_TIMER_WHEEL
+static os_boolean ioc_connection_is_idle(
+    iocConnection *con);
+
+static os_int ioc_set_connection_timer(
+    iocConnection *con,
+    os_int timeout_ms,
+    os_int fallback_ms);
+
+static void ioc_connection_timer_func(
+    iocTimer *timer,
+    void *context);
+#endif
+
 
 /**
 ****************************************************************************************************
@@ -162,6 +176,12 @@ void ioc_release_connection(
     root = con->link.root;
     ioc_lock(root);
 
+#if IOC_TIMER_WHEEL
+    /* Remove connection's timer from root's timer wheel.
+     */
+    ioc_cancel_timer(root, &con->timer);
+#endif
+
     /* If stream is open, close it.
      */
     ioc_close_stream(con);
@@ -611,6 +631,7 @@ osalStatus ioc_run_connection(
 #if OSAL_SOCKET_SUPPORT
     os_char connectstr[OSAL_HOST_BUF_SZ];
 #endif
+    IOC_PERF_VAR(t)
 
     osal_debug_assert(con->debug_id == 'C');
 
@@ -703,7 +724,9 @@ osalStatus ioc_run_connection(
          */
         while (osal_go())
         {
+            IOC_PERF_BEGIN(t)
             status = ioc_connection_receive(con);
+            IOC_PERF_END(con->link.root, IOC_PERF_RECEIVE, t)
             if (status == OSAL_PENDING)
             {
                 break;
@@ -716,7 +739,9 @@ osalStatus ioc_run_connection(
 
         /* Send one frame to connection
          */
+        IOC_PERF_BEGIN(t)
         status = ioc_connection_send(con);
+        IOC_PERF_END(con->link.root, IOC_PERF_SEND, t)
         if (status == OSAL_PENDING)
         {
             break;
@@ -914,6 +939,10 @@ void ioc_reset_connection_state(
      */
     con->authentication_sent = OS_FALSE;
     con->authentication_received = OS_FALSE;
+    con->peer_features = 0;
+#if IOC_MBINFO_RESUME
+    ioc_mbinfo_resume_con_closed(con);
+#endif
 
     /* Reset hand shake structure.
      */
@@ -927,12 +956,18 @@ void ioc_reset_connection_state(
     con->bytes_received = 0;
     con->bytes_acknowledged = 0xA0A000;
     con->bytes_sent = con->processed_bytes = 0;
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    ioc_reset_flow_control(con);
+#endif
 
     /* Initialize timers.
      */
     os_get_timer(&tnow);
     con->last_receive = tnow;
     con->last_send = tnow;
+#if IOC_CONNECT_STATS
+    ioc_connect_timing_start(con);
+#endif
 
     for (sbuf = con->sbuf.first;
          sbuf;
@@ -942,6 +977,12 @@ void ioc_reset_connection_state(
         sbuf->syncbuf.start_addr = sbuf->syncbuf.end_addr = 0;
         sbuf->syncbuf.make_keyframe = OS_TRUE;
         sbuf->syncbuf.is_keyframe = OS_TRUE;
+#if IOC_LAZY_SYNC_BUFFERS
+        ioc_sbuf_release_window(sbuf);
+#endif
+#if IOC_DIRTY_LISTS
+        ioc_sbuf_set_pending(sbuf);
+#endif
     }
 
     for (tbuf = con->tbuf.first;
@@ -1015,8 +1056,13 @@ static void ioc_connection_thread(
     const os_char *parameters;
     osalStatus status;
     os_timer tnow;
-    os_int check_timeouts_ms, silence_ms, count;
+    os_int check_timeouts_ms, select_ms, silence_ms, count;
     os_boolean is_serial;
+#if IOC_TIMER_WHEEL
+    os_int ms, timeout_ms;
+    os_uint bytes_sent, bytes_received;
+#endif
+    IOC_PERF_VAR(t)
 
     /* Parameters point to the connection object.
      */
@@ -1044,6 +1090,7 @@ static void ioc_connection_thread(
         silence_ms = IOC_SOCKET_SILENCE_MS;
         check_timeouts_ms = IOC_SOCKET_CHECK_TIMEOUTS_MS;
     }
+    select_ms = check_timeouts_ms;
 
     /* Run the connection.
      */
@@ -1107,7 +1154,8 @@ static void ioc_connection_thread(
         else
         {
             status = osal_stream_select(&con->stream, 1, con->worker.trig,
-                check_timeouts_ms, OSAL_STREAM_DEFAULT);
+                select_ms, OSAL_STREAM_DEFAULT);
+            select_ms = check_timeouts_ms;
 
             if (status == OSAL_STATUS_NOT_SUPPORTED)
             {
@@ -1144,6 +1192,11 @@ static void ioc_connection_thread(
         }
 #endif
 
+#if IOC_TIMER_WHEEL
+        bytes_sent = con->bytes_sent;
+        bytes_received = con->bytes_received;
+#endif
+
         /* Receive and send in loop as long as we can without waiting.
            How ever fast we write, we cannot block here (count=32) !
          */
@@ -1154,7 +1207,9 @@ static void ioc_connection_thread(
             {
                 /* Try receiving data from the connection.
                  */
+                IOC_PERF_BEGIN(t)
                 status = ioc_connection_receive(con);
+                IOC_PERF_END(root, IOC_PERF_RECEIVE, t)
                 if (status == OSAL_PENDING)
                 {
                     break;
@@ -1171,7 +1226,9 @@ static void ioc_connection_thread(
 
             /* Try sending data though the connection.
              */
+            IOC_PERF_BEGIN(t)
             status = ioc_connection_send(con);
+            IOC_PERF_END(root, IOC_PERF_SEND, t)
             if (status == OSAL_PENDING)
             {
                 break;
@@ -1204,6 +1261,21 @@ static void ioc_connection_thread(
             osal_stream_flush(con->stream, OSAL_STREAM_DEFAULT);
         }
 
+#if IOC_TIMER_WHEEL
+        /* If socket connection is idle, wait for data or trigger without timeout and let
+           the timer wheel wake this thread up for keep alive or silence timeout.
+         */
+        if (!is_serial &&
+            bytes_sent == con->bytes_sent &&
+            bytes_received == con->bytes_received &&
+            ioc_connection_is_idle(con))
+        {
+            ms = IOC_SOCKET_KEEPALIVE_MS - (os_int)os_get_ms_elapsed(&con->last_send, &tnow);
+            timeout_ms = silence_ms - (os_int)os_get_ms_elapsed(&con->last_receive, &tnow);
+            if (ms < timeout_ms) timeout_ms = ms;
+            select_ms = ioc_set_connection_timer(con, timeout_ms, check_timeouts_ms);
+        }
+#endif
         continue;
 
 failed:
@@ -1225,7 +1297,23 @@ failed:
         {
             break;
         }
+
+#if IOC_TIMER_WHEEL
+        /* Sleep until next connect try is allowed, see ioc_try_to_connect().
+         */
+        os_get_timer(&tnow);
+        timeout_ms = 500 - (os_int)os_get_ms_elapsed(&con->open_try_timer, &tnow);
+        if (con->open_fail_timer_set)
+        {
+            ms = 2000 - (os_int)os_get_ms_elapsed(&con->open_fail_timer, &tnow);
+            if (ms > timeout_ms) timeout_ms = ms;
+        }
+        if (timeout_ms < check_timeouts_ms) timeout_ms = check_timeouts_ms;
+        osal_event_wait(con->worker.trig,
+            ioc_set_connection_timer(con, timeout_ms, timeout_ms));
+#else
         os_timeslice();
+#endif
     }
 
     /* Mark that this thread is no longer running.
@@ -1243,6 +1331,106 @@ failed:
 #endif
 
 
+#if IOC_TIMER_WHEEL
+/**
+****************************************************************************************************
+
+  @brief Check if connection has nothing to send (internal).
+  @anchor ioc_connection_is_idle
+
+  The ioc_connection_is_idle() function checks that handshake is completed, there is no
+  partly sent frame and no synchronized data waiting to be sent. Such connection needs to
+  be woken up only by received data, trigger or timer.
+
+  @param   con Pointer to the connection object.
+  @return  OS_TRUE if connection is idle.
+
+****************************************************************************************************
+*/
+static os_boolean ioc_connection_is_idle(
+    iocConnection *con)
+{
+    iocRoot *root;
+    iocSourceBuffer *sbuf;
+    os_boolean idle;
+
+    root = con->link.root;
+    ioc_lock(root);
+    idle = (os_boolean)(con->authentication_sent && con->authentication_received &&
+        !con->frame_out.used);
+    for (sbuf = con->sbuf.first; sbuf && idle; sbuf = sbuf->clink.next)
+    {
+        if (sbuf->syncbuf.used) idle = OS_FALSE;
+    }
+    ioc_unlock(root);
+    return idle;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set connection's timer in root's timer wheel (internal).
+  @anchor ioc_set_connection_timer
+
+  The ioc_set_connection_timer() function sets the timer to trigger worker thread after
+  timeout_ms.
+
+  @param   con Pointer to the connection object.
+  @param   timeout_ms Time until worker thread needs to check timeouts.
+  @param   fallback_ms Timeout to return if timer could not be set.
+  @return  Timeout for worker thread wait: OSAL_INFINITE if the timer was set, otherwise
+           fallback_ms.
+
+****************************************************************************************************
+*/
+static os_int ioc_set_connection_timer(
+    iocConnection *con,
+    os_int timeout_ms,
+    os_int fallback_ms)
+{
+    iocRoot *root;
+    osalStatus s;
+
+    root = con->link.root;
+    ioc_lock(root);
+    s = ioc_set_timer(root, &con->timer, timeout_ms, ioc_connection_timer_func, con);
+    ioc_unlock(root);
+    return s ? fallback_ms : OSAL_INFINITE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Connection timer is due (internal).
+  @anchor ioc_connection_timer_func
+
+  The ioc_connection_timer_func() function is called by timer wheel thread with ioc_lock()
+  on. It wakes up connection's worker thread.
+
+  @param   timer Pointer to connection's timer.
+  @param   context Pointer to the connection object.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_connection_timer_func(
+    iocTimer *timer,
+    void *context)
+{
+    iocConnection *con;
+    OSAL_UNUSED(timer);
+
+    con = (iocConnection*)context;
+    if (con->worker.trig)
+    {
+        osal_event_set(con->worker.trig);
+    }
+}
+#endif
+
+
 #if IOC_ROOT_CALLBACK_SUPPORT
 /**
 ****************************************************************************************************
@@ -167,6 +167,7 @@
 /*@{*/
 #define IOC_EXTRA_ADDR_HAS_FOUR_BYTES 1
 #define IOC_EXTRA_MBLK_HAS_FOUR_BYTES 2
+#define IOC_EXTRA_LZ_COMPRESSED 4
 #define IOC_EXTRA_NO_ZERO 128
 /*@}*/
 
@@ -210,7 +211,8 @@ typedef enum
 {
     IOC_SYSFRAME_MBLK_INFO = 1,
     IOC_AUTHENTICATION_DATA = 2,
-    IOC_REMOVE_MBLK_REQUEST = 3
+    IOC_REMOVE_MBLK_REQUEST = 3,
+    IOC_MBINFO_RESUME_REPLY = 4
 }
 iocSystemFrameType;
 
@@ -637,6 +639,23 @@ typedef struct iocConnection
      */
     os_ushort unacknogledged_limit;
 
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    /** Round trip time estimate, adaptive acknowledge limit and acknowledge counters.
+     */
+    iocFlowControlState fc;
+#endif
+
+    /** Optional features supported by the other end of the connection, bits like
+        IOC_AUTH_FEATURE_LZ_COMPRESSION. Received in authentication message.
+     */
+    os_uchar peer_features;
+
+#if IOC_MBINFO_RESUME
+    /** Skipping memory block information exchange on reconnect.
+     */
+    iocMbinfoResumeState resume;
+#endif
+
     /** OSAL stream handle (socket or serial port).
      */
     osalStream stream;
@@ -663,6 +682,12 @@ typedef struct iocConnection
      */
     os_timer last_receive;
 
+#if IOC_CONNECT_STATS
+    /** Time from stream open to authentication and to first data.
+     */
+    iocConnectTiming connect_timing;
+#endif
+
     /** Timer of the last successful send.
      */
     os_timer last_send;
@@ -708,6 +733,12 @@ typedef struct iocConnection
     iocConnectionWorkerThread worker;
 #endif
 
+#if IOC_TIMER_WHEEL
+    /** Timer to wake up idle worker thread for keep alive, silence and reconnect timeouts.
+     */
+    iocTimer timer;
+#endif
+
     /** Linked list of connection's source buffers.
      */
     iocConnectionsSourceBufferList sbuf;
@@ -716,6 +747,13 @@ typedef struct iocConnection
      */
     iocConnectionsTargetBufferList tbuf;
 
+#if IOC_LAZY_SYNC_BUFFERS
+    /** Bytes currently allocated for synchronization buffers of this connection's source
+        and target buffers.
+     */
+    os_memsz syncbuf_bytes;
+#endif
+
     /** This connection in root's linked list of connections.
      */
     iocConnectionLink link;
@@ -872,7 +910,8 @@ void ioc_generate_header(
     os_char *hdr,
     iocSendHeaderPtrs *ptrs,
     os_int remote_mblk_id,
-    os_int addr);
+    os_int addr,
+    os_uchar extra_flags);
 
 /* Finish outgoing frame with general stuff.
  */
@@ -23,19 +23,22 @@ static osalStatus ioc_process_received_data_frame(
     os_int addr,
     os_char *data,
     os_int data_sz,
-    os_uchar flags);
+    os_uchar flags,
+    os_uchar extra_flags);
 
 static osalStatus ioc_process_received_system_frame(
     iocConnection *con,
     os_uint mblk_id,
-    os_char *data);
+    os_char *data,
+    os_int data_sz);
 
 static osalStatus ioc_store_data_frame(
     iocTargetBuffer *tbuf,
     os_int addr,
     os_char *data,
     os_int data_sz,
-    os_uchar flags);
+    os_uchar flags,
+    os_uchar extra_flags);
 
 
 /**
@@ -140,6 +143,10 @@ osalStatus ioc_connection_receive(
         osal_trace3_int("ACK received, in air=",
             (con->bytes_sent - con->processed_bytes));
 
+#if IOC_ADAPTIVE_FLOW_CONTROL
+        ioc_flow_control_ack_received(con);
+#endif
+
         status = OSAL_SUCCESS;
         goto alldone;
     }
@@ -186,10 +193,11 @@ osalStatus ioc_connection_receive(
     /* Process the data frame.
      */
     if (rfs.flags & IOC_SYSTEM_FRAME) {
-        status = ioc_process_received_system_frame(con, mblk_id, (os_char*)p);
+        status = ioc_process_received_system_frame(con, mblk_id, (os_char*)p, rfs.data_sz);
     }
     else {
-        status = ioc_process_received_data_frame(con, mblk_id, addr, (os_char*)p, rfs.data_sz, rfs.flags);
+        status = ioc_process_received_data_frame(con, mblk_id, addr, (os_char*)p, rfs.data_sz,
+            rfs.flags, rfs.extra_flags);
     }
 
 alldone:
@@ -441,6 +449,8 @@ osalStatus ioc_read_frame(
   @param   data_sz Size of received data in bytes.
   @param   flags Bits IOC_DELTA_ENCODED, IOC_COMPRESESSED and IOC_SYNC_COMPLETE are
            important here.
+  @param   extra_flags Extra flags from frame header, IOC_EXTRA_LZ_COMPRESSED bit is
+           important here.
 
   @return  OSAL_SUCCESS if successfull. Other values indicate corrupted frame.
 
@@ -452,7 +462,8 @@ static osalStatus ioc_process_received_data_frame(
     os_int addr,
     os_char *data,
     os_int data_sz,
-    os_uchar flags)
+    os_uchar flags,
+    os_uchar extra_flags)
 {
     iocTargetBuffer
         *tbuf;
@@ -492,11 +503,14 @@ static osalStatus ioc_process_received_data_frame(
 
     /* Store data to target buffer and optionally directly to memory block.
      */
-    if (ioc_store_data_frame(tbuf, addr, data, data_sz, flags))
+    if (ioc_store_data_frame(tbuf, addr, data, data_sz, flags, extra_flags))
     {
         return OSAL_STATUS_FAILED;
     }
 
+#if IOC_CONNECT_STATS
+    ioc_connect_timing_mark(con, IOC_CONNECT_PHASE_FIRST_DATA);
+#endif
     return OSAL_SUCCESS;
 }
 
@@ -519,6 +533,7 @@ static osalStatus ioc_process_received_data_frame(
   @param   con Pointer to the connection object.
   @param   mblk_id Memory block identifier in this end.
   @param   data Received data, can be compressed and delta encoded, check flags.
+  @param   data_sz Size of received data in bytes.
 
   @return  OSAL_SUCCESS if successfull. Other values indicate a corrupted frame.
 
@@ -527,7 +542,8 @@ static osalStatus ioc_process_received_data_frame(
 static osalStatus ioc_process_received_system_frame(
     iocConnection *con,
     os_uint mblk_id,
-    os_char *data)
+    os_char *data,
+    os_int data_sz)
 {
     switch (data[0])
     {
@@ -539,7 +555,7 @@ static osalStatus ioc_process_received_system_frame(
         /* Device authentication data received.
          */
         case IOC_AUTHENTICATION_DATA:
-            return ioc_process_received_authentication_message(con, mblk_id, data);
+            return ioc_process_received_authentication_message(con, mblk_id, data, data_sz);
 
 #if IOC_DYNAMIC_MBLK_CODE
         /* Remove memory block request.
@@ -548,6 +564,13 @@ static osalStatus ioc_process_received_system_frame(
             return ioc_process_remove_mblk_req_frame(con, mblk_id, data);
 #endif
 
+#if IOC_MBINFO_RESUME
+        /* Reply to memory block information digest.
+         */
+        case IOC_MBINFO_RESUME_REPLY:
+            return ioc_process_received_mbinfo_resume_frame(con, data, data_sz);
+#endif
+
         default:
             /* Ignore there, new frame types may be added later and they are to be ignored.
              */
@@ -575,6 +598,8 @@ static osalStatus ioc_process_received_system_frame(
   @param   data_sz Size of received data in bytes.
   @param   flags Bits IOC_DELTA_ENCODED, IOC_COMPRESESSED and IOC_SYNC_COMPLETE are
            important here.
+  @param   extra_flags Extra flags from frame header, IOC_EXTRA_LZ_COMPRESSED bit is
+           important here.
 
   @return  OSAL_SUCCESS if successfull. Other values indicate corrupted frame.
 
@@ -585,7 +610,8 @@ static osalStatus ioc_store_data_frame(
     os_int addr,
     os_char *data,
     os_int data_sz,
-    os_uchar flags)
+    os_uchar flags,
+    os_uchar extra_flags)
 {
     os_int
         max_newdata,
@@ -598,15 +624,46 @@ static osalStatus ioc_store_data_frame(
         return OSAL_STATUS_FAILED;
     }
 
+#if IOC_LAZY_SYNC_BUFFERS
+    /* Synchronized buffers are allocated when first data is received.
+     */
+    if (tbuf->syncbuf.buf == OS_NULL)
+    {
+        if (ioc_tbuf_allocate_syncbuf(tbuf)) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+    }
+#endif
+
     /* Update newdata buffer.
      * If delta encoding, shared buffer contains delta encoded values.
      */
+#if IOC_LZ_COMPRESSION_SUPPORT
+    if ((extra_flags & IOC_EXTRA_LZ_COMPRESSED) && (flags & IOC_COMPRESESSED))
+    {
+        dst_bytes = ioc_uncompress_lz(
+            data,
+            data_sz,
+            tbuf->syncbuf.newdata + addr,
+            max_newdata,
+            flags);
+    }
+    else
+    {
+        dst_bytes = ioc_uncompress(
+            data,
+            data_sz,
+            tbuf->syncbuf.newdata + addr,
+            max_newdata,
+            flags);
+    }
+#else
+    OSAL_UNUSED(extra_flags);
     dst_bytes = ioc_uncompress(
         data,
         data_sz,
         tbuf->syncbuf.newdata + addr,
         max_newdata,
         flags);
+#endif
 
     if (dst_bytes <= 0)
     {
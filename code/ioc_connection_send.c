@@ -28,6 +28,15 @@ static void ioc_make_mblk_info_frame(
     iocConnection *con,
     iocMemoryBlock *mblk);
 
+static os_int ioc_make_acknowledge(
+    iocConnection *con,
+    os_uchar *p);
+
+#if IOC_MBLK_PRIORITY_SUPPORT
+static iocSourceBuffer *ioc_select_sbuf_by_priority(
+    iocConnection *con);
+#endif
+
 
 /**
 ****************************************************************************************************
@@ -53,7 +62,9 @@ osalStatus ioc_connection_send(
         *mblk;
 
     iocSourceBuffer
+#if IOC_MBLK_PRIORITY_SUPPORT == 0
         *start_sbuf,
+#endif
         *sbuf;
 
     osalStatus
@@ -125,6 +136,17 @@ osalStatus ioc_connection_send(
     }
 #endif
 
+#if IOC_MBINFO_RESUME
+    /* Reply to memory block information digest received in authentication message. Or if
+       we sent the digest, wait for reply before sending memory block information.
+     */
+    if (ioc_make_mbinfo_resume_frame(con) != OSAL_COMPLETED ||
+        con->resume.state == IOC_RESUME_WAIT_REPLY)
+    {
+        goto just_move_data;
+    }
+#endif
+
     /* Do we have memory block information to send?
      */
     mblk = ioc_get_mbinfo_to_send(con);
@@ -134,6 +156,12 @@ osalStatus ioc_connection_send(
         goto just_move_data;
     }
 
+#if IOC_MBLK_PRIORITY_SUPPORT
+    /* Select source buffer with modified data by priority.
+     */
+    sbuf = ioc_select_sbuf_by_priority(con);
+    if (sbuf == OS_NULL) goto just_move_data;
+#else
     start_sbuf = con->sbuf.current ? con->sbuf.current : con->sbuf.first;
     if (start_sbuf == OS_NULL) goto just_move_data;
 
@@ -143,7 +171,7 @@ osalStatus ioc_connection_send(
     sbuf = start_sbuf;
     while (!sbuf->syncbuf.used || !sbuf->remote_mblk_id)
     {
-        if (sbuf->remote_mblk_id && sbuf->immediate_sync_needed)
+        if (sbuf->remote_mblk_id && sbuf->immediate_sync_needed && ioc_sbuf_sync_due(sbuf))
         {
             if (ioc_sbuf_synchronize(sbuf))
             {
@@ -163,6 +191,7 @@ osalStatus ioc_connection_send(
         if (sbuf == OS_NULL) sbuf = con->sbuf.first;
         if (sbuf == start_sbuf) goto just_move_data;
     }
+#endif
     con->sbuf.current = sbuf->clink.next;
 
     /* Move data from source buffer to frame buffer.
@@ -181,6 +210,112 @@ just_move_data:
 }
 
 
+#if IOC_MBLK_PRIORITY_SUPPORT
+/**
+****************************************************************************************************
+
+  @brief Select source buffer to send data from.
+  @anchor ioc_select_sbuf_by_priority
+
+  The ioc_select_sbuf_by_priority() function scans connection's source buffers, starting from
+  con->sbuf.current, and selects the one with modified data to send next:
+
+  1. Data which has waited longer than memory block's max_latency_ms hint.
+  2. IOC_MBLK_PRIORITY_HIGH data, and any data which has waited IOC_SEND_STARVATION_MS.
+  3. IOC_MBLK_PRIORITY_NORMAL data.
+  4. IOC_MBLK_PRIORITY_LOW data.
+
+  Within the same rank source buffers are served in round robin order. If some source buffer
+  is due to immediate sync in auto mode, it is done here.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   con Pointer to the connection object.
+  @return  Pointer to selected source buffer, OS_NULL if there is nothing to send.
+
+****************************************************************************************************
+*/
+static iocSourceBuffer *ioc_select_sbuf_by_priority(
+    iocConnection *con)
+{
+    iocSourceBuffer
+        *start_sbuf,
+        *sbuf,
+        *selected;
+
+    iocMemoryBlock
+        *mblk;
+
+    os_timer
+        tnow;
+
+    os_int
+        rank,
+        selected_rank;
+
+    start_sbuf = con->sbuf.current ? con->sbuf.current : con->sbuf.first;
+    if (start_sbuf == OS_NULL) return OS_NULL;
+
+    os_get_timer(&tnow);
+    selected = OS_NULL;
+    selected_rank = 4;
+
+    sbuf = start_sbuf;
+    do
+    {
+        if (sbuf->remote_mblk_id)
+        {
+            if (!sbuf->syncbuf.used && sbuf->immediate_sync_needed && ioc_sbuf_sync_due(sbuf))
+            {
+                if (ioc_sbuf_synchronize(sbuf))
+                {
+                    sbuf->immediate_sync_needed = OS_FALSE;
+                }
+
+#if OSAL_MULTITHREAD_SUPPORT
+                else if (con->worker.trig)
+                {
+                    osal_event_set(con->worker.trig);
+                }
+#endif
+            }
+
+            if (sbuf->syncbuf.used)
+            {
+                mblk = sbuf->mlink.mblk;
+                if (mblk->max_latency_ms &&
+                    os_has_elapsed_since(&sbuf->pending_since, &tnow, mblk->max_latency_ms))
+                {
+                    return sbuf;
+                }
+                if (mblk->priority == IOC_MBLK_PRIORITY_HIGH ||
+                    os_has_elapsed_since(&sbuf->pending_since, &tnow, IOC_SEND_STARVATION_MS))
+                {
+                    rank = 1;
+                }
+                else
+                {
+                    rank = (mblk->priority == IOC_MBLK_PRIORITY_LOW) ? 3 : 2;
+                }
+
+                if (rank < selected_rank)
+                {
+                    selected = sbuf;
+                    selected_rank = rank;
+                }
+            }
+        }
+
+        sbuf = sbuf->clink.next;
+        if (sbuf == OS_NULL) sbuf = con->sbuf.first;
+    }
+    while (sbuf != start_sbuf);
+
+    return selected;
+}
+#endif
+
+
 /**
 ****************************************************************************************************
 
@@ -205,7 +340,9 @@ static void ioc_make_data_frame(
         max_dst_bytes,
         src_bytes,
         start_addr,
-        used_bytes;
+        end_addr,
+        used_bytes,
+        ws;
 
     os_int
         bytes;
@@ -223,26 +360,73 @@ static void ioc_make_data_frame(
     os_ushort
         crc;
 
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    os_int
+        ack_bytes;
+#endif
+
 #if IOC_STATIC_MBLK_IN_PROGMEN
     os_boolean is_static = OS_FALSE;
 #endif
 
+#if IOC_LZ_COMPRESSION_SUPPORT
+    os_boolean
+        use_lz,
+        lz_used = OS_FALSE;
+#endif
+
+    saved_start_addr = sbuf->syncbuf.start_addr;
+
+#if IOC_LZ_COMPRESSION_SUPPORT
+    /* LZ compression may be used for key frames and large ranges, if the other end
+       has told in authentication message that it can uncompress it. Extra flags byte
+       is needed in header to mark LZ compressed frame.
+     */
+    use_lz = (os_boolean)((con->peer_features & IOC_AUTH_FEATURE_LZ_COMPRESSION) &&
+        sbuf->syncbuf.delta != OS_NULL &&
+        (sbuf->syncbuf.is_keyframe ||
+         sbuf->syncbuf.end_addr - saved_start_addr + 1 >= IOC_LZ_MIN_RANGE));
+
+    /* Set frame header
+     */
+    ioc_generate_header(con, con->frame_out.buf, &ptrs,
+        sbuf->remote_mblk_id,
+        (os_uint)saved_start_addr,
+        use_lz ? IOC_EXTRA_LZ_COMPRESSED : 0);
+#else
     /* Set frame header
      */
-    saved_start_addr = sbuf->syncbuf.start_addr;
     ioc_generate_header(con, con->frame_out.buf, &ptrs,
         sbuf->remote_mblk_id,
-        (os_uint)saved_start_addr);
+        (os_uint)saved_start_addr, 0);
+#endif
 
+    /* Delta buffer may cover only a window of the memory block, ws is address of
+       the first byte in delta buffer. Compression is done with window addresses.
+     */
     delta = sbuf->syncbuf.delta;
+#if IOC_LAZY_SYNC_BUFFERS
+    ws = (delta == OS_NULL) ? 0 : sbuf->syncbuf.win_start;
+#else
+    ws = 0;
+#endif
+    end_addr = sbuf->syncbuf.end_addr - ws;
     max_dst_bytes = con->dst_frame_sz - ptrs.header_sz; // DST_FRAME_SZ
+
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    /* If we have received data to acknowledge, reserve space to piggyback
+       the acknowledgement after the data frame.
+     */
+    ack_bytes = ioc_flow_control_piggyback_bytes(con);
+    max_dst_bytes -= ack_bytes;
+#endif
     dst = con->frame_out.buf + ptrs.header_sz;
 
     /* Compress data from synchronized buffer. Save start addr in case
        we need to cancel send because of flow control.
      */
     con->frame_out.pos = 0;
-    start_addr = saved_start_addr;
+    start_addr = saved_start_addr - ws;
     if (delta == OS_NULL) /* IOC_STATIC -> delta=0 */
     {
 #if IOC_STATIC_MBLK_IN_PROGMEN
@@ -263,10 +447,47 @@ static void ioc_make_data_frame(
        *ptrs.flags |= IOC_DELTA_ENCODED;
 #endif
     }
+
+#if IOC_LZ_COMPRESSION_SUPPORT
+    /* Key frame is LZ compressed, if allowed. Delta is first zero run compressed, which
+       suits well for sparse changes, and LZ is tried only if that fails. Zero run
+       compression is used as fallback in all cases.
+     */
+    compressed_bytes = -1;
+    if (use_lz && sbuf->syncbuf.is_keyframe)
+    {
+        compressed_bytes = ioc_compress_lz(delta,
+            &start_addr,
+            end_addr,
+            dst, max_dst_bytes);
+        lz_used = (os_boolean)(compressed_bytes >= 0);
+    }
+    if (!lz_used)
+    {
+        compressed_bytes = ioc_compress(delta,
+            &start_addr,
+            end_addr,
+            dst, max_dst_bytes);
+
+        if (compressed_bytes < 0 && use_lz && !sbuf->syncbuf.is_keyframe)
+        {
+            compressed_bytes = ioc_compress_lz(delta,
+                &start_addr,
+                end_addr,
+                dst, max_dst_bytes);
+            lz_used = (os_boolean)(compressed_bytes >= 0);
+        }
+    }
+    if (use_lz && !lz_used)
+    {
+        *ptrs.extra_flags &= (os_uchar)~IOC_EXTRA_LZ_COMPRESSED;
+    }
+#else
     compressed_bytes = ioc_compress(delta,
         &start_addr,
-        sbuf->syncbuf.end_addr,
+        end_addr,
         dst, max_dst_bytes);
+#endif
 
 skip_for_static:
     src_bytes = sbuf->syncbuf.end_addr - saved_start_addr + 1;
@@ -283,10 +504,13 @@ skip_for_static:
     if (used_bytes > bytes)
     {
         osal_trace2_int("Data frame canceled by flow control, free space on air=", bytes);
+#if IOC_ADAPTIVE_FLOW_CONTROL
+        con->fc.window_limited = OS_TRUE;
+#endif
         return;
     }
 
-    sbuf->syncbuf.start_addr = start_addr;
+    sbuf->syncbuf.start_addr = start_addr + ws;
 
     /* Frame not rejected by flow control, increment frame number.
      */
@@ -299,13 +523,13 @@ skip_for_static:
     {
 #if IOC_STATIC_MBLK_IN_PROGMEN
         if (is_static) {
-            os_memcpy_P(dst, delta + saved_start_addr, src_bytes);
+            os_memcpy_P(dst, delta + saved_start_addr - ws, src_bytes);
         }
         else {
-            os_memcpy(dst, delta + saved_start_addr, src_bytes);
+            os_memcpy(dst, delta + saved_start_addr - ws, src_bytes);
         }
 #else
-        os_memcpy(dst, delta + saved_start_addr, src_bytes);
+        os_memcpy(dst, delta + saved_start_addr - ws, src_bytes);
 #endif
         sbuf->syncbuf.start_addr += src_bytes;
     }
@@ -338,6 +562,9 @@ skip_for_static:
         {
             sbuf->syncbuf.used = OS_FALSE;
             *ptrs.flags |= IOC_SYNC_COMPLETE;
+#if IOC_LAZY_SYNC_BUFFERS
+            if (sbuf->syncbuf.release_window) ioc_sbuf_release_window(sbuf);
+#endif
 
 #if OSAL_MULTITHREAD_SUPPORT
             ioc_do_callback(sbuf->mlink.mblk, IOC_MBLK_CALLBACK_WRITE_TRIGGER, 0, 0);
@@ -346,6 +573,9 @@ skip_for_static:
 #else
         sbuf->syncbuf.used = OS_FALSE;
         *ptrs.flags |= IOC_SYNC_COMPLETE;
+#if IOC_LAZY_SYNC_BUFFERS
+        if (sbuf->syncbuf.release_window) ioc_sbuf_release_window(sbuf);
+#endif
 #if OSAL_MULTITHREAD_SUPPORT
         ioc_do_callback(sbuf->mlink.mblk, IOC_MBLK_CALLBACK_WRITE_TRIGGER, 0, 0);
 #endif
@@ -361,6 +591,19 @@ skip_for_static:
         *ptrs.checksum_low = (os_uchar)crc;
         *ptrs.checksum_high = (os_uchar)(crc >> 8);
     }
+
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    /* Start round trip measurement for this frame, if not running, and piggyback
+       acknowledgement after the frame to write both with one stream write.
+     */
+    ioc_flow_control_frame_sent(con, con->frame_out.used);
+    if (ack_bytes)
+    {
+        con->frame_out.used += ioc_make_acknowledge(con,
+            (os_uchar*)con->frame_out.buf + con->frame_out.used);
+        con->fc.piggybacked_acks++;
+    }
+#endif
 }
 
 
@@ -385,22 +628,18 @@ static void ioc_make_mblk_info_frame(
     iocSendHeaderPtrs
         ptrs;
 
+    iocMemoryBlockInfo
+        info;
+
     os_uchar
         *p,
         *start,
         *iflags;
 
-    os_uint
-        device_nr;
-
-    os_char
-        *device_name,
-        *network_name;
-
     /* Set frame header.
      */
     ioc_generate_header(con, con->frame_out.buf, &ptrs,
-        mblk->mblk_id, 0);
+        mblk->mblk_id, 0, 0);
 
     /* Generate frame content. Here we do not check for buffer overflow,
        we know (and trust) that it fits within one frame.
@@ -410,38 +649,22 @@ static void ioc_make_mblk_info_frame(
     iflags = p; /* version, for future additions (only 1 bit left for version) + flags */
     *(p++) = 0;
 
-    /* Set device number. If we are sending to device with automatically
-     * number, mark device number with IOC_TO_AUTO_DEVICE_NR.
+    /* Get memory block information as sent trough this connection.
      */
-#if IOC_MBLK_SPECIFIC_DEVICE_NAME
-    device_nr = mblk->device_nr;
-    device_name = mblk->device_name;
-    network_name = mblk->network_name;
-#else
-    device_nr = con->link.root->device_nr;
-    device_name = con->link.root->device_name;
-    network_name = con->link.root->network_name;
-#endif
-    if (device_nr > IOC_AUTO_DEVICE_NR)
-    {
-        if (device_nr == con->auto_device_nr && (mblk->local_flags & IOC_MBLK_LOCAL_AUTO_ID))
-        {
-            device_nr = IOC_TO_AUTO_DEVICE_NR;
-        }
-    }
+    ioc_make_mbinfo(con, mblk, &info);
 
-    ioc_msg_set_uint(device_nr, &p, iflags, IOC_INFO_D_2BYTES, iflags, IOC_INFO_D_4BYTES);
-    ioc_msg_set_uint(mblk->nbytes, &p, iflags, IOC_INFO_N_2BYTES, iflags, IOC_INFO_N_4BYTES);
-    if (ioc_msg_set_ushort(mblk->flags, &p)) *iflags |= IOC_INFO_F_2BYTES;
-    if (device_name[0])
+    ioc_msg_set_uint(info.device_nr, &p, iflags, IOC_INFO_D_2BYTES, iflags, IOC_INFO_D_4BYTES);
+    ioc_msg_set_uint(info.nbytes, &p, iflags, IOC_INFO_N_2BYTES, iflags, IOC_INFO_N_4BYTES);
+    if (ioc_msg_set_ushort(info.flags, &p)) *iflags |= IOC_INFO_F_2BYTES;
+    if (info.device_name[0])
     {
-        ioc_msg_setstr(device_name, &p);
-        ioc_msg_setstr(network_name, &p);
+        ioc_msg_setstr(info.device_name, &p);
+        ioc_msg_setstr(info.network_name, &p);
         *iflags |= IOC_INFO_HAS_DEVICE_NAME;
     }
-    if (mblk->mblk_name[0] /* || network_name[0] */)
+    if (info.mblk_name[0] /* || network_name[0] */)
     {
-        ioc_msg_setstr(mblk->mblk_name, &p);
+        ioc_msg_setstr(info.mblk_name, &p);
         *iflags |= IOC_INFO_HAS_MBLK_NAME;
     }
 
@@ -485,12 +708,6 @@ osalStatus ioc_send_acknowledge(
 
     IOC_MT_ROOT_PTR;
 
-    os_uchar
-        *p;
-
-    os_uint
-        rbytes;
-
     ioc_set_mt_root(root, con->link.root);
     ioc_lock(root);
 
@@ -504,19 +721,10 @@ osalStatus ioc_send_acknowledge(
 
     /* Generate acknowledge/keepalive message
      */
-    p = (os_uchar*)con->frame_out.buf;
-    *(p++) = IOC_ACKNOWLEDGE;
-    rbytes = con->bytes_received;
-    *(p++) = (os_uchar)rbytes;
-    *p = (os_uchar)(rbytes >> 8);
-    if (con->flags & IOC_SOCKET) {
-        *(++p) = (os_uchar)(rbytes >> 16);
-        con->frame_out.used = IOC_SOCKET_ACK_SIZE;
-    }
-    else {
-        con->frame_out.used = IOC_SERIAL_ACK_SIZE;
-    }
-    con->bytes_acknowledged = rbytes;
+    con->frame_out.used = ioc_make_acknowledge(con, (os_uchar*)con->frame_out.buf);
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    con->fc.standalone_acks++;
+#endif
 
     status = ioc_write_to_stream(con);
     os_get_timer(&con->last_send);
@@ -533,6 +741,41 @@ osalStatus ioc_send_acknowledge(
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Generate acknowledge message.
+  @anchor ioc_make_acknowledge
+
+  The ioc_make_acknowledge() function stores acknowledge message with number of received
+  bytes at given position in outgoing frame buffer, and marks received bytes acknowledged.
+
+  @param   con Pointer to the connection object.
+  @param   p Pointer where to store the acknowledge message.
+  @return  Acknowledge message size in bytes, IOC_SOCKET_ACK_SIZE or IOC_SERIAL_ACK_SIZE.
+
+****************************************************************************************************
+*/
+static os_int ioc_make_acknowledge(
+    iocConnection *con,
+    os_uchar *p)
+{
+    os_uint
+        rbytes;
+
+    *(p++) = IOC_ACKNOWLEDGE;
+    rbytes = con->bytes_received;
+    *(p++) = (os_uchar)rbytes;
+    *p = (os_uchar)(rbytes >> 8);
+    con->bytes_acknowledged = rbytes;
+    if (con->flags & IOC_SOCKET) {
+        *(++p) = (os_uchar)(rbytes >> 16);
+        return IOC_SOCKET_ACK_SIZE;
+    }
+    return IOC_SERIAL_ACK_SIZE;
+}
+
+
 /**
 ****************************************************************************************************
 
@@ -643,12 +886,21 @@ osalStatus ioc_acknowledge_as_needed(
         return OSAL_PENDING;
     }
 
-    /* If we have received enough unacknowledged bytes to acknowledge now.
+    /* If we have received enough unacknowledged bytes to acknowledge now. With adaptive
+       flow control the limit depends on round trip time and is at most half of the smallest
+       window the other end may use, and smaller amounts are acknowledged by piggybacking
+       after outgoing data frames.
      */
     u = (con->bytes_received - con->bytes_acknowledged) & mask;
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    if (u < (os_uint)con->fc.ack_limit) {
+        return OSAL_SUCCESS;
+    }
+#else
     if (u < con->unacknogledged_limit) {
         return OSAL_SUCCESS;
     }
+#endif
 
     status = ioc_send_acknowledge(con);
     if (status != OSAL_SUCCESS && status != OSAL_PENDING) {
@@ -786,6 +1038,8 @@ static osalStatus ioc_write_to_stream(
   @param   remote_mblk_id Identifier of remote memory block to which the message being
            generated is addressed to.
   @param   addr Beginning address within the memory block where this data is written to.
+  @param   extra_flags Extra flags to set, like IOC_EXTRA_LZ_COMPRESSED. If nonzero, the
+           extra flags byte is always included in header. Zero if none.
 
   @return  None.
 
@@ -796,7 +1050,8 @@ void ioc_generate_header(
     os_char *hdr,
     iocSendHeaderPtrs *ptrs,
     os_int remote_mblk_id,
-    os_int addr)
+    os_int addr,
+    os_uchar extra_flags)
 {
     os_boolean
         is_serial;
@@ -854,11 +1109,11 @@ void ioc_generate_header(
 
     /* If we need extra flags.
      */
-    if ((remote_mblk_id >> 16) || (addr >> 16))
+    if ((remote_mblk_id >> 16) || (addr >> 16) || extra_flags)
     {
         flags |= IOC_EXTRA_FLAGS;
         ptrs->extra_flags = p;
-        *(p++) = IOC_EXTRA_NO_ZERO;
+        *(p++) = IOC_EXTRA_NO_ZERO | extra_flags;
     }
 
     /* MBLK: Memory block idenfier, ADDR: Start memory address.
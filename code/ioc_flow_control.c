@@ -0,0 +1,389 @@
+/**
+
+  @file    ioc_flow_control.c
+  @brief   Round trip time estimate and adaptive acknowledgements.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_ADAPTIVE_FLOW_CONTROL
+
+/* Forward referred static functions.
+ */
+static void ioc_adapt_ack_limit(
+    iocConnection *con);
+
+static void ioc_adapt_window(
+    iocConnection *con,
+    os_int sample);
+
+static void ioc_set_max_in_air(
+    iocConnection *con,
+    os_int max_in_air);
+
+
+/**
+****************************************************************************************************
+
+  @brief Reset flow control state.
+  @anchor ioc_reset_flow_control
+
+  The ioc_reset_flow_control() function is called when connection is (re)established to
+  forget round trip time estimate of previous connection. Socket connection's window is
+  set back to fixed IOC_SOCKET_MAX_IN_AIR until bounds are negotiated by authentication
+  message. The other end's window toward this end is its fixed window, which is calculated
+  from this end's frame size. Acknowledge counters are kept.
+
+  @param   con Pointer to the connection object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_reset_flow_control(
+    iocConnection *con)
+{
+    con->fc.rtt_measuring = OS_FALSE;
+    con->fc.rtt_ms = 0;
+    con->fc.window_limited = OS_FALSE;
+    if ((con->flags & IOC_SOCKET) && con->dst_frame_sz)
+    {
+        ioc_set_max_in_air(con, IOC_SOCKET_MAX_IN_AIR(con->dst_frame_sz));
+    }
+    con->fc.max_in_air_min = con->fc.max_in_air_max = con->max_in_air;
+    con->fc.peer_in_air = (con->flags & IOC_SOCKET)
+        ? IOC_SOCKET_MAX_IN_AIR(con->frame_sz) : con->max_in_air;
+    con->fc.ack_limit = con->unacknogledged_limit;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set flow control window bounds.
+  @anchor ioc_flow_control_set_window_bounds
+
+  The ioc_flow_control_set_window_bounds() function is called when authentication message
+  has been received from the other end. If the other end did tell largest window it accepts,
+  window is adapted between IOC_FC_MIN_IN_AIR and smaller of the two maximums. Otherwise
+  the fixed window is kept, as older versions expect.
+
+  The other end adapts its window toward this end the same way, so it may shrink it down to
+  IOC_FC_MIN_IN_AIR of this end's frame size. The acknowledge limit is recalculated for that
+  smallest window.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   con Pointer to the connection object.
+  @param   peer_max_in_air Largest window the other end accepts in bytes, 0 if not sent.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_flow_control_set_window_bounds(
+    iocConnection *con,
+    os_int peer_max_in_air)
+{
+    os_int
+        min_in_air,
+        max_in_air,
+        peer_in_air;
+
+    con->fc.max_in_air_min = con->fc.max_in_air_max = con->max_in_air;
+    if ((con->flags & IOC_SOCKET) == 0 || peer_max_in_air <= 0) return;
+
+    max_in_air = IOC_FC_MAX_IN_AIR_LIMIT;
+    if (peer_max_in_air < max_in_air) max_in_air = peer_max_in_air;
+    min_in_air = IOC_FC_MIN_IN_AIR(con->dst_frame_sz);
+    if (min_in_air > con->max_in_air) min_in_air = con->max_in_air;
+    if (max_in_air < con->max_in_air) max_in_air = con->max_in_air;
+
+    con->fc.max_in_air_min = min_in_air;
+    con->fc.max_in_air_max = max_in_air;
+
+    peer_in_air = IOC_FC_MIN_IN_AIR(con->frame_sz);
+    if (peer_in_air < con->fc.peer_in_air) con->fc.peer_in_air = peer_in_air;
+    ioc_adapt_ack_limit(con);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Start round trip time measurement.
+  @anchor ioc_flow_control_frame_sent
+
+  The ioc_flow_control_frame_sent() function is called when a data frame has been placed
+  in outgoing frame buffer. If round trip measurement is not already running, it is started
+  for this frame.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   con Pointer to the connection object.
+  @param   frame_bytes Number of bytes in outgoing frame buffer.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_flow_control_frame_sent(
+    iocConnection *con,
+    os_int frame_bytes)
+{
+    if (con->fc.rtt_measuring) return;
+
+    con->fc.rtt_mark = (con->bytes_sent + (os_uint)frame_bytes)
+        & ((con->flags & IOC_SOCKET) ? 0xFFFFFF : 0xFFFF);
+    os_get_timer(&con->fc.rtt_timer);
+    con->fc.rtt_measuring = OS_TRUE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Acknowledge received, complete round trip time measurement.
+  @anchor ioc_flow_control_ack_received
+
+  The ioc_flow_control_ack_received() function is called when acknowledge message has been
+  received and con->processed_bytes updated. If the acknowledgement covers the frame being
+  measured, the round trip time sample is taken. The estimate is minimum of samples
+  within IOC_RTT_WINDOW_MS, to filter out delay caused by the other end postponing
+  acknowledgements. If window bounds have been negotiated, the sample is also used
+  to adapt the window.
+
+  Only immediate acknowledgements are sampled. The other end acknowledges at once when
+  received unacknowledged bytes reach its acknowledge limit, otherwise it holds the
+  acknowledgement until it sends data or keep alive. Such delayed acknowledgement covers
+  everything sent, nothing is in air when it arrives. It is not sampled, since the time
+  includes the other end's waiting and would shrink the window for no reason.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   con Pointer to the connection object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_flow_control_ack_received(
+    iocConnection *con)
+{
+    os_timer
+        tnow;
+
+    os_uint
+        mask,
+        d;
+
+    os_int
+        sample;
+
+    if (!con->fc.rtt_measuring) return;
+
+    mask = (con->flags & IOC_SOCKET) ? 0xFFFFFF : 0xFFFF;
+    d = (con->processed_bytes - con->fc.rtt_mark) & mask;
+    if (d > (mask >> 1)) return;
+
+    /* Possibly delayed acknowledgement, start over with the next frame.
+     */
+    if (((con->bytes_sent - con->processed_bytes) & mask) == 0)
+    {
+        con->fc.rtt_measuring = OS_FALSE;
+        return;
+    }
+
+    os_get_timer(&tnow);
+    sample = (os_int)os_get_ms_elapsed(&con->fc.rtt_timer, &tnow);
+    if (sample < 1) sample = 1;
+    con->fc.rtt_measuring = OS_FALSE;
+    if (con->fc.max_in_air_max > con->fc.max_in_air_min && con->fc.rtt_ms) {
+        ioc_adapt_window(con, sample);
+    }
+
+    if (con->fc.rtt_ms == 0 ||
+        sample < con->fc.rtt_ms ||
+        os_has_elapsed_since(&con->fc.rtt_window_timer, &tnow, IOC_RTT_WINDOW_MS))
+    {
+        if (sample != con->fc.rtt_ms)
+        {
+            con->fc.rtt_ms = sample;
+            ioc_adapt_ack_limit(con);
+        }
+        con->fc.rtt_window_timer = tnow;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get number of bytes to reserve for piggybacked acknowledgement.
+  @anchor ioc_flow_control_piggyback_bytes
+
+  The ioc_flow_control_piggyback_bytes() function checks if there are enough received
+  unacknowledged bytes to acknowledge them with the outgoing data frame. Threshold is
+  quarter of connection's unacknogledged_limit, so acknowledgements are sent more
+  often when it costs no extra stream writes.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   con Pointer to the connection object.
+  @return  Acknowledge message size, IOC_SOCKET_ACK_SIZE or IOC_SERIAL_ACK_SIZE, if
+           acknowledgement should be piggybacked. Zero if not.
+
+****************************************************************************************************
+*/
+os_int ioc_flow_control_piggyback_bytes(
+    iocConnection *con)
+{
+    os_uint
+        u,
+        mask;
+
+    mask = (con->flags & IOC_SOCKET) ? 0xFFFFFF : 0xFFFF;
+    u = (con->bytes_received - con->bytes_acknowledged) & mask;
+    if (u == 0 || u < (os_uint)(con->unacknogledged_limit >> 2)) return 0;
+
+    return (con->flags & IOC_SOCKET) ? IOC_SOCKET_ACK_SIZE : IOC_SERIAL_ACK_SIZE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Adapt stand-alone acknowledge limit to round trip time and window size.
+  @anchor ioc_adapt_ack_limit
+
+  The ioc_adapt_ack_limit() function sets number of received bytes which can be left
+  unacknowledged before stand-alone acknowledge message is sent. On fast local links
+  acknowledgements are postponed up to 1/8 of the smaller of this end's window and the
+  smallest window the other end may use, to reduce number of small packets. As round trip
+  time grows, the limit is scaled down towards unacknogledged_limit, so that the other end's
+  send window is reopened quickly. The limit never exceeds half of the other end's window:
+  The received bytes are the other end's data in flight, if the limit was at or above its
+  window, the other end would stop and wait for keep alive to carry the acknowledgement.
+
+  @param   con Pointer to the connection object.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_adapt_ack_limit(
+    iocConnection *con)
+{
+    os_int
+        limit,
+        max_limit;
+
+    limit = con->unacknogledged_limit;
+    max_limit = con->max_in_air;
+    if (con->fc.peer_in_air > 0 && con->fc.peer_in_air < max_limit)
+    {
+        max_limit = con->fc.peer_in_air;
+    }
+    max_limit >>= 3;
+
+    if (con->fc.rtt_ms > 0 && max_limit > limit)
+    {
+        if (con->fc.rtt_ms <= IOC_ACK_LAN_RTT_MS)
+        {
+            limit = max_limit;
+        }
+        else
+        {
+            max_limit = (os_int)(((os_long)max_limit * IOC_ACK_LAN_RTT_MS) / con->fc.rtt_ms);
+            if (max_limit > limit) limit = max_limit;
+        }
+    }
+
+    if (con->fc.peer_in_air > 0 && limit > (con->fc.peer_in_air >> 1))
+    {
+        limit = con->fc.peer_in_air >> 1;
+    }
+    con->fc.ack_limit = limit;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Adapt flow control window to round trip time.
+  @anchor ioc_adapt_window
+
+  The ioc_adapt_window() function is called for each round trip time sample. The sample
+  includes time the measured frame spent queued behind data sent before it. If sample is
+  more than twice the minimum (plus LAN jitter allowance), the link is over-buffered and
+  window is shrunk by 1/8. Otherwise if flow control did block sending since previous sample,
+  window is the bottleneck and it is grown by 1/4. This settles window near bandwidth-delay
+  product: Enough to keep the link busy, but not more.
+
+  @param   con Pointer to the connection object.
+  @param   sample Round trip time sample, ms.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_adapt_window(
+    iocConnection *con,
+    os_int sample)
+{
+    os_int
+        w;
+
+    w = con->max_in_air;
+    if (sample > 2 * con->fc.rtt_ms + IOC_ACK_LAN_RTT_MS)
+    {
+        w -= w >> 3;
+        if (w < con->fc.max_in_air_min) w = con->fc.max_in_air_min;
+    }
+    else if (con->fc.window_limited)
+    {
+        w += w >> 2;
+        if (w > con->fc.max_in_air_max) w = con->fc.max_in_air_max;
+    }
+    con->fc.window_limited = OS_FALSE;
+
+    if (w != con->max_in_air)
+    {
+        ioc_set_max_in_air(con, w);
+        ioc_adapt_ack_limit(con);
+        osal_trace2_int("Flow control window adapted to ", w);
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set socket connection's flow control window.
+  @anchor ioc_set_max_in_air
+
+  The ioc_set_max_in_air() function sets window for data and for acknowledge messages,
+  the latter keeps the same air space reserve for acknowledgements as the fixed
+  IOC_SOCKET_MAX_ACK_IN_AIR.
+
+  @param   con Pointer to the connection object.
+  @param   max_in_air New window size in bytes.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_set_max_in_air(
+    iocConnection *con,
+    os_int max_in_air)
+{
+    con->max_in_air = max_in_air;
+    if (con->flags & IOC_SOCKET)
+    {
+        con->max_ack_in_air = max_in_air + IOC_SOCKET_UNACKNOGLEDGED_LIMIT
+            + IOC_SOCKET_NRO_ACKS_TO_RESEVE * IOC_SOCKET_ACK_SIZE;
+    }
+}
+
+#endif
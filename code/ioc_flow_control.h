@@ -0,0 +1,164 @@
+/**
+
+  @file    ioc_flow_control.h
+  @brief   Round trip time estimate and adaptive acknowledgements.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Round trip time is estimated from acknowledge timing: Time is recorded when a data frame is
+  sent, and the measurement completes when the other end acknowledges it. The minimum of
+  recent samples is used, since the other end may delay acknowledgements.
+
+  The estimate is used to adapt the number of received bytes which may be left unacknowledged
+  before sending a stand-alone acknowledge message. When there is data to send, the
+  acknowledgement is piggybacked after the data frame, within the same stream write.
+
+  On socket connections the flow control window (max_in_air) is adapted as well: It grows
+  while sending is blocked by the window and round trip time stays near minimum, and shrinks
+  when round trip time grows (data is queuing). Window bounds are negotiated in authentication
+  message, if the other end doesn't send them the fixed IOC_SOCKET_MAX_IN_AIR is used.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_FLOW_CONTROL_H_
+#define IOC_FLOW_CONTROL_H_
+#include "iocom.h"
+
+#if IOC_ADAPTIVE_FLOW_CONTROL
+
+struct iocConnection;
+
+/* Round trip time at or below which link is considered local (LAN) and maximum
+   acknowledge limit is used. With longer round trip times acknowledge limit is scaled
+   down towards the connection's unacknogledged_limit.
+ */
+#ifndef IOC_ACK_LAN_RTT_MS
+#define IOC_ACK_LAN_RTT_MS 2
+#endif
+
+/* Round trip time estimate is the minimum of samples taken within this period.
+ */
+#ifndef IOC_RTT_WINDOW_MS
+#define IOC_RTT_WINDOW_MS 10000
+#endif
+
+/* Largest flow control window this end accepts on socket connection, bytes. Sent to the
+   other end in authentication message in kilobytes. Must be well below 8 MB, since sent and
+   received byte counters are compared modulo 2^24.
+ */
+#ifndef IOC_FC_MAX_IN_AIR_LIMIT
+#define IOC_FC_MAX_IN_AIR_LIMIT (1024 * 1024)
+#endif
+
+/* Smallest flow control window on socket connection, bytes.
+ */
+#ifndef IOC_FC_MIN_IN_AIR
+#define IOC_FC_MIN_IN_AIR(frame_sz) (8 * (frame_sz))
+#endif
+
+/**
+****************************************************************************************************
+    Flow control state for a connection.
+****************************************************************************************************
+*/
+typedef struct iocFlowControlState
+{
+    /** Round trip measurement: Received byte count (as in acknowledge message) which
+        completes the measurement.
+     */
+    os_uint rtt_mark;
+
+    /** Round trip measurement: Timer when measured frame was sent.
+     */
+    os_timer rtt_timer;
+
+    /** Round trip measurement is running.
+     */
+    os_boolean rtt_measuring;
+
+    /** Round trip time estimate in milliseconds, zero if not known.
+     */
+    os_int rtt_ms;
+
+    /** Timer when current round trip time minimum window was started.
+     */
+    os_timer rtt_window_timer;
+
+    /** Negotiated bounds for con->max_in_air. Equal if window is not adapted (serial
+        connection or other end doesn't support it).
+     */
+    os_int max_in_air_min;
+    os_int max_in_air_max;
+
+    /** Smallest window the other end may use when sending to this end, bytes. Stand-alone
+        acknowledge limit is kept well below this, so that the other end is never blocked
+        waiting for acknowledgement.
+     */
+    os_int peer_in_air;
+
+    /** Data frame has been canceled by flow control since last round trip sample, thus
+        the window limits the throughput.
+     */
+    os_boolean window_limited;
+
+    /** Number of received unacknowledged bytes which triggers sending stand-alone
+        acknowledge message.
+     */
+    os_int ack_limit;
+
+    /** Number of stand-alone acknowledge and keep alive messages sent.
+     */
+    os_uint standalone_acks;
+
+    /** Number of acknowledgements piggybacked after data frames.
+     */
+    os_uint piggybacked_acks;
+}
+iocFlowControlState;
+
+
+/**
+****************************************************************************************************
+  Flow control functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Reset flow control state when connection is (re)established.
+ */
+void ioc_reset_flow_control(
+    struct iocConnection *con);
+
+/* Start round trip time measurement for a data frame, if not already running.
+ */
+void ioc_flow_control_frame_sent(
+    struct iocConnection *con,
+    os_int frame_bytes);
+
+/* Complete round trip measurement when acknowledge message is received.
+ */
+void ioc_flow_control_ack_received(
+    struct iocConnection *con);
+
+/* Set flow control window bounds when authentication message has been received.
+ */
+void ioc_flow_control_set_window_bounds(
+    struct iocConnection *con,
+    os_int peer_max_in_air);
+
+/* Get number of bytes to reserve for piggybacked acknowledgement in data frame.
+ */
+os_int ioc_flow_control_piggyback_bytes(
+    struct iocConnection *con);
+
+/*@}*/
+
+#endif
+#endif
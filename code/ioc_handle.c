@@ -173,9 +173,17 @@ void ioc_terminate_handles(
 /* Get memory block pointer from handle and enter synchronization lock.
  * If memory block no longer exists, lock is left off and proot pointer is set to NULL.
  */
+#if IOC_PERF_TRACE
+struct iocMemoryBlock *ioc_handle_lock_to_mblk_at(
+    iocHandle *handle,
+    struct iocRoot **proot,
+    const os_char *file,
+    os_int line)
+#else
 struct iocMemoryBlock *ioc_handle_lock_to_mblk(
     iocHandle *handle,
     struct iocRoot **proot)
+#endif
 {
     iocRoot *root;
     iocMemoryBlock *mblk;
@@ -195,7 +203,11 @@ struct iocMemoryBlock *ioc_handle_lock_to_mblk(
 
     /* Synchronize.
      */
+#if IOC_PERF_TRACE
+    ioc_lock_at(root, file, line);
+#else
     ioc_lock(root);
+#endif
     ioc_validate_handle(handle);
 
     /* Get memory block pointer. If none, unlock and return NULL to indicate failure.
@@ -78,10 +78,23 @@ void ioc_duplicate_handle(
 void ioc_terminate_handles(
     iocHandle *handle);
 
+#if IOC_PERF_TRACE
+/* Get memory block pointer from handle and enter synchronization lock, trace the lock
+   by call site.
+ */
+struct iocMemoryBlock *ioc_handle_lock_to_mblk_at(
+    iocHandle *handle,
+    struct iocRoot **proot,
+    const os_char *file,
+    os_int line);
+
+#define ioc_handle_lock_to_mblk(h,r) ioc_handle_lock_to_mblk_at((h), (r), __FILE__, __LINE__)
+#else
 /* Get memory block pointer from handle and enter synchronization lock.
  */
 struct iocMemoryBlock *ioc_handle_lock_to_mblk(
     iocHandle *handle,
     struct iocRoot **proot);
+#endif
 
 #endif
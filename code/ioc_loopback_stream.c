@@ -0,0 +1,868 @@
+/**
+
+  @file    ioc_loopback_stream.c
+  @brief   In-process loopback stream.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Listening loopback streams are kept in a process wide list. Connecting creates a pair of
+  streams: the client end returned to caller, and the server end queued for accept(). Data
+  written to one end is placed in ring buffer of the other end. All shared state is
+  protected by os_lock().
+
+  If delay is set for the name, each write into the other end's ring buffer is recorded as
+  a mark with byte count and time. Reader gets only bytes of marks older than the delay.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_LOOPBACK_SUPPORT
+
+
+/**
+****************************************************************************************************
+    Delayed write: Number of bytes written and time when written.
+****************************************************************************************************
+*/
+typedef struct iocLoopbackMark
+{
+    os_int nbytes;
+    os_timer t;
+}
+iocLoopbackMark;
+
+
+/**
+****************************************************************************************************
+    Loopback stream structure.
+****************************************************************************************************
+*/
+typedef struct iocLoopbackStream
+{
+    /** A stream structure must start with this generic stream header structure, which contains
+        parameters common to every stream.
+     */
+    osalStreamHeader hdr;
+
+    /** Stream open flags.
+     */
+    os_int open_flags;
+
+    /** Loopback name, port number stripped.
+     */
+    os_char name[IOC_LOOPBACK_NAME_SZ];
+
+    /** OS_TRUE for listening stream.
+     */
+    os_boolean is_listener;
+
+    /** Connected stream: The other end, OS_NULL if it has been closed.
+     */
+    struct iocLoopbackStream *peer;
+
+    /** Listening stream: Next in the list of listening streams. Server end waiting for
+        accept: Next in listener's pending list.
+     */
+    struct iocLoopbackStream *next;
+
+    /** Server end waiting for accept: The listening stream.
+     */
+    struct iocLoopbackStream *listener;
+
+    /** Listening stream: First server end waiting for accept.
+     */
+    struct iocLoopbackStream *pending;
+
+    /** Connected stream: Data written by peer, to be read from this stream.
+     */
+    osalRingBuf rx;
+
+    /** Error status, set when the peer is closed.
+     */
+    osalStatus status;
+
+    /** Event to set when something happens with the stream, set while in select.
+     */
+    osalEvent select_event;
+    os_boolean trig_select;
+
+    /** One way delay, ms, zero if none. Delayed writes in rx: Ring of marks, index of the
+        oldest mark and number of marks.
+     */
+    os_int delay_ms;
+    iocLoopbackMark *mark;
+    os_int mark_head;
+    os_int mark_count;
+}
+iocLoopbackStream;
+
+/** Delay set for loopback name.
+ */
+typedef struct iocLoopbackDelay
+{
+    os_char name[IOC_LOOPBACK_NAME_SZ];
+    os_int delay_ms;
+}
+iocLoopbackDelay;
+
+/* List of listening loopback streams.
+ */
+static iocLoopbackStream *ioc_loopback_listeners;
+
+/* Delays set by ioc_set_loopback_delay().
+ */
+static iocLoopbackDelay ioc_loopback_delays[IOC_LOOPBACK_MAX_DELAYS];
+
+/* Forward referred static functions.
+ */
+static iocLoopbackStream *ioc_loopback_alloc(
+    const os_char *parameters,
+    os_boolean is_listener,
+    os_int flags);
+
+static void ioc_loopback_free(
+    iocLoopbackStream *thiso);
+
+static void ioc_loopback_trig(
+    iocLoopbackStream *thiso);
+
+static os_int ioc_loopback_delay_for_name(
+    const os_char *name);
+
+static os_int ioc_loopback_due_bytes(
+    iocLoopbackStream *thiso,
+    os_int *wait_ms);
+
+
+/**
+****************************************************************************************************
+
+  @brief Open a loopback stream.
+  @anchor ioc_loopback_open
+
+  The ioc_loopback_open() function either starts listening loopback name, or connects to
+  listening loopback stream within the same process.
+
+  @param  parameters Loopback name, like "bench". Optional port number is ignored.
+  @param  option Not used, set OS_NULL.
+  @param  status Pointer to integer into which to store the function status code. Value
+          OSAL_SUCCESS (0) indicates success and all nonzero values indicate an error.
+          OSAL_STATUS_CONNECTION_REFUSED if nobody is listening the name, OSAL_STATUS_FAILED
+          if the name is already listened. This parameter can be OS_NULL.
+  @param  flags OSAL_STREAM_LISTEN or OSAL_STREAM_CONNECT.
+  @return Stream pointer, or OS_NULL if the function failed.
+
+****************************************************************************************************
+*/
+static osalStream ioc_loopback_open(
+    const os_char *parameters,
+    void *option,
+    osalStatus *status,
+    os_int flags)
+{
+    iocLoopbackStream *thiso, *server, *listener;
+    osalStatus s;
+    OSAL_UNUSED(option);
+
+    if (flags & OSAL_STREAM_LISTEN)
+    {
+        thiso = ioc_loopback_alloc(parameters, OS_TRUE, flags);
+        if (thiso == OS_NULL) goto alloc_failed;
+
+        os_lock();
+        for (listener = ioc_loopback_listeners; listener; listener = listener->next)
+        {
+            if (!os_strcmp(listener->name, thiso->name)) break;
+        }
+        if (listener == OS_NULL)
+        {
+            thiso->next = ioc_loopback_listeners;
+            ioc_loopback_listeners = thiso;
+        }
+        os_unlock();
+
+        if (listener)
+        {
+            ioc_loopback_free(thiso);
+            s = OSAL_STATUS_FAILED;
+            goto getout;
+        }
+    }
+    else
+    {
+        thiso = ioc_loopback_alloc(parameters, OS_FALSE, flags);
+        if (thiso == OS_NULL) goto alloc_failed;
+        server = ioc_loopback_alloc(parameters, OS_FALSE, flags);
+        if (server == OS_NULL)
+        {
+            ioc_loopback_free(thiso);
+            goto alloc_failed;
+        }
+
+        /* Find the listener and queue server end for accept.
+         */
+        os_lock();
+        for (listener = ioc_loopback_listeners; listener; listener = listener->next)
+        {
+            if (!os_strcmp(listener->name, thiso->name)) break;
+        }
+        if (listener)
+        {
+            thiso->peer = server;
+            server->peer = thiso;
+            server->listener = listener;
+            server->next = listener->pending;
+            listener->pending = server;
+            ioc_loopback_trig(listener);
+        }
+        os_unlock();
+
+        if (listener == OS_NULL)
+        {
+            ioc_loopback_free(server);
+            ioc_loopback_free(thiso);
+            s = OSAL_STATUS_CONNECTION_REFUSED;
+            goto getout;
+        }
+    }
+
+    if (status) *status = OSAL_SUCCESS;
+    return (osalStream)thiso;
+
+alloc_failed:
+    s = OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+getout:
+    if (status) *status = s;
+    return OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Close loopback stream.
+  @anchor ioc_loopback_close
+
+  The ioc_loopback_close() function closes a loopback stream. The other end of connected
+  stream gets OSAL_STATUS_STREAM_CLOSED once it has read all data. Closing listening stream
+  closes server ends which have not been accepted.
+
+  @param   stream Stream pointer.
+  @param   flags Reserved, set OSAL_STREAM_DEFAULT (0).
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_loopback_close(
+    osalStream stream,
+    os_int flags)
+{
+    iocLoopbackStream *thiso, *p, **pp, *pending;
+    OSAL_UNUSED(flags);
+
+    if (stream == OS_NULL) return;
+    thiso = (iocLoopbackStream*)stream;
+    osal_debug_assert(thiso->hdr.iface == &ioc_loopback_iface);
+
+    pending = OS_NULL;
+    os_lock();
+    if (thiso->is_listener)
+    {
+        for (pp = &ioc_loopback_listeners; *pp; pp = &(*pp)->next)
+        {
+            if (*pp == thiso)
+            {
+                *pp = thiso->next;
+                break;
+            }
+        }
+
+        /* Detach server ends never accepted, these are freed after unlock.
+         */
+        pending = thiso->pending;
+        for (p = pending; p; p = p->next)
+        {
+            p->listener = OS_NULL;
+            if (p->peer)
+            {
+                p->peer->peer = OS_NULL;
+                p->peer->status = OSAL_STATUS_STREAM_CLOSED;
+                ioc_loopback_trig(p->peer);
+                p->peer = OS_NULL;
+            }
+        }
+    }
+    else
+    {
+        if (thiso->listener)
+        {
+            for (pp = &thiso->listener->pending; *pp; pp = &(*pp)->next)
+            {
+                if (*pp == thiso)
+                {
+                    *pp = thiso->next;
+                    break;
+                }
+            }
+        }
+        if (thiso->peer)
+        {
+            thiso->peer->peer = OS_NULL;
+            thiso->peer->status = OSAL_STATUS_STREAM_CLOSED;
+            ioc_loopback_trig(thiso->peer);
+        }
+    }
+    os_unlock();
+
+    while (pending)
+    {
+        p = pending;
+        pending = p->next;
+        ioc_loopback_free(p);
+    }
+    ioc_loopback_free(thiso);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Accept connection to listening loopback stream.
+  @anchor ioc_loopback_accept
+
+  The ioc_loopback_accept() function returns server end of the oldest waiting connection.
+
+  @param   stream Stream pointer representing the listening stream.
+  @param   remote_ip_addr Buffer where to store "loopback", OS_NULL if not needed.
+  @param   remote_ip_addr_sz Size of remote_ip_addr buffer in bytes.
+  @param   status Pointer to integer into which to store the function status code. Value
+           OSAL_SUCCESS (0) indicates that new connection was accepted. OSAL_NO_NEW_CONNECTION
+           indicates that there is no new connection. This parameter can be OS_NULL.
+  @param   flags Flags for accepted stream, OSAL_STREAM_DEFAULT to use listener's flags.
+  @return  Stream pointer representing the accepted stream, or OS_NULL if none.
+
+****************************************************************************************************
+*/
+static osalStream ioc_loopback_accept(
+    osalStream stream,
+    os_char *remote_ip_addr,
+    os_memsz remote_ip_addr_sz,
+    osalStatus *status,
+    os_int flags)
+{
+    iocLoopbackStream *thiso, *newstream, **pp;
+
+    if (remote_ip_addr) *remote_ip_addr = '\0';
+    if (stream == OS_NULL)
+    {
+        if (status) *status = OSAL_STATUS_FAILED;
+        return OS_NULL;
+    }
+    thiso = (iocLoopbackStream*)stream;
+    osal_debug_assert(thiso->hdr.iface == &ioc_loopback_iface);
+
+    /* Pending list is newest first, accept the oldest.
+     */
+    os_lock();
+    newstream = OS_NULL;
+    for (pp = &thiso->pending; *pp; pp = &(*pp)->next)
+    {
+        if ((*pp)->next == OS_NULL)
+        {
+            newstream = *pp;
+            *pp = OS_NULL;
+            newstream->listener = OS_NULL;
+            break;
+        }
+    }
+    os_unlock();
+
+    if (newstream == OS_NULL)
+    {
+        if (status) *status = OSAL_NO_NEW_CONNECTION;
+        return OS_NULL;
+    }
+
+    newstream->open_flags = (flags == OSAL_STREAM_DEFAULT) ? thiso->open_flags : flags;
+    if (remote_ip_addr) os_strncpy(remote_ip_addr, "loopback", remote_ip_addr_sz);
+    if (status) *status = OSAL_SUCCESS;
+    return (osalStream)newstream;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Flush the loopback stream.
+  @anchor ioc_loopback_flush
+
+  Written data is immediately available to the other end, nothing to flush.
+
+  @param   stream Stream pointer.
+  @param   flags Ignored.
+  @return  OSAL_SUCCESS, or OSAL_STATUS_STREAM_CLOSED if the other end has been closed.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_loopback_flush(
+    osalStream stream,
+    os_int flags)
+{
+    iocLoopbackStream *thiso;
+    OSAL_UNUSED(flags);
+
+    if (stream == OS_NULL) return OSAL_STATUS_FAILED;
+    thiso = (iocLoopbackStream*)stream;
+    osal_debug_assert(thiso->hdr.iface == &ioc_loopback_iface);
+    return thiso->status;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write data to loopback stream.
+  @anchor ioc_loopback_write
+
+  The ioc_loopback_write() function places up to n bytes into the other end's ring buffer.
+
+  @param   stream Stream pointer.
+  @param   buf Pointer to data to write.
+  @param   n Maximum number of bytes to write.
+  @param   n_written Pointer to integer into which the function stores the number of bytes
+           actually written, which may be less than n if ring buffer is full.
+  @param   flags Ignored.
+  @return  OSAL_SUCCESS, or OSAL_STATUS_STREAM_CLOSED if the other end has been closed.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_loopback_write(
+    osalStream stream,
+    const os_char *buf,
+    os_memsz n,
+    os_memsz *n_written,
+    os_int flags)
+{
+    iocLoopbackStream *thiso, *peer;
+    iocLoopbackMark *mark;
+    os_int count;
+    osalStatus s;
+    OSAL_UNUSED(flags);
+
+    *n_written = 0;
+    if (stream == OS_NULL) return OSAL_STATUS_FAILED;
+    thiso = (iocLoopbackStream*)stream;
+    osal_debug_assert(thiso->hdr.iface == &ioc_loopback_iface);
+
+    count = 0;
+    os_lock();
+    s = thiso->status;
+    peer = thiso->peer;
+    if (peer && n > 0 && (peer->mark == OS_NULL || peer->mark_count < IOC_LOOPBACK_MAX_MARKS))
+    {
+        count = osal_ringbuf_put(&peer->rx, buf, (os_int)n);
+        if (count && peer->mark)
+        {
+            mark = peer->mark + (peer->mark_head + peer->mark_count) % IOC_LOOPBACK_MAX_MARKS;
+            mark->nbytes = count;
+            os_get_timer(&mark->t);
+            peer->mark_count++;
+        }
+        if (count) ioc_loopback_trig(peer);
+    }
+    os_unlock();
+
+    *n_written = count;
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Read data from loopback stream.
+  @anchor ioc_loopback_read
+
+  The ioc_loopback_read() function reads up to n bytes from this stream's ring buffer.
+  Data written before the other end was closed can still be read.
+
+  @param   stream Stream pointer.
+  @param   buf Pointer to buffer to read into.
+  @param   n Maximum number of bytes to read.
+  @param   n_read Pointer to integer into which the function stores the number of bytes read.
+  @param   flags Ignored.
+  @return  OSAL_SUCCESS, or OSAL_STATUS_STREAM_CLOSED if the other end has been closed and
+           there is no more data.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_loopback_read(
+    osalStream stream,
+    os_char *buf,
+    os_memsz n,
+    os_memsz *n_read,
+    os_int flags)
+{
+    iocLoopbackStream *thiso;
+    iocLoopbackMark *mark;
+    os_int count, due, left, wait_ms;
+    osalStatus s;
+    OSAL_UNUSED(flags);
+
+    *n_read = 0;
+    if (stream == OS_NULL) return OSAL_STATUS_FAILED;
+    thiso = (iocLoopbackStream*)stream;
+    osal_debug_assert(thiso->hdr.iface == &ioc_loopback_iface);
+
+    count = 0;
+    os_lock();
+    if (n > 0)
+    {
+        due = thiso->mark ? ioc_loopback_due_bytes(thiso, &wait_ms) : (os_int)n;
+        count = osal_ringbuf_get(&thiso->rx, buf, (os_int)(n < due ? n : due));
+
+        /* Remove read bytes from delay marks.
+         */
+        left = thiso->mark ? count : 0;
+        while (left > 0)
+        {
+            mark = thiso->mark + thiso->mark_head;
+            if (mark->nbytes > left)
+            {
+                mark->nbytes -= left;
+                break;
+            }
+            left -= mark->nbytes;
+            thiso->mark_head = (thiso->mark_head + 1) % IOC_LOOPBACK_MAX_MARKS;
+            thiso->mark_count--;
+        }
+
+        /* Writer may be waiting for space.
+         */
+        if (count && thiso->peer) ioc_loopback_trig(thiso->peer);
+    }
+    s = (count || (thiso->mark && thiso->mark_count)) ? OSAL_SUCCESS : thiso->status;
+    os_unlock();
+
+    *n_read = count;
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Wait for an event from loopback streams.
+  @anchor ioc_loopback_select
+
+  The ioc_loopback_select() function blocks until data is written to, read from or closed
+  by the other end of one of the streams, a connection is waiting for accept, custom
+  event is set, or delayed data becomes readable.
+
+  @param   streams Array of loopback streams to wait for.
+  @param   n_streams Number of streams in array.
+  @param   evnt Custom event to interrupt the select. OS_NULL if not needed.
+  @param   timeout_ms Maximum time to wait, ms, or OSAL_INFINITE (-1) to disable timeout.
+  @param   flags Ignored, set OSAL_STREAM_DEFAULT (0).
+  @return  OSAL_SUCCESS (0).
+
+****************************************************************************************************
+*/
+static osalStatus ioc_loopback_select(
+    osalStream *streams,
+    os_int nstreams,
+    osalEvent evnt,
+    os_int timeout_ms,
+    os_int flags)
+{
+    iocLoopbackStream *thiso;
+    os_int i, wait_ms;
+    OSAL_UNUSED(flags);
+
+    if (evnt == OS_NULL)
+    {
+        os_timeslice();
+        return OSAL_SUCCESS;
+    }
+
+    os_lock();
+    for (i = 0; i < nstreams; i++)
+    {
+        thiso = (iocLoopbackStream*)streams[i];
+        if (thiso == OS_NULL) continue;
+        osal_debug_assert(thiso->hdr.iface == &ioc_loopback_iface);
+        thiso->select_event = evnt;
+        if (thiso->trig_select)
+        {
+            thiso->trig_select = OS_FALSE;
+            osal_event_set(evnt);
+        }
+
+        /* Do not sleep past the time when delayed data becomes readable.
+         */
+        if (thiso->mark && thiso->mark_count)
+        {
+            ioc_loopback_due_bytes(thiso, &wait_ms);
+            if (wait_ms >= 0 && (timeout_ms < 0 || wait_ms < timeout_ms)) {
+                timeout_ms = wait_ms;
+            }
+        }
+    }
+    os_unlock();
+
+    osal_event_wait(evnt, timeout_ms);
+
+    os_lock();
+    for (i = 0; i < nstreams; i++)
+    {
+        thiso = (iocLoopbackStream*)streams[i];
+        if (thiso) thiso->select_event = OS_NULL;
+    }
+    os_unlock();
+
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set one way delay for loopback name.
+  @anchor ioc_set_loopback_delay
+
+  The ioc_set_loopback_delay() function sets delay for streams connected to the name after
+  this call, in both directions. Round trip time is twice the delay. Existing streams are
+  not affected.
+
+  @param   name Loopback name, like "bench".
+  @param   delay_ms One way delay in milliseconds, 0 to remove the delay.
+  @return  OSAL_SUCCESS if successful, OSAL_STATUS_FAILED if IOC_LOOPBACK_MAX_DELAYS names
+           already have delay.
+
+****************************************************************************************************
+*/
+osalStatus ioc_set_loopback_delay(
+    const os_char *name,
+    os_int delay_ms)
+{
+    iocLoopbackDelay *d, *free_d;
+    os_int i;
+
+    free_d = OS_NULL;
+    os_lock();
+    for (i = 0; i < IOC_LOOPBACK_MAX_DELAYS; i++)
+    {
+        d = ioc_loopback_delays + i;
+        if (d->name[0] == '\0')
+        {
+            if (free_d == OS_NULL) free_d = d;
+        }
+        else if (!os_strcmp(d->name, name))
+        {
+            break;
+        }
+    }
+    if (i == IOC_LOOPBACK_MAX_DELAYS)
+    {
+        d = free_d;
+        if (d) os_strncpy(d->name, name, IOC_LOOPBACK_NAME_SZ);
+    }
+    if (d)
+    {
+        d->delay_ms = delay_ms;
+        if (delay_ms == 0) d->name[0] = '\0';
+    }
+    os_unlock();
+
+    return (d || delay_ms == 0) ? OSAL_SUCCESS : OSAL_STATUS_FAILED;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Allocate and initialize loopback stream structure (internal).
+
+  Name is copied from parameters up to ':'. Connected streams get ring buffer.
+
+****************************************************************************************************
+*/
+static iocLoopbackStream *ioc_loopback_alloc(
+    const os_char *parameters,
+    os_boolean is_listener,
+    os_int flags)
+{
+    iocLoopbackStream *thiso;
+    os_memsz buf_sz;
+    os_int i;
+
+    thiso = (iocLoopbackStream*)os_malloc(sizeof(iocLoopbackStream), OS_NULL);
+    if (thiso == OS_NULL) return OS_NULL;
+    os_memclear(thiso, sizeof(iocLoopbackStream));
+
+    thiso->hdr.iface = &ioc_loopback_iface;
+    thiso->open_flags = flags;
+    thiso->is_listener = is_listener;
+
+    for (i = 0; parameters[i] != '\0' && parameters[i] != ':' &&
+         i < IOC_LOOPBACK_NAME_SZ - 1; i++)
+    {
+        thiso->name[i] = parameters[i];
+    }
+
+    if (!is_listener)
+    {
+        thiso->rx.buf = (os_char*)os_malloc(IOC_LOOPBACK_BUF_SZ, &buf_sz);
+        if (thiso->rx.buf == OS_NULL)
+        {
+            os_free(thiso, sizeof(iocLoopbackStream));
+            return OS_NULL;
+        }
+        thiso->rx.buf_sz = (os_int)buf_sz;
+
+        thiso->delay_ms = ioc_loopback_delay_for_name(thiso->name);
+        if (thiso->delay_ms)
+        {
+            thiso->mark = (iocLoopbackMark*)os_malloc(
+                IOC_LOOPBACK_MAX_MARKS * sizeof(iocLoopbackMark), OS_NULL);
+            if (thiso->mark == OS_NULL)
+            {
+                ioc_loopback_free(thiso);
+                return OS_NULL;
+            }
+        }
+    }
+    return thiso;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Free loopback stream structure (internal).
+
+****************************************************************************************************
+*/
+static void ioc_loopback_free(
+    iocLoopbackStream *thiso)
+{
+    if (thiso->rx.buf) os_free(thiso->rx.buf, thiso->rx.buf_sz);
+    if (thiso->mark) os_free(thiso->mark, IOC_LOOPBACK_MAX_MARKS * sizeof(iocLoopbackMark));
+    thiso->hdr.iface = OS_NULL;
+    os_free(thiso, sizeof(iocLoopbackStream));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Wake up select on the stream (internal).
+
+  Sets select event if select is ongoing, otherwise marks that next select returns
+  immediately. os_lock() must be on.
+
+****************************************************************************************************
+*/
+static void ioc_loopback_trig(
+    iocLoopbackStream *thiso)
+{
+    thiso->trig_select = OS_TRUE;
+    if (thiso->select_event)
+    {
+        thiso->trig_select = OS_FALSE;
+        osal_event_set(thiso->select_event);
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get delay set for loopback name (internal).
+
+****************************************************************************************************
+*/
+static os_int ioc_loopback_delay_for_name(
+    const os_char *name)
+{
+    os_int i, delay_ms;
+
+    delay_ms = 0;
+    os_lock();
+    for (i = 0; i < IOC_LOOPBACK_MAX_DELAYS; i++)
+    {
+        if (ioc_loopback_delays[i].name[0] != '\0' &&
+            !os_strcmp(ioc_loopback_delays[i].name, name))
+        {
+            delay_ms = ioc_loopback_delays[i].delay_ms;
+            break;
+        }
+    }
+    os_unlock();
+    return delay_ms;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get number of delayed bytes which can be read (internal).
+
+  Sums byte counts of the oldest marks whose delay has passed. os_lock() must be on.
+
+  @param   thiso Stream with delay.
+  @param   wait_ms Set to time until the next mark becomes readable, -1 if no more marks.
+  @return  Number of bytes which can be read.
+
+****************************************************************************************************
+*/
+static os_int ioc_loopback_due_bytes(
+    iocLoopbackStream *thiso,
+    os_int *wait_ms)
+{
+    iocLoopbackMark *mark;
+    os_timer now;
+    os_long elapsed;
+    os_int i, due;
+
+    os_get_timer(&now);
+    due = 0;
+    *wait_ms = -1;
+    for (i = 0; i < thiso->mark_count; i++)
+    {
+        mark = thiso->mark + (thiso->mark_head + i) % IOC_LOOPBACK_MAX_MARKS;
+        elapsed = os_get_ms_elapsed(&mark->t, &now);
+        if (elapsed < thiso->delay_ms)
+        {
+            *wait_ms = (os_int)(thiso->delay_ms - elapsed);
+            break;
+        }
+        due += mark->nbytes;
+    }
+    return due;
+}
+
+
+/** Stream interface for loopback streams. This is structure osalStreamInterface filled with
+    function pointers to loopback stream implementation.
+ */
+OS_CONST osalStreamInterface ioc_loopback_iface
+ = {OSAL_STREAM_IFLAG_NONE,
+    ioc_loopback_open,
+    ioc_loopback_close,
+    ioc_loopback_accept,
+    ioc_loopback_flush,
+    osal_stream_default_seek,
+    ioc_loopback_write,
+    ioc_loopback_read,
+    ioc_loopback_select,
+    OS_NULL,
+    OS_NULL};
+
+#endif
@@ -0,0 +1,72 @@
+/**
+
+  @file    ioc_loopback_stream.h
+  @brief   In-process loopback stream.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Loopback stream implements OSAL stream API for connections within one process. It can be
+  used with ioc_listen() and ioc_connect() like socket stream, for example to run two iocom
+  roots against each other in one process for testing and performance measurement without
+  network stack. Flags IOC_SOCKET should be used, so connections have socket frame size
+  and handshake.
+
+  Address is a name, like "bench". Port number, if any, is ignored: ioc_listen() appends
+  default port to parameter string and "bench:6368" matches "bench". Each connected
+  stream pair has two ring buffers of IOC_LOOPBACK_BUF_SZ bytes.
+
+  One way delay can be set for a loopback name by ioc_set_loopback_delay(), to measure
+  behaviour on links with long round trip time. Data written becomes readable at the other
+  end only after the delay.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_LOOPBACK_STREAM_H_
+#define IOC_LOOPBACK_STREAM_H_
+#include "iocom.h"
+
+#if IOC_LOOPBACK_SUPPORT
+
+/* Ring buffer size for each direction of connected stream, bytes.
+ */
+#ifndef IOC_LOOPBACK_BUF_SZ
+#define IOC_LOOPBACK_BUF_SZ 16384
+#endif
+
+/* Maximum loopback name length, including terminating '\0'.
+ */
+#define IOC_LOOPBACK_NAME_SZ 32
+
+/* Maximum number of loopback names with delay set.
+ */
+#define IOC_LOOPBACK_MAX_DELAYS 4
+
+/* Maximum number of delayed writes waiting in one direction. Writes beyond this wait.
+ */
+#define IOC_LOOPBACK_MAX_MARKS 64
+
+/** Stream interface structure for loopback streams.
+ */
+extern OS_CONST_H osalStreamInterface ioc_loopback_iface;
+
+/** Define to get loopback interface pointer.
+ */
+#define IOC_LOOPBACK_IFACE &ioc_loopback_iface
+
+/* Set one way delay for loopback streams connected to given name.
+ */
+osalStatus ioc_set_loopback_delay(
+    const os_char *name,
+    os_int delay_ms);
+
+#else
+#define IOC_LOOPBACK_IFACE OS_NULL
+#endif
+#endif
@@ -0,0 +1,528 @@
+/**
+
+  @file    ioc_mbinfo_resume.c
+  @brief   Skip memory block information exchange on reconnect.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Memory block information digest, cache of received memory block information and resume
+  reply frame, see ioc_mbinfo_resume.h.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_MBINFO_RESUME
+
+/* Forward referred static functions.
+ */
+static iocMbinfoCacheEntry *ioc_get_mbinfo_cache_entry(
+    iocRoot *root,
+    os_uint digest,
+    const os_char *network_name);
+
+static void ioc_release_mbinfo_cache_entry(
+    iocRoot *root,
+    iocMbinfoCacheEntry *entry);
+
+static os_uint ioc_mbinfo_digest_str(
+    os_uint digest,
+    const os_char *str);
+
+
+/**
+****************************************************************************************************
+
+  @brief Release memory block information cache.
+  @anchor ioc_release_mbinfo_cache
+
+  The ioc_release_mbinfo_cache() function frees all cache entries. Called when root is
+  released, after connections have been released.
+
+  @param   root Pointer to the root object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_mbinfo_cache(
+    iocRoot *root)
+{
+    while (root->mbinfo_cache.first)
+    {
+        ioc_release_mbinfo_cache_entry(root, root->mbinfo_cache.first);
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add memory block information item to digest.
+  @anchor ioc_mbinfo_digest
+
+  The ioc_mbinfo_digest() function calculates FNV-1a hash over memory block information
+  fields as they are transferred in memory block information frame. Both ends must
+  calculate the same digest from the same information, thus local flags are not included.
+
+  @param   digest Digest so far, IOC_MBINFO_DIGEST_INIT for the first item.
+  @param   info Memory block information item.
+  @return  Updated digest.
+
+****************************************************************************************************
+*/
+os_uint ioc_mbinfo_digest(
+    os_uint digest,
+    const iocMemoryBlockInfo *info)
+{
+    os_uint v[4];
+    os_int i, j;
+
+    v[0] = info->mblk_id;
+    v[1] = info->device_nr;
+    v[2] = info->nbytes;
+    v[3] = info->flags;
+
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            digest ^= (os_uchar)(v[i] >> (8 * j));
+            digest *= 16777619U;
+        }
+    }
+    digest = ioc_mbinfo_digest_str(digest, info->device_name);
+    digest = ioc_mbinfo_digest_str(digest, info->network_name);
+    return ioc_mbinfo_digest_str(digest, info->mblk_name);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Connecting end: Start resume.
+  @anchor ioc_mbinfo_resume_start
+
+  The ioc_mbinfo_resume_start() function is called by connecting (IOC_CONNECT_UP) end when
+  authentication message has been received. If the other end supports resume, the function
+  calculates digest of memory block information to send. The digest is sent in this end's
+  authentication message, and memory block information is not sent until reply is received.
+
+  @param   con Pointer to the connection object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mbinfo_resume_start(
+    iocConnection *con)
+{
+    con->resume.state = IOC_RESUME_IDLE;
+    con->resume.digest = 0;
+
+    if ((con->flags & IOC_CONNECT_UP) == 0 ||
+        (con->peer_features & IOC_AUTH_FEATURE_MBINFO_RESUME) == 0)
+    {
+        return;
+    }
+
+    con->resume.digest = ioc_mbinfo_layout_digest(con);
+    if (con->resume.digest) {
+        con->resume.state = IOC_RESUME_WAIT_REPLY;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Other end: Resume requested.
+  @anchor ioc_mbinfo_resume_requested
+
+  The ioc_mbinfo_resume_requested() function is called when authentication message with
+  memory block information digest has been received from connecting end, and the
+  authentication has been accepted. If matching information is in cache, it is processed
+  now as if it was received. Otherwise memory block information received next is stored
+  in cache. Either way a reply is sent.
+
+  @param   con Pointer to the connection object.
+  @param   digest Digest received in authentication message.
+  @param   network_name Network name received in authentication message.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mbinfo_resume_requested(
+    iocConnection *con,
+    os_uint digest,
+    const os_char *network_name)
+{
+    iocRoot *root;
+    iocMbinfoCacheEntry *entry;
+    iocMemoryBlockInfo info;
+    os_int i;
+
+    ioc_mbinfo_resume_con_closed(con);
+    if (digest == 0 || (con->flags & IOC_CONNECT_UP)) return;
+    root = con->link.root;
+    con->resume.digest = digest;
+
+    entry = ioc_get_mbinfo_cache_entry(root, digest, network_name);
+    if (entry == OS_NULL)
+    {
+        con->resume.state = IOC_RESUME_DECLINE;
+        return;
+    }
+    os_get_timer(&entry->last_used);
+
+    if (entry->complete)
+    {
+        for (i = 0; i < entry->n; i++)
+        {
+            info = entry->items[i];
+            ioc_mbinfo_assign_device_nr(con, &info);
+            ioc_mbinfo_received(con, &info);
+        }
+        con->resume.state = IOC_RESUME_ACCEPT;
+        root->mbinfo_cache.hits++;
+        osal_trace2_int("Memory block information from cache, items ", entry->n);
+        return;
+    }
+
+    /* Not in cache: Store information received from this connection. If another
+       connection is already collecting the same layout, let it finish.
+     */
+    if (entry->collecting == OS_NULL)
+    {
+        entry->collecting = con;
+        entry->running_digest = IOC_MBINFO_DIGEST_INIT;
+        entry->n = 0;
+        con->resume.collect = entry;
+    }
+    con->resume.state = IOC_RESUME_DECLINE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Other end: Store received memory block information to cache.
+  @anchor ioc_mbinfo_resume_collect
+
+  The ioc_mbinfo_resume_collect() function is called for each received memory block
+  information frame, before automatic device number is assigned. If the connection is
+  collecting, the item is appended to cache entry. Once digest of stored items matches
+  the digest announced, the entry is complete.
+
+  @param   con Pointer to the connection object.
+  @param   info Received memory block information.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mbinfo_resume_collect(
+    iocConnection *con,
+    const iocMemoryBlockInfo *info)
+{
+    iocRoot *root;
+    iocMbinfoCacheEntry *entry;
+    iocMemoryBlockInfo *items;
+    os_int alloc;
+
+    entry = con->resume.collect;
+    if (entry == OS_NULL) return;
+    root = con->link.root;
+
+    if (entry->n >= entry->alloc)
+    {
+        alloc = entry->alloc ? 2 * entry->alloc : 8;
+        if (alloc > IOC_MBINFO_CACHE_MAX_ITEMS) goto giveup;
+        items = (iocMemoryBlockInfo*)ioc_malloc(root, alloc * sizeof(iocMemoryBlockInfo),
+            OS_NULL, IOC_DEFAULT_ALLOC);
+        if (items == OS_NULL) goto giveup;
+        if (entry->items)
+        {
+            os_memcpy(items, entry->items, entry->n * sizeof(iocMemoryBlockInfo));
+            ioc_free(root, entry->items, entry->alloc * sizeof(iocMemoryBlockInfo),
+                IOC_DEFAULT_ALLOC);
+        }
+        entry->items = items;
+        entry->alloc = alloc;
+    }
+
+    entry->items[entry->n] = *info;
+    entry->items[entry->n].local_flags = 0;
+    entry->n++;
+    entry->running_digest = ioc_mbinfo_digest(entry->running_digest, info);
+
+    if (entry->running_digest == entry->digest)
+    {
+        entry->complete = OS_TRUE;
+        entry->collecting = OS_NULL;
+        con->resume.collect = OS_NULL;
+        osal_trace2_int("Memory block information cached, items ", entry->n);
+    }
+    return;
+
+giveup:
+    con->resume.collect = OS_NULL;
+    ioc_release_mbinfo_cache_entry(root, entry);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Make resume reply frame.
+  @anchor ioc_make_mbinfo_resume_frame
+
+  The ioc_make_mbinfo_resume_frame() function sends reply to digest received in
+  authentication message, if one is to be sent. The reply frame contains accepted
+  flag and the digest.
+
+  @param   con Pointer to the connection object.
+  @return  OSAL_COMPLETED if there is no reply to send, OSAL_SUCCESS if reply was placed
+           in outgoing frame buffer and OSAL_PENDING if transmission is blocked by flow control.
+
+****************************************************************************************************
+*/
+osalStatus ioc_make_mbinfo_resume_frame(
+    iocConnection *con)
+{
+    iocSendHeaderPtrs ptrs;
+    os_uchar *p, *start;
+    os_uint digest;
+
+    if (con->resume.state != IOC_RESUME_ACCEPT &&
+        con->resume.state != IOC_RESUME_DECLINE)
+    {
+        return OSAL_COMPLETED;
+    }
+
+    ioc_generate_header(con, con->frame_out.buf, &ptrs, 0, 0, 0);
+    p = start = (os_uchar*)con->frame_out.buf + ptrs.header_sz;
+    *(p++) = IOC_MBINFO_RESUME_REPLY;
+    *(p++) = (os_uchar)(con->resume.state == IOC_RESUME_ACCEPT);
+    digest = con->resume.digest;
+    *(p++) = (os_uchar)digest;
+    *(p++) = (os_uchar)(digest >> 8);
+    *(p++) = (os_uchar)(digest >> 16);
+    *(p++) = (os_uchar)(digest >> 24);
+
+    if (ioc_finish_frame(con, &ptrs, start, p))
+    {
+        return OSAL_PENDING;
+    }
+
+    con->resume.state = IOC_RESUME_IDLE;
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Process received resume reply frame.
+  @anchor ioc_process_received_mbinfo_resume_frame
+
+  The ioc_process_received_mbinfo_resume_frame() function is called by connecting end when
+  reply to digest has been received. If the other end accepted the digest and memory blocks
+  have not changed since digest was calculated, memory block information is not sent.
+  Otherwise all memory block information is sent as usual (the other end ignores
+  duplicates).
+
+  @param   con Pointer to the connection object.
+  @param   data Received data.
+  @param   data_sz Received data size in bytes.
+  @return  OSAL_SUCCESS if successfull. Other values indicate a corrupted frame.
+
+****************************************************************************************************
+*/
+osalStatus ioc_process_received_mbinfo_resume_frame(
+    iocConnection *con,
+    os_char *data,
+    os_int data_sz)
+{
+    os_uchar *p;
+    os_uint digest;
+    os_boolean accepted;
+
+    if (data_sz < 6) return OSAL_STATUS_FAILED;
+    if (con->resume.state != IOC_RESUME_WAIT_REPLY) return OSAL_SUCCESS;
+
+    p = (os_uchar*)data + 1; /* Skip system frame IOC_MBINFO_RESUME_REPLY byte. */
+    accepted = (os_boolean)(*(p++) != 0);
+    digest = (os_uint)p[0] | ((os_uint)p[1] << 8) | ((os_uint)p[2] << 16) | ((os_uint)p[3] << 24);
+    con->resume.state = IOC_RESUME_IDLE;
+
+    if (accepted && digest == con->resume.digest &&
+        digest == ioc_mbinfo_layout_digest(con))
+    {
+        con->sinfo.current_mblk = OS_NULL;
+        osal_trace2("Memory block information exchange skipped");
+    }
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Connection closed or reset.
+  @anchor ioc_mbinfo_resume_con_closed
+
+  The ioc_mbinfo_resume_con_closed() function resets resume state of the connection. If
+  the connection was storing received memory block information to cache, the incomplete
+  cache entry is released.
+
+  @param   con Pointer to the connection object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mbinfo_resume_con_closed(
+    iocConnection *con)
+{
+    iocMbinfoCacheEntry *entry;
+
+    entry = con->resume.collect;
+    if (entry)
+    {
+        con->resume.collect = OS_NULL;
+        ioc_release_mbinfo_cache_entry(con->link.root, entry);
+    }
+    con->resume.state = IOC_RESUME_IDLE;
+    con->resume.digest = 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find or allocate cache entry (internal).
+
+  If cache is full, the least recently used entry which is not being collected is released.
+
+  @param   root Pointer to the root object.
+  @param   digest Memory block information digest.
+  @param   network_name Network name.
+  @return  Pointer to cache entry, OS_NULL if memory allocation failed.
+
+****************************************************************************************************
+*/
+static iocMbinfoCacheEntry *ioc_get_mbinfo_cache_entry(
+    iocRoot *root,
+    os_uint digest,
+    const os_char *network_name)
+{
+    iocMbinfoCacheEntry *entry, *oldest;
+
+    oldest = OS_NULL;
+    for (entry = root->mbinfo_cache.first; entry; entry = entry->next)
+    {
+        if (entry->digest == digest && !os_strcmp(entry->network_name, network_name))
+        {
+            return entry;
+        }
+        if (entry->collecting == OS_NULL)
+        {
+            if (oldest == OS_NULL ||
+                os_get_ms_elapsed(&entry->last_used, &oldest->last_used) > 0)
+            {
+                oldest = entry;
+            }
+        }
+    }
+
+    if (root->mbinfo_cache.count >= IOC_MBINFO_CACHE_SZ)
+    {
+        if (oldest == OS_NULL) return OS_NULL;
+        ioc_release_mbinfo_cache_entry(root, oldest);
+    }
+
+    entry = (iocMbinfoCacheEntry*)ioc_malloc(root, sizeof(iocMbinfoCacheEntry),
+        OS_NULL, IOC_DEFAULT_ALLOC);
+    if (entry == OS_NULL) return OS_NULL;
+    os_memclear(entry, sizeof(iocMbinfoCacheEntry));
+    entry->digest = digest;
+    os_strncpy(entry->network_name, network_name, IOC_NETWORK_NAME_SZ);
+    os_get_timer(&entry->last_used);
+
+    entry->next = root->mbinfo_cache.first;
+    root->mbinfo_cache.first = entry;
+    root->mbinfo_cache.count++;
+    return entry;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remove entry from cache and free it (internal).
+
+  @param   root Pointer to the root object.
+  @param   entry Pointer to cache entry.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_release_mbinfo_cache_entry(
+    iocRoot *root,
+    iocMbinfoCacheEntry *entry)
+{
+    iocMbinfoCacheEntry **pe;
+
+    for (pe = &root->mbinfo_cache.first; *pe; pe = &(*pe)->next)
+    {
+        if (*pe == entry)
+        {
+            *pe = entry->next;
+            root->mbinfo_cache.count--;
+            break;
+        }
+    }
+
+    if (entry->collecting) {
+        entry->collecting->resume.collect = OS_NULL;
+    }
+    if (entry->items)
+    {
+        ioc_free(root, entry->items, entry->alloc * sizeof(iocMemoryBlockInfo),
+            IOC_DEFAULT_ALLOC);
+    }
+    ioc_free(root, entry, sizeof(iocMbinfoCacheEntry), IOC_DEFAULT_ALLOC);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add string to digest (internal).
+
+  @param   digest Digest so far.
+  @param   str String, terminating '\0' is included.
+  @return  Updated digest.
+
+****************************************************************************************************
+*/
+static os_uint ioc_mbinfo_digest_str(
+    os_uint digest,
+    const os_char *str)
+{
+    const os_uchar *p;
+
+    p = (const os_uchar*)str;
+    do
+    {
+        digest ^= *p;
+        digest *= 16777619U;
+    }
+    while (*(p++));
+
+    return digest;
+}
+
+#endif
@@ -0,0 +1,208 @@
+/**
+
+  @file    ioc_mbinfo_resume.h
+  @brief   Skip memory block information exchange on reconnect.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  When a device connects upwards, it sends memory block information for all its memory blocks
+  and the other end creates source and target buffers one memory block at a time. For a device
+  with unstable link, this burst on every reconnect is most of the traffic.
+
+  The connecting (IOC_CONNECT_UP) end calculates digest of the memory block information it is
+  about to send, and sends it in authentication message if the other end told that it
+  supports IOC_AUTH_FEATURE_MBINFO_RESUME. The other end keeps a cache of memory block
+  information received on earlier connections, keyed by digest and network name. If the
+  digest is found, the cached information is processed as if it had been received and the
+  reply tells the device to skip sending it. Otherwise the reply declines and the information
+  received next is stored in cache, the entry becomes valid once digest of stored information
+  matches the digest announced.
+
+  Only memory block information is skipped. Data of every memory block is still sent as key
+  frame after reconnect, since neither end knows which changes reached the other end before
+  the link broke.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_MBINFO_RESUME_H_
+#define IOC_MBINFO_RESUME_H_
+#include "iocom.h"
+
+#if IOC_MBINFO_RESUME
+
+struct iocRoot;
+struct iocConnection;
+
+/* Maximum number of cached memory block layouts.
+ */
+#ifndef IOC_MBINFO_CACHE_SZ
+#define IOC_MBINFO_CACHE_SZ 64
+#endif
+
+/* Largest number of memory block information items to cache per layout. Larger layouts
+   are sent every time.
+ */
+#ifndef IOC_MBINFO_CACHE_MAX_ITEMS
+#define IOC_MBINFO_CACHE_MAX_ITEMS 256
+#endif
+
+/* Initial value for memory block information digest.
+ */
+#define IOC_MBINFO_DIGEST_INIT 2166136261U
+
+/* Resume state of a connection.
+ */
+#define IOC_RESUME_IDLE 0
+#define IOC_RESUME_WAIT_REPLY 1     /* Connecting end: Digest sent, waiting for reply. */
+#define IOC_RESUME_ACCEPT 2         /* Other end: Cached information used, reply to send. */
+#define IOC_RESUME_DECLINE 3        /* Other end: Not in cache, reply to send. */
+
+
+/**
+****************************************************************************************************
+    Cached memory block information received on earlier connection.
+****************************************************************************************************
+*/
+typedef struct iocMbinfoCacheEntry
+{
+    /** Next entry in root's cache.
+     */
+    struct iocMbinfoCacheEntry *next;
+
+    /** Digest of memory block information and network name given in authentication message.
+     */
+    os_uint digest;
+    os_char network_name[IOC_NETWORK_NAME_SZ];
+
+    /** Connection which is currently storing received information to this entry, OS_NULL
+        if none.
+     */
+    struct iocConnection *collecting;
+
+    /** Digest of the information stored so far, matches digest when complete.
+     */
+    os_uint running_digest;
+
+    /** Entry is complete and can be used.
+     */
+    os_boolean complete;
+
+    /** Cached memory block information items, number of items and allocated items.
+     */
+    iocMemoryBlockInfo *items;
+    os_int n;
+    os_int alloc;
+
+    /** Timer when entry was last used, oldest entry is dropped when cache is full.
+     */
+    os_timer last_used;
+}
+iocMbinfoCacheEntry;
+
+
+/**
+****************************************************************************************************
+    Memory block information cache, member of iocRoot.
+****************************************************************************************************
+*/
+typedef struct iocMbinfoCache
+{
+    iocMbinfoCacheEntry *first;
+    os_int count;
+
+    /** Number of connections which used cached information instead of exchanging it,
+        for diagnostics and tests.
+     */
+    os_uint hits;
+}
+iocMbinfoCache;
+
+
+/**
+****************************************************************************************************
+    Resume state within a connection.
+****************************************************************************************************
+*/
+typedef struct iocMbinfoResumeState
+{
+    /** Resume state, IOC_RESUME_IDLE, IOC_RESUME_WAIT_REPLY, IOC_RESUME_ACCEPT or
+        IOC_RESUME_DECLINE.
+     */
+    os_char state;
+
+    /** Digest sent (connecting end) or received (other end) in authentication message.
+        Zero if none.
+     */
+    os_uint digest;
+
+    /** Other end: Cache entry to which received memory block information is stored.
+     */
+    iocMbinfoCacheEntry *collect;
+}
+iocMbinfoResumeState;
+
+
+/**
+****************************************************************************************************
+  Memory block information resume functions, ioc_lock() must be on when calling these.
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Release memory block information cache.
+ */
+void ioc_release_mbinfo_cache(
+    struct iocRoot *root);
+
+/* Add memory block information item to digest.
+ */
+os_uint ioc_mbinfo_digest(
+    os_uint digest,
+    const iocMemoryBlockInfo *info);
+
+/* Connecting end: Calculate digest of memory block information to send.
+ */
+void ioc_mbinfo_resume_start(
+    struct iocConnection *con);
+
+/* Other end: Digest received in authentication message, use cache or start collecting.
+ */
+void ioc_mbinfo_resume_requested(
+    struct iocConnection *con,
+    os_uint digest,
+    const os_char *network_name);
+
+/* Other end: Store received memory block information to cache entry being collected.
+ */
+void ioc_mbinfo_resume_collect(
+    struct iocConnection *con,
+    const iocMemoryBlockInfo *info);
+
+/* Make resume reply frame, if one is to be sent.
+ */
+osalStatus ioc_make_mbinfo_resume_frame(
+    struct iocConnection *con);
+
+/* Process received resume reply frame.
+ */
+osalStatus ioc_process_received_mbinfo_resume_frame(
+    struct iocConnection *con,
+    os_char *data,
+    os_int data_sz);
+
+/* Connection closed or reset, stop collecting.
+ */
+void ioc_mbinfo_resume_con_closed(
+    struct iocConnection *con);
+
+/*@}*/
+
+#endif
+#endif
@@ -0,0 +1,550 @@
+/**
+
+  @file    ioc_mblk_index.c
+  @brief   Hash index of root's memory blocks.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Find memory blocks by names or by unique identifier without scanning root's memory block
+  list, see ioc_mblk_index.h.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_MBLK_INDEX
+
+/* Forward referred static functions.
+ */
+static os_uint ioc_mblk_type_hash(
+    const os_char *network_name,
+    const os_char *device_name,
+    const os_char *mblk_name);
+
+static os_uint ioc_mblk_name_hash(
+    os_uint type_hash,
+    os_uint device_nr);
+
+static void ioc_mblk_index_link(
+    iocMblkIndex *ix,
+    iocMemoryBlock *mblk);
+
+static osalStatus ioc_mblk_index_rebuild(
+    iocRoot *root,
+    os_int hash_sz);
+
+
+/**
+****************************************************************************************************
+
+  @brief Release memory block index.
+  @anchor ioc_release_mblk_index
+
+  The ioc_release_mblk_index() function frees hash tables. Called when root is released.
+
+  @param   root Pointer to the root object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_mblk_index(
+    iocRoot *root)
+{
+    iocMblkIndex *ix;
+
+    ix = &root->mblk_index;
+    if (ix->name_hash)
+    {
+        ioc_free(root, ix->name_hash, 3 * ix->hash_sz * sizeof(iocMemoryBlock*),
+            IOC_DEFAULT_ALLOC);
+    }
+    os_memclear(ix, sizeof(iocMblkIndex));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add memory block to index.
+  @anchor ioc_mblk_index_add
+
+  The ioc_mblk_index_add() function is called when memory block has been joined to root's
+  memory block list, and again if memory block's network name is changed. If there are more
+  memory blocks than hash table slots, hash tables are doubled.
+
+  @param   root Pointer to the root object.
+  @param   mblk Pointer to memory block, names and mblk_id must be set.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mblk_index_add(
+    iocRoot *root,
+    iocMemoryBlock *mblk)
+{
+    iocMblkIndex *ix;
+
+    ix = &root->mblk_index;
+    if (ix->count >= ix->hash_sz)
+    {
+        /* Rebuilding indexes all memory blocks in root's list, including this one.
+         */
+        if (ioc_mblk_index_rebuild(root, ix->hash_sz
+            ? 2 * ix->hash_sz : IOC_MBLK_INDEX_INITIAL_SZ) == OSAL_SUCCESS)
+        {
+            return;
+        }
+    }
+
+    if (ix->name_hash) {
+        ioc_mblk_index_link(ix, mblk);
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remove memory block from index.
+  @anchor ioc_mblk_index_remove
+
+  The ioc_mblk_index_remove() function is called when memory block is being released, or
+  before changing memory block's network name.
+
+  @param   root Pointer to the root object.
+  @param   mblk Pointer to memory block.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mblk_index_remove(
+    iocRoot *root,
+    iocMemoryBlock *mblk)
+{
+    iocMblkIndex *ix;
+    iocMemoryBlock **pm;
+    os_uint mask, h;
+
+    ix = &root->mblk_index;
+    if (ix->name_hash == OS_NULL) return;
+    mask = (os_uint)ix->hash_sz - 1;
+
+    h = ioc_mblk_type_hash(mblk->network_name, mblk->device_name, mblk->mblk_name);
+    for (pm = ix->name_hash + (ioc_mblk_name_hash(h, mblk->device_nr) & mask);
+         *pm;
+         pm = &(*pm)->link.name_next)
+    {
+        if (*pm == mblk) {
+            *pm = mblk->link.name_next;
+            break;
+        }
+    }
+
+    if (mblk->link.type_prev) {
+        mblk->link.type_prev->link.type_next = mblk->link.type_next;
+    }
+    else {
+        ix->type_hash[h & mask] = mblk->link.type_next;
+    }
+    if (mblk->link.type_next) {
+        mblk->link.type_next->link.type_prev = mblk->link.type_prev;
+    }
+
+    for (pm = ix->id_hash + (mblk->mblk_id & mask);
+         *pm;
+         pm = &(*pm)->link.id_next)
+    {
+        if (*pm == mblk) {
+            *pm = mblk->link.id_next;
+            break;
+        }
+    }
+
+    mblk->link.name_next = mblk->link.type_next = mblk->link.type_prev
+        = mblk->link.id_next = OS_NULL;
+    ix->count--;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find memory block by names.
+  @anchor ioc_mblk_index_find
+
+  The ioc_mblk_index_find() function finds memory block matching exactly to network name,
+  device name, device number and memory block name.
+
+  @param   root Pointer to the root object.
+  @param   network_name Network name.
+  @param   device_name Device name.
+  @param   device_nr Device number.
+  @param   mblk_name Memory block name.
+  @return  Pointer to memory block, OS_NULL if not found.
+
+****************************************************************************************************
+*/
+iocMemoryBlock *ioc_mblk_index_find(
+    iocRoot *root,
+    const os_char *network_name,
+    const os_char *device_name,
+    os_uint device_nr,
+    const os_char *mblk_name)
+{
+    iocMblkIndex *ix;
+    iocMemoryBlock *mblk;
+    os_uint h;
+
+    ix = &root->mblk_index;
+    if (ix->name_hash)
+    {
+        h = ioc_mblk_name_hash(ioc_mblk_type_hash(network_name, device_name, mblk_name),
+            device_nr);
+        mblk = ix->name_hash[h & ((os_uint)ix->hash_sz - 1)];
+    }
+    else
+    {
+        mblk = root->mblk.first;
+    }
+
+    while (mblk)
+    {
+        if (mblk->device_nr == device_nr &&
+            !os_strcmp(mblk->mblk_name, mblk_name) &&
+            !os_strcmp(mblk->device_name, device_name) &&
+            !os_strcmp(mblk->network_name, network_name))
+        {
+            return mblk;
+        }
+        mblk = ix->name_hash ? mblk->link.name_next : mblk->link.next;
+    }
+    return OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find memory block by names, any device number.
+  @anchor ioc_mblk_index_find_type
+
+  The ioc_mblk_index_find_type() function finds memory blocks with given network name,
+  device name and memory block name, regardless of device number. For example the
+  "data" memory blocks of "accounts" device within a network.
+
+  @param   root Pointer to the root object.
+  @param   prev_mblk OS_NULL to find first match, or previous match to find next one.
+  @param   network_name Network name.
+  @param   device_name Device name.
+  @param   mblk_name Memory block name.
+  @return  Pointer to memory block, OS_NULL if no (more) matches.
+
+****************************************************************************************************
+*/
+iocMemoryBlock *ioc_mblk_index_find_type(
+    iocRoot *root,
+    iocMemoryBlock *prev_mblk,
+    const os_char *network_name,
+    const os_char *device_name,
+    const os_char *mblk_name)
+{
+    iocMblkIndex *ix;
+    iocMemoryBlock *mblk;
+
+    ix = &root->mblk_index;
+    if (prev_mblk)
+    {
+        mblk = ix->name_hash ? prev_mblk->link.type_next : prev_mblk->link.next;
+    }
+    else if (ix->name_hash)
+    {
+        mblk = ix->type_hash[ioc_mblk_type_hash(network_name, device_name, mblk_name)
+            & ((os_uint)ix->hash_sz - 1)];
+    }
+    else
+    {
+        mblk = root->mblk.first;
+    }
+
+    while (mblk)
+    {
+        if (!os_strcmp(mblk->mblk_name, mblk_name) &&
+            !os_strcmp(mblk->device_name, device_name) &&
+            !os_strcmp(mblk->network_name, network_name))
+        {
+            return mblk;
+        }
+        mblk = ix->name_hash ? mblk->link.type_next : mblk->link.next;
+    }
+    return OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find memory block by identifier.
+  @anchor ioc_mblk_index_find_by_id
+
+  @param   root Pointer to the root object.
+  @param   mblk_id Unique memory block identifier.
+  @return  Pointer to memory block, OS_NULL if not found.
+
+****************************************************************************************************
+*/
+iocMemoryBlock *ioc_mblk_index_find_by_id(
+    iocRoot *root,
+    os_uint mblk_id)
+{
+    iocMblkIndex *ix;
+    iocMemoryBlock *mblk;
+
+    ix = &root->mblk_index;
+    if (ix->name_hash)
+    {
+        for (mblk = ix->id_hash[mblk_id & ((os_uint)ix->hash_sz - 1)];
+             mblk;
+             mblk = mblk->link.id_next)
+        {
+            if (mblk->mblk_id == mblk_id) return mblk;
+        }
+        return OS_NULL;
+    }
+
+    for (mblk = root->mblk.first; mblk; mblk = mblk->link.next)
+    {
+        if (mblk->mblk_id == mblk_id) return mblk;
+    }
+    return OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remember released memory block identifier.
+  @anchor ioc_mblk_index_free_id
+
+  The ioc_mblk_index_free_id() function stores identifier of a released memory block in
+  ring buffer. If the ring buffer is full, the oldest identifier is forgotten.
+
+  @param   root Pointer to the root object.
+  @param   mblk_id Identifier of released memory block.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mblk_index_free_id(
+    iocRoot *root,
+    os_uint mblk_id)
+{
+    iocMblkIndex *ix;
+    os_int i;
+
+    ix = &root->mblk_index;
+    if (mblk_id < IOC_MIN_UNIQUE_ID) return;
+
+    i = ix->free_id_head + ix->free_id_count;
+    if (i >= IOC_MBLK_FREE_ID_SZ) i -= IOC_MBLK_FREE_ID_SZ;
+    ix->free_id[i] = mblk_id;
+
+    if (ix->free_id_count < IOC_MBLK_FREE_ID_SZ)
+    {
+        ix->free_id_count++;
+    }
+    else if (++(ix->free_id_head) >= IOC_MBLK_FREE_ID_SZ)
+    {
+        ix->free_id_head = 0;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get released memory block identifier for reuse.
+  @anchor ioc_mblk_index_reuse_id
+
+  The ioc_mblk_index_reuse_id() function returns the oldest remembered identifier of a
+  released memory block, which is not taken by another memory block since. Identifiers
+  are reused only when unique identifiers have run out, so that the other end of a
+  connection doesn't confuse a new memory block with recently deleted one.
+
+  @param   root Pointer to the root object.
+  @return  Memory block identifier, 0 if none available.
+
+****************************************************************************************************
+*/
+os_uint ioc_mblk_index_reuse_id(
+    iocRoot *root)
+{
+    iocMblkIndex *ix;
+    os_uint mblk_id;
+
+    ix = &root->mblk_index;
+    while (ix->free_id_count > 0)
+    {
+        mblk_id = ix->free_id[ix->free_id_head];
+        if (++(ix->free_id_head) >= IOC_MBLK_FREE_ID_SZ) ix->free_id_head = 0;
+        ix->free_id_count--;
+
+        if (ioc_mblk_index_find_by_id(root, mblk_id) == OS_NULL) {
+            return mblk_id;
+        }
+    }
+    return 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Calculate hash from network, device and memory block names (internal).
+
+  FNV-1a hash over the three names, separated by '\0'.
+
+  @return  Hash value.
+
+****************************************************************************************************
+*/
+static os_uint ioc_mblk_type_hash(
+    const os_char *network_name,
+    const os_char *device_name,
+    const os_char *mblk_name)
+{
+    const os_char *names[3];
+    const os_uchar *p;
+    os_uint h;
+    os_int i;
+
+    names[0] = network_name;
+    names[1] = device_name;
+    names[2] = mblk_name;
+
+    h = 2166136261U;
+    for (i = 0; i < 3; i++)
+    {
+        for (p = (const os_uchar*)names[i]; *p; p++)
+        {
+            h ^= *p;
+            h *= 16777619U;
+        }
+        h *= 16777619U;
+    }
+    return h;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add device number to hash (internal).
+
+  @param   type_hash Hash from ioc_mblk_type_hash().
+  @param   device_nr Device number.
+  @return  Hash value.
+
+****************************************************************************************************
+*/
+static os_uint ioc_mblk_name_hash(
+    os_uint type_hash,
+    os_uint device_nr)
+{
+    os_uint h;
+
+    h = (type_hash ^ device_nr) * 16777619U;
+    return h ^ (h >> 15);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Join memory block to hash chains (internal).
+
+  @param   ix Pointer to memory block index, hash tables must be allocated.
+  @param   mblk Pointer to memory block.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_mblk_index_link(
+    iocMblkIndex *ix,
+    iocMemoryBlock *mblk)
+{
+    iocMemoryBlock **pm;
+    os_uint mask, h;
+
+    mask = (os_uint)ix->hash_sz - 1;
+    h = ioc_mblk_type_hash(mblk->network_name, mblk->device_name, mblk->mblk_name);
+
+    pm = ix->name_hash + (ioc_mblk_name_hash(h, mblk->device_nr) & mask);
+    mblk->link.name_next = *pm;
+    *pm = mblk;
+
+    pm = ix->type_hash + (h & mask);
+    mblk->link.type_prev = OS_NULL;
+    mblk->link.type_next = *pm;
+    if (*pm) (*pm)->link.type_prev = mblk;
+    *pm = mblk;
+
+    pm = ix->id_hash + (mblk->mblk_id & mask);
+    mblk->link.id_next = *pm;
+    *pm = mblk;
+
+    ix->count++;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Allocate new hash tables and index all root's memory blocks (internal).
+
+  If memory allocation fails, the current hash tables are kept.
+
+  @param   root Pointer to the root object.
+  @param   hash_sz New hash table size, power of two.
+  @return  OSAL_SUCCESS if all memory blocks were indexed in new hash tables,
+           OSAL_STATUS_MEMORY_ALLOCATION_FAILED if not.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_mblk_index_rebuild(
+    iocRoot *root,
+    os_int hash_sz)
+{
+    iocMblkIndex *ix;
+    iocMemoryBlock **tables, *mblk;
+    os_memsz sz;
+
+    ix = &root->mblk_index;
+    sz = 3 * hash_sz * sizeof(iocMemoryBlock*);
+    tables = (iocMemoryBlock**)ioc_malloc(root, sz, OS_NULL, IOC_DEFAULT_ALLOC);
+    if (tables == OS_NULL) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+    os_memclear(tables, sz);
+
+    if (ix->name_hash)
+    {
+        ioc_free(root, ix->name_hash, 3 * ix->hash_sz * sizeof(iocMemoryBlock*),
+            IOC_DEFAULT_ALLOC);
+    }
+    ix->name_hash = tables;
+    ix->type_hash = tables + hash_sz;
+    ix->id_hash = tables + 2 * hash_sz;
+    ix->hash_sz = hash_sz;
+    ix->count = 0;
+
+    for (mblk = root->mblk.first; mblk; mblk = mblk->link.next)
+    {
+        ioc_mblk_index_link(ix, mblk);
+    }
+    return OSAL_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,145 @@
+/**
+
+  @file    ioc_mblk_index.h
+  @brief   Hash index of root's memory blocks.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Servers may have thousands of dynamically created memory blocks. Finding a memory block
+  by names from root's linked list, for example when memory block information is received
+  from new connection, would be slow. The index keeps three hash tables of root's memory
+  blocks:
+  - by network name, device name, device number and memory block name (exact match),
+  - by network name, device name and memory block name (any device number), and
+  - by unique memory block identifier.
+
+  Hash tables are grown as memory blocks are added. If memory allocation fails, lookups
+  fall back to scanning root's memory block list.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_MBLK_INDEX_H_
+#define IOC_MBLK_INDEX_H_
+#include "iocom.h"
+
+#if IOC_MBLK_INDEX
+
+struct iocRoot;
+struct iocMemoryBlock;
+
+/* Initial hash table size, must be power of two. Hash tables are doubled when there
+   are more memory blocks than hash table slots.
+ */
+#ifndef IOC_MBLK_INDEX_INITIAL_SZ
+#define IOC_MBLK_INDEX_INITIAL_SZ 64
+#endif
+
+/* Number of released memory block identifiers remembered for reuse once unique
+   identifiers have run out.
+ */
+#ifndef IOC_MBLK_FREE_ID_SZ
+#define IOC_MBLK_FREE_ID_SZ 64
+#endif
+
+
+/**
+****************************************************************************************************
+    Memory block index, member of iocRoot.
+****************************************************************************************************
+*/
+typedef struct iocMblkIndex
+{
+    /** Hash tables by full name, by name without device number and by memory block
+        identifier. All three are in one allocation, OS_NULL if not allocated.
+     */
+    struct iocMemoryBlock **name_hash;
+    struct iocMemoryBlock **type_hash;
+    struct iocMemoryBlock **id_hash;
+
+    /** Number of slots in each hash table.
+     */
+    os_int hash_sz;
+
+    /** Number of memory blocks in index.
+     */
+    os_int count;
+
+    /** Ring buffer of released memory block identifiers, oldest first.
+     */
+    os_uint free_id[IOC_MBLK_FREE_ID_SZ];
+    os_short free_id_head;
+    os_short free_id_count;
+}
+iocMblkIndex;
+
+
+/**
+****************************************************************************************************
+  Memory block index functions, ioc_lock() must be on when calling these.
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Release memory allocated for the index.
+ */
+void ioc_release_mblk_index(
+    struct iocRoot *root);
+
+/* Add memory block to index.
+ */
+void ioc_mblk_index_add(
+    struct iocRoot *root,
+    struct iocMemoryBlock *mblk);
+
+/* Remove memory block from index.
+ */
+void ioc_mblk_index_remove(
+    struct iocRoot *root,
+    struct iocMemoryBlock *mblk);
+
+/* Find memory block by network name, device name, device number and memory block name.
+ */
+struct iocMemoryBlock *ioc_mblk_index_find(
+    struct iocRoot *root,
+    const os_char *network_name,
+    const os_char *device_name,
+    os_uint device_nr,
+    const os_char *mblk_name);
+
+/* Find memory block by network name, device name and memory block name, any device number.
+ */
+struct iocMemoryBlock *ioc_mblk_index_find_type(
+    struct iocRoot *root,
+    struct iocMemoryBlock *prev_mblk,
+    const os_char *network_name,
+    const os_char *device_name,
+    const os_char *mblk_name);
+
+/* Find memory block by unique memory block identifier.
+ */
+struct iocMemoryBlock *ioc_mblk_index_find_by_id(
+    struct iocRoot *root,
+    os_uint mblk_id);
+
+/* Remember identifier of released memory block for reuse.
+ */
+void ioc_mblk_index_free_id(
+    struct iocRoot *root,
+    os_uint mblk_id);
+
+/* Get released memory block identifier which is not in use, 0 if none.
+ */
+os_uint ioc_mblk_index_reuse_id(
+    struct iocRoot *root);
+
+/*@}*/
+
+#endif
+#endif
@@ -0,0 +1,341 @@
+/**
+
+  @file    ioc_mblk_journal.c
+  @brief   Memory block generation counter and change journal.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Generation number is updated and changed range is stored in journal whenever memory
+  block data changes. Pollers ask for changes since generation they have seen.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_MBLK_GENERATIONS
+
+
+/**
+****************************************************************************************************
+
+  @brief Record change to memory block.
+  @anchor ioc_mblk_record_change
+
+  The ioc_mblk_record_change() function is called when data in memory block has been modified
+  by local write or received data. It sets memory block's generation number from root's
+  generation counter and, if journal is enabled, stores the changed range. If the range
+  overlaps or is adjacent to the latest journal entry, it is merged into it. If journal is
+  full, the oldest entry is dropped.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   mblk Pointer to memory block structure.
+  @param   start_addr First changed byte address.
+  @param   end_addr Last changed byte address.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mblk_record_change(
+    iocMemoryBlock *mblk,
+    os_int start_addr,
+    os_int end_addr)
+{
+    iocRoot *root;
+    iocMblkJournal *j;
+    iocMblkChange *e;
+
+    /* Generation numbers are taken from one counter per root, so that a single generation
+       number tells what has changed in all memory blocks. Zero is reserved for "never seen".
+     */
+    root = mblk->link.root;
+    if (++(root->mblk_generation) == 0) root->mblk_generation = 1;
+    mblk->generation = root->mblk_generation;
+
+    j = mblk->journal;
+    if (j == OS_NULL) return;
+
+    if (j->count)
+    {
+        e = j->entry + (j->head + j->count - 1) % j->sz;
+        if (start_addr <= e->end_addr + 1 && end_addr + 1 >= e->start_addr)
+        {
+            if (start_addr < e->start_addr) e->start_addr = (ioc_addr)start_addr;
+            if (end_addr > e->end_addr) e->end_addr = (ioc_addr)end_addr;
+            e->generation = mblk->generation;
+            return;
+        }
+    }
+
+    if (j->count == j->sz)
+    {
+        j->base_generation = j->entry[j->head].generation;
+        j->head = (j->head + 1) % j->sz;
+        j->count--;
+    }
+
+    e = j->entry + (j->head + j->count) % j->sz;
+    e->generation = mblk->generation;
+    e->start_addr = (ioc_addr)start_addr;
+    e->end_addr = (ioc_addr)end_addr;
+    j->count++;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release memory block's change journal.
+  @anchor ioc_mblk_release_journal
+
+  The ioc_mblk_release_journal() function frees memory allocated for the change journal,
+  if any. Called when memory block is released or journal is resized.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   mblk Pointer to memory block structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mblk_release_journal(
+    iocMemoryBlock *mblk)
+{
+    iocRoot *root;
+    iocMblkJournal *j;
+
+    j = mblk->journal;
+    if (j == OS_NULL) return;
+    root = mblk->link.root;
+
+    ioc_free(root, j->entry, j->sz * sizeof(iocMblkChange), IOC_DEFAULT_ALLOC);
+    ioc_free(root, j, sizeof(iocMblkJournal), IOC_DEFAULT_ALLOC);
+    mblk->journal = OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Enable, resize or disable memory block's change journal.
+  @anchor ioc_mblk_enable_journal
+
+  The ioc_mblk_enable_journal() function allocates change journal for the memory block.
+  Generation number is maintained even without journal, but then changes since a generation
+  cannot be told apart and the whole memory block is reported as changed. Existing journal
+  content is dropped.
+
+  @param   handle Memory block handle.
+  @param   max_entries Maximum number of changed ranges to remember, at most
+           IOC_MBLK_JOURNAL_MAX_SZ. Zero to disable the journal.
+  @return  OSAL_SUCCESS if successfull, OSAL_STATUS_MEMORY_ALLOCATION_FAILED if memory
+           allocation failed and OSAL_STATUS_FAILED if memory block handle is not valid.
+
+****************************************************************************************************
+*/
+osalStatus ioc_mblk_enable_journal(
+    iocHandle *handle,
+    os_int max_entries)
+{
+    iocRoot *root;
+    iocMemoryBlock *mblk;
+    iocMblkJournal *j;
+    osalStatus s = OSAL_SUCCESS;
+
+    mblk = ioc_handle_lock_to_mblk(handle, &root);
+    if (mblk == OS_NULL) return OSAL_STATUS_FAILED;
+
+    ioc_mblk_release_journal(mblk);
+    if (max_entries <= 0) goto getout;
+    if (max_entries > IOC_MBLK_JOURNAL_MAX_SZ) max_entries = IOC_MBLK_JOURNAL_MAX_SZ;
+
+    j = (iocMblkJournal*)ioc_malloc(root, sizeof(iocMblkJournal), OS_NULL, IOC_DEFAULT_ALLOC);
+    if (j == OS_NULL) goto failed;
+    os_memclear(j, sizeof(iocMblkJournal));
+    j->entry = (iocMblkChange*)ioc_malloc(root, max_entries * sizeof(iocMblkChange),
+        OS_NULL, IOC_DEFAULT_ALLOC);
+    if (j->entry == OS_NULL)
+    {
+        ioc_free(root, j, sizeof(iocMblkJournal), IOC_DEFAULT_ALLOC);
+        goto failed;
+    }
+    j->sz = max_entries;
+    j->base_generation = mblk->generation;
+    mblk->journal = j;
+    goto getout;
+
+failed:
+    s = OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+getout:
+    ioc_unlock(root);
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get memory block's current generation number.
+  @anchor ioc_mblk_get_generation
+
+  The ioc_mblk_get_generation() function returns generation number, which is updated
+  whenever memory block data changes.
+
+  @param   handle Memory block handle.
+  @return  Generation number, zero if memory block has never been modified or handle is
+           not valid.
+
+****************************************************************************************************
+*/
+os_uint ioc_mblk_get_generation(
+    iocHandle *handle)
+{
+    iocRoot *root;
+    iocMemoryBlock *mblk;
+    os_uint generation;
+
+    mblk = ioc_handle_lock_to_mblk(handle, &root);
+    if (mblk == OS_NULL) return 0;
+    generation = mblk->generation;
+    ioc_unlock(root);
+    return generation;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get address ranges changed since given generation.
+  @anchor ioc_mblk_get_changes
+
+  The ioc_mblk_get_changes() function stores changed address ranges since generation
+  into changes array, oldest first. If journal doesn't reach back far enough, memory block
+  has no journal or there are more ranges than fit in changes array, one range covering
+  all changes (possibly whole memory block) is returned instead.
+
+  @param   handle Memory block handle.
+  @param   since_generation Generation number the caller has seen, zero if none.
+  @param   changes Where to store changed ranges.
+  @param   max_changes Size of changes array, at least 1.
+  @param   generation Pointer where to store current generation number, to be given
+           as since_generation in next call. OS_NULL if not needed.
+  @return  Number of changed ranges stored, zero if nothing has changed.
+
+****************************************************************************************************
+*/
+os_int ioc_mblk_get_changes(
+    iocHandle *handle,
+    os_uint since_generation,
+    iocMblkChange *changes,
+    os_int max_changes,
+    os_uint *generation)
+{
+    iocRoot *root;
+    iocMemoryBlock *mblk;
+    os_int n;
+
+    if (generation) *generation = 0;
+    mblk = ioc_handle_lock_to_mblk(handle, &root);
+    if (mblk == OS_NULL) return 0;
+    if (generation) *generation = mblk->generation;
+    n = ioc_mblk_changes_since(mblk, since_generation, changes, max_changes);
+    ioc_unlock(root);
+    return n;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get address ranges changed since given generation, ioc_lock() on.
+  @anchor ioc_mblk_changes_since
+
+  The ioc_mblk_changes_since() function is ioc_mblk_get_changes() for callers which already
+  hold ioc_lock() and have memory block pointer, like device directory listing.
+
+  Since generation numbers are common to all memory blocks of the root, since_generation
+  may be newer than memory block's own generation: This means that the memory block has not
+  changed. Only generation newer than root's latest generation is treated as unknown.
+
+  @param   mblk Pointer to memory block structure.
+  @param   since_generation Generation number the caller has seen, zero if none.
+  @param   changes Where to store changed ranges.
+  @param   max_changes Size of changes array, at least 1.
+  @return  Number of changed ranges stored, zero if nothing has changed.
+
+****************************************************************************************************
+*/
+os_int ioc_mblk_changes_since(
+    iocMemoryBlock *mblk,
+    os_uint since_generation,
+    iocMblkChange *changes,
+    os_int max_changes)
+{
+    iocMblkJournal *j;
+    iocMblkChange *e;
+    os_int i, n, first;
+
+    osal_debug_assert(max_changes > 0);
+    if (mblk->nbytes <= 0) return 0;
+
+    /* If since_generation is in the future, report whole block. Otherwise nothing has
+       changed if memory block's generation is not newer than since_generation.
+     */
+    if ((os_int)(mblk->link.root->mblk_generation - since_generation) < 0) goto whole_mblk;
+    if (since_generation && (os_int)(mblk->generation - since_generation) <= 0) return 0;
+    if (mblk->generation == 0) return 0;
+
+    /* If there is no journal or it doesn't reach back to since_generation, report
+       whole block.
+     */
+    j = mblk->journal;
+    if (j == OS_NULL || (os_int)(since_generation - j->base_generation) < 0) {
+        goto whole_mblk;
+    }
+
+    /* Find the oldest entry newer than since_generation.
+     */
+    first = j->count;
+    while (first > 0)
+    {
+        e = j->entry + (j->head + first - 1) % j->sz;
+        if ((os_int)(e->generation - since_generation) <= 0) break;
+        first--;
+    }
+    n = j->count - first;
+
+    if (n <= max_changes)
+    {
+        for (i = 0; i < n; i++)
+        {
+            changes[i] = j->entry[(j->head + first + i) % j->sz];
+        }
+        return n;
+    }
+
+    /* Too many ranges, merge into one.
+     */
+    e = j->entry + (j->head + first) % j->sz;
+    changes[0] = *e;
+    for (i = 1; i < n; i++)
+    {
+        e = j->entry + (j->head + first + i) % j->sz;
+        if (e->start_addr < changes[0].start_addr) changes[0].start_addr = e->start_addr;
+        if (e->end_addr > changes[0].end_addr) changes[0].end_addr = e->end_addr;
+    }
+    changes[0].generation = mblk->generation;
+    return 1;
+
+whole_mblk:
+    changes[0].generation = mblk->generation;
+    changes[0].start_addr = 0;
+    changes[0].end_addr = mblk->nbytes - 1;
+    return 1;
+}
+
+#endif
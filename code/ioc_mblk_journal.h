@@ -0,0 +1,139 @@
+/**
+
+  @file    ioc_mblk_journal.h
+  @brief   Memory block generation counter and change journal.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Each memory block has a generation number, which is updated whenever data in the memory
+  block changes, either by local write or by received data. A poller (Python application,
+  device directory, bridge) remembers the generation it has seen and can later ask which
+  address ranges have changed since, instead of rereading the whole memory block.
+  Generation numbers come from one counter per root, so one number seen by the poller also
+  tells which memory blocks have changed since.
+
+  Changed ranges are stored in optional, bounded change journal which is enabled per memory
+  block by ioc_mblk_enable_journal(). A change which overlaps or is adjacent to the latest
+  journal entry is merged into it. If the journal doesn't reach back to the generation asked
+  for, or memory block has no journal, the whole memory block is reported as changed. Thus
+  the answer is always safe, just not always minimal.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_MBLK_JOURNAL_H_
+#define IOC_MBLK_JOURNAL_H_
+#include "iocom.h"
+
+#if IOC_MBLK_GENERATIONS
+
+struct iocMemoryBlock;
+
+/* Maximum number of entries in memory block's change journal.
+ */
+#ifndef IOC_MBLK_JOURNAL_MAX_SZ
+#define IOC_MBLK_JOURNAL_MAX_SZ 1024
+#endif
+
+
+/**
+****************************************************************************************************
+    Changed address range.
+****************************************************************************************************
+*/
+typedef struct iocMblkChange
+{
+    /** Generation number after the change (or the last merged change).
+     */
+    os_uint generation;
+
+    /** First and last changed byte address.
+     */
+    ioc_addr start_addr;
+    ioc_addr end_addr;
+}
+iocMblkChange;
+
+
+/**
+****************************************************************************************************
+    Change journal, ring buffer of changed ranges. Allocated by ioc_mblk_enable_journal().
+****************************************************************************************************
+*/
+typedef struct iocMblkJournal
+{
+    /** Journal entries, sz entries allocated.
+     */
+    iocMblkChange *entry;
+    os_int sz;
+
+    /** Index of the oldest entry and number of entries in use.
+     */
+    os_int head;
+    os_int count;
+
+    /** Generation number before the oldest entry: Changes after this generation are
+        all in journal.
+     */
+    os_uint base_generation;
+}
+iocMblkJournal;
+
+
+/**
+****************************************************************************************************
+  Memory block generation and change journal functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Record change to memory block (ioc_lock must be on).
+ */
+void ioc_mblk_record_change(
+    struct iocMemoryBlock *mblk,
+    os_int start_addr,
+    os_int end_addr);
+
+/* Release memory block's change journal (ioc_lock must be on).
+ */
+void ioc_mblk_release_journal(
+    struct iocMemoryBlock *mblk);
+
+/* Enable, resize or disable memory block's change journal.
+ */
+osalStatus ioc_mblk_enable_journal(
+    iocHandle *handle,
+    os_int max_entries);
+
+/* Get memory block's current generation number.
+ */
+os_uint ioc_mblk_get_generation(
+    iocHandle *handle);
+
+/* Get address ranges changed since given generation.
+ */
+os_int ioc_mblk_get_changes(
+    iocHandle *handle,
+    os_uint since_generation,
+    iocMblkChange *changes,
+    os_int max_changes,
+    os_uint *generation);
+
+/* Get address ranges changed since given generation (ioc_lock must be on).
+ */
+os_int ioc_mblk_changes_since(
+    struct iocMemoryBlock *mblk,
+    os_uint since_generation,
+    iocMblkChange *changes,
+    os_int max_changes);
+
+/*@}*/
+
+#endif
+#endif
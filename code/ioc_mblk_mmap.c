@@ -0,0 +1,274 @@
+/**
+
+  @file    ioc_mblk_mmap.c
+  @brief   Memory block backed by memory mapped file.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Memory block's buffer is replaced by memory mapped file, so loading big static or persistent
+  memory block doesn't need copying it. Write back mappings are synchronized to disk by
+  ioc_run() on timer, and when memory block is released.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_MBLK_MMAP
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/**
+****************************************************************************************************
+
+  @brief Replace memory block's buffer by memory mapped file.
+  @anchor ioc_mmap_mblk
+
+  The ioc_mmap_mblk() function maps a file and sets it as memory block's buffer. Buffer
+  allocated for the memory block is freed. Memory block size is kept, except that memory
+  block with IOC_ALLOW_RESIZE flag grows to the file size. If memory block size changes,
+  source and target buffers of the memory block are released (as with resize), and if data
+  changes it will be sent to connected devices.
+
+  - IOC_MMAP_READ_ONLY: The file must be at least memory block size. Memory block must be
+    static (IOC_STATIC), received data is not written to it. The mapping is read only.
+  - IOC_MMAP_WRITE_BACK: The file is created if it doesn't exist and extended with zeros to
+    memory block size if it is shorter.
+
+  @param   handle Memory block handle.
+  @param   path Path to file to map, like "/coderoot/data/parameters.mblk".
+  @param   flags IOC_MMAP_READ_ONLY or IOC_MMAP_WRITE_BACK.
+  @return  OSAL_SUCCESS if successful. OSAL_STATUS_OPEN_FAILED if file could not be opened,
+           OSAL_STATUS_READING_FILE_FAILED if file is too short for read only mapping or cannot
+           be read, OSAL_STATUS_WRITING_FILE_FAILED if file could not be extended, and
+           OSAL_STATUS_FAILED for other errors (invalid handle, already mapped, read only
+           mapping of memory block which is not static, mmap failed).
+
+****************************************************************************************************
+*/
+osalStatus ioc_mmap_mblk(
+    iocHandle *handle,
+    const os_char *path,
+    os_short flags)
+{
+    iocRoot *root;
+    iocMemoryBlock *mblk;
+    iocMblkMmap *m;
+    struct stat st;
+    os_char *addr;
+    os_memsz file_sz;
+    os_int fd, nbytes;
+    os_boolean write_back;
+    osalStatus s;
+
+    mblk = ioc_handle_lock_to_mblk(handle, &root);
+    if (mblk == OS_NULL) return OSAL_STATUS_FAILED;
+
+    if (mblk->mmap)
+    {
+        osal_debug_error("memory block is already memory mapped");
+        s = OSAL_STATUS_FAILED;
+        goto getout;
+    }
+
+    write_back = (os_boolean)((flags & IOC_MMAP_WRITE_BACK) != 0);
+    if (!write_back && (mblk->flags & IOC_STATIC) == 0)
+    {
+        osal_debug_error("read only memory mapping needs static memory block");
+        s = OSAL_STATUS_FAILED;
+        goto getout;
+    }
+
+    fd = open(path, write_back ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd < 0)
+    {
+        s = OSAL_STATUS_OPEN_FAILED;
+        goto getout;
+    }
+
+    if (fstat(fd, &st))
+    {
+        s = OSAL_STATUS_READING_FILE_FAILED;
+        goto failed;
+    }
+    file_sz = (os_memsz)st.st_size;
+
+    nbytes = mblk->nbytes;
+    if ((mblk->flags & IOC_ALLOW_RESIZE) && file_sz > nbytes)
+    {
+        nbytes = (os_int)file_sz;
+    }
+
+    if (write_back)
+    {
+        if (file_sz < nbytes && ftruncate(fd, nbytes))
+        {
+            s = OSAL_STATUS_WRITING_FILE_FAILED;
+            goto failed;
+        }
+    }
+    else if (file_sz < nbytes || nbytes <= 0)
+    {
+        osal_debug_error_str("file is shorter than memory block: ", path);
+        s = OSAL_STATUS_READING_FILE_FAILED;
+        goto failed;
+    }
+
+    /* Read only file is mapped without write access, so nothing can modify the file
+       or make private copies of the pages.
+     */
+    addr = (os_char*)mmap(OS_NULL, (size_t)nbytes,
+        write_back ? (PROT_READ | PROT_WRITE) : PROT_READ,
+        write_back ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    if (addr == (os_char*)MAP_FAILED)
+    {
+        s = OSAL_STATUS_FAILED;
+        goto failed;
+    }
+
+    m = (iocMblkMmap*)ioc_malloc(root, sizeof(iocMblkMmap), OS_NULL, IOC_DEFAULT_ALLOC);
+    if (m == OS_NULL)
+    {
+        munmap(addr, (size_t)nbytes);
+        s = OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+        goto failed;
+    }
+    os_memclear(m, sizeof(iocMblkMmap));
+    m->fd = fd;
+    m->addr = addr;
+    m->sz = nbytes;
+    m->flags = flags;
+
+    /* Source and target buffers have been set up for current memory block size.
+     */
+    if (nbytes != mblk->nbytes)
+    {
+        while (mblk->sbuf.first)
+        {
+            ioc_release_source_buffer(mblk->sbuf.first);
+        }
+        while (mblk->tbuf.first)
+        {
+            ioc_release_target_buffer(mblk->tbuf.first);
+        }
+    }
+
+    if (mblk->buf_allocated)
+    {
+        ioc_free(root, mblk->buf, mblk->nbytes, IOC_DEFAULT_ALLOC);
+        mblk->buf_allocated = OS_FALSE;
+    }
+    mblk->buf = addr;
+    mblk->nbytes = nbytes;
+    mblk->mmap = m;
+    root->mmap_count++;
+
+    /* Content has changed, transfer it and count as a new generation. This one is
+       already on disk.
+     */
+    ioc_mblk_invalidate(mblk, 0, nbytes - 1);
+    m->synced_generation = mblk->generation;
+    s = OSAL_SUCCESS;
+    goto getout;
+
+failed:
+    close(fd);
+getout:
+    ioc_unlock(root);
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write changes to disk and remove memory mapping.
+  @anchor ioc_munmap_mblk
+
+  The ioc_munmap_mblk() function is called when memory mapped memory block is released.
+  Write back mapping is synchronized to disk before it is removed. Memory block's buffer
+  pointer is cleared, thus memory block must not be used after this call.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   mblk Pointer to memory block structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_munmap_mblk(
+    iocMemoryBlock *mblk)
+{
+    iocRoot *root;
+    iocMblkMmap *m;
+
+    m = mblk->mmap;
+    if (m == OS_NULL) return;
+    root = mblk->link.root;
+
+    if (m->flags & IOC_MMAP_WRITE_BACK)
+    {
+        msync(m->addr, (size_t)m->sz, MS_SYNC);
+    }
+    munmap(m->addr, (size_t)m->sz);
+    close(m->fd);
+
+    ioc_free(root, m, sizeof(iocMblkMmap), IOC_DEFAULT_ALLOC);
+    mblk->mmap = OS_NULL;
+    mblk->buf = OS_NULL;
+    root->mmap_count--;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write changed memory mapped memory blocks to disk.
+  @anchor ioc_sync_mmapped_mblks
+
+  The ioc_sync_mmapped_mblks() function is called by ioc_run(). Every IOC_MMAP_SYNC_MS it
+  starts writing write back memory blocks which have changed since last call to disk. The
+  memory block generation number tells if memory block has changed. Without force, msync()
+  is asynchronous and doesn't block while holding the lock.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   root Pointer to the root structure.
+  @param   force OS_TRUE to write changes now and wait until these are on disk, regardless
+           of timer.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_sync_mmapped_mblks(
+    iocRoot *root,
+    os_boolean force)
+{
+    iocMemoryBlock *mblk;
+    iocMblkMmap *m;
+
+    if (root->mmap_count == 0) return;
+    if (!force && !os_has_elapsed(&root->mmap_sync_timer, IOC_MMAP_SYNC_MS)) return;
+    os_get_timer(&root->mmap_sync_timer);
+
+    for (mblk = root->mblk.first; mblk; mblk = mblk->link.next)
+    {
+        m = mblk->mmap;
+        if (m == OS_NULL) continue;
+        if ((m->flags & IOC_MMAP_WRITE_BACK) == 0) continue;
+        if (m->synced_generation == mblk->generation) continue;
+
+        msync(m->addr, (size_t)m->sz, force ? MS_SYNC : MS_ASYNC);
+        m->synced_generation = mblk->generation;
+    }
+}
+
+#endif
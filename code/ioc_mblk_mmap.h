@@ -0,0 +1,103 @@
+/**
+
+  @file    ioc_mblk_mmap.h
+  @brief   Memory block backed by memory mapped file.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Large configuration and parameter memory blocks on Linux servers can be backed directly by
+  a memory mapped file, instead of allocating a buffer and copying file content into it at
+  startup. The memory block's buffer is replaced by the mapping, so the pages are read from
+  disk only when touched.
+
+  - IOC_MMAP_READ_ONLY: The file is never modified. The mapping is read only, so memory block
+    must be static (IOC_STATIC) and must not be written by application.
+  - IOC_MMAP_WRITE_BACK: Changes to memory block are written to the file. ioc_run() calls
+    msync() for changed memory blocks every IOC_MMAP_SYNC_MS, and the mapping is synchronized
+    to disk when the memory block is released. Meant for persistent memory blocks.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_MBLK_MMAP_H_
+#define IOC_MBLK_MMAP_H_
+#include "iocom.h"
+
+#if IOC_MBLK_MMAP
+
+struct iocMemoryBlock;
+
+/* How often ioc_run() writes changed memory mapped memory blocks to disk, ms.
+ */
+#ifndef IOC_MMAP_SYNC_MS
+#define IOC_MMAP_SYNC_MS 2000
+#endif
+
+/* Flags for ioc_mmap_mblk().
+ */
+#define IOC_MMAP_READ_ONLY 1
+#define IOC_MMAP_WRITE_BACK 2
+
+
+/**
+****************************************************************************************************
+    Memory mapping of a memory block. Allocated by ioc_mmap_mblk().
+****************************************************************************************************
+*/
+typedef struct iocMblkMmap
+{
+    /** File descriptor of mapped file.
+     */
+    os_int fd;
+
+    /** Mapped address and size in bytes.
+     */
+    os_char *addr;
+    os_memsz sz;
+
+    /** IOC_MMAP_READ_ONLY or IOC_MMAP_WRITE_BACK.
+     */
+    os_short flags;
+
+    /** Memory block generation number when mapping was last synchronized to disk.
+     */
+    os_uint synced_generation;
+}
+iocMblkMmap;
+
+
+/**
+****************************************************************************************************
+  Memory mapped memory block functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Replace memory block's buffer by memory mapped file.
+ */
+osalStatus ioc_mmap_mblk(
+    iocHandle *handle,
+    const os_char *path,
+    os_short flags);
+
+/* Write changes to disk and remove memory mapping (ioc_lock must be on).
+ */
+void ioc_munmap_mblk(
+    struct iocMemoryBlock *mblk);
+
+/* Write changed memory mapped memory blocks to disk (ioc_lock must be on).
+ */
+void ioc_sync_mmapped_mblks(
+    iocRoot *root,
+    os_boolean force);
+
+/*@}*/
+
+#endif
+#endif
@@ -0,0 +1,1111 @@
+/**
+
+  @file    ioc_mblk_recorder.c
+  @brief   Time series recording of memory block changes.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Receive callback appends delta records to RAM buffer, recorder thread writes them to
+  segment rotated log files. Reader functions for the log. See ioc_mblk_recorder.h for the
+  file format.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_MBLK_RECORDER
+
+#if IOC_MBLK_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* Forward referred static functions.
+ */
+static void ioc_recorder_callback(
+    struct iocHandle *handle,
+    os_int start_addr,
+    os_int end_addr,
+    os_ushort flags,
+    void *context);
+
+static void ioc_recorder_append(
+    iocMblkRecorder *rec,
+    iocMemoryBlock *mblk,
+    os_int start_addr,
+    os_int end_addr,
+    os_int flags);
+
+static void ioc_recorder_thread(
+    void *prm,
+    osalEvent done);
+
+static void ioc_recorder_flush(
+    iocMblkRecorder *rec);
+
+static osalStatus ioc_recorder_write_record(
+    iocMblkRecorder *rec,
+    os_int64 timestamp,
+    os_int addr,
+    const os_char *data,
+    os_int n,
+    os_int flags);
+
+static osalStatus ioc_recorder_new_segment(
+    iocMblkRecorder *rec,
+    os_int64 timestamp);
+
+static void ioc_recorder_close_segment(
+    iocMblkRecorder *rec);
+
+static void ioc_recorder_save_head(
+    iocMblkRecorder *rec);
+
+static osalStatus ioc_recorder_load_head(
+    const os_char *path,
+    iocRecorderSegment **segments,
+    os_int *n_segments);
+
+static osalStatus ioc_recording_load_segment(
+    iocRecordingReader *r,
+    os_int segment_ix);
+
+static os_char *ioc_recording_map_segment(
+    const os_char *fname,
+    os_memsz *n);
+
+static void ioc_recording_unload_segment(
+    iocRecordingReader *r);
+
+static void ioc_recorder_file_name(
+    const os_char *path,
+    os_uint seq,
+    const os_char *ext,
+    os_char *buf,
+    os_memsz buf_sz);
+
+static void ioc_recorder_put(
+    os_uchar *p,
+    os_ulong v,
+    os_int nbytes);
+
+static os_ulong ioc_recorder_get(
+    const os_uchar *p,
+    os_int nbytes);
+
+
+/**
+****************************************************************************************************
+
+  @brief Start recording received data of a memory block.
+  @anchor ioc_start_mblk_recorder
+
+  The ioc_start_mblk_recorder() function allocates the recorder, starts recorder thread,
+  records snapshot of current memory block content and adds receive callback to the memory
+  block. If log files exist already from earlier run, segment numbering continues
+  from them.
+
+  @param   mblk_handle Handle of memory block to record.
+  @param   prm Recorder parameters.
+  @return  Pointer to recorder object, OS_NULL if failed.
+
+****************************************************************************************************
+*/
+iocMblkRecorder *ioc_start_mblk_recorder(
+    iocHandle *mblk_handle,
+    iocRecorderParams *prm)
+{
+    iocMblkRecorder *rec;
+    iocMemoryBlock *mblk;
+    iocRoot *root;
+    iocRecorderSegment *old_segments;
+    os_int n_old, i;
+    osalThreadOptParams opt;
+
+    if (prm->path == OS_NULL || prm->path[0] == '\0') return OS_NULL;
+
+    rec = (iocMblkRecorder*)os_malloc(sizeof(iocMblkRecorder), OS_NULL);
+    if (rec == OS_NULL) return OS_NULL;
+    os_memclear(rec, sizeof(iocMblkRecorder));
+
+    os_strncpy(rec->path, prm->path, OSAL_PATH_SZ);
+    rec->segment_sz = prm->segment_sz > 0 ? prm->segment_sz : IOC_RECORDER_SEGMENT_SZ;
+    rec->max_segments = prm->max_segments > 0 ? prm->max_segments : IOC_RECORDER_MAX_SEGMENTS;
+    rec->buf_sz = prm->buf_sz > 0 ? prm->buf_sz : IOC_RECORDER_BUF_SZ;
+
+    rec->fill_buf = (os_char*)os_malloc(rec->buf_sz, OS_NULL);
+    rec->write_buf = (os_char*)os_malloc(rec->buf_sz, OS_NULL);
+    rec->segments = (iocRecorderSegment*)os_malloc(
+        rec->max_segments * sizeof(iocRecorderSegment), OS_NULL);
+    if (rec->fill_buf == OS_NULL || rec->write_buf == OS_NULL || rec->segments == OS_NULL)
+    {
+        goto failed;
+    }
+
+    /* Continue segment numbering and rotation from log files written earlier.
+     */
+    if (ioc_recorder_load_head(rec->path, &old_segments, &n_old) == OSAL_SUCCESS)
+    {
+        for (i = 0; i < n_old; i++)
+        {
+            if (rec->n_segments == rec->max_segments)
+            {
+                os_memmove(rec->segments, rec->segments + 1,
+                    (rec->max_segments - 1) * sizeof(iocRecorderSegment));
+                rec->n_segments--;
+            }
+            rec->segments[rec->n_segments++] = old_segments[i];
+        }
+        os_free(old_segments, n_old * sizeof(iocRecorderSegment));
+    }
+
+    rec->root = mblk_handle->root;
+    ioc_duplicate_handle(&rec->handle, mblk_handle);
+
+    /* Event and thread must exist before the first record is appended.
+     */
+    rec->trig = osal_event_create(OSAL_EVENT_SET_AT_EXIT);
+    if (rec->trig == OS_NULL) goto failed;
+    os_memclear(&opt, sizeof(opt));
+    opt.thread_name = "recorder";
+    rec->thread = osal_thread_create(ioc_recorder_thread, rec, &opt, OSAL_THREAD_ATTACHED);
+    if (rec->thread == OS_NULL) goto failed;
+
+    /* Record the initial state and add the callback last, within the same lock so that
+       no change is received between the snapshot and the first delta record. The lock
+       nests, like when a callback reads the memory block.
+     */
+    mblk = ioc_handle_lock_to_mblk(&rec->handle, &root);
+    if (mblk == OS_NULL) goto failed;
+    ioc_recorder_append(rec, mblk, 0, mblk->nbytes - 1, IOC_RECORD_SNAPSHOT);
+    ioc_add_callback(&rec->handle, ioc_recorder_callback, rec);
+    ioc_unlock(root);
+    return rec;
+
+failed:
+    if (rec->thread)
+    {
+        rec->stop_thread = OS_TRUE;
+        osal_event_set(rec->trig);
+        osal_thread_join(rec->thread);
+    }
+    if (rec->trig) osal_event_delete(rec->trig);
+    if (rec->root) ioc_release_handle(&rec->handle);
+    if (rec->fill_buf) os_free(rec->fill_buf, rec->buf_sz);
+    if (rec->write_buf) os_free(rec->write_buf, rec->buf_sz);
+    if (rec->segments) os_free(rec->segments, rec->max_segments * sizeof(iocRecorderSegment));
+    os_free(rec, sizeof(iocMblkRecorder));
+    return OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Stop recording and release the recorder.
+  @anchor ioc_stop_mblk_recorder
+
+  The ioc_stop_mblk_recorder() function removes receive callback, stops recorder thread
+  which writes remaining records to disk, and frees memory allocated for the recorder.
+
+  @param   rec Pointer to recorder object, OS_NULL to do nothing.
+  @param   stats Where to store final statistics, OS_NULL if not needed.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_stop_mblk_recorder(
+    iocMblkRecorder *rec,
+    iocRecorderStats *stats)
+{
+    if (rec == OS_NULL) return;
+
+    ioc_remove_callback(&rec->handle, ioc_recorder_callback, rec);
+
+    rec->stop_thread = OS_TRUE;
+    osal_event_set(rec->trig);
+    osal_thread_join(rec->thread);
+    osal_event_delete(rec->trig);
+    ioc_release_handle(&rec->handle);
+    if (stats) *stats = rec->stats;
+
+    if (rec->image) os_free(rec->image, rec->image_sz);
+    os_free(rec->fill_buf, rec->buf_sz);
+    os_free(rec->write_buf, rec->buf_sz);
+    os_free(rec->segments, rec->max_segments * sizeof(iocRecorderSegment));
+    os_free(rec, sizeof(iocMblkRecorder));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get recorder statistics.
+  @anchor ioc_get_mblk_recorder_stats
+
+  The ioc_get_mblk_recorder_stats() function copies number of records captured, dropped and
+  written. Use this to check that recorder keeps up with the data rate.
+
+  @param   rec Pointer to recorder object.
+  @param   stats Where to store statistics.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_get_mblk_recorder_stats(
+    iocMblkRecorder *rec,
+    iocRecorderStats *stats)
+{
+    iocRoot *root;
+
+    root = rec->root;
+    ioc_lock(root);
+    *stats = rec->stats;
+    ioc_unlock(root);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Receive callback (internal).
+
+  Called with ioc_lock() on when data has been received to the memory block. Appends record
+  to RAM buffer.
+
+****************************************************************************************************
+*/
+static void ioc_recorder_callback(
+    struct iocHandle *handle,
+    os_int start_addr,
+    os_int end_addr,
+    os_ushort flags,
+    void *context)
+{
+    if ((flags & IOC_MBLK_CALLBACK_RECEIVE) == 0) return;
+    ioc_recorder_append((iocMblkRecorder*)context, handle->mblk, start_addr, end_addr, 0);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Append record to RAM buffer (internal).
+
+  ioc_lock() must be on when this function is called. Never blocks: If the record doesn't
+  fit into RAM buffer, it is dropped.
+
+  @param   rec Pointer to recorder object.
+  @param   mblk Pointer to the memory block.
+  @param   start_addr First changed address.
+  @param   end_addr Last changed address.
+  @param   flags IOC_RECORD_SNAPSHOT or 0.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_recorder_append(
+    iocMblkRecorder *rec,
+    iocMemoryBlock *mblk,
+    os_int start_addr,
+    os_int end_addr,
+    os_int flags)
+{
+    os_uchar *p;
+    os_int64 t;
+    os_int n;
+
+    if (mblk == OS_NULL) return;
+    if (end_addr >= mblk->nbytes) end_addr = mblk->nbytes - 1;
+    n = end_addr - start_addr + 1;
+    if (n <= 0) return;
+
+    if (n > IOC_RECORDER_MAX_RECORD_SZ ||
+        rec->fill_n + IOC_RECORDER_RECORD_HDR_SZ + n > rec->buf_sz)
+    {
+        rec->gap = OS_TRUE;
+        rec->stats.dropped++;
+        osal_event_set(rec->trig);
+        return;
+    }
+
+    if (rec->gap)
+    {
+        flags |= IOC_RECORD_GAP;
+        rec->gap = OS_FALSE;
+    }
+
+    os_time(&t);
+    p = (os_uchar*)rec->fill_buf + rec->fill_n;
+    ioc_recorder_put(p, (os_ulong)t, 8);
+    ioc_recorder_put(p + 8, (os_ulong)start_addr, 4);
+    ioc_recorder_put(p + 12, (os_ulong)n | ((os_ulong)flags << 24), 4);
+    os_memcpy(p + IOC_RECORDER_RECORD_HDR_SZ, mblk->buf + start_addr, n);
+    rec->fill_n += IOC_RECORDER_RECORD_HDR_SZ + n;
+
+    rec->stats.records++;
+    rec->stats.bytes += n;
+
+    if (rec->fill_n > (rec->buf_sz >> 1))
+    {
+        osal_event_set(rec->trig);
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Recorder thread (internal).
+
+  Writes records to disk every IOC_RECORDER_FLUSH_MS or when triggered, until stopped.
+
+****************************************************************************************************
+*/
+static void ioc_recorder_thread(
+    void *prm,
+    osalEvent done)
+{
+    iocMblkRecorder *rec;
+
+    rec = (iocMblkRecorder*)prm;
+    osal_event_set(done);
+
+    while (!rec->stop_thread && osal_go())
+    {
+        osal_event_wait(rec->trig, IOC_RECORDER_FLUSH_MS);
+        ioc_recorder_flush(rec);
+    }
+
+    /* Write records captured before callback was removed.
+     */
+    ioc_recorder_flush(rec);
+    ioc_recorder_close_segment(rec);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write records from RAM buffer to disk (internal).
+
+  Swaps RAM buffers within ioc_lock(), then writes records without holding the lock.
+
+****************************************************************************************************
+*/
+static void ioc_recorder_flush(
+    iocMblkRecorder *rec)
+{
+    iocRoot *root;
+    os_char *buf;
+    const os_uchar *p, *e;
+    os_memsz n;
+    os_ulong u;
+    os_int64 t;
+    os_int addr, count, flags;
+    os_long written;
+
+    root = rec->root;
+    ioc_lock(root);
+    buf = rec->fill_buf;
+    n = rec->fill_n;
+    rec->fill_buf = rec->write_buf;
+    rec->write_buf = buf;
+    rec->fill_n = 0;
+    ioc_unlock(root);
+
+    written = 0;
+    p = (const os_uchar*)buf;
+    e = p + n;
+    while (p + IOC_RECORDER_RECORD_HDR_SZ <= e)
+    {
+        t = (os_int64)ioc_recorder_get(p, 8);
+        addr = (os_int)ioc_recorder_get(p + 8, 4);
+        u = ioc_recorder_get(p + 12, 4);
+        count = (os_int)(u & IOC_RECORDER_MAX_RECORD_SZ);
+        flags = (os_int)(u >> 24);
+        p += IOC_RECORDER_RECORD_HDR_SZ;
+
+        if (ioc_recorder_write_record(rec, t, addr, (const os_char*)p, count, flags)
+            == OSAL_SUCCESS)
+        {
+            written++;
+        }
+        p += count;
+    }
+
+    if (written)
+    {
+        if (rec->segment) osal_stream_flush(rec->segment, OSAL_STREAM_DEFAULT);
+        if (rec->index) osal_stream_flush(rec->index, OSAL_STREAM_DEFAULT);
+        ioc_lock(root);
+        rec->stats.written += written;
+        ioc_unlock(root);
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write one record to segment file (internal).
+
+  Updates memory block image, starts new segment when current one is full and writes
+  index entry when due.
+
+  @return  OSAL_SUCCESS if record was written.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_recorder_write_record(
+    iocMblkRecorder *rec,
+    os_int64 timestamp,
+    os_int addr,
+    const os_char *data,
+    os_int n,
+    os_int flags)
+{
+    os_uchar hdr[IOC_RECORDER_RECORD_HDR_SZ];
+    os_uchar ientry[IOC_RECORDER_INDEX_ENTRY_SZ];
+    os_char *image;
+    os_memsz image_sz, n_written;
+    osalStatus s;
+
+    /* Keep copy of memory block content, grow it if memory block has been resized.
+     */
+    image_sz = (os_memsz)addr + n;
+    if (image_sz > rec->image_sz)
+    {
+        image = (os_char*)os_malloc(image_sz, OS_NULL);
+        if (image == OS_NULL) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+        os_memclear(image, image_sz);
+        if (rec->image)
+        {
+            os_memcpy(image, rec->image, rec->image_sz);
+            os_free(rec->image, rec->image_sz);
+        }
+        rec->image = image;
+        rec->image_sz = image_sz;
+    }
+    os_memcpy(rec->image + addr, data, n);
+
+    /* Start new segment if needed. The new segment begins with snapshot of
+       memory block including this record.
+     */
+    if (rec->segment == OS_NULL ||
+        rec->segment_n + IOC_RECORDER_RECORD_HDR_SZ + n > rec->segment_sz)
+    {
+        s = ioc_recorder_new_segment(rec, timestamp);
+        if (s) return s;
+        if ((flags & IOC_RECORD_SNAPSHOT) == 0 || addr != 0)
+        {
+            flags |= IOC_RECORD_SNAPSHOT;
+            addr = 0;
+            data = rec->image;
+            n = (os_int)rec->image_sz;
+        }
+    }
+
+    /* Index entry.
+     */
+    if (rec->segment_n >= rec->next_index_pos && rec->index)
+    {
+        ioc_recorder_put(ientry, (os_ulong)timestamp, 8);
+        ioc_recorder_put(ientry + 8, (os_ulong)rec->segment_n, 4);
+        osal_stream_write(rec->index, (const os_char*)ientry, IOC_RECORDER_INDEX_ENTRY_SZ,
+            &n_written, OSAL_STREAM_DEFAULT);
+        rec->next_index_pos = rec->segment_n + IOC_RECORDER_INDEX_INTERVAL;
+    }
+
+    ioc_recorder_put(hdr, (os_ulong)timestamp, 8);
+    ioc_recorder_put(hdr + 8, (os_ulong)addr, 4);
+    ioc_recorder_put(hdr + 12, (os_ulong)n | ((os_ulong)flags << 24), 4);
+    s = osal_stream_write(rec->segment, (const os_char*)hdr, IOC_RECORDER_RECORD_HDR_SZ,
+        &n_written, OSAL_STREAM_DEFAULT);
+    if (s == OSAL_SUCCESS)
+    {
+        s = osal_stream_write(rec->segment, data, n, &n_written, OSAL_STREAM_DEFAULT);
+    }
+    if (s)
+    {
+        osal_debug_error_int("recorder: writing segment failed, status=", s);
+        ioc_recorder_close_segment(rec);
+        return OSAL_STATUS_WRITING_FILE_FAILED;
+    }
+    rec->segment_n += IOC_RECORDER_RECORD_HDR_SZ + n;
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Close current segment and start a new one (internal).
+
+  If maximum number of segments has been reached, the oldest segment is deleted.
+
+  @param   rec Pointer to recorder object.
+  @param   timestamp Time stamp of first record in new segment.
+  @return  OSAL_SUCCESS if new segment file was created.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_recorder_new_segment(
+    iocMblkRecorder *rec,
+    os_int64 timestamp)
+{
+    os_char fname[OSAL_PATH_SZ];
+    os_uchar hdr[IOC_RECORDER_SEGMENT_HDR_SZ];
+    os_memsz n_written;
+    os_uint seq;
+    osalStatus s;
+
+    ioc_recorder_close_segment(rec);
+
+    seq = rec->n_segments ? rec->segments[rec->n_segments - 1].seq + 1 : 1;
+    ioc_recorder_file_name(rec->path, seq, ".tsl", fname, sizeof(fname));
+    rec->segment = osal_stream_open(OSAL_FILE_IFACE, fname, OS_NULL, &s, OSAL_STREAM_WRITE);
+    if (rec->segment == OS_NULL)
+    {
+        osal_debug_error_str("recorder: unable to create ", fname);
+        return OSAL_STATUS_OPEN_FAILED;
+    }
+    ioc_recorder_file_name(rec->path, seq, ".tsi", fname, sizeof(fname));
+    rec->index = osal_stream_open(OSAL_FILE_IFACE, fname, OS_NULL, &s, OSAL_STREAM_WRITE);
+
+    /* Delete the oldest segment if maximum number of segments has been reached.
+     */
+    if (rec->n_segments == rec->max_segments)
+    {
+        ioc_recorder_file_name(rec->path, rec->segments[0].seq, ".tsl", fname, sizeof(fname));
+        osal_remove(fname, 0);
+        ioc_recorder_file_name(rec->path, rec->segments[0].seq, ".tsi", fname, sizeof(fname));
+        osal_remove(fname, 0);
+        os_memmove(rec->segments, rec->segments + 1,
+            (rec->max_segments - 1) * sizeof(iocRecorderSegment));
+        rec->n_segments--;
+    }
+
+    os_memcpy(hdr, "IOTS", 4);
+    ioc_recorder_put(hdr + 4, 1, 4);
+    osal_stream_write(rec->segment, (const os_char*)hdr, IOC_RECORDER_SEGMENT_HDR_SZ,
+        &n_written, OSAL_STREAM_DEFAULT);
+    rec->segment_n = IOC_RECORDER_SEGMENT_HDR_SZ;
+    rec->next_index_pos = 0;
+
+    rec->segments[rec->n_segments].seq = seq;
+    rec->segments[rec->n_segments].first_timestamp = timestamp;
+    rec->n_segments++;
+    ioc_recorder_save_head(rec);
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Close current segment and index files, if open (internal).
+
+****************************************************************************************************
+*/
+static void ioc_recorder_close_segment(
+    iocMblkRecorder *rec)
+{
+    if (rec->segment)
+    {
+        osal_stream_close(rec->segment, OSAL_STREAM_DEFAULT);
+        rec->segment = OS_NULL;
+    }
+    if (rec->index)
+    {
+        osal_stream_close(rec->index, OSAL_STREAM_DEFAULT);
+        rec->index = OS_NULL;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write head file listing segments (internal).
+
+****************************************************************************************************
+*/
+static void ioc_recorder_save_head(
+    iocMblkRecorder *rec)
+{
+    os_char fname[OSAL_PATH_SZ];
+    os_uchar *buf, *p;
+    os_memsz sz;
+    os_int i;
+
+    sz = IOC_RECORDER_HEAD_HDR_SZ + rec->n_segments * IOC_RECORDER_HEAD_ENTRY_SZ;
+    buf = (os_uchar*)os_malloc(sz, OS_NULL);
+    if (buf == OS_NULL) return;
+
+    os_memcpy(buf, "IOTH", 4);
+    ioc_recorder_put(buf + 4, (os_ulong)rec->n_segments, 4);
+    p = buf + IOC_RECORDER_HEAD_HDR_SZ;
+    for (i = 0; i < rec->n_segments; i++)
+    {
+        ioc_recorder_put(p, rec->segments[i].seq, 4);
+        ioc_recorder_put(p + 4, (os_ulong)rec->segments[i].first_timestamp, 8);
+        p += IOC_RECORDER_HEAD_ENTRY_SZ;
+    }
+
+    os_strncpy(fname, rec->path, sizeof(fname));
+    os_strncat(fname, ".tsh", sizeof(fname));
+    os_write_file(fname, (const os_char*)buf, sz, OS_FILE_DEFAULT);
+    os_free(buf, sz);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Read head file listing segments (internal).
+
+  @param   path Log file path prefix.
+  @param   segments Where to store pointer to segment array allocated by os_malloc().
+           Release by os_free(*segments, *n_segments * sizeof(iocRecorderSegment)).
+  @param   n_segments Where to store number of segments.
+  @return  OSAL_SUCCESS if head file was read and contains at least one segment.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_recorder_load_head(
+    const os_char *path,
+    iocRecorderSegment **segments,
+    os_int *n_segments)
+{
+    os_char fname[OSAL_PATH_SZ];
+    os_uchar *buf, *p;
+    os_memsz n_read;
+    os_int n, i;
+    osalStatus s = OSAL_STATUS_READING_FILE_FAILED;
+
+    *segments = OS_NULL;
+    *n_segments = 0;
+
+    os_strncpy(fname, path, sizeof(fname));
+    os_strncat(fname, ".tsh", sizeof(fname));
+    buf = (os_uchar*)os_read_file_alloc(fname, &n_read, OS_FILE_DEFAULT);
+    if (buf == OS_NULL) return s;
+
+    if (n_read < IOC_RECORDER_HEAD_HDR_SZ || os_memcmp(buf, "IOTH", 4)) goto getout;
+    n = (os_int)ioc_recorder_get(buf + 4, 4);
+    if (n <= 0 || IOC_RECORDER_HEAD_HDR_SZ + (os_memsz)n * IOC_RECORDER_HEAD_ENTRY_SZ > n_read)
+    {
+        goto getout;
+    }
+
+    *segments = (iocRecorderSegment*)os_malloc(n * sizeof(iocRecorderSegment), OS_NULL);
+    if (*segments == OS_NULL) goto getout;
+    p = buf + IOC_RECORDER_HEAD_HDR_SZ;
+    for (i = 0; i < n; i++)
+    {
+        (*segments)[i].seq = (os_uint)ioc_recorder_get(p, 4);
+        (*segments)[i].first_timestamp = (os_int64)ioc_recorder_get(p + 4, 8);
+        p += IOC_RECORDER_HEAD_ENTRY_SZ;
+    }
+    *n_segments = n;
+    s = OSAL_SUCCESS;
+
+getout:
+    os_free(buf, n_read);
+    return s;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Open recorded log for reading.
+  @anchor ioc_open_recording
+
+  The ioc_open_recording() function reads list of segments and positions the reader at
+  the first record of the oldest segment. Log can be read while it is being recorded,
+  records written after a segment was loaded are not seen.
+
+  @param   r Pointer to reader structure to set up.
+  @param   path Log file path prefix, as given to ioc_start_mblk_recorder().
+  @return  OSAL_SUCCESS if successful. Other values indicate that there is no log.
+
+****************************************************************************************************
+*/
+osalStatus ioc_open_recording(
+    iocRecordingReader *r,
+    const os_char *path)
+{
+    osalStatus s;
+
+    os_memclear(r, sizeof(iocRecordingReader));
+    os_strncpy(r->path, path, OSAL_PATH_SZ);
+    r->segment_ix = -1;
+
+    s = ioc_recorder_load_head(path, &r->segments, &r->n_segments);
+    if (s) return s;
+
+    return ioc_recording_load_segment(r, 0);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Move read position to the first record at or after time stamp.
+  @anchor ioc_seek_recording
+
+  The ioc_seek_recording() function selects segment by first time stamps in head file and
+  uses segment's index to skip most of the records before the time stamp.
+
+  To reconstruct memory block content at given time, start reading from the snapshot at
+  the beginning of the segment instead, by seeking to the segment's first time stamp.
+
+  @param   r Pointer to log reader.
+  @param   timestamp Time stamp, microseconds since 1.1.1970 UTC.
+  @return  OSAL_SUCCESS if record was found, OSAL_END_OF_FILE if there are no records at or
+           after the time stamp. Other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus ioc_seek_recording(
+    iocRecordingReader *r,
+    os_int64 timestamp)
+{
+    os_char fname[OSAL_PATH_SZ];
+    os_uchar *ibuf, *p;
+    os_memsz n_read, pos;
+    os_int lo, hi, mid, ix;
+    iocRecord record;
+    osalStatus s;
+
+    if (r->n_segments <= 0) return OSAL_END_OF_FILE;
+
+    /* Find the last segment which begins at or before time stamp.
+     */
+    lo = 0;
+    hi = r->n_segments - 1;
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1) >> 1;
+        if (r->segments[mid].first_timestamp <= timestamp) lo = mid;
+        else hi = mid - 1;
+    }
+    ix = lo;
+
+    s = ioc_recording_load_segment(r, ix);
+    if (s) return s;
+
+    /* Use index to find position of the last indexed record before time stamp.
+     */
+    ioc_recorder_file_name(r->path, r->segments[ix].seq, ".tsi", fname, sizeof(fname));
+    ibuf = (os_uchar*)os_read_file_alloc(fname, &n_read, OS_FILE_DEFAULT);
+    if (ibuf)
+    {
+        lo = 0;
+        hi = (os_int)(n_read / IOC_RECORDER_INDEX_ENTRY_SZ) - 1;
+        pos = -1;
+        while (lo <= hi)
+        {
+            mid = (lo + hi) >> 1;
+            p = ibuf + (os_memsz)mid * IOC_RECORDER_INDEX_ENTRY_SZ;
+            if ((os_int64)ioc_recorder_get(p, 8) < timestamp)
+            {
+                pos = (os_memsz)ioc_recorder_get(p + 8, 4);
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+        if (pos >= IOC_RECORDER_SEGMENT_HDR_SZ && pos < r->seg_n) r->pos = pos;
+        os_free(ibuf, n_read);
+    }
+
+    /* Scan forward to the first record at or after time stamp.
+     */
+    while (OS_TRUE)
+    {
+        pos = r->pos;
+        ix = r->segment_ix;
+        s = ioc_read_recording(r, &record);
+        if (s) return s;
+        if (record.timestamp >= timestamp) break;
+    }
+
+    /* Step back so that the record found is read next.
+     */
+    if (r->segment_ix != ix)
+    {
+        s = ioc_recording_load_segment(r, ix);
+        if (s) return s;
+    }
+    r->pos = pos;
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Read next record.
+  @anchor ioc_read_recording
+
+  The ioc_read_recording() function reads the next record from loaded segment, and moves
+  to next segment when the end is reached.
+
+  @param   r Pointer to log reader.
+  @param   record Where to store the record. Data pointer is valid until next call.
+  @return  OSAL_SUCCESS if record was read, OSAL_END_OF_FILE if there are no more records.
+           Other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus ioc_read_recording(
+    iocRecordingReader *r,
+    iocRecord *record)
+{
+    const os_uchar *p;
+    os_ulong u;
+    osalStatus s;
+
+    while (r->seg == OS_NULL || r->pos + IOC_RECORDER_RECORD_HDR_SZ > r->seg_n)
+    {
+        if (r->segment_ix + 1 >= r->n_segments) return OSAL_END_OF_FILE;
+        s = ioc_recording_load_segment(r, r->segment_ix + 1);
+        if (s) return s;
+    }
+
+    p = (const os_uchar*)r->seg + r->pos;
+    record->timestamp = (os_int64)ioc_recorder_get(p, 8);
+    record->addr = (os_int)ioc_recorder_get(p + 8, 4);
+    u = ioc_recorder_get(p + 12, 4);
+    record->n = (os_int)(u & IOC_RECORDER_MAX_RECORD_SZ);
+    record->flags = (os_int)(u >> 24);
+    record->data = (const os_char*)p + IOC_RECORDER_RECORD_HDR_SZ;
+
+    /* Partially written record at end of segment being recorded.
+     */
+    if (r->pos + IOC_RECORDER_RECORD_HDR_SZ + record->n > r->seg_n)
+    {
+        r->pos = r->seg_n;
+        return ioc_read_recording(r, record);
+    }
+
+    r->pos += IOC_RECORDER_RECORD_HDR_SZ + record->n;
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Close log reader.
+  @anchor ioc_close_recording
+
+  The ioc_close_recording() function releases memory allocated by the reader.
+
+  @param   r Pointer to log reader.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_close_recording(
+    iocRecordingReader *r)
+{
+    ioc_recording_unload_segment(r);
+    if (r->segments) os_free(r->segments, r->n_segments * sizeof(iocRecorderSegment));
+    os_memclear(r, sizeof(iocRecordingReader));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Load segment file into memory (internal).
+
+  On Linux the segment file is memory mapped read only, so that seeking within a large
+  segment doesn't copy it first. Elsewhere the file is read into allocated buffer.
+
+  @param   r Pointer to log reader.
+  @param   segment_ix Index in reader's segment array.
+  @return  OSAL_SUCCESS if successful. Missing segment (deleted by rotation) is skipped.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_recording_load_segment(
+    iocRecordingReader *r,
+    os_int segment_ix)
+{
+    os_char fname[OSAL_PATH_SZ];
+
+    ioc_recording_unload_segment(r);
+
+    for (; segment_ix < r->n_segments; segment_ix++)
+    {
+        r->segment_ix = segment_ix;
+        ioc_recorder_file_name(r->path, r->segments[segment_ix].seq, ".tsl",
+            fname, sizeof(fname));
+        r->seg = ioc_recording_map_segment(fname, &r->seg_n);
+        if (r->seg == OS_NULL) continue;
+
+        if (r->seg_n >= IOC_RECORDER_SEGMENT_HDR_SZ && !os_memcmp(r->seg, "IOTS", 4))
+        {
+            r->pos = IOC_RECORDER_SEGMENT_HDR_SZ;
+            return OSAL_SUCCESS;
+        }
+        ioc_recording_unload_segment(r);
+    }
+
+    return OSAL_END_OF_FILE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Map or read segment file (internal).
+
+  @param   fname Segment file path.
+  @param   n Pointer where to store file size in bytes.
+  @return  Pointer to file content, OS_NULL if file could not be opened or is empty.
+           Release by ioc_recording_unload_segment().
+
+****************************************************************************************************
+*/
+static os_char *ioc_recording_map_segment(
+    const os_char *fname,
+    os_memsz *n)
+{
+#if IOC_MBLK_MMAP
+    struct stat st;
+    os_char *addr;
+    int fd;
+
+    *n = 0;
+    fd = open(fname, O_RDONLY);
+    if (fd < 0) return OS_NULL;
+    if (fstat(fd, &st) || st.st_size <= 0)
+    {
+        close(fd);
+        return OS_NULL;
+    }
+
+    /* Mapping stays valid after the file is closed.
+     */
+    addr = (os_char*)mmap(OS_NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == (os_char*)MAP_FAILED) return OS_NULL;
+    *n = (os_memsz)st.st_size;
+    return addr;
+#else
+    return os_read_file_alloc(fname, n, OS_FILE_DEFAULT);
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release loaded segment (internal).
+
+  @param   r Pointer to log reader.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_recording_unload_segment(
+    iocRecordingReader *r)
+{
+    if (r->seg == OS_NULL) return;
+#if IOC_MBLK_MMAP
+    munmap(r->seg, (size_t)r->seg_n);
+#else
+    os_free(r->seg, r->seg_n);
+#endif
+    r->seg = OS_NULL;
+    r->seg_n = 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Make segment or index file name, like "/coderoot/data/tempctrl-000001.tsl" (internal).
+
+****************************************************************************************************
+*/
+static void ioc_recorder_file_name(
+    const os_char *path,
+    os_uint seq,
+    const os_char *ext,
+    os_char *buf,
+    os_memsz buf_sz)
+{
+    os_char nbuf[8];
+    os_int i;
+
+    for (i = 6; i > 0; i--)
+    {
+        nbuf[i] = (os_char)('0' + seq % 10);
+        seq /= 10;
+    }
+    nbuf[0] = '-';
+    nbuf[7] = '\0';
+
+    os_strncpy(buf, path, buf_sz);
+    os_strncat(buf, nbuf, buf_sz);
+    os_strncat(buf, ext, buf_sz);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Store integer as little endian bytes (internal).
+
+****************************************************************************************************
+*/
+static void ioc_recorder_put(
+    os_uchar *p,
+    os_ulong v,
+    os_int nbytes)
+{
+    while (nbytes--)
+    {
+        *(p++) = (os_uchar)v;
+        v >>= 8;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get integer from little endian bytes (internal).
+
+****************************************************************************************************
+*/
+static os_ulong ioc_recorder_get(
+    const os_uchar *p,
+    os_int nbytes)
+{
+    os_ulong v = 0;
+
+    while (nbytes--)
+    {
+        v = (v << 8) | p[nbytes];
+    }
+    return v;
+}
+
+#endif
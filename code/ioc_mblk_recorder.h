@@ -0,0 +1,320 @@
+/**
+
+  @file    ioc_mblk_recorder.h
+  @brief   Time series recording of memory block changes.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Memory block recorder keeps high rate history of received data for diagnosing plant
+  incidents. The recorder is attached to a memory block as IOC_MBLK_CALLBACK_RECEIVE callback.
+  The callback only appends a delta record (time stamp, address range and changed bytes) to
+  a RAM buffer. Recorder's own thread swaps the buffer and writes records to disk, so the
+  receive path never waits for file system. If the RAM buffer is full, records are dropped and
+  the next record written is marked with IOC_RECORD_GAP flag.
+
+  The log is written into numbered segment files. When a segment is full, the oldest segment
+  is deleted if max_segments is reached, and new segment is started. Each segment begins with
+  a snapshot record containing the whole memory block, so a segment can be replayed without
+  the ones before it. Files for path "/coderoot/data/tempctrl":
+  - "/coderoot/data/tempctrl.tsh"        Head: Segment numbers and first time stamps.
+  - "/coderoot/data/tempctrl-000001.tsl" Segment: Header and records.
+  - "/coderoot/data/tempctrl-000001.tsi" Index: Time stamp and position every
+                                         IOC_RECORDER_INDEX_INTERVAL bytes of segment.
+
+  All integers in files are little endian. Time stamps are microseconds since 1.1.1970 UTC.
+  Segment header is "IOTS" and 4 byte version. Record header is 8 byte time stamp, 4 byte
+  address and 4 byte length, whose most significant byte holds record flags. The index entry
+  is 8 byte time stamp and 4 byte position. The head file is "IOTH", 4 byte count and for each
+  segment 4 byte segment number and 8 byte first time stamp.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_MBLK_RECORDER_H_
+#define IOC_MBLK_RECORDER_H_
+#include "iocom.h"
+
+#if IOC_MBLK_RECORDER
+
+/* Default RAM buffer size in bytes. There are two buffers, one being filled by receive
+   callback and one being written to disk.
+ */
+#ifndef IOC_RECORDER_BUF_SZ
+#define IOC_RECORDER_BUF_SZ (256 * 1024)
+#endif
+
+/* Default segment file size and number of segment files to keep.
+ */
+#ifndef IOC_RECORDER_SEGMENT_SZ
+#define IOC_RECORDER_SEGMENT_SZ (16 * 1024 * 1024)
+#endif
+#ifndef IOC_RECORDER_MAX_SEGMENTS
+#define IOC_RECORDER_MAX_SEGMENTS 16
+#endif
+
+/* Index entry is written every IOC_RECORDER_INDEX_INTERVAL bytes of segment.
+ */
+#ifndef IOC_RECORDER_INDEX_INTERVAL
+#define IOC_RECORDER_INDEX_INTERVAL 65536
+#endif
+
+/* How often recorder thread writes records to disk, ms. Writing is triggered sooner
+   if RAM buffer gets half full.
+ */
+#ifndef IOC_RECORDER_FLUSH_MS
+#define IOC_RECORDER_FLUSH_MS 200
+#endif
+
+/* Sizes of file structures.
+ */
+#define IOC_RECORDER_SEGMENT_HDR_SZ 8
+#define IOC_RECORDER_RECORD_HDR_SZ 16
+#define IOC_RECORDER_INDEX_ENTRY_SZ 12
+#define IOC_RECORDER_HEAD_HDR_SZ 8
+#define IOC_RECORDER_HEAD_ENTRY_SZ 12
+#define IOC_RECORDER_MAX_RECORD_SZ 0xFFFFFF
+
+/* Record flags.
+ */
+#define IOC_RECORD_SNAPSHOT 1   /* Record contains whole memory block */
+#define IOC_RECORD_GAP 2        /* Records have been dropped before this one */
+
+
+/**
+****************************************************************************************************
+    Parameters for ioc_start_mblk_recorder(). Clear with os_memclear(), zero is default.
+****************************************************************************************************
+*/
+typedef struct iocRecorderParams
+{
+    /** Path and file name prefix of log files, like "/coderoot/data/tempctrl".
+     */
+    const os_char *path;
+
+    /** Segment file size in bytes, 0 for IOC_RECORDER_SEGMENT_SZ.
+     */
+    os_memsz segment_sz;
+
+    /** Maximum number of segment files to keep, 0 for IOC_RECORDER_MAX_SEGMENTS.
+     */
+    os_int max_segments;
+
+    /** RAM buffer size in bytes, 0 for IOC_RECORDER_BUF_SZ.
+     */
+    os_memsz buf_sz;
+}
+iocRecorderParams;
+
+
+/**
+****************************************************************************************************
+    Recorder statistics, see ioc_get_mblk_recorder_stats().
+****************************************************************************************************
+*/
+typedef struct iocRecorderStats
+{
+    /** Number of records and data bytes captured.
+     */
+    os_long records;
+    os_long bytes;
+
+    /** Number of records dropped because RAM buffer was full.
+     */
+    os_long dropped;
+
+    /** Number of records written to disk.
+     */
+    os_long written;
+}
+iocRecorderStats;
+
+
+/**
+****************************************************************************************************
+    Segment list item.
+****************************************************************************************************
+*/
+typedef struct iocRecorderSegment
+{
+    os_uint seq;
+    os_int64 first_timestamp;
+}
+iocRecorderSegment;
+
+
+/**
+****************************************************************************************************
+    Memory block recorder object.
+****************************************************************************************************
+*/
+typedef struct iocMblkRecorder
+{
+    /** Handle to recorded memory block and pointer to root object.
+     */
+    iocHandle handle;
+    iocRoot *root;
+
+    /** Log file path prefix, segment size and number of segments to keep.
+     */
+    os_char path[OSAL_PATH_SZ];
+    os_memsz segment_sz;
+    os_int max_segments;
+
+    /** RAM buffers, protected by ioc_lock(). Receive callback appends to fill_buf,
+        recorder thread writes write_buf to disk.
+     */
+    os_char *fill_buf;
+    os_char *write_buf;
+    os_memsz buf_sz;
+    os_memsz fill_n;
+
+    /** Records have been dropped, mark next record with IOC_RECORD_GAP.
+     */
+    os_boolean gap;
+
+    /** Statistics, protected by ioc_lock().
+     */
+    iocRecorderStats stats;
+
+    /** Recorder thread only: Copy of memory block content as written to disk, used
+        to write snapshot record at beginning of each segment.
+     */
+    os_char *image;
+    os_memsz image_sz;
+
+    /** Recorder thread only: Current segment and index files.
+     */
+    osalStream segment;
+    osalStream index;
+    os_memsz segment_n;
+    os_memsz next_index_pos;
+
+    /** Recorder thread only: Segments on disk, oldest first.
+     */
+    iocRecorderSegment *segments;
+    os_int n_segments;
+
+    /** Recorder thread.
+     */
+    osalThread *thread;
+    osalEvent trig;
+    volatile os_boolean stop_thread;
+}
+iocMblkRecorder;
+
+
+/**
+****************************************************************************************************
+    Record read from log by ioc_read_recording().
+****************************************************************************************************
+*/
+typedef struct iocRecord
+{
+    /** Time stamp, microseconds since 1.1.1970 UTC.
+     */
+    os_int64 timestamp;
+
+    /** Memory block address of the first byte and number of bytes.
+     */
+    os_int addr;
+    os_int n;
+
+    /** Record flags, IOC_RECORD_SNAPSHOT and IOC_RECORD_GAP.
+     */
+    os_int flags;
+
+    /** Pointer to data, valid until next ioc_read_recording() call.
+     */
+    const os_char *data;
+}
+iocRecord;
+
+
+/**
+****************************************************************************************************
+    Log reader.
+****************************************************************************************************
+*/
+typedef struct iocRecordingReader
+{
+    /** Log file path prefix.
+     */
+    os_char path[OSAL_PATH_SZ];
+
+    /** Segments on disk, oldest first.
+     */
+    iocRecorderSegment *segments;
+    os_int n_segments;
+
+    /** Index of loaded segment in segments array, and loaded segment content. Segment
+        is memory mapped on Linux, otherwise read into allocated buffer.
+     */
+    os_int segment_ix;
+    os_char *seg;
+    os_memsz seg_n;
+
+    /** Read position within loaded segment.
+     */
+    os_memsz pos;
+}
+iocRecordingReader;
+
+
+/**
+****************************************************************************************************
+  Memory block recorder functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Start recording received data of a memory block.
+ */
+iocMblkRecorder *ioc_start_mblk_recorder(
+    iocHandle *mblk_handle,
+    iocRecorderParams *prm);
+
+/* Stop recording, write remaining records to disk and release the recorder.
+ */
+void ioc_stop_mblk_recorder(
+    iocMblkRecorder *rec,
+    iocRecorderStats *stats);
+
+/* Get recorder statistics.
+ */
+void ioc_get_mblk_recorder_stats(
+    iocMblkRecorder *rec,
+    iocRecorderStats *stats);
+
+/* Open recorded log for reading.
+ */
+osalStatus ioc_open_recording(
+    iocRecordingReader *r,
+    const os_char *path);
+
+/* Move read position to the first record at or after time stamp.
+ */
+osalStatus ioc_seek_recording(
+    iocRecordingReader *r,
+    os_int64 timestamp);
+
+/* Read next record.
+ */
+osalStatus ioc_read_recording(
+    iocRecordingReader *r,
+    iocRecord *record);
+
+/* Close log reader.
+ */
+void ioc_close_recording(
+    iocRecordingReader *r);
+
+/*@}*/
+
+#endif
+#endif
@@ -25,6 +25,16 @@
 static os_uint ioc_get_unique_mblk_id(
     iocRoot *root);
 
+static void ioc_mblk_invalidate_sbufs(
+    iocMemoryBlock *mblk,
+    os_int start_addr,
+    os_int end_addr);
+
+#if IOC_DIRTY_LISTS
+static void ioc_mblk_clear_received(
+    iocMemoryBlock *mblk);
+#endif
+
 
 /**
 ****************************************************************************************************
@@ -129,6 +139,13 @@ osalStatus ioc_initialize_memory_block(
         os_memclear(buf, nbytes);
     }
     mblk->local_flags = prm->local_flags;
+#if IOC_MBLK_PRIORITY_SUPPORT
+    mblk->priority = prm->priority;
+    mblk->max_latency_ms = prm->max_latency_ms;
+#endif
+#if IOC_MBLK_COALESCE
+    mblk->send_interval_ms = prm->send_interval_ms;
+#endif
 
 #if IOC_MBLK_SPECIFIC_DEVICE_NAME
     os_strncpy(mblk->device_name, prm->device_name, IOC_NAME_SZ);
@@ -159,6 +176,9 @@ osalStatus ioc_initialize_memory_block(
         root->mblk.first = mblk;
     }
     root->mblk.last = mblk;
+#if IOC_MBLK_INDEX
+    ioc_mblk_index_add(root, mblk);
+#endif
 
     /* Mark memory block structure as initialized memory block object for debugging.
      */
@@ -225,6 +245,10 @@ void ioc_release_memory_block(
      */
     ioc_terminate_handles(&mblk->handle);
 
+#if IOC_DIRTY_LISTS
+    ioc_mblk_clear_received(mblk);
+#endif
+
     /* Release all source buffers.
      */
     while (mblk->sbuf.first)
@@ -239,8 +263,12 @@ void ioc_release_memory_block(
         ioc_release_target_buffer(mblk->tbuf.first);
     }
 
-    /* Remove memory block from linked list.
+    /* Remove memory block from index and linked list.
      */
+#if IOC_MBLK_INDEX
+    ioc_mblk_index_remove(root, mblk);
+    ioc_mblk_index_free_id(root, mblk->mblk_id);
+#endif
     if (mblk->link.prev)
     {
         mblk->link.prev->link.next = mblk->link.next;
@@ -264,6 +292,12 @@ void ioc_release_memory_block(
     {
         ioc_free(root, mblk->buf, mblk->nbytes, IOC_DEFAULT_ALLOC);
     }
+#if IOC_MBLK_MMAP
+    ioc_munmap_mblk(mblk);
+#endif
+#if IOC_MBLK_GENERATIONS
+    ioc_mblk_release_journal(mblk);
+#endif
 
     /* Clear allocated memory indicate that is no longer initialized (for debugging and
        for primitive static allocation schema).
@@ -354,7 +388,8 @@ void ioc_release_dynamic_mblk_if_not_attached(
   @anchor ioc_generate_del_mblk_request
 
   We need to generate "remove memory block" requests for those memory blocks which are to
-  be deleted deleted and have connections "up".
+  be deleted deleted and have connections "up". Connection threads are triggered, so that
+  an idle connection sends the requests without waiting for keep alive.
 
   ioc_lock must be on when calling this function.
 
@@ -387,6 +422,12 @@ void ioc_generate_del_mblk_request(
             if (con->flags & IOC_CONNECT_UP)
             {
                 ioc_add_request_to_remove_mblk(con, sbuf->remote_mblk_id);
+#if OSAL_MULTITHREAD_SUPPORT
+                if (con->worker.trig)
+                {
+                    osal_event_set(con->worker.trig);
+                }
+#endif
             }
         }
     }
@@ -401,6 +442,12 @@ void ioc_generate_del_mblk_request(
             if (con->flags & IOC_CONNECT_UP)
             {
                 ioc_add_request_to_remove_mblk(con, tbuf->remote_mblk_id);
+#if OSAL_MULTITHREAD_SUPPORT
+                if (con->worker.trig)
+                {
+                    osal_event_set(con->worker.trig);
+                }
+#endif
             }
         }
     }
@@ -451,7 +498,7 @@ void ioc_mblk_set_signal_header(
 
   @param   handle Memory block handle.
   @param   param_ix Parameter index. Selects which parameter to get, one of:
-           IOC_DEVICE_NR, or IOC_MBLK_SIZE.
+           IOC_DEVICE_NR, IOC_MBLK_SIZE, IOC_MBLK_PRIORITY or IOC_MBLK_SEND_INTERVAL.
   @return  Parameter value as integer. -1 if cannot be converted to integer.
 
 ****************************************************************************************************
@@ -483,6 +530,18 @@ os_int ioc_memory_block_get_int_param(
             value = mblk->nbytes;
             break;
 
+#if IOC_MBLK_PRIORITY_SUPPORT
+        case IOC_MBLK_PRIORITY:
+            value = mblk->priority;
+            break;
+#endif
+
+#if IOC_MBLK_COALESCE
+        case IOC_MBLK_SEND_INTERVAL:
+            value = mblk->send_interval_ms;
+            break;
+#endif
+
         default:
             value = -1;
             break;
@@ -565,6 +624,21 @@ void ioc_memory_block_get_string_param(
         case IOC_MBLK_SZ:
             value = mblk->nbytes;
             break;
+
+#if IOC_MBLK_PRIORITY_SUPPORT
+        case IOC_MBLK_PRIORITY:
+            value = mblk->priority;
+            break;
+#endif
+
+#if IOC_MBLK_COALESCE
+        case IOC_MBLK_SEND_INTERVAL:
+            value = mblk->send_interval_ms;
+            break;
+#endif
+
+        default:
+            break;
     }
 
     if (value != -1)
@@ -578,6 +652,48 @@ void ioc_memory_block_get_string_param(
 }
 
 
+#if IOC_MBLK_COALESCE
+/**
+****************************************************************************************************
+
+  @brief Set minimum send interval.
+  @anchor ioc_set_mblk_send_interval
+
+  The ioc_set_mblk_send_interval() function limits how often changes to memory block are
+  synchronized for sending. A producer writing at high rate, like a sensor loop at 10 kHz,
+  would otherwise cause a small frame for almost every write. Changes written within the
+  interval are merged and sent as one frame when the interval has elapsed, so latency is
+  bounded by the interval. Key frames are not delayed.
+
+  Postponed changes stay flagged for immediate sync and are sent by the connection once the
+  interval has elapsed. With IOC_TIMER_WHEEL the timer wheel wakes up connection's worker
+  thread on time. Without it, or if the timer cannot be set, changes are sent by the next
+  ioc_run() or connection thread round after the interval.
+
+  @param   handle Memory block handle.
+  @param   send_interval_ms Minimum send interval in milliseconds, 0 to send changes as
+           fast as possible (default).
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_set_mblk_send_interval(
+    iocHandle *handle,
+    os_int send_interval_ms)
+{
+    iocRoot *root;
+    iocMemoryBlock *mblk;
+
+    mblk = ioc_handle_lock_to_mblk(handle, &root);
+    if (mblk == OS_NULL) return;
+    if (send_interval_ms < 0) send_interval_ms = 0;
+    if (send_interval_ms > 0xFFFF) send_interval_ms = 0xFFFF;
+    mblk->send_interval_ms = (os_ushort)send_interval_ms;
+    ioc_unlock(root);
+}
+#endif
+
+
 /**
 ****************************************************************************************************
 
@@ -910,6 +1026,12 @@ void ioc_receive_nolock(
     os_int bitsi, i;
 #endif
 
+#if IOC_DIRTY_LISTS
+    /* All received data is moved now, remove from root's list.
+     */
+    ioc_mblk_clear_received(mblk);
+#endif
+
     /* Ignore data, if we are receiving data into a static memory block?
      */
     if (mblk->flags & IOC_STATIC) return;
@@ -960,6 +1082,9 @@ void ioc_receive_nolock(
 #endif
 
             tbuf->syncbuf.buf_used = OS_FALSE;
+#if IOC_MBLK_GENERATIONS
+            ioc_mblk_record_change(mblk, start_addr, end_addr);
+#endif
 
             ioc_do_callback(mblk, IOC_MBLK_CALLBACK_RECEIVE,
                 start_addr, end_addr);
@@ -1012,10 +1137,10 @@ void ioc_receive_nolock(
                 }
                 else
                 {
-                    ioc_mblk_invalidate(mblk, start_addr, end_addr);
+                    ioc_mblk_invalidate_sbufs(mblk, start_addr, end_addr);
                 }
 #else
-                ioc_mblk_invalidate(mblk, start_addr, end_addr);
+                ioc_mblk_invalidate_sbufs(mblk, start_addr, end_addr);
 #endif
 
             }
@@ -1023,6 +1148,93 @@ void ioc_receive_nolock(
     }
 }
 
+#if IOC_DIRTY_LISTS
+/**
+****************************************************************************************************
+
+  @brief Add memory block to root's list of memory blocks with received data.
+  @anchor ioc_mblk_set_received
+
+  The ioc_mblk_set_received() function is called when received data is stored into memory
+  block's target buffer. ioc_receive_all() processes only memory blocks in this list, instead
+  of looping trough all memory blocks. Does nothing if the memory block is already listed.
+
+  LOCK must be on when calling this function.
+
+  @param   mblk Pointer to memory block structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mblk_set_received(
+    iocMemoryBlock *mblk)
+{
+    iocRoot *root;
+
+    if (mblk->link.received_listed) return;
+    root = mblk->link.root;
+
+    mblk->link.received_next = OS_NULL;
+    mblk->link.received_prev = root->received_mblk.last;
+    if (root->received_mblk.last)
+    {
+        root->received_mblk.last->link.received_next = mblk;
+    }
+    else
+    {
+        root->received_mblk.first = mblk;
+    }
+    root->received_mblk.last = mblk;
+    mblk->link.received_listed = OS_TRUE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remove memory block from root's list of memory blocks with received data.
+  @anchor ioc_mblk_clear_received
+
+  The ioc_mblk_clear_received() function is called when received data has been moved to
+  memory block, or the memory block is released. Does nothing if the memory block is not
+  listed.
+
+  LOCK must be on when calling this function.
+
+  @param   mblk Pointer to memory block structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_mblk_clear_received(
+    iocMemoryBlock *mblk)
+{
+    iocRoot *root;
+
+    if (!mblk->link.received_listed) return;
+    root = mblk->link.root;
+
+    if (mblk->link.received_prev)
+    {
+        mblk->link.received_prev->link.received_next = mblk->link.received_next;
+    }
+    else
+    {
+        root->received_mblk.first = mblk->link.received_next;
+    }
+    if (mblk->link.received_next)
+    {
+        mblk->link.received_next->link.received_prev = mblk->link.received_prev;
+    }
+    else
+    {
+        root->received_mblk.last = mblk->link.received_prev;
+    }
+    mblk->link.received_next = mblk->link.received_prev = OS_NULL;
+    mblk->link.received_listed = OS_FALSE;
+}
+#endif
+
 
 /**
 ****************************************************************************************************
@@ -1058,11 +1270,13 @@ void ioc_do_callback(
     os_int end_addr)
 {
     os_short i;
+    IOC_PERF_VAR(t)
 
     if (mblk == OS_NULL) {
         return;
     }
 
+    IOC_PERF_BEGIN(t)
     for (i = 0; i < IOC_MBLK_MAX_CALLBACK_FUNCS; i++)
     {
         if (mblk->func[i])
@@ -1071,6 +1285,7 @@ void ioc_do_callback(
                 callback_flags, mblk->context[i]);
         }
     }
+    IOC_PERF_END(mblk->link.root, IOC_PERF_CALLBACK, t)
 }
 
 
@@ -1212,6 +1427,37 @@ void ioc_mblk_invalidate(
     iocMemoryBlock *mblk,
     os_int start_addr,
     os_int end_addr)
+{
+#if IOC_MBLK_GENERATIONS
+    ioc_mblk_record_change(mblk, start_addr, end_addr);
+#endif
+    ioc_mblk_invalidate_sbufs(mblk, start_addr, end_addr);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Mark address range of changed values in memory block's source buffers.
+  @anchor ioc_mblk_invalidate_sbufs
+
+  The ioc_mblk_invalidate_sbufs() function marks address range as possibly changed in all
+  source buffers, without recording the change in memory block's generation. Used to echo
+  received data, the change has been recorded already when it was received.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   mblk Pointer to memory block structure.
+  @param   start_addr Beginning address of changes.
+  @param   end_addr End address of changed.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_mblk_invalidate_sbufs(
+    iocMemoryBlock *mblk,
+    os_int start_addr,
+    os_int end_addr)
 {
     iocSourceBuffer *sbuf;
 
@@ -1306,6 +1552,9 @@ osalStatus ioc_resize_mblk(
         ioc_free(root, mblk->buf, mblk->nbytes, IOC_DEFAULT_ALLOC);
     }
     mblk->buf = newbuf;
+#if IOC_MBLK_GENERATIONS
+    ioc_mblk_record_change(mblk, mblk->nbytes, nbytes - 1);
+#endif
     mblk->nbytes = nbytes;
     mblk->buf_allocated = OS_TRUE;
 
@@ -1381,19 +1630,28 @@ static os_uint ioc_get_unique_mblk_id(
     }
 
     /* We run out of numbers. Strange, this can be possible only if special effort is
-       made for this to happen. Handle anyhow.
+       made for this to happen. Handle anyhow: Reuse identifier of released memory block,
+       or try random numbers.
      */
+#if IOC_MBLK_INDEX
+    id = ioc_mblk_index_reuse_id(root);
+    if (id) return id;
+#endif
     count = 100000;
     while (count--)
     {
         id = (os_uint)osal_rand(IOC_MIN_UNIQUE_ID, 0xFFFFFFFFL);
 
+#if IOC_MBLK_INDEX
+        mblk = ioc_mblk_index_find_by_id(root, id);
+#else
         for (mblk = root->mblk.first;
              mblk;
              mblk = mblk->link.next)
         {
             if (id == mblk->mblk_id) break;
         }
+#endif
         if (mblk == OS_NULL) return id;
     }
 
@@ -65,6 +65,15 @@
  */
 #define IOC_MBLK_LOCAL_AUTO_ID 1
 
+/* Memory block send priority classes. When multiple memory blocks have data to send
+   trough the same connection, data of higher priority memory blocks is sent first.
+   Use IOC_MBLK_PRIORITY_HIGH for small latency critical control blocks and
+   IOC_MBLK_PRIORITY_LOW for bulk transfers, like camera images and logs.
+ */
+#define IOC_MBLK_PRIORITY_NORMAL 0
+#define IOC_MBLK_PRIORITY_HIGH 1
+#define IOC_MBLK_PRIORITY_LOW 2
+
 /* Flags for ioc_write_internal().
  */
 #define IOC_SWAP_16 2 /* needs to be number of bytes */
@@ -135,6 +144,25 @@ typedef struct
         Flag IOC_MBLK_LOCAL_AUTO_ID: Device number was automatically generated by this process.
      */
     os_char local_flags;
+
+#if IOC_MBLK_PRIORITY_SUPPORT
+    /** Send priority class: IOC_MBLK_PRIORITY_NORMAL (0), IOC_MBLK_PRIORITY_HIGH or
+        IOC_MBLK_PRIORITY_LOW.
+     */
+    os_char priority;
+
+    /** Maximum latency hint in milliseconds. If data has been waiting to be sent longer
+        than this, it is sent before any other data. Zero if not set.
+     */
+    os_ushort max_latency_ms;
+#endif
+
+#if IOC_MBLK_COALESCE
+    /** Minimum send interval in milliseconds. Changes within the interval are merged
+        into one frame. Zero to send changes as fast as possible.
+     */
+    os_ushort send_interval_ms;
+#endif
 }
 iocMemoryBlockParams;
 
@@ -151,7 +179,9 @@ typedef enum
    IOC_DEVICE_NAME = 2,
    IOC_DEVICE_NR = 3,
    IOC_MBLK_NAME = 4,
-   IOC_MBLK_SZ = 6
+   IOC_MBLK_SZ = 6,
+   IOC_MBLK_PRIORITY = 7,
+   IOC_MBLK_SEND_INTERVAL = 8
 }
 iocMemoryBlockParamIx;
 
@@ -210,6 +240,25 @@ typedef struct
     /** Pointer to the previous memory block in linked list.
      */
     struct iocMemoryBlock *prev;
+
+#if IOC_MBLK_INDEX
+    /** Next memory block in root's memory block index hash chains: By full name, by name
+        without device number (two directional) and by memory block identifier.
+     */
+    struct iocMemoryBlock *name_next;
+    struct iocMemoryBlock *type_next;
+    struct iocMemoryBlock *type_prev;
+    struct iocMemoryBlock *id_next;
+#endif
+
+#if IOC_DIRTY_LISTS
+    /** Next and previous memory block in root's list of memory blocks with received
+        data, and flag indicating that this memory block is in the list.
+     */
+    struct iocMemoryBlock *received_next;
+    struct iocMemoryBlock *received_prev;
+    os_boolean received_listed;
+#endif
 }
 iocMemoryBlockLink;
 
@@ -289,6 +338,29 @@ typedef struct iocMemoryBlock
      */
     os_char local_flags;
 
+#if IOC_MBLK_PRIORITY_SUPPORT
+    /** Send priority class, IOC_MBLK_PRIORITY_NORMAL, IOC_MBLK_PRIORITY_HIGH or
+        IOC_MBLK_PRIORITY_LOW.
+     */
+    os_char priority;
+
+    /** Maximum latency hint in milliseconds, zero if not set.
+     */
+    os_ushort max_latency_ms;
+#endif
+
+#if IOC_MBLK_COALESCE
+    /** Minimum send interval in milliseconds, zero if not set.
+     */
+    os_ushort send_interval_ms;
+
+    /** Number of synchronizations which produced data to send, and number of
+        synchronizations postponed to merge changes within send interval.
+     */
+    os_uint sync_count;
+    os_uint coalesced_count;
+#endif
+
     /** Pointer to data buffer.
      */
     os_char *buf;
@@ -364,6 +436,23 @@ typedef struct iocMemoryBlock
      */
     const struct iocMblkSignalHdr *signal_hdr;
 #endif
+
+#if IOC_MBLK_GENERATIONS
+    /** Generation number, set from root's generation counter whenever memory block
+        data changes.
+     */
+    os_uint generation;
+
+    /** Change journal, OS_NULL if not enabled by ioc_mblk_enable_journal().
+     */
+    struct iocMblkJournal *journal;
+#endif
+
+#if IOC_MBLK_MMAP
+    /** Memory mapping, OS_NULL if buffer is not memory mapped file.
+     */
+    struct iocMblkMmap *mmap;
+#endif
 }
 iocMemoryBlock;
 
@@ -431,6 +520,14 @@ void ioc_memory_block_get_string_param(
     os_char *buf,
     os_memsz buf_sz);
 
+#if IOC_MBLK_COALESCE
+/* Set minimum send interval, merge changes within the interval into one frame.
+ */
+void ioc_set_mblk_send_interval(
+    iocHandle *handle,
+    os_int send_interval_ms);
+#endif
+
 /* Write data to memory block.
  */
 void ioc_write(
@@ -471,6 +568,13 @@ void ioc_receive(
 void ioc_receive_nolock(
     iocMemoryBlock *mblk);
 
+#if IOC_DIRTY_LISTS
+/* Add memory block to root's list of memory blocks with received data (internal).
+ */
+void ioc_mblk_set_received(
+    iocMemoryBlock *mblk);
+#endif
+
 /* Call memory block specific callback function.
  */
 void ioc_do_callback(
@@ -26,6 +26,10 @@
 static iocMemoryBlock *ioc_get_mbinfo_to_send2(
     struct iocConnection *con);
 
+static os_boolean ioc_mbinfo_skip_mblk(
+    struct iocConnection *con,
+    iocMemoryBlock *mblk);
+
 static void ioc_mbinfo_new_sbuf(
     iocConnection *con,
     iocMemoryBlock *mblk,
@@ -92,6 +96,14 @@ void ioc_add_mblk_to_global_mbinfo(
             {
                 con->sinfo.current_mblk = mblk;
             }
+#if OSAL_MULTITHREAD_SUPPORT
+            /* Wake up idle connection thread to send the memory block info.
+             */
+            if (con->worker.trig)
+            {
+                osal_event_set(con->worker.trig);
+            }
+#endif
         }
 
 #if IOC_SERVER2CLOUD_CODE
@@ -164,6 +176,9 @@ void ioc_mbinfo_con_is_closed(
 #if IOC_SERVER2CLOUD_CODE
     con->sinfo.current_cloud_mblk = OS_NULL;
 #endif
+#if IOC_MBINFO_RESUME
+    ioc_mbinfo_resume_con_closed(con);
+#endif
 }
 
 
@@ -192,40 +207,160 @@ struct iocMemoryBlock *ioc_get_mbinfo_to_send(
 
     while ((mblk = ioc_get_mbinfo_to_send2(con)))
     {
-#if IOC_SERVER2CLOUD_CODE
-        if (con->flags & IOC_CLOUD_CONNECTION)
+        if (!ioc_mbinfo_skip_mblk(con, mblk))
         {
-            if (mblk->flags & IOC_NO_CLOUD) goto skipit;
-        }
-        else
-        {
-            if (mblk->flags & IOC_CLOUD_ONLY) goto skipit;
+            if (con->flags & IOC_CONNECT_UP) break;
+            if ((mblk->flags & IOC_FLOOR) == 0) break;
         }
+        ioc_mbinfo_sent(con, mblk);
+    }
+
+    return mblk;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check if memory block information is not to be sent trough the connection.
+  @anchor ioc_mbinfo_skip_mblk
+
+  The ioc_mbinfo_skip_mblk() function checks cloud flags and network authorization.
+
+  ioc_lock() must be on when this function is called.
+
+  @param   con Pointer to the connection object.
+  @param   mblk Pointer to the memory block object.
+  @return  OS_TRUE if memory block information is not sent trough this connection.
+
+****************************************************************************************************
+*/
+static os_boolean ioc_mbinfo_skip_mblk(
+    struct iocConnection *con,
+    iocMemoryBlock *mblk)
+{
+#if IOC_SERVER2CLOUD_CODE
+    if (con->flags & IOC_CLOUD_CONNECTION)
+    {
+        if (mblk->flags & IOC_NO_CLOUD) return OS_TRUE;
+    }
+    else
+    {
+        if (mblk->flags & IOC_CLOUD_ONLY) return OS_TRUE;
+    }
 #endif
 
 #if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
 #if IOC_MBLK_SPECIFIC_DEVICE_NAME
-        /* If network is not authorized, just drop skip the memory block.
-         */
-        if (!ioc_is_network_authorized(con, mblk->network_name, 0))
-        {
-            goto skipit;
-        }
+    /* If network is not authorized, just drop skip the memory block.
+     */
+    if (!ioc_is_network_authorized(con, mblk->network_name, 0))
+    {
+        return OS_TRUE;
+    }
 #endif
 #endif
 
-        if (con->flags & IOC_CONNECT_UP) break;
-        if ((mblk->flags & IOC_FLOOR) == 0) break;
-#if IOC_SERVER2CLOUD_CODE
-skipit:
+    return OS_FALSE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get memory block information as sent trough a connection.
+  @anchor ioc_make_mbinfo
+
+  The ioc_make_mbinfo() function fills in memory block information structure with the
+  values which are placed in memory block information frame. If we are sending to device
+  with automatic device number, device number is marked with IOC_TO_AUTO_DEVICE_NR.
+
+  ioc_lock() must be on when this function is called.
+
+  @param   con Pointer to the connection object.
+  @param   mblk Pointer to the memory block object.
+  @param   info Pointer to structure to fill in.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_make_mbinfo(
+    struct iocConnection *con,
+    struct iocMemoryBlock *mblk,
+    iocMemoryBlockInfo *info)
+{
+    os_memclear(info, sizeof(iocMemoryBlockInfo));
+    info->mblk_id = mblk->mblk_id;
+#if IOC_MBLK_SPECIFIC_DEVICE_NAME
+    info->device_nr = mblk->device_nr;
+    os_strncpy(info->device_name, mblk->device_name, IOC_NAME_SZ);
+    os_strncpy(info->network_name, mblk->network_name, IOC_NETWORK_NAME_SZ);
+#else
+    info->device_nr = con->link.root->device_nr;
+    os_strncpy(info->device_name, con->link.root->device_name, IOC_NAME_SZ);
+    os_strncpy(info->network_name, con->link.root->network_name, IOC_NETWORK_NAME_SZ);
 #endif
-        ioc_mbinfo_sent(con, mblk);
+    if (info->device_nr > IOC_AUTO_DEVICE_NR)
+    {
+        if (info->device_nr == con->auto_device_nr && (mblk->local_flags & IOC_MBLK_LOCAL_AUTO_ID))
+        {
+            info->device_nr = IOC_TO_AUTO_DEVICE_NR;
+        }
     }
 
-    return mblk;
+    /* Network name is sent only together with device name.
+     */
+    if (info->device_name[0] == '\0')
+    {
+        info->network_name[0] = '\0';
+    }
+    info->nbytes = mblk->nbytes;
+    info->flags = (os_ushort)mblk->flags;
+    os_strncpy(info->mblk_name, mblk->mblk_name, IOC_NAME_SZ);
 }
 
 
+#if IOC_MBINFO_RESUME
+/**
+****************************************************************************************************
+
+  @brief Calculate digest of memory block information to send upwards.
+  @anchor ioc_mbinfo_layout_digest
+
+  The ioc_mbinfo_layout_digest() function calculates digest over memory block information
+  which would be sent trough upwards connection, in the same order as it would be sent.
+
+  ioc_lock() must be on when this function is called.
+
+  @param   con Pointer to the connection object.
+  @return  Digest, 0 if there is no memory block information to send.
+
+****************************************************************************************************
+*/
+os_uint ioc_mbinfo_layout_digest(
+    struct iocConnection *con)
+{
+    iocMemoryBlock *mblk;
+    iocMemoryBlockInfo info;
+    os_uint digest;
+    os_boolean any;
+
+    digest = IOC_MBINFO_DIGEST_INIT;
+    any = OS_FALSE;
+    for (mblk = con->link.root->mblk.first; mblk; mblk = mblk->link.next)
+    {
+        if (ioc_mbinfo_skip_mblk(con, mblk)) continue;
+        ioc_make_mbinfo(con, mblk, &info);
+        digest = ioc_mbinfo_digest(digest, &info);
+        any = OS_TRUE;
+    }
+
+    if (!any) return 0;
+    return digest ? digest : 1;
+}
+#endif
+
+
 
 /**
 ****************************************************************************************************
@@ -398,7 +533,6 @@ osalStatus ioc_process_received_mbinfo_frame(
     os_uint mblk_id,
     os_char *data)
 {
-    iocRoot *root;
     iocMemoryBlockInfo mbinfo;
     os_uchar
         iflags,
@@ -429,12 +563,42 @@ osalStatus ioc_process_received_mbinfo_frame(
             return OSAL_STATUS_FAILED;
     }
 
-    /* If we received message from device which requires automatically given
-       device number in controller end (not auto eumerated device) device,
-       give the number now.
-     */
+#if IOC_MBINFO_RESUME
+    ioc_mbinfo_resume_collect(con, &mbinfo);
+#endif
+    ioc_mbinfo_assign_device_nr(con, &mbinfo);
+    ioc_mbinfo_received(con, &mbinfo);
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Convert device number in received memory block information.
+  @anchor ioc_mbinfo_assign_device_nr
+
+  The ioc_mbinfo_assign_device_nr() function is called for received memory block
+  information before it is processed. If we received message from device which requires
+  automatically given device number in controller end (not auto eumerated device) device,
+  the number is given now.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   con Pointer to the connection object.
+  @param   info Received memory block information, modified.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_mbinfo_assign_device_nr(
+    struct iocConnection *con,
+    iocMemoryBlockInfo *info)
+{
+    iocRoot *root;
+
     root = con->link.root;
-    if (mbinfo.device_nr == IOC_AUTO_DEVICE_NR)
+    if (info->device_nr == IOC_AUTO_DEVICE_NR)
     {
         /* If we do not have automatic device number, reserve one now
          */
@@ -446,21 +610,18 @@ osalStatus ioc_process_received_mbinfo_frame(
             con->auto_device_nr = ioc_get_automatic_device_nr(root, OS_NULL);
 #endif
         }
-        mbinfo.device_nr = con->auto_device_nr;
-        mbinfo.local_flags = IOC_MBLK_LOCAL_AUTO_ID;
+        info->device_nr = con->auto_device_nr;
+        info->local_flags = IOC_MBLK_LOCAL_AUTO_ID;
     }
 
     /* If this is message to device with automatic device number and this device has
        automatic device number
      */
-    else if (mbinfo.device_nr == IOC_TO_AUTO_DEVICE_NR &&
+    else if (info->device_nr == IOC_TO_AUTO_DEVICE_NR &&
         root->device_nr == IOC_AUTO_DEVICE_NR)
     {
-        mbinfo.device_nr = IOC_AUTO_DEVICE_NR;
+        info->device_nr = IOC_AUTO_DEVICE_NR;
     }
-
-    ioc_mbinfo_received(con, &mbinfo);
-    return OSAL_SUCCESS;
 }
 
 
@@ -520,90 +681,95 @@ void ioc_mbinfo_received(
 #endif
 
     /* Find if we have memory block with device name, number and memory block
-       number. If not, do nothing.
+       number. Compare memory block, device and network names, all must match.
      */
-    mblk = root->mblk.first;
-    while (OS_TRUE)
+#if IOC_MBLK_INDEX
+    mblk = ioc_mblk_index_find(root, info->network_name, info->device_name,
+        info->device_nr, info->mblk_name);
+#else
+    for (mblk = root->mblk.first;
+         mblk;
+         mblk = mblk->link.next)
     {
-        if (mblk == OS_NULL)
-        {
-            osal_trace_str("~MBINFO received, dev name=", info->device_name);
-            osal_trace_int("~, dev nr=", info->device_nr);
-            osal_trace_str("~, net name=", info->network_name);
-            osal_trace_str(", mblk name=", info->mblk_name);
+        if (os_strcmp(info->mblk_name, mblk->mblk_name)) continue;
+#if IOC_MBLK_SPECIFIC_DEVICE_NAME
+        if (info->device_nr != mblk->device_nr) continue;
+        if (os_strcmp(info->device_name, mblk->device_name)) continue;
+        if (os_strcmp(info->network_name, mblk->network_name)) continue;
+#else
+        if (info->device_nr != root->device_nr) continue;
+        if (os_strcmp(info->device_name, root->device_name)) continue;
+        if (os_strcmp(info->network_name, root->network_name)) continue;
+#endif
+        break;
+    }
+#endif
+
+    if (mblk == OS_NULL)
+    {
+        osal_trace_str("~MBINFO received, dev name=", info->device_name);
+        osal_trace_int("~, dev nr=", info->device_nr);
+        osal_trace_str("~, net name=", info->network_name);
+        osal_trace_str(", mblk name=", info->mblk_name);
 
 #if IOC_DYNAMIC_MBLK_CODE
-            /* If we can allocate memory blocks dynamically.
-             */
-            if (con->flags & IOC_DYNAMIC_MBLKS)
-            {
-                os_memclear(&mbprm, sizeof(mbprm));
-                mbprm.network_name = info->network_name;
-                mbprm.device_name = info->device_name;
-                mbprm.device_nr = info->device_nr;
-                mbprm.flags = (info->flags & (IOC_MBLK_DOWN|IOC_MBLK_UP))
-                    | (IOC_ALLOW_RESIZE|IOC_DYNAMIC);
-                mbprm.local_flags = info->local_flags;
-                mbprm.mblk_name = info->mblk_name;
-                mbprm.nbytes = info->nbytes;
-
-                if (ioc_initialize_memory_block(&handle, OS_NULL, root, &mbprm)) return;
-                mblk = handle.mblk;
-
-                /* If we are maintaining dynamic information, create dynamic information
-                   structures for network and memory block already now.
-                 */
-                if (root->droot)
-                {
-                    dnetwork = ioc_add_dynamic_network(root->droot, mbprm.network_name);
-
-                    if (ioc_find_mblk_shortcut(dnetwork, mbprm.mblk_name,
-                        mbprm.device_name, mbprm.device_nr) == OS_NULL)
-                    {
-                        ioc_add_mblk_shortcut(dnetwork, mblk);
-                    }
-
-                    /* If this is info memory block, add callback to receive dynamic info.
-                     */
-                    if (!os_strcmp(mblk->mblk_name, "info"))
-                    {
-                        ioc_add_callback(&mblk->handle, ioc_mbinfo_info_callback, OS_NULL);
-                    }
-                }
-
-                ioc_new_root_event(root, IOC_NEW_MEMORY_BLOCK, OS_NULL, mblk,
-                    root->callback_context);
-
-                ioc_release_handle(&handle);
-                break;
-            }
-#endif
+        /* If we can allocate memory blocks dynamically, create the memory block.
+           Otherwise do nothing.
+         */
+        if ((con->flags & IOC_DYNAMIC_MBLKS) == 0)
+        {
             osal_trace2("No matching memory block");
             return;
         }
 
-        /* Compare memory block, device and network names. If same the memory blocks
-           do match. If one end has an empty name, accept it (execpt memory block name).
-           Notice that accepting empty names needs to be treated the same way for
-           both ends.
+        os_memclear(&mbprm, sizeof(mbprm));
+        mbprm.network_name = info->network_name;
+        mbprm.device_name = info->device_name;
+        mbprm.device_nr = info->device_nr;
+        mbprm.flags = (info->flags & (IOC_MBLK_DOWN|IOC_MBLK_UP))
+            | (IOC_ALLOW_RESIZE|IOC_DYNAMIC);
+        mbprm.local_flags = info->local_flags;
+        mbprm.mblk_name = info->mblk_name;
+        mbprm.nbytes = info->nbytes;
+
+        if (ioc_initialize_memory_block(&handle, OS_NULL, root, &mbprm)) return;
+        mblk = handle.mblk;
+
+        /* If we are maintaining dynamic information, create dynamic information
+           structures for network and memory block already now.
          */
-        if (os_strcmp(info->mblk_name, mblk->mblk_name)) goto goon;
-#if IOC_MBLK_SPECIFIC_DEVICE_NAME
-        if (info->device_nr != mblk->device_nr) goto goon;
-        if (os_strcmp(info->device_name, mblk->device_name)) goto goon;
-        if (os_strcmp(info->network_name, mblk->network_name)) goto goon;
+        if (root->droot)
+        {
+            dnetwork = ioc_add_dynamic_network(root->droot, mbprm.network_name);
+
+            if (ioc_find_mblk_shortcut(dnetwork, mbprm.mblk_name,
+                mbprm.device_name, mbprm.device_nr) == OS_NULL)
+            {
+                ioc_add_mblk_shortcut(dnetwork, mblk);
+            }
+
+            /* If this is info memory block, add callback to receive dynamic info.
+             */
+            if (!os_strcmp(mblk->mblk_name, "info"))
+            {
+                ioc_add_callback(&mblk->handle, ioc_mbinfo_info_callback, OS_NULL);
+            }
+        }
+
+        ioc_new_root_event(root, IOC_NEW_MEMORY_BLOCK, OS_NULL, mblk,
+            root->callback_context);
+
+        ioc_release_handle(&handle);
 #else
-        if (info->device_nr != root->device_nr) goto goon;
-        if (os_strcmp(info->device_name, root->device_name)) goto goon;
-        if (os_strcmp(info->network_name, root->network_name)) goto goon;
+        osal_trace2("No matching memory block");
+        return;
 #endif
-
+    }
+    else
+    {
         osal_trace_str("~MBinfo matched, dev name=", info->device_name);
         osal_trace_int("~, dev nr=", info->device_nr);
         osal_trace_str(", mblk name=", info->mblk_name);
-        break;
-goon:
-        mblk = mblk->link.next;
     }
 
 #if IOC_RESIZE_MBLK_CODE
@@ -168,6 +168,20 @@ void ioc_mbinfo_sent(
 void ioc_mbinfo_mblk_is_deleted(
     struct iocMemoryBlock *mblk);
 
+/* Get memory block information as sent trough a connection.
+ */
+void ioc_make_mbinfo(
+    struct iocConnection *con,
+    struct iocMemoryBlock *mblk,
+    iocMemoryBlockInfo *info);
+
+#if IOC_MBINFO_RESUME
+/* Calculate digest of memory block information to send upwards.
+ */
+os_uint ioc_mbinfo_layout_digest(
+    struct iocConnection *con);
+#endif
+
 /* Process memory block information frame received from socket or serial port.
  */
 osalStatus ioc_process_received_mbinfo_frame(
@@ -175,6 +189,12 @@ osalStatus ioc_process_received_mbinfo_frame(
     os_uint mblk_id,
     os_char *data);
 
+/* Convert device number in received memory block information.
+ */
+void ioc_mbinfo_assign_device_nr(
+    struct iocConnection *con,
+    iocMemoryBlockInfo *info);
+
 /* Create source and target buffers according to received memory block information.
  */
 void ioc_mbinfo_received(
@@ -0,0 +1,603 @@
+/**
+
+  @file    ioc_perf_trace.c
+  @brief   Lock contention and hot path tracing.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Call sites are kept in a hash table keyed by __FILE__ pointer and line. The same file
+  name string may have different pointers in different compilation units, this only means
+  that the same site is listed twice. Printing copies trace state under the trace mutex
+  and writes JSON from the copy, so slow output doesn't block traced code.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_PERF_TRACE
+
+/* Names of traced hot path functions, indexed by iocPerfKind.
+ */
+static const os_char *ioc_perf_kind_names[] = {"lock wait", "ioc_lock", "ioc_connection_send",
+    "ioc_connection_receive", "ioc_sbuf_synchronize", "ioc_do_callback"};
+
+/* Forward referred static functions.
+ */
+static os_short ioc_perf_site(
+    iocPerfTrace *perf,
+    const os_char *file,
+    os_int line,
+    os_short kind);
+
+static void ioc_perf_add(
+    iocPerfTrace *perf,
+    os_short site_ix,
+    os_boolean is_wait,
+    os_int64 start_us,
+    os_int64 end_us);
+
+static void ioc_perf_print_histogram(
+    osalStream stream,
+    const os_char *name,
+    iocPerfHistogram *h);
+
+static void ioc_perf_print_int(
+    osalStream stream,
+    const os_char *name,
+    os_long value,
+    os_boolean isfirst);
+
+static const os_char *ioc_perf_basename(
+    const os_char *file);
+
+static iocPerfTrace *ioc_perf_snapshot(
+    iocRoot *root);
+
+
+/**
+****************************************************************************************************
+
+  @brief Allocate performance trace state.
+  @anchor ioc_initialize_perf_trace
+
+  The ioc_initialize_perf_trace() function is called by ioc_initialize_root(). If memory
+  cannot be allocated, tracing is silently disabled for the root.
+
+  @param   root Pointer to the root structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_initialize_perf_trace(
+    iocRoot *root)
+{
+    iocPerfTrace *perf;
+
+    perf = (iocPerfTrace*)os_malloc(sizeof(iocPerfTrace), OS_NULL);
+    if (perf == OS_NULL) return;
+    os_memclear(perf, sizeof(iocPerfTrace));
+    perf->mutex = osal_mutex_create();
+    root->perf = perf;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Free performance trace state.
+  @anchor ioc_release_perf_trace
+
+  The ioc_release_perf_trace() function is called by ioc_release_root() after the root's
+  mutex has been deleted.
+
+  @param   root Pointer to the root structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_perf_trace(
+    iocRoot *root)
+{
+    iocPerfTrace *perf;
+
+    perf = root->perf;
+    if (perf == OS_NULL) return;
+    root->perf = OS_NULL;
+    osal_mutex_delete(perf->mutex);
+    os_free(perf, sizeof(iocPerfTrace));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Record that ioc_lock() acquired the lock.
+  @anchor ioc_perf_lock_acquired
+
+  The ioc_perf_lock_acquired() function is called by ioc_lock() with the root's mutex locked.
+  The outermost lock records time waited and starts timing the hold.
+
+  @param   root Pointer to the root structure.
+  @param   file Source file of the ioc_lock() call.
+  @param   line Source line of the ioc_lock() call.
+  @param   wait_start_us Time before waiting for the mutex, microseconds.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_perf_lock_acquired(
+    iocRoot *root,
+    const os_char *file,
+    os_int line,
+    os_int64 wait_start_us)
+{
+    iocPerfTrace *perf;
+    os_int64 tnow;
+    os_short site_ix;
+
+    perf = root->perf;
+    if (perf == OS_NULL) return;
+    if (perf->lock_depth++) return;
+
+    os_time(&tnow);
+    osal_mutex_lock(perf->mutex);
+    site_ix = ioc_perf_site(perf, file, line, IOC_PERF_LOCK);
+    ioc_perf_add(perf, site_ix, OS_TRUE, wait_start_us, tnow);
+    osal_mutex_unlock(perf->mutex);
+
+    perf->lock_site_ix = site_ix;
+    perf->lock_start_us = tnow;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Record that ioc_unlock() is about to release the lock.
+  @anchor ioc_perf_lock_releasing
+
+  The ioc_perf_lock_releasing() function is called by ioc_unlock() before the root's mutex
+  is unlocked. The outermost unlock records hold time for the call site which locked.
+
+  @param   root Pointer to the root structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_perf_lock_releasing(
+    iocRoot *root)
+{
+    iocPerfTrace *perf;
+    os_int64 tnow;
+
+    perf = root->perf;
+    if (perf == OS_NULL) return;
+    if (perf->lock_depth <= 0 || --perf->lock_depth) return;
+
+    os_time(&tnow);
+    osal_mutex_lock(perf->mutex);
+    ioc_perf_add(perf, perf->lock_site_ix, OS_FALSE, perf->lock_start_us, tnow);
+    osal_mutex_unlock(perf->mutex);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Record time spent in a hot path function.
+  @anchor ioc_perf_record
+
+  The ioc_perf_record() function is used through IOC_PERF_END macro. It can be called
+  with or without ioc_lock().
+
+  @param   root Pointer to the root structure.
+  @param   kind What was timed, like IOC_PERF_SEND.
+  @param   start_us Start time from IOC_PERF_BEGIN, microseconds.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_perf_record(
+    iocRoot *root,
+    iocPerfKind kind,
+    os_int64 start_us)
+{
+    iocPerfTrace *perf;
+    os_int64 tnow;
+    os_short site_ix;
+
+    if (root == OS_NULL) return;
+    perf = root->perf;
+    if (perf == OS_NULL) return;
+
+    os_time(&tnow);
+    osal_mutex_lock(perf->mutex);
+    site_ix = ioc_perf_site(perf, ioc_perf_kind_names[kind], 0, (os_short)kind);
+    ioc_perf_add(perf, site_ix, OS_FALSE, start_us, tnow);
+    osal_mutex_unlock(perf->mutex);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Clear histograms and events.
+  @anchor ioc_perf_clear
+
+  The ioc_perf_clear() function clears collected data, for example before measuring a
+  specific load.
+
+  @param   root Pointer to the root structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_perf_clear(
+    iocRoot *root)
+{
+    iocPerfTrace *perf;
+
+    perf = root->perf;
+    if (perf == OS_NULL) return;
+
+    osal_mutex_lock(perf->mutex);
+    os_memclear(perf->site, sizeof(perf->site));
+    perf->event_pos = 0;
+    perf->event_wrapped = OS_FALSE;
+    osal_mutex_unlock(perf->mutex);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write histograms as JSON.
+  @anchor ioc_perf_print_histograms
+
+  The ioc_perf_print_histograms() function writes wait and hold time histograms of all
+  call sites. Bucket i of "buckets" array counts times under 2^i microseconds.
+
+  @param   root Pointer to the root structure.
+  @param   stream Stream into which to write the JSON.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_perf_print_histograms(
+    iocRoot *root,
+    osalStream stream)
+{
+    iocPerfTrace *snapshot;
+    iocPerfSite *site;
+    os_char nbuf[OSAL_NBUF_SZ];
+    os_int i;
+    os_boolean isfirst;
+
+    snapshot = ioc_perf_snapshot(root);
+    if (snapshot == OS_NULL)
+    {
+        osal_stream_print_str(stream, "{\"error\":\"no trace data\"}\n", 0);
+        return;
+    }
+
+    osal_stream_print_str(stream, "{\"sites\": [\n", 0);
+    isfirst = OS_TRUE;
+    for (i = 0; i < IOC_PERF_MAX_SITES; i++)
+    {
+        site = snapshot->site + i;
+        if (site->file == OS_NULL) continue;
+
+        if (!isfirst) osal_stream_print_str(stream, ",\n", 0);
+        isfirst = OS_FALSE;
+
+        osal_stream_print_str(stream, "{\"site\":\"", 0);
+        osal_stream_print_str(stream, ioc_perf_basename(site->file), 0);
+        if (site->kind == IOC_PERF_LOCK)
+        {
+            osal_int_to_str(nbuf, sizeof(nbuf), site->line);
+            osal_stream_print_str(stream, ":", 0);
+            osal_stream_print_str(stream, nbuf, 0);
+            osal_stream_print_str(stream, "\"", 0);
+            ioc_perf_print_histogram(stream, "wait", &site->wait);
+        }
+        else
+        {
+            osal_stream_print_str(stream, "\"", 0);
+        }
+        ioc_perf_print_histogram(stream, "hold", &site->hold);
+        osal_stream_print_str(stream, "}", 0);
+    }
+    osal_stream_print_str(stream, "\n]}\n", 0);
+
+    os_free(snapshot, sizeof(iocPerfTrace));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write events as Chrome trace event JSON.
+  @anchor ioc_perf_print_trace
+
+  The ioc_perf_print_trace() function writes the latest events as complete ("X") events.
+  Each kind of event is shown on its own track: lock waits, lock holds, send, receive,
+  synchronization and callbacks.
+
+  @param   root Pointer to the root structure.
+  @param   stream Stream into which to write the JSON.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_perf_print_trace(
+    iocRoot *root,
+    osalStream stream)
+{
+    iocPerfTrace *snapshot;
+    iocPerfEvent *e;
+    iocPerfSite *site;
+    os_char nbuf[OSAL_NBUF_SZ];
+    os_int i, n, pos, tid;
+
+    snapshot = ioc_perf_snapshot(root);
+    if (snapshot == OS_NULL)
+    {
+        osal_stream_print_str(stream, "{\"traceEvents\":[]}\n", 0);
+        return;
+    }
+
+    osal_stream_print_str(stream, "{\"traceEvents\":[\n", 0);
+
+    /* Name the tracks.
+     */
+    for (tid = 0; tid <= IOC_PERF_CALLBACK; tid++)
+    {
+        osal_stream_print_str(stream, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1", 0);
+        ioc_perf_print_int(stream, "tid", tid, OS_FALSE);
+        osal_stream_print_str(stream, ",\"args\":{\"name\":\"", 0);
+        osal_stream_print_str(stream, ioc_perf_kind_names[tid], 0);
+        osal_stream_print_str(stream, "\"}}", 0);
+        if (tid < IOC_PERF_CALLBACK) osal_stream_print_str(stream, ",\n", 0);
+    }
+
+    /* Events from oldest to newest.
+     */
+    n = snapshot->event_wrapped ? IOC_PERF_TRACE_EVENTS : snapshot->event_pos;
+    pos = snapshot->event_wrapped ? snapshot->event_pos : 0;
+    for (i = 0; i < n; i++)
+    {
+        e = snapshot->event + pos;
+        if (++pos >= IOC_PERF_TRACE_EVENTS) pos = 0;
+        site = snapshot->site + e->site_ix;
+        if (site->file == OS_NULL) continue;
+
+        osal_stream_print_str(stream, ",\n{\"name\":\"", 0);
+        osal_stream_print_str(stream, ioc_perf_basename(site->file), 0);
+        if (site->kind == IOC_PERF_LOCK)
+        {
+            osal_int_to_str(nbuf, sizeof(nbuf), site->line);
+            osal_stream_print_str(stream, ":", 0);
+            osal_stream_print_str(stream, nbuf, 0);
+        }
+        osal_stream_print_str(stream, "\",\"ph\":\"X\",\"pid\":1", 0);
+        ioc_perf_print_int(stream, "tid", e->is_wait ? 0 : site->kind, OS_FALSE);
+        ioc_perf_print_int(stream, "ts", (os_long)e->ts_us, OS_FALSE);
+        ioc_perf_print_int(stream, "dur", e->dur_us, OS_FALSE);
+        osal_stream_print_str(stream, "}", 0);
+    }
+
+    osal_stream_print_str(stream, "\n]}\n", 0);
+    os_free(snapshot, sizeof(iocPerfTrace));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find or add call site (internal).
+
+  Trace mutex must be locked.
+
+  @return  Index of call site in hash table, or 0 if the table is full. Events of sites
+           which do not fit are added to the site at index 0.
+
+****************************************************************************************************
+*/
+static os_short ioc_perf_site(
+    iocPerfTrace *perf,
+    const os_char *file,
+    os_int line,
+    os_short kind)
+{
+    iocPerfSite *site;
+    os_uint ix;
+    os_int count;
+
+    ix = (os_uint)(((os_memsz)file >> 3) * 31u + (os_uint)line * 7919u) % IOC_PERF_MAX_SITES;
+    for (count = 0; count < IOC_PERF_MAX_SITES; count++)
+    {
+        site = perf->site + ix;
+        if (site->file == OS_NULL)
+        {
+            site->file = file;
+            site->line = line;
+            site->kind = kind;
+            return (os_short)ix;
+        }
+        if (site->file == file && site->line == line) return (os_short)ix;
+        if (++ix >= IOC_PERF_MAX_SITES) ix = 0;
+    }
+    return 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add event to histogram and ring buffer (internal).
+
+  Trace mutex must be locked.
+
+****************************************************************************************************
+*/
+static void ioc_perf_add(
+    iocPerfTrace *perf,
+    os_short site_ix,
+    os_boolean is_wait,
+    os_int64 start_us,
+    os_int64 end_us)
+{
+    iocPerfHistogram *h;
+    iocPerfEvent *e;
+    os_int64 d;
+    os_int us, b;
+
+    d = end_us - start_us;
+    if (d < 0) d = 0;
+    us = d > 0x7FFFFFFF ? 0x7FFFFFFF : (os_int)d;
+
+    for (b = 0; b < IOC_PERF_BUCKETS - 1; b++)
+    {
+        if (us < (1 << b)) break;
+    }
+
+    h = is_wait ? &perf->site[site_ix].wait : &perf->site[site_ix].hold;
+    h->count[b]++;
+    h->n++;
+    h->sum_us += us;
+    if (us > h->max_us) h->max_us = us;
+
+    e = perf->event + perf->event_pos;
+    e->ts_us = start_us;
+    e->dur_us = us;
+    e->site_ix = site_ix;
+    e->is_wait = is_wait;
+    if (++perf->event_pos >= IOC_PERF_TRACE_EVENTS)
+    {
+        perf->event_pos = 0;
+        perf->event_wrapped = OS_TRUE;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write one histogram as JSON member (internal).
+
+****************************************************************************************************
+*/
+static void ioc_perf_print_histogram(
+    osalStream stream,
+    const os_char *name,
+    iocPerfHistogram *h)
+{
+    os_int b, last;
+
+    osal_stream_print_str(stream, ",\"", 0);
+    osal_stream_print_str(stream, name, 0);
+    osal_stream_print_str(stream, "\":{", 0);
+    ioc_perf_print_int(stream, "n", h->n, OS_TRUE);
+    ioc_perf_print_int(stream, "sum_us", (os_long)h->sum_us, OS_FALSE);
+    ioc_perf_print_int(stream, "max_us", h->max_us, OS_FALSE);
+
+    /* Leave out empty buckets at the end.
+     */
+    for (last = IOC_PERF_BUCKETS - 1; last > 0; last--)
+    {
+        if (h->count[last]) break;
+    }
+    osal_stream_print_str(stream, ",\"buckets\":[", 0);
+    for (b = 0; b <= last; b++)
+    {
+        ioc_perf_print_int(stream, OS_NULL, h->count[b], (os_boolean)(b == 0));
+    }
+    osal_stream_print_str(stream, "]}", 0);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write integer as JSON member or array item (internal).
+
+  @param   name Member name, OS_NULL for array item.
+  @param   isfirst OS_FALSE to write comma before.
+
+****************************************************************************************************
+*/
+static void ioc_perf_print_int(
+    osalStream stream,
+    const os_char *name,
+    os_long value,
+    os_boolean isfirst)
+{
+    os_char nbuf[OSAL_NBUF_SZ];
+
+    if (!isfirst) osal_stream_print_str(stream, ",", 0);
+    if (name)
+    {
+        osal_stream_print_str(stream, "\"", 0);
+        osal_stream_print_str(stream, name, 0);
+        osal_stream_print_str(stream, "\":", 0);
+    }
+    osal_int_to_str(nbuf, sizeof(nbuf), value);
+    osal_stream_print_str(stream, nbuf, 0);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get file name without path (internal).
+
+  This also keeps Windows path separators out of JSON strings.
+
+****************************************************************************************************
+*/
+static const os_char *ioc_perf_basename(
+    const os_char *file)
+{
+    const os_char *p;
+
+    for (p = file; *p != '\0'; p++)
+    {
+        if (*p == '/' || *p == '\\') file = p + 1;
+    }
+    return file;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Copy trace state (internal).
+
+  @return  Pointer to copy to be freed with os_free(), or OS_NULL if tracing is not
+           active or memory allocation failed.
+
+****************************************************************************************************
+*/
+static iocPerfTrace *ioc_perf_snapshot(
+    iocRoot *root)
+{
+    iocPerfTrace *perf, *snapshot;
+
+    perf = root->perf;
+    if (perf == OS_NULL) return OS_NULL;
+
+    snapshot = (iocPerfTrace*)os_malloc(sizeof(iocPerfTrace), OS_NULL);
+    if (snapshot == OS_NULL) return OS_NULL;
+
+    osal_mutex_lock(perf->mutex);
+    os_memcpy(snapshot, perf, sizeof(iocPerfTrace));
+    osal_mutex_unlock(perf->mutex);
+    return snapshot;
+}
+
+#endif
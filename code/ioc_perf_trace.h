@@ -0,0 +1,233 @@
+/**
+
+  @file    ioc_perf_trace.h
+  @brief   Lock contention and hot path tracing.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Optional compile time instrumentation to find out why a server slows down: ioc_lock()
+  contention, synchronization, socket writes or application callbacks. Enabled by
+  IOC_PERF_TRACE=1 in compiler settings, when disabled the macros below generate no code.
+
+  - ioc_lock() and ioc_handle_lock_to_mblk() record wait and hold times per call site
+    (source file and line). Only the outermost lock of nested ioc_lock() calls is timed.
+  - Time spent in ioc_connection_send(), ioc_connection_receive(), ioc_sbuf_synchronize()
+    and ioc_do_callback() is recorded per function.
+
+  Times are collected to histograms with power of two microsecond buckets, and to a ring
+  buffer of the latest IOC_PERF_TRACE_EVENTS events. ioc_perf_print_histograms() writes
+  histograms as JSON, ioc_perf_print_trace() writes events as Chrome trace event JSON,
+  which can be opened with chrome://tracing or Perfetto UI.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_PERF_TRACE_H_
+#define IOC_PERF_TRACE_H_
+#include "iocom.h"
+
+#if IOC_PERF_TRACE
+
+#if OSAL_MULTITHREAD_SUPPORT == 0
+#error IOC_PERF_TRACE requires OSAL_MULTITHREAD_SUPPORT
+#endif
+
+struct iocRoot;
+
+/* Number of histogram buckets. Bucket 0 counts times under 1 us, bucket i times under
+   2^i us and the last bucket all longer times (8 s and over).
+ */
+#define IOC_PERF_BUCKETS 24
+
+/* Maximum number of traced call sites per root, size of the hash table.
+ */
+#ifndef IOC_PERF_MAX_SITES
+#define IOC_PERF_MAX_SITES 512
+#endif
+
+/* Number of latest events kept for trace dump.
+ */
+#ifndef IOC_PERF_TRACE_EVENTS
+#define IOC_PERF_TRACE_EVENTS 16384
+#endif
+
+/* What is traced, used also as thread id of the trace track.
+ */
+typedef enum iocPerfKind
+{
+    IOC_PERF_LOCK = 1,
+    IOC_PERF_SEND = 2,
+    IOC_PERF_RECEIVE = 3,
+    IOC_PERF_SBUF_SYNC = 4,
+    IOC_PERF_CALLBACK = 5
+}
+iocPerfKind;
+
+
+/**
+****************************************************************************************************
+    Histogram of times, microseconds.
+****************************************************************************************************
+*/
+typedef struct iocPerfHistogram
+{
+    os_uint count[IOC_PERF_BUCKETS];
+    os_uint n;
+    os_int64 sum_us;
+    os_int max_us;
+}
+iocPerfHistogram;
+
+
+/**
+****************************************************************************************************
+    Traced call site. Lock call sites have both wait and hold times, other sites only use
+    the hold histogram for time spent in the function.
+****************************************************************************************************
+*/
+typedef struct iocPerfSite
+{
+    /** Source file (__FILE__) or function name, OS_NULL if the hash slot is unused.
+     */
+    const os_char *file;
+    os_int line;
+    os_short kind;
+
+    iocPerfHistogram wait;
+    iocPerfHistogram hold;
+}
+iocPerfSite;
+
+
+/**
+****************************************************************************************************
+    One event in trace ring buffer.
+****************************************************************************************************
+*/
+typedef struct iocPerfEvent
+{
+    /** Start time, microseconds, and duration.
+     */
+    os_int64 ts_us;
+    os_int dur_us;
+
+    /** Index of call site, and OS_TRUE if this is time waited for the lock.
+     */
+    os_short site_ix;
+    os_boolean is_wait;
+}
+iocPerfEvent;
+
+
+/**
+****************************************************************************************************
+    Performance trace state, allocated by ioc_initialize_root().
+****************************************************************************************************
+*/
+typedef struct iocPerfTrace
+{
+    /** Mutex to protect histograms and the event ring buffer. Hot path functions may
+        be timed outside ioc_lock().
+     */
+    osalMutex mutex;
+
+    /** Call sites, hash table.
+     */
+    iocPerfSite site[IOC_PERF_MAX_SITES];
+
+    /** Event ring buffer, next position to write and OS_TRUE once it has wrapped around.
+     */
+    iocPerfEvent event[IOC_PERF_TRACE_EVENTS];
+    os_int event_pos;
+    os_boolean event_wrapped;
+
+    /** Current ioc_lock() holder: nesting depth, call site index and time when the lock
+        was acquired. Accessed only with root's mutex locked.
+     */
+    os_int lock_depth;
+    os_short lock_site_ix;
+    os_int64 lock_start_us;
+}
+iocPerfTrace;
+
+
+/**
+****************************************************************************************************
+  Macros to time a hot path. These generate no code if IOC_PERF_TRACE is 0.
+****************************************************************************************************
+ */
+#define IOC_PERF_VAR(t) os_int64 t;
+#define IOC_PERF_BEGIN(t) os_time(&t);
+#define IOC_PERF_END(r,k,t) ioc_perf_record((r), (k), t);
+
+
+/**
+****************************************************************************************************
+  Performance trace functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Allocate performance trace state for root, called by ioc_initialize_root().
+ */
+void ioc_initialize_perf_trace(
+    struct iocRoot *root);
+
+/* Free performance trace state, called by ioc_release_root().
+ */
+void ioc_release_perf_trace(
+    struct iocRoot *root);
+
+/* Lock acquired by ioc_lock() at file and line, wait started at wait_start_us.
+ */
+void ioc_perf_lock_acquired(
+    struct iocRoot *root,
+    const os_char *file,
+    os_int line,
+    os_int64 wait_start_us);
+
+/* Lock about to be released by ioc_unlock().
+ */
+void ioc_perf_lock_releasing(
+    struct iocRoot *root);
+
+/* Record time spent in hot path function, started at start_us.
+ */
+void ioc_perf_record(
+    struct iocRoot *root,
+    iocPerfKind kind,
+    os_int64 start_us);
+
+/* Clear histograms and events.
+ */
+void ioc_perf_clear(
+    struct iocRoot *root);
+
+/* Write histograms as JSON to stream.
+ */
+void ioc_perf_print_histograms(
+    struct iocRoot *root,
+    osalStream stream);
+
+/* Write events as Chrome trace event JSON to stream.
+ */
+void ioc_perf_print_trace(
+    struct iocRoot *root,
+    osalStream stream);
+
+/*@}*/
+
+#else
+
+#define IOC_PERF_VAR(t)
+#define IOC_PERF_BEGIN(t)
+#define IOC_PERF_END(r,k,t)
+
+#endif
+#endif
@@ -55,6 +55,9 @@ void ioc_initialize_root(
         root->mutex = osal_mutex_create();
     }
 #endif
+#if IOC_PERF_TRACE
+    ioc_initialize_perf_trace(root);
+#endif
 
     /* Start automatic device enumeration from 10001 and start unique memory block
        identifiers from 8.
@@ -187,11 +190,23 @@ void ioc_release_root(
     {
         ioc_release_memory_block(&root->mblk.first->handle);
     }
+#if IOC_MBLK_INDEX
+    ioc_release_mblk_index(root);
+#endif
+#if IOC_MBINFO_RESUME
+    ioc_release_mbinfo_cache(root);
+#endif
 
     /* End syncronization.
      */
     ioc_unlock(root);
 
+#if IOC_TIMER_WHEEL
+    /* Stop timer wheel thread, no more timers after connections are gone.
+     */
+    ioc_release_timer_wheel(root);
+#endif
+
 #if OSAL_MULTITHREAD_SUPPORT
     /* Delete synchronization mutex.
      */
@@ -199,6 +214,9 @@ void ioc_release_root(
         osal_mutex_delete(root->mutex);
     }
 #endif
+#if IOC_PERF_TRACE
+    ioc_release_perf_trace(root);
+#endif
 
 #if OSAL_DYNAMIC_MEMORY_ALLOCATION
     /* If we allocated pool (fixed size pool, but dynamically allocated,
@@ -336,6 +354,12 @@ void ioc_run(
         }
     }
 
+#if IOC_MBLK_MMAP
+    /* Write changed memory mapped memory blocks to disk.
+     */
+    ioc_sync_mmapped_mblks(root, OS_FALSE);
+#endif
+
     /* End syncronization.
      */
     ioc_unlock(root);
@@ -354,11 +378,28 @@ void ioc_run(
   called by one threads, other threads are paused when they ioc_lock(), until the first
   thread calls ioc_unlock().
 
+  With IOC_PERF_TRACE, ioc_lock() is a macro which calls ioc_lock_at() with source
+  file and line of the call.
+
   @param   root Pointer to the root structure.
   @return  None.
 
 ****************************************************************************************************
 */
+#if IOC_PERF_TRACE
+void ioc_lock_at(
+    iocRoot *root,
+    const os_char *file,
+    os_int line)
+{
+    os_int64 t;
+
+    osal_debug_assert(root->debug_id == 'R');
+    os_time(&t);
+    osal_mutex_lock(root->mutex);
+    ioc_perf_lock_acquired(root, file, line, t);
+}
+#else
 void ioc_lock(
     iocRoot *root)
 {
@@ -366,6 +407,7 @@ void ioc_lock(
     osal_mutex_lock(root->mutex);
 }
 #endif
+#endif
 
 #if OSAL_MULTITHREAD_SUPPORT
 /**
@@ -385,6 +427,9 @@ void ioc_unlock(
     iocRoot *root)
 {
     osal_debug_assert(root->debug_id == 'R');
+#if IOC_PERF_TRACE
+    ioc_perf_lock_releasing(root);
+#endif
     osal_mutex_unlock(root->mutex);
 }
 #endif
@@ -530,7 +575,13 @@ void ioc_set_network_name(
     {
         if (!os_strcmp(mblk->network_name, osal_str_asterisk) || mblk->network_name[0] == '\0')
         {
+#if IOC_MBLK_INDEX
+            ioc_mblk_index_remove(root, mblk);
+#endif
             os_strncpy(mblk->network_name, root->network_name, IOC_NETWORK_NAME_SZ);
+#if IOC_MBLK_INDEX
+            ioc_mblk_index_add(root, mblk);
+#endif
         }
     }
 
@@ -565,6 +616,28 @@ void ioc_set_network_name(
 void ioc_send_all(
     iocRoot *root)
 {
+#if IOC_DIRTY_LISTS
+    iocSourceBuffer *sbuf, *next_sbuf;
+    if (root == OS_NULL) return;
+
+    /* Only source buffers which have been invalidated or need a key frame are in the
+       pending list. Source buffer whose synchronized buffer is still in use stays in
+       the list to be synchronized later.
+     */
+    ioc_lock(root);
+    for (sbuf = root->pending_sbuf.first;
+         sbuf;
+         sbuf = next_sbuf)
+    {
+        next_sbuf = sbuf->plink.next;
+        ioc_sbuf_synchronize(sbuf);
+        if (!sbuf->changed.range_set && !sbuf->syncbuf.make_keyframe)
+        {
+            ioc_sbuf_clear_pending(sbuf);
+        }
+    }
+    ioc_unlock(root);
+#else
     iocMemoryBlock *mblk;
     iocSourceBuffer *sbuf;
     if (root == OS_NULL) return;
@@ -582,6 +655,7 @@ void ioc_send_all(
         }
     }
     ioc_unlock(root);
+#endif
 }
 
 
@@ -605,11 +679,20 @@ void ioc_receive_all(
     iocMemoryBlock *mblk;
 
     ioc_lock(root);
+#if IOC_DIRTY_LISTS
+    /* ioc_receive_nolock() removes the memory block from received list.
+     */
+    while ((mblk = root->received_mblk.first))
+    {
+        ioc_receive_nolock(mblk);
+    }
+#else
     for (mblk = root->mblk.first;
          mblk;
          mblk = mblk->link.next)
     {
         ioc_receive_nolock(mblk);
     }
+#endif
     ioc_unlock(root);
 }
@@ -74,6 +74,26 @@ typedef struct
 iocRootsMemoryBlockList;
 
 
+#if IOC_DIRTY_LISTS
+/**
+****************************************************************************************************
+    Linked list of root's source buffers with changes to send
+****************************************************************************************************
+*/
+typedef struct
+{
+    /** Pointer to the first source buffer in linked list.
+     */
+    struct iocSourceBuffer *first;
+
+    /** Pointer to the last source buffer in linked list.
+     */
+    struct iocSourceBuffer *last;
+}
+iocRootsSourceBufferList;
+#endif
+
+
 /**
 ****************************************************************************************************
     Linked list of root's connections
@@ -170,12 +190,26 @@ typedef struct iocRoot
      */
     iocRootsConnectionList con;
 
+#if IOC_DIRTY_LISTS
+    /** Source buffers with invalidated data or key frame to send, and memory blocks with
+        received data waiting for ioc_receive(). Used by ioc_send_all() and ioc_receive_all().
+     */
+    iocRootsSourceBufferList pending_sbuf;
+    iocRootsMemoryBlockList received_mblk;
+#endif
+
 #if OSAL_SOCKET_SUPPORT
     /** Linked list of root's end points.
      */
     iocRootsEndPointList epoint;
 #endif
 
+#if IOC_TIMER_WHEEL
+    /** Timer wheel for connection timeouts.
+     */
+    iocTimerWheel timer_wheel;
+#endif
+
     /** IO device only: Device name, if this is single IO device. Empty if not set.
      */
     os_char device_name[IOC_NAME_SZ];
@@ -219,6 +253,12 @@ typedef struct iocRoot
     osalMutex mutex;
 #endif
 
+#if IOC_PERF_TRACE
+    /** Lock contention and hot path trace data, OS_NULL if not allocated.
+     */
+    struct iocPerfTrace *perf;
+#endif
+
 #if IOC_ROOT_CALLBACK_SUPPORT
     /** Callback function pointer. OS_NULL if not used.
      */
@@ -237,6 +277,39 @@ typedef struct iocRoot
      */
     os_uint next_unique_mblk_id;
 
+#if IOC_MBLK_GENERATIONS
+    /** Latest memory block generation number, see ioc_mblk_record_change().
+     */
+    os_uint mblk_generation;
+#endif
+
+#if IOC_MBLK_INDEX
+    /** Hash index of memory blocks by names and by memory block identifier.
+     */
+    iocMblkIndex mblk_index;
+#endif
+
+#if IOC_MBINFO_RESUME
+    /** Memory block information received on earlier connections, to skip memory
+        block information exchange on reconnect.
+     */
+    iocMbinfoCache mbinfo_cache;
+#endif
+
+#if IOC_CONNECT_STATS
+    /** Connection setup time histograms.
+     */
+    iocConnectStats connect_stats;
+#endif
+
+#if IOC_MBLK_MMAP
+    /** Number of memory mapped memory blocks and timer when these were last
+        written to disk.
+     */
+    os_int mmap_count;
+    os_timer mmap_sync_timer;
+#endif
+
 #if IOC_DYNAMIC_MBLK_CODE
     /** Pointer to dynamic IO network configuration, if any.
      */
@@ -360,10 +433,21 @@ void ioc_receive_all(
 */
 /*@{*/
 
+#if IOC_PERF_TRACE
+/* Lock the communication object hierarchy, trace wait and hold times of the call site.
+ */
+void ioc_lock_at(
+    iocRoot *root,
+    const os_char *file,
+    os_int line);
+
+#define ioc_lock(r) ioc_lock_at((r), __FILE__, __LINE__)
+#else
 /* Lock the communication object hierarchy.
  */
 void ioc_lock(
     iocRoot *root);
+#endif
 
 /* Unlock the communication object hierarchy.
  */
@@ -0,0 +1,401 @@
+/**
+
+  @file    ioc_sampler.c
+  @brief   Lossless sample history over brick transfer.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_SAMPLER_SUPPORT
+
+
+/**
+****************************************************************************************************
+
+  @brief Initialize sampler.
+  @anchor ioc_initialize_sampler
+
+  The ioc_initialize_sampler() function allocates sample ring and batch buffer. The brick
+  buffer must have been initialized by ioc_initialize_brick_buffer() as sending end.
+  For ring buffer transfer the brick buffer's internal buffer is allocated here if it is
+  not allocated already.
+
+  @param   s Pointer to sampler structure to initialize.
+  @param   brick Brick buffer to send the sample batches.
+  @param   sample_sz Size of one sample, bytes.
+  @param   max_samples Number of samples the ring can hold. This needs to cover samples
+           added while previous batch is being transferred.
+  @return  OSAL_SUCCESS if all is fine. OSAL_STATUS_MEMORY_ALLOCATION_FAILED if memory
+           allocation failed, other values indicate invalid arguments.
+
+****************************************************************************************************
+*/
+osalStatus ioc_initialize_sampler(
+    iocSampler *s,
+    iocBrickBuffer *brick,
+    os_int sample_sz,
+    os_int max_samples)
+{
+    os_memsz space;
+    osalStatus st;
+
+    os_memclear(s, sizeof(iocSampler));
+
+    if (sample_sz < 1 || max_samples < 1 ||
+        sample_sz + IOC_SAMPLE_TSTAMP_SZ > IOC_MAX_BRICK_WIDTH)
+    {
+        osal_debug_error("ioc_sampler: invalid sample size or count");
+        return OSAL_STATUS_FAILED;
+    }
+
+    s->brick = brick;
+    s->sample_sz = sample_sz;
+    s->rec_sz = sample_sz + IOC_SAMPLE_TSTAMP_SZ;
+    s->max_samples = max_samples;
+
+    /* Number of samples which fit into one brick.
+     */
+    s->max_batch = max_samples < IOC_MAX_BRICK_HEIGHT ? max_samples : IOC_MAX_BRICK_HEIGHT;
+    if (brick->signals->flat_buffer)
+    {
+        space = brick->signals->buf->n - (os_memsz)sizeof(iocBrickHdr);
+        if (space < s->rec_sz)
+        {
+            osal_debug_error("ioc_sampler: flat buffer too small for a sample");
+            return OSAL_STATUS_OUT_OF_BUFFER;
+        }
+        if (space / s->rec_sz < s->max_batch)
+        {
+            s->max_batch = (os_int)(space / s->rec_sz);
+        }
+    }
+    else if (brick->buf == OS_NULL)
+    {
+        st = ioc_allocate_brick_buffer(brick,
+            (os_memsz)sizeof(iocBrickHdr) + s->max_batch * (os_memsz)s->rec_sz);
+        if (st) return st;
+    }
+    else if (brick->buf_sz < (os_memsz)sizeof(iocBrickHdr) + s->rec_sz)
+    {
+        osal_debug_error("ioc_sampler: brick buffer too small for a sample");
+        return OSAL_STATUS_OUT_OF_BUFFER;
+    }
+    else
+    {
+        space = brick->buf_sz - (os_memsz)sizeof(iocBrickHdr);
+        if (space / s->rec_sz < s->max_batch)
+        {
+            s->max_batch = (os_int)(space / s->rec_sz);
+        }
+    }
+
+    s->ring = os_malloc(max_samples * (os_memsz)s->rec_sz, &s->ring_alloc_sz);
+    s->batch = os_malloc(s->max_batch * (os_memsz)s->rec_sz, &s->batch_alloc_sz);
+    if (s->ring == OS_NULL || s->batch == OS_NULL)
+    {
+        ioc_release_sampler(s);
+        return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+    }
+
+#if OSAL_MULTITHREAD_SUPPORT
+    s->mutex = osal_mutex_create();
+#endif
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release sampler.
+  @anchor ioc_release_sampler
+
+  The ioc_release_sampler() function frees memory allocated by ioc_initialize_sampler().
+  The brick buffer is not released.
+
+  @param   s Pointer to sampler structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_sampler(
+    iocSampler *s)
+{
+    if (s->ring)
+    {
+        os_free(s->ring, s->ring_alloc_sz);
+        s->ring = OS_NULL;
+    }
+    if (s->batch)
+    {
+        os_free(s->batch, s->batch_alloc_sz);
+        s->batch = OS_NULL;
+    }
+#if OSAL_MULTITHREAD_SUPPORT
+    if (s->mutex)
+    {
+        osal_mutex_delete(s->mutex);
+        s->mutex = OS_NULL;
+    }
+#endif
+    s->count = 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add sample to sampler's ring.
+  @anchor ioc_add_sample
+
+  The ioc_add_sample() function stores time stamp and copy of sample data as a record in
+  sampler's ring. This is typically called from measurement loop or thread at
+  sample rate. If the ring is full the new sample is dropped and counted, samples already
+  in ring are never overwritten.
+
+  @param   s Pointer to sampler structure.
+  @param   data Sample data, sample_sz bytes.
+  @param   tstamp_us Sample time stamp, microseconds. 0 to use current time.
+  @return  OSAL_SUCCESS if sample was stored. OSAL_STATUS_OUT_OF_BUFFER if the ring was
+           full and the sample was dropped.
+
+****************************************************************************************************
+*/
+osalStatus ioc_add_sample(
+    iocSampler *s,
+    const os_char *data,
+    os_int64 tstamp_us)
+{
+    os_uchar *rec;
+    os_int ix, i;
+
+    if (tstamp_us == 0) os_time(&tstamp_us);
+
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_lock(s->mutex);
+#endif
+    s->stats.samples++;
+    if (s->count >= s->max_samples)
+    {
+        s->stats.dropped++;
+#if OSAL_MULTITHREAD_SUPPORT
+        osal_mutex_unlock(s->mutex);
+#endif
+        return OSAL_STATUS_OUT_OF_BUFFER;
+    }
+
+    ix = s->tail + s->count;
+    if (ix >= s->max_samples) ix -= s->max_samples;
+    rec = (os_uchar*)s->ring + ix * (os_memsz)s->rec_sz;
+
+    /* Time stamp least significant byte first, same as in brick header.
+     */
+    for (i = 0; i < IOC_SAMPLE_TSTAMP_SZ; i++)
+    {
+        rec[i] = (os_uchar)(tstamp_us >> (8 * i));
+    }
+    os_memcpy(rec + IOC_SAMPLE_TSTAMP_SZ, data, s->sample_sz);
+    s->count++;
+
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_unlock(s->mutex);
+#endif
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Send accumulated samples and run brick transfer.
+  @anchor ioc_run_sampler
+
+  The ioc_run_sampler() function should be called repeatedly from the sending thread,
+  instead of calling ioc_run_brick_send() directly. When the previous brick has been
+  transferred and there are samples in ring, up to max_batch oldest samples are packed
+  into one uncompressed brick marked as sample batch (IOC_SAMPLES). Samples are removed
+  from the ring only once the brick has been stored for sending, so a failure does not lose
+  them.
+
+  @param   s Pointer to sampler structure.
+  @return  Return value of ioc_run_brick_send() or ioc_compress_brick().
+
+****************************************************************************************************
+*/
+osalStatus ioc_run_sampler(
+    iocSampler *s)
+{
+    iocBrickBuffer *b;
+    iocBrickHdr hdr;
+    os_memsz n1, sz, alloc_sz;
+    os_int n, tail;
+    osalStatus st;
+
+    b = s->brick;
+    if (s->count && ioc_ready_for_new_brick(b))
+    {
+#if OSAL_MULTITHREAD_SUPPORT
+        osal_mutex_lock(s->mutex);
+#endif
+        n = s->count < s->max_batch ? s->count : s->max_batch;
+        tail = s->tail;
+
+        /* Copy records, the batch may wrap around end of the ring.
+         */
+        n1 = s->max_samples - tail;
+        if (n1 > n) n1 = n;
+        os_memcpy(s->batch, s->ring + tail * (os_memsz)s->rec_sz, n1 * s->rec_sz);
+        if (n > n1)
+        {
+            os_memcpy(s->batch + n1 * s->rec_sz, s->ring, (n - n1) * s->rec_sz);
+        }
+#if OSAL_MULTITHREAD_SUPPORT
+        osal_mutex_unlock(s->mutex);
+#endif
+
+        sz = n * (os_memsz)s->rec_sz;
+        alloc_sz = sz + sizeof(iocBrickHdr);
+        os_memclear(&hdr, sizeof(iocBrickHdr));
+        hdr.alloc_sz[0] = (os_uchar)alloc_sz;
+        hdr.alloc_sz[1] = (os_uchar)(alloc_sz >> 8);
+        hdr.alloc_sz[2] = (os_uchar)(alloc_sz >> 16);
+        hdr.alloc_sz[3] = (os_uchar)(alloc_sz >> 24);
+
+        st = ioc_compress_brick(b, &hdr, (os_uchar*)s->batch, sz,
+            OSAL_GRAYSCALE8, s->rec_sz, n, IOC_SAMPLES);
+        if (st) return st;
+
+#if OSAL_MULTITHREAD_SUPPORT
+        osal_mutex_lock(s->mutex);
+#endif
+        s->tail += n;
+        if (s->tail >= s->max_samples) s->tail -= s->max_samples;
+        s->count -= n;
+        s->stats.sent_samples += n;
+        s->stats.sent_bricks++;
+#if OSAL_MULTITHREAD_SUPPORT
+        osal_mutex_unlock(s->mutex);
+#endif
+    }
+
+    return ioc_run_brick_send(b);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get copy of sampler statistics.
+  @anchor ioc_get_sampler_stats
+
+  @param   s Pointer to sampler structure.
+  @param   stats Pointer to structure where to store the statistics.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_get_sampler_stats(
+    iocSampler *s,
+    iocSamplerStats *stats)
+{
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_lock(s->mutex);
+#endif
+    os_memcpy(stats, &s->stats, sizeof(iocSamplerStats));
+#if OSAL_MULTITHREAD_SUPPORT
+    osal_mutex_unlock(s->mutex);
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get number of samples in received sample batch brick.
+  @anchor ioc_get_brick_samples
+
+  The ioc_get_brick_samples() function is called from brick received callback to find out
+  how many samples the received brick contains. Only bricks marked as sample batch
+  (IOC_SAMPLES) are sample batches, uncompressed images are not.
+
+  @param   b Pointer to receiving brick buffer, b->buf holds the received brick.
+  @param   sample_sz Pointer where to store size of sample data, bytes. OS_NULL if not needed.
+  @return  Number of samples, 0 if the brick is not a sample batch.
+
+****************************************************************************************************
+*/
+os_int ioc_get_brick_samples(
+    iocBrickBuffer *b,
+    os_int *sample_sz)
+{
+    iocBrickHdr *hdr;
+    os_int w, h;
+
+    if (sample_sz) *sample_sz = 0;
+    if (b->buf == OS_NULL || b->buf_sz < (os_memsz)sizeof(iocBrickHdr)) return 0;
+    hdr = (iocBrickHdr*)b->buf;
+    if (hdr->format != OSAL_GRAYSCALE8 || hdr->compression != IOC_SAMPLES) return 0;
+
+    w = (os_int)ioc_get_brick_hdr_int(hdr->width, IOC_BRICK_DIM_SZ);
+    h = (os_int)ioc_get_brick_hdr_int(hdr->height, IOC_BRICK_DIM_SZ);
+    if (w <= IOC_SAMPLE_TSTAMP_SZ ||
+        (os_memsz)sizeof(iocBrickHdr) + w * (os_memsz)h > b->buf_sz)
+    {
+        return 0;
+    }
+
+    if (sample_sz) *sample_sz = w - IOC_SAMPLE_TSTAMP_SZ;
+    return h;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get sample from received sample batch brick.
+  @anchor ioc_get_brick_sample
+
+  @param   b Pointer to receiving brick buffer, b->buf holds the received brick.
+  @param   sample_ix Sample index, 0 ... ioc_get_brick_samples() - 1. Samples are in order
+           they were added.
+  @param   tstamp_us Pointer where to store sample time stamp, microseconds. OS_NULL if
+           not needed.
+  @return  Pointer to sample data within brick buffer, OS_NULL if index is out of range.
+
+****************************************************************************************************
+*/
+const os_char *ioc_get_brick_sample(
+    iocBrickBuffer *b,
+    os_int sample_ix,
+    os_int64 *tstamp_us)
+{
+    const os_uchar *rec;
+    os_int64 t;
+    os_int n, sample_sz, i;
+
+    n = ioc_get_brick_samples(b, &sample_sz);
+    if (sample_ix < 0 || sample_ix >= n) return OS_NULL;
+
+    rec = b->buf + sizeof(iocBrickHdr)
+        + sample_ix * (os_memsz)(sample_sz + IOC_SAMPLE_TSTAMP_SZ);
+    if (tstamp_us)
+    {
+        t = 0;
+        for (i = IOC_SAMPLE_TSTAMP_SZ - 1; i >= 0; i--)
+        {
+            t = (t << 8) | rec[i];
+        }
+        *tstamp_us = t;
+    }
+    return (const os_char*)rec + IOC_SAMPLE_TSTAMP_SZ;
+}
+
+#endif
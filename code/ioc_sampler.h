@@ -0,0 +1,159 @@
+/**
+
+  @file    ioc_sampler.h
+  @brief   Lossless sample history over brick transfer.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Memory block transfer sends only the latest state, values which change faster than the
+  link can deliver are lost. For vibration and energy measurements every sample is needed.
+  The sampler keeps a ring of time stamped sample records. Whenever the brick buffer is
+  ready for a new brick, all samples accumulated since the previous brick are packed into
+  one uncompressed brick and sent using the existing brick/streamer transfer, flat or ring
+  buffer.
+
+  Sample batch brick: compression IOC_SAMPLES (data is not compressed), format
+  OSAL_GRAYSCALE8, width is record size and height is number of samples. Each record is 8
+  byte time stamp in microseconds (least significant byte first) followed by sample data.
+  The receiver gets the brick in its brick received callback and reads the samples with
+  ioc_get_brick_samples() and ioc_get_brick_sample().
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_SAMPLER_H_
+#define IOC_SAMPLER_H_
+#include "iocom.h"
+
+#if IOC_SAMPLER_SUPPORT
+
+/* Size of time stamp at beginning of each sample record.
+ */
+#define IOC_SAMPLE_TSTAMP_SZ 8
+
+
+/**
+****************************************************************************************************
+    Sampler statistics.
+****************************************************************************************************
+*/
+typedef struct iocSamplerStats
+{
+    /** Number of samples added, and number dropped because the ring was full.
+     */
+    os_uint samples;
+    os_uint dropped;
+
+    /** Number of samples and bricks sent.
+     */
+    os_uint sent_samples;
+    os_uint sent_bricks;
+}
+iocSamplerStats;
+
+
+/**
+****************************************************************************************************
+    Sampler state, sending end.
+****************************************************************************************************
+*/
+typedef struct iocSampler
+{
+    /** Brick buffer used to send sample batches.
+     */
+    iocBrickBuffer *brick;
+
+    /** Sample data size and record size (time stamp + sample data), bytes.
+     */
+    os_int sample_sz;
+    os_int rec_sz;
+
+    /** Ring of sample records: buffer, capacity (records), index of oldest record
+        and number of records.
+     */
+    os_char *ring;
+    os_memsz ring_alloc_sz;
+    os_int max_samples;
+    os_int tail;
+    os_int count;
+
+    /** Buffer to pack one batch, maximum number of samples in batch.
+     */
+    os_char *batch;
+    os_memsz batch_alloc_sz;
+    os_int max_batch;
+
+    /** Statistics.
+     */
+    iocSamplerStats stats;
+
+#if OSAL_MULTITHREAD_SUPPORT
+    /** Samples may be added by a different thread than the one sending.
+     */
+    osalMutex mutex;
+#endif
+}
+iocSampler;
+
+
+/**
+****************************************************************************************************
+  Sampler functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Initialize sampler and allocate its buffers.
+ */
+osalStatus ioc_initialize_sampler(
+    iocSampler *s,
+    iocBrickBuffer *brick,
+    os_int sample_sz,
+    os_int max_samples);
+
+/* Release sampler buffers.
+ */
+void ioc_release_sampler(
+    iocSampler *s);
+
+/* Add sample to sampler's ring.
+ */
+osalStatus ioc_add_sample(
+    iocSampler *s,
+    const os_char *data,
+    os_int64 tstamp_us);
+
+/* Send accumulated samples as a brick when brick buffer is ready, and run brick transfer.
+ */
+osalStatus ioc_run_sampler(
+    iocSampler *s);
+
+/* Get copy of sampler statistics.
+ */
+void ioc_get_sampler_stats(
+    iocSampler *s,
+    iocSamplerStats *stats);
+
+/* Get number of samples in received sample batch brick, and sample data size.
+ */
+os_int ioc_get_brick_samples(
+    iocBrickBuffer *b,
+    os_int *sample_sz);
+
+/* Get time stamp and pointer to data of sample in received sample batch brick.
+ */
+const os_char *ioc_get_brick_sample(
+    iocBrickBuffer *b,
+    os_int sample_ix,
+    os_int64 *tstamp_us);
+
+/*@}*/
+
+#endif
+#endif
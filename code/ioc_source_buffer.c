@@ -18,6 +18,25 @@
 */
 #include "iocom.h"
 
+/* Forward referred static functions.
+ */
+#if IOC_LAZY_SYNC_BUFFERS
+static osalStatus ioc_sbuf_prepare_window(
+    iocSourceBuffer *sbuf,
+    os_boolean *raw);
+#endif
+
+#if IOC_MBLK_COALESCE
+static os_boolean ioc_sbuf_coalesce(
+    iocSourceBuffer *sbuf);
+
+#if IOC_TIMER_WHEEL
+static void ioc_sbuf_coalesce_timer_func(
+    struct iocTimer *timer,
+    void *context);
+#endif
+#endif
+
 
 /**
 ****************************************************************************************************
@@ -56,6 +75,9 @@ iocSourceBuffer *ioc_initialize_source_buffer(
 {
     iocRoot *root;
     iocSourceBuffer *sbuf;
+#if IOC_LAZY_SYNC_BUFFERS
+    os_boolean allocate_now = OS_FALSE;
+#endif
 
     /* Check that connection and memory block are valid pointers.
      */
@@ -90,6 +112,17 @@ iocSourceBuffer *ioc_initialize_source_buffer(
         }
 #endif
 
+#if IOC_LAZY_SYNC_BUFFERS
+        /* Buffers are allocated on demand by ioc_sbuf_synchronize(), except for
+           bidirectional transfer which keeps change marks in the synchronized buffer.
+         */
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+        if (flags & IOC_BIDIRECTIONAL) allocate_now = OS_TRUE;
+#endif
+    }
+    if (allocate_now)
+    {
+#endif
         sbuf->syncbuf.buf = ioc_malloc(root, 2 * (os_memsz)sbuf->syncbuf.nbytes, OS_NULL, IOC_PREFER_PSRAM);
         if (sbuf->syncbuf.buf == OS_NULL)
         {
@@ -99,6 +132,10 @@ iocSourceBuffer *ioc_initialize_source_buffer(
         }
         os_memclear(sbuf->syncbuf.buf, 2 * sbuf->syncbuf.nbytes);
         sbuf->syncbuf.delta = sbuf->syncbuf.buf + sbuf->syncbuf.nbytes;
+#if IOC_LAZY_SYNC_BUFFERS
+        sbuf->syncbuf.win_n = sbuf->syncbuf.nbytes;
+        con->syncbuf_bytes += 2 * (os_memsz)sbuf->syncbuf.nbytes;
+#endif
     }
 
     /* Save remote memory block identifier, always start with key frame.
@@ -133,6 +170,12 @@ iocSourceBuffer *ioc_initialize_source_buffer(
     }
     mblk->sbuf.last = sbuf;
 
+#if IOC_DIRTY_LISTS
+    /* Key frame is to be sent.
+     */
+    ioc_sbuf_set_pending(sbuf);
+#endif
+
     /* Mark source buffer structure as initialized source buffer object for debugging.
      */
     IOC_SET_DEBUG_ID(sbuf, 'S')
@@ -237,7 +280,19 @@ void ioc_release_source_buffer(
         sbuf->clink.con->sbuf.current = OS_NULL;
     }
 
+#if IOC_DIRTY_LISTS
+    ioc_sbuf_clear_pending(sbuf);
+#endif
+#if IOC_MBLK_COALESCE && IOC_TIMER_WHEEL
+    ioc_cancel_timer(root, &sbuf->coalesce_timer);
+#endif
+
+#if IOC_LAZY_SYNC_BUFFERS
+    ioc_free(root, sbuf->syncbuf.buf, 2 * (os_memsz)sbuf->syncbuf.win_n, IOC_PREFER_PSRAM);
+    con->syncbuf_bytes -= 2 * (os_memsz)sbuf->syncbuf.win_n;
+#else
     ioc_free(root, sbuf->syncbuf.buf, 2 * sbuf->syncbuf.nbytes, IOC_PREFER_PSRAM);
+#endif
 
     /* Clear allocated memory indicate that is no longer initialized (for debugging).
      */
@@ -333,6 +388,7 @@ void ioc_sbuf_invalidate(
     os_int end_addr)
 {
     os_char *buf, *syncbuf;
+    os_int ws;
 
     /* Experimental, invalidate only bytes which are really changed (optimization).
      * Helps especially in case when unchanged values are rewritten. Do not bother
@@ -345,15 +401,23 @@ void ioc_sbuf_invalidate(
 #endif
         buf = sbuf->mlink.mblk->buf;
         syncbuf = sbuf->syncbuf.buf;
+        ws = 0;
+
+#if IOC_LAZY_SYNC_BUFFERS
+        /* Synchronized buffer can be compared only within the window.
+         */
+        ws = sbuf->syncbuf.win_start;
+        if (start_addr < ws || end_addr >= ws + sbuf->syncbuf.win_n) syncbuf = OS_NULL;
+#endif
 
         if (buf && syncbuf && end_addr - start_addr < 256) {
             while (start_addr <= end_addr) {
-                if (buf[start_addr] != syncbuf[start_addr]) break;
+                if (buf[start_addr] != syncbuf[start_addr - ws]) break;
                 if (start_addr == end_addr) return;
                 start_addr++;
             }
             while (end_addr > start_addr) {
-                if (buf[end_addr] != syncbuf[end_addr]) break;
+                if (buf[end_addr] != syncbuf[end_addr - ws]) break;
                 end_addr--;
             }
         }
@@ -374,6 +438,10 @@ void ioc_sbuf_invalidate(
         if (end_addr > sbuf->changed.end_addr) sbuf->changed.end_addr = end_addr;
     }
 
+#if IOC_DIRTY_LISTS
+    ioc_sbuf_set_pending(sbuf);
+#endif
+
 #if IOC_BIDIRECTIONAL_MBLK_CODE
     if (sbuf->syncbuf.flags & IOC_BIDIRECTIONAL)
     {
@@ -417,13 +485,21 @@ osalStatus ioc_sbuf_synchronize(
         start_addr,
         end_addr,
         n,
-        i;
+        i,
+        ws;
 
 #if IOC_BIDIRECTIONAL_MBLK_CODE
     os_int
         pos,
         count;
 #endif
+
+#if IOC_LAZY_SYNC_BUFFERS
+    os_boolean
+        raw = OS_FALSE;
+#endif
+    IOC_PERF_VAR(t)
+
     if (sbuf == OS_NULL) return OSAL_STATUS_FAILED;
 
     if ((!sbuf->changed.range_set && !sbuf->syncbuf.make_keyframe) ||
@@ -432,6 +508,30 @@ osalStatus ioc_sbuf_synchronize(
         return sbuf->changed.range_set ? OSAL_PENDING : OSAL_SUCCESS;
     }
 
+#if IOC_MBLK_COALESCE
+    /* Merge changes within memory block's send interval.
+     */
+    if (ioc_sbuf_coalesce(sbuf)) return OSAL_PENDING;
+#endif
+    IOC_PERF_BEGIN(t)
+
+#if IOC_LAZY_SYNC_BUFFERS
+    /* Make sure that synchronized buffer covers range to send. If we cannot allocate
+       memory now, try again later.
+     */
+    if ((sbuf->mlink.mblk->flags & IOC_STATIC) == 0)
+    {
+        if (ioc_sbuf_prepare_window(sbuf, &raw))
+        {
+            IOC_PERF_END(sbuf->mlink.mblk->link.root, IOC_PERF_SBUF_SYNC, t)
+            return OSAL_PENDING;
+        }
+    }
+    ws = sbuf->syncbuf.win_start;
+#else
+    ws = 0;
+#endif
+
     buf = sbuf->mlink.mblk->buf;
     syncbuf = sbuf->syncbuf.buf;
     delta = sbuf->syncbuf.delta;
@@ -458,6 +558,19 @@ osalStatus ioc_sbuf_synchronize(
         sbuf->syncbuf.is_keyframe = OS_FALSE;
     }
 
+#if IOC_LAZY_SYNC_BUFFERS
+    /* Range grew the window: Other end's values for the range are not known,
+       send it without delta encoding.
+     */
+    else if (raw)
+    {
+        start_addr = sbuf->changed.start_addr;
+        end_addr = sbuf->changed.end_addr;
+        os_memcpy(delta + start_addr - ws, buf + start_addr, end_addr - start_addr + 1);
+        sbuf->syncbuf.is_keyframe = OS_TRUE;
+    }
+#endif
+
     /* Not making a key frame or transferring static data.
        Check what is actually changed.
      */
@@ -475,25 +588,29 @@ osalStatus ioc_sbuf_synchronize(
            */
           while (start_addr <= sbuf->changed.end_addr)
           {
-              if (syncbuf[start_addr] != buf[start_addr]) break;
+              if (syncbuf[start_addr - ws] != buf[start_addr]) break;
               start_addr++;
           }
 
           while (end_addr >= start_addr)
           {
-              if (syncbuf[end_addr] != buf[end_addr]) break;
+              if (syncbuf[end_addr - ws] != buf[end_addr]) break;
               end_addr--;
           }
 #if IOC_BIDIRECTIONAL_MBLK_CODE
         }
 #endif
-        if (end_addr < start_addr) return OSAL_SUCCESS;
+        if (end_addr < start_addr)
+        {
+            IOC_PERF_END(sbuf->mlink.mblk->link.root, IOC_PERF_SBUF_SYNC, t)
+            return OSAL_SUCCESS;
+        }
 
         /* Do delta encoding.
          */
         for (i = start_addr; i <= end_addr; i++)
         {
-            delta[i] = buf[i] - syncbuf[i];
+            delta[i - ws] = buf[i] - syncbuf[i - ws];
         }
 
         sbuf->syncbuf.is_keyframe = OS_FALSE;
@@ -502,6 +619,14 @@ osalStatus ioc_sbuf_synchronize(
     sbuf->syncbuf.start_addr = start_addr;
     sbuf->syncbuf.end_addr = end_addr;
     sbuf->syncbuf.used = OS_TRUE;
+    sbuf->immediate_sync_needed = OS_FALSE;
+#if IOC_MBLK_PRIORITY_SUPPORT
+    os_get_timer(&sbuf->pending_since);
+#endif
+#if IOC_MBLK_COALESCE
+    os_get_timer(&sbuf->last_sync);
+    sbuf->mlink.mblk->sync_count++;
+#endif
 
 #if IOC_BIDIRECTIONAL_MBLK_CODE
     sbuf->syncbuf.bidir_range_set = OS_FALSE;
@@ -511,7 +636,7 @@ osalStatus ioc_sbuf_synchronize(
     if (syncbuf)
     {
         n = end_addr - start_addr + 1;
-        os_memcpy(syncbuf + start_addr, buf + start_addr, n);
+        os_memcpy(syncbuf + start_addr - ws, buf + start_addr, n);
 
 #if IOC_BIDIRECTIONAL_MBLK_CODE
         if (sbuf->syncbuf.flags & IOC_BIDIRECTIONAL)
@@ -538,5 +663,333 @@ osalStatus ioc_sbuf_synchronize(
         osal_event_set(sbuf->clink.con->worker.trig);
     }
 #endif
+    IOC_PERF_END(sbuf->mlink.mblk->link.root, IOC_PERF_SBUF_SYNC, t)
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check if source buffer may be synchronized now.
+  @anchor ioc_sbuf_sync_due
+
+  The ioc_sbuf_sync_due() function checks memory block's minimum send interval. Connection's
+  send path calls this before retrying synchronization of a source buffer flagged for
+  immediate sync, so that postponed changes are not retried, nor worker thread woken up,
+  before the interval has elapsed. Key frames are always due.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   sbuf Pointer to the source buffer.
+  @return  OS_TRUE if source buffer can be synchronized now, OS_FALSE if send interval has
+           not elapsed since the last synchronization.
+
+****************************************************************************************************
+*/
+os_boolean ioc_sbuf_sync_due(
+    iocSourceBuffer *sbuf)
+{
+#if IOC_MBLK_COALESCE
+    os_int interval_ms;
+
+    interval_ms = sbuf->mlink.mblk->send_interval_ms;
+    if (interval_ms == 0 || sbuf->syncbuf.make_keyframe) return OS_TRUE;
+    return os_has_elapsed(&sbuf->last_sync, interval_ms);
+#else
+    OSAL_UNUSED(sbuf);
+    return OS_TRUE;
+#endif
+}
+
+
+#if IOC_MBLK_COALESCE
+/**
+****************************************************************************************************
+
+  @brief Check if synchronization should wait for send interval (internal).
+  @anchor ioc_sbuf_coalesce
+
+  The ioc_sbuf_coalesce() function is called by ioc_sbuf_synchronize() when there are
+  changes to synchronize. If memory block's minimum send interval has not elapsed since
+  last synchronization, changes are left in invalidated range to be merged with following
+  writes. The source buffer is flagged for immediate synchronization, so connection's send
+  path synchronizes it once ioc_sbuf_sync_due() tells that the interval has elapsed. This
+  does not depend on the timer wheel: The timer only wakes up connection's worker thread
+  on time, without it (or if the timer cannot be set) the changes are sent by the next
+  ioc_run() or connection thread round after the interval.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   sbuf Pointer to the source buffer.
+  @return  OS_TRUE if synchronization is postponed, OS_FALSE to synchronize now.
+
+****************************************************************************************************
+*/
+static os_boolean ioc_sbuf_coalesce(
+    iocSourceBuffer *sbuf)
+{
+    iocMemoryBlock *mblk;
+    os_timer tnow;
+    os_int interval_ms;
+
+    mblk = sbuf->mlink.mblk;
+    interval_ms = mblk->send_interval_ms;
+    if (interval_ms == 0 || sbuf->syncbuf.make_keyframe) return OS_FALSE;
+
+    os_get_timer(&tnow);
+    if (os_has_elapsed_since(&sbuf->last_sync, &tnow, interval_ms)) return OS_FALSE;
+
+    /* Not due yet. Keep the source buffer flagged, send path doesn't retry before the
+       interval has elapsed.
+     */
+    mblk->coalesced_count++;
+    sbuf->immediate_sync_needed = OS_TRUE;
+
+#if IOC_TIMER_WHEEL
+    if (sbuf->coalesce_timer.slot == OS_NULL)
+    {
+        ioc_set_timer(mblk->link.root, &sbuf->coalesce_timer,
+            interval_ms - (os_int)os_get_ms_elapsed(&sbuf->last_sync, &tnow),
+            ioc_sbuf_coalesce_timer_func, sbuf);
+    }
+#endif
+    return OS_TRUE;
+}
+
+
+#if IOC_TIMER_WHEEL
+/**
+****************************************************************************************************
+
+  @brief Send interval elapsed (internal).
+  @anchor ioc_sbuf_coalesce_timer_func
+
+  Called by timer wheel thread with ioc_lock() on. Flags the source buffer for immediate
+  synchronization and wakes up connection worker thread, which synchronizes and sends
+  merged changes.
+
+****************************************************************************************************
+*/
+static void ioc_sbuf_coalesce_timer_func(
+    struct iocTimer *timer,
+    void *context)
+{
+    iocSourceBuffer *sbuf;
+    OSAL_UNUSED(timer);
+
+    sbuf = (iocSourceBuffer*)context;
+    if (!sbuf->changed.range_set) return;
+
+    sbuf->immediate_sync_needed = OS_TRUE;
+    if (sbuf->clink.con->worker.trig)
+    {
+        osal_event_set(sbuf->clink.con->worker.trig);
+    }
+}
+#endif
+#endif
+
+
+#if IOC_DIRTY_LISTS
+/**
+****************************************************************************************************
+
+  @brief Add source buffer to root's list of source buffers with changes to send.
+  @anchor ioc_sbuf_set_pending
+
+  The ioc_sbuf_set_pending() function is called when source buffer is invalidated or key frame
+  needs to be sent. ioc_send_all() synchronizes only source buffers in this list, instead of
+  looping trough all memory blocks and their source buffers. Does nothing if the source buffer
+  is already listed.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   sbuf Pointer to the source buffer object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_sbuf_set_pending(
+    iocSourceBuffer *sbuf)
+{
+    iocRoot *root;
+
+    if (sbuf->plink.listed) return;
+    root = sbuf->clink.con->link.root;
+
+    sbuf->plink.next = OS_NULL;
+    sbuf->plink.prev = root->pending_sbuf.last;
+    if (root->pending_sbuf.last)
+    {
+        root->pending_sbuf.last->plink.next = sbuf;
+    }
+    else
+    {
+        root->pending_sbuf.first = sbuf;
+    }
+    root->pending_sbuf.last = sbuf;
+    sbuf->plink.listed = OS_TRUE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remove source buffer from root's list of source buffers with changes to send.
+  @anchor ioc_sbuf_clear_pending
+
+  The ioc_sbuf_clear_pending() function is called by ioc_send_all() when source buffer has
+  no more changes to synchronize, and when source buffer is released. Does nothing if the
+  source buffer is not listed.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   sbuf Pointer to the source buffer object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_sbuf_clear_pending(
+    iocSourceBuffer *sbuf)
+{
+    iocRoot *root;
+
+    if (!sbuf->plink.listed) return;
+    root = sbuf->clink.con->link.root;
+
+    if (sbuf->plink.prev)
+    {
+        sbuf->plink.prev->plink.next = sbuf->plink.next;
+    }
+    else
+    {
+        root->pending_sbuf.first = sbuf->plink.next;
+    }
+    if (sbuf->plink.next)
+    {
+        sbuf->plink.next->plink.prev = sbuf->plink.prev;
+    }
+    else
+    {
+        root->pending_sbuf.last = sbuf->plink.prev;
+    }
+    sbuf->plink.next = sbuf->plink.prev = OS_NULL;
+    sbuf->plink.listed = OS_FALSE;
+}
+#endif
+
+
+#if IOC_LAZY_SYNC_BUFFERS
+/**
+****************************************************************************************************
+
+  @brief Make sure that synchronized buffer covers range to synchronize (internal).
+  @anchor ioc_sbuf_prepare_window
+
+  The ioc_sbuf_prepare_window() function grows window of synchronized and delta buffers to
+  cover whole memory block for a key frame, or changed range otherwise. New window is hull of
+  the old window and the range. Bytes outside old window have not been sent since the last
+  key frame, and thus have not been written either: they are initialized from memory block,
+  which holds the same values as the other end of connection.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   sbuf Pointer to the source buffer object.
+  @param   raw Set to OS_TRUE if window was grown for changed range, which then must be sent
+           without delta encoding.
+  @return  OSAL_SUCCESS if successful, OSAL_STATUS_MEMORY_ALLOCATION_FAILED if memory
+           allocation failed.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_sbuf_prepare_window(
+    iocSourceBuffer *sbuf,
+    os_boolean *raw)
+{
+    iocMemoryBlock *mblk;
+    iocRoot *root;
+    os_char *newbuf;
+    os_int start_addr, end_addr, ws, old_n, n;
+
+    *raw = OS_FALSE;
+    mblk = sbuf->mlink.mblk;
+    sbuf->syncbuf.release_window = sbuf->syncbuf.make_keyframe;
+
+    if (sbuf->syncbuf.make_keyframe)
+    {
+        start_addr = 0;
+        end_addr = sbuf->syncbuf.nbytes - 1;
+    }
+    else
+    {
+        start_addr = sbuf->changed.start_addr;
+        end_addr = sbuf->changed.end_addr;
+    }
+
+    ws = sbuf->syncbuf.win_start;
+    old_n = sbuf->syncbuf.win_n;
+    if (old_n)
+    {
+        if (start_addr >= ws && end_addr < ws + old_n) return OSAL_SUCCESS;
+        if (ws < start_addr) start_addr = ws;
+        if (ws + old_n - 1 > end_addr) end_addr = ws + old_n - 1;
+    }
+
+    n = end_addr - start_addr + 1;
+    root = mblk->link.root;
+    newbuf = ioc_malloc(root, 2 * (os_memsz)n, OS_NULL, IOC_PREFER_PSRAM);
+    if (newbuf == OS_NULL) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+
+    os_memcpy(newbuf, mblk->buf + start_addr, n);
+    if (old_n)
+    {
+        os_memcpy(newbuf + ws - start_addr, sbuf->syncbuf.buf, old_n);
+        ioc_free(root, sbuf->syncbuf.buf, 2 * (os_memsz)old_n, IOC_PREFER_PSRAM);
+    }
+
+    sbuf->syncbuf.buf = newbuf;
+    sbuf->syncbuf.delta = newbuf + n;
+    sbuf->syncbuf.win_start = (ioc_addr)start_addr;
+    sbuf->syncbuf.win_n = (ioc_addr)n;
+    sbuf->clink.con->syncbuf_bytes += 2 * (os_memsz)(n - old_n);
+
+    *raw = (os_boolean)!sbuf->syncbuf.make_keyframe;
     return OSAL_SUCCESS;
 }
+
+
+/**
+****************************************************************************************************
+
+  @brief Release synchronized and delta buffers when they are not needed (internal).
+  @anchor ioc_sbuf_release_window
+
+  The ioc_sbuf_release_window() function frees synchronized and delta buffers of the source
+  buffer. Called when key frame has been sent, after which the memory block holds the same
+  data as the other end, and when connection is reset. Buffers of bidirectional source
+  buffers hold change marks and are kept.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   sbuf Pointer to the source buffer object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_sbuf_release_window(
+    iocSourceBuffer *sbuf)
+{
+    sbuf->syncbuf.release_window = OS_FALSE;
+    if (sbuf->syncbuf.win_n == 0) return;
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+    if (sbuf->syncbuf.flags & IOC_BIDIRECTIONAL) return;
+#endif
+
+    ioc_free(sbuf->mlink.mblk->link.root, sbuf->syncbuf.buf,
+        2 * (os_memsz)sbuf->syncbuf.win_n, IOC_PREFER_PSRAM);
+    sbuf->clink.con->syncbuf_bytes -= 2 * (os_memsz)sbuf->syncbuf.win_n;
+    sbuf->syncbuf.buf = sbuf->syncbuf.delta = OS_NULL;
+    sbuf->syncbuf.win_start = sbuf->syncbuf.win_n = 0;
+}
+#endif
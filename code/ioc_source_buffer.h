@@ -9,6 +9,12 @@
   Transfer buffer binds a memory block and connection object together. It buffers changes
   to be sent through the connection.
 
+  With IOC_LAZY_SYNC_BUFFERS the synchronized and delta buffers cover only a window of
+  memory block addresses, which grows as data is written. Bytes outside the window have not
+  been written since last key frame, so the other end has the same values as the memory
+  block. A range which grows the window is sent without delta encoding. Key frame needs
+  window covering whole memory block, which is released once the key frame has been sent.
+
   Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
   modified, and distributed under the terms of the project licensing. By continuing to use, modify,
   or distribute this file you indicate that you have read the license and understand and accept 
@@ -82,6 +88,18 @@ typedef struct
      */
     ioc_addr end_addr;
 
+#if IOC_LAZY_SYNC_BUFFERS
+    /** Window of memory block addresses covered by buf and delta: win_start is address of
+        the first byte and win_n number of bytes. win_n is zero if buffers are not allocated.
+     */
+    ioc_addr win_start;
+    ioc_addr win_n;
+
+    /** Release window once the key frame being synchronized has been sent.
+     */
+    os_boolean release_window;
+#endif
+
 #if IOC_BIDIRECTIONAL_MBLK_CODE
 
     /** Bidirectional address range to be transferred.
@@ -149,6 +167,27 @@ typedef struct
 iocMemoryBlocksSourceBufferLink;
 
 
+#if IOC_DIRTY_LISTS
+/**
+****************************************************************************************************
+    This source buffer in root's list of source buffers with changes to send.
+****************************************************************************************************
+*/
+typedef struct
+{
+    /** Pointer to next and previous source buffer in root's pending list.
+     */
+    struct iocSourceBuffer *next;
+    struct iocSourceBuffer *prev;
+
+    /** Source buffer is in root's pending list.
+     */
+    os_boolean listed;
+}
+iocRootsPendingSourceBufferLink;
+#endif
+
+
 /**
 ****************************************************************************************************
 
@@ -179,6 +218,26 @@ typedef struct iocSourceBuffer
      */
     iocInvalidatedRange changed;
 
+#if IOC_MBLK_PRIORITY_SUPPORT
+    /** Timer when synchronized buffer became used (data waiting to be sent). Used for
+        send priority aging and maximum latency.
+     */
+    os_timer pending_since;
+#endif
+
+#if IOC_MBLK_COALESCE
+    /** Timer when changes were last synchronized for sending, to enforce memory block's
+        minimum send interval.
+     */
+    os_timer last_sync;
+
+#if IOC_TIMER_WHEEL
+    /** Timer to synchronize merged changes when send interval has elapsed.
+     */
+    iocTimer coalesce_timer;
+#endif
+#endif
+
     /** Synchronized buffer.
      */
     iocSynchronizedSourceBuffer syncbuf;
@@ -190,6 +249,12 @@ typedef struct iocSourceBuffer
     /** This source buffer in connections's linked list of source buffers.
      */
     iocConnectionsSourceBufferLink clink;
+
+#if IOC_DIRTY_LISTS
+    /** This source buffer in root's list of source buffers with changes to send.
+     */
+    iocRootsPendingSourceBufferLink plink;
+#endif
 }
 iocSourceBuffer;
 
@@ -233,6 +298,30 @@ void ioc_sbuf_invalidate(
 osalStatus ioc_sbuf_synchronize(
     iocSourceBuffer *sbuf);
 
+/* Check if memory block's send interval allows synchronizing now (internal).
+ */
+os_boolean ioc_sbuf_sync_due(
+    iocSourceBuffer *sbuf);
+
+#if IOC_DIRTY_LISTS
+/* Add source buffer to root's list of source buffers with changes to send (internal).
+ */
+void ioc_sbuf_set_pending(
+    iocSourceBuffer *sbuf);
+
+/* Remove source buffer from root's pending list (internal).
+ */
+void ioc_sbuf_clear_pending(
+    iocSourceBuffer *sbuf);
+#endif
+
+#if IOC_LAZY_SYNC_BUFFERS
+/* Release synchronized and delta buffers when they are not needed (internal).
+ */
+void ioc_sbuf_release_window(
+    iocSourceBuffer *sbuf);
+#endif
+
 /*@}*/
 
 #endif
@@ -143,7 +143,7 @@ static void ioc_make_switchbox_authentication_message(
 
     /* Generate IOCOM frame header.
      */
-    ioc_generate_header(OS_NULL, buf, &ptrs, 0, 0);
+    ioc_generate_header(OS_NULL, buf, &ptrs, 0, 0, 0);
 
     /* Generate frame content. Here we do not check for buffer overflow,
        we know (and trust) that it fits within one frame.
@@ -48,10 +48,6 @@ iocTargetBuffer *ioc_initialize_target_buffer(
 {
     iocRoot *root;
     iocTargetBuffer *tbuf;
-#if IOC_BIDIRECTIONAL_MBLK_CODE
-    os_char *p;
-    os_int count;
-#endif
 
     /* Check that connection and memory block are valid pointers.
      */
@@ -87,49 +83,25 @@ iocTargetBuffer *ioc_initialize_target_buffer(
     }
 #endif
 
-    tbuf->syncbuf.buf = ioc_malloc(root, 2 * (os_memsz)tbuf->syncbuf.nbytes, OS_NULL, IOC_PREFER_PSRAM);
-    if (tbuf->syncbuf.buf == OS_NULL)
-    {
-        ioc_free(root, tbuf, sizeof(iocTargetBuffer), IOC_DEFAULT_ALLOC);
-        ioc_unlock(root);
-        return OS_NULL;
-    }
-    tbuf->syncbuf.newdata = tbuf->syncbuf.buf + tbuf->syncbuf.nbytes;
-
-    /* Copy data backwars to get the initial situation
+    /* Save pointer to connection and memory block objects.
      */
-    os_memcpy(tbuf->syncbuf.buf, mblk->buf, mblk->nbytes);
-    os_memcpy(tbuf->syncbuf.newdata, mblk->buf, mblk->nbytes);
+    tbuf->clink.con = con;
+    tbuf->mlink.mblk = mblk;
 
-    /* If this target buffer is for data received from device down for two
-       directional communication, mark whole memory block to be updated.
-       We will expect key frame first. Clear mark buffers anyhow.
+#if IOC_LAZY_SYNC_BUFFERS == 0
+    /* Allocate synchronized buffers now, unless these are allocated when first data
+       is received.
      */
-#if IOC_BIDIRECTIONAL_MBLK_CODE
-    if (flags & IOC_BIDIRECTIONAL)
+    if (ioc_tbuf_allocate_syncbuf(tbuf))
     {
-        count = tbuf->syncbuf.nbytes - mblk->nbytes;
-
-        os_memclear(tbuf->syncbuf.buf + mblk->nbytes, count);
-        p = tbuf->syncbuf.newdata + mblk->nbytes;
-
-        if ((mblk->flags & IOC_MBLK_DOWN) &&
-            (con->flags & IOC_CONNECT_UP) == 0)
-        {
-            while (count--) *(p++) = 0xFF;
-        }
-        else
-        {
-            os_memclear(p, count);
-        }
+        ioc_free(root, tbuf, sizeof(iocTargetBuffer), IOC_DEFAULT_ALLOC);
+        ioc_unlock(root);
+        return OS_NULL;
     }
 #endif
 
-    /* Save pointer to connection and memory block objects and join to linked list
-       of target buffers for both connection and memory block.
+    /* Join to linked list of target buffers for both connection and memory block.
      */
-    tbuf->clink.con = con;
-    tbuf->mlink.mblk = mblk;
     tbuf->clink.prev = con->tbuf.last;
     if (con->tbuf.last)
     {
@@ -244,7 +216,13 @@ void ioc_release_target_buffer(
         tbuf->mlink.mblk->tbuf.last = tbuf->mlink.prev;
     }
 
-    ioc_free(root, tbuf->syncbuf.buf, 2 * (os_memsz)tbuf->syncbuf.nbytes, IOC_PREFER_PSRAM);
+    if (tbuf->syncbuf.buf)
+    {
+        ioc_free(root, tbuf->syncbuf.buf, 2 * (os_memsz)tbuf->syncbuf.nbytes, IOC_PREFER_PSRAM);
+#if IOC_LAZY_SYNC_BUFFERS
+        con->syncbuf_bytes -= 2 * (os_memsz)tbuf->syncbuf.nbytes;
+#endif
+    }
 
     /* Clear allocated memory indicate that is no longer initialized (for debugging).
      */
@@ -259,6 +237,88 @@ void ioc_release_target_buffer(
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Allocate synchronized and new data buffers (internal).
+  @anchor ioc_tbuf_allocate_syncbuf
+
+  The ioc_tbuf_allocate_syncbuf() function allocates synchronized and new data buffers for
+  the target buffer and initializes them from memory block content. With IOC_LAZY_SYNC_BUFFERS
+  this is called when first data frame is received for the target buffer, so connections
+  which never send data to the memory block do not hold copies of it.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   tbuf Pointer to the target buffer object.
+  @return  OSAL_SUCCESS if successful, OSAL_STATUS_MEMORY_ALLOCATION_FAILED if memory
+           allocation failed.
+
+****************************************************************************************************
+*/
+osalStatus ioc_tbuf_allocate_syncbuf(
+    iocTargetBuffer *tbuf)
+{
+    iocRoot *root;
+    iocMemoryBlock *mblk;
+    os_int ndata;
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+    os_char *p;
+    os_int count;
+#endif
+
+    mblk = tbuf->mlink.mblk;
+    root = mblk->link.root;
+
+    tbuf->syncbuf.buf = ioc_malloc(root, 2 * (os_memsz)tbuf->syncbuf.nbytes, OS_NULL, IOC_PREFER_PSRAM);
+    if (tbuf->syncbuf.buf == OS_NULL)
+    {
+        return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+    }
+    tbuf->syncbuf.newdata = tbuf->syncbuf.buf + tbuf->syncbuf.nbytes;
+#if IOC_LAZY_SYNC_BUFFERS
+    tbuf->clink.con->syncbuf_bytes += 2 * (os_memsz)tbuf->syncbuf.nbytes;
+#endif
+
+    /* Copy data backwars to get the initial situation
+     */
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+    ndata = tbuf->syncbuf.ndata;
+#else
+    ndata = tbuf->syncbuf.nbytes;
+#endif
+    if (ndata > mblk->nbytes) ndata = mblk->nbytes;
+    os_memcpy(tbuf->syncbuf.buf, mblk->buf, ndata);
+    os_memcpy(tbuf->syncbuf.newdata, mblk->buf, ndata);
+
+    /* If this target buffer is for data received from device down for two
+       directional communication, mark whole memory block to be updated.
+       We will expect key frame first. Clear mark buffers anyhow.
+     */
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+    if (tbuf->syncbuf.flags & IOC_BIDIRECTIONAL)
+    {
+        count = tbuf->syncbuf.nbytes - tbuf->syncbuf.ndata;
+
+        os_memclear(tbuf->syncbuf.buf + tbuf->syncbuf.ndata, count);
+        p = tbuf->syncbuf.newdata + tbuf->syncbuf.ndata;
+
+        if ((mblk->flags & IOC_MBLK_DOWN) &&
+            (tbuf->clink.con->flags & IOC_CONNECT_UP) == 0)
+        {
+            while (count--) *(p++) = 0xFF;
+        }
+        else
+        {
+            os_memclear(p, count);
+        }
+    }
+#endif
+
+    return OSAL_SUCCESS;
+}
+
+
 /**
 ****************************************************************************************************
 
@@ -424,6 +484,12 @@ void ioc_tbuf_synchronize(
         tbuf->syncbuf.buf_end_addr = end_addr;
         tbuf->syncbuf.buf_used = OS_TRUE;
     }
+
+#if IOC_DIRTY_LISTS
+    /* Let ioc_receive_all() know that this memory block has received data.
+     */
+    ioc_mblk_set_received(tbuf->mlink.mblk);
+#endif
 }
 
 
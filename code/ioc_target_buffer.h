@@ -187,6 +187,11 @@ iocTargetBuffer *ioc_initialize_target_buffer(
 void ioc_release_target_buffer(
     iocTargetBuffer *tbuf);
 
+/* Allocate synchronized and new data buffers (internal).
+ */
+osalStatus ioc_tbuf_allocate_syncbuf(
+    iocTargetBuffer *tbuf);
+
 /* Mark address range of changed values (internal).
  */
 void ioc_tbuf_invalidate(
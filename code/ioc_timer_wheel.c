@@ -0,0 +1,447 @@
+/**
+
+  @file    ioc_timer_wheel.c
+  @brief   Shared timer wheel for connection timeouts.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Hierarchical timer wheel and the timer wheel thread. The wheel is member of the root object
+  and protected by ioc_lock().
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_TIMER_WHEEL
+
+/* Wake up tick when there are no timers.
+ */
+#define IOC_TIMER_WHEEL_NEVER 0x7FFFFFFFFFFFFFFFLL
+
+/* Forward referred static functions.
+ */
+static os_int64 ioc_timer_wheel_current_tick(
+    iocTimerWheel *w);
+
+static void ioc_place_timer(
+    iocTimerWheel *w,
+    iocTimer *timer);
+
+static void ioc_unlink_timer(
+    iocTimerWheel *w,
+    iocTimer *timer);
+
+static void ioc_advance_timer_wheel(
+    iocTimerWheel *w);
+
+static os_int64 ioc_timer_wheel_next_tick(
+    iocTimerWheel *w);
+
+static void ioc_timer_wheel_thread(
+    void *prm,
+    osalEvent done);
+
+
+/**
+****************************************************************************************************
+
+  @brief Set or reset a timer.
+  @anchor ioc_set_timer
+
+  The ioc_set_timer() function sets timer to call func after timeout_ms. If the timer is
+  already set, it is moved to the new time. The timer wheel thread is started when the first
+  timer is set. Timer resolution is IOC_TIMER_WHEEL_TICK_MS, the function is never called
+  before timeout has elapsed, except for timeouts longer than the wheel's range.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   root Pointer to the root object.
+  @param   timer Pointer to timer structure, cleared with os_memclear() before first use.
+  @param   timeout_ms Timeout in milliseconds.
+  @param   func Function to call when the timer is due. Called by timer wheel thread with
+           ioc_lock() on.
+  @param   context Context pointer to pass to func.
+  @return  OSAL_SUCCESS if the timer was set. OSAL_STATUS_FAILED if timer wheel thread could
+           not be started, the caller must then poll for its timeouts.
+
+****************************************************************************************************
+*/
+osalStatus ioc_set_timer(
+    iocRoot *root,
+    iocTimer *timer,
+    os_int timeout_ms,
+    ioc_timer_func *func,
+    void *context)
+{
+    iocTimerWheel *w;
+    osalThreadOptParams opt;
+    os_timer tnow;
+
+    w = &root->timer_wheel;
+    if (!w->started)
+    {
+        os_get_timer(&w->start_timer);
+        w->tick = 0;
+        w->wakeup_tick = IOC_TIMER_WHEEL_NEVER;
+        w->stop_thread = OS_FALSE;
+        w->trig = osal_event_create(OSAL_EVENT_SET_AT_EXIT);
+        if (w->trig == OS_NULL) return OSAL_STATUS_FAILED;
+
+        os_memclear(&opt, sizeof(opt));
+        opt.thread_name = "timerwheel";
+        w->thread = osal_thread_create(ioc_timer_wheel_thread, root, &opt, OSAL_THREAD_ATTACHED);
+        if (w->thread == OS_NULL)
+        {
+            osal_event_delete(w->trig);
+            w->trig = OS_NULL;
+            return OSAL_STATUS_FAILED;
+        }
+        w->started = OS_TRUE;
+    }
+
+    if (timer->slot) ioc_cancel_timer(root, timer);
+    if (timeout_ms < 0) timeout_ms = 0;
+
+    /* Empty wheel is not advanced, move it to current time.
+     */
+    if (w->count == 0) w->tick = ioc_timer_wheel_current_tick(w);
+
+    timer->func = func;
+    timer->context = context;
+    os_get_timer(&tnow);
+    timer->due_tick = ((os_int64)os_get_ms_elapsed(&w->start_timer, &tnow) + timeout_ms +
+        IOC_TIMER_WHEEL_TICK_MS - 1) / IOC_TIMER_WHEEL_TICK_MS;
+    ioc_place_timer(w, timer);
+    w->count++;
+
+    /* If the thread is sleeping past this timer, wake it up to recalculate.
+     */
+    if (timer->due_tick < w->wakeup_tick)
+    {
+        w->wakeup_tick = timer->due_tick;
+        osal_event_set(w->trig);
+    }
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Cancel timer.
+  @anchor ioc_cancel_timer
+
+  The ioc_cancel_timer() function removes the timer from the wheel, if it is set. Must be
+  called before memory of an object containing a timer is released.
+
+  ioc_lock() must be on before calling this function.
+
+  @param   root Pointer to the root object.
+  @param   timer Pointer to timer structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_cancel_timer(
+    iocRoot *root,
+    iocTimer *timer)
+{
+    iocTimerWheel *w;
+
+    if (timer->slot == OS_NULL) return;
+    w = &root->timer_wheel;
+    ioc_unlink_timer(w, timer);
+    w->count--;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Stop timer wheel thread.
+  @anchor ioc_release_timer_wheel
+
+  The ioc_release_timer_wheel() function is called by ioc_release_root() after all connections
+  have been released. It stops the timer wheel thread and waits for it to exit.
+
+  ioc_lock() must not be on when calling this function.
+
+  @param   root Pointer to the root object.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_timer_wheel(
+    iocRoot *root)
+{
+    iocTimerWheel *w;
+
+    w = &root->timer_wheel;
+    if (!w->started) return;
+
+    w->stop_thread = OS_TRUE;
+    osal_event_set(w->trig);
+    osal_thread_join(w->thread);
+    osal_event_delete(w->trig);
+    w->trig = OS_NULL;
+    w->thread = OS_NULL;
+    w->started = OS_FALSE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get current timer wheel tick (internal).
+
+****************************************************************************************************
+*/
+static os_int64 ioc_timer_wheel_current_tick(
+    iocTimerWheel *w)
+{
+    os_timer tnow;
+
+    os_get_timer(&tnow);
+    return (os_int64)os_get_ms_elapsed(&w->start_timer, &tnow) / IOC_TIMER_WHEEL_TICK_MS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Place timer into the slot matching it's due tick (internal).
+
+  Timer due within IOC_TIMER_WHEEL_SLOTS ticks goes to level 0, within SLOTS^2 ticks to level 1,
+  etc. Timer which is already due goes to the current level 0 slot. Timer beyond the wheel's
+  range is clamped to the last tick of the range.
+
+****************************************************************************************************
+*/
+static void ioc_place_timer(
+    iocTimerWheel *w,
+    iocTimer *timer)
+{
+    iocTimerSlot *slot;
+    os_int64 delta, due;
+    os_int level, shift;
+
+    due = timer->due_tick;
+    if (due < w->tick) due = w->tick;
+    delta = due - w->tick;
+
+    for (level = 0; level < IOC_TIMER_WHEEL_LEVELS - 1; level++)
+    {
+        if (delta < ((os_int64)1 << (IOC_TIMER_WHEEL_BITS * (level + 1)))) break;
+    }
+    shift = IOC_TIMER_WHEEL_BITS * level;
+    if (delta >= ((os_int64)1 << (shift + IOC_TIMER_WHEEL_BITS)))
+    {
+        due = w->tick + ((os_int64)1 << (shift + IOC_TIMER_WHEEL_BITS)) - 1;
+        timer->due_tick = due;
+    }
+
+    slot = &w->slot[level][(due >> shift) & IOC_TIMER_WHEEL_MASK];
+    timer->prev = OS_NULL;
+    timer->next = slot->first;
+    if (slot->first) slot->first->prev = timer;
+    slot->first = timer;
+    timer->slot = slot;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remove timer from it's slot (internal).
+
+****************************************************************************************************
+*/
+static void ioc_unlink_timer(
+    iocTimerWheel *w,
+    iocTimer *timer)
+{
+    OSAL_UNUSED(w);
+
+    if (timer->prev)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        timer->slot->first = timer->next;
+    }
+    if (timer->next)
+    {
+        timer->next->prev = timer->prev;
+    }
+    timer->next = timer->prev = OS_NULL;
+    timer->slot = OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Process ticks up to now (internal).
+
+  For each tick: When lower level wraps around, timers in the matching higher level slot are
+  moved to lower levels. Then timers in the level 0 slot are called. The tick is advanced
+  before calling, so a timer function which sets a timer again doesn't land in the slot
+  being processed.
+
+  ioc_lock() must be on before calling this function.
+
+****************************************************************************************************
+*/
+static void ioc_advance_timer_wheel(
+    iocTimerWheel *w)
+{
+    iocTimerSlot *slot;
+    iocTimer *timer, *next_timer;
+    os_int64 now_tick;
+    os_int level, shift, idx;
+
+    now_tick = ioc_timer_wheel_current_tick(w);
+    while (w->tick <= now_tick)
+    {
+        if (w->count == 0)
+        {
+            w->tick = now_tick + 1;
+            break;
+        }
+
+        for (level = IOC_TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+        {
+            shift = IOC_TIMER_WHEEL_BITS * level;
+            if (w->tick & (((os_int64)1 << shift) - 1)) continue;
+
+            slot = &w->slot[level][(w->tick >> shift) & IOC_TIMER_WHEEL_MASK];
+            timer = slot->first;
+            slot->first = OS_NULL;
+            while (timer)
+            {
+                next_timer = timer->next;
+                ioc_place_timer(w, timer);
+                timer = next_timer;
+            }
+        }
+
+        idx = (os_int)(w->tick & IOC_TIMER_WHEEL_MASK);
+        w->tick++;
+        slot = &w->slot[0][idx];
+        while ((timer = slot->first))
+        {
+            ioc_unlink_timer(w, timer);
+            w->count--;
+            timer->func(timer, timer->context);
+        }
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find tick at which the timer wheel needs to be processed next (internal).
+
+  Level 0 slots hold timers due within IOC_TIMER_WHEEL_SLOTS ticks. For higher levels the
+  first non empty slot tells when the slot needs to be cascaded.
+
+  @return  Tick, or IOC_TIMER_WHEEL_NEVER if no timers are set.
+
+****************************************************************************************************
+*/
+static os_int64 ioc_timer_wheel_next_tick(
+    iocTimerWheel *w)
+{
+    os_int64 base, next_tick, t;
+    os_int level, shift, k;
+
+    next_tick = IOC_TIMER_WHEEL_NEVER;
+    if (w->count == 0) return next_tick;
+
+    for (k = 0; k < IOC_TIMER_WHEEL_SLOTS; k++)
+    {
+        if (w->slot[0][(w->tick + k) & IOC_TIMER_WHEEL_MASK].first)
+        {
+            next_tick = w->tick + k;
+            break;
+        }
+    }
+
+    for (level = 1; level < IOC_TIMER_WHEEL_LEVELS; level++)
+    {
+        shift = IOC_TIMER_WHEEL_BITS * level;
+        base = w->tick >> shift;
+
+        /* Current slot is cascaded now only if the tick is exactly at the boundary,
+           otherwise it is next time around.
+         */
+        for (k = (w->tick & (((os_int64)1 << shift) - 1)) ? 1 : 0;
+             k <= IOC_TIMER_WHEEL_SLOTS;
+             k++)
+        {
+            if (w->slot[level][(base + k) & IOC_TIMER_WHEEL_MASK].first)
+            {
+                t = (base + k) << shift;
+                if (t < next_tick) next_tick = t;
+                break;
+            }
+        }
+    }
+
+    return next_tick;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Timer wheel thread (internal).
+
+  Processes the wheel and sleeps until the next timer is due, or until triggered by
+  ioc_set_timer() for an earlier timer.
+
+****************************************************************************************************
+*/
+static void ioc_timer_wheel_thread(
+    void *prm,
+    osalEvent done)
+{
+    iocRoot *root;
+    iocTimerWheel *w;
+    os_int64 next_tick, now_tick;
+    os_int wait_ms;
+
+    root = (iocRoot*)prm;
+    w = &root->timer_wheel;
+    osal_event_set(done);
+
+    while (!w->stop_thread && osal_go())
+    {
+        ioc_lock(root);
+        ioc_advance_timer_wheel(w);
+        next_tick = ioc_timer_wheel_next_tick(w);
+        w->wakeup_tick = next_tick;
+        if (next_tick == IOC_TIMER_WHEEL_NEVER)
+        {
+            wait_ms = OSAL_INFINITE;
+        }
+        else
+        {
+            now_tick = ioc_timer_wheel_current_tick(w);
+            wait_ms = next_tick > now_tick
+                ? (os_int)(next_tick - now_tick) * IOC_TIMER_WHEEL_TICK_MS : 0;
+        }
+        ioc_unlock(root);
+
+        osal_event_wait(w->trig, wait_ms);
+    }
+}
+
+#endif
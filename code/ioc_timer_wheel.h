@@ -0,0 +1,170 @@
+/**
+
+  @file    ioc_timer_wheel.h
+  @brief   Shared timer wheel for connection timeouts.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Connection worker threads used to wake up every IOC_SOCKET_CHECK_TIMEOUTS_MS just to check
+  keep alive and silence timeouts, and to poll reconnect back off. With thousands of
+  connections this alone is tens of thousands of wake ups per second. Instead, an idle
+  connection arms a timer in root's timer wheel and waits for data or the timer without
+  timeout. One timer wheel thread per root sleeps until the next timer is due and sets
+  worker thread's trigger event.
+
+  The wheel is hierarchical: IOC_TIMER_WHEEL_LEVELS levels of IOC_TIMER_WHEEL_SLOTS slots.
+  Level 0 slot is one IOC_TIMER_WHEEL_TICK_MS tick, each higher level slot spans the whole
+  level below it. Setting and cancelling a timer is O(1), timers on higher levels are moved
+  (cascaded) to lower levels as their time approaches. Timers beyond the wheel's range are
+  clamped to it and fire early, so timer functions must check if the timeout really elapsed.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_TIMER_WHEEL_H_
+#define IOC_TIMER_WHEEL_H_
+#include "iocom.h"
+
+#if IOC_TIMER_WHEEL
+
+struct iocRoot;
+struct iocTimer;
+struct iocTimerSlot;
+
+/* Timer wheel tick, ms.
+ */
+#ifndef IOC_TIMER_WHEEL_TICK_MS
+#define IOC_TIMER_WHEEL_TICK_MS 10
+#endif
+
+/* Number of slots per level as power of two, and number of levels. With defaults the
+   wheel covers 64^4 ticks, about 46 hours.
+ */
+#define IOC_TIMER_WHEEL_BITS 6
+#define IOC_TIMER_WHEEL_SLOTS (1 << IOC_TIMER_WHEEL_BITS)
+#define IOC_TIMER_WHEEL_MASK (IOC_TIMER_WHEEL_SLOTS - 1)
+#define IOC_TIMER_WHEEL_LEVELS 4
+
+
+/**
+****************************************************************************************************
+    Timer function type. Called by timer wheel thread with ioc_lock() on. The function must
+    be quick, typically it just sets an event.
+****************************************************************************************************
+*/
+typedef void ioc_timer_func(
+    struct iocTimer *timer,
+    void *context);
+
+
+/**
+****************************************************************************************************
+    Timer, typically member of the object which uses it. Clear with os_memclear() before use.
+****************************************************************************************************
+*/
+typedef struct iocTimer
+{
+    /** Next and previous timer in the same slot, and the slot. Slot is OS_NULL if the timer
+        is not set.
+     */
+    struct iocTimer *next;
+    struct iocTimer *prev;
+    struct iocTimerSlot *slot;
+
+    /** Timer wheel tick when the timer is due.
+     */
+    os_int64 due_tick;
+
+    /** Function to call when the timer is due, and context pointer for it.
+     */
+    ioc_timer_func *func;
+    void *context;
+}
+iocTimer;
+
+
+/**
+****************************************************************************************************
+    Timer wheel slot.
+****************************************************************************************************
+*/
+typedef struct iocTimerSlot
+{
+    iocTimer *first;
+}
+iocTimerSlot;
+
+
+/**
+****************************************************************************************************
+    Timer wheel, member of the root object. Protected by ioc_lock().
+****************************************************************************************************
+*/
+typedef struct iocTimerWheel
+{
+    /** Timer slots for each level.
+     */
+    iocTimerSlot slot[IOC_TIMER_WHEEL_LEVELS][IOC_TIMER_WHEEL_SLOTS];
+
+    /** Timer at tick zero and next tick to process. All timers due before this tick
+        have been called.
+     */
+    os_timer start_timer;
+    os_int64 tick;
+
+    /** Number of timers set.
+     */
+    os_int count;
+
+    /** Tick at which the timer wheel thread is going to wake up next, used to tell if
+        the thread needs to be triggered when a timer is set.
+     */
+    os_int64 wakeup_tick;
+
+    /** Timer wheel thread, started when the first timer is set.
+     */
+    osalThread *thread;
+    osalEvent trig;
+    volatile os_boolean stop_thread;
+    os_boolean started;
+}
+iocTimerWheel;
+
+
+/**
+****************************************************************************************************
+  Timer wheel functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Set or reset timer to call func after timeout_ms (ioc_lock must be on).
+ */
+osalStatus ioc_set_timer(
+    struct iocRoot *root,
+    iocTimer *timer,
+    os_int timeout_ms,
+    ioc_timer_func *func,
+    void *context);
+
+/* Cancel timer, if set (ioc_lock must be on).
+ */
+void ioc_cancel_timer(
+    struct iocRoot *root,
+    iocTimer *timer);
+
+/* Stop timer wheel thread (ioc_lock must not be on).
+ */
+void ioc_release_timer_wheel(
+    struct iocRoot *root);
+
+/*@}*/
+
+#endif
+#endif
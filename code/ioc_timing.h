@@ -50,6 +50,13 @@
 #define IOC_SOCKET_SILENCE_MS 20000
 #endif
 
+/* Lower priority memory block data, which has been waiting to be sent this long, is
+   sent as if it was high priority data. This prevents starving bulk transfers.
+ */
+#ifndef IOC_SEND_STARVATION_MS
+#define IOC_SEND_STARVATION_MS 200
+#endif
+
 /* How often to send CONNECT character while establishing serial connection.
  */
 #ifndef IOC_SERIAL_CONNECT_PERIOD_MS 
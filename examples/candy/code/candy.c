@@ -299,6 +299,12 @@ osalStatus osal_main(
     ioc_initialize_brick_buffer(&video_output, &candy.camera,
         &ioboard_root, 4000, IOC_BRICK_DEVICE);
 
+    /* Publish video rate control telemetry in "exp" memory block.
+     */
+    iocBrickRateSignals rate_sigs;
+    IOC_SET_BRICK_RATE_SIGNALS(rate_sigs, candy);
+    ioc_set_brick_rate_signals(&video_output, &rate_sigs);
+
     pinsCameraParams camera_prm;
     PINS_CAMERA_IFACE.initialize();
     os_memclear(&camera_prm, sizeof(camera_prm));
@@ -633,6 +639,9 @@ static void ioboard_camera_callback(
                 trigger_motion_detect(&motion);
             }
         }
+        else if (ioc_is_brick_connected(&video_output)) {
+            ioc_brick_frame_skipped(&video_output);
+        }
     }
 }
 
@@ -556,5 +556,9 @@ void ioboard_camera_callback(
         photo->iface->finalize_photo(photo);
         pins_store_photo_as_brick(photo, &video_output, IOC_DEFAULT_COMPRESSION);
     }
+    else if (ioc_is_brick_connected(&video_output))
+    {
+        ioc_brick_frame_skipped(&video_output);
+    }
 }
 #endif
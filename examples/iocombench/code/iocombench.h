@@ -0,0 +1,264 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench.h
+  @brief   End to end benchmarks for iocom library.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Benchmark scenarios run device and controller roots in one process, connected by loopback
+  stream (iocomTestPair shared with iocomtest), and print one result line per metric:
+  "scenario.metric value unit". Command line selects scenarios by name and sets options as
+  name=value, for example "iocombench loopback delay=20".
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOCOMBENCH_H_
+#define IOCOMBENCH_H_
+#include "iocomtest.h"
+
+/* Loopback name used by benchmarks.
+ */
+#define IOCOMBENCH_NAME "iocombench"
+
+/* Benchmark scenario function.
+ */
+typedef void iocombench_func(void);
+
+/* Background load function, called once per loop round while measuring.
+ */
+typedef void iocombench_load_func(
+    void *context);
+
+
+/**
+****************************************************************************************************
+    Echo round trip: Device writes sequence number to "exp", controller echoes it back
+    through "imp". Time from device's write until the echo is received is one round trip.
+****************************************************************************************************
+*/
+typedef struct iocomBenchEcho
+{
+    iocomTestPair *p;
+
+    /** Device's and controller's "exp" and "imp" memory blocks.
+     */
+    iocHandle dexp, dimp, cexp, cimp;
+
+    /** Optional background load, OS_NULL if none.
+     */
+    iocombench_load_func *load_func;
+    void *load_context;
+}
+iocomBenchEcho;
+
+#if IOC_STREAMER_SUPPORT
+/* Streamer signals, index in iocomBenchStreamer signal arrays.
+ */
+#define IOCOMBENCH_STREAM_CMD 0
+#define IOCOMBENCH_STREAM_SELECT 1
+#define IOCOMBENCH_STREAM_ERR 2
+#define IOCOMBENCH_STREAM_CS 3
+#define IOCOMBENCH_STREAM_BUF 4
+#define IOCOMBENCH_STREAM_HEAD 5
+#define IOCOMBENCH_STREAM_TAIL 6
+#define IOCOMBENCH_STREAM_STATE 7
+#define IOCOMBENCH_STREAM_NRO_SIGNALS 8
+
+
+/**
+****************************************************************************************************
+    Ring buffer streamer signals at device and controller end of test pair. Signals written
+    by device are in "exp", signals written by controller in "imp".
+****************************************************************************************************
+*/
+typedef struct iocomBenchStreamer
+{
+    /** Device's and controller's "exp" and "imp" memory blocks.
+     */
+    iocHandle dexp, dimp, cexp, cimp;
+
+    /** Streamer signals at device and controller end.
+     */
+    iocSignal dsig[IOCOMBENCH_STREAM_NRO_SIGNALS];
+    iocSignal csig[IOCOMBENCH_STREAM_NRO_SIGNALS];
+    iocStreamerSignals dsignals, csignals;
+}
+iocomBenchStreamer;
+#endif
+
+
+/**
+****************************************************************************************************
+  Benchmark utility functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Store command line options.
+ */
+void iocombench_set_options(
+    os_int argc,
+    os_char *argv[]);
+
+/* Get integer option given as name=value on command line.
+ */
+os_long iocombench_option(
+    const os_char *name,
+    os_long default_value);
+
+/* Print benchmark result line.
+ */
+void iocombench_result(
+    const os_char *scenario,
+    const os_char *metric,
+    os_double value,
+    const os_char *unit);
+
+/* Sort samples and get percentile.
+ */
+os_int64 iocombench_percentile(
+    os_int64 *samples,
+    os_int n,
+    os_int percent);
+
+/* Get CPU time used by the process, ms. Negative if not available.
+ */
+os_double iocombench_cpu_ms(void);
+
+/* Get CPU time used by the calling thread, ms. Negative if not available.
+ */
+os_double iocombench_thread_cpu_ms(void);
+
+/* Set loopback delay from "delay" option and connect test pair.
+ */
+osalStatus iocombench_connect_pair(
+    iocomTestPair *p);
+
+/* Create echo memory blocks, before connecting the pair.
+ */
+void iocombench_setup_echo(
+    iocomBenchEcho *e,
+    iocomTestPair *p,
+    os_char priority);
+
+/* Measure echo round trips.
+ */
+os_int iocombench_run_echo(
+    iocomBenchEcho *e,
+    os_int64 *samples,
+    os_int rounds);
+
+/* Release echo memory block handles.
+ */
+void iocombench_release_echo(
+    iocomBenchEcho *e);
+
+/* Print round trip percentiles.
+ */
+void iocombench_rtt_results(
+    const os_char *scenario,
+    const os_char *prefix,
+    os_int64 *samples,
+    os_int n);
+
+/* Open more connections from device to controller of connected test pair.
+ */
+osalStatus iocombench_connect_more(
+    iocomTestPair *p,
+    iocConnection **cons,
+    os_int n,
+    os_short flags);
+
+/* Release connections opened by iocombench_connect_more().
+ */
+void iocombench_release_more(
+    iocConnection **cons,
+    os_int n);
+
+#if IOC_STREAMER_SUPPORT
+/* Create ring buffer streamer memory blocks and signals, before connecting the pair.
+ */
+void iocombench_setup_streamer(
+    iocomBenchStreamer *s,
+    iocomTestPair *p,
+    os_int buf_sz,
+    os_boolean to_device);
+
+/* Release streamer memory block handles.
+ */
+void iocombench_release_streamer(
+    iocomBenchStreamer *s);
+#endif
+
+/*@}*/
+
+
+/**
+****************************************************************************************************
+  Benchmark scenarios
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Round trip latency and bulk throughput over loopback connection.
+ */
+void iocombench_loopback(void);
+
+/* Latency of normal and high priority memory block under bulk load.
+ */
+void iocombench_priority(void);
+
+/* Lighthouse client network table with many networks.
+ */
+void iocombench_lighthouse(void);
+
+/* Dynamic signal information with many signals.
+ */
+void iocombench_signals(void);
+
+/* Memory block lookups in a root with many memory blocks.
+ */
+void iocombench_mblkindex(void);
+
+/* Sync buffer memory of a large memory block linked to many connections.
+ */
+void iocombench_syncbufs(void);
+
+/* Main loop cost of ioc_send_all() and ioc_receive_all() with many memory blocks.
+ */
+void iocombench_sendall(void);
+
+/* CPU used by many idle connections running in their own threads.
+ */
+void iocombench_idle(void);
+
+/* Connect and reconnect storm of many devices against a threaded server.
+ */
+void iocombench_storm(void);
+
+/* Sustained record rate of memory block recorder.
+ */
+void iocombench_recorder(void);
+
+/* Brick transfer over flat and ring buffer.
+ */
+void iocombench_brick(void);
+
+/* Streamer upload from controller to device.
+ */
+void iocombench_upload(void);
+
+/* Lossless sample rate of sampler over flat brick buffer.
+ */
+void iocombench_sampler(void);
+
+/*@}*/
+
+#endif
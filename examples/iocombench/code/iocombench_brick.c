@@ -0,0 +1,284 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_brick.c
+  @brief   Brick (camera image) transfer over flat and ring buffer.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Device sends uncompressed grayscale images as bricks to controller as fast as the brick
+  buffer accepts them, first through flat buffer (whole brick in one memory block signal,
+  acknowledged by controller) and then through ring buffer streamer. Rate control's frame
+  interval limit is disabled (link share 100%), so the transfer itself is measured. Prints
+  bricks received per second, throughput and process CPU use for both (flat_bricks_per_s,
+  flat_throughput, flat_cpu, ring_bricks_per_s, ring_throughput, ring_cpu).
+
+  Options: w=N and h=N image size in pixels (default 320 x 240), seconds=N measurement time
+  for each (default 3), ring=N ring buffer size in bytes (default 16384).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_STREAMER_SUPPORT
+
+/* Forward referred static functions.
+ */
+static void iocombench_brick_flat(void);
+
+#if IOC_BRICK_RING_BUFFER_SUPPORT && IOC_DEVICE_STREAMER
+static void iocombench_brick_ring(void);
+#endif
+
+static void iocombench_brick_measure(
+    const os_char *prefix,
+    iocBrickBuffer *send,
+    iocBrickBuffer *receive,
+    iocomTestPair *p);
+
+static os_boolean iocombench_brick_round(
+    iocBrickBuffer *send,
+    iocBrickBuffer *receive,
+    iocomTestPair *p,
+    os_uchar *image,
+    os_int w,
+    os_int h);
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick transfer benchmark.
+  @anchor iocombench_brick
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_brick(void)
+{
+    iocombench_brick_flat();
+#if IOC_BRICK_RING_BUFFER_SUPPORT && IOC_DEVICE_STREAMER
+    iocombench_brick_ring();
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Measure flat buffer brick transfer (internal).
+  @anchor iocombench_brick_flat
+
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_brick_flat(void)
+{
+    iocomTestPair p;
+    iocomTestBrickPair *bp;
+    os_int w, h;
+
+    w = (os_int)iocombench_option("w", 320);
+    h = (os_int)iocombench_option("h", 240);
+    if (w <= 0 || h <= 0) return;
+    bp = (iocomTestBrickPair*)os_malloc(sizeof(iocomTestBrickPair), OS_NULL);
+    if (bp == OS_NULL) return;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocomtest_setup_brick_pair(bp, &p, (os_int)sizeof(iocBrickHdr) + w * h);
+    ioc_set_brick_rate_target(&bp->send, IOC_BRICK_DEFAULT_TARGET_LATENCY_MS, 100);
+    iocombench_connect_pair(&p);
+
+    iocombench_brick_measure("flat_", &bp->send, &bp->receive, &p);
+
+    iocomtest_release_brick_pair(bp);
+    iocomtest_release_pair(&p);
+    os_free(bp, sizeof(iocomTestBrickPair));
+}
+
+
+#if IOC_BRICK_RING_BUFFER_SUPPORT && IOC_DEVICE_STREAMER
+/**
+****************************************************************************************************
+
+  @brief Measure ring buffer brick transfer (internal).
+  @anchor iocombench_brick_ring
+
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_brick_ring(void)
+{
+    iocomTestPair p;
+    iocomBenchStreamer *st;
+    iocBrickBuffer *send, *receive;
+    os_int w, h, ring_sz;
+
+    w = (os_int)iocombench_option("w", 320);
+    h = (os_int)iocombench_option("h", 240);
+    ring_sz = (os_int)iocombench_option("ring", 16384);
+    if (w <= 0 || h <= 0 || ring_sz <= 0) return;
+    st = (iocomBenchStreamer*)os_malloc(sizeof(iocomBenchStreamer), OS_NULL);
+    send = (iocBrickBuffer*)os_malloc(sizeof(iocBrickBuffer), OS_NULL);
+    receive = (iocBrickBuffer*)os_malloc(sizeof(iocBrickBuffer), OS_NULL);
+    if (st == OS_NULL || send == OS_NULL || receive == OS_NULL) goto getout;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocombench_setup_streamer(st, &p, ring_sz, OS_FALSE);
+    ioc_initialize_brick_buffer(send, &st->dsignals, &p.device, 0, IOC_BRICK_DEVICE);
+    ioc_allocate_brick_buffer(send, (os_int)sizeof(iocBrickHdr) + w * h);
+    ioc_set_brick_rate_target(send, IOC_BRICK_DEFAULT_TARGET_LATENCY_MS, 100);
+    ioc_initialize_brick_buffer(receive, &st->csignals, &p.controller, 0,
+        IOC_BRICK_CONTROLLER);
+    ioc_brick_set_receive(receive, OS_TRUE);
+    iocombench_connect_pair(&p);
+
+    iocombench_brick_measure("ring_", send, receive, &p);
+
+    ioc_release_brick_buffer(send);
+    ioc_release_brick_buffer(receive);
+    iocombench_release_streamer(st);
+    iocomtest_release_pair(&p);
+
+getout:
+    if (st) os_free(st, sizeof(iocomBenchStreamer));
+    if (send) os_free(send, sizeof(iocBrickBuffer));
+    if (receive) os_free(receive, sizeof(iocBrickBuffer));
+}
+#endif
+
+
+/**
+****************************************************************************************************
+
+  @brief Send bricks for "seconds" and print results (internal).
+  @anchor iocombench_brick_measure
+
+  @param   prefix Metric name prefix, "flat_" or "ring_".
+  @param   send Device's sending brick buffer.
+  @param   receive Controller's receiving brick buffer.
+  @param   p Pointer to connected test pair.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_brick_measure(
+    const os_char *prefix,
+    iocBrickBuffer *send,
+    iocBrickBuffer *receive,
+    iocomTestPair *p)
+{
+    os_uchar *image;
+    os_int w, h, seconds, i, nreceived;
+    os_int64 start_us, end_us;
+    os_double cpu_ms, s;
+    os_timer start_t;
+    os_char metric[32];
+
+    w = (os_int)iocombench_option("w", 320);
+    h = (os_int)iocombench_option("h", 240);
+    seconds = (os_int)iocombench_option("seconds", 3);
+    image = (os_uchar*)os_malloc(w * h, OS_NULL);
+    if (image == OS_NULL) return;
+    for (i = 0; i < w * h; i++) image[i] = (os_uchar)(i * 7);
+
+    /* Wait until the first brick has been received, so that connect time is not measured.
+     */
+    os_get_timer(&start_t);
+    while (!iocombench_brick_round(send, receive, p, image, w, h))
+    {
+        if (os_has_elapsed(&start_t, IOCOMTEST_TIMEOUT_MS))
+        {
+            osal_console_write("brick: no brick received\n");
+            goto getout;
+        }
+    }
+
+    nreceived = 0;
+    cpu_ms = iocombench_cpu_ms();
+    os_get_timer(&start_t);
+    os_time(&start_us);
+    while (!os_has_elapsed(&start_t, 1000 * seconds))
+    {
+        if (iocombench_brick_round(send, receive, p, image, w, h)) nreceived++;
+    }
+    os_time(&end_us);
+    s = (end_us - start_us) / 1000000.0;
+
+    os_strncpy(metric, prefix, sizeof(metric));
+    os_strncat(metric, "bricks_per_s", sizeof(metric));
+    iocombench_result("brick", metric, nreceived / s, "1/s");
+    os_strncpy(metric, prefix, sizeof(metric));
+    os_strncat(metric, "throughput", sizeof(metric));
+    iocombench_result("brick", metric,
+        nreceived * (os_double)(sizeof(iocBrickHdr) + w * h) / s / 1.0e6, "MB/s");
+    if (cpu_ms >= 0) {
+        os_strncpy(metric, prefix, sizeof(metric));
+        os_strncat(metric, "cpu", sizeof(metric));
+        iocombench_result("brick", metric,
+            100.0 * (iocombench_cpu_ms() - cpu_ms) / (1000.0 * s), "%");
+    }
+
+getout:
+    os_free(image, w * h);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Store new brick if sender is ready, move data and run receiver once (internal).
+  @anchor iocombench_brick_round
+
+  @param   send Device's sending brick buffer.
+  @param   receive Controller's receiving brick buffer.
+  @param   p Pointer to connected test pair.
+  @param   image Grayscale image to send.
+  @param   w Image width in pixels.
+  @param   h Image height in pixels.
+  @return  OS_TRUE if a brick was received.
+
+****************************************************************************************************
+*/
+static os_boolean iocombench_brick_round(
+    iocBrickBuffer *send,
+    iocBrickBuffer *receive,
+    iocomTestPair *p,
+    os_uchar *image,
+    os_int w,
+    os_int h)
+{
+    iocBrickHdr hdr;
+    os_memsz alloc_sz;
+
+    if (ioc_ready_for_new_brick(send) && ioc_is_brick_connected(send))
+    {
+        alloc_sz = sizeof(iocBrickHdr) + w * h;
+        os_memclear(&hdr, sizeof(iocBrickHdr));
+        hdr.alloc_sz[0] = (os_uchar)alloc_sz;
+        hdr.alloc_sz[1] = (os_uchar)(alloc_sz >> 8);
+        hdr.alloc_sz[2] = (os_uchar)(alloc_sz >> 16);
+        hdr.alloc_sz[3] = (os_uchar)(alloc_sz >> 24);
+        image[0]++;
+        ioc_compress_brick(send, &hdr, image, w * h, OSAL_GRAYSCALE8, w, h, IOC_UNCOMPRESSED);
+    }
+
+    ioc_run_brick_send(send);
+    ioc_send_all(&p->device);
+    ioc_send_all(&p->controller);
+    iocomtest_run_pair(p);
+    ioc_receive_all(&p->device);
+    ioc_receive_all(&p->controller);
+    return (os_boolean)(ioc_run_brick_receive(receive) == OSAL_COMPLETED);
+}
+
+#else
+void iocombench_brick(void) {}
+#endif
@@ -0,0 +1,152 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_idle.c
+  @brief   CPU used by many idle connections running in their own threads.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Controller listens with IOC_CREATE_THREAD and device opens "conns" loopback connections,
+  each run by its own thread, so there are two connection threads per connection like on a
+  server with as many devices. Once all connections are up and memory blocks have been
+  transferred, nothing is written and the process CPU time used over "seconds" is measured.
+  With IOC_TIMER_WHEEL idle connections wait for keep alive and silence timers on the root's
+  timer wheel, without it each connection thread wakes every IOC_SOCKET_CHECK_TIMEOUTS_MS.
+  Build with IOC_TIMER_WHEEL=0 for comparison. CPU time is available on Linux only.
+
+  Options: conns=N number of connections (default 5000), seconds=N measurement time
+  (default 10).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if OSAL_MULTITHREAD_SUPPORT
+
+/* Forward referred static functions.
+ */
+static os_int iocombench_nro_connected(
+    iocRoot *root);
+
+
+/**
+****************************************************************************************************
+
+  @brief Idle connection CPU benchmark.
+  @anchor iocombench_idle
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_idle(void)
+{
+    iocomTestPair p;
+    iocEndPointParams epprm;
+    iocHandle dexp, cexp;
+    iocConnection **cons;
+    os_int nconns, seconds, n;
+    os_int64 start_us, end_us;
+    os_double cpu_start, cpu_end;
+    os_timer start_t;
+
+    nconns = (os_int)iocombench_option("conns", 5000);
+    seconds = (os_int)iocombench_option("seconds", 10);
+    if (nconns <= 0 || seconds <= 0) return;
+    cons = (iocConnection**)os_malloc(nconns * sizeof(iocConnection*), OS_NULL);
+    if (cons == OS_NULL) return;
+    os_memclear(cons, nconns * sizeof(iocConnection*));
+
+    iocombench_result("idle", "timer_wheel", IOC_TIMER_WHEEL, "");
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocomtest_memory_block(&dexp, &p.device, "exp", 16, IOC_MBLK_UP);
+    iocomtest_memory_block(&cexp, &p.controller, "exp", 16, IOC_MBLK_UP);
+
+    p.epoint = ioc_initialize_end_point(OS_NULL, &p.controller);
+    os_memclear(&epprm, sizeof(epprm));
+    epprm.iface = IOC_LOOPBACK_IFACE;
+    epprm.flags = IOC_SOCKET|IOC_CREATE_THREAD;
+    epprm.parameters = p.name;
+    if (ioc_listen(p.epoint, &epprm)) goto getout;
+
+    os_time(&start_us);
+    iocombench_connect_more(&p, cons, nconns, IOC_CREATE_THREAD);
+    os_get_timer(&start_t);
+    while ((n = iocombench_nro_connected(&p.controller)) < nconns)
+    {
+        if (os_has_elapsed(&start_t, 120000)) break;
+        os_sleep(100);
+    }
+    os_time(&end_us);
+    iocombench_result("idle", "connected", n, "");
+    if (n < nconns)
+    {
+        osal_console_write("idle: not all connections were set up\n");
+        goto getout;
+    }
+    iocombench_result("idle", "connect_all", (end_us - start_us) / 1000.0, "ms");
+
+    /* Let memory block information and key frames settle before measuring.
+     */
+    os_sleep(2000);
+
+    cpu_start = iocombench_cpu_ms();
+    os_time(&start_us);
+    os_sleep(seconds * 1000);
+    cpu_end = iocombench_cpu_ms();
+    os_time(&end_us);
+    if (cpu_start < 0.0)
+    {
+        osal_console_write("idle: process CPU time not available\n");
+        goto getout;
+    }
+    iocombench_result("idle", "cpu_percent",
+        100.0 * (cpu_end - cpu_start) * 1000.0 / (end_us - start_us), "%");
+    iocombench_result("idle", "cpu_us_per_con_s",
+        (cpu_end - cpu_start) * 1000.0 * 1000000.0 / ((os_double)(end_us - start_us) * nconns),
+        "us");
+
+getout:
+    iocombench_release_more(cons, nconns);
+    ioc_release_handle(&dexp);
+    ioc_release_handle(&cexp);
+    iocomtest_release_pair(&p);
+    os_free(cons, nconns * sizeof(iocConnection*));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Count root's connected connections (internal).
+  @anchor iocombench_nro_connected
+
+  @param   root Pointer to root object.
+  @return  Number of connections with connected flag set.
+
+****************************************************************************************************
+*/
+static os_int iocombench_nro_connected(
+    iocRoot *root)
+{
+    iocConnection *con;
+    os_int n;
+
+    n = 0;
+    ioc_lock(root);
+    for (con = root->con.first; con; con = con->link.next)
+    {
+        if (con->connected) n++;
+    }
+    ioc_unlock(root);
+    return n;
+}
+
+#else
+void iocombench_idle(void) {}
+#endif
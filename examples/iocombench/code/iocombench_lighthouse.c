@@ -0,0 +1,170 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_lighthouse.c
+  @brief   Lighthouse client network table with many networks.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Multicasts of "nets" servers, each publishing one IO network, are built in memory and replayed
+  to lighthouse client through ioc_process_lighthouse_multicast(), so no UDP socket is needed.
+  Time per processed multicast and per ioc_get_lighthouse_connectstr() lookup are printed.
+  With linear search both grew with number of networks, with hashed table they should not.
+
+  Options: nets=N number of networks (default 1000), rounds=N times each multicast is
+  replayed (default 20).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#include "lighthouse.h"
+
+/* TCP port published in replayed multicasts.
+ */
+#define IOCOMBENCH_LIGHTHOUSE_PORT 6368
+
+/* Forward referred static functions.
+ */
+static void iocombench_lighthouse_msg(
+    LighthouseMessage *msg,
+    os_char *ip_addr,
+    os_char *network_name,
+    os_int k);
+
+
+/**
+****************************************************************************************************
+
+  @brief Lighthouse benchmark.
+  @anchor iocombench_lighthouse
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_lighthouse(void)
+{
+    LighthouseClient c;
+    LighthouseMessage *msgs, msg;
+    os_char *ips, *names, connectstr[OSAL_HOST_BUF_SZ];
+    os_int nets, rounds, found, i, k;
+    os_memsz bytes;
+    os_int64 start_us, end_us;
+    os_timer received_timer;
+
+    nets = (os_int)iocombench_option("nets", 1000);
+    rounds = (os_int)iocombench_option("rounds", 20);
+    msgs = (LighthouseMessage*)os_malloc(nets * sizeof(LighthouseMessage), OS_NULL);
+    ips = (os_char*)os_malloc(nets * OSAL_IPADDR_SZ, OS_NULL);
+    names = (os_char*)os_malloc(nets * IOC_NETWORK_NAME_SZ, OS_NULL);
+    if (msgs == OS_NULL || ips == OS_NULL || names == OS_NULL) goto getout;
+
+    for (k = 0; k < nets; k++)
+    {
+        iocombench_lighthouse_msg(msgs + k, ips + k * OSAL_IPADDR_SZ,
+            names + k * IOC_NETWORK_NAME_SZ, k);
+    }
+
+    ioc_initialize_lighthouse_client(&c, OS_FALSE, OS_FALSE, OS_NULL);
+
+    /* Replay multicasts. Message is copied since processing clears the checksum.
+     */
+    os_get_timer(&received_timer);
+    os_time(&start_us);
+    for (i = 0; i < rounds; i++)
+    {
+        for (k = 0; k < nets; k++)
+        {
+            bytes = sizeof(LighthouseMessageHdr) + msgs[k].hdr.publish_sz;
+            os_memcpy(&msg, msgs + k, bytes);
+            ioc_process_lighthouse_multicast(&c, &msg, bytes,
+                ips + k * OSAL_IPADDR_SZ, &received_timer);
+        }
+    }
+    os_time(&end_us);
+    iocombench_result("lighthouse", "us_per_multicast",
+        (end_us - start_us) / ((os_double)rounds * nets), "us");
+
+    /* Look up every network by name.
+     */
+    found = 0;
+    os_time(&start_us);
+    for (k = 0; k < nets; k++)
+    {
+        if (ioc_get_lighthouse_connectstr(&c, LIGHTHOUSE_GET_CONNECT_STR,
+            names + k * IOC_NETWORK_NAME_SZ, IOC_SOCKET,
+            connectstr, sizeof(connectstr)) == OSAL_SUCCESS)
+        {
+            found++;
+        }
+    }
+    os_time(&end_us);
+    iocombench_result("lighthouse", "us_per_lookup", (end_us - start_us) / (os_double)nets, "us");
+    iocombench_result("lighthouse", "found", found, "");
+
+    ioc_release_lighthouse_client(&c);
+
+getout:
+    if (msgs) os_free(msgs, nets * sizeof(LighthouseMessage));
+    if (ips) os_free(ips, nets * OSAL_IPADDR_SZ);
+    if (names) os_free(names, nets * IOC_NETWORK_NAME_SZ);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Build lighthouse multicast of one server (internal).
+  @anchor iocombench_lighthouse_msg
+
+  Server k is at IP address 10.0.k/256.k%256 and publishes network "net<k>" for plain TCP
+  socket, like lighthouse server would.
+
+  @param   msg Where to store the message.
+  @param   ip_addr Where to store IP address, OSAL_IPADDR_SZ bytes.
+  @param   network_name Where to store network name, IOC_NETWORK_NAME_SZ bytes.
+  @param   k Server number.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_lighthouse_msg(
+    LighthouseMessage *msg,
+    os_char *ip_addr,
+    os_char *network_name,
+    os_int k)
+{
+    os_char nbuf[OSAL_NBUF_SZ];
+    os_memsz bytes;
+    os_ushort checksum;
+
+    os_strncpy(ip_addr, "10.0.", OSAL_IPADDR_SZ);
+    osal_int_to_str(nbuf, sizeof(nbuf), (k >> 8) & 0xFF);
+    os_strncat(ip_addr, nbuf, OSAL_IPADDR_SZ);
+    os_strncat(ip_addr, ".", OSAL_IPADDR_SZ);
+    osal_int_to_str(nbuf, sizeof(nbuf), k & 0xFF);
+    os_strncat(ip_addr, nbuf, OSAL_IPADDR_SZ);
+
+    os_strncpy(network_name, "net", IOC_NETWORK_NAME_SZ);
+    osal_int_to_str(nbuf, sizeof(nbuf), k);
+    os_strncat(network_name, nbuf, IOC_NETWORK_NAME_SZ);
+
+    os_memclear(msg, sizeof(LighthouseMessage));
+    os_strncpy(msg->publish, "bench,s:i:", LIGHTHOUSE_PUBLISH_SZ);
+    os_strncat(msg->publish, network_name, LIGHTHOUSE_PUBLISH_SZ);
+    msg->hdr.msg_id = LIGHTHOUSE_MSG_ID;
+    msg->hdr.hdr_sz = (os_uchar)sizeof(LighthouseMessageHdr);
+    msg->hdr.publish_sz = (os_uchar)os_strlen(msg->publish);
+    msg->hdr.tcp_port_nr_low = (os_uchar)IOCOMBENCH_LIGHTHOUSE_PORT;
+    msg->hdr.tcp_port_nr_high = (os_uchar)(IOCOMBENCH_LIGHTHOUSE_PORT >> 8);
+
+    bytes = sizeof(LighthouseMessageHdr) + (os_memsz)msg->hdr.publish_sz;
+    checksum = os_checksum((const os_char*)msg, bytes, OS_NULL);
+    msg->hdr.checksum_low = (os_uchar)checksum;
+    msg->hdr.checksum_high = (os_uchar)(checksum >> 8);
+}
@@ -0,0 +1,172 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_loopback.c
+  @brief   Round trip latency and bulk throughput over loopback connection.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Latency: Echo round trip of small memory block, see iocomBenchEcho. Throughput: Device
+  rewrites the whole "bulk" memory block as fast as it can be sent, controller counts
+  versions received.
+
+  Options: rounds=N round trips (default 2000), seconds=N throughput run time (default 3),
+  bulk=N bulk memory block size (default 16384), delay=N one way delay ms (default 0).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+
+/* Forward referred static functions.
+ */
+static void iocombench_loopback_latency(void);
+
+static void iocombench_loopback_throughput(void);
+
+
+/**
+****************************************************************************************************
+
+  @brief Loopback latency and throughput benchmark.
+  @anchor iocombench_loopback
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_loopback(void)
+{
+    iocombench_loopback_latency();
+    iocombench_loopback_throughput();
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Measure round trip latency (internal).
+  @anchor iocombench_loopback_latency
+
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_loopback_latency(void)
+{
+    iocomTestPair p;
+    iocomBenchEcho e;
+    os_int64 *samples;
+    os_int rounds, n;
+
+    rounds = (os_int)iocombench_option("rounds", 2000);
+    samples = (os_int64*)os_malloc(rounds * sizeof(os_int64), OS_NULL);
+    if (samples == OS_NULL) return;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocombench_setup_echo(&e, &p, IOC_MBLK_PRIORITY_NORMAL);
+    iocombench_connect_pair(&p);
+
+    n = iocombench_run_echo(&e, samples, rounds);
+    iocombench_result("loopback", "round_trips", n, "");
+    iocombench_rtt_results("loopback", OS_NULL, samples, n);
+
+    iocombench_release_echo(&e);
+    iocomtest_release_pair(&p);
+    os_free(samples, rounds * sizeof(os_int64));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Measure bulk throughput (internal).
+  @anchor iocombench_loopback_throughput
+
+  Sends are not paced: When the synchronization buffer is busy, ioc_send() merges the new
+  version into pending changes, so received versions can be fewer than written.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_loopback_throughput(void)
+{
+    iocomTestPair p;
+    iocHandle dbulk, cbulk;
+    os_char *buf;
+    os_int bulk_sz, seconds, version, received, prev_received, nro_received, i;
+    os_int64 start_us, end_us;
+    os_double cpu_ms, s;
+    os_timer start_t;
+
+    bulk_sz = (os_int)iocombench_option("bulk", 16384);
+    seconds = (os_int)iocombench_option("seconds", 3);
+    buf = (os_char*)os_malloc(bulk_sz, OS_NULL);
+    if (buf == OS_NULL) return;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocomtest_memory_block(&dbulk, &p.device, "bulk", bulk_sz, IOC_MBLK_UP);
+    iocomtest_memory_block(&cbulk, &p.controller, "bulk", bulk_sz, IOC_MBLK_UP);
+    iocombench_connect_pair(&p);
+
+    /* Wait for connection, so that connect time is not measured.
+     */
+    version = 0;
+    prev_received = 0;
+    nro_received = 0;
+    os_get_timer(&start_t);
+    while (nro_received == 0 && !os_has_elapsed(&start_t, IOCOMTEST_TIMEOUT_MS))
+    {
+        iocomtest_set_int(&dbulk, 0, ++version);
+        ioc_send(&dbulk);
+        iocomtest_run_pair(&p);
+        ioc_receive(&cbulk);
+        if (iocomtest_get_int(&cbulk, 0)) nro_received = 1;
+    }
+
+    nro_received = 0;
+    prev_received = iocomtest_get_int(&cbulk, 0);
+    cpu_ms = iocombench_cpu_ms();
+    os_get_timer(&start_t);
+    os_time(&start_us);
+    while (!os_has_elapsed(&start_t, 1000 * seconds))
+    {
+        /* Change every byte, so that nothing is left out by delta encoding.
+         */
+        version++;
+        for (i = 4; i < bulk_sz; i++) buf[i] = (os_char)(version + i * 7);
+        ioc_write(&dbulk, 4, buf + 4, bulk_sz - 4, 0);
+        iocomtest_set_int(&dbulk, 0, version);
+        ioc_send(&dbulk);
+
+        iocomtest_run_pair(&p);
+
+        ioc_receive(&cbulk);
+        received = iocomtest_get_int(&cbulk, 0);
+        if (received != prev_received)
+        {
+            prev_received = received;
+            nro_received++;
+        }
+    }
+    os_time(&end_us);
+    s = (end_us - start_us) / 1000000.0;
+
+    iocombench_result("loopback", "versions_per_s", nro_received / s, "1/s");
+    iocombench_result("loopback", "throughput",
+        nro_received * (os_double)bulk_sz / s / 1.0e6, "MB/s");
+    if (cpu_ms >= 0) {
+        iocombench_result("loopback", "cpu",
+            100.0 * (iocombench_cpu_ms() - cpu_ms) / (1000.0 * s), "%");
+    }
+
+    ioc_release_handle(&dbulk);
+    ioc_release_handle(&cbulk);
+    iocomtest_release_pair(&p);
+    os_free(buf, bulk_sz);
+}
@@ -0,0 +1,128 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_main.c
+  @brief   End to end benchmarks for iocom library.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+
+/* If needed for the operating system, EOSAL_C_MAIN macro generates the actual C main() function.
+ */
+EOSAL_C_MAIN
+
+/** Benchmark scenario name and function.
+ */
+typedef struct iocomBenchScenario
+{
+    const os_char *name;
+    iocombench_func *func;
+}
+iocomBenchScenario;
+
+/* Benchmark scenarios, run in this order when no scenario is named on command line.
+ */
+static const iocomBenchScenario iocombench_scenarios[] = {
+    {"loopback", iocombench_loopback},
+    {"priority", iocombench_priority},
+    {"lighthouse", iocombench_lighthouse},
+    {"signals", iocombench_signals},
+    {"mblkindex", iocombench_mblkindex},
+    {"syncbufs", iocombench_syncbufs},
+    {"sendall", iocombench_sendall},
+    {"idle", iocombench_idle},
+    {"storm", iocombench_storm},
+    {"recorder", iocombench_recorder},
+    {"brick", iocombench_brick},
+    {"upload", iocombench_upload},
+    {"sampler", iocombench_sampler}
+};
+
+#define IOCOMBENCH_NRO_SCENARIOS \
+    ((os_int)(sizeof(iocombench_scenarios) / sizeof(iocomBenchScenario)))
+
+
+/**
+****************************************************************************************************
+
+  @brief Process entry point.
+
+  The osal_main() function runs benchmark scenarios named on command line, or all scenarios
+  if none is named. Arguments containing '=' are options for the scenarios.
+
+  @param   argc Number of command line arguments.
+  @param   argv Array of string pointers, one for each command line argument. UTF8 encoded.
+
+  @return  OSAL_SUCCESS, or OSAL_STATUS_FAILED if unknown scenario was named.
+
+****************************************************************************************************
+*/
+osalStatus osal_main(
+    os_int argc,
+    os_char *argv[])
+{
+    os_int i, j;
+    os_boolean named;
+    osalStatus s = OSAL_SUCCESS;
+
+    iocombench_set_options(argc, argv);
+
+    named = OS_FALSE;
+    for (i = 1; i < argc; i++)
+    {
+        if (os_strchr(argv[i], '=')) continue;
+        named = OS_TRUE;
+        for (j = 0; j < IOCOMBENCH_NRO_SCENARIOS; j++)
+        {
+            if (!os_strcmp(argv[i], iocombench_scenarios[j].name))
+            {
+                iocombench_scenarios[j].func();
+                break;
+            }
+        }
+        if (j == IOCOMBENCH_NRO_SCENARIOS)
+        {
+            osal_console_write("unknown scenario: ");
+            osal_console_write(argv[i]);
+            osal_console_write("\n");
+            s = OSAL_STATUS_FAILED;
+        }
+    }
+
+    if (!named)
+    {
+        for (j = 0; j < IOCOMBENCH_NRO_SCENARIOS; j++)
+        {
+            iocombench_scenarios[j].func();
+        }
+    }
+
+    return s;
+}
+
+
+/*  Empty function implementation needed to build for microcontroller.
+ */
+osalStatus osal_loop(
+    void *app_context)
+{
+    OSAL_UNUSED(app_context);
+    return OSAL_SUCCESS;
+}
+
+
+/*  Empty function implementation needed to build for microcontroller.
+ */
+void osal_main_cleanup(
+    void *app_context)
+{
+    OSAL_UNUSED(app_context);
+}
@@ -0,0 +1,167 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_mblkindex.c
+  @brief   Memory block lookups in a root with many memory blocks.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Creates "mblks" memory blocks in controller root of a test pair and looks each of them up
+  by names and by identifier through the memory block index. The same name lookups are also
+  made by scanning root's memory block list, which is what was done without the index.
+  Prints time per create, index lookup, list scan lookup and release.
+
+  Options: mblks=N number of memory blocks (default 10000).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_MBLK_INDEX
+
+/* Forward referred static functions.
+ */
+static iocMemoryBlock *iocombench_scan_mblk(
+    iocRoot *root,
+    const os_char *mblk_name);
+
+
+/**
+****************************************************************************************************
+
+  @brief Memory block index benchmark.
+  @anchor iocombench_mblkindex
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_mblkindex(void)
+{
+    iocomTestPair p;
+    iocHandle *handles;
+    iocRoot *root;
+    iocMemoryBlock *mblk;
+    os_uint *ids;
+    os_char mblk_name[IOC_NAME_SZ], nbuf[OSAL_NBUF_SZ];
+    os_int nmblks, found, k;
+    os_int64 start_us, end_us;
+
+    nmblks = (os_int)iocombench_option("mblks", 10000);
+    if (nmblks <= 0) return;
+    handles = (iocHandle*)os_malloc(nmblks * sizeof(iocHandle), OS_NULL);
+    ids = (os_uint*)os_malloc(nmblks * sizeof(os_uint), OS_NULL);
+    if (handles == OS_NULL || ids == OS_NULL) goto getout;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    root = &p.controller;
+
+    os_time(&start_us);
+    for (k = 0; k < nmblks; k++)
+    {
+        os_strncpy(mblk_name, "m", sizeof(mblk_name));
+        osal_int_to_str(nbuf, sizeof(nbuf), k);
+        os_strncat(mblk_name, nbuf, sizeof(mblk_name));
+        iocomtest_memory_block(handles + k, root, mblk_name, 16, IOC_MBLK_UP);
+    }
+    os_time(&end_us);
+    iocombench_result("mblkindex", "us_per_create", (end_us - start_us) / (os_double)nmblks, "us");
+
+    ioc_lock(root);
+    for (mblk = root->mblk.first, k = 0; mblk && k < nmblks; mblk = mblk->link.next, k++)
+    {
+        ids[k] = mblk->mblk_id;
+    }
+
+    found = 0;
+    os_time(&start_us);
+    for (k = 0; k < nmblks; k++)
+    {
+        os_strncpy(mblk_name, "m", sizeof(mblk_name));
+        osal_int_to_str(nbuf, sizeof(nbuf), k);
+        os_strncat(mblk_name, nbuf, sizeof(mblk_name));
+        if (ioc_mblk_index_find(root, IOCOMTEST_NETWORK_NAME, IOCOMTEST_DEVICE_NAME,
+            IOCOMTEST_DEVICE_NR, mblk_name)) found++;
+    }
+    os_time(&end_us);
+    iocombench_result("mblkindex", "us_per_find", (end_us - start_us) / (os_double)nmblks, "us");
+    iocombench_result("mblkindex", "found", found, "");
+
+    os_time(&start_us);
+    for (k = 0; k < nmblks; k++)
+    {
+        ioc_mblk_index_find_by_id(root, ids[k]);
+    }
+    os_time(&end_us);
+    iocombench_result("mblkindex", "us_per_find_by_id",
+        (end_us - start_us) / (os_double)nmblks, "us");
+
+    os_time(&start_us);
+    for (k = 0; k < nmblks; k++)
+    {
+        os_strncpy(mblk_name, "m", sizeof(mblk_name));
+        osal_int_to_str(nbuf, sizeof(nbuf), k);
+        os_strncat(mblk_name, nbuf, sizeof(mblk_name));
+        iocombench_scan_mblk(root, mblk_name);
+    }
+    os_time(&end_us);
+    ioc_unlock(root);
+    iocombench_result("mblkindex", "us_per_scan", (end_us - start_us) / (os_double)nmblks, "us");
+
+    os_time(&start_us);
+    for (k = 0; k < nmblks; k++)
+    {
+        ioc_release_memory_block(handles + k);
+    }
+    os_time(&end_us);
+    iocombench_result("mblkindex", "us_per_release",
+        (end_us - start_us) / (os_double)nmblks, "us");
+
+    iocomtest_release_pair(&p);
+
+getout:
+    if (handles) os_free(handles, nmblks * sizeof(iocHandle));
+    if (ids) os_free(ids, nmblks * sizeof(os_uint));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find memory block by scanning root's memory block list (internal).
+  @anchor iocombench_scan_mblk
+
+  Same match as the index, as done before the memory block index. ioc_lock() must be on.
+
+  @param   root Pointer to the root object.
+  @param   mblk_name Memory block name.
+  @return  Pointer to memory block, OS_NULL if not found.
+
+****************************************************************************************************
+*/
+static iocMemoryBlock *iocombench_scan_mblk(
+    iocRoot *root,
+    const os_char *mblk_name)
+{
+    iocMemoryBlock *mblk;
+
+    for (mblk = root->mblk.first; mblk; mblk = mblk->link.next)
+    {
+        if (mblk->device_nr == IOCOMTEST_DEVICE_NR &&
+            !os_strcmp(mblk->mblk_name, mblk_name) &&
+            !os_strcmp(mblk->device_name, IOCOMTEST_DEVICE_NAME) &&
+            !os_strcmp(mblk->network_name, IOCOMTEST_NETWORK_NAME))
+        {
+            return mblk;
+        }
+    }
+    return OS_NULL;
+}
+
+#else
+void iocombench_mblkindex(void) {}
+#endif
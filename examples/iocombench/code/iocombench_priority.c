@@ -0,0 +1,138 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_priority.c
+  @brief   Latency of small memory block while bulk data saturates the connection.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Device rewrites a "bulk" memory block on every loop round, so the connection is always busy.
+  Echo round trip of small memory block is measured once with normal priority and once with
+  IOC_MBLK_PRIORITY_HIGH. Without priority classes small block waits for its round robin turn
+  behind bulk frames.
+
+  Options: rounds=N round trips per run (default 1000), bulk=N bulk memory block size (default
+  32768), delay=N one way delay ms (default 0).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+
+/** Bulk load state.
+ */
+typedef struct iocomBenchBulk
+{
+    iocHandle dbulk, cbulk;
+    os_char *buf;
+    os_int sz;
+    os_int version;
+}
+iocomBenchBulk;
+
+/* Forward referred static functions.
+ */
+static void iocombench_priority_run(
+    const os_char *prefix,
+    os_char priority);
+
+static void iocombench_bulk_load(
+    void *context);
+
+
+/**
+****************************************************************************************************
+
+  @brief Priority benchmark.
+  @anchor iocombench_priority
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_priority(void)
+{
+    iocombench_priority_run("normal", IOC_MBLK_PRIORITY_NORMAL);
+    iocombench_priority_run("high", IOC_MBLK_PRIORITY_HIGH);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Measure echo round trips with bulk load (internal).
+  @anchor iocombench_priority_run
+
+  @param   prefix Metric name prefix.
+  @param   priority Priority of echo memory blocks.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_priority_run(
+    const os_char *prefix,
+    os_char priority)
+{
+    iocomTestPair p;
+    iocomBenchEcho e;
+    iocomBenchBulk bulk;
+    os_int64 *samples;
+    os_int rounds, n;
+
+    rounds = (os_int)iocombench_option("rounds", 1000);
+    samples = (os_int64*)os_malloc(rounds * sizeof(os_int64), OS_NULL);
+    os_memclear(&bulk, sizeof(bulk));
+    bulk.sz = (os_int)iocombench_option("bulk", 32768);
+    bulk.buf = (os_char*)os_malloc(bulk.sz, OS_NULL);
+    if (samples == OS_NULL || bulk.buf == OS_NULL) goto getout;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocombench_setup_echo(&e, &p, priority);
+    iocomtest_memory_block(&bulk.dbulk, &p.device, "bulk", bulk.sz, IOC_MBLK_UP);
+    iocomtest_memory_block(&bulk.cbulk, &p.controller, "bulk", bulk.sz, IOC_MBLK_UP);
+    e.load_func = iocombench_bulk_load;
+    e.load_context = &bulk;
+    iocombench_connect_pair(&p);
+
+    n = iocombench_run_echo(&e, samples, rounds);
+    iocombench_rtt_results("priority", prefix, samples, n);
+
+    iocombench_release_echo(&e);
+    ioc_release_handle(&bulk.dbulk);
+    ioc_release_handle(&bulk.cbulk);
+    iocomtest_release_pair(&p);
+
+getout:
+    if (samples) os_free(samples, rounds * sizeof(os_int64));
+    if (bulk.buf) os_free(bulk.buf, bulk.sz);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Rewrite bulk memory block (internal).
+  @anchor iocombench_bulk_load
+
+  @param   context Pointer to bulk load state.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_bulk_load(
+    void *context)
+{
+    iocomBenchBulk *bulk;
+    os_int i;
+
+    bulk = (iocomBenchBulk*)context;
+    bulk->version++;
+    for (i = 0; i < bulk->sz; i++) bulk->buf[i] = (os_char)(bulk->version + i * 7);
+    ioc_write(&bulk->dbulk, 0, bulk->buf, bulk->sz, 0);
+    ioc_send(&bulk->dbulk);
+    ioc_receive(&bulk->cbulk);
+}
@@ -0,0 +1,114 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_recorder.c
+  @brief   Sustained record rate of memory block recorder.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Device rewrites a small memory block on every loop round and controller records every
+  received change with memory block recorder. Prints records captured and written to disk
+  per second, and records dropped because the recorder's RAM buffer was full. Log files are
+  written to "iocombench_rec" files in working directory, at most four segments are kept.
+
+  Options: seconds=N measurement time (default 3), bytes=N memory block size (default 64).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_MBLK_RECORDER
+
+
+/**
+****************************************************************************************************
+
+  @brief Memory block recorder benchmark.
+  @anchor iocombench_recorder
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_recorder(void)
+{
+    iocomTestPair p;
+    iocHandle dexp, cexp;
+    iocRecorderParams prm;
+    iocRecorderStats stats;
+    iocMblkRecorder *rec;
+    os_int nbytes, seconds, version;
+    os_int64 start_us, end_us;
+    os_double cpu_ms, s;
+    os_timer start_t;
+
+    seconds = (os_int)iocombench_option("seconds", 3);
+    nbytes = (os_int)iocombench_option("bytes", 64);
+    if (seconds <= 0 || nbytes < (os_int)sizeof(os_int)) return;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocomtest_memory_block(&dexp, &p.device, "exp", nbytes, IOC_MBLK_UP);
+    iocomtest_memory_block(&cexp, &p.controller, "exp", nbytes, IOC_MBLK_UP);
+    iocombench_connect_pair(&p);
+
+    /* Wait for connection, so that connect time is not measured.
+     */
+    version = 0;
+    os_get_timer(&start_t);
+    while (iocomtest_get_int(&cexp, 0) == 0 && !os_has_elapsed(&start_t, IOCOMTEST_TIMEOUT_MS))
+    {
+        iocomtest_set_int(&dexp, 0, ++version);
+        ioc_send(&dexp);
+        iocomtest_run_pair(&p);
+        ioc_receive(&cexp);
+    }
+
+    os_memclear(&prm, sizeof(prm));
+    prm.path = "iocombench_rec";
+    prm.max_segments = 4;
+    rec = ioc_start_mblk_recorder(&cexp, &prm);
+    if (rec == OS_NULL)
+    {
+        osal_console_write("recorder: could not start recorder\n");
+        goto getout;
+    }
+
+    cpu_ms = iocombench_cpu_ms();
+    os_get_timer(&start_t);
+    os_time(&start_us);
+    while (!os_has_elapsed(&start_t, 1000 * seconds))
+    {
+        iocomtest_set_int(&dexp, 0, ++version);
+        ioc_send(&dexp);
+        iocomtest_run_pair(&p);
+        ioc_receive(&cexp);
+    }
+    os_time(&end_us);
+    s = (end_us - start_us) / 1000000.0;
+    ioc_get_mblk_recorder_stats(rec, &stats);
+    iocombench_result("recorder", "records_per_s", stats.records / s, "1/s");
+    iocombench_result("recorder", "written_per_s", stats.written / s, "1/s");
+    iocombench_result("recorder", "dropped", (os_double)stats.dropped, "");
+    if (cpu_ms >= 0) {
+        iocombench_result("recorder", "cpu",
+            100.0 * (iocombench_cpu_ms() - cpu_ms) / (1000.0 * s), "%");
+    }
+
+    /* Stopping writes remaining records, all captured records should be on disk.
+     */
+    ioc_stop_mblk_recorder(rec, &stats);
+    iocombench_result("recorder", "unwritten", (os_double)(stats.records - stats.written), "");
+
+getout:
+    ioc_release_handle(&dexp);
+    ioc_release_handle(&cexp);
+    iocomtest_release_pair(&p);
+}
+
+#else
+void iocombench_recorder(void) {}
+#endif
@@ -0,0 +1,214 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_sampler.c
+  @brief   Lossless sample rate of sampler over flat brick buffer.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Device adds time stamped samples to sampler as fast as the sampler's ring has room, so no
+  sample is dropped, and the sampler sends them batched into bricks through flat buffer.
+  Controller reads the samples in brick received callback. Prints samples received per
+  second, bricks per second, sample data throughput, process CPU use and number of samples
+  dropped (samples_per_s, bricks_per_s, throughput, cpu, dropped).
+
+  Options: seconds=N measurement time (default 3), bytes=N sample data size (default 8),
+  batch=N maximum samples per brick (default 256), samples=N ring size (default 4096).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_SAMPLER_SUPPORT
+
+/* Sampler, brick pair and samples counted by brick received callback.
+ */
+typedef struct iocomBenchSampler
+{
+    iocomTestBrickPair bp;
+    iocSampler sampler;
+
+    /** Number of samples and sample batch bricks received.
+     */
+    os_long nsamples;
+    os_long nbricks;
+}
+iocomBenchSampler;
+
+/* Forward referred static functions.
+ */
+static osalStatus iocombench_sampler_received(
+    struct iocBrickBuffer *b,
+    void *context);
+
+static void iocombench_sampler_round(
+    iocomBenchSampler *t,
+    iocomTestPair *p,
+    os_char *sample);
+
+
+/**
+****************************************************************************************************
+
+  @brief Sampler benchmark.
+  @anchor iocombench_sampler
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_sampler(void)
+{
+    iocomTestPair p;
+    iocomBenchSampler *t;
+    iocSamplerStats stats;
+    os_char *sample;
+    os_int seconds, sample_sz, batch, max_samples;
+    os_long nsamples, nbricks;
+    os_int64 start_us, end_us;
+    os_double cpu_ms, s;
+    os_timer start_t;
+
+    seconds = (os_int)iocombench_option("seconds", 3);
+    sample_sz = (os_int)iocombench_option("bytes", 8);
+    batch = (os_int)iocombench_option("batch", 256);
+    max_samples = (os_int)iocombench_option("samples", 4096);
+    if (seconds <= 0 || sample_sz <= 0 || batch <= 0 || max_samples <= 0) return;
+    t = (iocomBenchSampler*)os_malloc(sizeof(iocomBenchSampler), OS_NULL);
+    sample = (os_char*)os_malloc(sample_sz, OS_NULL);
+    if (t == OS_NULL || sample == OS_NULL) goto getout;
+    os_memclear(t, sizeof(iocomBenchSampler));
+    os_memclear(sample, sample_sz);
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocomtest_setup_brick_pair(&t->bp, &p, (os_int)sizeof(iocBrickHdr) +
+        batch * (sample_sz + IOC_SAMPLE_TSTAMP_SZ));
+    ioc_set_brick_rate_target(&t->bp.send, IOC_BRICK_DEFAULT_TARGET_LATENCY_MS, 100);
+    ioc_set_brick_received_callback(&t->bp.receive, iocombench_sampler_received, t);
+    if (ioc_initialize_sampler(&t->sampler, &t->bp.send, sample_sz, max_samples))
+    {
+        osal_console_write("sampler: could not initialize sampler\n");
+        goto release_pair;
+    }
+    iocombench_connect_pair(&p);
+
+    /* Wait until the first batch has been received, so that connect time is not measured.
+     */
+    os_get_timer(&start_t);
+    while (t->nbricks == 0)
+    {
+        if (os_has_elapsed(&start_t, IOCOMTEST_TIMEOUT_MS))
+        {
+            osal_console_write("sampler: no samples received\n");
+            goto release;
+        }
+        iocombench_sampler_round(t, &p, sample);
+    }
+
+    nsamples = t->nsamples;
+    nbricks = t->nbricks;
+    cpu_ms = iocombench_cpu_ms();
+    os_get_timer(&start_t);
+    os_time(&start_us);
+    while (!os_has_elapsed(&start_t, 1000 * seconds))
+    {
+        iocombench_sampler_round(t, &p, sample);
+    }
+    os_time(&end_us);
+    s = (end_us - start_us) / 1000000.0;
+    nsamples = t->nsamples - nsamples;
+    nbricks = t->nbricks - nbricks;
+
+    iocombench_result("sampler", "samples_per_s", nsamples / s, "1/s");
+    iocombench_result("sampler", "bricks_per_s", nbricks / s, "1/s");
+    iocombench_result("sampler", "throughput", nsamples * (os_double)sample_sz / s / 1.0e6,
+        "MB/s");
+    if (cpu_ms >= 0) {
+        iocombench_result("sampler", "cpu",
+            100.0 * (iocombench_cpu_ms() - cpu_ms) / (1000.0 * s), "%");
+    }
+    ioc_get_sampler_stats(&t->sampler, &stats);
+    iocombench_result("sampler", "dropped", (os_double)stats.dropped, "");
+
+release:
+    ioc_release_sampler(&t->sampler);
+release_pair:
+    iocomtest_release_brick_pair(&t->bp);
+    iocomtest_release_pair(&p);
+
+getout:
+    if (t) os_free(t, sizeof(iocomBenchSampler));
+    if (sample) os_free(sample, sample_sz);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick received callback, count samples (internal).
+  @anchor iocombench_sampler_received
+
+  @param   b Pointer to receiving brick buffer.
+  @param   context Pointer to iocomBenchSampler.
+  @return  OSAL_SUCCESS.
+
+****************************************************************************************************
+*/
+static osalStatus iocombench_sampler_received(
+    struct iocBrickBuffer *b,
+    void *context)
+{
+    iocomBenchSampler *t;
+    os_int n;
+
+    t = (iocomBenchSampler*)context;
+    n = ioc_get_brick_samples(b, OS_NULL);
+    if (n)
+    {
+        t->nsamples += n;
+        t->nbricks++;
+    }
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Fill sampler's ring, run sampler and move data once (internal).
+  @anchor iocombench_sampler_round
+
+  Samples are added only while the ring has room, so that the rate measured is the lossless
+  rate and no samples are dropped.
+
+  @param   t Pointer to benchmark state.
+  @param   p Pointer to connected test pair.
+  @param   sample Sample data buffer, first bytes are changed for each sample.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_sampler_round(
+    iocomBenchSampler *t,
+    iocomTestPair *p,
+    os_char *sample)
+{
+    os_int64 tstamp_us;
+
+    os_time(&tstamp_us);
+    while (t->sampler.count < t->sampler.max_samples)
+    {
+        sample[0]++;
+        ioc_add_sample(&t->sampler, sample, tstamp_us);
+    }
+    ioc_run_sampler(&t->sampler);
+    iocomtest_run_brick_pair(&t->bp, p);
+}
+
+#else
+void iocombench_sampler(void) {}
+#endif
@@ -0,0 +1,248 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_sendall.c
+  @brief   Main loop cost of ioc_send_all() and ioc_receive_all() with many memory blocks.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Device and controller of a connected test pair have "mblks" small memory blocks each.
+  After initial key frames have been transferred, device's ioc_send_all() and controller's
+  ioc_receive_all() main loop calls are timed "rounds" times with nothing changed, and
+  "rounds" times with "changed" device memory blocks written before each round.
+  Time per call is printed. With IOC_DIRTY_LISTS the cost should follow number of changed
+  memory blocks, without it number of all memory blocks: Build with IOC_DIRTY_LISTS=0 to
+  get the "before" numbers. us_per_scan is time to visit every memory block and its source
+  buffers under lock, which is the least the loops without dirty lists do.
+
+  Options: mblks=N number of memory blocks (default 10000), rounds=N (default 1000),
+  changed=N memory blocks written per round (default 1).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+
+/* Memory block handles, used by condition function.
+ */
+typedef struct iocomBenchSendAll
+{
+    iocHandle *dhandles;
+    iocHandle *chandles;
+    os_int nmblks;
+    os_int value;
+}
+iocomBenchSendAll;
+
+/* Forward referred static functions.
+ */
+static os_boolean iocombench_all_received(
+    iocomTestPair *p,
+    void *context);
+
+static os_int iocombench_scan_sbufs(
+    iocRoot *root);
+
+
+/**
+****************************************************************************************************
+
+  @brief ioc_send_all() and ioc_receive_all() benchmark.
+  @anchor iocombench_sendall
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_sendall(void)
+{
+    iocomTestPair p;
+    iocomBenchSendAll b;
+    os_char mblk_name[IOC_NAME_SZ], nbuf[OSAL_NBUF_SZ];
+    os_int nmblks, rounds, changed, i, j, k, ncalls;
+    os_int64 start_us, end_us, send_us, receive_us;
+    os_timer start_t;
+
+    nmblks = (os_int)iocombench_option("mblks", 10000);
+    rounds = (os_int)iocombench_option("rounds", 1000);
+    changed = (os_int)iocombench_option("changed", 1);
+    if (nmblks <= 0 || rounds <= 0 || changed < 0) return;
+    if (changed > nmblks) changed = nmblks;
+
+    os_memclear(&b, sizeof(b));
+    b.nmblks = nmblks;
+    b.dhandles = (iocHandle*)os_malloc(nmblks * sizeof(iocHandle), OS_NULL);
+    b.chandles = (iocHandle*)os_malloc(nmblks * sizeof(iocHandle), OS_NULL);
+    if (b.dhandles == OS_NULL || b.chandles == OS_NULL) goto getout;
+
+    iocombench_result("sendall", "dirty_lists", IOC_DIRTY_LISTS, "");
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    for (k = 0; k < nmblks; k++)
+    {
+        os_strncpy(mblk_name, "m", sizeof(mblk_name));
+        osal_int_to_str(nbuf, sizeof(nbuf), k);
+        os_strncat(mblk_name, nbuf, sizeof(mblk_name));
+        iocomtest_memory_block(b.dhandles + k, &p.device, mblk_name, 16, IOC_MBLK_UP);
+        iocomtest_memory_block(b.chandles + k, &p.controller, mblk_name, 16, IOC_MBLK_UP);
+        iocomtest_set_int(b.dhandles + k, 0, 1);
+    }
+
+    /* Wait for key frames of all memory blocks.
+     */
+    b.value = 1;
+    if (iocombench_connect_pair(&p) ||
+        !iocomtest_run_pair_until(&p, iocombench_all_received, &b, 120000))
+    {
+        osal_console_write("sendall: initial transfer failed\n");
+        goto release_pair;
+    }
+
+    /* Nothing changed.
+     */
+    os_time(&start_us);
+    for (i = 0; i < rounds; i++)
+    {
+        ioc_send_all(&p.device);
+    }
+    os_time(&end_us);
+    iocombench_result("sendall", "idle_us_per_send_all",
+        (end_us - start_us) / (os_double)rounds, "us");
+
+    os_time(&start_us);
+    for (i = 0; i < rounds; i++)
+    {
+        ioc_receive_all(&p.controller);
+    }
+    os_time(&end_us);
+    iocombench_result("sendall", "idle_us_per_receive_all",
+        (end_us - start_us) / (os_double)rounds, "us");
+
+    /* "changed" memory blocks written before each round. Receive is called until the
+       last written memory block has arrived, time per call is averaged over all calls.
+     */
+    send_us = receive_us = 0;
+    ncalls = 0;
+    k = 0;
+    for (i = 0; i < rounds && changed > 0; i++)
+    {
+        for (j = 0; j < changed; j++)
+        {
+            iocomtest_set_int(b.dhandles + k, 0, i + 2);
+            if (++k >= nmblks) k = 0;
+        }
+        j = k ? k - 1 : nmblks - 1;
+
+        os_time(&start_us);
+        ioc_send_all(&p.device);
+        os_time(&end_us);
+        send_us += end_us - start_us;
+
+        os_get_timer(&start_t);
+        do
+        {
+            iocomtest_run_pair(&p);
+            os_time(&start_us);
+            ioc_receive_all(&p.controller);
+            os_time(&end_us);
+            receive_us += end_us - start_us;
+            ncalls++;
+            if (os_has_elapsed(&start_t, IOCOMTEST_TIMEOUT_MS)) break;
+        }
+        while (iocomtest_get_int(b.chandles + j, 0) != i + 2);
+    }
+    if (i > 0 && ncalls > 0)
+    {
+        iocombench_result("sendall", "us_per_send_all", send_us / (os_double)i, "us");
+        iocombench_result("sendall", "us_per_receive_all",
+            receive_us / (os_double)ncalls, "us");
+    }
+
+    os_time(&start_us);
+    for (i = 0; i < rounds; i++)
+    {
+        iocombench_scan_sbufs(&p.device);
+    }
+    os_time(&end_us);
+    iocombench_result("sendall", "us_per_scan", (end_us - start_us) / (os_double)rounds, "us");
+
+release_pair:
+    for (k = 0; k < nmblks; k++)
+    {
+        ioc_release_handle(b.dhandles + k);
+        ioc_release_handle(b.chandles + k);
+    }
+    iocomtest_release_pair(&p);
+
+getout:
+    if (b.dhandles) os_free(b.dhandles, nmblks * sizeof(iocHandle));
+    if (b.chandles) os_free(b.chandles, nmblks * sizeof(iocHandle));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Send and receive all, check if controller has value in every memory block (internal).
+  @anchor iocombench_all_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomBenchSendAll.
+  @return  OS_TRUE if all controller's memory blocks have the value.
+
+****************************************************************************************************
+*/
+static os_boolean iocombench_all_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomBenchSendAll *b;
+    os_int k;
+
+    b = (iocomBenchSendAll*)context;
+    ioc_send_all(&p->device);
+    ioc_receive_all(&p->controller);
+    for (k = 0; k < b->nmblks; k++)
+    {
+        if (iocomtest_get_int(b->chandles + k, 0) != b->value) return OS_FALSE;
+    }
+    return OS_TRUE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Visit every memory block and source buffer of the root (internal).
+  @anchor iocombench_scan_sbufs
+
+  Same walk as ioc_send_all() does without dirty lists, but without synchronizing.
+
+  @param   root Pointer to root object.
+  @return  Number of source buffers with changes, so that the walk is not optimized away.
+
+****************************************************************************************************
+*/
+static os_int iocombench_scan_sbufs(
+    iocRoot *root)
+{
+    iocMemoryBlock *mblk;
+    iocSourceBuffer *sbuf;
+    os_int n;
+
+    n = 0;
+    ioc_lock(root);
+    for (mblk = root->mblk.first; mblk; mblk = mblk->link.next)
+    {
+        for (sbuf = mblk->sbuf.first; sbuf; sbuf = sbuf->mlink.next)
+        {
+            if (sbuf->changed.range_set) n++;
+        }
+    }
+    ioc_unlock(root);
+    return n;
+}
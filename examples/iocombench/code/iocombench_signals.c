@@ -0,0 +1,130 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_signals.c
+  @brief   Dynamic signal information with many signals.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Adds "signals" dynamic signals spread over "mblks" memory blocks of one device to a dynamic
+  network, like info blocks of a large device would, then looks up every signal by name and
+  releases the network. Prints time per add, find and release, and memory used per signal
+  including interned names.
+
+  Options: signals=N number of signals (default 10000), mblks=N number of memory blocks
+  (default 10).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_DYNAMIC_MBLK_CODE
+
+/* Forward referred static functions.
+ */
+static void iocombench_signal_name(
+    os_char *buf,
+    os_memsz buf_sz,
+    const os_char *prefix,
+    os_int k);
+
+
+/**
+****************************************************************************************************
+
+  @brief Dynamic signals benchmark.
+  @anchor iocombench_signals
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_signals(void)
+{
+    iocDynamicNetwork *dnetwork;
+    iocDynamicMemoryUse use;
+    iocIdentifiers identifiers;
+    os_char signal_name[IOC_SIGNAL_NAME_SZ], mblk_name[IOC_NAME_SZ];
+    os_int nsignals, nmblks, found, k;
+    os_int64 start_us, end_us;
+
+    nsignals = (os_int)iocombench_option("signals", 10000);
+    nmblks = (os_int)iocombench_option("mblks", 10);
+    if (nsignals <= 0 || nmblks <= 0) return;
+
+    dnetwork = ioc_initialize_dynamic_network();
+    if (dnetwork == OS_NULL) return;
+
+    os_time(&start_us);
+    for (k = 0; k < nsignals; k++)
+    {
+        iocombench_signal_name(signal_name, sizeof(signal_name), "sig", k);
+        iocombench_signal_name(mblk_name, sizeof(mblk_name), "m", k % nmblks);
+        ioc_add_dynamic_signal(dnetwork, signal_name, mblk_name, IOCOMTEST_DEVICE_NAME,
+            IOCOMTEST_DEVICE_NR, 2 * (k / nmblks), 1, 1, OS_SHORT);
+    }
+    os_time(&end_us);
+    iocombench_result("signals", "us_per_add", (end_us - start_us) / (os_double)nsignals, "us");
+
+    os_memclear(&use, sizeof(use));
+    ioc_dynamic_network_memory_use(dnetwork, &use);
+    iocombench_result("signals", "bytes_per_signal",
+        (os_double)(use.signal_bytes + use.string_bytes + use.network_bytes) / nsignals, "B");
+    iocombench_result("signals", "strings", use.nro_strings, "");
+
+    os_memclear(&identifiers, sizeof(identifiers));
+    os_strncpy(identifiers.device_name, IOCOMTEST_DEVICE_NAME, IOC_NAME_SZ);
+    identifiers.device_nr = IOCOMTEST_DEVICE_NR;
+    found = 0;
+    os_time(&start_us);
+    for (k = 0; k < nsignals; k++)
+    {
+        iocombench_signal_name(identifiers.signal_name, IOC_SIGNAL_NAME_SZ, "sig", k);
+        if (ioc_find_dynamic_signal(dnetwork, &identifiers)) found++;
+    }
+    os_time(&end_us);
+    iocombench_result("signals", "us_per_find", (end_us - start_us) / (os_double)nsignals, "us");
+    iocombench_result("signals", "found", found, "");
+
+    os_time(&start_us);
+    ioc_release_dynamic_network(dnetwork);
+    os_time(&end_us);
+    iocombench_result("signals", "us_per_release",
+        (end_us - start_us) / (os_double)nsignals, "us");
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Make name from prefix and number (internal).
+  @anchor iocombench_signal_name
+
+  @param   buf Buffer where to store the name.
+  @param   buf_sz Buffer size in bytes.
+  @param   prefix Name prefix, like "sig".
+  @param   k Number to append.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_signal_name(
+    os_char *buf,
+    os_memsz buf_sz,
+    const os_char *prefix,
+    os_int k)
+{
+    os_char nbuf[OSAL_NBUF_SZ];
+
+    os_strncpy(buf, prefix, buf_sz);
+    osal_int_to_str(nbuf, sizeof(nbuf), k);
+    os_strncat(buf, nbuf, buf_sz);
+}
+
+#else
+void iocombench_signals(void) {}
+#endif
@@ -0,0 +1,593 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_storm.c
+  @brief   Connect and reconnect storm of many devices against a threaded server.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Load generator for mass reconnects, like after power cycle or switch reboot. Server root
+  listens with IOC_CREATE_THREAD and IOC_DYNAMIC_MBLKS, so each accepted connection runs in
+  its own thread and memory blocks of devices are created dynamically as the memory block
+  information arrives, like on ioserver. "devices" device roots, each with own device number
+  and "exp" and "info" memory blocks, connect to it. Server parses each device's "info" block
+  into dynamic signal information, like for real IO devices. Device connections have no
+  threads, they are run by the calling thread, so CPU time used by the server is process CPU
+  time minus calling thread's CPU time.
+
+  After all devices have connected, all connections are closed and opened again at once
+  "storms" times. Server's connection setup statistics (IOC_CONNECT_STATS) give percentiles
+  of time from stream open to authentication and to first data over the reconnect storms.
+
+  By default devices connect over the loopback stream. With tls=1 they connect by TLS to
+  127.0.0.1 using the underlying TLS library (mbedtls or openssl wrapper of eosal). Server
+  certificate, key and test root certificate are loaded from "certs" directory in working
+  directory, generate these with scripts/make-test-certificates.sh. Server root has user
+  authorization enabled, it is called for secure connections only, so it is part of the
+  measured setup with tls=1.
+
+  Options: devices=N number of devices (default 500), storms=N number of reconnect storms
+  (default 3), tls=1 to connect by TLS.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_CONNECT_STATS && IOC_DYNAMIC_MBLK_CODE && OSAL_MULTITHREAD_SUPPORT
+
+/* Device name of simulated devices, device numbers are 1...devices.
+ */
+#define IOCOMBENCH_STORM_DEVICE "stormdev"
+
+/* Directory of test certificates, relative to working directory.
+ */
+#define IOCOMBENCH_CERTS_DIR "certs"
+
+/* Password of simulated devices.
+ */
+#define IOCOMBENCH_STORM_PASSWORD "testpass"
+
+/* Signal information published by simulated devices in "info" memory block, as JSON.
+ */
+#if OSAL_JSON_TEXT_SUPPORT
+#define IOCOMBENCH_STORM_INFO \
+    "{\"mblk\": [{\"name\": \"exp\", \"flags\": \"up\", \"groups\": [" \
+    "{\"name\": \"state\", \"signals\": [" \
+    "{\"name\": \"nr\", \"type\": \"int\"}," \
+    "{\"name\": \"temperature\", \"type\": \"float\"}," \
+    "{\"name\": \"status\", \"type\": \"str\", \"array\": 8}]}]}]}"
+#endif
+
+/* Server root and simulated devices.
+ */
+typedef struct iocomBenchStorm
+{
+    /** Server root and end point, run by end point and connection threads.
+     */
+    iocRoot server;
+    iocEndPoint *epoint;
+
+    /** Device roots, their "exp" and "info" memory blocks and connections, run by calling
+        thread.
+     */
+    iocRoot *devices;
+    iocHandle *handles;
+    iocHandle *info_handles;
+    iocConnection **cons;
+    os_int ndevices;
+
+    /** Packed JSON content of "info" memory blocks, shared by all devices. OS_NULL if
+        JSON text support is not available.
+     */
+    os_char *info;
+    os_memsz info_sz;
+
+#if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
+    /** Password as received by server, to check in authorization.
+     */
+    os_char password[IOC_PASSWORD_SZ];
+#endif
+
+    /** Connection parameters, the same for all devices.
+     */
+    iocConnectionParams conprm;
+}
+iocomBenchStorm;
+
+/* Forward referred static functions.
+ */
+#if OSAL_TLS_SUPPORT
+static void iocombench_storm_initialize_tls(void);
+#endif
+
+static void iocombench_storm_make_info(
+    iocomBenchStorm *s);
+
+#if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
+static osalStatus iocombench_storm_authorize(
+    struct iocRoot *root,
+    iocAllowedNetworkConf *allowed_networks,
+    iocUser *user,
+    os_char *ip,
+    void *context);
+#endif
+
+static osalStatus iocombench_storm_connect(
+    iocomBenchStorm *s,
+    os_int timeout_ms);
+
+static osalStatus iocombench_storm_disconnect(
+    iocomBenchStorm *s,
+    os_int timeout_ms);
+
+static os_int iocombench_nro_connections(
+    iocRoot *root);
+
+static void iocombench_storm_percentiles(
+    const os_char *phase,
+    iocConnectHistogram *h);
+
+
+/**
+****************************************************************************************************
+
+  @brief Connect and reconnect storm benchmark.
+  @anchor iocombench_storm
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_storm(void)
+{
+    iocomBenchStorm s;
+    iocEndPointParams epprm;
+    iocMemoryBlockParams mbprm;
+    iocConnectStats stats;
+    os_int ndevices, storms, tls, i, k;
+    os_int64 start_us, end_us, storm_us;
+    os_double cpu_start, thread_start, server_cpu;
+    os_boolean cpu_ok;
+
+    ndevices = (os_int)iocombench_option("devices", 500);
+    storms = (os_int)iocombench_option("storms", 3);
+    tls = (os_int)iocombench_option("tls", 0);
+    if (ndevices <= 0 || storms < 0) return;
+
+    os_memclear(&s, sizeof(s));
+    s.ndevices = ndevices;
+    s.devices = (iocRoot*)os_malloc(ndevices * sizeof(iocRoot), OS_NULL);
+    s.handles = (iocHandle*)os_malloc(ndevices * sizeof(iocHandle), OS_NULL);
+    s.info_handles = (iocHandle*)os_malloc(ndevices * sizeof(iocHandle), OS_NULL);
+    s.cons = (iocConnection**)os_malloc(ndevices * sizeof(iocConnection*), OS_NULL);
+    if (s.devices == OS_NULL || s.handles == OS_NULL || s.info_handles == OS_NULL ||
+        s.cons == OS_NULL)
+    {
+        goto getout;
+    }
+    os_memclear(s.cons, ndevices * sizeof(iocConnection*));
+    iocombench_storm_make_info(&s);
+
+    os_memclear(&epprm, sizeof(epprm));
+    epprm.flags = IOC_SOCKET|IOC_CREATE_THREAD|IOC_DYNAMIC_MBLKS;
+    s.conprm.flags = IOC_SOCKET|IOC_CONNECT_UP;
+    if (tls)
+    {
+#if OSAL_TLS_SUPPORT
+        iocombench_storm_initialize_tls();
+        epprm.iface = OSAL_TLS_IFACE;
+        epprm.parameters = ":" IOC_DEFAULT_TLS_PORT_STR;
+        s.conprm.iface = OSAL_TLS_IFACE;
+        s.conprm.parameters = "127.0.0.1:" IOC_DEFAULT_TLS_PORT_STR;
+#else
+        osal_console_write("storm: no TLS support\n");
+        goto getout;
+#endif
+    }
+    else
+    {
+        epprm.iface = IOC_LOOPBACK_IFACE;
+        epprm.parameters = IOCOMBENCH_NAME;
+        s.conprm.iface = IOC_LOOPBACK_IFACE;
+        s.conprm.parameters = IOCOMBENCH_NAME;
+    }
+    iocombench_result("storm", "tls", tls ? 1 : 0, "");
+    iocombench_result("storm", "devices", ndevices, "");
+
+    ioc_initialize_root(&s.server, IOC_CREATE_OWN_MUTEX);
+    ioc_set_iodevice_id(&s.server, "stormsrv", 1, IOCOMBENCH_STORM_PASSWORD,
+        IOCOMTEST_NETWORK_NAME);
+    ioc_initialize_dynamic_root(&s.server);
+#if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
+#if OSAL_SECRET_SUPPORT
+    osal_hash_password(s.password, IOCOMBENCH_STORM_PASSWORD, IOC_PASSWORD_SZ);
+#else
+    os_strncpy(s.password, IOCOMBENCH_STORM_PASSWORD, IOC_PASSWORD_SZ);
+#endif
+    ioc_enable_user_authentication(&s.server, iocombench_storm_authorize, &s);
+#endif
+
+    for (k = 0; k < ndevices; k++)
+    {
+        ioc_initialize_root(s.devices + k, IOC_CREATE_OWN_MUTEX);
+        ioc_set_iodevice_id(s.devices + k, IOCOMBENCH_STORM_DEVICE, k + 1,
+            IOCOMBENCH_STORM_PASSWORD, IOCOMTEST_NETWORK_NAME);
+        os_memclear(&mbprm, sizeof(mbprm));
+        mbprm.mblk_name = "exp";
+        mbprm.device_name = IOCOMBENCH_STORM_DEVICE;
+        mbprm.device_nr = k + 1;
+        mbprm.network_name = IOCOMTEST_NETWORK_NAME;
+        mbprm.nbytes = 32;
+        mbprm.flags = IOC_MBLK_UP;
+        ioc_initialize_memory_block(s.handles + k, OS_NULL, s.devices + k, &mbprm);
+        iocomtest_set_int(s.handles + k, 0, k + 1);
+
+        os_memclear(s.info_handles + k, sizeof(iocHandle));
+        if (s.info)
+        {
+            mbprm.mblk_name = "info";
+            mbprm.buf = s.info;
+            mbprm.nbytes = (os_int)s.info_sz;
+            mbprm.flags = IOC_MBLK_UP|IOC_STATIC;
+            ioc_initialize_memory_block(s.info_handles + k, OS_NULL, s.devices + k, &mbprm);
+        }
+    }
+
+    s.epoint = ioc_initialize_end_point(OS_NULL, &s.server);
+    if (ioc_listen(s.epoint, &epprm))
+    {
+        osal_console_write("storm: listen failed\n");
+        goto release;
+    }
+
+    /* All devices connect.
+     */
+    os_time(&start_us);
+    if (iocombench_storm_connect(&s, 120000))
+    {
+        osal_console_write("storm: not all devices connected\n");
+        goto release;
+    }
+    os_time(&end_us);
+    iocombench_result("storm", "connect_all", (end_us - start_us) / 1000.0, "ms");
+
+    /* Reconnect storms. Statistics and server CPU time cover only the storms.
+     */
+    ioc_get_connect_stats(&s.server, &stats, OS_TRUE);
+    storm_us = 0;
+    server_cpu = 0.0;
+    cpu_ok = OS_TRUE;
+    for (i = 0; i < storms; i++)
+    {
+        if (iocombench_storm_disconnect(&s, 60000)) break;
+        cpu_start = iocombench_cpu_ms();
+        thread_start = iocombench_thread_cpu_ms();
+        if (cpu_start < 0.0 || thread_start < 0.0) cpu_ok = OS_FALSE;
+        os_time(&start_us);
+        if (iocombench_storm_connect(&s, 120000)) break;
+        os_time(&end_us);
+        server_cpu += (iocombench_cpu_ms() - cpu_start) -
+            (iocombench_thread_cpu_ms() - thread_start);
+        storm_us += end_us - start_us;
+    }
+    if (i < storms)
+    {
+        osal_console_write("storm: reconnect storm failed\n");
+    }
+    if (i > 0)
+    {
+        ioc_get_connect_stats(&s.server, &stats, OS_FALSE);
+        iocombench_result("storm", "storm_all", storm_us / 1000.0 / i, "ms");
+        iocombench_storm_percentiles("auth", &stats.phase[IOC_CONNECT_PHASE_AUTHENTICATED]);
+        iocombench_storm_percentiles("first_data", &stats.phase[IOC_CONNECT_PHASE_FIRST_DATA]);
+        if (cpu_ok)
+        {
+            iocombench_result("storm", "server_cpu_percent",
+                100.0 * server_cpu * 1000.0 / storm_us, "%");
+            iocombench_result("storm", "server_cpu_ms_per_device",
+                server_cpu / ((os_double)i * ndevices), "ms");
+        }
+        else
+        {
+            osal_console_write("storm: thread CPU time not available\n");
+        }
+    }
+
+release:
+    for (k = 0; k < ndevices; k++)
+    {
+        if (s.cons[k]) ioc_release_connection(s.cons[k]);
+        ioc_release_handle(s.handles + k);
+        ioc_release_handle(s.info_handles + k);
+        ioc_release_root(s.devices + k);
+    }
+    if (s.epoint) ioc_release_end_point(s.epoint);
+    ioc_release_root(&s.server);
+
+getout:
+    if (s.devices) os_free(s.devices, ndevices * sizeof(iocRoot));
+    if (s.handles) os_free(s.handles, ndevices * sizeof(iocHandle));
+    if (s.info_handles) os_free(s.info_handles, ndevices * sizeof(iocHandle));
+    if (s.info) os_free(s.info, s.info_sz);
+    if (s.cons) os_free(s.cons, ndevices * sizeof(iocConnection*));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Initialize TLS with test certificates (internal).
+  @anchor iocombench_storm_initialize_tls
+
+  The same process is both TLS server and clients, so server certificate and key and the
+  root certificate clients trust are all set here.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+#if OSAL_TLS_SUPPORT
+static void iocombench_storm_initialize_tls(void)
+{
+    osalSecurityConfig secprm;
+
+    os_memclear(&secprm, sizeof(secprm));
+    secprm.certs_dir = IOCOMBENCH_CERTS_DIR;
+    secprm.server_cert_file = "iocombench.crt";
+    secprm.server_key_file = "iocombench.key";
+    secprm.trusted_cert_file = "rootca.crt";
+    secprm.share_cert_file = "rootca.crt";
+    osal_tls_initialize(OS_NULL, 0, OS_NULL, 0, &secprm);
+}
+#endif
+
+
+/**
+****************************************************************************************************
+
+  @brief Pack device information JSON for "info" memory blocks (internal).
+  @anchor iocombench_storm_make_info
+
+  Real IO devices have signal information packed at build time, here it is packed once at
+  start up and shared by all simulated devices. Server's dynamic root parses it for every
+  device which connects.
+
+  @param   s Pointer to storm benchmark state. s->info and s->info_sz are set, s->info is
+           OS_NULL if JSON text support is not available or packing fails.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_storm_make_info(
+    iocomBenchStorm *s)
+{
+#if OSAL_JSON_TEXT_SUPPORT
+    osalStream compressed;
+    os_char *data;
+    os_memsz data_sz;
+
+    compressed = osal_stream_buffer_open(OS_NULL, OS_NULL, OS_NULL, OSAL_STREAM_DEFAULT);
+    if (compressed == OS_NULL) return;
+    if (osal_compress_json(compressed, IOCOMBENCH_STORM_INFO, "title", OSAL_JSON_SIMPLIFY)
+        == OSAL_SUCCESS)
+    {
+        data = osal_stream_buffer_content(compressed, &data_sz);
+        s->info = (os_char*)os_malloc(data_sz, OS_NULL);
+        if (s->info)
+        {
+            os_memcpy(s->info, data, data_sz);
+            s->info_sz = data_sz;
+        }
+    }
+    osal_stream_close(compressed, OSAL_STREAM_DEFAULT);
+#else
+    OSAL_UNUSED(s);
+    osal_console_write("storm: no JSON text support, devices have no info block\n");
+#endif
+}
+
+
+#if IOC_AUTHENTICATION_CODE == IOC_FULL_AUTHENTICATION
+/**
+****************************************************************************************************
+
+  @brief Authorize a connecting simulated device (internal).
+  @anchor iocombench_storm_authorize
+
+  Server's authorization callback, see ioc_authorize_user_func. A simulated device may
+  connect to the test network with the test password. This stands in for checking accounts
+  on a real server, so that authorization is part of measured connection setup.
+
+  @param   root Pointer to server root.
+  @param   allowed_networks Networks the device may access are added here.
+  @param   user Account received from the connecting device.
+  @param   ip Address the connection came from, not used.
+  @param   context Pointer to storm benchmark state.
+  @return  OSAL_SUCCESS if device is accepted, OSAL_STATUS_NO_ACCESS_RIGHT if not.
+
+****************************************************************************************************
+*/
+static osalStatus iocombench_storm_authorize(
+    struct iocRoot *root,
+    iocAllowedNetworkConf *allowed_networks,
+    iocUser *user,
+    os_char *ip,
+    void *context)
+{
+    iocomBenchStorm *s;
+    OSAL_UNUSED(root);
+    OSAL_UNUSED(ip);
+
+    s = (iocomBenchStorm*)context;
+    if (os_strcmp(user->network_name, IOCOMTEST_NETWORK_NAME) ||
+        os_strcmp(user->password, s->password))
+    {
+        return OSAL_STATUS_NO_ACCESS_RIGHT;
+    }
+    ioc_add_allowed_network(allowed_networks, user->network_name, 0);
+    return OSAL_SUCCESS;
+}
+#endif
+
+
+/**
+****************************************************************************************************
+
+  @brief Connect all devices at once and wait until server has data from each (internal).
+  @anchor iocombench_storm_connect
+
+  Device connections are opened and run by the calling thread until server's connection
+  statistics show first data received from every device.
+
+  @param   s Pointer to storm benchmark state, devices not connected.
+  @param   timeout_ms Maximum time to wait, ms.
+  @return  OSAL_SUCCESS if all devices connected, OSAL_STATUS_TIMEOUT if timed out. Other
+           values indicate an error.
+
+****************************************************************************************************
+*/
+static osalStatus iocombench_storm_connect(
+    iocomBenchStorm *s,
+    os_int timeout_ms)
+{
+    iocConnectStats stats;
+    os_uint target;
+    os_timer start_t, check_t;
+    osalStatus rval;
+    os_int k;
+
+    ioc_get_connect_stats(&s->server, &stats, OS_FALSE);
+    target = stats.phase[IOC_CONNECT_PHASE_FIRST_DATA].n + (os_uint)s->ndevices;
+
+    for (k = 0; k < s->ndevices; k++)
+    {
+        s->cons[k] = ioc_initialize_connection(OS_NULL, s->devices + k);
+        if (s->cons[k] == OS_NULL) return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+        rval = ioc_connect(s->cons[k], &s->conprm);
+        if (rval) return rval;
+    }
+
+    os_get_timer(&start_t);
+    check_t = start_t;
+    while (!os_has_elapsed(&start_t, timeout_ms))
+    {
+        for (k = 0; k < s->ndevices; k++)
+        {
+            ioc_run(s->devices + k);
+        }
+        if (os_has_elapsed(&check_t, 10))
+        {
+            os_get_timer(&check_t);
+            ioc_get_connect_stats(&s->server, &stats, OS_FALSE);
+            if (stats.phase[IOC_CONNECT_PHASE_FIRST_DATA].n >= target) return OSAL_SUCCESS;
+        }
+        os_timeslice();
+    }
+    return OSAL_STATUS_TIMEOUT;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Close all device connections and wait until server has released its own (internal).
+  @anchor iocombench_storm_disconnect
+
+  @param   s Pointer to storm benchmark state.
+  @param   timeout_ms Maximum time to wait, ms.
+  @return  OSAL_SUCCESS if server has no connections left, OSAL_STATUS_TIMEOUT if timed out.
+
+****************************************************************************************************
+*/
+static osalStatus iocombench_storm_disconnect(
+    iocomBenchStorm *s,
+    os_int timeout_ms)
+{
+    os_timer start_t;
+    os_int k;
+
+    for (k = 0; k < s->ndevices; k++)
+    {
+        if (s->cons[k])
+        {
+            ioc_release_connection(s->cons[k]);
+            s->cons[k] = OS_NULL;
+        }
+    }
+
+    os_get_timer(&start_t);
+    while (iocombench_nro_connections(&s->server))
+    {
+        if (os_has_elapsed(&start_t, timeout_ms)) return OSAL_STATUS_TIMEOUT;
+        os_sleep(50);
+    }
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Count root's connections (internal).
+  @anchor iocombench_nro_connections
+
+  @param   root Pointer to root object.
+  @return  Number of connections, accepted ones not yet released included.
+
+****************************************************************************************************
+*/
+static os_int iocombench_nro_connections(
+    iocRoot *root)
+{
+    iocConnection *con;
+    os_int n;
+
+    n = 0;
+    ioc_lock(root);
+    for (con = root->con.first; con; con = con->link.next)
+    {
+        n++;
+    }
+    ioc_unlock(root);
+    return n;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Print percentiles of one connection setup phase (internal).
+  @anchor iocombench_storm_percentiles
+
+  Percentiles are upper limits of power of two histogram buckets, maximum is exact.
+
+  @param   phase Phase name used as metric prefix, "auth" or "first_data".
+  @param   h Pointer to histogram of the phase.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_storm_percentiles(
+    const os_char *phase,
+    iocConnectHistogram *h)
+{
+    os_char metric[32];
+
+    os_strncpy(metric, phase, sizeof(metric));
+    os_strncat(metric, "_p50", sizeof(metric));
+    iocombench_result("storm", metric, ioc_connect_stats_percentile(h, 50), "ms");
+    os_strncpy(metric, phase, sizeof(metric));
+    os_strncat(metric, "_p99", sizeof(metric));
+    iocombench_result("storm", metric, ioc_connect_stats_percentile(h, 99), "ms");
+    os_strncpy(metric, phase, sizeof(metric));
+    os_strncat(metric, "_max", sizeof(metric));
+    iocombench_result("storm", metric, h->max_ms, "ms");
+}
+
+#else
+void iocombench_storm(void) {}
+#endif
@@ -0,0 +1,190 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_syncbufs.c
+  @brief   Sync buffer memory of a large memory block linked to many connections.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Controller has one "bulk" byte memory block which is sent down to "conns" connections from
+  the device, so controller has one source buffer per connection. After the key frames
+  have been sent, controller rewrites "touched" bytes at the beginning of the memory block
+  "rounds" times and waits each time until every connection has sent the change. Prints
+  sync buffer bytes per connection after the key frames and after the small writes, time
+  to connect all and small write rounds per second. full_copy_bytes_per_con is what sync
+  buffers allocated up front, synchronized and delta copy of the memory block, would hold.
+
+  Options: conns=N number of connections (default 100), bulk=N memory block size (default
+  65536), touched=N bytes written per round (default 16), rounds=N (default 100).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_LAZY_SYNC_BUFFERS
+
+/* Number of connections to wait for, used by condition function.
+ */
+typedef struct iocomBenchSyncbufs
+{
+    os_int nconns;
+}
+iocomBenchSyncbufs;
+
+/* Forward referred static functions.
+ */
+static os_boolean iocombench_all_sent(
+    iocomTestPair *p,
+    void *context);
+
+static os_double iocombench_syncbuf_bytes(
+    iocRoot *root);
+
+
+/**
+****************************************************************************************************
+
+  @brief Sync buffer memory benchmark.
+  @anchor iocombench_syncbufs
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_syncbufs(void)
+{
+    iocomTestPair p;
+    iocomBenchSyncbufs b;
+    iocHandle dbulk, cbulk;
+    iocConnection **cons;
+    os_char *buf;
+    os_int nconns, bulk, touched, rounds, i, k;
+    os_int64 start_us, end_us;
+
+    nconns = (os_int)iocombench_option("conns", 100);
+    bulk = (os_int)iocombench_option("bulk", 65536);
+    touched = (os_int)iocombench_option("touched", 16);
+    rounds = (os_int)iocombench_option("rounds", 100);
+    if (nconns <= 0 || bulk <= 0 || touched <= 0 || touched > bulk) return;
+    cons = (iocConnection**)os_malloc(nconns * sizeof(iocConnection*), OS_NULL);
+    buf = (os_char*)os_malloc(touched, OS_NULL);
+    if (cons == OS_NULL || buf == OS_NULL) goto getout;
+    os_memclear(cons, nconns * sizeof(iocConnection*));
+    b.nconns = nconns;
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocomtest_memory_block(&dbulk, &p.device, "bulk", bulk, IOC_MBLK_DOWN);
+    iocomtest_memory_block(&cbulk, &p.controller, "bulk", bulk, IOC_MBLK_DOWN);
+
+    os_time(&start_us);
+    if (iocombench_connect_pair(&p)) goto release_pair;
+    iocombench_connect_more(&p, cons, nconns - 1, 0);
+    if (!iocomtest_run_pair_until(&p, iocombench_all_sent, &b, 60000))
+    {
+        osal_console_write("syncbufs: not all connections were set up\n");
+        goto release_pair;
+    }
+    os_time(&end_us);
+    iocombench_result("syncbufs", "connect_all", (end_us - start_us) / 1000.0, "ms");
+    iocombench_result("syncbufs", "keyframe_bytes_per_con",
+        iocombench_syncbuf_bytes(&p.controller) / nconns, "B");
+
+    os_time(&start_us);
+    for (i = 0; i < rounds; i++)
+    {
+        for (k = 0; k < touched; k++) buf[k] = (os_char)(i + k);
+        ioc_write(&cbulk, 0, buf, touched, 0);
+        ioc_send(&cbulk);
+        if (!iocomtest_run_pair_until(&p, iocombench_all_sent, &b, 60000)) break;
+    }
+    os_time(&end_us);
+    if (i > 0)
+    {
+        iocombench_result("syncbufs", "rounds_per_s", 1000000.0 * i / (end_us - start_us), "1/s");
+    }
+    iocombench_result("syncbufs", "bytes_per_con",
+        iocombench_syncbuf_bytes(&p.controller) / nconns, "B");
+    iocombench_result("syncbufs", "full_copy_bytes_per_con", 2.0 * bulk, "B");
+
+release_pair:
+    iocombench_release_more(cons, nconns - 1);
+    ioc_release_handle(&dbulk);
+    ioc_release_handle(&cbulk);
+    iocomtest_release_pair(&p);
+
+getout:
+    if (cons) os_free(cons, nconns * sizeof(iocConnection*));
+    if (buf) os_free(buf, touched);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check if all controller's connections have sent memory block changes (internal).
+  @anchor iocombench_all_sent
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomBenchSyncbufs.
+  @return  OS_TRUE if nconns connections have a source buffer and nothing is left to send.
+
+****************************************************************************************************
+*/
+static os_boolean iocombench_all_sent(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomBenchSyncbufs *b;
+    iocConnection *con;
+    iocSourceBuffer *sbuf;
+    os_int n;
+
+    b = (iocomBenchSyncbufs*)context;
+    n = 0;
+    ioc_lock(&p->controller);
+    for (con = p->controller.con.first; con; con = con->link.next)
+    {
+        sbuf = con->sbuf.first;
+        if (sbuf == OS_NULL) break;
+        if (sbuf->changed.range_set || sbuf->syncbuf.used || sbuf->syncbuf.make_keyframe) break;
+        n++;
+    }
+    ioc_unlock(&p->controller);
+    return (os_boolean)(n == b->nconns);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Sum sync buffer bytes of root's connections (internal).
+  @anchor iocombench_syncbuf_bytes
+
+  @param   root Pointer to root object.
+  @return  Sync buffer bytes allocated by all connections of the root.
+
+****************************************************************************************************
+*/
+static os_double iocombench_syncbuf_bytes(
+    iocRoot *root)
+{
+    iocConnection *con;
+    os_double n;
+
+    n = 0.0;
+    ioc_lock(root);
+    for (con = root->con.first; con; con = con->link.next)
+    {
+        n += (os_double)con->syncbuf_bytes;
+    }
+    ioc_unlock(root);
+    return n;
+}
+
+#else
+void iocombench_syncbufs(void) {}
+#endif
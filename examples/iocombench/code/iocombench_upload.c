@@ -0,0 +1,274 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_upload.c
+  @brief   Streamer upload from controller to device.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Controller writes a block of data to device through ring buffer streamer, like when
+  uploading a configuration or program, and closes the transfer with the final handshake.
+  Device reads with checksum check. Prints average time per upload from opening the stream
+  until both ends have completed (upload_ms), throughput and process CPU use.
+
+  Options: bytes=N upload size (default 1048576), ring=N ring buffer size in bytes (default
+  16384), rounds=N number of uploads (default 3).
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocombench.h"
+#if IOC_DEVICE_STREAMER && IOC_CONTROLLER_STREAMER
+
+/* Time limit for one upload, ms.
+ */
+#define IOCOMBENCH_UPLOAD_TIMEOUT_MS 60000
+
+/* Forward referred static functions.
+ */
+static osalStatus iocombench_upload_one(
+    iocomTestPair *p,
+    iocStreamerParams *cprm,
+    iocStreamerParams *dprm,
+    const os_char *data,
+    os_int nbytes,
+    os_char *rbuf,
+    os_int ring_sz);
+
+static void iocombench_upload_run(
+    iocomTestPair *p);
+
+
+/**
+****************************************************************************************************
+
+  @brief Streamer upload benchmark.
+  @anchor iocombench_upload
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_upload(void)
+{
+    iocomTestPair p;
+    iocomBenchStreamer *st;
+    iocStreamerParams cprm, dprm;
+    os_char *data, *rbuf;
+    os_int nbytes, ring_sz, rounds, i, nuploads;
+    os_int64 start_us, end_us;
+    os_double cpu_ms, s;
+    os_char state_bits;
+    os_timer start_t;
+
+    nbytes = (os_int)iocombench_option("bytes", 1048576);
+    ring_sz = (os_int)iocombench_option("ring", 16384);
+    rounds = (os_int)iocombench_option("rounds", 3);
+    if (nbytes <= 0 || ring_sz <= 0 || rounds <= 0) return;
+    st = (iocomBenchStreamer*)os_malloc(sizeof(iocomBenchStreamer), OS_NULL);
+    data = (os_char*)os_malloc(nbytes, OS_NULL);
+    rbuf = (os_char*)os_malloc(ring_sz, OS_NULL);
+    if (st == OS_NULL || data == OS_NULL || rbuf == OS_NULL) goto getout;
+    for (i = 0; i < nbytes; i++) data[i] = (os_char)(i * 13);
+
+    iocomtest_initialize_pair(&p, IOCOMBENCH_NAME);
+    iocombench_setup_streamer(st, &p, ring_sz, OS_TRUE);
+    os_memclear(&cprm, sizeof(cprm));
+    os_memcpy(&cprm.tod, &st->csignals, sizeof(iocStreamerSignals));
+    os_memclear(&dprm, sizeof(dprm));
+    dprm.is_device = OS_TRUE;
+    os_memcpy(&dprm.tod, &st->dsignals, sizeof(iocStreamerSignals));
+    ioc_set(dprm.tod.state, IOC_STREAM_IDLE);
+    iocombench_connect_pair(&p);
+
+    /* Wait until controller sees device's state, so that connect time is not measured.
+     */
+    os_get_timer(&start_t);
+    do
+    {
+        if (os_has_elapsed(&start_t, IOCOMTEST_TIMEOUT_MS))
+        {
+            osal_console_write("upload: not connected\n");
+            goto release;
+        }
+        iocombench_upload_run(&p);
+        ioc_get_ext(cprm.tod.state, &state_bits, IOC_SIGNAL_DEFAULT);
+    }
+    while ((state_bits & OSAL_STATE_CONNECTED) == 0);
+
+    nuploads = 0;
+    cpu_ms = iocombench_cpu_ms();
+    os_time(&start_us);
+    for (i = 0; i < rounds; i++)
+    {
+        if (iocombench_upload_one(&p, &cprm, &dprm, data, nbytes, rbuf, ring_sz))
+        {
+            osal_console_write("upload: transfer failed\n");
+            break;
+        }
+        nuploads++;
+    }
+    os_time(&end_us);
+    s = (end_us - start_us) / 1000000.0;
+
+    iocombench_result("upload", "uploads", nuploads, "");
+    if (nuploads)
+    {
+        iocombench_result("upload", "upload_ms", 1000.0 * s / nuploads, "ms");
+        iocombench_result("upload", "throughput", nuploads * (os_double)nbytes / s / 1.0e6,
+            "MB/s");
+        if (cpu_ms >= 0) {
+            iocombench_result("upload", "cpu",
+                100.0 * (iocombench_cpu_ms() - cpu_ms) / (1000.0 * s), "%");
+        }
+    }
+
+release:
+    iocombench_release_streamer(st);
+    iocomtest_release_pair(&p);
+
+getout:
+    if (st) os_free(st, sizeof(iocomBenchStreamer));
+    if (data) os_free(data, nbytes);
+    if (rbuf) os_free(rbuf, ring_sz);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Upload data once (internal).
+  @anchor iocombench_upload_one
+
+  Controller opens the stream for writing. Device opens its end for reading once controller's
+  command is IOC_STREAM_RUNNING, like device's control stream does.
+
+  @param   p Pointer to connected test pair.
+  @param   cprm Controller's streamer parameters.
+  @param   dprm Device's streamer parameters.
+  @param   data Data to upload.
+  @param   nbytes Number of bytes to upload.
+  @param   rbuf Device's read buffer.
+  @param   ring_sz Size of read buffer, bytes.
+  @return  OSAL_SUCCESS if all data was received and both ends completed. Other values
+           indicate an error.
+
+****************************************************************************************************
+*/
+static osalStatus iocombench_upload_one(
+    iocomTestPair *p,
+    iocStreamerParams *cprm,
+    iocStreamerParams *dprm,
+    const os_char *data,
+    os_int nbytes,
+    os_char *rbuf,
+    os_int ring_sz)
+{
+    osalStream cstream, dstream;
+    os_memsz n, pos, received;
+    os_boolean flushed, done;
+    osalStatus s, rval;
+    os_timer start_t;
+
+    cstream = ioc_streamer_open(OS_NULL, cprm, OS_NULL, OSAL_STREAM_WRITE);
+    if (cstream == OS_NULL) return OSAL_STATUS_FAILED;
+    dstream = OS_NULL;
+    pos = received = 0;
+    flushed = done = OS_FALSE;
+    rval = OSAL_STATUS_TIMEOUT;
+
+    os_get_timer(&start_t);
+    while (!os_has_elapsed(&start_t, IOCOMBENCH_UPLOAD_TIMEOUT_MS))
+    {
+        /* Controller: Write data, then final handshake.
+         */
+        if (pos < nbytes)
+        {
+            s = ioc_streamer_write(cstream, data + pos, nbytes - pos, &n, OSAL_STREAM_DEFAULT);
+            if (OSAL_IS_ERROR(s))
+            {
+                rval = s;
+                break;
+            }
+            pos += n;
+        }
+        else if (!flushed)
+        {
+            s = ioc_streamer_flush(cstream, OSAL_STREAM_FINAL_HANDSHAKE);
+            if (s == OSAL_SUCCESS)
+            {
+                flushed = OS_TRUE;
+            }
+            else if (s != OSAL_PENDING)
+            {
+                rval = s;
+                break;
+            }
+        }
+
+        /* Device: Open when controller starts the transfer, read until completed.
+         */
+        if (dstream == OS_NULL)
+        {
+            if (ioc_get(dprm->tod.cmd) == IOC_STREAM_RUNNING) {
+                dstream = ioc_streamer_open(OS_NULL, dprm, OS_NULL, OSAL_STREAM_READ);
+            }
+        }
+        else if (!done)
+        {
+            s = ioc_streamer_read(dstream, rbuf, ring_sz, &n, OSAL_STREAM_DEFAULT);
+            received += n;
+            if (s == OSAL_COMPLETED)
+            {
+                done = OS_TRUE;
+            }
+            else if (s)
+            {
+                rval = s;
+                break;
+            }
+        }
+
+        if (flushed && done)
+        {
+            rval = (received == nbytes) ? OSAL_SUCCESS : OSAL_STATUS_FAILED;
+            break;
+        }
+        iocombench_upload_run(p);
+    }
+
+    ioc_streamer_close(cstream, OSAL_STREAM_DEFAULT);
+    ioc_streamer_close(dstream, OSAL_STREAM_DEFAULT);
+    iocombench_upload_run(p);
+    return rval;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Move changed signals both ways (internal).
+  @anchor iocombench_upload_run
+
+  @param   p Pointer to test pair.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_upload_run(
+    iocomTestPair *p)
+{
+    ioc_send_all(&p->device);
+    ioc_send_all(&p->controller);
+    iocomtest_run_pair(p);
+    ioc_receive_all(&p->device);
+    ioc_receive_all(&p->controller);
+}
+
+#else
+void iocombench_upload(void) {}
+#endif
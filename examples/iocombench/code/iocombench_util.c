@@ -0,0 +1,637 @@
+/**
+
+  @file    iocom/examples/iocombench/code/iocombench_util.c
+  @brief   Benchmark options, result output and measurement helpers.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "iocombench.h"
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+/* Command line arguments.
+ */
+static os_int iocombench_argc;
+static os_char **iocombench_argv;
+
+#if IOC_STREAMER_SUPPORT
+/* Forward referred static functions.
+ */
+static void iocombench_streamer_signals(
+    iocSignal *sig,
+    iocStreamerSignals *signals,
+    iocHandle *exp,
+    iocHandle *imp,
+    os_int buf_sz,
+    os_boolean to_device);
+#endif
+
+
+/**
+****************************************************************************************************
+
+  @brief Store command line options.
+  @anchor iocombench_set_options
+
+  @param   argc Number of command line arguments.
+  @param   argv Array of command line arguments.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_set_options(
+    os_int argc,
+    os_char *argv[])
+{
+    iocombench_argc = argc;
+    iocombench_argv = argv;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get integer option.
+  @anchor iocombench_option
+
+  Options are given on command line as name=value, like "n=5000".
+
+  @param   name Option name.
+  @param   default_value Value to return if option is not given.
+  @return  Option value.
+
+****************************************************************************************************
+*/
+os_long iocombench_option(
+    const os_char *name,
+    os_long default_value)
+{
+    os_memsz len;
+    os_int i;
+
+    len = os_strlen(name) - 1;
+    for (i = 1; i < iocombench_argc; i++)
+    {
+        if (!os_strncmp(iocombench_argv[i], name, len) && iocombench_argv[i][len] == '=')
+        {
+            return osal_str_to_int(iocombench_argv[i] + len + 1, OS_NULL);
+        }
+    }
+    return default_value;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Print benchmark result line.
+  @anchor iocombench_result
+
+  @param   scenario Scenario name.
+  @param   metric Metric name.
+  @param   value Measured value.
+  @param   unit Unit of the value, like "ms".
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_result(
+    const os_char *scenario,
+    const os_char *metric,
+    os_double value,
+    const os_char *unit)
+{
+    os_char nbuf[OSAL_NBUF_SZ];
+
+    osal_double_to_str(nbuf, sizeof(nbuf), value, 3, OSAL_FLOAT_DEFAULT);
+    osal_console_write(scenario);
+    osal_console_write(".");
+    osal_console_write(metric);
+    osal_console_write(" ");
+    osal_console_write(nbuf);
+    osal_console_write(" ");
+    osal_console_write(unit);
+    osal_console_write("\n");
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Sort samples and get percentile.
+  @anchor iocombench_percentile
+
+  Samples are sorted in place (shell sort), so several percentiles can be taken from the same
+  array.
+
+  @param   samples Array of samples.
+  @param   n Number of samples.
+  @param   percent Percentile 0 - 100.
+  @return  Sample value at the percentile, 0 if no samples.
+
+****************************************************************************************************
+*/
+os_int64 iocombench_percentile(
+    os_int64 *samples,
+    os_int n,
+    os_int percent)
+{
+    os_int64 x;
+    os_int gap, i, j;
+
+    if (n <= 0) return 0;
+
+    for (gap = n / 2; gap > 0; gap /= 2)
+    {
+        for (i = gap; i < n; i++)
+        {
+            x = samples[i];
+            for (j = i; j >= gap && samples[j - gap] > x; j -= gap)
+            {
+                samples[j] = samples[j - gap];
+            }
+            samples[j] = x;
+        }
+    }
+
+    i = (os_int)(((os_long)n * percent) / 100);
+    if (i >= n) i = n - 1;
+    return samples[i];
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get CPU time used by the process.
+  @anchor iocombench_cpu_ms
+
+  User and system time of all threads. Available on Linux only.
+
+  @return  CPU time in milliseconds, -1 if not available.
+
+****************************************************************************************************
+*/
+os_double iocombench_cpu_ms(void)
+{
+#if defined(__linux__)
+    struct rusage u;
+
+    if (getrusage(RUSAGE_SELF, &u)) return -1.0;
+    return (u.ru_utime.tv_sec + u.ru_stime.tv_sec) * 1000.0 +
+        (u.ru_utime.tv_usec + u.ru_stime.tv_usec) / 1000.0;
+#else
+    return -1.0;
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get CPU time used by the calling thread.
+  @anchor iocombench_thread_cpu_ms
+
+  User and system time of the calling thread only. Subtracted from iocombench_cpu_ms() this
+  gives CPU time used by the other threads, like connection threads of a server. Available
+  on Linux only.
+
+  @return  CPU time in milliseconds, -1 if not available.
+
+****************************************************************************************************
+*/
+os_double iocombench_thread_cpu_ms(void)
+{
+#if defined(__linux__) && defined(RUSAGE_THREAD)
+    struct rusage u;
+
+    if (getrusage(RUSAGE_THREAD, &u)) return -1.0;
+    return (u.ru_utime.tv_sec + u.ru_stime.tv_sec) * 1000.0 +
+        (u.ru_utime.tv_usec + u.ru_stime.tv_usec) / 1000.0;
+#else
+    return -1.0;
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set loopback delay and connect test pair.
+  @anchor iocombench_connect_pair
+
+  One way delay is taken from "delay" option (ms, default 0). Memory blocks should be
+  created before calling this function.
+
+  @param   p Pointer to test pair initialized by iocomtest_initialize_pair().
+  @return  OSAL_SUCCESS if successful, other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus iocombench_connect_pair(
+    iocomTestPair *p)
+{
+    ioc_set_loopback_delay(p->name, (os_int)iocombench_option("delay", 0));
+    return iocomtest_connect_pair(p);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Create echo memory blocks.
+  @anchor iocombench_setup_echo
+
+  Creates "exp" and "imp" memory blocks at both ends of the test pair. Call before the pair
+  is connected.
+
+  @param   e Echo structure to set up.
+  @param   p Test pair initialized by iocomtest_initialize_pair().
+  @param   priority Send priority of echo memory blocks, like IOC_MBLK_PRIORITY_HIGH. Ignored
+           if priority support is not compiled in.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_setup_echo(
+    iocomBenchEcho *e,
+    iocomTestPair *p,
+    os_char priority)
+{
+    iocMemoryBlockParams prm;
+
+    os_memclear(e, sizeof(iocomBenchEcho));
+    e->p = p;
+
+    os_memclear(&prm, sizeof(prm));
+    prm.nbytes = 64;
+#if IOC_MBLK_PRIORITY_SUPPORT
+    prm.priority = priority;
+#else
+    OSAL_UNUSED(priority);
+#endif
+    prm.mblk_name = "exp";
+    prm.flags = IOC_MBLK_UP;
+    iocomtest_memory_block_prm(&e->dexp, &p->device, &prm);
+    iocomtest_memory_block_prm(&e->cexp, &p->controller, &prm);
+    prm.mblk_name = "imp";
+    prm.flags = IOC_MBLK_DOWN;
+    iocomtest_memory_block_prm(&e->dimp, &p->device, &prm);
+    iocomtest_memory_block_prm(&e->cimp, &p->controller, &prm);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Measure echo round trips.
+  @anchor iocombench_run_echo
+
+  Device starts the next round trip when the previous one has been echoed. Both roots and the
+  background load function are run once per loop round.
+
+  @param   e Echo structure, pair connected.
+  @param   samples Array where to store round trip times, microseconds.
+  @param   rounds Number of round trips to measure, size of samples array.
+  @return  Number of round trips measured, less than rounds if timed out.
+
+****************************************************************************************************
+*/
+os_int iocombench_run_echo(
+    iocomBenchEcho *e,
+    os_int64 *samples,
+    os_int rounds)
+{
+    os_int64 start_us, now_us;
+    os_int n, seq, ctrl_seq, prev_ctrl_seq;
+    os_timer start_t;
+
+    n = 0;
+    seq = iocomtest_get_int(&e->dexp, 0);
+    prev_ctrl_seq = 0;
+    os_get_timer(&start_t);
+    os_time(&start_us);
+    while (n < rounds && !os_has_elapsed(&start_t, 10 * IOCOMTEST_TIMEOUT_MS))
+    {
+        ioc_receive(&e->dimp);
+        if (iocomtest_get_int(&e->dimp, 0) == seq)
+        {
+            os_time(&now_us);
+            if (seq) samples[n++] = now_us - start_us;
+            start_us = now_us;
+            iocomtest_set_int(&e->dexp, 0, ++seq);
+            ioc_send(&e->dexp);
+        }
+
+        ioc_receive(&e->cexp);
+        ctrl_seq = iocomtest_get_int(&e->cexp, 0);
+        if (ctrl_seq != prev_ctrl_seq)
+        {
+            prev_ctrl_seq = ctrl_seq;
+            iocomtest_set_int(&e->cimp, 0, ctrl_seq);
+            ioc_send(&e->cimp);
+        }
+
+        if (e->load_func) e->load_func(e->load_context);
+        iocomtest_run_pair(e->p);
+    }
+    return n;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release echo memory block handles.
+  @anchor iocombench_release_echo
+
+  @param   e Echo structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_release_echo(
+    iocomBenchEcho *e)
+{
+    ioc_release_handle(&e->dexp);
+    ioc_release_handle(&e->dimp);
+    ioc_release_handle(&e->cexp);
+    ioc_release_handle(&e->cimp);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Print round trip percentiles.
+  @anchor iocombench_rtt_results
+
+  Prints prefix_rtt_p50, prefix_rtt_p99 and prefix_rtt_max in milliseconds.
+
+  @param   scenario Scenario name.
+  @param   prefix Metric name prefix, like "high". OS_NULL or empty for none.
+  @param   samples Round trip times, microseconds. Sorted by this function.
+  @param   n Number of samples.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_rtt_results(
+    const os_char *scenario,
+    const os_char *prefix,
+    os_int64 *samples,
+    os_int n)
+{
+    static const os_int percent[] = {50, 99, 100};
+    static const os_char *suffix[] = {"rtt_p50", "rtt_p99", "rtt_max"};
+    os_char metric[64];
+    os_int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        metric[0] = '\0';
+        if (prefix && *prefix)
+        {
+            os_strncpy(metric, prefix, sizeof(metric));
+            os_strncat(metric, "_", sizeof(metric));
+        }
+        os_strncat(metric, suffix[i], sizeof(metric));
+        iocombench_result(scenario, metric,
+            iocombench_percentile(samples, n, percent[i]) / 1000.0, "ms");
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Open more connections from device to controller.
+  @anchor iocombench_connect_more
+
+  Device root of the test pair opens n more connections to controller's loopback end point,
+  like many devices with the same identity would. Each connection links device's memory
+  blocks to controller's matching ones independently, so controller has one source or
+  target buffer per connection for each memory block. Connections are run by
+  iocomtest_run_pair(), unless IOC_CREATE_THREAD flag is given.
+
+  @param   p Pointer to test pair, controller must be listening.
+  @param   cons Array where to store n connection pointers. Entries for connections which
+           could not be opened are set to OS_NULL.
+  @param   n Number of connections to open.
+  @param   flags Additional connection flags, IOC_CREATE_THREAD to run each connection in
+           its own thread. Zero for none.
+  @return  OSAL_SUCCESS if all connections were opened, other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus iocombench_connect_more(
+    iocomTestPair *p,
+    iocConnection **cons,
+    os_int n,
+    os_short flags)
+{
+    iocConnectionParams conprm;
+    osalStatus s, rval = OSAL_SUCCESS;
+    os_int k;
+
+    os_memclear(&conprm, sizeof(conprm));
+    conprm.iface = IOC_LOOPBACK_IFACE;
+    conprm.flags = IOC_SOCKET|IOC_CONNECT_UP|flags;
+    conprm.parameters = p->name;
+
+    for (k = 0; k < n; k++)
+    {
+        cons[k] = ioc_initialize_connection(OS_NULL, &p->device);
+        if (cons[k] == OS_NULL)
+        {
+            rval = OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+            continue;
+        }
+        s = ioc_connect(cons[k], &conprm);
+        if (s)
+        {
+            ioc_release_connection(cons[k]);
+            cons[k] = OS_NULL;
+            rval = s;
+        }
+    }
+    return rval;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release connections opened by iocombench_connect_more().
+  @anchor iocombench_release_more
+
+  @param   cons Array of connection pointers, OS_NULL entries are skipped.
+  @param   n Number of entries in array.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_release_more(
+    iocConnection **cons,
+    os_int n)
+{
+    os_int k;
+
+    for (k = 0; k < n; k++)
+    {
+        if (cons[k])
+        {
+            ioc_release_connection(cons[k]);
+            cons[k] = OS_NULL;
+        }
+    }
+}
+
+
+#if IOC_STREAMER_SUPPORT
+/**
+****************************************************************************************************
+
+  @brief Set up ring buffer streamer signals at both ends of test pair.
+  @anchor iocombench_setup_streamer
+
+  Creates "exp" (IOC_MBLK_UP) and "imp" (IOC_MBLK_DOWN) memory blocks at both ends. Ring
+  buffer, head and checksum are written by the sending end: In "exp" for transfer from
+  device, in "imp" for transfer to device. Call before connecting the pair.
+
+  @param   s Pointer to streamer structure to set up.
+  @param   p Pointer to initialized test pair, not yet connected.
+  @param   buf_sz Ring buffer size, bytes.
+  @param   to_device OS_TRUE for transfer from controller to device, OS_FALSE for transfer
+           from device to controller.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_setup_streamer(
+    iocomBenchStreamer *s,
+    iocomTestPair *p,
+    os_int buf_sz,
+    os_boolean to_device)
+{
+    os_memclear(s, sizeof(iocomBenchStreamer));
+
+    iocomtest_memory_block(&s->dexp, &p->device, "exp", buf_sz + 21, IOC_MBLK_UP);
+    iocomtest_memory_block(&s->dimp, &p->device, "imp", buf_sz + 21, IOC_MBLK_DOWN);
+    iocomtest_memory_block(&s->cexp, &p->controller, "exp", buf_sz + 21, IOC_MBLK_UP);
+    iocomtest_memory_block(&s->cimp, &p->controller, "imp", buf_sz + 21, IOC_MBLK_DOWN);
+
+    iocombench_streamer_signals(s->dsig, &s->dsignals, &s->dexp, &s->dimp, buf_sz, to_device);
+    iocombench_streamer_signals(s->csig, &s->csignals, &s->cexp, &s->cimp, buf_sz, to_device);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release streamer memory block handles.
+  @anchor iocombench_release_streamer
+
+  @param   s Pointer to streamer structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocombench_release_streamer(
+    iocomBenchStreamer *s)
+{
+    ioc_release_handle(&s->dexp);
+    ioc_release_handle(&s->dimp);
+    ioc_release_handle(&s->cexp);
+    ioc_release_handle(&s->cimp);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set up ring buffer streamer signals for one end (internal).
+  @anchor iocombench_streamer_signals
+
+  Both memory blocks have the same layout, each signal has state byte followed by value:
+  Integers at 0, 5 and 10, checksum (ushort) at 15, error (char) at 18 and ring buffer at 20.
+  Command and select are in "imp", state and error in "exp". Sending end's memory block holds
+  head at 10, checksum and buffer, receiving end's holds tail at 10.
+
+  @param   sig Array of IOCOMBENCH_STREAM_NRO_SIGNALS signals to set up.
+  @param   signals Streamer signal structure to set up.
+  @param   exp Handle of "exp" memory block.
+  @param   imp Handle of "imp" memory block.
+  @param   buf_sz Ring buffer size, bytes.
+  @param   to_device OS_TRUE for transfer from controller to device.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocombench_streamer_signals(
+    iocSignal *sig,
+    iocStreamerSignals *signals,
+    iocHandle *exp,
+    iocHandle *imp,
+    os_int buf_sz,
+    os_boolean to_device)
+{
+    iocHandle *snd, *rcv;
+    os_int i;
+
+    snd = to_device ? imp : exp;
+    rcv = to_device ? exp : imp;
+
+    os_memclear(sig, IOCOMBENCH_STREAM_NRO_SIGNALS * sizeof(iocSignal));
+    for (i = 0; i < IOCOMBENCH_STREAM_NRO_SIGNALS; i++) {
+        sig[i].n = 1;
+        sig[i].flags = OS_INT;
+    }
+
+    /* Command is written by controller and state by device, whatever the direction.
+     */
+    sig[IOCOMBENCH_STREAM_CMD].handle = imp;
+    sig[IOCOMBENCH_STREAM_STATE].handle = exp;
+    sig[IOCOMBENCH_STREAM_SELECT].addr = 5;
+    sig[IOCOMBENCH_STREAM_SELECT].handle = imp;
+    sig[IOCOMBENCH_STREAM_HEAD].addr = 10;
+    sig[IOCOMBENCH_STREAM_HEAD].handle = snd;
+    sig[IOCOMBENCH_STREAM_CS].addr = 15;
+    sig[IOCOMBENCH_STREAM_CS].flags = OS_USHORT;
+    sig[IOCOMBENCH_STREAM_CS].handle = snd;
+    sig[IOCOMBENCH_STREAM_BUF].addr = 20;
+    sig[IOCOMBENCH_STREAM_BUF].n = buf_sz;
+    sig[IOCOMBENCH_STREAM_BUF].flags = OS_UCHAR;
+    sig[IOCOMBENCH_STREAM_BUF].handle = snd;
+    sig[IOCOMBENCH_STREAM_TAIL].addr = 10;
+    sig[IOCOMBENCH_STREAM_TAIL].handle = rcv;
+    sig[IOCOMBENCH_STREAM_ERR].addr = 18;
+    sig[IOCOMBENCH_STREAM_ERR].flags = OS_CHAR;
+    sig[IOCOMBENCH_STREAM_ERR].handle = exp;
+
+    os_memclear(signals, sizeof(iocStreamerSignals));
+    signals->cmd = sig + IOCOMBENCH_STREAM_CMD;
+    signals->select = sig + IOCOMBENCH_STREAM_SELECT;
+    signals->err = sig + IOCOMBENCH_STREAM_ERR;
+    signals->cs = sig + IOCOMBENCH_STREAM_CS;
+    signals->buf = sig + IOCOMBENCH_STREAM_BUF;
+    signals->head = sig + IOCOMBENCH_STREAM_HEAD;
+    signals->tail = sig + IOCOMBENCH_STREAM_TAIL;
+    signals->state = sig + IOCOMBENCH_STREAM_STATE;
+    signals->to_device = to_device;
+    signals->flat_buffer = OS_FALSE;
+}
+#endif
@@ -0,0 +1,17 @@
+#!/bin/sh
+# make-test-certificates.sh - Generate test certificates for "iocombench storm tls=1".
+# Creates test root CA (rootca.crt) and server certificate and key for 127.0.0.1
+# (iocombench.crt, iocombench.key) into directory given as argument, "certs" by default.
+# Keys are not protected, use for testing only.
+set -e
+CERTS_DIR=${1:-certs}
+mkdir -p "$CERTS_DIR"
+cd "$CERTS_DIR"
+openssl req -x509 -newkey rsa:2048 -nodes -days 3650 -subj "/CN=iocombench test CA" \
+  -keyout rootca.key -out rootca.crt
+openssl req -newkey rsa:2048 -nodes -subj "/CN=127.0.0.1" \
+  -keyout iocombench.key -out iocombench.csr
+echo "subjectAltName=IP:127.0.0.1" > iocombench.ext
+openssl x509 -req -in iocombench.csr -CA rootca.crt -CAkey rootca.key -CAcreateserial \
+  -days 3650 -extfile iocombench.ext -out iocombench.crt
+rm iocombench.csr iocombench.ext
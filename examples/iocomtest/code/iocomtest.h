@@ -0,0 +1,281 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest.h
+  @brief   Unit and loopback tests for iocom library.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Tests which need a connection use iocomTestPair: Two iocom roots, "device" which connects
+  upwards and "controller" which listens, connected by in-process loopback stream and run
+  from the test's own loop by iocomtest_run_pair().
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOCOMTEST_H_
+#define IOCOMTEST_H_
+#include "iocom.h"
+
+/* Network, device name and number used by tests.
+ */
+#define IOCOMTEST_NETWORK_NAME "iocomtest"
+#define IOCOMTEST_DEVICE_NAME "testdev"
+#define IOCOMTEST_DEVICE_NR 1
+
+/* Time to wait for a test condition before the check fails, ms.
+ */
+#define IOCOMTEST_TIMEOUT_MS 5000
+
+
+/**
+****************************************************************************************************
+    Device and controller roots connected by loopback stream.
+****************************************************************************************************
+*/
+typedef struct iocomTestPair
+{
+    /** Device root, connects up.
+     */
+    iocRoot device;
+
+    /** Controller root, listens.
+     */
+    iocRoot controller;
+
+    /** Device's connection and controller's end point, OS_NULL if not connected.
+     */
+    iocConnection *con;
+    iocEndPoint *epoint;
+
+    /** Loopback stream name.
+     */
+    const os_char *name;
+}
+iocomTestPair;
+
+#if IOC_STREAMER_SUPPORT
+/* Flat buffer brick signals: cmd in "imp", state, head, cs and buf in "exp".
+ */
+#define IOCOMTEST_BRICK_CMD 0
+#define IOCOMTEST_BRICK_STATE 1
+#define IOCOMTEST_BRICK_HEAD 2
+#define IOCOMTEST_BRICK_CS 3
+#define IOCOMTEST_BRICK_BUF 4
+#define IOCOMTEST_BRICK_NRO_SIGNALS 5
+
+
+/**
+****************************************************************************************************
+    Flat buffer brick transfer from device to controller over test pair.
+****************************************************************************************************
+*/
+typedef struct iocomTestBrickPair
+{
+    /** Device's and controller's "exp" and "imp" memory blocks.
+     */
+    iocHandle dexp, dimp, cexp, cimp;
+
+    /** Brick signals at device and controller end.
+     */
+    iocSignal dsig[IOCOMTEST_BRICK_NRO_SIGNALS];
+    iocSignal csig[IOCOMTEST_BRICK_NRO_SIGNALS];
+    iocStreamerSignals dsignals, csignals;
+
+    /** Device's sending and controller's receiving brick buffer.
+     */
+    iocBrickBuffer send, receive;
+}
+iocomTestBrickPair;
+#endif
+
+/* Condition function for iocomtest_run_pair_until().
+ */
+typedef os_boolean iocomtest_condition_func(
+    iocomTestPair *p,
+    void *context);
+
+
+/**
+****************************************************************************************************
+  Test framework functions
+****************************************************************************************************
+ */
+/*@{*/
+
+/* Check test condition, record and print failure.
+ */
+#define iocomtest_check(cond, text) \
+    iocomtest_report((os_boolean)((cond) ? OS_TRUE : OS_FALSE), (text), __FILE__, __LINE__)
+
+/* Record result of a check, used through iocomtest_check() macro.
+ */
+os_boolean iocomtest_report(
+    os_boolean ok,
+    const os_char *text,
+    const os_char *file,
+    os_int line);
+
+/* Print test group name.
+ */
+void iocomtest_group(
+    const os_char *name);
+
+/* Print summary, returns OSAL_SUCCESS if all checks passed.
+ */
+osalStatus iocomtest_summary(void);
+
+/* Initialize device and controller roots.
+ */
+void iocomtest_initialize_pair(
+    iocomTestPair *p,
+    const os_char *name);
+
+/* Start listening and connecting, memory blocks should be created before this.
+ */
+osalStatus iocomtest_connect_pair(
+    iocomTestPair *p);
+
+/* Close and reopen device's connection, memory blocks are kept.
+ */
+osalStatus iocomtest_reconnect_pair(
+    iocomTestPair *p);
+
+/* Close device's connection and controller's end point.
+ */
+void iocomtest_disconnect_pair(
+    iocomTestPair *p);
+
+/* Release device and controller roots.
+ */
+void iocomtest_release_pair(
+    iocomTestPair *p);
+
+/* Run both roots once.
+ */
+void iocomtest_run_pair(
+    iocomTestPair *p);
+
+/* Run both roots until condition is true or timeout.
+ */
+os_boolean iocomtest_run_pair_until(
+    iocomTestPair *p,
+    iocomtest_condition_func *func,
+    void *context,
+    os_int timeout_ms);
+
+/* Create memory block for test pair, IOC_MBLK_UP or IOC_MBLK_DOWN at both ends.
+ */
+osalStatus iocomtest_memory_block(
+    iocHandle *handle,
+    iocRoot *root,
+    const os_char *mblk_name,
+    os_int nbytes,
+    os_short flags);
+
+/* Create memory block for test pair with parameters, like priority.
+ */
+osalStatus iocomtest_memory_block_prm(
+    iocHandle *handle,
+    iocRoot *root,
+    iocMemoryBlockParams *prm);
+
+/* Write integer to memory block.
+ */
+void iocomtest_set_int(
+    iocHandle *handle,
+    os_int addr,
+    os_int value);
+
+/* Read integer from memory block.
+ */
+os_int iocomtest_get_int(
+    iocHandle *handle,
+    os_int addr);
+
+#if IOC_STREAMER_SUPPORT
+/* Create memory blocks and brick buffers for flat buffer brick transfer, before connecting.
+ */
+void iocomtest_setup_brick_pair(
+    iocomTestBrickPair *bp,
+    iocomTestPair *p,
+    os_int buf_sz);
+
+/* Move memory block data both ways and run controller's brick receive once.
+ */
+osalStatus iocomtest_run_brick_pair(
+    iocomTestBrickPair *bp,
+    iocomTestPair *p);
+
+/* Release brick buffers and memory block handles.
+ */
+void iocomtest_release_brick_pair(
+    iocomTestBrickPair *bp);
+#endif
+
+/*@}*/
+
+
+/**
+****************************************************************************************************
+  Test groups
+****************************************************************************************************
+ */
+/*@{*/
+
+/* LZ compression.
+ */
+void iocomtest_compress(void);
+
+/* Optional feature fields in authentication message.
+ */
+void iocomtest_auth(void);
+
+/* Adaptive flow control.
+ */
+void iocomtest_flow_control(void);
+
+/* Memory block information resume on reconnect.
+ */
+void iocomtest_resume(void);
+
+/* Memory block generation numbers and change journal.
+ */
+void iocomtest_journal(void);
+
+/* Communication event queue.
+ */
+void iocomtest_events(void);
+
+/* Memory blocks backed by memory mapped files.
+ */
+void iocomtest_mmap(void);
+
+/* Merging memory block changes within minimum send interval.
+ */
+void iocomtest_coalesce(void);
+
+/* Lossless sample history over brick transfer.
+ */
+void iocomtest_sampler(void);
+
+/* Tiled brick transfer, frame assembly and key frame request.
+ */
+void iocomtest_tiles(void);
+
+/* Brick hub delivery to local consumers and drop policies.
+ */
+void iocomtest_hub(void);
+
+/* Waking up idle connection threads for new memory blocks.
+ */
+void iocomtest_idle(void);
+
+/*@}*/
+
+#endif
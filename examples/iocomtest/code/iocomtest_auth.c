@@ -0,0 +1,138 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_auth.c
+  @brief   Tests for optional features in authentication message.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Both ends of a connection may be built with different optional features. Feature fields
+  in received authentication message must be consumed by the other end's feature bits, not
+  by this build's feature flags.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+
+/* Window and digest values used in test messages. Window is in kilobytes in message.
+ */
+#define IOCOMTEST_AUTH_WINDOW_KB 0x0140
+#define IOCOMTEST_AUTH_DIGEST 0x12345678
+
+/* Forward referred static functions.
+ */
+static os_int iocomtest_auth_message(
+    os_uchar *buf,
+    os_uchar features,
+    os_int trailer_sz);
+
+
+/**
+****************************************************************************************************
+
+  @brief Authentication feature tests.
+  @anchor iocomtest_auth
+
+  Feature byte and fields are written as ends built with different feature sets would write
+  them: all features, memory block info resume without adaptive flow control, adaptive flow
+  control without resume, older version without feature byte, and truncated message.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_auth(void)
+{
+    iocAuthFeatures f;
+    os_uchar buf[16], *p;
+    os_int n;
+
+    iocomtest_group("auth");
+
+    /* Both optional fields.
+     */
+    n = iocomtest_auth_message(buf, IOC_AUTH_FEATURE_LZ_COMPRESSION|
+        IOC_AUTH_FEATURE_FLOW_WINDOW|IOC_AUTH_FEATURE_MBINFO_RESUME, -1);
+    p = ioc_get_auth_features(&f, buf, buf + n);
+    iocomtest_check(p == buf + n, "all fields consumed");
+    iocomtest_check(f.max_in_air == IOCOMTEST_AUTH_WINDOW_KB << 10, "window with resume");
+    iocomtest_check(f.digest == IOCOMTEST_AUTH_DIGEST, "digest after window");
+
+    /* Other end built without adaptive flow control.
+     */
+    n = iocomtest_auth_message(buf, IOC_AUTH_FEATURE_MBINFO_RESUME, -1);
+    p = ioc_get_auth_features(&f, buf, buf + n);
+    iocomtest_check(p == buf + n, "digest only consumed");
+    iocomtest_check(f.max_in_air == 0, "no window from peer without flow control");
+    iocomtest_check(f.digest == IOCOMTEST_AUTH_DIGEST, "digest without window");
+
+    /* Other end built without resume.
+     */
+    n = iocomtest_auth_message(buf, IOC_AUTH_FEATURE_FLOW_WINDOW, -1);
+    p = ioc_get_auth_features(&f, buf, buf + n);
+    iocomtest_check(p == buf + n, "window only consumed");
+    iocomtest_check(f.max_in_air == IOCOMTEST_AUTH_WINDOW_KB << 10, "window without resume");
+    iocomtest_check(f.digest == 0, "no digest from peer without resume");
+
+    /* Older version, no feature byte.
+     */
+    p = ioc_get_auth_features(&f, buf, buf);
+    iocomtest_check(p == buf && f.flags == 0 && f.max_in_air == 0 && f.digest == 0,
+        "missing feature byte means no features");
+
+    /* Truncated digest is not read past end of message.
+     */
+    n = iocomtest_auth_message(buf, IOC_AUTH_FEATURE_FLOW_WINDOW|
+        IOC_AUTH_FEATURE_MBINFO_RESUME, 3);
+    p = ioc_get_auth_features(&f, buf, buf + n);
+    iocomtest_check(p == buf + n, "truncated message stops at end");
+    iocomtest_check(f.max_in_air == IOCOMTEST_AUTH_WINDOW_KB << 10 && f.digest == 0,
+        "window kept, truncated digest ignored");
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write feature byte and fields as the other end would (internal).
+  @anchor iocomtest_auth_message
+
+  @param   buf Buffer where to write, at least 1 + IOC_AUTH_FLOW_WINDOW_SZ +
+           IOC_AUTH_MBINFO_DIGEST_SZ bytes.
+  @param   features Feature flags, fields are written for IOC_AUTH_FEATURE_FLOW_WINDOW and
+           IOC_AUTH_FEATURE_MBINFO_RESUME bits.
+  @param   trailer_sz Number of bytes to keep after feature byte, -1 to keep all fields.
+  @return  Message length in bytes.
+
+****************************************************************************************************
+*/
+static os_int iocomtest_auth_message(
+    os_uchar *buf,
+    os_uchar features,
+    os_int trailer_sz)
+{
+    os_uchar *p;
+    os_int n;
+
+    p = buf;
+    *(p++) = features;
+    if (features & IOC_AUTH_FEATURE_FLOW_WINDOW) {
+        *(p++) = (os_uchar)IOCOMTEST_AUTH_WINDOW_KB;
+        *(p++) = (os_uchar)(IOCOMTEST_AUTH_WINDOW_KB >> 8);
+    }
+    if (features & IOC_AUTH_FEATURE_MBINFO_RESUME) {
+        *(p++) = (os_uchar)IOCOMTEST_AUTH_DIGEST;
+        *(p++) = (os_uchar)(IOCOMTEST_AUTH_DIGEST >> 8);
+        *(p++) = (os_uchar)(IOCOMTEST_AUTH_DIGEST >> 16);
+        *(p++) = (os_uchar)(IOCOMTEST_AUTH_DIGEST >> 24);
+    }
+
+    n = (os_int)(p - buf);
+    if (trailer_sz >= 0 && 1 + trailer_sz < n) n = 1 + trailer_sz;
+    return n;
+}
@@ -0,0 +1,154 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_coalesce.c
+  @brief   Tests for merging memory block changes within minimum send interval.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_MBLK_COALESCE
+
+/* Send interval, long enough that writes right after synchronization are postponed.
+ */
+#define IOCOMTEST_SEND_INTERVAL_MS 1000
+
+/* Memory block handles and value to wait for, used by condition functions.
+ */
+typedef struct iocomTestCoalesce
+{
+    iocHandle dexp, cexp;
+    os_int value;
+}
+iocomTestCoalesce;
+
+/* Forward referred static functions.
+ */
+static os_boolean iocomtest_coalesce_sent(
+    iocomTestPair *p,
+    void *context);
+
+static os_boolean iocomtest_coalesce_received(
+    iocomTestPair *p,
+    void *context);
+
+
+/**
+****************************************************************************************************
+
+  @brief Send interval tests.
+  @anchor iocomtest_coalesce
+
+  Changes written within the send interval are postponed and merged. The last change must
+  be sent once the interval has elapsed without further writes or ioc_send() calls, also
+  when there is no timer wheel to wake up the connection.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_coalesce(void)
+{
+    iocomTestPair p;
+    iocomTestCoalesce t;
+    os_uint sync_count;
+
+    iocomtest_group("coalesce");
+    os_memclear(&t, sizeof(t));
+
+    iocomtest_initialize_pair(&p, "coalescetest");
+    iocomtest_memory_block(&t.dexp, &p.device, "exp", 16, IOC_MBLK_UP);
+    iocomtest_memory_block(&t.cexp, &p.controller, "exp", 16, IOC_MBLK_UP);
+    ioc_set_mblk_send_interval(&t.dexp, IOCOMTEST_SEND_INTERVAL_MS);
+
+    t.value = 1;
+    iocomtest_set_int(&t.dexp, 0, t.value);
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_coalesce_sent, &t,
+        IOCOMTEST_TIMEOUT_MS), "first change sent");
+
+    /* Written right after synchronization: postponed.
+     */
+    sync_count = t.dexp.mblk->sync_count;
+    iocomtest_set_int(&t.dexp, 0, 2);
+    ioc_send(&t.dexp);
+    iocomtest_set_int(&t.dexp, 0, 3);
+    ioc_send(&t.dexp);
+    iocomtest_check(t.dexp.mblk->coalesced_count >= 2, "changes within interval postponed");
+    iocomtest_run_pair(&p);
+    ioc_receive(&t.cexp);
+    iocomtest_check(iocomtest_get_int(&t.cexp, 0) == 1, "postponed change not sent yet");
+
+    /* Only run the connection, no more writes or ioc_send() calls.
+     */
+    t.value = 3;
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_coalesce_received, &t,
+        IOCOMTEST_SEND_INTERVAL_MS + IOCOMTEST_TIMEOUT_MS), "last change sent after interval");
+    iocomtest_check(t.dexp.mblk->sync_count == sync_count + 1, "changes merged into one frame");
+
+    ioc_release_handle(&t.dexp);
+    ioc_release_handle(&t.cexp);
+    iocomtest_release_pair(&p);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Send device's memory block and check if controller has received the value (internal).
+  @anchor iocomtest_coalesce_sent
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestCoalesce.
+  @return  OS_TRUE if controller has received the value.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_coalesce_sent(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestCoalesce *t;
+    OSAL_UNUSED(p);
+
+    t = (iocomTestCoalesce*)context;
+    ioc_send(&t->dexp);
+    ioc_receive(&t->cexp);
+    return (os_boolean)(iocomtest_get_int(&t->cexp, 0) == t->value);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check if controller has received the value, without sending (internal).
+  @anchor iocomtest_coalesce_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestCoalesce.
+  @return  OS_TRUE if controller has received the value.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_coalesce_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestCoalesce *t;
+    OSAL_UNUSED(p);
+
+    t = (iocomTestCoalesce*)context;
+    ioc_receive(&t->cexp);
+    return (os_boolean)(iocomtest_get_int(&t->cexp, 0) == t->value);
+}
+
+#else
+void iocomtest_coalesce(void) {}
+#endif
@@ -0,0 +1,221 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_compress.c
+  @brief   Tests for LZ compression.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_LZ_COMPRESSION_SUPPORT
+
+#define IOCOMTEST_LZ_DATA_SZ 10000
+#define IOCOMTEST_LZ_MBLK_SZ 3000
+
+/* Device's and controller's memory block handles for condition function.
+ */
+typedef struct iocomTestLzHandles
+{
+    iocHandle dh;
+    iocHandle ch;
+}
+iocomTestLzHandles;
+
+/* Forward referred static functions.
+ */
+static void iocomtest_fill_json(
+    os_char *buf,
+    os_int n);
+
+static os_boolean iocomtest_mblk_matches(
+    iocomTestPair *p,
+    void *context);
+
+
+/**
+****************************************************************************************************
+
+  @brief LZ compression tests.
+  @anchor iocomtest_compress
+
+  Round trip of JSON like data in IOC_LZ_MAX_SRC_BYTES pieces, incompressible data, delta
+  encoding, corrupted data and LZ compressed key frame over loopback connection.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_compress(void)
+{
+    os_char *src, *dst, *out;
+    os_int start_addr, prev_addr, n, i;
+    os_uint x;
+    os_boolean ok;
+    os_char bad[4];
+    iocomTestPair p;
+    iocomTestLzHandles h;
+
+    iocomtest_group("compress");
+
+    src = (os_char*)os_malloc(IOCOMTEST_LZ_DATA_SZ, OS_NULL);
+    dst = (os_char*)os_malloc(IOCOMTEST_LZ_DATA_SZ, OS_NULL);
+    out = (os_char*)os_malloc(IOCOMTEST_LZ_DATA_SZ, OS_NULL);
+    if (src == OS_NULL || dst == OS_NULL || out == OS_NULL)
+    {
+        iocomtest_check(OS_FALSE, "memory allocation");
+        goto getout;
+    }
+
+    /* Round trip, compressed at most IOC_LZ_MAX_SRC_BYTES at a time.
+     */
+    iocomtest_fill_json(src, IOCOMTEST_LZ_DATA_SZ);
+    os_memclear(out, IOCOMTEST_LZ_DATA_SZ);
+    start_addr = 0;
+    ok = OS_TRUE;
+    while (start_addr < IOCOMTEST_LZ_DATA_SZ)
+    {
+        prev_addr = start_addr;
+        n = ioc_compress_lz(src, &start_addr, IOCOMTEST_LZ_DATA_SZ - 1,
+            dst, IOCOMTEST_LZ_DATA_SZ);
+        if (n <= 0 || start_addr - prev_addr > IOC_LZ_MAX_SRC_BYTES ||
+            n >= start_addr - prev_addr)
+        {
+            ok = OS_FALSE;
+            break;
+        }
+        if (ioc_uncompress_lz(dst, n, out + prev_addr, start_addr - prev_addr, 0)
+            != start_addr - prev_addr)
+        {
+            ok = OS_FALSE;
+            break;
+        }
+    }
+    iocomtest_check(ok, "LZ compress in pieces");
+    iocomtest_check(ok && !os_memcmp(src, out, IOCOMTEST_LZ_DATA_SZ), "LZ round trip");
+
+    /* Incompressible data must be left uncompressed.
+     */
+    x = 12345;
+    for (i = 0; i < IOC_LZ_MAX_SRC_BYTES; i++)
+    {
+        x = x * 1103515245U + 12345U;
+        src[i] = (os_char)(x >> 16);
+    }
+    start_addr = 0;
+    n = ioc_compress_lz(src, &start_addr, IOC_LZ_MAX_SRC_BYTES - 1, dst, IOCOMTEST_LZ_DATA_SZ);
+    iocomtest_check(n == -1 && start_addr == 0, "LZ incompressible data");
+
+    /* Delta encoded data is added to destination.
+     */
+    for (i = 0; i < 1000; i++)
+    {
+        src[i] = (os_char)(i < 500 ? 1 : 0);
+        out[i] = (os_char)i;
+    }
+    start_addr = 0;
+    n = ioc_compress_lz(src, &start_addr, 999, dst, IOCOMTEST_LZ_DATA_SZ);
+    ok = (n > 0 && ioc_uncompress_lz(dst, n, out, 1000, IOC_DELTA_ENCODED) == 1000);
+    for (i = 0; i < 1000 && ok; i++)
+    {
+        if (out[i] != (os_char)(i + (i < 500 ? 1 : 0))) ok = OS_FALSE;
+    }
+    iocomtest_check(ok, "LZ delta encoding");
+
+    /* Match offset pointing before start of data.
+     */
+    bad[0] = 0x10;
+    bad[1] = 'a';
+    bad[2] = 5;
+    bad[3] = 0;
+    iocomtest_check(ioc_uncompress_lz(bad, sizeof(bad), out, 100, 0) == -1,
+        "LZ corrupted data");
+
+    /* Key frame of JSON like memory block over loopback connection.
+     */
+    iocomtest_initialize_pair(&p, "lztest");
+    iocomtest_memory_block(&h.dh, &p.device, "conf", IOCOMTEST_LZ_MBLK_SZ, IOC_MBLK_UP);
+    iocomtest_memory_block(&h.ch, &p.controller, "conf", IOCOMTEST_LZ_MBLK_SZ, IOC_MBLK_UP);
+    iocomtest_fill_json(src, IOCOMTEST_LZ_MBLK_SZ);
+    ioc_write(&h.dh, 0, src, IOCOMTEST_LZ_MBLK_SZ, 0);
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_mblk_matches, &h,
+        IOCOMTEST_TIMEOUT_MS), "LZ key frame over connection");
+    ioc_release_handle(&h.dh);
+    ioc_release_handle(&h.ch);
+    iocomtest_release_pair(&p);
+
+getout:
+    os_free(src, IOCOMTEST_LZ_DATA_SZ);
+    os_free(dst, IOCOMTEST_LZ_DATA_SZ);
+    os_free(out, IOCOMTEST_LZ_DATA_SZ);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Fill buffer with JSON like text (internal).
+  @anchor iocomtest_fill_json
+
+  @param   buf Buffer to fill.
+  @param   n Buffer size in bytes.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocomtest_fill_json(
+    os_char *buf,
+    os_int n)
+{
+    const os_char *item = "{\"name\": \"signal\", \"type\": \"ushort\", \"array\": 8},\n";
+    os_char nbuf[OSAL_NBUF_SZ];
+    os_int pos, i, j;
+
+    pos = 0;
+    for (i = 0; pos < n; i++)
+    {
+        osal_int_to_str(nbuf, sizeof(nbuf), i);
+        for (j = 0; item[j] && pos < n; j++) buf[pos++] = item[j];
+        for (j = 0; nbuf[j] && pos < n; j++) buf[pos++] = nbuf[j];
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check if controller's memory block has data written by device (internal).
+  @anchor iocomtest_mblk_matches
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestLzHandles.
+  @return  OS_TRUE if data matches.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_mblk_matches(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestLzHandles *h;
+    os_char expected[IOCOMTEST_LZ_MBLK_SZ], received[IOCOMTEST_LZ_MBLK_SZ];
+    OSAL_UNUSED(p);
+
+    h = (iocomTestLzHandles*)context;
+    ioc_send(&h->dh);
+    ioc_receive(&h->ch);
+    ioc_read(&h->ch, 0, received, IOCOMTEST_LZ_MBLK_SZ, 0);
+    iocomtest_fill_json(expected, IOCOMTEST_LZ_MBLK_SZ);
+    return (os_boolean)!os_memcmp(expected, received, IOCOMTEST_LZ_MBLK_SZ);
+}
+
+#else
+void iocomtest_compress(void) {}
+#endif
@@ -0,0 +1,121 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_events.c
+  @brief   Tests for communication event queue.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_DYNAMIC_MBLK_CODE
+
+#define IOCOMTEST_MAX_EVENTS 3
+
+/* Forward referred static functions.
+ */
+static osalStatus iocomtest_queue_mblk_event(
+    iocRoot *root,
+    iocEvent event,
+    const os_char *mblk_name);
+
+
+/**
+****************************************************************************************************
+
+  @brief Event queue tests.
+  @anchor iocomtest_events
+
+  When the ring buffer is full, a new event may only be coalesced into the newest queued
+  event for the same memory block. Fresh "new memory block" after queued "new memory block,
+  memory block deleted" must not be coalesced into the first event, since application would
+  then see the memory block deleted while it exists.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_events(void)
+{
+    iocRoot root;
+    iocEventQueue *queue;
+    iocQueuedEvent events[IOCOMTEST_MAX_EVENTS + 1];
+    os_int n;
+
+    iocomtest_group("event queue");
+    ioc_initialize_root(&root, IOC_CREATE_OWN_MUTEX);
+    iocomtest_check(ioc_initialize_event_queue(&root, OS_NULL, IOCOMTEST_MAX_EVENTS,
+        IOC_ALL_MBLK_EVENTS) == OSAL_SUCCESS, "initialize event queue");
+    queue = root.event_queue;
+
+    /* Fill the queue.
+     */
+    iocomtest_queue_mblk_event(&root, IOC_NEW_MEMORY_BLOCK, "x");
+    iocomtest_queue_mblk_event(&root, IOC_MEMORY_BLOCK_DELETED, "x");
+    iocomtest_queue_mblk_event(&root, IOC_NEW_MEMORY_BLOCK, "y");
+    iocomtest_check(queue->coalesced == 0 && queue->dropped == 0, "queue filled");
+
+    iocomtest_check(iocomtest_queue_mblk_event(&root, IOC_NEW_MEMORY_BLOCK, "x")
+        != OSAL_SUCCESS, "new after deleted not coalesced into older event");
+    iocomtest_check(queue->coalesced == 0 && queue->dropped == 1, "event counted as dropped");
+
+    iocomtest_check(iocomtest_queue_mblk_event(&root, IOC_MEMORY_BLOCK_DELETED, "x")
+        == OSAL_SUCCESS, "duplicate of newest event coalesced");
+    iocomtest_check(iocomtest_queue_mblk_event(&root, IOC_NEW_MEMORY_BLOCK, "y")
+        == OSAL_SUCCESS, "duplicate of other memory block's event coalesced");
+    iocomtest_check(queue->coalesced == 2, "events counted as coalesced");
+
+    n = ioc_get_events(&root, events, IOCOMTEST_MAX_EVENTS + 1);
+    iocomtest_check(n == IOCOMTEST_MAX_EVENTS &&
+        events[0].event == IOC_NEW_MEMORY_BLOCK && !os_strcmp(events[0].mblk_name, "x") &&
+        events[1].event == IOC_MEMORY_BLOCK_DELETED && !os_strcmp(events[1].mblk_name, "x") &&
+        events[2].event == IOC_NEW_MEMORY_BLOCK && !os_strcmp(events[2].mblk_name, "y"),
+        "queued events in order");
+
+    /* Room again, the event is queued.
+     */
+    iocomtest_check(iocomtest_queue_mblk_event(&root, IOC_NEW_MEMORY_BLOCK, "x")
+        == OSAL_SUCCESS, "event queued after drain");
+    n = ioc_get_events(&root, events, IOCOMTEST_MAX_EVENTS + 1);
+    iocomtest_check(n == 1 && events[0].event == IOC_NEW_MEMORY_BLOCK, "fresh event received");
+
+    ioc_release_root(&root);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Queue memory block event for test device (internal).
+  @anchor iocomtest_queue_mblk_event
+
+  @param   root Pointer to root object with event queue.
+  @param   event Event to queue.
+  @param   mblk_name Memory block name.
+  @return  Return value of ioc_queue_event().
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_queue_mblk_event(
+    iocRoot *root,
+    iocEvent event,
+    const os_char *mblk_name)
+{
+    osalStatus s;
+
+    ioc_lock(root);
+    s = ioc_queue_event(root, event, IOCOMTEST_NETWORK_NAME, IOCOMTEST_DEVICE_NAME,
+        IOCOMTEST_DEVICE_NR, mblk_name);
+    ioc_unlock(root);
+    return s;
+}
+
+#else
+void iocomtest_events(void) {}
+#endif
@@ -0,0 +1,233 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_flow.c
+  @brief   Tests for adaptive flow control.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_ADAPTIVE_FLOW_CONTROL
+
+#define IOCOMTEST_FC_BULK_SZ 32768
+#define IOCOMTEST_FC_VERSIONS 20
+
+/* Memory block handles and transfer state for condition function.
+ */
+typedef struct iocomTestFlow
+{
+    iocHandle dbulk, cbulk;
+    iocHandle decho, cecho;
+    os_char buf[IOCOMTEST_FC_BULK_SZ];
+    os_int version;
+}
+iocomTestFlow;
+
+/* Forward referred static functions.
+ */
+static void iocomtest_set_window(
+    iocConnection *con,
+    os_int max_in_air);
+
+static os_boolean iocomtest_bulk_received(
+    iocomTestPair *p,
+    void *context);
+
+static void iocomtest_flow_delayed_ack(void);
+
+
+/**
+****************************************************************************************************
+
+  @brief Flow control tests.
+  @anchor iocomtest_flow_control
+
+  Mismatched windows: Controller's own window is set to IOC_FC_MAX_IN_AIR_LIMIT while device
+  sends with the smallest window IOC_FC_MIN_IN_AIR. Controller must acknowledge by the
+  device's window, not by its own: Otherwise device would fill its window and wait for
+  the keep alive message, which comes after IOC_SOCKET_KEEPALIVE_MS, far beyond the time
+  allowed for the whole transfer. Round trip time is not sampled from acknowledgement which
+  the other end may have delayed.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_flow_control(void)
+{
+    iocomTestPair p;
+    iocomTestFlow *f;
+    iocConnection *ccon;
+    os_int i, j;
+
+    iocomtest_group("flow control");
+    f = (iocomTestFlow*)os_malloc(sizeof(iocomTestFlow), OS_NULL);
+    if (f == OS_NULL) return;
+    os_memclear(f, sizeof(iocomTestFlow));
+
+    iocomtest_initialize_pair(&p, "fctest");
+    iocomtest_memory_block(&f->dbulk, &p.device, "bulk", IOCOMTEST_FC_BULK_SZ, IOC_MBLK_UP);
+    iocomtest_memory_block(&f->cbulk, &p.controller, "bulk", IOCOMTEST_FC_BULK_SZ, IOC_MBLK_UP);
+    iocomtest_memory_block(&f->decho, &p.device, "echo", 64, IOC_MBLK_DOWN);
+    iocomtest_memory_block(&f->cecho, &p.controller, "echo", 64, IOC_MBLK_DOWN);
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+
+    /* First version sets up connection and negotiates window bounds.
+     */
+    f->version = 1;
+    iocomtest_set_int(&f->dbulk, 0, f->version);
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_bulk_received, f,
+        IOCOMTEST_TIMEOUT_MS), "first version received");
+
+    ccon = p.controller.con.first;
+    iocomtest_check(ccon != OS_NULL && p.con != OS_NULL, "controller connection");
+    if (ccon == OS_NULL || p.con == OS_NULL) goto getout;
+
+    ioc_lock(&p.controller);
+    iocomtest_set_window(ccon, IOC_FC_MAX_IN_AIR_LIMIT);
+    ioc_unlock(&p.controller);
+    ioc_lock(&p.device);
+    iocomtest_set_window(p.con, p.con->fc.max_in_air_min);
+    ioc_unlock(&p.device);
+
+    /* Controller sends a frame, so that its round trip time and acknowledge limit can be
+       measured with the new window.
+     */
+    iocomtest_set_int(&f->cecho, 0, 1);
+    ioc_send(&f->cecho);
+
+    for (i = 2; i <= IOCOMTEST_FC_VERSIONS; i++)
+    {
+        f->version = i;
+        for (j = 4; j < IOCOMTEST_FC_BULK_SZ; j++) f->buf[j] = (os_char)(i + j * 7);
+        ioc_write(&f->dbulk, 4, f->buf + 4, IOCOMTEST_FC_BULK_SZ - 4, 0);
+        iocomtest_set_int(&f->dbulk, 0, f->version);
+        if (!iocomtest_run_pair_until(&p, iocomtest_bulk_received, f, IOCOMTEST_TIMEOUT_MS)) break;
+    }
+    iocomtest_check(i > IOCOMTEST_FC_VERSIONS, "mismatched windows, no wait for keep alive");
+    iocomtest_check(ccon->fc.ack_limit <= (p.con->max_in_air >> 1),
+        "acknowledge limit within half of peer's window");
+
+    iocomtest_flow_delayed_ack();
+
+getout:
+    ioc_release_handle(&f->dbulk);
+    ioc_release_handle(&f->cbulk);
+    ioc_release_handle(&f->decho);
+    ioc_release_handle(&f->cecho);
+    iocomtest_release_pair(&p);
+    os_free(f, sizeof(iocomTestFlow));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Set and pin connection's flow control window (internal).
+  @anchor iocomtest_set_window
+
+  Window bounds are set equal, so the window is not adapted away from the test value.
+  ioc_lock() must be on.
+
+  @param   con Pointer to the connection object.
+  @param   max_in_air Window size in bytes.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocomtest_set_window(
+    iocConnection *con,
+    os_int max_in_air)
+{
+    con->max_in_air = max_in_air;
+    con->max_ack_in_air = max_in_air + IOC_SOCKET_UNACKNOGLEDGED_LIMIT
+        + IOC_SOCKET_NRO_ACKS_TO_RESEVE * IOC_SOCKET_ACK_SIZE;
+    con->fc.max_in_air_min = con->fc.max_in_air_max = max_in_air;
+    con->fc.rtt_ms = 0;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check that only immediate acknowledgements are sampled (internal).
+  @anchor iocomtest_flow_delayed_ack
+
+  Byte counters of a connection object, which is not connected, are set as by sending and
+  receiving acknowledgements. Acknowledgement which covers everything sent may have been
+  held by the other end and is not sampled. Acknowledgement which arrives while more data
+  is in air is.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocomtest_flow_delayed_ack(void)
+{
+    iocConnection *con;
+
+    con = (iocConnection*)os_malloc(sizeof(iocConnection), OS_NULL);
+    if (con == OS_NULL) return;
+    os_memclear(con, sizeof(iocConnection));
+    con->flags = IOC_SOCKET;
+    con->bytes_sent = 1000;
+
+    /* Frame sent, nothing after it. Acknowledgement covers all.
+     */
+    ioc_flow_control_frame_sent(con, 100);
+    con->bytes_sent += 100;
+    con->processed_bytes = con->bytes_sent;
+    ioc_flow_control_ack_received(con);
+    iocomtest_check(con->fc.rtt_ms == 0 && !con->fc.rtt_measuring,
+        "delayed acknowledgement not sampled");
+
+    /* Frame sent and more after it. Acknowledgement for the frame arrives while the rest
+       is in air.
+     */
+    ioc_flow_control_frame_sent(con, 100);
+    con->bytes_sent += 300;
+    con->processed_bytes = con->bytes_sent - 200;
+    ioc_flow_control_ack_received(con);
+    iocomtest_check(con->fc.rtt_ms > 0, "immediate acknowledgement sampled");
+
+    os_free(con, sizeof(iocConnection));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Send device's bulk block and check if controller has current version (internal).
+  @anchor iocomtest_bulk_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestFlow.
+  @return  OS_TRUE if controller has received the version.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_bulk_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestFlow *f;
+    OSAL_UNUSED(p);
+
+    f = (iocomTestFlow*)context;
+    ioc_send(&f->dbulk);
+    ioc_send(&f->cecho);
+    ioc_receive(&f->cbulk);
+    ioc_receive(&f->decho);
+    return (os_boolean)(iocomtest_get_int(&f->cbulk, 0) == f->version);
+}
+
+#else
+void iocomtest_flow_control(void) {}
+#endif
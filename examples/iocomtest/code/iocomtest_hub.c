@@ -0,0 +1,350 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_hub.c
+  @brief   Tests for distributing received bricks to many consumers.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_BRICK_HUB_SUPPORT
+
+/* Grayscale test image, every pixel set to brick number.
+ */
+#define IOCOMTEST_HUB_W 16
+#define IOCOMTEST_HUB_H 8
+#define IOCOMTEST_HUB_FRAME_SZ (IOCOMTEST_HUB_W * IOCOMTEST_HUB_H)
+
+/* Local consumer state: busy consumer returns OSAL_PENDING.
+ */
+typedef struct iocomTestHubConsumer
+{
+    iocBrickHubConsumer consumer;
+    os_boolean busy;
+    os_int ndelivered;
+    os_int last_value;
+    os_boolean bad_brick;
+}
+iocomTestHubConsumer;
+
+/* Brick pair with hub on controller's receiving end, and two local consumers.
+ */
+typedef struct iocomTestHub
+{
+    iocomTestBrickPair bp;
+    iocBrickHub hub;
+    iocomTestHubConsumer latest, keep;
+
+    /** Number of bricks hub should have received, and consumer deliveries to wait for.
+     */
+    os_uint received;
+    os_int latest_delivered, keep_delivered;
+}
+iocomTestHub;
+
+/* Forward referred static functions.
+ */
+static osalStatus iocomtest_hub_consume(
+    iocBrickHubConsumer *consumer,
+    const os_uchar *buf,
+    os_memsz buf_sz,
+    void *context);
+
+static void iocomtest_hub_run(
+    iocomTestHub *t,
+    iocomTestPair *p);
+
+static os_boolean iocomtest_hub_ready(
+    iocomTestPair *p,
+    void *context);
+
+static os_boolean iocomtest_hub_received(
+    iocomTestPair *p,
+    void *context);
+
+static os_boolean iocomtest_hub_delivered(
+    iocomTestPair *p,
+    void *context);
+
+static osalStatus iocomtest_hub_send(
+    iocomTestHub *t,
+    iocomTestPair *p,
+    os_int value);
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick hub tests.
+  @anchor iocomtest_hub
+
+  Every brick received from device is passed to all local consumers. A busy consumer does
+  not hold back others: IOC_BRICK_HUB_KEEP_LATEST consumer gets the newest brick once it is
+  free, IOC_BRICK_HUB_KEEP_PENDING consumer the oldest one. Dropped bricks are counted.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_hub(void)
+{
+    iocomTestPair p;
+    iocomTestHub *t;
+    iocBrickHubConsumerParams prm;
+
+    iocomtest_group("hub");
+    t = (iocomTestHub*)os_malloc(sizeof(iocomTestHub), OS_NULL);
+    if (t == OS_NULL) return;
+    os_memclear(t, sizeof(iocomTestHub));
+
+    iocomtest_initialize_pair(&p, "hubtest");
+    iocomtest_setup_brick_pair(&t->bp, &p,
+        (os_int)sizeof(iocBrickHdr) + IOCOMTEST_HUB_FRAME_SZ);
+    ioc_initialize_brick_hub(&t->hub, &t->bp.receive);
+
+    os_memclear(&prm, sizeof(prm));
+    prm.func = iocomtest_hub_consume;
+    prm.policy = IOC_BRICK_HUB_KEEP_LATEST;
+    prm.context = &t->latest;
+    ioc_add_brick_hub_consumer(&t->hub, &t->latest.consumer, &prm);
+    prm.policy = IOC_BRICK_HUB_KEEP_PENDING;
+    prm.context = &t->keep;
+    ioc_add_brick_hub_consumer(&t->hub, &t->keep.consumer, &prm);
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+
+    /* Free consumers get every brick.
+     */
+    iocomtest_check(iocomtest_hub_send(t, &p, 1) == OSAL_SUCCESS, "brick stored");
+    t->latest_delivered = t->keep_delivered = 1;
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_hub_delivered, t,
+        IOCOMTEST_TIMEOUT_MS), "brick delivered to all consumers");
+    iocomtest_check(t->latest.last_value == 1 && t->keep.last_value == 1,
+        "consumers got the brick");
+
+    /* Two bricks while both consumers are busy.
+     */
+    t->latest.busy = t->keep.busy = OS_TRUE;
+    iocomtest_check(iocomtest_hub_send(t, &p, 2) == OSAL_SUCCESS, "second brick stored");
+    iocomtest_check(iocomtest_hub_send(t, &p, 3) == OSAL_SUCCESS, "third brick stored");
+    iocomtest_check(t->latest.ndelivered == 1 && t->keep.ndelivered == 1,
+        "busy consumers not called back");
+    iocomtest_check(t->latest.consumer.dropped == 1 && t->keep.consumer.dropped == 1,
+        "dropped bricks counted");
+
+    t->latest.busy = t->keep.busy = OS_FALSE;
+    t->latest_delivered = t->keep_delivered = 2;
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_hub_delivered, t,
+        IOCOMTEST_TIMEOUT_MS), "pending bricks delivered");
+    iocomtest_check(t->latest.last_value == 3, "keep latest consumer got newest brick");
+    iocomtest_check(t->keep.last_value == 2, "keep pending consumer got oldest brick");
+    iocomtest_check(t->latest.consumer.pending == OS_NULL &&
+        t->keep.consumer.pending == OS_NULL, "no frames left pending");
+    iocomtest_check(!t->latest.bad_brick && !t->keep.bad_brick,
+        "consumers got whole uncompressed bricks");
+
+    ioc_release_brick_hub(&t->hub);
+    iocomtest_release_brick_pair(&t->bp);
+    iocomtest_release_pair(&p);
+    os_free(t, sizeof(iocomTestHub));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Local consumer callback (internal).
+  @anchor iocomtest_hub_consume
+
+  @param   consumer Pointer to hub consumer.
+  @param   buf Brick, header and data.
+  @param   buf_sz Brick size in bytes.
+  @param   context Pointer to iocomTestHubConsumer.
+  @return  OSAL_PENDING if consumer is busy, otherwise OSAL_SUCCESS.
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_hub_consume(
+    iocBrickHubConsumer *consumer,
+    const os_uchar *buf,
+    os_memsz buf_sz,
+    void *context)
+{
+    iocomTestHubConsumer *c;
+    const iocBrickHdr *hdr;
+    OSAL_UNUSED(consumer);
+
+    c = (iocomTestHubConsumer*)context;
+    if (c->busy) return OSAL_PENDING;
+
+    hdr = (const iocBrickHdr*)buf;
+    if (buf_sz != (os_memsz)sizeof(iocBrickHdr) + IOCOMTEST_HUB_FRAME_SZ ||
+        hdr->compression != IOC_UNCOMPRESSED)
+    {
+        c->bad_brick = OS_TRUE;
+    }
+    c->last_value = buf[sizeof(iocBrickHdr)];
+    c->ndelivered++;
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run brick sender, move memory block data and run the hub once (internal).
+  @anchor iocomtest_hub_run
+
+  The hub runs controller's receiving brick buffer, so iocomtest_run_brick_pair() is not used.
+
+  @param   t Pointer to test state.
+  @param   p Pointer to test pair.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocomtest_hub_run(
+    iocomTestHub *t,
+    iocomTestPair *p)
+{
+    ioc_run_brick_send(&t->bp.send);
+    ioc_send_all(&p->device);
+    ioc_send_all(&p->controller);
+    iocomtest_run_pair(p);
+    ioc_receive_all(&p->device);
+    ioc_receive_all(&p->controller);
+    ioc_run_brick_hub(&t->hub);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run transfer, check if device is ready to send new brick (internal).
+  @anchor iocomtest_hub_ready
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestHub.
+  @return  OS_TRUE if sending brick buffer is connected and ready.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_hub_ready(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestHub *t;
+
+    t = (iocomTestHub*)context;
+    iocomtest_hub_run(t, p);
+    return (os_boolean)(ioc_ready_for_new_brick(&t->bp.send) &&
+        ioc_is_brick_connected(&t->bp.send));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run transfer, check if hub has received all bricks sent (internal).
+  @anchor iocomtest_hub_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestHub.
+  @return  OS_TRUE if hub's received count has reached bricks sent.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_hub_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestHub *t;
+
+    t = (iocomTestHub*)context;
+    iocomtest_hub_run(t, p);
+    return (os_boolean)(t->hub.received >= t->received);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run transfer, check if consumers have been called back enough times (internal).
+  @anchor iocomtest_hub_delivered
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestHub.
+  @return  OS_TRUE if both consumers have got expected number of bricks.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_hub_delivered(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestHub *t;
+
+    t = (iocomTestHub*)context;
+    iocomtest_hub_run(t, p);
+    return (os_boolean)(t->latest.ndelivered >= t->latest_delivered &&
+        t->keep.ndelivered >= t->keep_delivered);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Wait until device is ready, store brick and wait until the hub has received it
+         (internal).
+  @anchor iocomtest_hub_send
+
+  @param   t Pointer to test state.
+  @param   p Pointer to test pair.
+  @param   value Value for all pixels of the image.
+  @return  Return value of ioc_compress_brick(), OSAL_STATUS_TIMEOUT if the brick was not
+           transferred.
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_hub_send(
+    iocomTestHub *t,
+    iocomTestPair *p,
+    os_int value)
+{
+    iocBrickHdr hdr;
+    os_uchar image[IOCOMTEST_HUB_FRAME_SZ];
+    os_memsz alloc_sz;
+    os_int i;
+    osalStatus s;
+
+    if (!iocomtest_run_pair_until(p, iocomtest_hub_ready, t, IOCOMTEST_TIMEOUT_MS)) {
+        return OSAL_STATUS_TIMEOUT;
+    }
+
+    for (i = 0; i < IOCOMTEST_HUB_FRAME_SZ; i++) {
+        image[i] = (os_uchar)value;
+    }
+    alloc_sz = sizeof(iocBrickHdr) + IOCOMTEST_HUB_FRAME_SZ;
+    os_memclear(&hdr, sizeof(iocBrickHdr));
+    hdr.alloc_sz[0] = (os_uchar)alloc_sz;
+    hdr.alloc_sz[1] = (os_uchar)(alloc_sz >> 8);
+    s = ioc_compress_brick(&t->bp.send, &hdr, image, IOCOMTEST_HUB_FRAME_SZ,
+        OSAL_GRAYSCALE8, IOCOMTEST_HUB_W, IOCOMTEST_HUB_H, IOC_UNCOMPRESSED);
+    if (s) return s;
+
+    t->received++;
+    if (!iocomtest_run_pair_until(p, iocomtest_hub_received, t, IOCOMTEST_TIMEOUT_MS)) {
+        return OSAL_STATUS_TIMEOUT;
+    }
+    return OSAL_SUCCESS;
+}
+
+#else
+void iocomtest_hub(void) {}
+#endif
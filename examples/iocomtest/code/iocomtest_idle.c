@@ -0,0 +1,161 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_idle.c
+  @brief   Tests for waking up idle connection threads.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Idle connection thread waits without timeout when timer wheel has nothing due before keep
+  alive. Memory block created or deleted while connection is idle must wake the thread, so
+  that memory block info is sent at once, not with the next keep alive.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_TIMER_WHEEL && OSAL_MULTITHREAD_SUPPORT
+
+/* Time to let connections go idle after initial exchange and time within which a new memory
+   block must arrive, ms. Sum must be well below IOC_SOCKET_KEEPALIVE_MS.
+ */
+#define IOCOMTEST_IDLE_SETTLE_MS 1000
+#define IOCOMTEST_IDLE_ARRIVE_MS 2000
+
+/* Forward referred static functions.
+ */
+static osalStatus iocomtest_idle_connect(
+    iocomTestPair *p);
+
+static os_boolean iocomtest_idle_wait_int(
+    iocHandle *handle,
+    os_int value,
+    os_int timeout_ms);
+
+
+/**
+****************************************************************************************************
+
+  @brief Idle connection tests.
+  @anchor iocomtest_idle
+
+  Connections run in their own threads. Once the initial exchange is done and connections are
+  idle, device creates a new memory block. Its data must arrive at controller well before
+  keep alive would wake the connection thread.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_idle(void)
+{
+    iocomTestPair p;
+    iocHandle dbase, cbase, dlate, clate;
+
+    iocomtest_group("idle");
+    iocomtest_initialize_pair(&p, "idletest");
+    iocomtest_memory_block(&dbase, &p.device, "base", 32, IOC_MBLK_UP);
+    iocomtest_memory_block(&cbase, &p.controller, "base", 32, IOC_MBLK_UP);
+    iocomtest_memory_block(&clate, &p.controller, "late", 32, IOC_MBLK_UP);
+    iocomtest_check(iocomtest_idle_connect(&p) == OSAL_SUCCESS, "connect threaded loopback");
+
+    iocomtest_set_int(&dbase, 0, 11);
+    ioc_send(&dbase);
+    iocomtest_check(iocomtest_idle_wait_int(&cbase, 11, IOCOMTEST_TIMEOUT_MS),
+        "initial exchange");
+
+    /* Let connection threads go idle, then create memory block at device.
+     */
+    os_sleep(IOCOMTEST_IDLE_SETTLE_MS);
+    iocomtest_memory_block(&dlate, &p.device, "late", 32, IOC_MBLK_UP);
+    iocomtest_set_int(&dlate, 0, 22);
+    ioc_send(&dlate);
+    iocomtest_check(iocomtest_idle_wait_int(&clate, 22, IOCOMTEST_IDLE_ARRIVE_MS),
+        "new memory block arrives without waiting for keep alive");
+
+    /* Connection threads are terminated by releasing roots.
+     */
+    iocomtest_release_pair(&p);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Start listening and connecting with worker threads (internal).
+  @anchor iocomtest_idle_connect
+
+  Like iocomtest_connect_pair(), but end point and connection run in their own threads.
+  Connection and end point pointers are not stored in test pair: Threads are terminated and
+  objects released by ioc_release_root().
+
+  @param   p Pointer to test pair.
+  @return  OSAL_SUCCESS if successful, other values indicate an error.
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_idle_connect(
+    iocomTestPair *p)
+{
+    iocEndPointParams epprm;
+    iocConnectionParams conprm;
+    iocEndPoint *epoint;
+    iocConnection *con;
+    osalStatus s;
+
+    epoint = ioc_initialize_end_point(OS_NULL, &p->controller);
+    os_memclear(&epprm, sizeof(epprm));
+    epprm.iface = IOC_LOOPBACK_IFACE;
+    epprm.flags = IOC_SOCKET|IOC_CREATE_THREAD;
+    epprm.parameters = p->name;
+    s = ioc_listen(epoint, &epprm);
+    if (s) return s;
+
+    con = ioc_initialize_connection(OS_NULL, &p->device);
+    os_memclear(&conprm, sizeof(conprm));
+    conprm.iface = IOC_LOOPBACK_IFACE;
+    conprm.flags = IOC_SOCKET|IOC_CONNECT_UP|IOC_CREATE_THREAD;
+    conprm.parameters = p->name;
+    return ioc_connect(con, &conprm);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Wait until received integer at address 0 has expected value (internal).
+  @anchor iocomtest_idle_wait_int
+
+  Connection threads move the data, this function only polls received data.
+
+  @param   handle Memory block handle at controller.
+  @param   value Expected value.
+  @param   timeout_ms Maximum time to wait, ms.
+  @return  OS_TRUE if value was received within timeout.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_idle_wait_int(
+    iocHandle *handle,
+    os_int value,
+    os_int timeout_ms)
+{
+    os_timer start_t;
+
+    os_get_timer(&start_t);
+    while (!os_has_elapsed(&start_t, timeout_ms))
+    {
+        ioc_receive(handle);
+        if (iocomtest_get_int(handle, 0) == value) return OS_TRUE;
+        os_sleep(10);
+    }
+    return OS_FALSE;
+}
+
+#else
+void iocomtest_idle(void) {}
+#endif
@@ -0,0 +1,162 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_journal.c
+  @brief   Tests for memory block generation numbers and change journal.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_MBLK_GENERATIONS
+
+#define IOCOMTEST_JOURNAL_SZ 4
+#define IOCOMTEST_MAX_CHANGES 8
+
+/* Memory block handles for condition function.
+ */
+typedef struct iocomTestJournal
+{
+    iocHandle da, db;
+    iocHandle ca;
+}
+iocomTestJournal;
+
+/* Forward referred static functions.
+ */
+static os_boolean iocomtest_journal_received(
+    iocomTestPair *p,
+    void *context);
+
+
+/**
+****************************************************************************************************
+
+  @brief Generation number and change journal tests.
+  @anchor iocomtest_journal
+
+  Generation numbers are common to all memory blocks of a root, so generation seen in one
+  memory block can be used to ask if another has changed. Changes are merged into the latest
+  journal entry if adjacent, and whole memory block is reported when journal doesn't reach
+  back far enough or generation is unknown.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_journal(void)
+{
+    iocomTestPair p;
+    iocomTestJournal t;
+    iocMblkChange ch[IOCOMTEST_MAX_CHANGES];
+    os_uint g1, g2, g3, g4, gen;
+    os_int n;
+
+    iocomtest_group("journal");
+    os_memclear(&t, sizeof(t));
+
+    iocomtest_initialize_pair(&p, "journaltest");
+    iocomtest_memory_block(&t.da, &p.device, "a", 64, IOC_MBLK_UP);
+    iocomtest_memory_block(&t.db, &p.device, "b", 64, IOC_MBLK_UP);
+    iocomtest_memory_block(&t.ca, &p.controller, "a", 64, IOC_MBLK_UP);
+
+    iocomtest_check(ioc_mblk_get_generation(&t.da) == 0, "new memory block, generation zero");
+    iocomtest_check(ioc_mblk_get_changes(&t.da, 0, ch, IOCOMTEST_MAX_CHANGES, OS_NULL) == 0,
+        "new memory block, no changes");
+    iocomtest_check(ioc_mblk_enable_journal(&t.da, IOCOMTEST_JOURNAL_SZ) == OSAL_SUCCESS,
+        "enable journal");
+
+    /* Generation numbers are common to memory blocks of the root.
+     */
+    iocomtest_set_int(&t.da, 0, 1);
+    g1 = ioc_mblk_get_generation(&t.da);
+    iocomtest_set_int(&t.db, 0, 1);
+    g2 = ioc_mblk_get_generation(&t.db);
+    iocomtest_check(g1 != 0 && (os_int)(g2 - g1) > 0, "generation common to root");
+    iocomtest_check(ioc_mblk_get_changes(&t.da, g2, ch, IOCOMTEST_MAX_CHANGES, OS_NULL) == 0,
+        "not changed since other memory block's generation");
+    n = ioc_mblk_get_changes(&t.db, g1, ch, IOCOMTEST_MAX_CHANGES, OS_NULL);
+    iocomtest_check(n == 1 && ch[0].start_addr == 0 && ch[0].end_addr == 63,
+        "no journal, whole memory block");
+
+    /* Adjacent change is merged, separate one is a new entry.
+     */
+    iocomtest_set_int(&t.da, 4, 2);
+    g3 = ioc_mblk_get_generation(&t.da);
+    iocomtest_set_int(&t.da, 20, 3);
+    g4 = ioc_mblk_get_generation(&t.da);
+    n = ioc_mblk_get_changes(&t.da, 0, ch, IOCOMTEST_MAX_CHANGES, &gen);
+    iocomtest_check(n == 2 && ch[0].start_addr == 0 && ch[0].end_addr == 7 &&
+        ch[1].start_addr == 20 && ch[1].end_addr == 23, "adjacent changes merged");
+    iocomtest_check(gen == g4, "current generation returned");
+    n = ioc_mblk_get_changes(&t.da, g3, ch, IOCOMTEST_MAX_CHANGES, OS_NULL);
+    iocomtest_check(n == 1 && ch[0].start_addr == 20 && ch[0].end_addr == 23,
+        "only changes after generation");
+    n = ioc_mblk_get_changes(&t.da, 0, ch, 1, OS_NULL);
+    iocomtest_check(n == 1 && ch[0].start_addr == 0 && ch[0].end_addr == 23,
+        "ranges which don't fit merged into one");
+
+    /* Journal overflow drops the oldest entries.
+     */
+    iocomtest_set_int(&t.da, 32, 4);
+    iocomtest_set_int(&t.da, 40, 5);
+    iocomtest_set_int(&t.da, 48, 6);
+    iocomtest_set_int(&t.da, 56, 7);
+    n = ioc_mblk_get_changes(&t.da, g3, ch, IOCOMTEST_MAX_CHANGES, &gen);
+    iocomtest_check(n == 1 && ch[0].start_addr == 0 && ch[0].end_addr == 63,
+        "journal overflow, whole memory block");
+    n = ioc_mblk_get_changes(&t.da, g4, ch, IOCOMTEST_MAX_CHANGES, OS_NULL);
+    iocomtest_check(n == IOCOMTEST_JOURNAL_SZ && ch[0].start_addr == 32 &&
+        ch[IOCOMTEST_JOURNAL_SZ - 1].end_addr == 59, "journal keeps the latest changes");
+    n = ioc_mblk_get_changes(&t.da, gen + 100, ch, IOCOMTEST_MAX_CHANGES, OS_NULL);
+    iocomtest_check(n == 1 && ch[0].start_addr == 0 && ch[0].end_addr == 63,
+        "unknown generation, whole memory block");
+
+    /* Received data is recorded as change.
+     */
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_journal_received, &t,
+        IOCOMTEST_TIMEOUT_MS), "data received");
+    iocomtest_check(ioc_mblk_get_generation(&t.ca) != 0, "received data updates generation");
+
+    ioc_release_handle(&t.da);
+    ioc_release_handle(&t.db);
+    ioc_release_handle(&t.ca);
+    iocomtest_release_pair(&p);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Send device's memory block and check if controller has received it (internal).
+  @anchor iocomtest_journal_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestJournal.
+  @return  OS_TRUE if controller has received the value written last.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_journal_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestJournal *t;
+    OSAL_UNUSED(p);
+
+    t = (iocomTestJournal*)context;
+    ioc_send(&t->da);
+    ioc_receive(&t->ca);
+    return (os_boolean)(iocomtest_get_int(&t->ca, 56) == 7);
+}
+
+#else
+void iocomtest_journal(void) {}
+#endif
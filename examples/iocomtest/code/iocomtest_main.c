@@ -0,0 +1,77 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_main.c
+  @brief   Unit and loopback tests for iocom library.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+
+/* If needed for the operating system, EOSAL_C_MAIN macro generates the actual C main() function.
+ */
+EOSAL_C_MAIN
+
+
+/**
+****************************************************************************************************
+
+  @brief Process entry point.
+
+  The osal_main() function runs all test groups once and prints the summary.
+
+  @param   argc Number of command line arguments.
+  @param   argv Array of string pointers, one for each command line argument. UTF8 encoded.
+
+  @return  OSAL_SUCCESS if all checks passed, OSAL_STATUS_FAILED otherwise.
+
+****************************************************************************************************
+*/
+osalStatus osal_main(
+    os_int argc,
+    os_char *argv[])
+{
+    OSAL_UNUSED(argc);
+    OSAL_UNUSED(argv);
+
+    iocomtest_compress();
+    iocomtest_auth();
+    iocomtest_flow_control();
+    iocomtest_resume();
+    iocomtest_journal();
+    iocomtest_events();
+    iocomtest_mmap();
+    iocomtest_coalesce();
+    iocomtest_sampler();
+    iocomtest_tiles();
+    iocomtest_hub();
+    iocomtest_idle();
+
+    return iocomtest_summary();
+}
+
+
+/*  Empty function implementation needed to build for microcontroller.
+ */
+osalStatus osal_loop(
+    void *app_context)
+{
+    OSAL_UNUSED(app_context);
+    return OSAL_SUCCESS;
+}
+
+
+/*  Empty function implementation needed to build for microcontroller.
+ */
+void osal_main_cleanup(
+    void *app_context)
+{
+    OSAL_UNUSED(app_context);
+}
@@ -0,0 +1,166 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_mmap.c
+  @brief   Tests for memory blocks backed by memory mapped files.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Write back mapping creates the file, data written to memory block is in the file and
+  forced synchronization marks the memory block synced. Read only mapping of the same file
+  shows the data, is not writable and needs a static memory block and a long enough file.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_MBLK_MMAP
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* File to map, in working directory. Removed before and after the test.
+ */
+#define IOCOMTEST_MMAP_FILE "iocomtest_mmap.mblk"
+#define IOCOMTEST_MMAP_SZ 64
+
+/* Forward referred static functions.
+ */
+static os_int iocomtest_mmap_file_int(
+    os_int addr);
+
+static os_boolean iocomtest_mmap_is_writable(
+    os_char *addr);
+
+
+/**
+****************************************************************************************************
+
+  @brief Memory mapped memory block tests.
+  @anchor iocomtest_mmap
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_mmap(void)
+{
+    iocRoot root;
+    iocHandle h;
+    iocMemoryBlock *mblk;
+    struct stat st;
+    os_boolean ok;
+
+    iocomtest_group("mmap");
+    unlink(IOCOMTEST_MMAP_FILE);
+    ioc_initialize_root(&root, IOC_CREATE_OWN_MUTEX);
+
+    /* Write back mapping creates the file at memory block size.
+     */
+    iocomtest_memory_block(&h, &root, "mm", IOCOMTEST_MMAP_SZ, IOC_MBLK_UP);
+    iocomtest_check(ioc_mmap_mblk(&h, IOCOMTEST_MMAP_FILE, IOC_MMAP_WRITE_BACK) == OSAL_SUCCESS,
+        "write back mapping");
+    iocomtest_check(stat(IOCOMTEST_MMAP_FILE, &st) == 0 && st.st_size == IOCOMTEST_MMAP_SZ,
+        "file created at memory block size");
+
+    /* Data written to memory block is in the file, forced sync catches up generation.
+     */
+    iocomtest_set_int(&h, 8, 1234);
+    iocomtest_check(iocomtest_mmap_file_int(8) == 1234, "write goes to file");
+    ioc_lock(&root);
+    mblk = h.mblk;
+    ok = (os_boolean)(mblk->mmap->synced_generation != mblk->generation);
+    ioc_sync_mmapped_mblks(&root, OS_TRUE);
+    ok &= (os_boolean)(mblk->mmap->synced_generation == mblk->generation);
+    ioc_unlock(&root);
+    iocomtest_check(ok, "changed memory block synced to disk");
+    ioc_release_memory_block(&h);
+
+    /* Read only mapping needs static memory block.
+     */
+    iocomtest_memory_block(&h, &root, "ro", IOCOMTEST_MMAP_SZ, IOC_MBLK_UP);
+    iocomtest_check(ioc_mmap_mblk(&h, IOCOMTEST_MMAP_FILE, IOC_MMAP_READ_ONLY) ==
+        OSAL_STATUS_FAILED, "read only mapping of non static memory block refused");
+    ioc_release_memory_block(&h);
+
+    /* Read only mapping shows the data and can't be written.
+     */
+    iocomtest_memory_block(&h, &root, "ro", IOCOMTEST_MMAP_SZ, IOC_MBLK_UP|IOC_STATIC);
+    iocomtest_check(ioc_mmap_mblk(&h, IOCOMTEST_MMAP_FILE, IOC_MMAP_READ_ONLY) == OSAL_SUCCESS,
+        "read only mapping");
+    iocomtest_check(iocomtest_get_int(&h, 8) == 1234, "read only mapping has file data");
+    iocomtest_check(!iocomtest_mmap_is_writable(h.mblk->buf), "read only mapping not writable");
+    ioc_release_memory_block(&h);
+
+    /* File shorter than memory block.
+     */
+    iocomtest_memory_block(&h, &root, "big", 2 * IOCOMTEST_MMAP_SZ, IOC_MBLK_UP|IOC_STATIC);
+    iocomtest_check(ioc_mmap_mblk(&h, IOCOMTEST_MMAP_FILE, IOC_MMAP_READ_ONLY) ==
+        OSAL_STATUS_READING_FILE_FAILED, "read only mapping of too short file refused");
+    ioc_release_memory_block(&h);
+
+    ioc_release_root(&root);
+    unlink(IOCOMTEST_MMAP_FILE);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Read integer from the mapped file, not through the mapping (internal).
+  @anchor iocomtest_mmap_file_int
+
+  @param   addr Position in file.
+  @return  Value read, -1 if it could not be read.
+
+****************************************************************************************************
+*/
+static os_int iocomtest_mmap_file_int(
+    os_int addr)
+{
+    os_int fd, value;
+
+    value = -1;
+    fd = open(IOCOMTEST_MMAP_FILE, O_RDONLY);
+    if (fd < 0) return value;
+    if (pread(fd, &value, sizeof(value), addr) != sizeof(value)) value = -1;
+    close(fd);
+    return value;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check if memory can be written without touching it (internal).
+  @anchor iocomtest_mmap_is_writable
+
+  Kernel reads one byte from /dev/zero into the address. This fails with EFAULT, instead of
+  crashing the process, if the page is not writable.
+
+  @param   addr Address to check.
+  @return  OS_TRUE if memory at address is writable.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_mmap_is_writable(
+    os_char *addr)
+{
+    os_int fd;
+    os_boolean writable;
+
+    fd = open("/dev/zero", O_RDONLY);
+    if (fd < 0) return OS_TRUE;
+    writable = (os_boolean)(read(fd, addr, 1) == 1);
+    close(fd);
+    return writable;
+}
+
+#else
+void iocomtest_mmap(void) {}
+#endif
@@ -0,0 +1,115 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_resume.c
+  @brief   Tests for skipping memory block information exchange on reconnect.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_MBINFO_RESUME
+
+/* Device's and controller's memory block handles and value written for condition function.
+ */
+typedef struct iocomTestResume
+{
+    iocHandle dexp, cexp;
+    iocHandle dimp, cimp;
+    os_int value;
+}
+iocomTestResume;
+
+/* Forward referred static functions.
+ */
+static os_boolean iocomtest_resume_value_received(
+    iocomTestPair *p,
+    void *context);
+
+
+/**
+****************************************************************************************************
+
+  @brief Memory block information resume tests.
+  @anchor iocomtest_resume
+
+  First connection stores device's memory block information in controller's cache. After
+  reconnect the cached information must be used, and data must still flow both ways.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_resume(void)
+{
+    iocomTestPair p;
+    iocomTestResume r;
+
+    iocomtest_group("resume");
+    os_memclear(&r, sizeof(r));
+
+    iocomtest_initialize_pair(&p, "resumetest");
+    iocomtest_memory_block(&r.dexp, &p.device, "exp", 64, IOC_MBLK_UP);
+    iocomtest_memory_block(&r.cexp, &p.controller, "exp", 64, IOC_MBLK_UP);
+    iocomtest_memory_block(&r.dimp, &p.device, "imp", 64, IOC_MBLK_DOWN);
+    iocomtest_memory_block(&r.cimp, &p.controller, "imp", 64, IOC_MBLK_DOWN);
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+
+    r.value = 101;
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_resume_value_received, &r,
+        IOCOMTEST_TIMEOUT_MS), "data on first connection");
+    iocomtest_check(p.controller.mbinfo_cache.hits == 0, "first connection not from cache");
+
+    iocomtest_check(iocomtest_reconnect_pair(&p) == OSAL_SUCCESS, "reconnect");
+    r.value = 202;
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_resume_value_received, &r,
+        IOCOMTEST_TIMEOUT_MS), "data after reconnect");
+    iocomtest_check(p.controller.mbinfo_cache.hits == 1, "reconnect used cached information");
+
+    ioc_release_handle(&r.dexp);
+    ioc_release_handle(&r.cexp);
+    ioc_release_handle(&r.dimp);
+    ioc_release_handle(&r.cimp);
+    iocomtest_release_pair(&p);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write value at both ends and check if it is received at the other end (internal).
+  @anchor iocomtest_resume_value_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestResume.
+  @return  OS_TRUE if both device and controller have received the value.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_resume_value_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestResume *r;
+    OSAL_UNUSED(p);
+
+    r = (iocomTestResume*)context;
+    iocomtest_set_int(&r->dexp, 0, r->value);
+    iocomtest_set_int(&r->cimp, 0, r->value);
+    ioc_send(&r->dexp);
+    ioc_send(&r->cimp);
+    ioc_receive(&r->cexp);
+    ioc_receive(&r->dimp);
+    return (os_boolean)(iocomtest_get_int(&r->cexp, 0) == r->value &&
+        iocomtest_get_int(&r->dimp, 0) == r->value);
+}
+
+#else
+void iocomtest_resume(void) {}
+#endif
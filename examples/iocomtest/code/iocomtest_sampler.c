@@ -0,0 +1,294 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_sampler.c
+  @brief   Tests for lossless sample history over brick transfer.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_SAMPLER_SUPPORT
+
+/* Ring size and number of samples which fit into one brick in the flat buffer.
+ */
+#define IOCOMTEST_MAX_SAMPLES 64
+#define IOCOMTEST_BATCH 16
+
+/* Sample data size, one integer.
+ */
+#define IOCOMTEST_SAMPLE_SZ ((os_int)sizeof(os_int))
+
+/* Maximum number of samples to collect at receiving end.
+ */
+#define IOCOMTEST_MAX_RECEIVED 128
+
+/* Sampler, brick pair and samples collected by brick received callback.
+ */
+typedef struct iocomTestSampler
+{
+    iocomTestBrickPair bp;
+    iocSampler sampler;
+
+    os_int values[IOCOMTEST_MAX_RECEIVED];
+    os_int64 tstamps[IOCOMTEST_MAX_RECEIVED];
+    os_int nreceived;
+    os_int nbricks;
+    os_boolean bad_brick;
+
+    /** Set to send an uncompressed image brick shaped like a sample batch.
+     */
+    os_boolean send_image;
+
+    /** Number of samples to wait for.
+     */
+    os_int expected;
+}
+iocomTestSampler;
+
+/* Forward referred static functions.
+ */
+static osalStatus iocomtest_sampler_received(
+    struct iocBrickBuffer *b,
+    void *context);
+
+static os_boolean iocomtest_samples_received(
+    iocomTestPair *p,
+    void *context);
+
+static os_boolean iocomtest_sampler_image_received(
+    iocomTestPair *p,
+    void *context);
+
+static os_boolean iocomtest_samples_in_order(
+    iocomTestSampler *t,
+    os_int first_value);
+
+
+/**
+****************************************************************************************************
+
+  @brief Sampler tests.
+  @anchor iocomtest_sampler
+
+  Every sample added must arrive once, in order and with its time stamp, batched into bricks
+  no larger than the flat buffer. When the ring is full, new samples are dropped and
+  counted, older ones are kept. Uncompressed grayscale image is not taken as sample batch.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_sampler(void)
+{
+    iocomTestPair p;
+    iocomTestSampler *t;
+    iocSamplerStats stats;
+    os_int i, ndropped;
+
+    iocomtest_group("sampler");
+    t = (iocomTestSampler*)os_malloc(sizeof(iocomTestSampler), OS_NULL);
+    if (t == OS_NULL) return;
+    os_memclear(t, sizeof(iocomTestSampler));
+
+    iocomtest_initialize_pair(&p, "samplertest");
+    iocomtest_setup_brick_pair(&t->bp, &p, (os_int)sizeof(iocBrickHdr) +
+        IOCOMTEST_BATCH * (IOCOMTEST_SAMPLE_SZ + IOC_SAMPLE_TSTAMP_SZ));
+    ioc_set_brick_received_callback(&t->bp.receive, iocomtest_sampler_received, t);
+    iocomtest_check(ioc_initialize_sampler(&t->sampler, &t->bp.send, IOCOMTEST_SAMPLE_SZ,
+        IOCOMTEST_MAX_SAMPLES) == OSAL_SUCCESS, "initialize sampler");
+    iocomtest_check(t->sampler.max_batch == IOCOMTEST_BATCH, "batch limited by flat buffer");
+
+    /* Few samples, one brick.
+     */
+    for (i = 1; i <= 10; i++)
+    {
+        ioc_add_sample(&t->sampler, (const os_char*)&i, 1000 * (os_int64)i);
+    }
+    t->expected = 10;
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_samples_received, t,
+        IOCOMTEST_TIMEOUT_MS), "samples received");
+    iocomtest_check(iocomtest_samples_in_order(t, 1), "samples in order with time stamps");
+
+    /* Ring full: newest samples are dropped, others sent in several bricks.
+     */
+    ndropped = 0;
+    for (i = 11; i <= 10 + IOCOMTEST_MAX_SAMPLES + 6; i++)
+    {
+        if (ioc_add_sample(&t->sampler, (const os_char*)&i, 1000 * (os_int64)i)) ndropped++;
+    }
+    iocomtest_check(ndropped == 6, "samples dropped when ring is full");
+    t->nreceived = 0;
+    t->nbricks = 0;
+    t->expected = IOCOMTEST_MAX_SAMPLES;
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_samples_received, t,
+        IOCOMTEST_TIMEOUT_MS), "full ring received");
+    iocomtest_check(iocomtest_samples_in_order(t, 11), "oldest samples kept");
+    iocomtest_check(t->nbricks >= IOCOMTEST_MAX_SAMPLES / IOCOMTEST_BATCH,
+        "samples split into several bricks");
+    iocomtest_check(!t->bad_brick, "all bricks are sample batches");
+
+    /* Image brick with the same format and shape as a sample batch.
+     */
+    t->send_image = OS_TRUE;
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_sampler_image_received, t,
+        IOCOMTEST_TIMEOUT_MS), "uncompressed image is not sample batch");
+
+    ioc_get_sampler_stats(&t->sampler, &stats);
+    iocomtest_check(stats.samples == 10 + IOCOMTEST_MAX_SAMPLES + 6 && stats.dropped == 6 &&
+        stats.sent_samples == 10 + IOCOMTEST_MAX_SAMPLES, "sampler statistics");
+
+    ioc_release_sampler(&t->sampler);
+    iocomtest_release_brick_pair(&t->bp);
+    iocomtest_release_pair(&p);
+    os_free(t, sizeof(iocomTestSampler));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick received callback, collect samples (internal).
+  @anchor iocomtest_sampler_received
+
+  @param   b Pointer to receiving brick buffer.
+  @param   context Pointer to iocomTestSampler.
+  @return  OSAL_SUCCESS.
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_sampler_received(
+    struct iocBrickBuffer *b,
+    void *context)
+{
+    iocomTestSampler *t;
+    const os_char *data;
+    os_int n, i, sample_sz;
+
+    t = (iocomTestSampler*)context;
+    n = ioc_get_brick_samples(b, &sample_sz);
+    if (n == 0 || sample_sz != IOCOMTEST_SAMPLE_SZ)
+    {
+        t->bad_brick = OS_TRUE;
+        return OSAL_SUCCESS;
+    }
+    t->nbricks++;
+
+    for (i = 0; i < n && t->nreceived < IOCOMTEST_MAX_RECEIVED; i++)
+    {
+        data = ioc_get_brick_sample(b, i, t->tstamps + t->nreceived);
+        if (data == OS_NULL) break;
+        os_memcpy(t->values + t->nreceived, data, IOCOMTEST_SAMPLE_SZ);
+        t->nreceived++;
+    }
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run sampler and brick transfer, check if expected samples are received (internal).
+  @anchor iocomtest_samples_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestSampler.
+  @return  OS_TRUE if expected number of samples has been received.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_samples_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestSampler *t;
+
+    t = (iocomTestSampler*)context;
+    ioc_run_sampler(&t->sampler);
+    iocomtest_run_brick_pair(&t->bp, p);
+    return (os_boolean)(t->nreceived >= t->expected);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Send uncompressed image brick, check that it is not read as samples (internal).
+  @anchor iocomtest_sampler_image_received
+
+  Image is OSAL_GRAYSCALE8 with sample record width, like a sample batch, but not marked
+  as one (IOC_UNCOMPRESSED).
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestSampler.
+  @return  OS_TRUE once the image has been received and rejected by ioc_get_brick_samples().
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_sampler_image_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestSampler *t;
+    iocBrickHdr hdr;
+    os_uchar image[2 * (IOCOMTEST_SAMPLE_SZ + IOC_SAMPLE_TSTAMP_SZ)];
+    os_memsz alloc_sz;
+
+    t = (iocomTestSampler*)context;
+    if (t->send_image && ioc_ready_for_new_brick(&t->bp.send))
+    {
+        alloc_sz = sizeof(iocBrickHdr) + sizeof(image);
+        os_memclear(&hdr, sizeof(iocBrickHdr));
+        hdr.alloc_sz[0] = (os_uchar)alloc_sz;
+        hdr.alloc_sz[1] = (os_uchar)(alloc_sz >> 8);
+        hdr.alloc_sz[2] = (os_uchar)(alloc_sz >> 16);
+        hdr.alloc_sz[3] = (os_uchar)(alloc_sz >> 24);
+        os_memclear(image, sizeof(image));
+        if (ioc_compress_brick(&t->bp.send, &hdr, image, sizeof(image), OSAL_GRAYSCALE8,
+            IOCOMTEST_SAMPLE_SZ + IOC_SAMPLE_TSTAMP_SZ, 2, IOC_UNCOMPRESSED) == OSAL_SUCCESS)
+        {
+            t->send_image = OS_FALSE;
+        }
+    }
+    iocomtest_run_brick_pair(&t->bp, p);
+    return t->bad_brick;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Check that received samples are consecutive values with matching time stamps (internal).
+  @anchor iocomtest_samples_in_order
+
+  @param   t Pointer to test state.
+  @param   first_value Value of the first sample expected.
+  @return  OS_TRUE if exactly the expected samples were received in order.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_samples_in_order(
+    iocomTestSampler *t,
+    os_int first_value)
+{
+    os_int i;
+
+    if (t->nreceived != t->expected) return OS_FALSE;
+    for (i = 0; i < t->nreceived; i++)
+    {
+        if (t->values[i] != first_value + i) return OS_FALSE;
+        if (t->tstamps[i] != 1000 * (os_int64)(first_value + i)) return OS_FALSE;
+    }
+    return OS_TRUE;
+}
+
+#else
+void iocomtest_sampler(void) {}
+#endif
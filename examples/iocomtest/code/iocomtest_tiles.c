@@ -0,0 +1,356 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_tiles.c
+  @brief   Tests for tiled brick transfer and frame assembly.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+#if IOC_BRICK_TILES_SUPPORT
+
+/* Grayscale test image, 4 x 2 tiles.
+ */
+#define IOCOMTEST_TILES_W 64
+#define IOCOMTEST_TILES_H 32
+#define IOCOMTEST_TILE_SZ 16
+#define IOCOMTEST_FRAME_SZ (IOCOMTEST_TILES_W * IOCOMTEST_TILES_H)
+
+/* Brick pair, tiled sender, image to send and last frame passed to brick received callback.
+ */
+typedef struct iocomTestTiles
+{
+    iocomTestBrickPair bp;
+    iocBrickTiles tiles;
+
+    os_uchar image[IOCOMTEST_FRAME_SZ];
+    os_uchar received[IOCOMTEST_FRAME_SZ];
+    os_int nreceived;
+    os_boolean bad_frame;
+
+    /** Number of frames received when last brick was stored.
+     */
+    os_int nreceived_at_send;
+}
+iocomTestTiles;
+
+/* Forward referred static functions.
+ */
+static osalStatus iocomtest_tiles_received(
+    struct iocBrickBuffer *b,
+    void *context);
+
+static os_boolean iocomtest_tiles_ready(
+    iocomTestPair *p,
+    void *context);
+
+static os_boolean iocomtest_tiles_frame_received(
+    iocomTestPair *p,
+    void *context);
+
+static os_boolean iocomtest_tiles_keyframe_requested(
+    iocomTestPair *p,
+    void *context);
+
+static osalStatus iocomtest_tiles_send(
+    iocomTestTiles *t,
+    iocomTestPair *p,
+    os_boolean tiled);
+
+static void iocomtest_tiles_change(
+    iocomTestTiles *t,
+    os_int col,
+    os_int row);
+
+
+/**
+****************************************************************************************************
+
+  @brief Tiled brick tests.
+  @anchor iocomtest_tiles
+
+  Receiver must pass full frames assembled from changed tiles. Tiles which arrive without
+  a key frame below them must not be drawn, the receiver asks the sender for a key frame
+  instead. Uncompressed full frame is a valid base for tiles.
+
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_tiles(void)
+{
+    iocomTestPair p;
+    iocomTestTiles *t;
+    os_int i, n;
+
+    iocomtest_group("tiles");
+    t = (iocomTestTiles*)os_malloc(sizeof(iocomTestTiles), OS_NULL);
+    if (t == OS_NULL) return;
+    os_memclear(t, sizeof(iocomTestTiles));
+    for (i = 0; i < IOCOMTEST_FRAME_SZ; i++) {
+        t->image[i] = (os_uchar)(i % IOCOMTEST_TILES_W + i / IOCOMTEST_TILES_W);
+    }
+
+    iocomtest_initialize_pair(&p, "tilestest");
+    iocomtest_setup_brick_pair(&t->bp, &p,
+        (os_int)sizeof(iocBrickHdr) + IOCOMTEST_FRAME_SZ + 64);
+    ioc_set_brick_received_callback(&t->bp.receive, iocomtest_tiles_received, t);
+    ioc_initialize_brick_tiles(&t->tiles, &t->bp.send, IOCOMTEST_TILE_SZ, IOCOMTEST_TILE_SZ);
+    t->tiles.keyframe_ms = 0;
+    iocomtest_check(iocomtest_connect_pair(&p) == OSAL_SUCCESS, "connect loopback");
+
+    /* First frame is key frame. All tiles uncompressed do not fit into the brick, so it
+       is sent as full frame.
+     */
+    iocomtest_check(iocomtest_tiles_send(t, &p, OS_TRUE) == OSAL_SUCCESS, "key frame stored");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_tiles_frame_received, t,
+        IOCOMTEST_TIMEOUT_MS), "key frame received");
+    iocomtest_check(!os_memcmp(t->received, t->image, IOCOMTEST_FRAME_SZ), "key frame matches");
+
+    /* One changed tile is sent and drawn over assembled frame.
+     */
+    n = t->tiles.tiles_sent;
+    iocomtest_tiles_change(t, 1, 0);
+    iocomtest_check(iocomtest_tiles_send(t, &p, OS_TRUE) == OSAL_SUCCESS, "changed tile stored");
+    iocomtest_check(t->tiles.tiles_sent == n + 1, "only changed tile sent");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_tiles_frame_received, t,
+        IOCOMTEST_TIMEOUT_MS), "tiled brick received");
+    iocomtest_check(!os_memcmp(t->received, t->image, IOCOMTEST_FRAME_SZ),
+        "assembled frame matches");
+
+    /* Receiver lost its assembled frame: tiles are dropped and key frame requested.
+     */
+    ioc_free_brick_tiles_frame(&t->bp.receive);
+    n = t->nreceived;
+    iocomtest_tiles_change(t, 2, 1);
+    iocomtest_check(iocomtest_tiles_send(t, &p, OS_TRUE) == OSAL_SUCCESS, "tile without base");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_tiles_keyframe_requested, t,
+        IOCOMTEST_TIMEOUT_MS), "key frame requested by negative acknowledge");
+    iocomtest_check(t->nreceived == n, "tiles without key frame not passed");
+    iocomtest_check(t->bp.receive.tile_frame == OS_NULL, "tiles without key frame not drawn");
+
+    /* The request makes unchanged image to be sent as key frame.
+     */
+    n = t->tiles.tiles_sent;
+    iocomtest_check(iocomtest_tiles_send(t, &p, OS_TRUE) == OSAL_SUCCESS,
+        "requested key frame stored");
+    iocomtest_check(!t->bp.send.tile_keyframe_request, "key frame request consumed");
+    iocomtest_check(t->tiles.tiles_sent == n + t->tiles.cols * t->tiles.rows,
+        "all tiles sent");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_tiles_frame_received, t,
+        IOCOMTEST_TIMEOUT_MS), "requested key frame received");
+    iocomtest_check(!os_memcmp(t->received, t->image, IOCOMTEST_FRAME_SZ),
+        "frame after key frame request matches");
+
+    /* Uncompressed full frame becomes assembled frame, also when there is none.
+     */
+    ioc_free_brick_tiles_frame(&t->bp.receive);
+    iocomtest_check(iocomtest_tiles_send(t, &p, OS_FALSE) == OSAL_SUCCESS, "full frame stored");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_tiles_frame_received, t,
+        IOCOMTEST_TIMEOUT_MS), "full frame received");
+    iocomtest_check(t->bp.receive.tile_frame != OS_NULL, "full frame assembled");
+    iocomtest_tiles_change(t, 0, 1);
+    iocomtest_check(iocomtest_tiles_send(t, &p, OS_TRUE) == OSAL_SUCCESS,
+        "tile over full frame stored");
+    iocomtest_check(iocomtest_run_pair_until(&p, iocomtest_tiles_frame_received, t,
+        IOCOMTEST_TIMEOUT_MS), "tile over full frame received");
+    iocomtest_check(!os_memcmp(t->received, t->image, IOCOMTEST_FRAME_SZ),
+        "tile drawn over full frame");
+    iocomtest_check(!t->bad_frame, "all received frames are full uncompressed frames");
+
+    ioc_release_brick_tiles(&t->tiles);
+    iocomtest_release_brick_pair(&t->bp);
+    iocomtest_release_pair(&p);
+    os_free(t, sizeof(iocomTestTiles));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Brick received callback, save received frame (internal).
+  @anchor iocomtest_tiles_received
+
+  @param   b Pointer to receiving brick buffer.
+  @param   context Pointer to iocomTestTiles.
+  @return  OSAL_SUCCESS.
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_tiles_received(
+    struct iocBrickBuffer *b,
+    void *context)
+{
+    iocomTestTiles *t;
+    iocBrickHdr *hdr;
+
+    t = (iocomTestTiles*)context;
+    hdr = (iocBrickHdr*)b->buf;
+    if (b->buf_sz != (os_memsz)sizeof(iocBrickHdr) + IOCOMTEST_FRAME_SZ ||
+        hdr->compression != IOC_UNCOMPRESSED)
+    {
+        t->bad_frame = OS_TRUE;
+        return OSAL_SUCCESS;
+    }
+    os_memcpy(t->received, b->buf + sizeof(iocBrickHdr), IOCOMTEST_FRAME_SZ);
+    t->nreceived++;
+    return OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run brick transfer, check if sender is ready for new brick (internal).
+  @anchor iocomtest_tiles_ready
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestTiles.
+  @return  OS_TRUE if sender is connected and ready.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_tiles_ready(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestTiles *t;
+
+    t = (iocomTestTiles*)context;
+    ioc_run_brick_send(&t->bp.send);
+    iocomtest_run_brick_pair(&t->bp, p);
+    return (os_boolean)(ioc_ready_for_new_brick(&t->bp.send) &&
+        ioc_is_brick_connected(&t->bp.send));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run brick transfer, check if a new frame has been received (internal).
+  @anchor iocomtest_tiles_frame_received
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestTiles.
+  @return  OS_TRUE if brick received callback has been called.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_tiles_frame_received(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestTiles *t;
+
+    t = (iocomTestTiles*)context;
+    iocomtest_tiles_ready(p, context);
+    return (os_boolean)(t->nreceived > t->nreceived_at_send);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run brick transfer, check if sender has got key frame request (internal).
+  @anchor iocomtest_tiles_keyframe_requested
+
+  @param   p Pointer to test pair.
+  @param   context Pointer to iocomTestTiles.
+  @return  OS_TRUE if sending brick buffer has key frame request.
+
+****************************************************************************************************
+*/
+static os_boolean iocomtest_tiles_keyframe_requested(
+    iocomTestPair *p,
+    void *context)
+{
+    iocomTestTiles *t;
+
+    t = (iocomTestTiles*)context;
+    iocomtest_tiles_ready(p, context);
+    return t->bp.send.tile_keyframe_request;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Wait until sender is ready and store the image (internal).
+  @anchor iocomtest_tiles_send
+
+  @param   t Pointer to test state.
+  @param   p Pointer to test pair.
+  @param   tiled OS_TRUE to send changed tiles, OS_FALSE to send uncompressed full frame.
+  @return  Return value of ioc_compress_brick_tiles() or ioc_compress_brick(),
+           OSAL_STATUS_TIMEOUT if sender did not get ready.
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_tiles_send(
+    iocomTestTiles *t,
+    iocomTestPair *p,
+    os_boolean tiled)
+{
+    iocBrickHdr hdr;
+    os_memsz alloc_sz;
+
+    if (!iocomtest_run_pair_until(p, iocomtest_tiles_ready, t, IOCOMTEST_TIMEOUT_MS)) {
+        return OSAL_STATUS_TIMEOUT;
+    }
+
+    t->nreceived_at_send = t->nreceived;
+    alloc_sz = sizeof(iocBrickHdr) + IOCOMTEST_FRAME_SZ;
+    os_memclear(&hdr, sizeof(iocBrickHdr));
+    hdr.alloc_sz[0] = (os_uchar)alloc_sz;
+    hdr.alloc_sz[1] = (os_uchar)(alloc_sz >> 8);
+
+    if (tiled) {
+        return ioc_compress_brick_tiles(&t->tiles, &hdr, t->image, IOCOMTEST_FRAME_SZ,
+            OSAL_GRAYSCALE8, IOCOMTEST_TILES_W, IOCOMTEST_TILES_H, IOC_UNCOMPRESSED);
+    }
+    return ioc_compress_brick(&t->bp.send, &hdr, t->image, IOCOMTEST_FRAME_SZ,
+        OSAL_GRAYSCALE8, IOCOMTEST_TILES_W, IOCOMTEST_TILES_H, IOC_UNCOMPRESSED);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Change all pixels of one tile in test image (internal).
+  @anchor iocomtest_tiles_change
+
+  @param   t Pointer to test state.
+  @param   col Tile column.
+  @param   row Tile row.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocomtest_tiles_change(
+    iocomTestTiles *t,
+    os_int col,
+    os_int row)
+{
+    os_uchar *px;
+    os_int x, y;
+
+    for (y = 0; y < IOCOMTEST_TILE_SZ; y++)
+    {
+        px = t->image + (row * IOCOMTEST_TILE_SZ + y) * IOCOMTEST_TILES_W
+            + col * IOCOMTEST_TILE_SZ;
+        for (x = 0; x < IOCOMTEST_TILE_SZ; x++) {
+            px[x] += 100;
+        }
+    }
+}
+
+#else
+void iocomtest_tiles(void) {}
+#endif
@@ -0,0 +1,613 @@
+/**
+
+  @file    iocom/examples/iocomtest/code/iocomtest_util.c
+  @brief   Test framework: checks, summary and loopback connected root pair.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocomtest.h"
+
+/* Number of checks done and failed.
+ */
+static os_int iocomtest_nro_checks;
+static os_int iocomtest_nro_failed;
+
+/* Forward referred static functions.
+ */
+static osalStatus iocomtest_connect_device(
+    iocomTestPair *p);
+
+#if IOC_STREAMER_SUPPORT
+static void iocomtest_brick_signals(
+    iocSignal *sig,
+    iocStreamerSignals *signals,
+    iocHandle *exp,
+    iocHandle *imp,
+    os_int buf_sz);
+#endif
+
+
+/**
+****************************************************************************************************
+
+  @brief Record result of a check.
+  @anchor iocomtest_report
+
+  The iocomtest_report() function is called through iocomtest_check() macro. It counts checks
+  and prints failed ones with source file and line number.
+
+  @param   ok OS_TRUE if check passed.
+  @param   text Description of what was checked.
+  @param   file Source file name.
+  @param   line Line number within source file.
+  @return  Value of ok.
+
+****************************************************************************************************
+*/
+os_boolean iocomtest_report(
+    os_boolean ok,
+    const os_char *text,
+    const os_char *file,
+    os_int line)
+{
+    os_char nbuf[OSAL_NBUF_SZ];
+
+    iocomtest_nro_checks++;
+    if (ok) return OS_TRUE;
+
+    iocomtest_nro_failed++;
+    osal_int_to_str(nbuf, sizeof(nbuf), line);
+    osal_console_write("  FAILED: ");
+    osal_console_write(text);
+    osal_console_write(" (");
+    osal_console_write(file);
+    osal_console_write(":");
+    osal_console_write(nbuf);
+    osal_console_write(")\n");
+    return OS_FALSE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Print test group name.
+  @anchor iocomtest_group
+
+  @param   name Test group name.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_group(
+    const os_char *name)
+{
+    osal_console_write(name);
+    osal_console_write("\n");
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Print summary.
+  @anchor iocomtest_summary
+
+  @return  OSAL_SUCCESS if all checks passed, OSAL_STATUS_FAILED otherwise.
+
+****************************************************************************************************
+*/
+osalStatus iocomtest_summary(void)
+{
+    os_char nbuf[OSAL_NBUF_SZ];
+
+    osal_int_to_str(nbuf, sizeof(nbuf), iocomtest_nro_checks);
+    osal_console_write(nbuf);
+    osal_console_write(" checks, ");
+    osal_int_to_str(nbuf, sizeof(nbuf), iocomtest_nro_failed);
+    osal_console_write(nbuf);
+    osal_console_write(" failed\n");
+    return iocomtest_nro_failed ? OSAL_STATUS_FAILED : OSAL_SUCCESS;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Initialize device and controller roots.
+  @anchor iocomtest_initialize_pair
+
+  @param   p Pointer to test pair structure to initialize.
+  @param   name Loopback stream name, unique for the test.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_initialize_pair(
+    iocomTestPair *p,
+    const os_char *name)
+{
+    os_memclear(p, sizeof(iocomTestPair));
+    p->name = name;
+
+    ioc_initialize_root(&p->device, IOC_CREATE_OWN_MUTEX);
+    ioc_set_iodevice_id(&p->device, IOCOMTEST_DEVICE_NAME, IOCOMTEST_DEVICE_NR,
+        "testpass", IOCOMTEST_NETWORK_NAME);
+
+    ioc_initialize_root(&p->controller, IOC_CREATE_OWN_MUTEX);
+    ioc_set_iodevice_id(&p->controller, "testctrl", 1, "testpass", IOCOMTEST_NETWORK_NAME);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Start listening and connecting.
+  @anchor iocomtest_connect_pair
+
+  Controller listens and device connects up over loopback stream. Connection and end point
+  are run from iocomtest_run_pair(), no worker threads are created.
+
+  @param   p Pointer to test pair.
+  @return  OSAL_SUCCESS if successful, other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus iocomtest_connect_pair(
+    iocomTestPair *p)
+{
+    iocEndPointParams epprm;
+    osalStatus s;
+
+    p->epoint = ioc_initialize_end_point(OS_NULL, &p->controller);
+    os_memclear(&epprm, sizeof(epprm));
+    epprm.iface = IOC_LOOPBACK_IFACE;
+    epprm.flags = IOC_SOCKET;
+    epprm.parameters = p->name;
+    s = ioc_listen(p->epoint, &epprm);
+    if (s) return s;
+
+    return iocomtest_connect_device(p);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Reconnect device.
+  @anchor iocomtest_reconnect_pair
+
+  Device's connection is closed and the pair is run until controller has released its
+  accepted connection, then device connects again. Memory blocks and controller's end point
+  are kept, like when a device with unstable link reconnects.
+
+  @param   p Pointer to connected test pair.
+  @return  OSAL_SUCCESS if successful, OSAL_STATUS_TIMEOUT if controller did not notice the
+           disconnect within IOCOMTEST_TIMEOUT_MS. Other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus iocomtest_reconnect_pair(
+    iocomTestPair *p)
+{
+    os_timer start_t;
+
+    if (p->con)
+    {
+        ioc_release_connection(p->con);
+        p->con = OS_NULL;
+    }
+
+    os_get_timer(&start_t);
+    while (p->controller.con.first)
+    {
+        if (os_has_elapsed(&start_t, IOCOMTEST_TIMEOUT_MS)) return OSAL_STATUS_TIMEOUT;
+        iocomtest_run_pair(p);
+        os_timeslice();
+    }
+
+    return iocomtest_connect_device(p);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Close device's connection and controller's end point.
+  @anchor iocomtest_disconnect_pair
+
+  Controller's accepted connection notices the disconnect and is released when the pair is
+  run next time.
+
+  @param   p Pointer to test pair.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_disconnect_pair(
+    iocomTestPair *p)
+{
+    if (p->con)
+    {
+        ioc_release_connection(p->con);
+        p->con = OS_NULL;
+    }
+    if (p->epoint)
+    {
+        ioc_release_end_point(p->epoint);
+        p->epoint = OS_NULL;
+    }
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release device and controller roots.
+  @anchor iocomtest_release_pair
+
+  Releases also connection, end point and memory blocks.
+
+  @param   p Pointer to test pair.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_release_pair(
+    iocomTestPair *p)
+{
+    iocomtest_disconnect_pair(p);
+    ioc_release_root(&p->device);
+    ioc_release_root(&p->controller);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run both roots once.
+  @anchor iocomtest_run_pair
+
+  @param   p Pointer to test pair.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_run_pair(
+    iocomTestPair *p)
+{
+    ioc_run(&p->device);
+    ioc_run(&p->controller);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Run both roots until condition is true.
+  @anchor iocomtest_run_pair_until
+
+  @param   p Pointer to test pair.
+  @param   func Condition function, called after each run.
+  @param   context Application context for condition function.
+  @param   timeout_ms Maximum time to wait, ms.
+  @return  OS_TRUE if condition became true, OS_FALSE if timed out.
+
+****************************************************************************************************
+*/
+os_boolean iocomtest_run_pair_until(
+    iocomTestPair *p,
+    iocomtest_condition_func *func,
+    void *context,
+    os_int timeout_ms)
+{
+    os_timer start_t;
+
+    os_get_timer(&start_t);
+    do
+    {
+        iocomtest_run_pair(p);
+        if (func(p, context)) return OS_TRUE;
+        os_timeslice();
+    }
+    while (!os_has_elapsed(&start_t, timeout_ms));
+
+    return OS_FALSE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Create memory block for test pair.
+  @anchor iocomtest_memory_block
+
+  Memory block is named so that device's and controller's memory blocks with the same
+  name match: Device name, number and network name are always the device's. Direction
+  flag is the same at both ends.
+
+  @param   handle Memory block handle to set up.
+  @param   root Device or controller root of test pair.
+  @param   mblk_name Memory block name.
+  @param   nbytes Memory block size in bytes.
+  @param   flags IOC_MBLK_UP for data from device to controller, IOC_MBLK_DOWN for data
+           from controller to device.
+  @return  OSAL_SUCCESS if successful, other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus iocomtest_memory_block(
+    iocHandle *handle,
+    iocRoot *root,
+    const os_char *mblk_name,
+    os_int nbytes,
+    os_short flags)
+{
+    iocMemoryBlockParams prm;
+
+    os_memclear(&prm, sizeof(prm));
+    prm.mblk_name = mblk_name;
+    prm.nbytes = (ioc_addr)nbytes;
+    prm.flags = flags;
+    return iocomtest_memory_block_prm(handle, root, &prm);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Create memory block for test pair with parameters.
+  @anchor iocomtest_memory_block_prm
+
+  Like iocomtest_memory_block(), but memory block name, size, flags and optional settings
+  like priority are given in parameter structure. Device name, number and network name
+  are set by this function.
+
+  @param   handle Memory block handle to set up.
+  @param   root Device or controller root of test pair.
+  @param   prm Memory block parameters.
+  @return  OSAL_SUCCESS if successful, other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus iocomtest_memory_block_prm(
+    iocHandle *handle,
+    iocRoot *root,
+    iocMemoryBlockParams *prm)
+{
+    prm->device_name = IOCOMTEST_DEVICE_NAME;
+    prm->device_nr = IOCOMTEST_DEVICE_NR;
+    prm->network_name = IOCOMTEST_NETWORK_NAME;
+    return ioc_initialize_memory_block(handle, OS_NULL, root, prm);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Write integer to memory block.
+  @anchor iocomtest_set_int
+
+  Value is written in native byte order, both ends of the test pair run in the same process.
+
+  @param   handle Memory block handle.
+  @param   addr Address within memory block.
+  @param   value Value to write.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_set_int(
+    iocHandle *handle,
+    os_int addr,
+    os_int value)
+{
+    ioc_write(handle, addr, (const os_char*)&value, sizeof(value), 0);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Read integer from memory block.
+  @anchor iocomtest_get_int
+
+  @param   handle Memory block handle.
+  @param   addr Address within memory block.
+  @return  Value read.
+
+****************************************************************************************************
+*/
+os_int iocomtest_get_int(
+    iocHandle *handle,
+    os_int addr)
+{
+    os_int value;
+
+    ioc_read(handle, addr, (os_char*)&value, sizeof(value), 0);
+    return value;
+}
+
+
+#if IOC_STREAMER_SUPPORT
+/**
+****************************************************************************************************
+
+  @brief Set up flat buffer brick transfer from device to controller.
+  @anchor iocomtest_setup_brick_pair
+
+  Creates "exp" memory block for state, head, checksum and buffer signals and "imp" memory
+  block for command signal at both ends, and initializes device's brick buffer as sending
+  and controller's as receiving end with receive enabled. Call before connecting the pair.
+
+  @param   bp Pointer to brick pair structure to set up.
+  @param   p Pointer to initialized test pair, not yet connected.
+  @param   buf_sz Size of flat brick buffer, bytes. Must hold brick header and data.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_setup_brick_pair(
+    iocomTestBrickPair *bp,
+    iocomTestPair *p,
+    os_int buf_sz)
+{
+    os_memclear(bp, sizeof(iocomTestBrickPair));
+
+    iocomtest_memory_block(&bp->dexp, &p->device, "exp", buf_sz + 14, IOC_MBLK_UP);
+    iocomtest_memory_block(&bp->dimp, &p->device, "imp", 5, IOC_MBLK_DOWN);
+    iocomtest_memory_block(&bp->cexp, &p->controller, "exp", buf_sz + 14, IOC_MBLK_UP);
+    iocomtest_memory_block(&bp->cimp, &p->controller, "imp", 5, IOC_MBLK_DOWN);
+
+    iocomtest_brick_signals(bp->dsig, &bp->dsignals, &bp->dexp, &bp->dimp, buf_sz);
+    iocomtest_brick_signals(bp->csig, &bp->csignals, &bp->cexp, &bp->cimp, buf_sz);
+
+    ioc_initialize_brick_buffer(&bp->send, &bp->dsignals, &p->device, 0, IOC_BRICK_DEVICE);
+    ioc_initialize_brick_buffer(&bp->receive, &bp->csignals, &p->controller, 0,
+        IOC_BRICK_CONTROLLER);
+    ioc_brick_set_receive(&bp->receive, OS_TRUE);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Move brick signals and run receiving end.
+  @anchor iocomtest_run_brick_pair
+
+  Sends changed memory blocks of both roots, runs the pair once, receives and runs
+  controller's brick buffer. Sending end is run by the test, like by ioc_run_brick_send().
+
+  @param   bp Pointer to brick pair.
+  @param   p Pointer to connected test pair.
+  @return  Return value of ioc_run_brick_receive(), OSAL_COMPLETED if a brick was received.
+
+****************************************************************************************************
+*/
+osalStatus iocomtest_run_brick_pair(
+    iocomTestBrickPair *bp,
+    iocomTestPair *p)
+{
+    ioc_send_all(&p->device);
+    ioc_send_all(&p->controller);
+    iocomtest_run_pair(p);
+    ioc_receive_all(&p->device);
+    ioc_receive_all(&p->controller);
+    return ioc_run_brick_receive(&bp->receive);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release brick pair.
+  @anchor iocomtest_release_brick_pair
+
+  @param   bp Pointer to brick pair.
+  @return  None.
+
+****************************************************************************************************
+*/
+void iocomtest_release_brick_pair(
+    iocomTestBrickPair *bp)
+{
+    ioc_release_brick_buffer(&bp->send);
+    ioc_release_brick_buffer(&bp->receive);
+    ioc_release_handle(&bp->dexp);
+    ioc_release_handle(&bp->dimp);
+    ioc_release_handle(&bp->cexp);
+    ioc_release_handle(&bp->cimp);
+}
+#endif
+
+
+/**
+****************************************************************************************************
+
+  @brief Connect device up to controller (internal).
+  @anchor iocomtest_connect_device
+
+  @param   p Pointer to test pair.
+  @return  OSAL_SUCCESS if successful, other values indicate an error.
+
+****************************************************************************************************
+*/
+static osalStatus iocomtest_connect_device(
+    iocomTestPair *p)
+{
+    iocConnectionParams conprm;
+
+    p->con = ioc_initialize_connection(OS_NULL, &p->device);
+    os_memclear(&conprm, sizeof(conprm));
+    conprm.iface = IOC_LOOPBACK_IFACE;
+    conprm.flags = IOC_SOCKET|IOC_CONNECT_UP;
+    conprm.parameters = p->name;
+    return ioc_connect(p->con, &conprm);
+}
+
+
+#if IOC_STREAMER_SUPPORT
+/**
+****************************************************************************************************
+
+  @brief Set up flat buffer brick signals for one end (internal).
+  @anchor iocomtest_brick_signals
+
+  Each signal has state byte followed by value: state (int) at 0, head (int) at 5,
+  checksum (ushort) at 10 and buffer at 13 in "exp", command (int) at 0 in "imp".
+
+  @param   sig Array of IOCOMTEST_BRICK_NRO_SIGNALS signals to set up.
+  @param   signals Streamer signal structure to set up.
+  @param   exp Handle of "exp" memory block.
+  @param   imp Handle of "imp" memory block.
+  @param   buf_sz Size of flat brick buffer, bytes.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void iocomtest_brick_signals(
+    iocSignal *sig,
+    iocStreamerSignals *signals,
+    iocHandle *exp,
+    iocHandle *imp,
+    os_int buf_sz)
+{
+    os_memclear(sig, IOCOMTEST_BRICK_NRO_SIGNALS * sizeof(iocSignal));
+    sig[IOCOMTEST_BRICK_CMD].addr = 0;
+    sig[IOCOMTEST_BRICK_CMD].n = 1;
+    sig[IOCOMTEST_BRICK_CMD].flags = OS_INT;
+    sig[IOCOMTEST_BRICK_CMD].handle = imp;
+    sig[IOCOMTEST_BRICK_STATE].addr = 0;
+    sig[IOCOMTEST_BRICK_STATE].n = 1;
+    sig[IOCOMTEST_BRICK_STATE].flags = OS_INT;
+    sig[IOCOMTEST_BRICK_STATE].handle = exp;
+    sig[IOCOMTEST_BRICK_HEAD].addr = 5;
+    sig[IOCOMTEST_BRICK_HEAD].n = 1;
+    sig[IOCOMTEST_BRICK_HEAD].flags = OS_INT;
+    sig[IOCOMTEST_BRICK_HEAD].handle = exp;
+    sig[IOCOMTEST_BRICK_CS].addr = 10;
+    sig[IOCOMTEST_BRICK_CS].n = 1;
+    sig[IOCOMTEST_BRICK_CS].flags = OS_USHORT;
+    sig[IOCOMTEST_BRICK_CS].handle = exp;
+    sig[IOCOMTEST_BRICK_BUF].addr = 13;
+    sig[IOCOMTEST_BRICK_BUF].n = buf_sz;
+    sig[IOCOMTEST_BRICK_BUF].flags = OS_UCHAR;
+    sig[IOCOMTEST_BRICK_BUF].handle = exp;
+
+    os_memclear(signals, sizeof(iocStreamerSignals));
+    signals->cmd = sig + IOCOMTEST_BRICK_CMD;
+    signals->state = sig + IOCOMTEST_BRICK_STATE;
+    signals->head = sig + IOCOMTEST_BRICK_HEAD;
+    signals->cs = sig + IOCOMTEST_BRICK_CS;
+    signals->buf = sig + IOCOMTEST_BRICK_BUF;
+    signals->flat_buffer = OS_TRUE;
+}
+#endif
@@ -633,6 +633,9 @@ static void ioboard_camera_callback(
                 trigger_motion_detect(&motion);
             }
         }
+        else if (ioc_is_brick_connected(&video_output)) {
+            ioc_brick_frame_skipped(&video_output);
+        }
     }
 }
 
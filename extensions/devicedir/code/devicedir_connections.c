@@ -15,13 +15,41 @@
 */
 #include "devicedir.h"
 
+/* Snapshot of one connection, copied under ioc_lock.
+ */
+typedef struct devicedirConSnapshot
+{
+    const os_char *iface_name;
+    os_boolean connected;
+    os_short flags;
+    os_char parameters[IOC_CONNECTION_PRMSTR_SZ];
+#if OSAL_SOCKET_SUPPORT
+    os_char ip_from_lighthouse[OSAL_IPADDR_AND_PORT_SZ];
+#endif
+#if IOC_ADAPTIVE_FLOW_CONTROL
+    os_int rtt_ms;
+    os_int max_in_air;
+    os_uint standalone_acks;
+    os_uint piggybacked_acks;
+#endif
+#if IOC_LAZY_SYNC_BUFFERS
+    os_memsz syncbuf_bytes;
+#endif
+#if IOC_CONNECT_STATS
+    os_int auth_ms;
+    os_int first_data_ms;
+#endif
+}
+devicedirConSnapshot;
+
 
 /**
 ****************************************************************************************************
 
   @brief List connections of this node.
 
-  The devicedir_connections() function lists connections.
+  The devicedir_connections() function lists connections. Connection information is copied
+  to a snapshot while ioc_lock is on, JSON is printed after releasing the lock.
 
   @param   root Pointer to the root structure.
   @param   list Steam handle into which to write connection list JSON
@@ -36,61 +64,127 @@ void devicedir_connections(
     os_short flags)
 {
     iocConnection *con;
-    os_char *iface_name;
+    devicedirConSnapshot *snapshot, *cs;
+    os_memsz snapshot_sz;
+    os_int n, i;
     os_short cflags;
     os_boolean isfirst;
+    OSAL_UNUSED(flags);
 
     /* Check that root object is valid pointer.
      */
     osal_debug_assert(root->debug_id == 'R');
 
-    osal_stream_print_str(list, "{\"con\": [\n", 0);
-
     /* Synchronize.
      */
     ioc_lock(root);
 
-    for (con = root->con.first;
+    n = 0;
+    for (con = root->con.first; con; con = con->link.next) {
+        n++;
+    }
+
+    snapshot = OS_NULL;
+    snapshot_sz = n * sizeof(devicedirConSnapshot);
+    if (n)
+    {
+        snapshot = (devicedirConSnapshot*)os_malloc(snapshot_sz, OS_NULL);
+        if (snapshot == OS_NULL)
+        {
+            ioc_unlock(root);
+            osal_stream_print_str(list, "{\"error\":\"out of memory\"}\n", 0);
+            return;
+        }
+    }
+
+    for (con = root->con.first, cs = snapshot;
          con;
-         con = con->link.next)
+         con = con->link.next, cs++)
     {
         cflags = con->flags;
 
         if (con->iface == OSAL_SOCKET_IFACE)
         {
-            iface_name = (cflags & IOC_SOCKET) ? "socket" : "socket MISMATCH";
+            cs->iface_name = (cflags & IOC_SOCKET) ? "socket" : "socket MISMATCH";
         }
 #if OSAL_TLS_SUPPORT
         else if (con->iface == OSAL_TLS_IFACE)
         {
-            iface_name = (cflags & IOC_SOCKET) ? "tls" : "tls MISMATCH";
+            cs->iface_name = (cflags & IOC_SOCKET) ? "tls" : "tls MISMATCH";
         }
 #endif
 #if OSAL_SERIAL_SUPPORT
         else if (con->iface == OSAL_SERIAL_IFACE)
         {
-            iface_name = (cflags & IOC_SOCKET) ? "serial MISMATCH" : "serial";
+            cs->iface_name = (cflags & IOC_SOCKET) ? "serial MISMATCH" : "serial";
         }
 #endif
 #if OSAL_BLUETOOTH_SUPPORT
         else if (con->iface == OSAL_BLUETOOTH_IFACE)
         {
-            iface_name = (cflags & IOC_SOCKET) ? "bluetooth MISMATCH" : "bluetooth";
+            cs->iface_name = (cflags & IOC_SOCKET) ? "bluetooth MISMATCH" : "bluetooth";
         }
 #endif
         else
         {
-            iface_name = "unknown";
+            cs->iface_name = "unknown";
         }
 
+        cs->connected = con->connected;
+        cs->flags = cflags;
+        os_strncpy(cs->parameters, con->parameters, IOC_CONNECTION_PRMSTR_SZ);
+#if OSAL_SOCKET_SUPPORT
+        os_strncpy(cs->ip_from_lighthouse, con->ip_from_lighthouse, OSAL_IPADDR_AND_PORT_SZ);
+#endif
+#if IOC_ADAPTIVE_FLOW_CONTROL
+        cs->rtt_ms = con->fc.rtt_ms;
+        cs->max_in_air = con->max_in_air;
+        cs->standalone_acks = con->fc.standalone_acks;
+        cs->piggybacked_acks = con->fc.piggybacked_acks;
+#endif
+#if IOC_LAZY_SYNC_BUFFERS
+        cs->syncbuf_bytes = con->syncbuf_bytes;
+#endif
+#if IOC_CONNECT_STATS
+        cs->auth_ms = con->connect_timing.phase_ms[IOC_CONNECT_PHASE_AUTHENTICATED];
+        cs->first_data_ms = con->connect_timing.phase_ms[IOC_CONNECT_PHASE_FIRST_DATA];
+#endif
+    }
+
+    /* End synchronization.
+     */
+    ioc_unlock(root);
+
+    osal_stream_print_str(list, "{\"con\": [\n", 0);
+
+    for (i = 0, cs = snapshot; i < n; i++, cs++)
+    {
+        cflags = cs->flags;
+
         osal_stream_print_str(list, "{", 0);
-        devicedir_append_int_param(list, "connected", con->connected, OS_TRUE);
-        devicedir_append_str_param(list, "iface", iface_name, OS_FALSE);
-        devicedir_append_str_param(list, "param", con->parameters, OS_FALSE);
+        devicedir_append_int_param(list, "connected", cs->connected, OS_TRUE);
+        devicedir_append_str_param(list, "iface", cs->iface_name, OS_FALSE);
+        devicedir_append_str_param(list, "param", cs->parameters, OS_FALSE);
 
 #if OSAL_SOCKET_SUPPORT
-        if (con->ip_from_lighthouse[0] != '\0') {
-            devicedir_append_str_param(list, "lighthouse", con->ip_from_lighthouse, OS_FALSE);
+        if (cs->ip_from_lighthouse[0] != '\0') {
+            devicedir_append_str_param(list, "lighthouse", cs->ip_from_lighthouse, OS_FALSE);
+        }
+#endif
+
+#if IOC_ADAPTIVE_FLOW_CONTROL
+        devicedir_append_int_param(list, "rtt_ms", cs->rtt_ms, OS_FALSE);
+        devicedir_append_int_param(list, "max_in_air", cs->max_in_air, OS_FALSE);
+        devicedir_append_int_param(list, "acks", (os_int)cs->standalone_acks, OS_FALSE);
+        devicedir_append_int_param(list, "piggybacked_acks", (os_int)cs->piggybacked_acks, OS_FALSE);
+#endif
+#if IOC_LAZY_SYNC_BUFFERS
+        devicedir_append_int_param(list, "syncbuf_bytes", (os_int)cs->syncbuf_bytes, OS_FALSE);
+#endif
+#if IOC_CONNECT_STATS
+        if (cs->connected) {
+            devicedir_append_int_param(list, "auth_ms", cs->auth_ms, OS_FALSE);
+            devicedir_append_int_param(list, "first_data_ms", cs->first_data_ms, OS_FALSE);
         }
 #endif
 
@@ -109,16 +203,16 @@ void devicedir_connections(
         osal_stream_print_str(list, "\"", 0);
 
         osal_stream_print_str(list, "}", 0);
-        if (con->link.next)
+        if (i + 1 < n)
         {
             osal_stream_print_str(list, ",", 0);
         }
         osal_stream_print_str(list, "\n", 0);
     }
 
-    /* End synchronization.
-     */
-    ioc_unlock(root);
-
     osal_stream_print_str(list, "]}\n", 0);
+
+    if (snapshot) {
+        os_free(snapshot, snapshot_sz);
+    }
 }
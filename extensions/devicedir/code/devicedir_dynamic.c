@@ -16,26 +16,39 @@
 #include "devicedir.h"
 #if IOC_DYNAMIC_MBLK_CODE
 
+/* Snapshot of one dynamic signal, copied under ioc_lock.
+ */
+typedef struct devicedirSignalSnapshot
+{
+    os_char signal_name[IOC_SIGNAL_NAME_SZ];
+    os_char mblk_name[IOC_NAME_SZ];
+    os_char device_name[IOC_NAME_SZ];
+    os_uint device_nr;
+    os_char network_name[IOC_NETWORK_NAME_SZ];
+    os_int addr;
+    os_int n;
+    os_char flags;
+}
+devicedirSignalSnapshot;
 
 /* Forward referred static functions.
  */
-static void devicedir_networks_dynamic_signals(
-    iocDynamicNetwork *dnetwork,
-    osalStream list,
-    os_short flags,
-    os_boolean *is_first);
+static os_boolean devicedir_dsignal_matches(
+    iocDynamicSignal *dsignal,
+    iocIdentifiers *ids);
 
 
 /**
 ****************************************************************************************************
 
-  @brief List end points connections of this node.
+  @brief List dynamic signals of this node.
 
   The devicedir_dynamic_signals() function lists all dynamic signals.
 
   @param   root Pointer to the root structure.
   @param   list Steam handle into which to write connection list JSON
-  @param   iopath
+  @param   iopath Not used, all dynamic signals are listed. Use
+           devicedir_query_dynamic_signals() to select signals.
   @param   flags Reserved for future, set 0.
   @return  None.
 
@@ -46,16 +59,59 @@ void devicedir_dynamic_signals(
     osalStream list,
     const os_char *iopath,
     os_short flags)
+{
+    devicedirQuery query;
+    OSAL_UNUSED(iopath);
+
+    os_memclear(&query, sizeof(query));
+    query.flags = flags;
+    devicedir_query_dynamic_signals(root, list, &query);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief List a page of dynamic signals.
+
+  The devicedir_query_dynamic_signals() function lists dynamic signals selected by IO path
+  (memory block, device and network name, like "exp.tempctrl1.cafenet"), starting from
+  query->first matching signal and listing at most query->max_items. If there are more
+  matching signals, "next" index is appended to JSON for the following query.
+
+  Signal information is copied to a snapshot while ioc_lock is on, the JSON is printed
+  from the snapshot after releasing the lock.
+
+  @param   root Pointer to the root structure.
+  @param   list Steam handle into which to write signal list JSON.
+  @param   query Selects signals and page.
+  @return  None.
+
+****************************************************************************************************
+*/
+void devicedir_query_dynamic_signals(
+    iocRoot *root,
+    osalStream list,
+    const devicedirQuery *query)
 {
     iocDynamicRoot *droot;
     iocDynamicNetwork *dnetwork;
-    os_int i;
-    os_boolean is_first;
+    iocDynamicSignal *dsignal;
+    iocIdentifiers ids;
+    devicedirSignalSnapshot *snapshot, *ss;
+    os_memsz snapshot_sz;
+    os_int i, j, pass, index, n, max_items, next;
 
     /* Check that root object is valid pointer.
      */
     osal_debug_assert(root->debug_id == 'R');
 
+    os_memclear(&ids, sizeof(ids));
+    if (query->iopath) {
+        ioc_iopath_to_identifiers(root, &ids, query->iopath, IOC_EXPECT_MEMORY_BLOCK);
+    }
+    max_items = query->max_items > 0 ? query->max_items : 0x7FFFFFFF;
+
     /* Synchronize.
      */
     ioc_lock(root);
@@ -63,67 +119,146 @@ void devicedir_dynamic_signals(
     droot = root->droot;
     if (droot == OS_NULL)
     {
-        osal_stream_print_str(list, "{\"error\":\"Dynamic signal information not used by the application\"}\n", 0);
         ioc_unlock(root);
+        osal_stream_print_str(list, "{\"error\":\"Dynamic signal information not used by the application\"}\n", 0);
         return;
     }
 
-    osal_stream_print_str(list, "{\"signal\": [", 0);
+    /* First pass counts signals on the page, second one copies them to snapshot.
+     */
+    snapshot = ss = OS_NULL;
+    snapshot_sz = 0;
+    n = 0;
+    next = -1;
+    for (pass = 0; pass < 2; pass++)
+    {
+        index = 0;
+        for (i = 0; i < IOC_DROOT_HASH_TAB_SZ; i++)
+        {
+            for (dnetwork = droot->hash[i];
+                 dnetwork;
+                 dnetwork = dnetwork->next)
+            {
+                if (ids.network_name[0] != '\0' &&
+                    os_strcmp(ids.network_name, dnetwork->network_name))
+                {
+                    continue;
+                }
 
+                for (j = 0; j < IOC_DNETWORK_HASH_TAB_SZ; j++)
+                {
+                    for (dsignal = dnetwork->hash[j];
+                         dsignal;
+                         dsignal = dsignal->next)
+                    {
+                        if (!devicedir_dsignal_matches(dsignal, &ids)) continue;
+                        if (index++ < query->first) continue;
 
-    is_first = OS_TRUE;
-    for (i = 0; i < IOC_DROOT_HASH_TAB_SZ; i++)
-    {
-        for (dnetwork = droot->hash[i];
-             dnetwork;
-             dnetwork = dnetwork->next)
+                        if (pass == 0)
+                        {
+                            if (n >= max_items) {
+                                if (next < 0) next = index - 1;
+                                continue;
+                            }
+                            n++;
+                            continue;
+                        }
+
+                        if (ss - snapshot >= n) continue;
+                        os_strncpy(ss->signal_name, dsignal->signal_name, IOC_SIGNAL_NAME_SZ);
+                        os_strncpy(ss->mblk_name, dsignal->mblk_name, IOC_NAME_SZ);
+                        os_strncpy(ss->device_name, dsignal->device_name, IOC_NAME_SZ);
+                        ss->device_nr = dsignal->device_nr;
+                        os_strncpy(ss->network_name, dnetwork->network_name, IOC_NETWORK_NAME_SZ);
+                        ss->addr = dsignal->addr;
+                        ss->n = dsignal->n;
+                        ss->flags = dsignal->flags;
+                        ss++;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0)
         {
-            devicedir_networks_dynamic_signals(dnetwork, list, flags, &is_first);
+            if (n == 0) break;
+            snapshot_sz = n * sizeof(devicedirSignalSnapshot);
+            snapshot = ss = (devicedirSignalSnapshot*)os_malloc(snapshot_sz, OS_NULL);
+            if (snapshot == OS_NULL)
+            {
+                ioc_unlock(root);
+                osal_stream_print_str(list, "{\"error\":\"out of memory\"}\n", 0);
+                return;
+            }
         }
     }
 
     /* End synchronization.
      */
     ioc_unlock(root);
-    osal_stream_print_str(list, "\n]}\n", 0);
+
+    osal_stream_print_str(list, "{\"signal\": [", 0);
+    for (i = 0, ss = snapshot; i < n; i++, ss++)
+    {
+        if (i) {
+            osal_stream_print_str(list, ",\n", 0);
+        }
+
+        osal_stream_print_str(list, "{", 0);
+        devicedir_append_str_param(list, "signal_name", ss->signal_name, OS_TRUE);
+        devicedir_append_str_param(list, "mblk_name", ss->mblk_name, OS_FALSE);
+        devicedir_append_str_param(list, "device_name", ss->device_name, OS_FALSE);
+        devicedir_append_int_param(list, "device_nr", ss->device_nr, OS_FALSE);
+        devicedir_append_str_param(list, "network_name", ss->network_name, OS_FALSE);
+        devicedir_append_int_param(list, "addr", ss->addr, OS_FALSE);
+        devicedir_append_int_param(list, "n", ss->n, OS_FALSE);
+        devicedir_append_str_param(list, "type",
+            osal_typeid_to_name(ss->flags & OSAL_TYPEID_MASK), OS_FALSE);
+
+        osal_stream_print_str(list, "}", 0);
+    }
+    osal_stream_print_str(list, "\n]", 0);
+    if (next >= 0) {
+        devicedir_append_int_param(list, "next", next, OS_FALSE);
+    }
+    osal_stream_print_str(list, "}\n", 0);
+
+    if (snapshot) {
+        os_free(snapshot, snapshot_sz);
+    }
 }
 
 
-static void devicedir_networks_dynamic_signals(
-    iocDynamicNetwork *dnetwork,
-    osalStream list,
-    os_short flags,
-    os_boolean *is_first)
-{
-    iocDynamicSignal *dsignal;
-    os_int i;
+/**
+****************************************************************************************************
+
+  @brief Check if dynamic signal is selected by IO path identifiers (internal).
+
+  Network name is checked by caller.
 
-    for (i = 0; i < IOC_DNETWORK_HASH_TAB_SZ; i++)
+  @param   dsignal Pointer to dynamic signal.
+  @param   ids IO path split to identifiers, empty identifiers match all.
+  @return  OS_TRUE if signal matches.
+
+****************************************************************************************************
+*/
+static os_boolean devicedir_dsignal_matches(
+    iocDynamicSignal *dsignal,
+    iocIdentifiers *ids)
+{
+    if (ids->device_name[0] != '\0')
     {
-        for (dsignal = dnetwork->hash[i];
-             dsignal;
-             dsignal = dsignal->next)
-        {
-            if (!*is_first)
-            {
-                osal_stream_print_str(list, ",\n", 0);
-            }
-            *is_first = OS_FALSE;
-
-            osal_stream_print_str(list, "{", 0);
-            devicedir_append_str_param(list, "signal_name", dsignal->signal_name, OS_TRUE);
-            devicedir_append_str_param(list, "mblk_name", dsignal->mblk_name, OS_FALSE);
-            devicedir_append_str_param(list, "device_name", dsignal->device_name, OS_FALSE);
-            devicedir_append_int_param(list, "device_nr", dsignal->device_nr, OS_FALSE);
-            devicedir_append_str_param(list, "network_name", dnetwork->network_name, OS_FALSE);
-            devicedir_append_int_param(list, "addr", dsignal->addr, OS_FALSE);
-            devicedir_append_int_param(list, "n", dsignal->n, OS_FALSE);
-            devicedir_append_str_param(list, "type",
-                osal_typeid_to_name(dsignal->flags & OSAL_TYPEID_MASK), OS_FALSE);
-
-            osal_stream_print_str(list, "}", 0);
-        }
+        if (os_strcmp(ids->device_name, dsignal->device_name)) return OS_FALSE;
+    }
+    if (ids->device_nr)
+    {
+        if (ids->device_nr != dsignal->device_nr) return OS_FALSE;
+    }
+    if (ids->mblk_name[0] != '\0')
+    {
+        if (os_strcmp(ids->mblk_name, dsignal->mblk_name)) return OS_FALSE;
     }
+    return OS_TRUE;
 }
 
 #endif
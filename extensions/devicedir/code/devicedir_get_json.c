@@ -102,3 +102,54 @@ osalStatus devicedir_get_json(
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Get a page of selected information as JSON text.
+  @anchor devicedir_query_json
+
+  The devicedir_query_json function is like devicedir_get_json(), but memory blocks and
+  dynamic signals are selected and paged by query, see devicedirQuery. Other information
+  is listed as by devicedir_get_json().
+
+  @param   root Pointer to the root structure.
+  @param   list Steam handle into which to write the list as JSON
+  @param   select Selects what information to get, see ddSelectJSON enumeration.
+  @param   query IO path to select items, page and information to display.
+  @param   plabel Pointer where to store label for the information, OS_NULL if not needed.
+  @return  OSAL_SUCCESS if all good, other values indicate an error.
+
+****************************************************************************************************
+*/
+osalStatus devicedir_query_json(
+    iocRoot *root,
+    osalStream list,
+    ddSelectJSON select,
+    const devicedirQuery *query,
+    const os_char **plabel)
+{
+    os_memsz n;
+
+    switch (select)
+    {
+        case IO_DD_MEMORY_BLOCKS:
+            devicedir_query_memory_blocks(root, list, query);
+            break;
+
+#if IOC_DYNAMIC_MBLK_CODE
+        case IO_DD_DYNAMIC_SIGNALS:
+            devicedir_query_dynamic_signals(root, list, query);
+            break;
+#endif
+
+        default:
+            return devicedir_get_json(root, list, select, query->iopath, query->flags, plabel);
+    }
+
+    osal_stream_write(list, "\0", 1, &n, OSAL_STREAM_DEFAULT);
+
+    if (plabel) {
+        *plabel = (select == IO_DD_MEMORY_BLOCKS) ? "memory blocks" : "dynamic signals";
+    }
+    return OSAL_SUCCESS;
+}
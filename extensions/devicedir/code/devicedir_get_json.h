@@ -41,4 +41,13 @@ osalStatus devicedir_get_json(
     os_short flags,
     const os_char **plabel);
 
+/* Convert selected and paged information to JSON text.
+*/
+osalStatus devicedir_query_json(
+    iocRoot *root,
+    osalStream list,
+    ddSelectJSON select,
+    const devicedirQuery *query,
+    const os_char **plabel);
+
 #endif
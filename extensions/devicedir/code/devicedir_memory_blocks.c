@@ -15,6 +15,92 @@
 */
 #include "devicedir.h"
 
+/* Align snapshot item size.
+ */
+#define DEVICEDIR_ALIGN(n) (((n) + 7) & ~7)
+
+/* Snapshot of one source or target buffer. Values are listed with names from
+   devicedir_sbuf_names or devicedir_tbuf_names.
+ */
+#define DEVICEDIR_BUF_NVALUES 9
+typedef struct devicedirBufSnapshot
+{
+    os_int remote_mblk_id;
+    os_int value[DEVICEDIR_BUF_NVALUES];
+    os_boolean bidirectional;
+}
+devicedirBufSnapshot;
+
+static const os_char * const devicedir_sbuf_names[DEVICEDIR_BUF_NVALUES] = {
+    "range_set", "changed.start_addr", "changed.end_addr", "nbytes", "buf_used",
+    "make_keyframe", "is_keyframe", "start_addr", "end_addr"};
+
+static const os_char * const devicedir_tbuf_names[DEVICEDIR_BUF_NVALUES] = {
+    "nbytes", "buf_start_addr", "buf_end_addr", "buf_used", "has_new_data",
+    "newdata_start_addr", "newdata_end_addr", OS_NULL, OS_NULL};
+
+/* Maximum number of changed address ranges listed per memory block. More changes are
+   merged into one range.
+ */
+#define DEVICEDIR_MAX_CHANGES 8
+
+/* Snapshot of one memory block. Buffer snapshots and data follow memory block snapshots
+   in the same allocation.
+ */
+typedef struct devicedirMblkSnapshot
+{
+    os_char mblk_name[IOC_NAME_SZ];
+#if IOC_MBLK_SPECIFIC_DEVICE_NAME
+    os_char device_name[IOC_NAME_SZ];
+    os_uint device_nr;
+    os_char network_name[IOC_NETWORK_NAME_SZ];
+#endif
+    os_int mblk_id;
+    os_int nbytes;
+    os_short flags;
+    os_short nro_sbufs;
+    os_short nro_tbufs;
+    os_int data_sz;
+#if IOC_MBLK_COALESCE
+    os_int send_interval_ms;
+    os_uint sync_count;
+    os_uint coalesced_count;
+#endif
+#if IOC_MBLK_GENERATIONS
+    os_uint generation;
+    os_int nro_changes;
+    iocMblkChange changes[DEVICEDIR_MAX_CHANGES];
+#endif
+}
+devicedirMblkSnapshot;
+
+/* Forward referred static functions.
+ */
+#if IOC_DYNAMIC_MBLK_CODE
+static os_boolean devicedir_mblk_matches(
+    iocMemoryBlock *mblk,
+    iocIdentifiers *ids);
+#endif
+
+#if IOC_MBLK_GENERATIONS
+static os_boolean devicedir_mblk_changed(
+    iocMemoryBlock *mblk,
+    os_uint changed_since);
+#endif
+
+static void devicedir_print_mblk_snapshot(
+    devicedirMblkSnapshot *ms,
+    osalStream list,
+    os_char **pos,
+    os_short flags);
+
+static void devicedir_print_buf_snapshots(
+    const os_char *list_name,
+    const os_char * const *names,
+    devicedirBufSnapshot *bs,
+    os_int n,
+    osalStream list);
+
 
 /**
 ****************************************************************************************************
@@ -38,14 +124,61 @@ void devicedir_memory_blocks(
     osalStream list,
     const os_char *iopath,
     os_short flags)
+{
+    devicedirQuery query;
+
+    os_memclear(&query, sizeof(query));
+    query.iopath = iopath;
+    query.flags = flags;
+    devicedir_query_memory_blocks(root, list, &query);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief List a page of memory blocks.
+
+  The devicedir_query_memory_blocks() function lists memory blocks selected by IO path,
+  starting from query->first matching memory block and listing at most query->max_items.
+  If there are more matching memory blocks, "next" index is appended to JSON for the
+  following query.
+
+  Root's latest memory block "generation" is appended to JSON. When it is given as
+  query->changed_since to a later query, only memory blocks changed since are listed,
+  each with "changes" list of changed address ranges.
+
+  Memory block information, and data and buffer states if requested, is copied to
+  a snapshot while ioc_lock is on. The JSON is printed from the snapshot after releasing
+  the lock, so that listing doesn't hold back communication.
+
+  @param   root Pointer to the root structure.
+  @param   list Steam handle into which to write the list as JSON
+  @param   query Selects memory blocks, page and information to display.
+  @return  None.
+
+****************************************************************************************************
+*/
+void devicedir_query_memory_blocks(
+    iocRoot *root,
+    osalStream list,
+    const devicedirQuery *query)
 {
 #if IOC_DYNAMIC_MBLK_CODE
     iocIdentifiers ids;
 #endif
     iocMemoryBlock *mblk;
-    os_char *sep;
-    os_short mflags;
-    os_boolean isfirst;
+    iocSourceBuffer *sbuf;
+    iocTargetBuffer *tbuf;
+    devicedirMblkSnapshot *ms;
+    devicedirBufSnapshot *bs;
+    os_char *snapshot, *pos, *sep;
+    os_memsz snapshot_sz;
+    os_int index, n, i, next, max_items;
+    os_short flags;
+#if IOC_MBLK_GENERATIONS
+    os_uint generation;
+#endif
 
     /* Check that root object is valid pointer.
      */
@@ -55,329 +188,413 @@ void devicedir_memory_blocks(
     /* Split IO path
      */
 #if IOC_DYNAMIC_MBLK_CODE
-    ioc_iopath_to_identifiers(root, &ids, iopath, IOC_EXPECT_MEMORY_BLOCK);
+    os_memclear(&ids, sizeof(ids));
+    if (query->iopath) {
+        ioc_iopath_to_identifiers(root, &ids, query->iopath, IOC_EXPECT_MEMORY_BLOCK);
+    }
 #endif
-    osal_stream_print_str(list, "{\"mblk\": [\n", 0);
-    sep = "{";
+    flags = query->flags;
+    max_items = query->max_items > 0 ? query->max_items : 0x7FFFFFFF;
 
     /* Synchronize.
      */
     ioc_lock(root);
 
-    for (mblk = root->mblk.first;
-         mblk;
-         mblk = mblk->link.next)
+    /* Calculate snapshot size for the page.
+     */
+    snapshot_sz = 0;
+    index = n = 0;
+    next = -1;
+    for (mblk = root->mblk.first; mblk; mblk = mblk->link.next)
     {
 #if IOC_DYNAMIC_MBLK_CODE
-#if IOC_MBLK_SPECIFIC_DEVICE_NAME
-        if (ids.network_name[0] != '\0')
-        {
-            if (os_strcmp(ids.network_name, mblk->network_name)) continue;
+        if (!devicedir_mblk_matches(mblk, &ids)) continue;
+#endif
+#if IOC_MBLK_GENERATIONS
+        if (!devicedir_mblk_changed(mblk, query->changed_since)) continue;
+#endif
+        if (index++ < query->first) continue;
+        if (n >= max_items) {
+            next = index - 1;
+            break;
         }
-        if (ids.device_name[0] != '\0')
+        n++;
+
+        snapshot_sz += sizeof(devicedirMblkSnapshot);
+        if (flags & IOC_DEVDIR_BUFFERS)
         {
-            if (os_strcmp(ids.device_name, mblk->device_name)) continue;
+            for (sbuf = mblk->sbuf.first; sbuf; sbuf = sbuf->mlink.next) {
+                snapshot_sz += sizeof(devicedirBufSnapshot);
+            }
+            for (tbuf = mblk->tbuf.first; tbuf; tbuf = tbuf->mlink.next) {
+                snapshot_sz += sizeof(devicedirBufSnapshot);
+            }
         }
-        if (ids.device_nr)
-        {
-            if (ids.device_nr != mblk->device_nr) continue;
+        if (flags & IOC_DEVDIR_DATA) {
+            snapshot_sz += DEVICEDIR_ALIGN(mblk->nbytes);
         }
-        if (ids.mblk_name[0] != '\0')
+    }
+
+    snapshot = OS_NULL;
+    if (snapshot_sz)
+    {
+        snapshot = (os_char*)os_malloc(snapshot_sz, OS_NULL);
+        if (snapshot == OS_NULL)
         {
-            if (os_strcmp(ids.mblk_name, mblk->mblk_name)) continue;
+            ioc_unlock(root);
+            osal_stream_print_str(list, "{\"error\":\"out of memory\"}\n", 0);
+            return;
         }
+    }
+
+    /* Copy the snapshot.
+     */
+    pos = snapshot;
+    index = i = 0;
+    for (mblk = root->mblk.first; mblk && i < n; mblk = mblk->link.next)
+    {
+#if IOC_DYNAMIC_MBLK_CODE
+        if (!devicedir_mblk_matches(mblk, &ids)) continue;
 #endif
+#if IOC_MBLK_GENERATIONS
+        if (!devicedir_mblk_changed(mblk, query->changed_since)) continue;
 #endif
-        osal_stream_print_str(list, sep, 0);
-        devicedir_append_str_param(list, "mblk_name", mblk->mblk_name, OS_TRUE);
+        if (index++ < query->first) continue;
+        i++;
+
+        ms = (devicedirMblkSnapshot*)pos;
+        pos += sizeof(devicedirMblkSnapshot);
+        os_memclear(ms, sizeof(devicedirMblkSnapshot));
+        os_strncpy(ms->mblk_name, mblk->mblk_name, IOC_NAME_SZ);
 #if IOC_MBLK_SPECIFIC_DEVICE_NAME
-        devicedir_append_str_param(list, "dev_name", mblk->device_name, OS_FALSE);
-        devicedir_append_int_param(list, "dev_nr", mblk->device_nr, OS_FALSE);
-        devicedir_append_str_param(list, "net_name", mblk->network_name, OS_FALSE);
+        os_strncpy(ms->device_name, mblk->device_name, IOC_NAME_SZ);
+        ms->device_nr = mblk->device_nr;
+        os_strncpy(ms->network_name, mblk->network_name, IOC_NETWORK_NAME_SZ);
 #endif
-        devicedir_append_int_param(list, "mblk_id", mblk->mblk_id, OS_FALSE);
-        devicedir_append_int_param(list, "size", mblk->nbytes, OS_FALSE);
-
-        osal_stream_print_str(list, ", \"flags\":\"", 0);
-        isfirst = OS_TRUE;
-        mflags = mblk->flags;
-        if (mflags & IOC_MBLK_UP) devicedir_append_flag(list, "up", &isfirst);
-        if (mflags & IOC_MBLK_DOWN) devicedir_append_flag(list, "down", &isfirst);
-        if (mflags & IOC_ALLOW_RESIZE) devicedir_append_flag(list, "resize", &isfirst);
-        if (mflags & IOC_STATIC) devicedir_append_flag(list, "static", &isfirst);
-#if IOC_DYNAMIC_MBLK_CODE
-        if (mflags & IOC_DYNAMIC) devicedir_append_flag(list, "dynamic", &isfirst);
+        ms->mblk_id = mblk->mblk_id;
+        ms->nbytes = mblk->nbytes;
+        ms->flags = mblk->flags;
+#if IOC_MBLK_COALESCE
+        ms->send_interval_ms = mblk->send_interval_ms;
+        ms->sync_count = mblk->sync_count;
+        ms->coalesced_count = mblk->coalesced_count;
 #endif
-#if IOC_BIDIRECTIONAL_MBLK_CODE
-        if (mflags & IOC_BIDIRECTIONAL) devicedir_append_flag(list, "bdsupport", &isfirst);
+#if IOC_MBLK_GENERATIONS
+        ms->generation = mblk->generation;
+        if (query->changed_since) {
+            ms->nro_changes = ioc_mblk_changes_since(mblk, query->changed_since,
+                ms->changes, DEVICEDIR_MAX_CHANGES);
+        }
 #endif
-        if (mflags & IOC_CLOUD_ONLY) devicedir_append_flag(list, "cloud-only", &isfirst);
-        if (mflags & IOC_NO_CLOUD) devicedir_append_flag(list, "no-cloud", &isfirst);
-
-        osal_stream_print_str(list, "\"", 0);
 
         if (flags & IOC_DEVDIR_BUFFERS)
         {
-            devicedir_list_mblks_source_buffers(mblk, list, flags);
-            devicedir_list_mblks_target_buffers(mblk, list, flags);
+            for (sbuf = mblk->sbuf.first; sbuf; sbuf = sbuf->mlink.next)
+            {
+                bs = (devicedirBufSnapshot*)pos;
+                pos += sizeof(devicedirBufSnapshot);
+                bs->remote_mblk_id = sbuf->remote_mblk_id;
+                bs->value[0] = sbuf->changed.range_set;
+                bs->value[1] = sbuf->changed.start_addr;
+                bs->value[2] = sbuf->changed.end_addr;
+                bs->value[3] = sbuf->syncbuf.nbytes;
+                bs->value[4] = sbuf->syncbuf.used;
+                bs->value[5] = sbuf->syncbuf.make_keyframe;
+                bs->value[6] = sbuf->syncbuf.is_keyframe;
+                bs->value[7] = sbuf->syncbuf.start_addr;
+                bs->value[8] = sbuf->syncbuf.end_addr;
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+                bs->bidirectional = (os_boolean)((sbuf->syncbuf.flags & IOC_BIDIRECTIONAL) != 0);
+#else
+                bs->bidirectional = OS_FALSE;
+#endif
+                ms->nro_sbufs++;
+            }
+            for (tbuf = mblk->tbuf.first; tbuf; tbuf = tbuf->mlink.next)
+            {
+                bs = (devicedirBufSnapshot*)pos;
+                pos += sizeof(devicedirBufSnapshot);
+                os_memclear(bs, sizeof(devicedirBufSnapshot));
+                bs->remote_mblk_id = tbuf->remote_mblk_id;
+                bs->value[0] = tbuf->syncbuf.nbytes;
+                bs->value[1] = tbuf->syncbuf.buf_start_addr;
+                bs->value[2] = tbuf->syncbuf.buf_end_addr;
+                bs->value[3] = tbuf->syncbuf.buf_used;
+                bs->value[4] = tbuf->syncbuf.has_new_data;
+                bs->value[5] = tbuf->syncbuf.newdata_start_addr;
+                bs->value[6] = tbuf->syncbuf.newdata_end_addr;
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+                bs->bidirectional = (os_boolean)((tbuf->syncbuf.flags & IOC_BIDIRECTIONAL) != 0);
+#endif
+                ms->nro_tbufs++;
+            }
         }
 
         if (flags & IOC_DEVDIR_DATA)
         {
-            devicedir_append_mblk_binary(mblk, list, flags);
+            ms->data_sz = mblk->nbytes;
+            os_memcpy(pos, mblk->buf, mblk->nbytes);
+            pos += DEVICEDIR_ALIGN(mblk->nbytes);
         }
-
-        osal_stream_print_str(list, "}", 0);
-
-        sep = ",\n{";
     }
-    osal_stream_print_str(list, "\n", 0);
+
+#if IOC_MBLK_GENERATIONS
+    generation = root->mblk_generation;
+#endif
 
     /* End synchronization.
      */
     ioc_unlock(root);
 
-    osal_stream_print_str(list, "]}\n", 0);
-}
-
-
-/**
-****************************************************************************************************
-
-  @brief Show data of one target buffer.
-
-  The devicedir_append_target_buffer() function appends information about target buffer to
-  list (JSON).
-
-  Sync lock must be on when calling this function.
-
-  @param   tbuf Pointer to the target buffer structure.
-  @param   list Steam handle into which to write the list as JSON
-  @param   flags Reserved for future, set 0.
-  @return  None.
-
-****************************************************************************************************
-*/
-void devicedir_append_target_buffer(
-    iocTargetBuffer *tbuf,
-    osalStream list,
-    os_short flags)
-{
-    OSAL_UNUSED(flags);
-
-    /* Check that root object is valid pointer.
+    /* Print JSON from the snapshot.
      */
-    osal_debug_assert(tbuf->debug_id == 'T');
-    osal_debug_assert(list != OS_NULL);
-
-    osal_stream_print_str(list, "    {", 0);
-    devicedir_append_int_param(list, "remote_mblk_id", tbuf->remote_mblk_id, OS_TRUE);
-    devicedir_append_int_param(list, "nbytes", tbuf->syncbuf.nbytes, OS_FALSE);
-    devicedir_append_int_param(list, "buf_start_addr", tbuf->syncbuf.buf_start_addr, OS_FALSE);
-    devicedir_append_int_param(list, "buf_end_addr", tbuf->syncbuf.buf_end_addr, OS_FALSE);
-    devicedir_append_int_param(list, "buf_used", tbuf->syncbuf.buf_used, OS_FALSE);
-    devicedir_append_int_param(list, "has_new_data", tbuf->syncbuf.has_new_data, OS_FALSE);
-    devicedir_append_int_param(list, "newdata_start_addr", tbuf->syncbuf.newdata_start_addr, OS_FALSE);
-    devicedir_append_int_param(list, "newdata_end_addr", tbuf->syncbuf.newdata_end_addr, OS_FALSE);
-
-#if IOC_BIDIRECTIONAL_MBLK_CODE
-    if (tbuf->syncbuf.flags & IOC_BIDIRECTIONAL)
+    osal_stream_print_str(list, "{\"mblk\": [\n", 0);
+    sep = "{";
+    pos = snapshot;
+    for (i = 0; i < n; i++)
     {
-        osal_stream_print_str(list, ", \"flags\":\"bidirectional\"", 0);
+        osal_stream_print_str(list, sep, 0);
+        devicedir_print_mblk_snapshot((devicedirMblkSnapshot*)pos, list, &pos, flags);
+        osal_stream_print_str(list, "}", 0);
+        sep = ",\n{";
+    }
+    osal_stream_print_str(list, "\n]", 0);
+    if (next >= 0) {
+        devicedir_append_int_param(list, "next", next, OS_FALSE);
     }
+#if IOC_MBLK_GENERATIONS
+    devicedir_append_int_param(list, "generation", (os_int)generation, OS_FALSE);
 #endif
+    osal_stream_print_str(list, "}\n", 0);
 
-    osal_stream_print_str(list, "}", 0);
+    if (snapshot) {
+        os_free(snapshot, snapshot_sz);
+    }
 }
 
 
+#if IOC_DYNAMIC_MBLK_CODE
 /**
 ****************************************************************************************************
 
-  @brief List target buffers connected to a memory block.
-
-  The devicedir_list_mblks_target_buffers() function appends list of target buffers attached to
-  a memory block to lists in JSON format.
-
-  Sync lock must be on when calling this function.
+  @brief Check if memory block is selected by IO path identifiers (internal).
 
-  @param   mblk Pointer to the memory buffer buffer structure.
-  @param   list Steam handle into which to write the list as JSON
-  @param   flags Reserved for future, set 0.
-  @return  None.
+  @param   mblk Pointer to the memory block.
+  @param   ids IO path split to identifiers, empty identifiers match all.
+  @return  OS_TRUE if memory block matches.
 
 ****************************************************************************************************
 */
-void devicedir_list_mblks_target_buffers(
+static os_boolean devicedir_mblk_matches(
     iocMemoryBlock *mblk,
-    osalStream list,
-    os_short flags)
+    iocIdentifiers *ids)
 {
-    iocTargetBuffer *tbuf;
-
-    tbuf = mblk->tbuf.first;
-    if (tbuf == OS_NULL) return;
-
-    osal_stream_print_str(list, ",\n  \"tbuf\": [\n", 0);
-
-    while (tbuf)
+#if IOC_MBLK_SPECIFIC_DEVICE_NAME
+    if (ids->network_name[0] != '\0')
     {
-        devicedir_append_target_buffer(tbuf, list, flags);
-
-        tbuf = tbuf->mlink.next;
-        if (tbuf)
-        {
-            osal_stream_print_str(list, ",", 0);
-        }
-        osal_stream_print_str(list, "\n", 0);
+        if (os_strcmp(ids->network_name, mblk->network_name)) return OS_FALSE;
     }
-
-    osal_stream_print_str(list, "  ]", 0);
+    if (ids->device_name[0] != '\0')
+    {
+        if (os_strcmp(ids->device_name, mblk->device_name)) return OS_FALSE;
+    }
+    if (ids->device_nr)
+    {
+        if (ids->device_nr != mblk->device_nr) return OS_FALSE;
+    }
+#endif
+    if (ids->mblk_name[0] != '\0')
+    {
+        if (os_strcmp(ids->mblk_name, mblk->mblk_name)) return OS_FALSE;
+    }
+    return OS_TRUE;
 }
+#endif
 
 
+#if IOC_MBLK_GENERATIONS
 /**
 ****************************************************************************************************
 
-  @brief Append information about one source buffer.
-
-  The devicedir_append_source_buffer() function appends information about a source buffer to
-  list (JSON).
+  @brief Check if memory block has changed since generation (internal).
 
-  Sync lock must be on when calling this function.
+  Generation numbers are common to all memory blocks of the root. Generation newer than
+  root's latest one is from an earlier run and selects all memory blocks. ioc_lock must be on.
 
-  @param   sbuf Pointer to the source buffer structure.
-  @param   list Steam handle into which to write the list as JSON
-  @param   flags Reserved for future, set 0.
-  @return  None.
+  @param   mblk Pointer to the memory block.
+  @param   changed_since Generation number from earlier listing, zero to select all.
+  @return  OS_TRUE if memory block is selected.
 
 ****************************************************************************************************
 */
-void devicedir_append_source_buffer(
-    iocSourceBuffer *sbuf,
-    osalStream list,
-    os_short flags)
+static os_boolean devicedir_mblk_changed(
+    iocMemoryBlock *mblk,
+    os_uint changed_since)
 {
-    /* Check that root object is valid pointer.
-     */
-    osal_debug_assert(sbuf->debug_id == 'S');
-    osal_debug_assert(list != OS_NULL);
-
-    osal_stream_print_str(list, "    {", 0);
-    devicedir_append_int_param(list, "remote_mblk_id", sbuf->remote_mblk_id, OS_TRUE);
-    devicedir_append_int_param(list, "range_set", sbuf->changed.range_set, OS_FALSE);
-    devicedir_append_int_param(list, "changed.start_addr", sbuf->changed.start_addr, OS_FALSE);
-    devicedir_append_int_param(list, "changed.end_addr", sbuf->changed.end_addr, OS_FALSE);
-
-    devicedir_append_int_param(list, "nbytes", sbuf->syncbuf.nbytes, OS_FALSE);
-    devicedir_append_int_param(list, "buf_used", sbuf->syncbuf.used, OS_FALSE);
-
-    devicedir_append_int_param(list, "make_keyframe", sbuf->syncbuf.make_keyframe, OS_FALSE);
-    devicedir_append_int_param(list, "is_keyframe", sbuf->syncbuf.is_keyframe, OS_FALSE);
-    devicedir_append_int_param(list, "start_addr", sbuf->syncbuf.start_addr, OS_FALSE);
-    devicedir_append_int_param(list, "end_addr", sbuf->syncbuf.end_addr, OS_FALSE);
-
-#if IOC_BIDIRECTIONAL_MBLK_CODE
-    if (sbuf->syncbuf.flags & IOC_BIDIRECTIONAL)
-    {
-        osal_stream_print_str(list, ", \"flags\":\"bidirectional\"", 0);
-    }
-#endif
-
-    osal_stream_print_str(list, "}", 0);
+    if (changed_since == 0) return OS_TRUE;
+    if ((os_int)(mblk->link.root->mblk_generation - changed_since) < 0) return OS_TRUE;
+    return (os_boolean)((os_int)(mblk->generation - changed_since) > 0);
 }
+#endif
 
 
 /**
 ****************************************************************************************************
 
-  @brief List source buffers connected to a memory block.
-
-  The devicedir_list_mblks_source_buffers() function appends list of source buffers attached to
-  a memory block to lists in JSON format.
+  @brief Print memory block snapshot as JSON (internal).
 
-  Sync lock must be on when calling this function.
-
-  @param   mblk Pointer to the memory buffer buffer structure.
-  @param   list Steam handle into which to write the list as JSON
-  @param   flags Reserved for future, set 0.
+  @param   ms Pointer to memory block snapshot.
+  @param   list Steam handle into which to write the JSON.
+  @param   pos Position in snapshot, moved to next memory block snapshot.
+  @param   flags Information to display, bit fields: IOC_DEVDIR_DATA, IOC_DEVDIR_BUFFERS.
   @return  None.
 
 ****************************************************************************************************
 */
-void devicedir_list_mblks_source_buffers(
-    iocMemoryBlock *mblk,
+static void devicedir_print_mblk_snapshot(
+    devicedirMblkSnapshot *ms,
     osalStream list,
+    os_char **pos,
     os_short flags)
 {
-    iocSourceBuffer *sbuf;
+    devicedirBufSnapshot *bs;
+    os_char nbuf[OSAL_NBUF_SZ];
+    os_uchar *data;
+    os_short mflags;
+    os_int i;
+    os_boolean isfirst;
+
+    devicedir_append_str_param(list, "mblk_name", ms->mblk_name, OS_TRUE);
+#if IOC_MBLK_SPECIFIC_DEVICE_NAME
+    devicedir_append_str_param(list, "dev_name", ms->device_name, OS_FALSE);
+    devicedir_append_int_param(list, "dev_nr", ms->device_nr, OS_FALSE);
+    devicedir_append_str_param(list, "net_name", ms->network_name, OS_FALSE);
+#endif
+    devicedir_append_int_param(list, "mblk_id", ms->mblk_id, OS_FALSE);
+    devicedir_append_int_param(list, "size", ms->nbytes, OS_FALSE);
+#if IOC_MBLK_COALESCE
+    if (ms->send_interval_ms) {
+        devicedir_append_int_param(list, "send_interval_ms", ms->send_interval_ms, OS_FALSE);
+    }
+    devicedir_append_int_param(list, "syncs", (os_int)ms->sync_count, OS_FALSE);
+    devicedir_append_int_param(list, "coalesced", (os_int)ms->coalesced_count, OS_FALSE);
+#endif
+#if IOC_MBLK_GENERATIONS
+    devicedir_append_int_param(list, "generation", (os_int)ms->generation, OS_FALSE);
+    if (ms->nro_changes > 0)
+    {
+        osal_stream_print_str(list, ", \"changes\": [", 0);
+        for (i = 0; i < ms->nro_changes; i++)
+        {
+            osal_stream_print_str(list, i ? ", [" : "[", 0);
+            osal_int_to_str(nbuf, sizeof(nbuf), ms->changes[i].start_addr);
+            osal_stream_print_str(list, nbuf, 0);
+            osal_stream_print_str(list, ", ", 0);
+            osal_int_to_str(nbuf, sizeof(nbuf), ms->changes[i].end_addr);
+            osal_stream_print_str(list, nbuf, 0);
+            osal_stream_print_str(list, "]", 0);
+        }
+        osal_stream_print_str(list, "]", 0);
+    }
+#endif
 
-    sbuf = mblk->sbuf.first;
-    if (sbuf == OS_NULL) return;
+    osal_stream_print_str(list, ", \"flags\":\"", 0);
+    isfirst = OS_TRUE;
+    mflags = ms->flags;
+    if (mflags & IOC_MBLK_UP) devicedir_append_flag(list, "up", &isfirst);
+    if (mflags & IOC_MBLK_DOWN) devicedir_append_flag(list, "down", &isfirst);
+    if (mflags & IOC_ALLOW_RESIZE) devicedir_append_flag(list, "resize", &isfirst);
+    if (mflags & IOC_STATIC) devicedir_append_flag(list, "static", &isfirst);
+#if IOC_DYNAMIC_MBLK_CODE
+    if (mflags & IOC_DYNAMIC) devicedir_append_flag(list, "dynamic", &isfirst);
+#endif
+#if IOC_BIDIRECTIONAL_MBLK_CODE
+    if (mflags & IOC_BIDIRECTIONAL) devicedir_append_flag(list, "bdsupport", &isfirst);
+#endif
+    if (mflags & IOC_CLOUD_ONLY) devicedir_append_flag(list, "cloud-only", &isfirst);
+    if (mflags & IOC_NO_CLOUD) devicedir_append_flag(list, "no-cloud", &isfirst);
 
-    osal_stream_print_str(list, ",\n  \"sbuf\": [\n", 0);
+    osal_stream_print_str(list, "\"", 0);
 
-    while (sbuf)
+    *pos += sizeof(devicedirMblkSnapshot);
+    if (flags & IOC_DEVDIR_BUFFERS)
     {
-        devicedir_append_source_buffer(sbuf, list, flags);
+        bs = (devicedirBufSnapshot*)*pos;
+        devicedir_print_buf_snapshots("sbuf", devicedir_sbuf_names, bs, ms->nro_sbufs, list);
+        bs += ms->nro_sbufs;
+        devicedir_print_buf_snapshots("tbuf", devicedir_tbuf_names, bs, ms->nro_tbufs, list);
+        bs += ms->nro_tbufs;
+        *pos = (os_char*)bs;
+    }
 
-        sbuf = sbuf->mlink.next;
-        if (sbuf)
+    if (flags & IOC_DEVDIR_DATA)
+    {
+        data = (os_uchar*)*pos;
+        osal_stream_print_str(list, ",\n  \"data\": [\n    ", 0);
+        for (i = 0; i < ms->data_sz; i++)
         {
-            osal_stream_print_str(list, ",", 0);
+            osal_int_to_str(nbuf, sizeof(nbuf), data[i]);
+            osal_stream_print_str(list, nbuf, 0);
+
+            if (i + 1 < ms->data_sz)
+            {
+                if (((i + 1) % 32) == 0)
+                    osal_stream_print_str(list, ",\n    ", 0);
+                else
+                    osal_stream_print_str(list, ", ", 0);
+            }
         }
-        osal_stream_print_str(list, "\n", 0);
+        osal_stream_print_str(list, "\n  ]\n", 0);
+        *pos += DEVICEDIR_ALIGN(ms->data_sz);
     }
-
-    osal_stream_print_str(list, "  ]", 0);
 }
 
 
 /**
 ****************************************************************************************************
 
-  @brief Append memory block content as binary.
-
-  The devicedir_append_mblk_binary() function...
+  @brief Print source or target buffer snapshots as JSON list (internal).
 
-  Sync lock must be on when calling this function.
-
-  @param   mblk Pointer to the memory buffer buffer structure.
-  @param   list Steam handle into which to write the JSON output.
-  @param   flags Reserved for future, set 0.
+  @param   list_name Either "sbuf" or "tbuf".
+  @param   names Names for values in buffer snapshot, OS_NULL terminated.
+  @param   bs Pointer to first buffer snapshot.
+  @param   n Number of buffer snapshots.
+  @param   list Steam handle into which to write the JSON.
   @return  None.
 
 ****************************************************************************************************
 */
-void devicedir_append_mblk_binary(
-    iocMemoryBlock *mblk,
-    osalStream list,
-    os_short flags)
+static void devicedir_print_buf_snapshots(
+    const os_char *list_name,
+    const os_char * const *names,
+    devicedirBufSnapshot *bs,
+    os_int n,
+    osalStream list)
 {
-    os_uchar *buf;
-    os_char nbuf[OSAL_NBUF_SZ];
-    os_int nbytes, i;
+    os_int i, j;
 
-    buf = (os_uchar*)mblk->buf;
-    nbytes = mblk->nbytes;
+    if (n <= 0) return;
 
-    osal_stream_print_str(list, ",\n  \"data\": [\n    ", 0);
+    osal_stream_print_str(list, ",\n  \"", 0);
+    osal_stream_print_str(list, list_name, 0);
+    osal_stream_print_str(list, "\": [\n", 0);
 
-    for (i = 0; i<nbytes; i++)
+    for (i = 0; i < n; i++, bs++)
     {
-        osal_int_to_str(nbuf, sizeof(nbuf), (os_uchar)buf[i]);
-        osal_stream_print_str(list, nbuf, 0);
-
-        if (i + 1 < nbytes)
+        osal_stream_print_str(list, "    {", 0);
+        devicedir_append_int_param(list, "remote_mblk_id", bs->remote_mblk_id, OS_TRUE);
+        for (j = 0; j < DEVICEDIR_BUF_NVALUES && names[j]; j++) {
+            devicedir_append_int_param(list, names[j], bs->value[j], OS_FALSE);
+        }
+        if (bs->bidirectional)
         {
-            if (((i + 1) % 32) == 0)
-                osal_stream_print_str(list, ",\n    ", 0);
-            else
-                osal_stream_print_str(list, ", ", 0);
+            osal_stream_print_str(list, ", \"flags\":\"bidirectional\"", 0);
         }
+        osal_stream_print_str(list, i + 1 < n ? "}," : "}", 0);
+        osal_stream_print_str(list, "\n", 0);
     }
 
-    osal_stream_print_str(list, "\n  ]\n", 0);
+    osal_stream_print_str(list, "  ]", 0);
 }
 
 
@@ -34,6 +34,39 @@
 */
 #define IOC_HELP_MODE 4
 
+/* Query to select and page items listed by devicedir_query_*() functions. Listing is
+   printed from a snapshot taken under ioc_lock, so large lists can be inspected
+   page by page without holding back communication.
+ */
+typedef struct devicedirQuery
+{
+    /* IO path to select items, like "tempctrl1.cafenet". OS_NULL or empty string
+       to list all.
+     */
+    const os_char *iopath;
+
+    /* Index of first matching item to list, 0 for first page. If more items match
+       than listed, JSON contains "next" index for the following page.
+     */
+    os_int first;
+
+    /* Maximum number of items to list, 0 for no limit.
+     */
+    os_int max_items;
+
+    /* Information to display, bit fields: IOC_DEVDIR_DEFAULT, IOC_DEVDIR_DATA,
+       IOC_DEVDIR_BUFFERS.
+     */
+    os_short flags;
+
+    /* Memory block generation number from "generation" of earlier listing. If nonzero,
+       only memory blocks changed since are listed, with changed address ranges. Ignored
+       if IOC_MBLK_GENERATIONS is not enabled.
+     */
+    os_uint changed_since;
+}
+devicedirQuery;
+
 void devicedir_connections(
     iocRoot *root,
     osalStream list,
@@ -54,20 +87,10 @@ void devicedir_memory_blocks(
     const os_char *iopath,
     os_short flags);
 
-void devicedir_list_mblks_target_buffers(
-    iocMemoryBlock *mblk,
-    osalStream list,
-    os_short flags);
-
-void devicedir_list_mblks_source_buffers(
-    iocMemoryBlock *mblk,
-    osalStream list,
-    os_short flags);
-
-void devicedir_append_mblk_binary(
-    iocMemoryBlock *mblk,
+void devicedir_query_memory_blocks(
+    iocRoot *root,
     osalStream list,
-    os_short flags);
+    const devicedirQuery *query);
 
 #if OSAL_JSON_TEXT_SUPPORT
 osalStatus devicedir_static_mblk_to_json(
@@ -103,6 +126,11 @@ void devicedir_dynamic_signals(
     const os_char *iopath,
     os_short flags);
 
+void devicedir_query_dynamic_signals(
+    iocRoot *root,
+    osalStream list,
+    const devicedirQuery *query);
+
 void devicedir_info(
     iocRoot *root,
     osalStream list,
@@ -61,7 +61,8 @@ iocDynamicNetwork *ioc_initialize_dynamic_network(
   @anchor ioc_release_dynamic_network
 
   The ioc_release_dynamic_network() function releases memory allocated for dynamic IO network
-  structure, and memory allocated for dynamic IO signal and memory block shortcuts.
+  structure, and memory allocated for dynamic IO signals, interned names and memory block
+  shortcuts.
   Synchronization ioc_lock() must be on when this function is called.
 
   @param   dnetwork Pointer to dynamic network structure to release. If OS_NULL, the function
@@ -73,21 +74,18 @@ iocDynamicNetwork *ioc_initialize_dynamic_network(
 void ioc_release_dynamic_network(
     iocDynamicNetwork *dnetwork)
 {
-    iocDynamicSignal *dsignal, *next_dsignal;
-    os_int i;
+    iocDynamicSignalBlock *block, *next_block;
 
     if (dnetwork == OS_NULL) return;
 
-    for (i = 0; i < IOC_DNETWORK_HASH_TAB_SZ; i++)
+    /* Signals are not released one by one: Free signal blocks and all interned names.
+     */
+    for (block = dnetwork->signal_blocks; block; block = next_block)
     {
-        for (dsignal = dnetwork->hash[i];
-             dsignal;
-             dsignal = next_dsignal)
-        {
-            next_dsignal = dsignal->next;
-            ioc_release_dynamic_signal(dsignal);
-        }
+        next_block = block->next;
+        os_free(block, sizeof(iocDynamicSignalBlock));
     }
+    ioc_release_string_pool(&dnetwork->strings);
 
     while (dnetwork->mlist_first)
     {
@@ -139,10 +137,17 @@ iocDynamicSignal *ioc_add_dynamic_signal(
     os_char flags)
 {
     iocDynamicSignal *dsignal, *prev_dsignal;
+    const os_char *p_signal_name, *p_mblk_name, *p_device_name;
     os_uint hash_ix;
 
-    /* If we have existing IO network with this name,
-       just return pointer to it.
+    /* Names are interned, so existing signal with same names has the same name pointers.
+       If any of names is not in string pool, there cannot be matching signal.
+     */
+    p_signal_name = ioc_find_interned_string(&dnetwork->strings, signal_name);
+    p_mblk_name = ioc_find_interned_string(&dnetwork->strings, mblk_name);
+    p_device_name = ioc_find_interned_string(&dnetwork->strings, device_name);
+
+    /* If we have existing signal with these names, just return pointer to it.
      */
     hash_ix = ioc_hash(signal_name) % IOC_DNETWORK_HASH_TAB_SZ;
     prev_dsignal = OS_NULL;
@@ -150,26 +155,21 @@ iocDynamicSignal *ioc_add_dynamic_signal(
          dsignal;
          dsignal = dsignal->next)
     {
-        if (!os_strcmp(signal_name, dsignal->signal_name))
+        if (dsignal->signal_name == p_signal_name &&
+            dsignal->mblk_name == p_mblk_name &&
+            dsignal->device_name == p_device_name &&
+            dsignal->device_nr == device_nr)
         {
-            if (!os_strcmp(mblk_name, dsignal->mblk_name) &&
-                !os_strcmp(device_name, dsignal->device_name) &&
-                device_nr == dsignal->device_nr)
-            {
-                return dsignal;
-            }
+            return dsignal;
         }
 
         prev_dsignal = dsignal;
     }
 
-    /* Allocate and initialize a new IO network object.
+    /* Allocate and initialize a new dynamic signal.
      */
-    dsignal = ioc_initialize_dynamic_signal(signal_name);
+    dsignal = ioc_initialize_dynamic_signal(dnetwork, signal_name, mblk_name, device_name);
     if (dsignal == OS_NULL) return OS_NULL;
-    dsignal->dnetwork = dnetwork;
-    os_strncpy(dsignal->mblk_name, mblk_name, IOC_NAME_SZ);
-    os_strncpy(dsignal->device_name, device_name, IOC_NAME_SZ);
     dsignal->device_nr = device_nr;
     dsignal->addr = addr;
     dsignal->n = n;
@@ -212,38 +212,37 @@ iocDynamicSignal *ioc_find_dynamic_signal(
     iocIdentifiers *identifiers)
 {
     os_uint hash_ix;
-    iocDynamicSignal *dsignal = OS_NULL;
+    iocDynamicSignal *dsignal;
+    const os_char *p_signal_name, *p_mblk_name, *p_device_name;
 
-    while (OS_TRUE)
+    /* Convert names to interned pointers. If a name given as identifier is not in
+       string pool, no signal can match.
+     */
+    p_signal_name = ioc_find_interned_string(&dnetwork->strings, identifiers->signal_name);
+    if (p_signal_name == OS_NULL) return OS_NULL;
+    p_mblk_name = p_device_name = OS_NULL;
+    if (identifiers->mblk_name[0] != '\0')
     {
-        if (dsignal)
-        {
-            dsignal = dsignal->next;
-        }
-        else
-        {
-            hash_ix = ioc_hash(identifiers->signal_name) % IOC_DNETWORK_HASH_TAB_SZ;
-            dsignal = dnetwork->hash[hash_ix];
-        }
-        if (dsignal == OS_NULL) break;
+        p_mblk_name = ioc_find_interned_string(&dnetwork->strings, identifiers->mblk_name);
+        if (p_mblk_name == OS_NULL) return OS_NULL;
+    }
+    if (identifiers->device_name[0] != '\0')
+    {
+        p_device_name = ioc_find_interned_string(&dnetwork->strings, identifiers->device_name);
+        if (p_device_name == OS_NULL) return OS_NULL;
+    }
 
-        if (!os_strcmp(identifiers->signal_name, dsignal->signal_name))
-        {
-            if (identifiers->mblk_name[0] != '\0')
-            {
-                if (os_strcmp(identifiers->mblk_name, dsignal->mblk_name)) continue;
-            }
-            if (identifiers->device_name[0] != '\0')
-            {
-                if (os_strcmp(identifiers->device_name, dsignal->device_name)) continue;
-            }
-            if (identifiers->device_nr)
-            {
-                if (identifiers->device_nr != dsignal->device_nr) continue;
-            }
+    hash_ix = ioc_hash(identifiers->signal_name) % IOC_DNETWORK_HASH_TAB_SZ;
+    for (dsignal = dnetwork->hash[hash_ix];
+         dsignal;
+         dsignal = dsignal->next)
+    {
+        if (dsignal->signal_name != p_signal_name) continue;
+        if (p_mblk_name && dsignal->mblk_name != p_mblk_name) continue;
+        if (p_device_name && dsignal->device_name != p_device_name) continue;
+        if (identifiers->device_nr && dsignal->device_nr != identifiers->device_nr) continue;
 
-            return dsignal;
-        }
+        return dsignal;
     }
 
     return OS_NULL;
@@ -274,6 +273,8 @@ void ioc_network_mblk_is_deleted(
 {
     iocRoot *root;
     iocDynamicSignal *dsignal, *prev_dsignal, *next_dsignal;
+    const os_char *p_mblk_name, *p_device_name;
+    os_uint device_nr;
     os_int i;
 
     root = mblk->link.root;
@@ -285,7 +286,19 @@ void ioc_network_mblk_is_deleted(
         ioc_new_root_event(root, IOC_DEVICE_DISCONNECTED, dnetwork, mblk, root->callback_context);
     }
 
-    for (i = 0; i < IOC_DNETWORK_HASH_TAB_SZ; i++)
+    /* Compare interned name pointers. If names are not in string pool, this memory
+       block has no signals.
+     */
+#if IOC_MBLK_SPECIFIC_DEVICE_NAME
+    p_device_name = ioc_find_interned_string(&dnetwork->strings, mblk->device_name);
+    device_nr = mblk->device_nr;
+#else
+    p_device_name = ioc_find_interned_string(&dnetwork->strings, root->device_name);
+    device_nr = root->device_nr;
+#endif
+    p_mblk_name = ioc_find_interned_string(&dnetwork->strings, mblk->mblk_name);
+
+    for (i = 0; i < IOC_DNETWORK_HASH_TAB_SZ && p_mblk_name && p_device_name; i++)
     {
         prev_dsignal = OS_NULL;
         for (dsignal = dnetwork->hash[i];
@@ -294,15 +307,9 @@ void ioc_network_mblk_is_deleted(
         {
             next_dsignal = dsignal->next;
 
-#if IOC_MBLK_SPECIFIC_DEVICE_NAME
-            if (!os_strcmp(dsignal->mblk_name, mblk->mblk_name) &&
-                !os_strcmp(dsignal->device_name, mblk->device_name) &&
-                dsignal->device_nr == mblk->device_nr)
-#else
-            if (!os_strcmp(dsignal->mblk_name, mblk->mblk_name) &&
-                !os_strcmp(dsignal->device_name, root->device_name) &&
-                dsignal->device_nr == root->device_nr)
-#endif
+            if (dsignal->mblk_name == p_mblk_name &&
+                dsignal->device_name == p_device_name &&
+                dsignal->device_nr == device_nr)
             {
                 if (prev_dsignal) prev_dsignal->next = dsignal->next;
                 else dnetwork->hash[i] = dsignal->next;
@@ -331,4 +338,33 @@ void ioc_network_mblk_is_deleted(
     }
 }
 
+
+/**
+****************************************************************************************************
+
+  @brief Get memory used by dynamic network.
+  @anchor ioc_dynamic_network_memory_use
+
+  The ioc_dynamic_network_memory_use() function adds number of signals and interned names,
+  and memory allocated for these, to memory use structure. This is used to report footprint
+  of dynamic information, see ioc_dynamic_memory_use(). Memory block shortcuts are not
+  included. Synchronization ioc_lock() must be on when this function is called.
+
+  @param   dnetwork Pointer to dynamic network structure.
+  @param   use Pointer to memory use structure to add to.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_dynamic_network_memory_use(
+    iocDynamicNetwork *dnetwork,
+    iocDynamicMemoryUse *use)
+{
+    use->nro_signals += dnetwork->nro_signals;
+    use->signal_bytes += dnetwork->nro_signal_blocks * (os_memsz)sizeof(iocDynamicSignalBlock);
+    use->nro_strings += dnetwork->strings.count;
+    use->string_bytes += ioc_string_pool_memory_use(&dnetwork->strings);
+    use->network_bytes += sizeof(iocDynamicNetwork);
+}
+
 #endif
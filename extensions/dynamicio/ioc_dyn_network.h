@@ -30,6 +30,65 @@ struct iocMblkShortcut;
  */
 #define IOC_DNETWORK_HASH_TAB_SZ 64
 
+/** Number of dynamic signal structures allocated at once. Signals are allocated in blocks
+    to avoid per signal allocation overhead and to keep a network's signals close together.
+ */
+#ifndef IOC_DSIGNAL_BLOCK_SZ
+#if OSAL_MICROCONTROLLER
+#define IOC_DSIGNAL_BLOCK_SZ 8
+#else
+#define IOC_DSIGNAL_BLOCK_SZ 64
+#endif
+#endif
+
+
+/**
+****************************************************************************************************
+  Block of dynamic signal structures.
+****************************************************************************************************
+*/
+typedef struct iocDynamicSignalBlock
+{
+    /** Next block allocated for the same network.
+     */
+    struct iocDynamicSignalBlock *next;
+
+    /** Signal structures.
+     */
+    iocDynamicSignal signal[IOC_DSIGNAL_BLOCK_SZ];
+}
+iocDynamicSignalBlock;
+
+
+/**
+****************************************************************************************************
+  Memory used by dynamic information, see ioc_dynamic_network_memory_use().
+****************************************************************************************************
+*/
+typedef struct iocDynamicMemoryUse
+{
+    /** Number of dynamic signals in use.
+     */
+    os_int nro_signals;
+
+    /** Bytes allocated for signal blocks, including unused signal structures.
+     */
+    os_memsz signal_bytes;
+
+    /** Number of distinct interned names.
+     */
+    os_int nro_strings;
+
+    /** Bytes allocated for interned names and string pool hash table.
+     */
+    os_memsz string_bytes;
+
+    /** Bytes allocated for dynamic network structures.
+     */
+    os_memsz network_bytes;
+}
+iocDynamicMemoryUse;
+
 
 /**
 ****************************************************************************************************
@@ -42,6 +101,18 @@ typedef struct iocDynamicNetwork
 
     iocDynamicSignal *hash[IOC_DNETWORK_HASH_TAB_SZ];
 
+    /** Signal, memory block and device names of this network's signals.
+     */
+    iocStringPool strings;
+
+    /** Blocks of signal structures, list of free signal structures within the blocks,
+        number of blocks and number of signals in use.
+     */
+    iocDynamicSignalBlock *signal_blocks;
+    iocDynamicSignal *free_signal;
+    os_int nro_signal_blocks;
+    os_int nro_signals;
+
     /* Set to TRUE when new dynamic network structure is allocated. Set to false, once
        application has been informed about the new network.
      */
@@ -96,5 +167,11 @@ void ioc_network_mblk_is_deleted(
     iocDynamicNetwork *dnetwork,
     iocMemoryBlock *mblk);
 
+/* Add memory used by dynamic network to memory use structure.
+ */
+void ioc_dynamic_network_memory_use(
+    iocDynamicNetwork *dnetwork,
+    iocDynamicMemoryUse *use);
+
 #endif
 #endif
@@ -14,6 +14,10 @@
   to avoid challenges with application being called by different thread.
   with callbacks.
 
+  Events are stored in preallocated ring buffer. Communication side queues events with
+  ioc_lock on and moves only the tail index, application drains events without lock and
+  moves only the head index.
+
   Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
   modified, and distributed under the terms of the project licensing. By continuing to use, modify,
   or distribute this file you indicate that you have read the license and understand and accept
@@ -24,6 +28,18 @@
 #include "iocom.h"
 #if IOC_DYNAMIC_MBLK_CODE
 
+/* MemoryBarrier() for ioc_event_queue_barrier() with Microsoft compiler.
+ */
+#if defined(_MSC_VER) && !defined(__clang__) && !defined(__GNUC__)
+#include <windows.h>
+#endif
+
+/* Forward referred static functions.
+ */
+static os_boolean ioc_coalesce_event(
+    iocEventQueue *queue,
+    iocQueuedEvent *e);
+
 /**
 ****************************************************************************************************
 
@@ -41,7 +57,7 @@
   @param   flags Which communication events we wish to queue, bits: IOC_MBLK_EVENTS,
            IOC_DEVICE_EVENTS, IOC_NETWORK_EVENTS.
   @return  OSAL_SUCCESS to indicate success or OSAL_STATUS_MEMORY_ALLOCATION_FAILED if
-           memory allocation has failed.
+           memory allocation has failed. Ring buffer for max_events is allocated here.
 
 ****************************************************************************************************
 */
@@ -67,7 +83,16 @@ osalStatus ioc_initialize_event_queue(
     queue->root = root;
     queue->event = event;
     queue->flags = flags;
-    queue->max_nro_events = max_nro_events ? max_nro_events : 1000;
+    queue->max_nro_events = max_nro_events > 0 ? max_nro_events : 1000;
+
+    queue->sz = queue->max_nro_events + 1;
+    queue->ring = (iocQueuedEvent*)os_malloc(queue->sz * sizeof(iocQueuedEvent), OS_NULL);
+    if (queue->ring == OS_NULL)
+    {
+        os_free(queue, sizeof(iocEventQueue));
+        ioc_unlock(root);
+        return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+    }
     root->event_queue = queue;
 
     ioc_unlock(root);
@@ -102,11 +127,7 @@ void ioc_release_event_queue(
         return;
     }
 
-    while (queue->first)
-    {
-        ioc_pop_event(root);
-    }
-
+    os_free(queue->ring, queue->sz * sizeof(iocQueuedEvent));
     os_free(queue, sizeof(iocEventQueue));
     root->event_queue = OS_NULL;
 
@@ -119,8 +140,11 @@ void ioc_release_event_queue(
 
   @brief Queue a communication event to inform application about it.
 
-  The ioc_queue_event() function creates a new communication event into queue and sets
-  application defined OS event (if not NULL) to trigger the application.
+  The ioc_queue_event() function stores a new communication event into queue and sets
+  application defined OS event (if not NULL) to trigger the application. No memory is
+  allocated: The event is written to free slot of the ring buffer and then the tail
+  index is moved. If the ring buffer is full, the event is coalesced into a queued
+  duplicate, if any, or dropped.
 
   ioc_lock must be on when calling this function.
 
@@ -130,8 +154,8 @@ void ioc_release_event_queue(
   @param   device_name Device name.
   @param   device_nr Device number.
   @param   mblk_name Memory block name.
-  @return  OSAL_SUCCESS if successful. Other values indicate an error (out of memory or
-           queue overflow).
+  @return  OSAL_SUCCESS if successful or event was coalesced into a duplicate.
+           OSAL_STATUS_FAILED if queue overflow.
 
 ****************************************************************************************************
 */
@@ -145,6 +169,7 @@ osalStatus ioc_queue_event(
 {
     iocEventQueue *queue;
     iocQueuedEvent *e;
+    os_int tail, next_tail;
 
     queue = root->event_queue;
 
@@ -175,21 +200,11 @@ osalStatus ioc_queue_event(
             break;
     }
 
-    if (queue->event_count >= queue->max_nro_events)
-    {
-        osal_debug_error("Communication event queue overflow.");
-        return OSAL_STATUS_FAILED;
-    }
-    queue->event_count++;
-
-    /* Allocate new event structure and fill it.
+    /* Fill in the slot at tail. This slot is not visible to application until the tail
+       index is moved, and it is never in use even when the ring buffer is full.
      */
-    e = (iocQueuedEvent*)os_malloc(sizeof(iocQueuedEvent), OS_NULL);
-    if (e == OS_NULL)
-    {
-        ioc_unlock(root);
-        return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
-    }
+    tail = queue->tail;
+    e = queue->ring + tail;
     os_memclear(e, sizeof(iocQueuedEvent));
     e->event = event;
     os_strncpy(e->network_name, network_name, IOC_NETWORK_NAME_SZ);
@@ -197,15 +212,26 @@ osalStatus ioc_queue_event(
     e->device_nr = device_nr;
     os_strncpy(e->mblk_name, mblk_name, IOC_NAME_SZ);
 
-    if (queue->last)
+    next_tail = tail + 1;
+    if (next_tail >= queue->sz) next_tail = 0;
+    if (next_tail == queue->head)
     {
-        queue->last->next = e;
-    }
-    else
-    {
-        queue->first = e;
+        if (ioc_coalesce_event(queue, e))
+        {
+            queue->coalesced++;
+            return OSAL_SUCCESS;
+        }
+        if (queue->dropped++ == 0)
+        {
+            osal_debug_error("Communication event queue overflow.");
+        }
+        return OSAL_STATUS_FAILED;
     }
-    queue->last = e;
+
+    /* Publish the event.
+     */
+    ioc_event_queue_barrier();
+    queue->tail = next_tail;
 
     if (queue->event)
     {
@@ -221,8 +247,9 @@ osalStatus ioc_queue_event(
 
   @brief Get oldest communication event in queue.
 
-  The ioc_release_event_queue() function returns pointer to next event to be processed but
-  does not remove it from the queue.
+  The ioc_get_event() function returns pointer to next event to be processed but
+  does not remove it from the queue. The event stays valid until ioc_pop_event() is called.
+  Only one application thread may process events.
 
   @param   root Pointer to IOCOM root object.
   @return  Pointer to communication event structure, OS_NULL if no events in queue.
@@ -233,19 +260,15 @@ iocQueuedEvent *ioc_get_event(
     iocRoot *root)
 {
     iocEventQueue *queue;
-    iocQueuedEvent *e;
+    os_int head;
 
-    ioc_lock(root);
     queue = root->event_queue;
+    if (queue == OS_NULL) return OS_NULL;
 
-    if (queue == OS_NULL)
-    {
-        ioc_unlock(root);
-        return OS_NULL;
-    }
-    e = queue->first;
-    ioc_unlock(root);
-    return e;
+    head = queue->head;
+    if (head == queue->tail) return OS_NULL;
+    ioc_event_queue_barrier();
+    return queue->ring + head;
 }
 
 
@@ -254,7 +277,7 @@ iocQueuedEvent *ioc_get_event(
 
   @brief Remove oldest communication event in queue.
 
-  The ioc_release_event_queue() function pops event away from queue. Called after processing
+  The ioc_pop_event() function pops event away from queue. Called after processing
   event returned by ioc_get_event().
 
   @param   root Pointer to IOCOM root object.
@@ -266,36 +289,128 @@ os_boolean ioc_pop_event(
     iocRoot *root)
 {
     iocEventQueue *queue;
-    iocQueuedEvent *e;
-    os_boolean is_empty;
+    os_int head;
 
-    ioc_lock(root);
     queue = root->event_queue;
+    if (queue == OS_NULL) return OS_TRUE;
+
+    head = queue->head;
+    if (head == queue->tail) return OS_TRUE;
 
-    e = queue->first;
-    osal_debug_assert(e != OS_NULL);
-    queue->first = e->next;
-    if (e->next == OS_NULL)
+    if (++head >= queue->sz) head = 0;
+    ioc_event_queue_barrier();
+    queue->head = head;
+
+    if (head == queue->tail) return OS_TRUE;
+
+    if (queue->event)
     {
-        queue->last = OS_NULL;
-        is_empty = OS_TRUE;
+        osal_event_set(queue->event);
     }
-    else
+    return OS_FALSE;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get and remove many communication events at once.
+
+  The ioc_get_events() function copies up to max_events oldest events from queue into events
+  array, oldest first, and removes them from the queue. This is faster than ioc_get_event()
+  and ioc_pop_event() per event when device storm has queued lots of events. If events are
+  left in queue, the application's OS event is set.
+
+  @param   root Pointer to IOCOM root object.
+  @param   events Where to store the events.
+  @param   max_events Size of events array.
+  @return  Number of events stored, zero if queue is empty.
+
+****************************************************************************************************
+*/
+os_int ioc_get_events(
+    iocRoot *root,
+    iocQueuedEvent *events,
+    os_int max_events)
+{
+    iocEventQueue *queue;
+    os_int head, tail, n;
+
+    queue = root->event_queue;
+    if (queue == OS_NULL) return 0;
+
+    head = queue->head;
+    tail = queue->tail;
+    ioc_event_queue_barrier();
+
+    n = 0;
+    while (head != tail && n < max_events)
     {
-        is_empty = OS_FALSE;
+        events[n++] = queue->ring[head];
+        if (++head >= queue->sz) head = 0;
     }
 
-    os_free(e, sizeof(iocQueuedEvent));
-    queue->event_count--;
-
-    if (queue->event)
+    if (n)
     {
-        osal_event_set(queue->event);
+        ioc_event_queue_barrier();
+        queue->head = head;
+
+        if (head != queue->tail && queue->event)
+        {
+            osal_event_set(queue->event);
+        }
     }
+    return n;
+}
 
-    ioc_unlock(root);
 
-    return is_empty;
+/**
+****************************************************************************************************
+
+  @brief Coalesce event into queued duplicate.
+
+  The ioc_coalesce_event() function is called when the ring buffer is full. It finds the
+  newest queued event for the same network, device and memory block which is not yet
+  processed by the application. If that event is the same as the new one, the new event is
+  not needed. Older events for the same object are never looked at: For example a new
+  memory block event after queued "new memory block, memory block deleted" sequence
+  must not be coalesced into the first event, or application would see the memory
+  block deleted. Queued events are only read, so application may process them at the
+  same time.
+
+  ioc_lock must be on when calling this function.
+
+  @param   queue Pointer to event queue.
+  @param   e New event, filled in slot at tail.
+  @return  OS_TRUE if duplicate was found, OS_FALSE if not.
+
+****************************************************************************************************
+*/
+static os_boolean ioc_coalesce_event(
+    iocEventQueue *queue,
+    iocQueuedEvent *e)
+{
+    iocQueuedEvent *q;
+    os_int i, head;
+
+    /* Search from the newest, duplicates of storm events are most likely there.
+       Stop at the first event for the same object.
+     */
+    head = queue->head;
+    i = queue->tail;
+    while (i != head)
+    {
+        if (--i < 0) i = queue->sz - 1;
+        q = queue->ring + i;
+        if (q->device_nr == e->device_nr &&
+            !os_strcmp(q->mblk_name, e->mblk_name) &&
+            !os_strcmp(q->device_name, e->device_name) &&
+            !os_strcmp(q->network_name, e->network_name))
+        {
+            return (os_boolean)(q->event == e->event);
+        }
+    }
+    return OS_FALSE;
 }
 
 #endif
@@ -14,6 +14,13 @@
   to avoid challenges with application being called by different thread.
   with callbacks.
 
+  The queue is a ring buffer preallocated by ioc_initialize_event_queue(), so queueing an event
+  never allocates memory. Events are queued by communication side with ioc_lock on, and
+  drained by one application thread without the lock: the communication side only moves
+  the tail index and application only the head index. If the ring is full, a new event which
+  is the same as the newest queued event for the same network, device and memory block is
+  coalesced into it. Application can drain many events at once by ioc_get_events().
+
   Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
   modified, and distributed under the terms of the project licensing. By continuing to use, modify,
   or distribute this file you indicate that you have read the license and understand and accept 
@@ -51,14 +58,24 @@ typedef struct iocQueuedEvent
     /** Memory block name.
      */
     os_char mblk_name[IOC_NAME_SZ];
-    
-    /* Pointer to next event in queue
-     */
-    struct iocQueuedEvent *next;
 }
 iocQueuedEvent;
 
 
+/* Memory barrier between writing/reading a queue slot and moving head or tail index.
+   MemoryBarrier() is from windows.h, included by ioc_dyn_queue.c.
+ */
+#ifndef ioc_event_queue_barrier
+#if defined(__GNUC__) || defined(__clang__)
+#define ioc_event_queue_barrier() __sync_synchronize()
+#elif defined(_MSC_VER)
+#define ioc_event_queue_barrier() MemoryBarrier()
+#else
+#define ioc_event_queue_barrier()
+#endif
+#endif
+
+
 /**
 ****************************************************************************************************
   Communication event queue structure
@@ -70,9 +87,20 @@ typedef struct iocEventQueue
      */
     iocRoot *root;
 
-    /** First and last event in the queue. Last is the newest.
+    /** Ring buffer of queued events, sz slots. One slot is always left unused to tell
+        full queue from empty one.
      */
-    iocQueuedEvent *first, *last;
+    iocQueuedEvent *ring;
+    os_int sz;
+
+    /** Index of the oldest queued event, moved only by application when it pops events.
+     */
+    volatile os_int head;
+
+    /** Index of the slot for next event, moved only by communication side when it
+        queues an event.
+     */
+    volatile os_int tail;
 
     /** Operating system event to set when new event is
         placed into queue.
@@ -84,16 +112,16 @@ typedef struct iocEventQueue
      */
     os_int flags;
     
-    /** Number of events queued at the moment.
+    /** Maximum number of events to queue. Ring buffer is allocated for this many
+        events when the queue is initialized.
      */
-    os_int event_count;
+    os_int max_nro_events;
 
-    /** Maximum number of events to queue. This should be quite
-        a big number which never is reached. Limit is there
-        just to avoid allocating all memory of application doesn't
-        process the events.
+    /** Number of events coalesced into duplicate and number of events dropped because
+        the ring buffer was full.
      */
-    os_int max_nro_events;
+    os_long coalesced;
+    os_long dropped;
 }
 iocEventQueue;
 
@@ -148,5 +176,12 @@ iocQueuedEvent *ioc_get_event(
 os_boolean ioc_pop_event(
     iocRoot *root);
 
+/* Copy up to max_events events from queue and remove them.
+ */
+os_int ioc_get_events(
+    iocRoot *root,
+    iocQueuedEvent *events,
+    os_int max_events);
+
 #endif
 #endif
@@ -312,6 +312,46 @@ iocDynamicNetwork *ioc_find_dynamic_network(
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Get memory used by dynamic signal information.
+  @anchor ioc_dynamic_memory_use
+
+  The ioc_dynamic_memory_use() function reports number of dynamic signals and distinct interned
+  names, and bytes allocated for these, summed over all IO device networks. This can be used
+  to monitor memory footprint of dynamic information on large installations.
+
+  @param   droot Pointer to dynamic information root structure.
+  @param   use Pointer to memory use structure to set.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_dynamic_memory_use(
+    iocDynamicRoot *droot,
+    iocDynamicMemoryUse *use)
+{
+    iocDynamicNetwork *dnetwork;
+    os_int i;
+
+    os_memclear(use, sizeof(iocDynamicMemoryUse));
+    if (droot == OS_NULL) return;
+
+    ioc_lock(droot->root);
+    for (i = 0; i < IOC_DROOT_HASH_TAB_SZ; i++)
+    {
+        for (dnetwork = droot->hash[i];
+             dnetwork;
+             dnetwork = dnetwork->next)
+        {
+            ioc_dynamic_network_memory_use(dnetwork, use);
+        }
+    }
+    ioc_unlock(droot->root);
+}
+
+
 /**
 ****************************************************************************************************
 
@@ -101,6 +101,12 @@ void ioc_dynamic_mblk_is_deleted(
     iocDynamicRoot *droot,
     iocMemoryBlock *mblk);
 
+/* Get memory used by dynamic signal information of all networks.
+ */
+void ioc_dynamic_memory_use(
+    iocDynamicRoot *droot,
+    iocDynamicMemoryUse *use);
+
 /* Calculate hash index for the key.
  */
 os_uint ioc_hash(
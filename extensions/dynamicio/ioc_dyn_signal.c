@@ -34,33 +34,61 @@ static void ioc_setup_signal(
   @brief Allocate and initialize dynamic signal structure.
   @anchor ioc_initialize_dynamic_signal
 
-  The ioc_initialize_dynamic_signal() function allocates new dynamic signal structure and
-  stores signal name for it. This function doesn't join allocated structure to any top
-  level structure.
+  The ioc_initialize_dynamic_signal() function takes a dynamic signal structure from network's
+  free list, allocating a new block of IOC_DSIGNAL_BLOCK_SZ signals if the list is empty.
+  Signal, memory block and device names are interned in network's string pool. This function
+  doesn't join the signal to network's hash table.
 
+  @param   dnetwork Pointer to dynamic network structure.
   @param   signal_name Name of the new signal.
+  @param   mblk_name Memory block name.
+  @param   device_name Device name.
   @return  Pointer to dynamic signal structure, or OS_NULL if memory allocation failed.
 
 ****************************************************************************************************
 */
 iocDynamicSignal *ioc_initialize_dynamic_signal(
-    const os_char *signal_name)
+    struct iocDynamicNetwork *dnetwork,
+    const os_char *signal_name,
+    const os_char *mblk_name,
+    const os_char *device_name)
 {
     iocDynamicSignal *dsignal;
-    os_memsz sz;
+    iocDynamicSignalBlock *block;
+    os_int i;
 
-    dsignal = (iocDynamicSignal*)os_malloc(sizeof(iocDynamicSignal), OS_NULL);
-    if (dsignal == OS_NULL) return OS_NULL;
+    if (dnetwork->free_signal == OS_NULL)
+    {
+        block = (iocDynamicSignalBlock*)os_malloc(sizeof(iocDynamicSignalBlock), OS_NULL);
+        if (block == OS_NULL) return OS_NULL;
+        block->next = dnetwork->signal_blocks;
+        dnetwork->signal_blocks = block;
+        dnetwork->nro_signal_blocks++;
+
+        for (i = IOC_DSIGNAL_BLOCK_SZ - 1; i >= 0; i--)
+        {
+            block->signal[i].next = dnetwork->free_signal;
+            dnetwork->free_signal = block->signal + i;
+        }
+    }
+
+    dsignal = dnetwork->free_signal;
+    dnetwork->free_signal = dsignal->next;
     os_memclear(dsignal, sizeof(iocDynamicSignal));
+    dsignal->dnetwork = dnetwork;
+
+    dsignal->signal_name = ioc_intern_string(&dnetwork->strings, signal_name);
+    dsignal->mblk_name = ioc_intern_string(&dnetwork->strings, mblk_name);
+    dsignal->device_name = ioc_intern_string(&dnetwork->strings, device_name);
+    dnetwork->nro_signals++;
 
-    sz = os_strlen(signal_name);
-    dsignal->signal_name = os_malloc(sz, OS_NULL);
-    if (dsignal->signal_name == OS_NULL)
+    if (dsignal->signal_name == OS_NULL ||
+        dsignal->mblk_name == OS_NULL ||
+        dsignal->device_name == OS_NULL)
     {
-        os_free(dsignal, sizeof(iocDynamicSignal));
+        ioc_release_dynamic_signal(dsignal);
         return OS_NULL;
     }
-    os_memcpy(dsignal->signal_name, signal_name, sz);
 
     return dsignal;
 }
@@ -72,8 +100,9 @@ iocDynamicSignal *ioc_initialize_dynamic_signal(
   @brief Release dynamic signal structure.
   @anchor ioc_release_dynamic_signal
 
-  The ioc_release_dynamic_signal() function frees memory allocated for dynamic signal structure
-  and signal name.
+  The ioc_release_dynamic_signal() function releases references to interned names and
+  returns the dynamic signal structure to network's free list. Memory is freed when the
+  dynamic network is released.
 
   @param   dsignal Pointer to dynamic signal structure to release.
   @return  None.
@@ -83,11 +112,19 @@ iocDynamicSignal *ioc_initialize_dynamic_signal(
 void ioc_release_dynamic_signal(
     iocDynamicSignal *dsignal)
 {
-    os_memsz sz;
+    iocDynamicNetwork *dnetwork;
+
+    dnetwork = dsignal->dnetwork;
+    ioc_release_interned_string(&dnetwork->strings, dsignal->signal_name);
+    ioc_release_interned_string(&dnetwork->strings, dsignal->mblk_name);
+    ioc_release_interned_string(&dnetwork->strings, dsignal->device_name);
 
-    sz = os_strlen(dsignal->signal_name);
-    os_free(dsignal->signal_name, sz);
-    os_free(dsignal, sizeof(iocDynamicSignal));
+#if OSAL_DEBUG
+    os_memclear(dsignal, sizeof(iocDynamicSignal));
+#endif
+    dsignal->next = dnetwork->free_signal;
+    dnetwork->free_signal = dsignal;
+    dnetwork->nro_signals--;
 }
 
 
@@ -311,9 +348,21 @@ iocDynamicSignal *ioc_setup_signal_by_identifiers(
         return dsignal;
     }
 
-    /* Search trough all memory blocks. This will be slow if there are very many IO device networks,
-     * that is why the shortcuts are in memory block list.
+    /* Search memory block index, or trough all memory blocks if there is no index. The latter
+     * will be slow if there are very many IO device networks, that is why the shortcuts are
+     * in memory block list.
      */
+#if IOC_MBLK_INDEX
+    mblk = ioc_mblk_index_find(root, identifiers->network_name, dsignal->device_name,
+        dsignal->device_nr, dsignal->mblk_name);
+    if (mblk)
+    {
+        ioc_release_handle(signal->handle);
+        ioc_setup_handle(signal->handle, root, mblk);
+        ioc_add_mblk_shortcut(dnetwork, mblk);
+        return dsignal;
+    }
+#else
     for (mblk = root->mblk.first;
          mblk;
          mblk = mblk->link.next)
@@ -333,6 +382,7 @@ iocDynamicSignal *ioc_setup_signal_by_identifiers(
         ioc_add_mblk_shortcut(dnetwork, mblk);
         return dsignal;
     }
+#endif
 
     return OS_NULL;
 }
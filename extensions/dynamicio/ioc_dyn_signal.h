@@ -34,18 +34,18 @@ struct iocDynamicNetwork;
 */
 typedef struct iocDynamicSignal
 {
-    /** Signal name. Dynamically allocated, can be up to 31 characters.
+    /** Signal name, can be up to 31 characters. Interned in network's string pool.
      */
-    os_char *signal_name;
+    const os_char *signal_name;
 
-    /** Memory block name, max 15 characters.
+    /** Memory block name, max 15 characters. Interned in network's string pool.
      */
-    os_char mblk_name[IOC_NAME_SZ];
+    const os_char *mblk_name;
 
     /** Device name, max 15 characters from 'a' - 'z' or 'A' - 'Z'. This
-        identifies IO device type, like "TEMPCTRL".
+        identifies IO device type, like "TEMPCTRL". Interned in network's string pool.
      */
-    os_char device_name[IOC_NAME_SZ];
+    const os_char *device_name;
 
     /** If there are multiple devices of same type (same device name),
         this identifies the device. This number is often written in
@@ -76,7 +76,7 @@ typedef struct iocDynamicSignal
      */
     os_int ncolumns;
 
-    /** Next dynamic signal with same hash key.
+    /** Next dynamic signal with same hash key, or next free signal in network's free list.
      */
     struct iocDynamicSignal *next;
 }
@@ -91,7 +91,10 @@ iocDynamicSignal;
 /* Allocate and initialize dynamic signal.
  */
 iocDynamicSignal *ioc_initialize_dynamic_signal(
-    const os_char *signal_name);
+    struct iocDynamicNetwork *dnetwork,
+    const os_char *signal_name,
+    const os_char *mblk_name,
+    const os_char *device_name);
 
 /* Release dynamic signal.
  */
@@ -0,0 +1,282 @@
+/**
+
+  @file    ioc_dyn_string_pool.c
+  @brief   Interned strings for dynamic IO information.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Store each distinct memory block, device and signal name once, see ioc_dyn_string_pool.h.
+  Synchronization ioc_lock() must be on when these functions are called.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#include "iocom.h"
+#if IOC_DYNAMIC_MBLK_CODE
+
+/* Get string from pooled string header, and header from string.
+ */
+#define IOC_POOLED_STR(ps) ((os_char*)((ps) + 1))
+#define IOC_POOLED_HDR(s) (((iocPooledString*)(s)) - 1)
+
+/* Forward referred static functions.
+ */
+static iocPooledString **ioc_string_pool_slot(
+    iocStringPool *pool,
+    const os_char *str);
+
+static void ioc_grow_string_pool(
+    iocStringPool *pool);
+
+
+/**
+****************************************************************************************************
+
+  @brief Release string pool.
+  @anchor ioc_release_string_pool
+
+  The ioc_release_string_pool() function frees all pooled strings, regardless of reference
+  counts, and the hash table. The pool structure itself is left clear.
+
+  @param   pool Pointer to string pool.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_string_pool(
+    iocStringPool *pool)
+{
+    iocPooledString *ps, *next_ps;
+    os_int i;
+
+    if (pool->hash == OS_NULL) return;
+
+    for (i = 0; i < pool->hash_sz; i++)
+    {
+        for (ps = pool->hash[i]; ps; ps = next_ps)
+        {
+            next_ps = ps->next;
+            os_free(ps, sizeof(iocPooledString) + ps->len + 1);
+        }
+    }
+    os_free(pool->hash, pool->hash_sz * sizeof(iocPooledString*));
+    os_memclear(pool, sizeof(iocStringPool));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Intern a string.
+  @anchor ioc_intern_string
+
+  The ioc_intern_string() function finds the string from pool and increments its reference
+  count. If the string is not in pool, it is added.
+
+  @param   pool Pointer to string pool.
+  @param   str String to intern.
+  @return  Pointer to pooled string, OS_NULL if memory allocation failed. The reference
+           must be released by ioc_release_interned_string().
+
+****************************************************************************************************
+*/
+const os_char *ioc_intern_string(
+    iocStringPool *pool,
+    const os_char *str)
+{
+    iocPooledString *ps, **slot;
+    os_int len;
+
+    if (pool->hash == OS_NULL || pool->count >= pool->hash_sz)
+    {
+        ioc_grow_string_pool(pool);
+        if (pool->hash == OS_NULL) return OS_NULL;
+    }
+
+    slot = ioc_string_pool_slot(pool, str);
+    for (ps = *slot; ps; ps = ps->next)
+    {
+        if (!os_strcmp(IOC_POOLED_STR(ps), str))
+        {
+            ps->ref_count++;
+            return IOC_POOLED_STR(ps);
+        }
+    }
+
+    len = (os_int)os_strlen(str) - 1;
+    ps = (iocPooledString*)os_malloc(sizeof(iocPooledString) + len + 1, OS_NULL);
+    if (ps == OS_NULL) return OS_NULL;
+    ps->ref_count = 1;
+    ps->len = len;
+    os_memcpy(IOC_POOLED_STR(ps), str, len + 1);
+
+    ps->next = *slot;
+    *slot = ps;
+    pool->count++;
+    pool->bytes += sizeof(iocPooledString) + len + 1;
+    return IOC_POOLED_STR(ps);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find pooled string.
+  @anchor ioc_find_interned_string
+
+  The ioc_find_interned_string() function looks up the string without adding a reference.
+  It is used to convert search keys to pooled pointers, so that they can be compared to
+  pooled strings by pointer. If the string is not in pool, nothing can match it.
+
+  @param   pool Pointer to string pool.
+  @param   str String to look for.
+  @return  Pointer to pooled string, OS_NULL if not in pool.
+
+****************************************************************************************************
+*/
+const os_char *ioc_find_interned_string(
+    iocStringPool *pool,
+    const os_char *str)
+{
+    iocPooledString *ps;
+
+    if (pool->hash == OS_NULL) return OS_NULL;
+
+    for (ps = *ioc_string_pool_slot(pool, str); ps; ps = ps->next)
+    {
+        if (!os_strcmp(IOC_POOLED_STR(ps), str)) {
+            return IOC_POOLED_STR(ps);
+        }
+    }
+    return OS_NULL;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release reference to pooled string.
+  @anchor ioc_release_interned_string
+
+  The ioc_release_interned_string() function decrements reference count of a pooled string
+  and frees the string when it is no longer referenced.
+
+  @param   pool Pointer to string pool.
+  @param   str Pooled string as returned by ioc_intern_string(). OS_NULL is ignored.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_interned_string(
+    iocStringPool *pool,
+    const os_char *str)
+{
+    iocPooledString *ps, **pps;
+
+    if (str == OS_NULL) return;
+    ps = IOC_POOLED_HDR(str);
+    if (--(ps->ref_count) > 0) return;
+
+    for (pps = ioc_string_pool_slot(pool, str); *pps; pps = &(*pps)->next)
+    {
+        if (*pps == ps)
+        {
+            *pps = ps->next;
+            break;
+        }
+    }
+
+    pool->count--;
+    pool->bytes -= sizeof(iocPooledString) + ps->len + 1;
+    os_free(ps, sizeof(iocPooledString) + ps->len + 1);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get allocated memory of string pool.
+  @anchor ioc_string_pool_memory_use
+
+  @param   pool Pointer to string pool.
+  @return  Bytes allocated for pooled strings and hash table.
+
+****************************************************************************************************
+*/
+os_memsz ioc_string_pool_memory_use(
+    iocStringPool *pool)
+{
+    return pool->bytes + pool->hash_sz * sizeof(iocPooledString*);
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get hash table slot for a string (internal).
+
+  @param   pool Pointer to string pool, hash table must be allocated.
+  @param   str String.
+  @return  Pointer to hash chain head.
+
+****************************************************************************************************
+*/
+static iocPooledString **ioc_string_pool_slot(
+    iocStringPool *pool,
+    const os_char *str)
+{
+    return pool->hash + (ioc_hash(str) & (os_uint)(pool->hash_sz - 1));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Allocate or double string pool hash table (internal).
+
+  If memory allocation fails, the existing hash table is kept (chains just get longer).
+
+  @param   pool Pointer to string pool.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_grow_string_pool(
+    iocStringPool *pool)
+{
+    iocPooledString **hash, **old_hash, *ps, *next_ps;
+    os_int hash_sz, old_hash_sz, i;
+
+    old_hash = pool->hash;
+    old_hash_sz = pool->hash_sz;
+    hash_sz = old_hash ? 2 * old_hash_sz : IOC_STRING_POOL_INITIAL_HASH_SZ;
+
+    hash = (iocPooledString**)os_malloc(hash_sz * sizeof(iocPooledString*), OS_NULL);
+    if (hash == OS_NULL) return;
+    os_memclear(hash, hash_sz * sizeof(iocPooledString*));
+
+    pool->hash = hash;
+    pool->hash_sz = hash_sz;
+
+    for (i = 0; i < old_hash_sz; i++)
+    {
+        for (ps = old_hash[i]; ps; ps = next_ps)
+        {
+            next_ps = ps->next;
+            hash = ioc_string_pool_slot(pool, IOC_POOLED_STR(ps));
+            ps->next = *hash;
+            *hash = ps;
+        }
+    }
+
+    if (old_hash) {
+        os_free(old_hash, old_hash_sz * sizeof(iocPooledString*));
+    }
+}
+
+#endif
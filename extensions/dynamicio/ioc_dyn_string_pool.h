@@ -0,0 +1,121 @@
+/**
+
+  @file    ioc_dyn_string_pool.h
+  @brief   Interned strings for dynamic IO information.
+  @author  agent
+  @version 1.0
+  @date    18.10.2026
+
+  Dynamic signal information repeats the same memory block, device and signal names over
+  and over: Every signal of a device has the same device name, and all devices of the same
+  type have the same signal names. The string pool stores each distinct string once, with
+  a reference count, and signals point to the pooled strings. Since a string is stored only
+  once per pool, two pooled strings are equal if and only if the pointers are equal.
+
+  Copyright 2020 Pekka Lehtikoski. This file is part of the iocom project and shall only be used,
+  modified, and distributed under the terms of the project licensing. By continuing to use, modify,
+  or distribute this file you indicate that you have read the license and understand and accept
+  it fully.
+
+****************************************************************************************************
+*/
+#pragma once
+#ifndef IOC_DYN_STRING_POOL_H_
+#define IOC_DYN_STRING_POOL_H_
+#include "iocom.h"
+
+#if IOC_DYNAMIC_MBLK_CODE
+
+/** Initial string pool hash table size, must be power of two. The hash table is doubled
+    when there are more strings than hash table slots.
+ */
+#define IOC_STRING_POOL_INITIAL_HASH_SZ 32
+
+
+/**
+****************************************************************************************************
+    Pooled string, the string follows the header in the same allocation.
+****************************************************************************************************
+*/
+typedef struct iocPooledString
+{
+    /** Next pooled string in the same hash chain.
+     */
+    struct iocPooledString *next;
+
+    /** Number of references to this string.
+     */
+    os_int ref_count;
+
+    /** String length in bytes, not including terminating '\0'.
+     */
+    os_int len;
+}
+iocPooledString;
+
+
+/**
+****************************************************************************************************
+    String pool structure.
+****************************************************************************************************
+*/
+typedef struct iocStringPool
+{
+    /** Hash table, OS_NULL until first string is added.
+     */
+    iocPooledString **hash;
+
+    /** Number of slots in hash table.
+     */
+    os_int hash_sz;
+
+    /** Number of distinct strings in pool.
+     */
+    os_int count;
+
+    /** Bytes allocated for pooled strings, including headers.
+     */
+    os_memsz bytes;
+}
+iocStringPool;
+
+
+/**
+****************************************************************************************************
+  String pool functions
+****************************************************************************************************
+*/
+/*@{*/
+
+/* Release all strings and hash table of a string pool.
+ */
+void ioc_release_string_pool(
+    iocStringPool *pool);
+
+/* Add reference to a string, storing it in pool if not already there.
+ */
+const os_char *ioc_intern_string(
+    iocStringPool *pool,
+    const os_char *str);
+
+/* Find a pooled string without adding a reference.
+ */
+const os_char *ioc_find_interned_string(
+    iocStringPool *pool,
+    const os_char *str);
+
+/* Remove reference to a pooled string, free it when no longer referenced.
+ */
+void ioc_release_interned_string(
+    iocStringPool *pool,
+    const os_char *str);
+
+/* Get allocated memory of string pool in bytes.
+ */
+os_memsz ioc_string_pool_memory_use(
+    iocStringPool *pool);
+
+/*@}*/
+
+#endif
+#endif
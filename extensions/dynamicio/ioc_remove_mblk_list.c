@@ -221,7 +221,7 @@ osalStatus ioc_make_remove_mblk_req_frame(
     /* Set frame header (set number of items as mblk id field).
      */
     n = r->n_requests;
-    ioc_generate_header(con, con->frame_out.buf, &ptrs, n, 0);
+    ioc_generate_header(con, con->frame_out.buf, &ptrs, n, 0, 0);
 
     /* Generate frame content. Here we do not check for buffer overflow,
        we know (and trust) that it fits within one frame.
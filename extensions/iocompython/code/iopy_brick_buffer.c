@@ -535,7 +535,9 @@ static PyObject *BrickBuffer_get(
     width = (os_int)ioc_get_brick_hdr_int(hdr->width, IOC_BRICK_DIM_SZ);
     height = (os_int)ioc_get_brick_hdr_int(hdr->height, IOC_BRICK_DIM_SZ);
 
-    if (compression == IOC_UNCOMPRESSED)
+    /* Sample batch data is stored uncompressed.
+     */
+    if (compression == IOC_UNCOMPRESSED || compression == IOC_SAMPLES)
     {
         brick_data = PyBytes_FromStringAndSize((const char*)data, data_sz);
     }
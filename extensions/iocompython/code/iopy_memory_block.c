@@ -188,6 +188,10 @@ failed:
 static void MemoryBlock_dealloc(
     MemoryBlock *self)
 {
+#if IOC_MBLK_RECORDER
+    ioc_stop_mblk_recorder(self->recorder, OS_NULL);
+    self->recorder = OS_NULL;
+#endif
     Py_TYPE(self)->tp_free((PyObject *)self);
 
 #if IOPYTHON_TRACE
@@ -237,6 +241,11 @@ static int MemoryBlock_init(
 static PyObject *MemoryBlock_delete(
     MemoryBlock *self)
 {
+#if IOC_MBLK_RECORDER
+    ioc_stop_mblk_recorder(self->recorder, OS_NULL);
+    self->recorder = OS_NULL;
+#endif
+
     if (self->mblk_created)
     {
         ioc_release_memory_block(&self->mblk_handle);
@@ -334,10 +343,8 @@ static PyObject *MemoryBlock_get_param(
 
   The MemoryBlock.set_param() function gets value of memory block's parameter.
 
-  THIS FUNCTION IS NOT NEEDED, WAS USED FOR AUTO SYNC
-
-  param_name Currently only "auto" can be set. Controlles wether to use automatic (value 1)
-  or synchronous sending/receiving (value 0).
+  param_name Currently only "journal" can be set: Number of changed ranges to remember
+  for changes() function, 0 to disable the change journal.
 
 ****************************************************************************************************
 */
@@ -355,6 +362,18 @@ static PyObject *MemoryBlock_set_param(
         return NULL;
     }
 
+#if IOC_MBLK_GENERATIONS
+    if (!os_strcmp(param_name, "journal"))
+    {
+        if (ioc_mblk_enable_journal(&self->mblk_handle, param_value))
+        {
+            PyErr_SetString(iocomError, "Enabling change journal failed");
+            return NULL;
+        }
+        Py_RETURN_NONE;
+    }
+#endif
+
     /* if (!os_strcmp(param_name, "auto"))
     {
         param_ix = IOC_MBLK_AUTO_SYNC_FLAG;
@@ -455,6 +474,120 @@ static PyObject *MemoryBlock_write(
 }
 
 
+#if IOC_MBLK_GENERATIONS
+/**
+****************************************************************************************************
+  Get address ranges changed since generation.
+
+  Returns tuple (generation, [(start_addr, end_addr), ...]). Pass the returned generation as
+  "since" argument to the next call. Use 0 to get the whole memory block.
+****************************************************************************************************
+*/
+static PyObject *MemoryBlock_changes(
+    MemoryBlock *self,
+    PyObject *args,
+    PyObject *kwds)
+{
+    iocMblkChange changes[32];
+    PyObject *list, *item;
+    unsigned int pysince = 0;
+    os_uint generation;
+    os_int n, i;
+
+    static char *kwlist[] = {
+        "since",
+        NULL
+    };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|I",
+         kwlist, &pysince))
+    {
+        PyErr_SetString(iocomError, "Errornous function arguments");
+        return NULL;
+    }
+
+    n = ioc_mblk_get_changes(&self->mblk_handle, (os_uint)pysince, changes,
+        sizeof(changes) / sizeof(iocMblkChange), &generation);
+
+    list = PyList_New(n);
+    for (i = 0; i < n; i++)
+    {
+        item = Py_BuildValue("(ii)", (int)changes[i].start_addr, (int)changes[i].end_addr);
+        PyList_SetItem(list, i, item);
+    }
+
+    return Py_BuildValue("(IN)", (unsigned int)generation, list);
+}
+#endif
+
+
+#if IOC_MBLK_RECORDER
+/**
+****************************************************************************************************
+  Start recording received data to segment rotated log files.
+****************************************************************************************************
+*/
+static PyObject *MemoryBlock_record(
+    MemoryBlock *self,
+    PyObject *args,
+    PyObject *kwds)
+{
+    iocRecorderParams prm;
+    const char *path = NULL;
+    long long segment_sz = 0;
+    int max_segments = 0;
+
+    static char *kwlist[] = {
+        "path",
+        "segment_sz",
+        "max_segments",
+        NULL
+    };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|Li",
+         kwlist, &path, &segment_sz, &max_segments))
+    {
+        PyErr_SetString(iocomError, "Errornous function arguments");
+        return NULL;
+    }
+
+    ioc_stop_mblk_recorder(self->recorder, OS_NULL);
+    os_memclear(&prm, sizeof(prm));
+    prm.path = path;
+    prm.segment_sz = (os_memsz)segment_sz;
+    prm.max_segments = max_segments;
+    self->recorder = ioc_start_mblk_recorder(&self->mblk_handle, &prm);
+    if (self->recorder == OS_NULL)
+    {
+        PyErr_SetString(iocomError, "Starting recorder failed");
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+/**
+****************************************************************************************************
+  Stop recording. Returns recorder statistics as dictionary.
+****************************************************************************************************
+*/
+static PyObject *MemoryBlock_stop_recording(
+    MemoryBlock *self)
+{
+    iocRecorderStats stats;
+
+    if (self->recorder == OS_NULL) Py_RETURN_NONE;
+
+    ioc_stop_mblk_recorder(self->recorder, &stats);
+    self->recorder = OS_NULL;
+    return Py_BuildValue("{s:L,s:L,s:L,s:L}",
+        "records", (long long)stats.records, "bytes", (long long)stats.bytes,
+        "dropped", (long long)stats.dropped, "written", (long long)stats.written);
+}
+#endif
+
+
 /**
 ****************************************************************************************************
   Publish memory block content as dynamic IO network information.
@@ -572,6 +705,13 @@ static PyMethodDef MemoryBlock_methods[] = {
     {"publish", (PyCFunction)MemoryBlock_publish, METH_VARARGS|METH_KEYWORDS, "Publish as dynamic IO info"},
     {"send", (PyCFunction)MemoryBlock_send, METH_NOARGS, "Send data synchronously"},
     {"receive", (PyCFunction)MemoryBlock_receive, METH_NOARGS, "Receive data synchronously"},
+#if IOC_MBLK_RECORDER
+    {"record", (PyCFunction)MemoryBlock_record, METH_VARARGS|METH_KEYWORDS, "Start recording received data"},
+    {"stop_recording", (PyCFunction)MemoryBlock_stop_recording, METH_NOARGS, "Stop recording"},
+#endif
+#if IOC_MBLK_GENERATIONS
+    {"changes", (PyCFunction)MemoryBlock_changes, METH_VARARGS|METH_KEYWORDS, "Get address ranges changed since generation"},
+#endif
 
     {NULL} /* Sentinel */
 };
@@ -26,6 +26,12 @@ typedef struct
    */
   os_boolean mblk_created;
 
+#if IOC_MBLK_RECORDER
+  /* Recorder started by record(), OS_NULL if not recording.
+   */
+  iocMblkRecorder *recorder;
+#endif
+
   int number;
 }
 MemoryBlock;
@@ -234,6 +234,9 @@ static PyMethodDef iocomPythonMethods[] = {
     {"get_secret", (PyCFunction)iocom_python_get_secret, METH_NOARGS, "Get security secret"},
     {"get_password", (PyCFunction)iocom_python_get_password, METH_NOARGS, "Get automatically generated password"},
     {"hash_password", (PyCFunction)iocom_python_hash_password, METH_VARARGS, "Hash password (run SHA-256 hash on password)"},
+#if IOC_MBLK_RECORDER
+    {"read_recording", (PyCFunction)iocom_python_read_recording, METH_VARARGS|METH_KEYWORDS, "Read records from memory block recorder log"},
+#endif
     {"forget_secret", (PyCFunction)iocom_python_forget_secret, METH_NOARGS, "Forget the secret (and password)"},
 
     {NULL, NULL, 0, NULL}        /* Sentinel */
@@ -422,6 +422,75 @@ static PyObject *Root_interrupt_wait(
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Convert queued communication event to Python list.
+
+  The Root_event_to_list function builds [event_name, network_name, device_name, mblk_name]
+  list from the event.
+
+****************************************************************************************************
+*/
+static PyObject *Root_event_to_list(
+    iocQueuedEvent *e)
+{
+    PyObject *rval;
+    os_char device_name[IOC_DEVICE_ID_SZ];
+    os_char nbuf[OSAL_NBUF_SZ], *event_name;
+
+    rval = PyList_New(4);
+    switch (e->event)
+    {
+        case IOC_NEW_MEMORY_BLOCK:
+            event_name = "new_mblk";
+            break;
+
+        case IOC_MBLK_CONNECTED_AS_SOURCE:
+            event_name = "mblk_as_source";
+            break;
+
+        case IOC_MBLK_CONNECTED_AS_TARGET:
+            event_name = "mblk_as_target";
+            break;
+
+        case IOC_MEMORY_BLOCK_DELETED:
+            event_name = "mblk_deleted";
+            break;
+
+        case IOC_NEW_NETWORK:
+            event_name = "new_network";
+            break;
+
+        case IOC_NETWORK_DISCONNECTED:
+            event_name = "network_disconnected";
+            break;
+
+        case IOC_NEW_DEVICE:
+            event_name = "new_device";
+            break;
+
+        case IOC_DEVICE_DISCONNECTED:
+            event_name = "device_disconnected";
+            break;
+
+        default:
+            event_name = "unknown";
+            break;
+    }
+
+    PyList_SetItem(rval, 0, Py_BuildValue("s", (char *)event_name));
+    PyList_SetItem(rval, 1, Py_BuildValue("s", (char *)e->network_name));
+
+    osal_int_to_str(nbuf, sizeof(nbuf), e->device_nr);
+    os_strncpy(device_name, e->device_name, sizeof(device_name));
+    os_strncat(device_name, nbuf, sizeof(device_name));
+    PyList_SetItem(rval, 2, Py_BuildValue("s", (char *)device_name));
+    PyList_SetItem(rval, 3, Py_BuildValue("s", (char *)e->mblk_name));
+    return rval;
+}
+
+
 /**
 ****************************************************************************************************
 
@@ -440,8 +509,6 @@ static PyObject *Root_wait_for_com_event(
     PyObject *rval;
     int timeout_ms;
     iocQueuedEvent *e;
-    os_char device_name[IOC_DEVICE_ID_SZ];
-    os_char nbuf[OSAL_NBUF_SZ], *event_name;
 
     root = self->root;
     if (root == OS_NULL)
@@ -470,63 +537,90 @@ static PyObject *Root_wait_for_com_event(
 
     if (e)
     {
-        rval = PyList_New(4);
-        switch (e->event)
-        {
-            case IOC_NEW_MEMORY_BLOCK:
-                event_name = "new_mblk";
-                break;
+        rval = Root_event_to_list(e);
+        ioc_pop_event(root);
+        return rval;
+    }
 
-            case IOC_MBLK_CONNECTED_AS_SOURCE:
-                event_name = "mblk_as_source";
-                break;
+    /* Return "None".
+     */
+    Py_INCREF(Py_None);
+    return Py_None;
+}
 
-            case IOC_MBLK_CONNECTED_AS_TARGET:
-                event_name = "mblk_as_target";
-                break;
 
-            case IOC_MEMORY_BLOCK_DELETED:
-                event_name = "mblk_deleted";
-                break;
+/**
+****************************************************************************************************
 
-            case IOC_NEW_NETWORK:
-                event_name = "new_network";
-                break;
+  @brief Wait for communication events and get many of them at once.
 
-            case IOC_NETWORK_DISCONNECTED:
-                event_name = "network_disconnected";
-                break;
+  The Root_wait_for_com_events function waits for communication events for given amount of
+  time and returns list of up to n events, each as [event_name, network_name, device_name,
+  mblk_name] list. If no events, the function returns empty list.
 
-            case IOC_NEW_DEVICE:
-                event_name = "new_device";
-                break;
+****************************************************************************************************
+*/
+static PyObject *Root_wait_for_com_events(
+    Root *self,
+    PyObject *args,
+    PyObject *kwds)
+{
+    iocRoot *root;
+    PyObject *rval;
+    int timeout_ms = 0;
+    int py_max_events = 100;
+    iocQueuedEvent *events;
+    os_memsz sz;
+    os_int n, i;
 
-            case IOC_DEVICE_DISCONNECTED:
-                event_name = "device_disconnected";
-                break;
+    static char *kwlist[] = {
+        "timeout_ms",
+        "n",
+        NULL
+    };
 
-            default:
-                event_name = "unknown";
-                break;
-        }
+    root = self->root;
+    if (root == OS_NULL)
+    {
+        PyErr_SetString(iocomError, "no IOCOM root object");
+        return NULL;
+    }
 
-        PyList_SetItem(rval, 0, Py_BuildValue("s", (char *)event_name));
-        PyList_SetItem(rval, 1, Py_BuildValue("s", (char *)e->network_name));
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ii",
+         kwlist, &timeout_ms, &py_max_events))
+    {
+        PyErr_SetString(PyExc_TypeError, "parsing argument failed");
+        return NULL;
+    }
 
-        osal_int_to_str(nbuf, sizeof(nbuf), e->device_nr);
-        os_strncpy(device_name, e->device_name, sizeof(device_name));
-        os_strncat(device_name, nbuf, sizeof(device_name));
-        PyList_SetItem(rval, 2, Py_BuildValue("s", (char *)device_name));
-        PyList_SetItem(rval, 3, Py_BuildValue("s", (char *)e->mblk_name));
+    if (self->queue_event == OS_NULL)
+    {
+        PyErr_SetString(PyExc_TypeError, "Communication events are not queues, call queue_events()");
+        return NULL;
+    }
+    if (py_max_events < 1) py_max_events = 1;
 
-        ioc_pop_event(root);
-        return rval;
+    sz = py_max_events * sizeof(iocQueuedEvent);
+    events = (iocQueuedEvent*)os_malloc(sz, OS_NULL);
+    if (events == OS_NULL)
+    {
+        return PyErr_NoMemory();
     }
 
-    /* Return "None".
-     */
-    Py_INCREF(Py_None);
-    return Py_None;
+    Py_BEGIN_ALLOW_THREADS
+    osal_event_wait(self->queue_event, timeout_ms);
+    Py_END_ALLOW_THREADS
+
+    n = ioc_get_events(root, events, py_max_events);
+
+    rval = PyList_New(n);
+    for (i = 0; i < n; i++)
+    {
+        PyList_SetItem(rval, i, Root_event_to_list(events + i));
+    }
+
+    os_free(events, sz);
+    return rval;
 }
 
 
@@ -858,6 +952,7 @@ static PyMethodDef Root_methods[] = {
     {"queue_events", (PyCFunction)Root_initialize_event_queue, METH_VARARGS|METH_KEYWORDS,
         "Start queueing connect/disconnect, etc. events"},
     {"wait_com_event", (PyCFunction)Root_wait_for_com_event, METH_VARARGS, "Wait for a communication event"},
+    {"wait_com_events", (PyCFunction)Root_wait_for_com_events, METH_VARARGS|METH_KEYWORDS, "Wait for communication events, get many at once"},
     {"interrupt_wait", (PyCFunction)Root_interrupt_wait, METH_NOARGS, "Interrupt \'wait for communication event\'"},
     {"list_networks", (PyCFunction)Root_list_networks, METH_VARARGS, "List IO device networks"},
     {"list_devices", (PyCFunction)Root_list_devices, METH_VARARGS, "List devices in spefified network"},
@@ -143,3 +143,55 @@ PyObject *iocom_python_forget_secret(
     Py_RETURN_NONE;
 }
 
+#if IOC_MBLK_RECORDER
+/* Read records from memory block recorder log. Returns list of (timestamp_us, addr, data, flags)
+   tuples, starting from first record at or after "start" time stamp and ending before "end"
+   (0 = no limit), at most max_records.
+ */
+PyObject *iocom_python_read_recording(
+    PyObject *self,
+    PyObject *args,
+    PyObject *kwds)
+{
+    const char *path = NULL;
+    long long start = 0, end = 0;
+    int max_records = 100000;
+    iocRecordingReader reader;
+    iocRecord record;
+    PyObject *list, *item;
+    osalStatus s;
+
+    static char *kwlist[] = {
+        "path",
+        "start",
+        "end",
+        "max_records",
+        NULL
+    };
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|LLi",
+         kwlist, &path, &start, &end, &max_records))
+    {
+        PyErr_SetString(iocomError, "Errornous function arguments");
+        return NULL;
+    }
+
+    list = PyList_New(0);
+    if (ioc_open_recording(&reader, path)) return list;
+
+    s = start ? ioc_seek_recording(&reader, (os_int64)start) : OSAL_SUCCESS;
+    while (s == OSAL_SUCCESS && PyList_Size(list) < max_records)
+    {
+        if (ioc_read_recording(&reader, &record)) break;
+        if (end && record.timestamp >= (os_int64)end) break;
+
+        item = Py_BuildValue("(Liy#i)", (long long)record.timestamp, (int)record.addr,
+            record.data, (Py_ssize_t)record.n, (int)record.flags);
+        PyList_Append(list, item);
+        Py_DECREF(item);
+    }
+
+    ioc_close_recording(&reader);
+    return list;
+}
+#endif
@@ -46,3 +46,12 @@ PyObject *iocom_python_hash_password(
  */
 PyObject *iocom_python_forget_secret(
     PyObject *self);
+
+#if IOC_MBLK_RECORDER
+/* Read records from memory block recorder log.
+ */
+PyObject *iocom_python_read_recording(
+    PyObject *self,
+    PyObject *args,
+    PyObject *kwds);
+#endif
@@ -62,6 +62,9 @@ AbstractCamera::AbstractCamera()
     m_iface = OS_NULL;
     // m_camera_on_or_off = OS_FALSE;
     m_camera_is_on = OS_FALSE;
+#if IOC_BRICK_TILES_SUPPORT
+    m_tiles_enabled = OS_FALSE;
+#endif
     initialize_motion_detection(&m_motion);
     os_memclear(&m_motion_prm, sizeof(MotionDetectionParameters));
     m_motion_prm.min_interval_ms = 10;
@@ -226,9 +229,45 @@ void AbstractCamera::close()
         m_iface->close(&m_pins_camera);
         m_iface = OS_NULL;
     }
+
+#if IOC_BRICK_TILES_SUPPORT
+    if (m_tiles_enabled) {
+        ioc_release_brick_tiles(&m_video_tiles);
+        m_tiles_enabled = OS_FALSE;
+    }
+#endif
 }
 
 
+#if IOC_BRICK_TILES_SUPPORT
+/**
+****************************************************************************************************
+
+  @brief Send only changed tiles of the image.
+
+  The enable_tiles function turns on tiled brick transfer: The image is split into tiles and
+  only tiles which have changed are sent. Receiving brick buffer reassembles the full frame.
+  This reduces bandwidth a lot for mostly static scenes. Call after setup_camera().
+
+  @param   tile_w Tile width in pixels, multiple of 16 is good for JPEG.
+  @param   tile_h Tile height in pixels.
+  @return  None.
+
+****************************************************************************************************
+*/
+void AbstractCamera::enable_tiles(
+    os_int tile_w,
+    os_int tile_h)
+{
+    if (m_tiles_enabled) {
+        ioc_release_brick_tiles(&m_video_tiles);
+    }
+    ioc_initialize_brick_tiles(&m_video_tiles, &m_video_output, tile_w, tile_h);
+    m_tiles_enabled = OS_TRUE;
+}
+#endif
+
+
 /**
 ****************************************************************************************************
 
@@ -290,8 +329,18 @@ void AbstractCamera::callback(
 
         if (detect_motion(&m_motion, photo, &m_motion_prm, &m_motion_res) != OSAL_NOTHING_TO_DO)
         {
-            if (pins_store_photo_as_brick(photo, &m_video_output, IOC_DEFAULT_COMPRESSION) ==
-                OSAL_STATUS_OUT_OF_BUFFER)
+            osalStatus s;
+#if IOC_BRICK_TILES_SUPPORT
+            if (m_tiles_enabled) {
+                s = ioc_compress_brick_tiles(&m_video_tiles, photo->hdr, photo->data,
+                    photo->data_sz, photo->format, photo->w, photo->h, IOC_DEFAULT_COMPRESSION);
+            }
+            else
+#endif
+            {
+                s = pins_store_photo_as_brick(photo, &m_video_output, IOC_DEFAULT_COMPRESSION);
+            }
+            if (s == OSAL_STATUS_OUT_OF_BUFFER)
             {
                 trigger_motion_detect(&m_motion);
             }
@@ -331,6 +380,10 @@ void AbstractCamera::callback(
 #endif
         }
     }
+    else if (ioc_is_brick_connected(&m_video_output))
+    {
+        ioc_brick_frame_skipped(&m_video_output);
+    }
 }
 
 
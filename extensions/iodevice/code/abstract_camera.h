@@ -89,6 +89,14 @@ namespace IoDevice
             pinsCameraParamIx ix,
             const iocSignal *sig);
 
+#if IOC_BRICK_TILES_SUPPORT
+        /* Send only changed tiles of the image.
+         */
+        void enable_tiles(
+            os_int tile_w,
+            os_int tile_h);
+#endif
+
 #if OSAL_MULTITHREAD_SUPPORT
         /* Start thread to run camera processing independently.
          */
@@ -126,6 +134,13 @@ namespace IoDevice
          */
         iocBrickBuffer m_video_output;
 
+#if IOC_BRICK_TILES_SUPPORT
+        /* Tiled video output state, used if m_tiles_enabled is set.
+         */
+        iocBrickTiles m_video_tiles;
+        os_boolean m_tiles_enabled;
+#endif
+
         /* Camera control parameter has changed, camera on/off.
          */
         // os_boolean m_camera_on_or_off;
@@ -123,7 +123,9 @@ osalStatus ioc_authorize(
     os_boolean is_valid_user = OS_FALSE;
     os_char *check_root_network = OS_NULL;
     os_char user_and_net[IOC_DEVICE_ID_SZ + IOC_NETWORK_NAME_SZ];
+#if IOC_MBLK_INDEX == 0
     os_short n_to_check = 1;
+#endif
 
     /* User and network names are needed to check anything.
      */
@@ -144,7 +146,9 @@ osalStatus ioc_authorize(
     if (os_strcmp(user->network_name, root->network_name))
     {
         check_root_network = root->network_name;
+#if IOC_MBLK_INDEX == 0
         n_to_check = 2;
+#endif
     }
 
     os_strncpy(user_and_net, user->user_name, sizeof(user_and_net));
@@ -153,6 +157,28 @@ osalStatus ioc_authorize(
 
     /* Find account data memory block for the IO network matching to the the connecting device.
      */
+#if IOC_MBLK_INDEX
+    mblk = ioc_mblk_index_find_type(root, OS_NULL, user->network_name,
+        ioc_accounts_device_name, ioc_accounts_data_mblk_name);
+    if (mblk)
+    {
+        ioc_authorize_parse_accounts(allowed_networks, &is_valid_user, user,
+            ip, user->user_name, mblk->network_name, mblk->buf, mblk->nbytes, context);
+    }
+
+    /* Check also accounts in device's root network.
+     */
+    if (check_root_network)
+    {
+        mblk = ioc_mblk_index_find_type(root, OS_NULL, check_root_network,
+            ioc_accounts_device_name, ioc_accounts_data_mblk_name);
+        if (mblk)
+        {
+            ioc_authorize_parse_accounts(allowed_networks, &is_valid_user, user,
+                ip, user_and_net, user->network_name, mblk->buf, mblk->nbytes, context);
+        }
+    }
+#else
     for (mblk = root->mblk.first;
          mblk;
          mblk = mblk->link.next)
@@ -181,6 +207,7 @@ osalStatus ioc_authorize(
             if (n_to_check-- <= 1) break;
         }
     }
+#endif
 
 #if OSAL_DEBUG
     if (!is_valid_user)
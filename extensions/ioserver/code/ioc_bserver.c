@@ -111,6 +111,10 @@ void ioc_release_bserver(
         os_free(m->networks, sizeof(iocBServerNetwork) * m->nro_networks);
     }
 
+#if IOC_DYNAMIC_MBLK_CODE
+    ioc_release_persistent_writers(m);
+#endif
+
     ioc_release_memory_block(&m->exp);
     ioc_release_memory_block(&m->imp);
     ioc_release_memory_block(&m->conf_exp);
@@ -97,10 +97,15 @@ typedef struct iocBServer
     const os_uchar *account_defaults;
     os_memsz account_defaults_sz;
 
-    /** Pointer to persistent writer object, if currently uploading client certificate
-        or automatically updating IO device's flash program.
+    /** List of persistent writer objects, currently uploading client certificate
+        or automatically updating IO device's flash program, and number of them.
      */
-    struct iocPersistentWriter *persistent_writer;
+    struct iocPersistentWriter *persistent_writers;
+    os_int nro_persistent_writers;
+
+    /** Upload payloads cached for persistent writers.
+     */
+    struct iocUploadPayload *upload_payloads;
 
     /** Security run timer.
      */
@@ -18,6 +18,18 @@
 #include "ioserver.h"
 #if IOC_DYNAMIC_MBLK_CODE
 
+/* Forward referred static functions.
+ */
+static iocUploadPayload *ioc_get_upload_payload(
+    iocBServer *m,
+    osPersistentBlockNr default_block_nr,
+    const os_char *dir,
+    const os_char *file_name);
+
+static void ioc_release_upload_payloads(
+    iocBServer *m,
+    os_boolean unused_only);
+
 
 /**
 ****************************************************************************************************
@@ -26,8 +38,10 @@
   @anchor ioc_start_persistent_writer
 
   The ioc_start_persistent_writer() function gets source data and starts writing data to
-  the IO device.
+  the IO device. Source data is read only once and shared by all writers uploading it.
+  The new writer is added to server's persistent writer list.
 
+  @param   m Pointer to basic server structure.
   @param   default_block_nr If reading from persistent storage, this is default block
            number for the case when file name doesn't specify one.
   @param   dir Directory from where files are read, if using file system.
@@ -42,16 +56,15 @@
 ****************************************************************************************************
 */
 iocPersistentWriter *ioc_start_persistent_writer(
+    iocBServer *m,
     osPersistentBlockNr default_block_nr,
     const os_char *dir,
     const os_char *file_name,
     iocMemoryBlock *mblk)
 {
     iocPersistentWriter *wr;
+    iocUploadPayload *payload;
     iocStream *stream;
-    osalStatus s;
-    os_char *buf;
-    os_memsz n_read;
     os_int select;
 
     /* Block number on target IO device. Future: check default_block_nr
@@ -68,12 +81,10 @@ iocPersistentWriter *ioc_start_persistent_writer(
         return OS_NULL;
     }
 
-    /* Get data from persistent block or from file.
+    /* Get data from cache, persistent block or from file.
      */
-    s = osal_get_persistent_block_or_file(default_block_nr, dir,
-        file_name, &buf, &n_read, OS_FILE_NULL_CHAR);
-    if (OSAL_IS_ERROR(s)) {
-        osal_error(OSAL_WARNING, iocom_mod, s, "no data to upload");
+    payload = ioc_get_upload_payload(m, default_block_nr, dir, file_name);
+    if (payload == OS_NULL) {
         ioc_release_stream(stream);
         return OS_NULL;
     }
@@ -83,19 +94,22 @@ iocPersistentWriter *ioc_start_persistent_writer(
     wr = (iocPersistentWriter*)os_malloc(sizeof(iocPersistentWriter), OS_NULL);
     if (wr == OS_NULL)
     {
-        if (s == OSAL_MEMORY_ALLOCATED) {
-            os_free(buf, n_read);
-        }
         ioc_release_stream(stream);
         return OS_NULL;
     }
     os_memclear(wr, sizeof(iocPersistentWriter));
-    wr->buf_allocated = (os_boolean) (s == OSAL_MEMORY_ALLOCATED);
-    wr->buf = buf;
-    wr->buf_sz = n_read;
+    wr->payload = payload;
     wr->stream = stream;
+    os_strncpy(wr->device_name, mblk->device_name, IOC_NAME_SZ);
+    wr->device_nr = mblk->device_nr;
+    os_get_timer(&wr->start_timer);
+    payload->ref_count++;
 
-    ioc_start_stream_write(stream, buf, n_read, OS_FALSE);
+    wr->next = m->persistent_writers;
+    m->persistent_writers = wr;
+    m->nro_persistent_writers++;
+
+    ioc_start_stream_write(stream, payload->buf, payload->buf_sz, OS_FALSE);
     return wr;
 }
 
@@ -106,29 +120,63 @@ iocPersistentWriter *ioc_start_persistent_writer(
   @brief Release persistent writer object.
   @anchor ioc_release_persistent_writer
 
-  The ioc_release_persistent_writer() function releases persistent writer object and all
-  resources allocated for it.
+  The ioc_release_persistent_writer() function removes persistent writer from server's list
+  and releases it and all resources allocated for it. The shared upload payload is kept
+  in cache, see ioc_upload_cert_chain_or_flash_prog().
 
+  @param   m Pointer to basic server structure.
   @param   wr Pointer to persistent writer object.
   @return  None.
 
 ****************************************************************************************************
 */
 void ioc_release_persistent_writer(
+    iocBServer *m,
     iocPersistentWriter *wr)
 {
-    if (wr == OS_NULL) return;
+    iocPersistentWriter **pwr;
 
-    ioc_release_stream(wr->stream);
+    if (wr == OS_NULL) return;
 
-    if (wr->buf_allocated) {
-        os_free(wr->buf, wr->buf_sz);
+    for (pwr = &m->persistent_writers; *pwr; pwr = &(*pwr)->next)
+    {
+        if (*pwr == wr)
+        {
+            *pwr = wr->next;
+            m->nro_persistent_writers--;
+            break;
+        }
     }
 
+    ioc_release_stream(wr->stream);
+    wr->payload->ref_count--;
     os_free(wr, sizeof(iocPersistentWriter));
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Release all persistent writers and cached upload payloads.
+  @anchor ioc_release_persistent_writers
+
+  The ioc_release_persistent_writers() function is called when basic server is released.
+
+  @param   m Pointer to basic server structure.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_release_persistent_writers(
+    iocBServer *m)
+{
+    while (m->persistent_writers) {
+        ioc_release_persistent_writer(m, m->persistent_writers);
+    }
+    ioc_release_upload_payloads(m, OS_FALSE);
+}
+
+
 /**
 ****************************************************************************************************
 
@@ -154,6 +202,10 @@ osalStatus ioc_run_persistent_writer(
     {
         osal_error(OSAL_WARNING, iocom_mod, s, "upload to IO device failed");
     }
+    else if (s == OSAL_COMPLETED)
+    {
+        osal_trace2_int("upload to IO device completed, bytes=", wr->payload->buf_sz);
+    }
     return s;
 }
 
@@ -161,16 +213,19 @@ osalStatus ioc_run_persistent_writer(
 /**
 ****************************************************************************************************
 
-  @brief X
-  @anchor X
+  @brief Upload certificate chain (or flash program) to IO devices which need it.
+  @anchor ioc_upload_cert_chain_or_flash_prog
 
   If a device without certificate chain has been connected, the connection has IOC_NO_CERT_CHAIN
   flag set. This function checks for those flags and initiates the certificate transfer.
+  Up to IOC_MAX_PERSISTENT_WRITERS uploads run at the same time, connections still flagged
+  wait in line and are picked up when a writer completes. Cached upload payloads are
+  released once nothing is uploading or waiting.
 
   This function may be upgrader in future to automatically upload flash program to IO device
   if newer version has been copied to server.
 
-  @param   wr Pointer to persistent writer object.
+  @param   m Pointer to basic server structure.
   @return  None.
 
 ****************************************************************************************************
@@ -181,30 +236,40 @@ void ioc_upload_cert_chain_or_flash_prog(
     iocConnection *con;
     iocTargetBuffer *tbuf;
     iocMemoryBlock *mblk;
+    iocPersistentWriter *wr, *next_wr;
     osalStatus s;
 
-    /* If we have persistent writer, keep on writing.
+    /* Keep on writing with persistent writers we have.
      */
-    if (m->persistent_writer)
+    for (wr = m->persistent_writers; wr; wr = next_wr)
     {
-        s = ioc_run_persistent_writer(m->persistent_writer);
-        if (s)
-        {
-            ioc_release_persistent_writer(m->persistent_writer);
-            m->persistent_writer = OS_NULL;
+        next_wr = wr->next;
+        s = ioc_run_persistent_writer(wr);
+        if (s) {
+            ioc_release_persistent_writer(m, wr);
         }
-        return;
     }
 
     /* If we are not triggered to scan for updates, we have nothing to do.
      */
-    if (!m->check_cert_chain_etc) return;
+    if (!m->check_cert_chain_etc)
+    {
+        if (m->persistent_writers == OS_NULL && m->upload_payloads) {
+            ioc_release_upload_payloads(m, OS_TRUE);
+        }
+        return;
+    }
+
+    /* If all writers are busy, let the rest wait in line.
+     */
+    if (m->nro_persistent_writers >= IOC_MAX_PERSISTENT_WRITERS) return;
 
     /* Synchronize.
      */
     ioc_lock(m->root);
 
-    /* If we have connection which has no serfiticate chain (or maybe in future needs a flash software update)
+    /* Start writers for connections which have no serfiticate chain (or maybe in future
+       need a flash software update), as many as we have free writers for.
      */
     for (con = m->root->con.first;
          con;
@@ -212,13 +277,15 @@ void ioc_upload_cert_chain_or_flash_prog(
     {
         if (con->flags & IOC_NO_CERT_CHAIN)
         {
+            if (m->nro_persistent_writers >= IOC_MAX_PERSISTENT_WRITERS) break;
+
             for (tbuf = con->tbuf.first; tbuf; tbuf = tbuf->clink.next)
             {
                 mblk = tbuf->mlink.mblk;
 
                 if (!os_strcmp(mblk->mblk_name, "info"))
                 {
-                    m->persistent_writer = ioc_start_persistent_writer(OS_PBNR_PUBLISH_CERT_CHAIN,
+                    ioc_start_persistent_writer(m, OS_PBNR_PUBLISH_CERT_CHAIN,
                         OS_NULL, "myhome-bundle.crt", mblk);
 
                     break;
@@ -226,7 +293,6 @@ void ioc_upload_cert_chain_or_flash_prog(
             }
 
             con->flags &= ~IOC_NO_CERT_CHAIN;
-            break;
         }
     }
 
@@ -234,7 +300,7 @@ void ioc_upload_cert_chain_or_flash_prog(
      */
     ioc_unlock(m->root);
 
-    /* If we dodn't find connection to process.
+    /* If we dodn't find more connections to process.
      */
     if (con == OS_NULL)
     {
@@ -242,4 +308,149 @@ void ioc_upload_cert_chain_or_flash_prog(
     }
 }
 
+
+/**
+****************************************************************************************************
+
+  @brief Get progress of uploads in progress.
+  @anchor ioc_get_upload_progress
+
+  The ioc_get_upload_progress() function reports bytes moved and average throughput for
+  each IO device being uploaded to.
+
+  @param   m Pointer to basic server structure.
+  @param   progress Array where to store progress information.
+  @param   max_progress Number of elements in progress array.
+  @return  Number of uploads stored in progress array.
+
+****************************************************************************************************
+*/
+os_int ioc_get_upload_progress(
+    iocBServer *m,
+    iocUploadProgress *progress,
+    os_int max_progress)
+{
+    iocPersistentWriter *wr;
+    os_timer tnow;
+    os_long ms;
+    os_int n;
+
+    os_get_timer(&tnow);
+    n = 0;
+    for (wr = m->persistent_writers; wr && n < max_progress; wr = wr->next)
+    {
+        os_strncpy(progress->device_name, wr->device_name, IOC_NAME_SZ);
+        progress->device_nr = wr->device_nr;
+        progress->bytes_moved = wr->stream->write_buf_pos;
+        progress->total_bytes = wr->payload->buf_sz;
+        ms = os_get_ms_elapsed(&wr->start_timer, &tnow);
+        progress->bytes_per_s = ms > 0 ? (os_long)progress->bytes_moved * 1000 / ms : 0;
+        progress++;
+        n++;
+    }
+    return n;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Get cached upload payload, or read it (internal).
+  @anchor ioc_get_upload_payload
+
+  The ioc_get_upload_payload() function looks for payload read earlier from the same
+  persistent block/file. If not found, the data is read and added to cache. Directory is
+  assumed to be constant for the server, it is not part of the cache key.
+
+  @param   m Pointer to basic server structure.
+  @param   default_block_nr Default persistent block number.
+  @param   dir Directory from where files are read, if using file system.
+  @param   file_name Specifies file name or persistent block number.
+  @return  Pointer to upload payload, OS_NULL if failed.
+
+****************************************************************************************************
+*/
+static iocUploadPayload *ioc_get_upload_payload(
+    iocBServer *m,
+    osPersistentBlockNr default_block_nr,
+    const os_char *dir,
+    const os_char *file_name)
+{
+    iocUploadPayload *payload;
+    osalStatus s;
+    os_char *buf;
+    os_memsz n_read;
+
+    for (payload = m->upload_payloads; payload; payload = payload->next)
+    {
+        if (payload->default_block_nr == default_block_nr &&
+            !os_strcmp(payload->file_name, file_name))
+        {
+            return payload;
+        }
+    }
+
+    s = osal_get_persistent_block_or_file(default_block_nr, dir,
+        file_name, &buf, &n_read, OS_FILE_NULL_CHAR);
+    if (OSAL_IS_ERROR(s)) {
+        osal_error(OSAL_WARNING, iocom_mod, s, "no data to upload");
+        return OS_NULL;
+    }
+
+    payload = (iocUploadPayload*)os_malloc(sizeof(iocUploadPayload), OS_NULL);
+    if (payload == OS_NULL)
+    {
+        if (s == OSAL_MEMORY_ALLOCATED) {
+            os_free(buf, n_read);
+        }
+        return OS_NULL;
+    }
+    os_memclear(payload, sizeof(iocUploadPayload));
+    payload->default_block_nr = default_block_nr;
+    os_strncpy(payload->file_name, file_name, IOC_UPLOAD_FILE_NAME_SZ);
+    payload->buf_allocated = (os_boolean) (s == OSAL_MEMORY_ALLOCATED);
+    payload->buf = buf;
+    payload->buf_sz = n_read;
+
+    payload->next = m->upload_payloads;
+    m->upload_payloads = payload;
+    return payload;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Release cached upload payloads (internal).
+  @anchor ioc_release_upload_payloads
+
+  @param   m Pointer to basic server structure.
+  @param   unused_only OS_TRUE to release only payloads not used by any persistent writer.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_release_upload_payloads(
+    iocBServer *m,
+    os_boolean unused_only)
+{
+    iocUploadPayload *payload, **ppayload;
+
+    ppayload = &m->upload_payloads;
+    while ((payload = *ppayload))
+    {
+        if (unused_only && payload->ref_count > 0)
+        {
+            ppayload = &payload->next;
+            continue;
+        }
+
+        *ppayload = payload->next;
+        if (payload->buf_allocated) {
+            os_free(payload->buf, payload->buf_sz);
+        }
+        os_free(payload, sizeof(iocUploadPayload));
+    }
+}
+
 #endif
@@ -18,10 +18,31 @@
 
 #if IOC_DYNAMIC_MBLK_CODE
 
-/* Persistent writer object structure.
+/* Maximum number of persistent writers uploading at the same time. Connections waiting for
+   upload are flagged (IOC_NO_CERT_CHAIN) and picked up as writers complete.
  */
-typedef struct iocPersistentWriter
+#ifndef IOC_MAX_PERSISTENT_WRITERS
+  #if OSAL_MICROCONTROLLER
+    #define IOC_MAX_PERSISTENT_WRITERS 1
+  #else
+    #define IOC_MAX_PERSISTENT_WRITERS 16
+  #endif
+#endif
+
+/* Maximum file name length for upload payload cache.
+ */
+#define IOC_UPLOAD_FILE_NAME_SZ 64
+
+/* Upload payload, read once and shared read only by all persistent writers uploading
+   the same data.
+ */
+typedef struct iocUploadPayload
 {
+    /* Persistent block number and file name from which the data was read.
+     */
+    osPersistentBlockNr default_block_nr;
+    os_char file_name[IOC_UPLOAD_FILE_NAME_SZ];
+
     /* Memory for buffer has been allocated by os_malloc
      */
     os_boolean buf_allocated;
@@ -31,16 +52,66 @@ typedef struct iocPersistentWriter
     os_char *buf;
     os_memsz buf_sz;
 
+    /* Number of persistent writers using this payload.
+     */
+    os_int ref_count;
+
+    /* Next cached payload.
+     */
+    struct iocUploadPayload *next;
+}
+iocUploadPayload;
+
+/* Persistent writer object structure.
+ */
+typedef struct iocPersistentWriter
+{
+    /* Shared data to write.
+     */
+    iocUploadPayload *payload;
+
     /* Writing stream
      */
     iocStream *stream;
+
+    /* Device to which we are writing, for progress reporting.
+     */
+    os_char device_name[IOC_NAME_SZ];
+    os_uint device_nr;
+
+    /* Timer when upload was started.
+     */
+    os_timer start_timer;
+
+    /* Next active persistent writer.
+     */
+    struct iocPersistentWriter *next;
 }
 iocPersistentWriter;
 
+/* Progress of one upload, see ioc_get_upload_progress().
+ */
+typedef struct iocUploadProgress
+{
+    os_char device_name[IOC_NAME_SZ];
+    os_uint device_nr;
+
+    /* Bytes moved so far and total bytes to move.
+     */
+    os_memsz bytes_moved;
+    os_memsz total_bytes;
+
+    /* Average throughput since upload was started, bytes per second.
+     */
+    os_long bytes_per_s;
+}
+iocUploadProgress;
+
 
 /* Get data to and start writing.
  */
 iocPersistentWriter *ioc_start_persistent_writer(
+    iocBServer *m,
     osPersistentBlockNr default_block_nr,
     const os_char *dir,
     const os_char *file_name,
@@ -49,8 +120,14 @@ iocPersistentWriter *ioc_start_persistent_writer(
 /* Release persistent writer object.
  */
 void ioc_release_persistent_writer(
+    iocBServer *m,
     iocPersistentWriter *wr);
 
+/* Release all persistent writers and cached upload payloads.
+ */
+void ioc_release_persistent_writers(
+    iocBServer *m);
+
 /* Move the data.
  */
 osalStatus ioc_run_persistent_writer(
@@ -61,4 +138,11 @@ osalStatus ioc_run_persistent_writer(
 void ioc_upload_cert_chain_or_flash_prog(
     iocBServer *m);
 
+/* Get progress of uploads in progress.
+ */
+os_int ioc_get_upload_progress(
+    iocBServer *m,
+    iocUploadProgress *progress,
+    os_int max_progress);
+
 #endif
@@ -35,6 +35,29 @@ static void ioc_add_lighthouse_net(
 static void ioc_delete_expired_lighthouse_nets(
     LighthouseClient *c);
 
+static os_short ioc_find_lighthouse_net(
+    LighthouseClient *c,
+    const os_char *network_name,
+    iocTransportEnum transport);
+
+static os_short ioc_alloc_lighthouse_net(
+    LighthouseClient *c);
+
+static void ioc_free_lighthouse_net(
+    LighthouseClient *c,
+    os_short i);
+
+static void ioc_link_lighthouse_net(
+    LighthouseClient *c,
+    os_short i);
+
+static void ioc_unlink_lighthouse_net(
+    LighthouseClient *c,
+    os_short i);
+
+static osalStatus ioc_grow_lighthouse_nets(
+    LighthouseClient *c);
+
 /**
 ****************************************************************************************************
 
@@ -62,6 +85,7 @@ void ioc_initialize_lighthouse_client(
     c->socket_error_timeout = 100;
     c->multicast_ip = is_ipv6 ? LIGHTHOUSE_IP_IPV6 : LIGHTHOUSE_IP_IPV4;
     c->select_tls = is_tls;
+    c->free_net = c->oldest_net = c->newest_net = -1;
 }
 
 
@@ -71,8 +95,9 @@ void ioc_initialize_lighthouse_client(
   @brief Release resources allocated for lighthouse client.
 
   The ioc_release_lighthouse_client() function releases the resources allocated for lighthouse
-  client. In practice the function closes the socket, which listens for UDP multicasts.
-  The function doesn't release memory allocated for the client structure.
+  client. In practice the function closes the socket, which listens for UDP multicasts,
+  and releases the network table. The function doesn't release memory allocated for the
+  client structure.
 
   @param   c Pointer to the light house client object structure.
   @return  None.
@@ -87,6 +112,18 @@ void ioc_release_lighthouse_client(
         osal_stream_close(c->udp_socket, OSAL_STREAM_DEFAULT);
         c->udp_socket = OS_NULL;
     }
+
+    os_lock();
+    if (c->net)
+    {
+        os_free(c->net, c->nro_nets * sizeof(LightHouseNetwork));
+        os_free(c->hash, 2 * c->nro_nets * sizeof(os_short));
+        c->net = OS_NULL;
+        c->hash = OS_NULL;
+        c->nro_nets = 0;
+    }
+    c->free_net = c->oldest_net = c->newest_net = -1;
+    os_unlock();
 }
 
 
@@ -150,7 +187,8 @@ os_boolean ioc_is_lighthouse_used(
 
   The ioc_run_lighthouse_client() function is called repeatedly to poll for received
   lighthouse UDP messages. The IO network information received is stores within
-  the lighthouse client structure.
+  the lighthouse client structure. At most LIGHTHOUSE_MAX_BATCH messages are processed
+  per call, the timer is read once per batch.
 
   @param   c Pointer to the light house client object structure.
   @param   trigger To return always immediately, give 0 here. If event is given here,
@@ -169,17 +207,12 @@ osalStatus ioc_run_lighthouse_client(
     osalStatus s;
     LighthouseMessage msg;
     os_char remote_addr[OSAL_IPADDR_SZ];
-    os_memsz n_read, bytes, n, count;
-    os_ushort checksum, port_nr, tls_port_nr, tcp_port_nr, counter;
-    os_ushort my_tls_port_nr, my_tcp_port_nr;
-    os_char network_item[IOC_NETWORK_NAME_SZ + IOC_NAME_SZ + 10], *p, *e;
-    os_char *network_name, *protocol, nickname[IOC_NAME_SZ], *justincase, *q;
+    os_memsz n_read;
     os_timer received_timer;
-    os_boolean is_tls;
+    os_int batch_count;
 #if OSAL_SOCKET_SELECT_SUPPORT
     osalStream streams[1];
 #endif
-    LightHouseClientCallbackData callbackdata;
 
     /* If UDP socket is not open
      */
@@ -211,7 +244,8 @@ osalStatus ioc_run_lighthouse_client(
         os_get_timer(&c->multicast_received);
     }
 
-    while (OS_TRUE)
+    os_get_timer(&received_timer);
+    for (batch_count = 0; batch_count < LIGHTHOUSE_MAX_BATCH; batch_count++)
     {
         /* Try to read multicast received from UDP stream
          */
@@ -230,7 +264,7 @@ osalStatus ioc_run_lighthouse_client(
 
         /*  Recoed that we recieived a multicast.
          */
-        os_get_timer(&c->multicast_received);
+        c->multicast_received = received_timer;
 
         /* If success, but nothing received
          */
@@ -247,145 +281,7 @@ osalStatus ioc_run_lighthouse_client(
             break;
         }
 
-        /* Make sure that string is terminated (just in case) and
-           Validate the message id and size.
-         */
-        msg.publish[LIGHTHOUSE_PUBLISH_SZ-1] = '\0';
-        bytes = sizeof(LighthouseMessageHdr) + msg.hdr.publish_sz;
-        if (msg.hdr.msg_id != LIGHTHOUSE_MSG_ID ||
-            msg.hdr.publish_sz < 1 ||
-            msg.hdr.publish_sz > LIGHTHOUSE_PUBLISH_SZ ||
-            msg.hdr.hdr_sz !=  sizeof(LighthouseMessageHdr) ||
-            n_read < bytes)
-        {
-            osal_error(OSAL_WARNING, iocom_mod,
-                OSAL_STATUS_UNKNOWN_LIGHTHOUSE_MULTICAST, "content");
-            continue;
-        }
-
-        /* Verify checksum
-         */
-        checksum = msg.hdr.checksum_high;
-        checksum = (checksum << 8) | msg.hdr.checksum_low;
-
-        msg.hdr.checksum_high = msg.hdr.checksum_low = 0;
-        if (checksum != os_checksum((const os_char*)&msg, bytes, OS_NULL))
-        {
-            osal_error(OSAL_WARNING, iocom_mod,
-                OSAL_STATUS_UNKNOWN_LIGHTHOUSE_MULTICAST, "checksum");
-            continue;
-        }
-
-        /* Get network ports and counter.
-         */
-        tls_port_nr = msg.hdr.tls_port_nr_high;
-        tls_port_nr = (tls_port_nr << 8) | msg.hdr.tls_port_nr_low;
-        tcp_port_nr = msg.hdr.tcp_port_nr_high;
-        tcp_port_nr = (tcp_port_nr << 8) | msg.hdr.tcp_port_nr_low;
-        counter = msg.hdr.counter_high;
-        counter = (counter << 8) | msg.hdr.counter_low;
-
-        /* Add/update device network or process name.
-         */
-        if (tls_port_nr || tcp_port_nr) {
-            os_get_timer(&received_timer);
-
-            p = os_strchr(msg.publish, ',');
-            if (p == OS_NULL) {
-                p = os_strchr(msg.publish, '\0');
-            }
-            n = p - msg.publish + 1;
-            if (n > (os_memsz)sizeof(nickname)) {
-                n = sizeof(nickname);
-            }
-            os_strncpy(nickname, msg.publish, n);
-            p++;
-
-            while (*p != '\0')
-            {
-                e = os_strchr(p, ',');
-                if (e == OS_NULL) e = os_strchr(p, '\0');
-                n = e - p + 1;
-                if (n > (os_memsz)sizeof(network_item)) {
-                    n = sizeof(network_item);
-                }
-                os_strncpy(network_item, p, n);
-
-                protocol = os_strchr(network_item, ':');
-                if (protocol == OS_NULL) goto goon;
-                protocol++;
-
-                network_name = os_strchr(protocol, ':');
-                if (network_name == OS_NULL) goto goon;
-                *(network_name++) = '\0';
-
-                justincase = os_strchr(network_name, ':');
-                if (justincase) {
-                    *justincase = '\0';
-                }
-
-                my_tls_port_nr = 0;
-                my_tcp_port_nr = 0;
-                q = network_item;
-                while (q + 1 < protocol) {
-                    switch (*q) {
-                        case 'T':
-                        case 't':
-                            is_tls = OS_TRUE;
-                            break;
-
-                        case 'S':
-                        case 's':
-                            is_tls = OS_FALSE;
-                            break;
-
-                        default:
-                            osal_debug_error("Unknown lighthouse TLS/IPv6 mark");
-                            goto goon;
-                    }
-                    q++;
-
-                    port_nr = 0;
-                    if (osal_char_isdigit(*q)) {
-                        port_nr = (os_ushort)osal_str_to_int(q, &count);
-                        q += count;
-                    }
-
-                    if (is_tls) {
-                        my_tls_port_nr = port_nr ? port_nr : tls_port_nr;
-                    }
-                    else {
-                        my_tcp_port_nr = port_nr ? port_nr : tcp_port_nr;
-                    }
-                }
-                port_nr = c->select_tls ? my_tls_port_nr : my_tcp_port_nr;
-
-                os_memclear(&callbackdata, sizeof(LightHouseClientCallbackData));
-                callbackdata.ip_addr = remote_addr;
-                callbackdata.protocol = protocol;
-                callbackdata.tls_port_nr = my_tls_port_nr;
-                callbackdata.tcp_port_nr = my_tcp_port_nr;
-                callbackdata.network_name = network_name;
-                callbackdata.nickname = nickname;
-                callbackdata.counter = counter;
-
-                if (c->func) {
-                    c->func(c, &callbackdata, c->context);
-                }
-
-                if (port_nr && !os_strcmp(protocol, "i")) {
-                    /* SWITCH THIS TO USE CALLBACKDATA and select_tls flag.
-                     * And to use counter to select fastest of multiple IPs.
-                     */
-                    ioc_add_lighthouse_net(c, remote_addr, port_nr,
-                        c->select_tls ? IOC_TLS_SOCKET : IOC_TCP_SOCKET,
-                        network_name, &received_timer);
-                }
-goon:
-                if (*e == '\0') break;
-                p = e + 1;
-            }
-        }
+        ioc_process_lighthouse_multicast(c, &msg, n_read, remote_addr, &received_timer);
     }
 
     /* If we have not received anything for 30 seconds, close socket to reopen it
@@ -418,13 +314,190 @@ goon:
 }
 
 
+/**
+****************************************************************************************************
+
+  @brief Process one received lighthouse multicast.
+  @anchor ioc_process_lighthouse_multicast
+
+  The ioc_process_lighthouse_multicast() function validates a lighthouse UDP message, calls
+  the callback function and stores the published IO networks. It is called by
+  ioc_run_lighthouse_client() for each multicast received, and can be called to replay
+  recorded multicasts. The message buffer is modified (checksum is cleared).
+
+  @param   c Pointer to the light house client object structure.
+  @param   msg Received message.
+  @param   n_read Number of bytes received.
+  @param   remote_addr IP address of the sender, like "192.168.1.220".
+  @param   received_timer os_get_timer() value when the message was received.
+  @return  None.
+
+****************************************************************************************************
+*/
+void ioc_process_lighthouse_multicast(
+    LighthouseClient *c,
+    LighthouseMessage *msg,
+    os_memsz n_read,
+    os_char *remote_addr,
+    os_timer *received_timer)
+{
+    os_memsz bytes, n, count;
+    os_ushort checksum, port_nr, tls_port_nr, tcp_port_nr, counter;
+    os_ushort my_tls_port_nr, my_tcp_port_nr;
+    os_char network_item[IOC_NETWORK_NAME_SZ + IOC_NAME_SZ + 10], *p, *e;
+    os_char *network_name, *protocol, nickname[IOC_NAME_SZ], *justincase, *q;
+    os_boolean is_tls;
+    LightHouseClientCallbackData callbackdata;
+
+    /* Make sure that string is terminated (just in case) and
+       Validate the message id and size.
+     */
+    msg->publish[LIGHTHOUSE_PUBLISH_SZ-1] = '\0';
+    bytes = sizeof(LighthouseMessageHdr) + msg->hdr.publish_sz;
+    if (msg->hdr.msg_id != LIGHTHOUSE_MSG_ID ||
+        msg->hdr.publish_sz < 1 ||
+        msg->hdr.publish_sz > LIGHTHOUSE_PUBLISH_SZ ||
+        msg->hdr.hdr_sz !=  sizeof(LighthouseMessageHdr) ||
+        n_read < bytes)
+    {
+        osal_error(OSAL_WARNING, iocom_mod,
+            OSAL_STATUS_UNKNOWN_LIGHTHOUSE_MULTICAST, "content");
+        return;
+    }
+
+    /* Verify checksum
+     */
+    checksum = msg->hdr.checksum_high;
+    checksum = (checksum << 8) | msg->hdr.checksum_low;
+
+    msg->hdr.checksum_high = msg->hdr.checksum_low = 0;
+    if (checksum != os_checksum((const os_char*)msg, bytes, OS_NULL))
+    {
+        osal_error(OSAL_WARNING, iocom_mod,
+            OSAL_STATUS_UNKNOWN_LIGHTHOUSE_MULTICAST, "checksum");
+        return;
+    }
+
+    /* Get network ports and counter.
+     */
+    tls_port_nr = msg->hdr.tls_port_nr_high;
+    tls_port_nr = (tls_port_nr << 8) | msg->hdr.tls_port_nr_low;
+    tcp_port_nr = msg->hdr.tcp_port_nr_high;
+    tcp_port_nr = (tcp_port_nr << 8) | msg->hdr.tcp_port_nr_low;
+    counter = msg->hdr.counter_high;
+    counter = (counter << 8) | msg->hdr.counter_low;
+
+    /* Add/update device network or process name.
+     */
+    if (tls_port_nr || tcp_port_nr) {
+        p = os_strchr(msg->publish, ',');
+        if (p == OS_NULL) {
+            p = os_strchr(msg->publish, '\0');
+        }
+        n = p - msg->publish + 1;
+        if (n > (os_memsz)sizeof(nickname)) {
+            n = sizeof(nickname);
+        }
+        os_strncpy(nickname, msg->publish, n);
+        p++;
+
+        while (*p != '\0')
+        {
+            e = os_strchr(p, ',');
+            if (e == OS_NULL) e = os_strchr(p, '\0');
+            n = e - p + 1;
+            if (n > (os_memsz)sizeof(network_item)) {
+                n = sizeof(network_item);
+            }
+            os_strncpy(network_item, p, n);
+
+            protocol = os_strchr(network_item, ':');
+            if (protocol == OS_NULL) goto goon;
+            protocol++;
+
+            network_name = os_strchr(protocol, ':');
+            if (network_name == OS_NULL) goto goon;
+            *(network_name++) = '\0';
+
+            justincase = os_strchr(network_name, ':');
+            if (justincase) {
+                *justincase = '\0';
+            }
+
+            my_tls_port_nr = 0;
+            my_tcp_port_nr = 0;
+            q = network_item;
+            while (q + 1 < protocol) {
+                switch (*q) {
+                    case 'T':
+                    case 't':
+                        is_tls = OS_TRUE;
+                        break;
+
+                    case 'S':
+                    case 's':
+                        is_tls = OS_FALSE;
+                        break;
+
+                    default:
+                        osal_debug_error("Unknown lighthouse TLS/IPv6 mark");
+                        goto goon;
+                }
+                q++;
+
+                port_nr = 0;
+                if (osal_char_isdigit(*q)) {
+                    port_nr = (os_ushort)osal_str_to_int(q, &count);
+                    q += count;
+                }
+
+                if (is_tls) {
+                    my_tls_port_nr = port_nr ? port_nr : tls_port_nr;
+                }
+                else {
+                    my_tcp_port_nr = port_nr ? port_nr : tcp_port_nr;
+                }
+            }
+            port_nr = c->select_tls ? my_tls_port_nr : my_tcp_port_nr;
+
+            os_memclear(&callbackdata, sizeof(LightHouseClientCallbackData));
+            callbackdata.ip_addr = remote_addr;
+            callbackdata.protocol = protocol;
+            callbackdata.tls_port_nr = my_tls_port_nr;
+            callbackdata.tcp_port_nr = my_tcp_port_nr;
+            callbackdata.network_name = network_name;
+            callbackdata.nickname = nickname;
+            callbackdata.counter = counter;
+
+            if (c->func) {
+                c->func(c, &callbackdata, c->context);
+            }
+
+            if (port_nr && !os_strcmp(protocol, "i")) {
+                /* SWITCH THIS TO USE CALLBACKDATA and select_tls flag.
+                 * And to use counter to select fastest of multiple IPs.
+                 */
+                ioc_add_lighthouse_net(c, remote_addr, port_nr,
+                    c->select_tls ? IOC_TLS_SOCKET : IOC_TCP_SOCKET,
+                    network_name, received_timer);
+            }
+goon:
+            if (*e == '\0') break;
+            p = e + 1;
+        }
+    }
+}
+
+
 /**
 ****************************************************************************************************
 
   @brief Store information about an IO network to lighthouse client structure (internal).
 
   The ioc_add_lighthouse_net() function is called for each network when lighthouse UDP is
-  received.
+  received. The network is looked up by hash of transport and network name. If not found,
+  a new network is allocated. If network table is full and cannot be grown, the oldest
+  network is replaced.
 
   @param   c Pointer to the light house client object structure.
   @param   ip_address Something like "192.168.1.220".
@@ -446,73 +519,42 @@ static void ioc_add_lighthouse_net(
     os_timer *received_timer)
 {
     LightHouseNetwork *n;
-    os_int i, selected_i;
-    os_boolean update_iface, is_right_net;
+    os_short i;
+    os_boolean is_right_net;
 
     os_lock();
 
     /* If we already have network with this name, update it.
      */
-    selected_i = -1;
-    update_iface = OS_FALSE;
-    for (i = 0; i < LIGHTHOUSE_NRO_NETS; i++)
+    i = ioc_find_lighthouse_net(c, network_name, transport);
+    if (i >= 0)
     {
-        /* Skip if transport doesn't match (skips also unused ones).
+        /* If we already got loopback interface and new received interface is
+           something else, we prefer to keep the loopback unless it is very old (20 seconds).
          */
-        if (c->net[i].transport != transport) continue;
-
-        /* If network name doesn't match, skip.
-         */
-        if (os_strcmp(network_name, c->net[i].network_name)) continue;
-
-        /* Select this line.
-         */
-        selected_i = i;
-        update_iface = OS_TRUE;
-        break;
-    }
-
-    /* No matching network name, if we have empty one, use it.
-     */
-    if (selected_i < 0)
-    {
-        for (i = 0; i < LIGHTHOUSE_NRO_NETS; i++)
+        n = c->net + i;
+        if ((!os_strcmp(n->ip_addr, "127.0.0.1") || !os_strcmp(n->ip_addr, "::1")) &&
+             os_strcmp(ip_addr, "127.0.0.1") &&
+             os_strcmp(ip_addr, "::1"))
         {
-            if (c->net[i].transport) continue;
-            selected_i = i;
-            break;
-        }
-    }
-
-    /* No empty ones, pick up the oldest.
-     */
-    if (selected_i < 0)
-    {
-        selected_i = 0;
-        for (i = 1; i < LIGHTHOUSE_NRO_NETS; i++)
-        {
-            if (!os_has_elapsed_since(&c->net[selected_i].received_timer,
-                &c->net[i].received_timer, 1))
-            {
-                selected_i = i;
+            if (!os_has_elapsed_since(&n->received_timer, received_timer, 10000)) {
+                os_unlock();
+                return;
             }
         }
+        ioc_unlink_lighthouse_net(c, i);
     }
 
-    /* If we already got loopback interface and new received interface is
-       something else, we prefer to keep the loopback unless it is very old (20 seconds).
+    /* No matching network name, allocate new one.
      */
-    n = c->net + selected_i;
-    if (update_iface &&
-        (!os_strcmp(n->ip_addr, "127.0.0.1") || !os_strcmp(n->ip_addr, "::1")) &&
-         !os_strcmp(n->network_name, network_name) &&
-         os_strcmp(ip_addr, "127.0.0.1") &&
-         os_strcmp(ip_addr, "::1"))
+    else
     {
-        if (!os_has_elapsed_since(&n->received_timer, received_timer, 10000)) {
+        i = ioc_alloc_lighthouse_net(c);
+        if (i < 0) {
             os_unlock();
             return;
         }
+        n = c->net + i;
     }
 
     /* Save or update the network.
@@ -520,8 +562,9 @@ static void ioc_add_lighthouse_net(
     os_strncpy(n->ip_addr, ip_addr, OSAL_IPADDR_SZ);
     n->port_nr = port_nr;
     n->transport = transport;
-    os_strncpy(n->network_name, network_name, OSAL_IPADDR_SZ);
+    os_strncpy(n->network_name, network_name, IOC_NETWORK_NAME_SZ);
     n->received_timer = *received_timer;
+    ioc_link_lighthouse_net(c, i);
 
     /* Show lighthouse connect/no in network state
      */
@@ -538,34 +581,287 @@ static void ioc_add_lighthouse_net(
 
   @brief Delete information about received networks which is exipired (internal).
 
-  The ioc_delete_expired_lighthouse_nets() function...
+  The ioc_delete_expired_lighthouse_nets() function deletes networks which have not been
+  refreshed by multicast within LIGHTHOUSE_NET_TTL_MS. Since networks are linked in receive
+  order, only the expired ones from the old end of the list are looked at.
 
   @param   c Pointer to the light house client object structure.
-  @return  rNone.
+  @return  None.
 
 ****************************************************************************************************
 */
 static void ioc_delete_expired_lighthouse_nets(
     LighthouseClient *c)
 {
-    OSAL_UNUSED(c);
-#if 0
+#if LIGHTHOUSE_NET_TTL_MS
     os_timer ti;
-    os_int i;
+    os_short i;
 
     os_get_timer(&ti);
 
-    for (i = 0; i < LIGHTHOUSE_NRO_NETS; i++)
+    os_lock();
+    while ((i = c->oldest_net) >= 0)
+    {
+        if (!os_has_elapsed_since(&c->net[i].received_timer, &ti, LIGHTHOUSE_NET_TTL_MS)) {
+            break;
+        }
+        ioc_unlink_lighthouse_net(c, i);
+        ioc_free_lighthouse_net(c, i);
+    }
+    os_unlock();
+#else
+    OSAL_UNUSED(c);
+#endif
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Calculate hash table slot for network (internal).
+
+  @param   c Pointer to the light house client object structure.
+  @param   network_name Network name, like "cafenet".
+  @param   transport Either IOC_TCP_SOCKET or IOC_TLS_SOCKET.
+  @return  Hash table index.
+
+****************************************************************************************************
+*/
+static os_int ioc_lighthouse_hash(
+    LighthouseClient *c,
+    const os_char *network_name,
+    iocTransportEnum transport)
+{
+    os_uint h;
+
+    h = 2166136261U ^ (os_uint)transport;
+    while (*network_name) {
+        h = (h ^ (os_uchar)*(network_name++)) * 16777619U;
+    }
+    return (os_int)(h & (os_uint)(2 * c->nro_nets - 1));
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Find network by name and transport (internal).
+
+  ioc_lock() must be on when calling this function.
+
+  @param   c Pointer to the light house client object structure.
+  @param   network_name Network name, like "cafenet".
+  @param   transport Either IOC_TCP_SOCKET or IOC_TLS_SOCKET.
+  @return  Index of network in net array, -1 if not found.
+
+****************************************************************************************************
+*/
+static os_short ioc_find_lighthouse_net(
+    LighthouseClient *c,
+    const os_char *network_name,
+    iocTransportEnum transport)
+{
+    os_short i;
+
+    if (c->net == OS_NULL) return -1;
+
+    for (i = c->hash[ioc_lighthouse_hash(c, network_name, transport)];
+         i >= 0;
+         i = c->net[i].hash_next)
     {
-        if (!c->net[i].transport) continue;
+        if (c->net[i].transport == transport &&
+            !os_strcmp(network_name, c->net[i].network_name))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Allocate a network entry (internal).
+
+  The ioc_alloc_lighthouse_net() function takes network entry from free list. If there
+  are no free entries, network table is grown. If table is already at maximum size, the
+  oldest network is dropped to make space.
+
+  ioc_lock() must be on when calling this function.
 
-        /* 60s, shoud be linger than loopback expiration */
-        if (os_has_elapsed_since(&c->net[i].received_timer, &ti, 60000))
+  @param   c Pointer to the light house client object structure.
+  @return  Index of network in net array, -1 if memory allocation failed.
+
+****************************************************************************************************
+*/
+static os_short ioc_alloc_lighthouse_net(
+    LighthouseClient *c)
+{
+    os_short i;
+
+    if (c->free_net < 0)
+    {
+        if (c->nro_nets >= LIGHTHOUSE_MAX_NETS || ioc_grow_lighthouse_nets(c))
         {
-            c->net[i].transport = 0;
+            i = c->oldest_net;
+            if (i < 0) return -1;
+            ioc_unlink_lighthouse_net(c, i);
+            return i;
         }
     }
-#endif
+
+    i = c->free_net;
+    c->free_net = c->net[i].hash_next;
+    return i;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Move unlinked network entry to free list (internal).
+
+  @param   c Pointer to the light house client object structure.
+  @param   i Index of network in net array.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_free_lighthouse_net(
+    LighthouseClient *c,
+    os_short i)
+{
+    c->net[i].transport = 0;
+    c->net[i].hash_next = c->free_net;
+    c->free_net = i;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Add network entry to hash chain and as newest to receive order list (internal).
+
+  @param   c Pointer to the light house client object structure.
+  @param   i Index of network in net array.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_link_lighthouse_net(
+    LighthouseClient *c,
+    os_short i)
+{
+    LightHouseNetwork *n;
+    os_short *h;
+
+    n = c->net + i;
+    h = c->hash + ioc_lighthouse_hash(c, n->network_name, n->transport);
+    n->hash_next = *h;
+    *h = i;
+
+    n->older = c->newest_net;
+    n->newer = -1;
+    if (c->newest_net >= 0) {
+        c->net[c->newest_net].newer = i;
+    }
+    else {
+        c->oldest_net = i;
+    }
+    c->newest_net = i;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Remove network entry from hash chain and receive order list (internal).
+
+  @param   c Pointer to the light house client object structure.
+  @param   i Index of network in net array.
+  @return  None.
+
+****************************************************************************************************
+*/
+static void ioc_unlink_lighthouse_net(
+    LighthouseClient *c,
+    os_short i)
+{
+    LightHouseNetwork *n;
+    os_short *h;
+
+    n = c->net + i;
+    h = c->hash + ioc_lighthouse_hash(c, n->network_name, n->transport);
+    while (*h != i) {
+        h = &c->net[*h].hash_next;
+    }
+    *h = n->hash_next;
+
+    if (n->older >= 0) c->net[n->older].newer = n->newer;
+    else c->oldest_net = n->newer;
+    if (n->newer >= 0) c->net[n->newer].older = n->older;
+    else c->newest_net = n->older;
+}
+
+
+/**
+****************************************************************************************************
+
+  @brief Allocate or double network table (internal).
+
+  The ioc_grow_lighthouse_nets() function allocates network table for LIGHTHOUSE_NRO_NETS
+  networks, or doubles size of existing one. Existing networks keep their indices, the hash
+  table is rebuilt and new entries are added to free list.
+
+  @param   c Pointer to the light house client object structure.
+  @return  OSAL_SUCCESS if successful, OSAL_STATUS_MEMORY_ALLOCATION_FAILED if out of memory.
+
+****************************************************************************************************
+*/
+static osalStatus ioc_grow_lighthouse_nets(
+    LighthouseClient *c)
+{
+    LightHouseNetwork *net;
+    os_short *hash, nro_nets, i;
+
+    nro_nets = c->net ? 2 * c->nro_nets : LIGHTHOUSE_NRO_NETS;
+    net = (LightHouseNetwork*)os_malloc(nro_nets * sizeof(LightHouseNetwork), OS_NULL);
+    hash = (os_short*)os_malloc(2 * nro_nets * sizeof(os_short), OS_NULL);
+    if (net == OS_NULL || hash == OS_NULL)
+    {
+        if (net) os_free(net, nro_nets * sizeof(LightHouseNetwork));
+        if (hash) os_free(hash, 2 * nro_nets * sizeof(os_short));
+        return OSAL_STATUS_MEMORY_ALLOCATION_FAILED;
+    }
+    os_memclear(net, nro_nets * sizeof(LightHouseNetwork));
+    for (i = 0; i < 2 * nro_nets; i++) {
+        hash[i] = -1;
+    }
+
+    if (c->net)
+    {
+        os_memcpy(net, c->net, c->nro_nets * sizeof(LightHouseNetwork));
+        os_free(c->net, c->nro_nets * sizeof(LightHouseNetwork));
+        os_free(c->hash, 2 * c->nro_nets * sizeof(os_short));
+    }
+    for (i = nro_nets - 1; i >= c->nro_nets; i--) {
+        net[i].hash_next = c->free_net;
+        c->free_net = i;
+    }
+    c->net = net;
+    c->hash = hash;
+    c->nro_nets = nro_nets;
+
+    /* Rehash existing networks, in the same receive order.
+     */
+    for (i = c->oldest_net; i >= 0; i = net[i].newer)
+    {
+        hash = c->hash + ioc_lighthouse_hash(c, net[i].network_name, net[i].transport);
+        net[i].hash_next = *hash;
+        *hash = i;
+    }
+    return OSAL_SUCCESS;
 }
 
 
@@ -603,7 +899,7 @@ osalStatus ioc_get_lighthouse_connectstr(
     os_char *connectstr,
     os_memsz connectstr_sz)
 {
-    os_int i, selected_i;
+    os_short i, selected_i;
     os_char nbuf[OSAL_NBUF_SZ];
     const os_char *compare_name;
     iocTransportEnum transport;
@@ -627,31 +923,24 @@ osalStatus ioc_get_lighthouse_connectstr(
         compare_name = osal_str_empty;
     }
 
+    /* If we have network name, look it up by hash. Otherwise select the newest
+       network with matching transport.
+     */
     selected_i = -1;
-    lighthouse_visible = OS_FALSE;
-    for (i = 0; i < LIGHTHOUSE_NRO_NETS; i++)
+    if (*compare_name != '\0') {
+        selected_i = ioc_find_lighthouse_net(c, compare_name, transport);
+    }
+    lighthouse_visible = (os_boolean)(selected_i >= 0);
+    for (i = c->newest_net; i >= 0 && !lighthouse_visible; i = c->net[i].older)
     {
-        /* Skip if transport doesn't match (skips also unused ones).
+        /* Skip if transport doesn't match.
          */
         if (c->net[i].transport != transport) continue;
 
         lighthouse_visible = OS_TRUE;
-
-        /* If network name doesn't match and we have network name, skip
-         */
-        if (*compare_name != '\0' &&  os_strcmp(compare_name, c->net[i].network_name)) continue;
-
-        /* If this is older than some previous match, skip
-         */
-        if (selected_i >= 0) {
-            if (!os_has_elapsed_since(&c->net[selected_i].received_timer, &c->net[i].received_timer, 1)) {
-                continue;
-            }
+        if (*compare_name == '\0') {
+            selected_i = i;
         }
-
-        /* Select this line.
-         */
-        selected_i = i;
     }
 
     /* If we found no match?
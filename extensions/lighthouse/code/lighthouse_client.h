@@ -56,6 +56,15 @@ typedef struct LightHouseNetwork
         many networks.
      */
     os_timer received_timer;
+
+    /** Next network in the same hash chain, or in free list if this network is unused.
+        -1 if none.
+     */
+    os_short hash_next;
+
+    /** Previous (older) and next (newer) network in receive order list, -1 if none.
+     */
+    os_short older, newer;
 }
 LightHouseNetwork;
 
@@ -79,7 +88,8 @@ typedef void ioc_lighthouse_client_callback(
     void *context);
 
 
-/** How many networks we can remember.
+/** How many networks we can remember. Network table is allocated for LIGHTHOUSE_NRO_NETS
+    networks and grown up to LIGHTHOUSE_MAX_NETS as needed. Both must be powers of two.
  */
 #ifndef LIGHTHOUSE_NRO_NETS
   #if OSAL_MICROCONTROLLER
@@ -88,6 +98,27 @@ typedef void ioc_lighthouse_client_callback(
     #define LIGHTHOUSE_NRO_NETS 32
   #endif
 #endif
+#ifndef LIGHTHOUSE_MAX_NETS
+  #if OSAL_MICROCONTROLLER
+    #define LIGHTHOUSE_MAX_NETS LIGHTHOUSE_NRO_NETS
+  #else
+    #define LIGHTHOUSE_MAX_NETS 4096
+  #endif
+#endif
+
+/** Network information not refreshed by multicast within this time is deleted, ms.
+    Should be longer than loopback preference time (10 s).
+ */
+#ifndef LIGHTHOUSE_NET_TTL_MS
+#define LIGHTHOUSE_NET_TTL_MS 60000
+#endif
+
+/** Maximum number of UDP multicasts processed by one ioc_run_lighthouse_client() call,
+    so that busy network segment cannot hog the calling thread.
+ */
+#ifndef LIGHTHOUSE_MAX_BATCH
+#define LIGHTHOUSE_MAX_BATCH 64
+#endif
 
 /** Light house client state
  */
@@ -113,9 +144,27 @@ typedef struct LighthouseClient
      */
     os_int check_expired_count;
 
-    /** Information about knwon networks.
+    /** Information about known networks, allocated when first network is received.
+        Networks are hashed by transport and network name, and linked in receive order
+        list to find the oldest and the newest quickly.
+     */
+    LightHouseNetwork *net;
+
+    /** Number of networks allocated in net array.
+     */
+    os_short nro_nets;
+
+    /** Hash table, index of first network in chain or -1. Two slots per network.
+     */
+    os_short *hash;
+
+    /** First network in free list, -1 if none.
+     */
+    os_short free_net;
+
+    /** Oldest and newest network in receive order list, -1 if none.
      */
-    LightHouseNetwork net[LIGHTHOUSE_NRO_NETS];
+    os_short oldest_net, newest_net;
 
     /** Network name we are looking for to get faster indication. Empty string if unknown.
      */
@@ -180,6 +229,15 @@ osalStatus ioc_run_lighthouse_client(
     LighthouseClient *c,
     osalEvent trigger);
 
+/* Process one received (or recorded) lighthouse multicast.
+ */
+void ioc_process_lighthouse_multicast(
+    LighthouseClient *c,
+    LighthouseMessage *msg,
+    os_memsz n_read,
+    os_char *remote_addr,
+    os_timer *received_timer);
+
 /* Get server (controller) IP address and port by transport,
  * if received by UDP broadcast.
  */
@@ -153,6 +153,135 @@ OSAL_C_HEADER_BEGINS
   #endif
 #endif
 
+/* Memory block send priority classes and maximum latency hints. Not used in minimalistic
+   build to save memory.
+ */
+#ifndef IOC_MBLK_PRIORITY_SUPPORT
+#define IOC_MBLK_PRIORITY_SUPPORT (OSAL_MINIMALISTIC == 0)
+#endif
+
+/* Round trip time estimate, adaptive acknowledgements and acknowledgements piggybacked
+   after data frames. Not used in minimalistic build to save memory.
+ */
+#ifndef IOC_ADAPTIVE_FLOW_CONTROL
+#define IOC_ADAPTIVE_FLOW_CONTROL (OSAL_MINIMALISTIC == 0)
+#endif
+
+/* Skip memory block information exchange on reconnect if memory blocks have not changed.
+   The other end of connection caches received memory block information, thus this needs
+   dynamic memory allocation.
+ */
+#ifndef IOC_MBINFO_RESUME
+#define IOC_MBINFO_RESUME (OSAL_DYNAMIC_MEMORY_ALLOCATION && OSAL_MINIMALISTIC == 0)
+#endif
+
+/* Memory block generation numbers and optional change journal, so that pollers can ask
+   which data has changed since they last looked. Not used in minimalistic build.
+ */
+#ifndef IOC_MBLK_GENERATIONS
+#define IOC_MBLK_GENERATIONS (OSAL_MINIMALISTIC == 0)
+#endif
+
+/* Time series recording of memory block changes to segment rotated log files. Needs file
+   system, threads and 64 bit integers, thus only on PC/server builds.
+ */
+#ifndef IOC_MBLK_RECORDER
+#define IOC_MBLK_RECORDER (OSAL_FILESYS_SUPPORT && OSAL_MULTITHREAD_SUPPORT && \
+    OSAL_DYNAMIC_MEMORY_ALLOCATION && OSAL_LONG_IS_64_BITS && OSAL_MICROCONTROLLER == 0)
+#endif
+
+/* Root keeps lists of source buffers with changes to send and memory blocks with received
+   data, so that ioc_send_all() and ioc_receive_all() do not need to walk all memory blocks.
+ */
+#ifndef IOC_DIRTY_LISTS
+#define IOC_DIRTY_LISTS (OSAL_MINIMALISTIC == 0)
+#endif
+
+/* Shared timer wheel in root for connection keep alive, silence and reconnect timeouts, so
+   that idle connection threads do not need to wake up periodically.
+ */
+#ifndef IOC_TIMER_WHEEL
+#define IOC_TIMER_WHEEL (OSAL_MULTITHREAD_SUPPORT && OSAL_MICROCONTROLLER == 0)
+#endif
+
+/* Memory blocks backed by memory mapped files. Linux servers only, needs generation
+   numbers to know which memory blocks to write back.
+ */
+#ifndef IOC_MBLK_MMAP
+#if defined(__linux__) && OSAL_FILESYS_SUPPORT && OSAL_MICROCONTROLLER == 0 && IOC_MBLK_GENERATIONS
+#define IOC_MBLK_MMAP 1
+#else
+#define IOC_MBLK_MMAP 0
+#endif
+#endif
+
+/* Allocate synchronization buffers on demand. Target buffer's buffers are allocated when
+   first data is received, and source buffer's buffers cover only the address range written
+   since last key frame. Not used in microcontroller builds, which prefer memory to be
+   allocated once at startup.
+ */
+#ifndef IOC_LAZY_SYNC_BUFFERS
+#define IOC_LAZY_SYNC_BUFFERS (OSAL_DYNAMIC_MEMORY_ALLOCATION && OSAL_MICROCONTROLLER == 0)
+#endif
+
+/* In-process loopback stream, to connect two roots within one process without network
+   stack, for example for testing and performance measurement.
+ */
+#ifndef IOC_LOOPBACK_SUPPORT
+#define IOC_LOOPBACK_SUPPORT (OSAL_MICROCONTROLLER == 0)
+#endif
+
+/* Measure connection setup time, from stream open to authentication and to first data,
+   into per root histograms. Not used in microcontroller builds.
+ */
+#ifndef IOC_CONNECT_STATS
+#define IOC_CONNECT_STATS (OSAL_MICROCONTROLLER == 0)
+#endif
+
+/* Lock contention and hot path tracing. Off by default, costs a time stamp and a
+   histogram update per ioc_lock(). Set IOC_PERF_TRACE=1 in compiler settings to
+   find out where a slow server spends its time.
+ */
+#ifndef IOC_PERF_TRACE
+#define IOC_PERF_TRACE 0
+#endif
+
+/* Memory block minimum send interval. Changes written within the interval are merged
+   into one frame, to limit frame rate of high rate producers. Not used in minimalistic
+   build to save memory.
+ */
+#ifndef IOC_MBLK_COALESCE
+#define IOC_MBLK_COALESCE (OSAL_MINIMALISTIC == 0)
+#endif
+
+/* Lossless sample history: time stamped samples are buffered and sent in batches over
+   brick transfer, so that no sample is lost between memory block updates.
+ */
+#ifndef IOC_SAMPLER_SUPPORT
+#define IOC_SAMPLER_SUPPORT (IOC_STREAMER_SUPPORT && OSAL_DYNAMIC_MEMORY_ALLOCATION)
+#endif
+
+/* Tiled brick transfer: only changed parts of camera image are sent.
+ */
+#ifndef IOC_BRICK_TILES_SUPPORT
+#define IOC_BRICK_TILES_SUPPORT (IOC_STREAMER_SUPPORT && OSAL_DYNAMIC_MEMORY_ALLOCATION)
+#endif
+
+/* Brick hub: controller receives bricks once from device and distributes them to many
+   local and remote consumers.
+ */
+#ifndef IOC_BRICK_HUB_SUPPORT
+#define IOC_BRICK_HUB_SUPPORT (IOC_STREAMER_SUPPORT && OSAL_DYNAMIC_MEMORY_ALLOCATION)
+#endif
+
+/* LZ compression of keyframes and large data ranges. The codec is negotiated per
+   connection in authentication message, so peers without it fall back to zero run
+   compression. Not included in microcontroller builds to save stack and code space.
+ */
+#ifndef IOC_LZ_COMPRESSION_SUPPORT
+#define IOC_LZ_COMPRESSION_SUPPORT (OSAL_MICROCONTROLLER == 0 && OSAL_MINIMALISTIC == 0)
+#endif
+
 /* Security and testing is difficult with security on, define to turn much of it off.
    By default iocom define IOC_RELAX_SECURITY follows OSAL_RELAX_SECURITY in eosal.h.
  */
@@ -178,6 +307,13 @@ OSAL_C_HEADER_BEGINS
   #define IOC_MBLK_SPECIFIC_DEVICE_NAME (OSAL_MINIMALISTIC == 0)
 #endif
 
+/* Hash index of memory blocks by names and by identifier, for servers with many dynamically
+   created memory blocks. Requires memory block specific device and network names.
+ */
+#ifndef IOC_MBLK_INDEX
+  #define IOC_MBLK_INDEX (IOC_DYNAMIC_MBLK_CODE && IOC_MBLK_SPECIFIC_DEVICE_NAME)
+#endif
+
 
 #if OSAL_MINIMALISTIC
     typedef os_short ioc_addr;
@@ -194,10 +330,18 @@ OSAL_C_HEADER_BEGINS
 #include "code/ioc_debug.h"
 #include "code/ioc_handle.h"
 #include "code/ioc_memory_block_info.h"
+#include "code/ioc_mbinfo_resume.h"
 #include "code/ioc_authentication.h"
 #include "code/ioc_auto_device_nr.h"
+#include "code/ioc_mblk_index.h"
+#include "code/ioc_timer_wheel.h"
+#include "code/ioc_connect_stats.h"
+#include "code/ioc_perf_trace.h"
 #include "code/ioc_root.h"
 #include "code/ioc_memory_block.h"
+#include "code/ioc_mblk_journal.h"
+#include "code/ioc_mblk_mmap.h"
+#include "code/ioc_mblk_recorder.h"
 #include "code/ioc_signal.h"
 #include "code/ioc_signal_addr.h"
 #include "code/ioc_streamer.h"
@@ -206,6 +350,7 @@ OSAL_C_HEADER_BEGINS
 #endif
 #include "code/ioc_handshake.h"
 #include "code/ioc_handshake_iocom.h"
+#include "code/ioc_flow_control.h"
 #include "code/ioc_connection.h"
 #include "code/ioc_end_point.h"
 #include "code/ioc_source_buffer.h"
@@ -213,6 +358,9 @@ OSAL_C_HEADER_BEGINS
 #include "code/ioc_compress.h"
 #include "code/ioc_memory.h"
 #include "code/ioc_brick.h"
+#include "code/ioc_brick_tiles.h"
+#include "code/ioc_brick_hub.h"
+#include "code/ioc_sampler.h"
 #include "code/ioc_parameters.h"
 #include "code/ioc_ioboard.h"
 #if IOC_NICKGEN_SUPPORT
@@ -221,6 +369,7 @@ OSAL_C_HEADER_BEGINS
 #include "code/ioc_switchbox_auth_frame.h"
 #include "code/ioc_switchbox_socket.h"
 #include "code/ioc_switchbox_util.h"
+#include "code/ioc_loopback_stream.h"
 
 /* If C++ compilation, end the undecorated code.
  */
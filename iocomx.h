@@ -32,6 +32,7 @@ OSAL_C_HEADER_BEGINS
 
 #if IOC_DYNAMIC_MBLK_CODE
 #include "extensions/dynamicio/ioc_identifiers.h"
+#include "extensions/dynamicio/ioc_dyn_string_pool.h"
 #include "extensions/dynamicio/ioc_dyn_signal.h"
 #include "extensions/dynamicio/ioc_dyn_network.h"
 #include "extensions/dynamicio/ioc_dyn_root.h"